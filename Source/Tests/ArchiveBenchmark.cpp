@@ -0,0 +1,113 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <catch2/catch_amalgamated.hpp>
+#include <Urho3D/Urho3D.h>
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/IO/ArchiveSerialization.h>
+#include <Urho3D/IO/BinaryArchive.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/IO/VectorBuffer.h>
+
+#include "ArchiveTestRecord.h"
+
+using namespace Urho3D;
+using namespace Tests;
+
+TEST_CASE("Binary archive roundtrip", "[archive]")
+{
+    auto context = MakeShared<Context>();
+    ea::vector<ArchiveTestRecord> records = CreateRecords(64);
+
+    VectorBuffer buffer;
+    {
+        BinaryOutputArchive archive(context, buffer);
+        REQUIRE(SerializeRecords(archive, records));
+    }
+
+    SECTION("memory buffer")
+    {
+        ea::vector<ArchiveTestRecord> loadedRecords;
+        MemoryBuffer memoryBuffer(buffer.GetBuffer());
+        BinaryInputArchive archive(context, memoryBuffer);
+        REQUIRE(SerializeRecords(archive, loadedRecords));
+        REQUIRE(loadedRecords.size() == records.size());
+        for (unsigned i = 0; i < records.size(); ++i)
+            REQUIRE(loadedRecords[i] == records[i]);
+    }
+
+    SECTION("generic archive interface")
+    {
+        ea::vector<ArchiveTestRecord> loadedRecords;
+        buffer.Seek(0);
+        BinaryInputArchive binaryArchive(context, buffer);
+        Archive& archive = binaryArchive;
+        REQUIRE(SerializeRecords(archive, loadedRecords));
+        REQUIRE(loadedRecords.size() == records.size());
+        REQUIRE(loadedRecords.back().id_ == records.back().id_);
+        REQUIRE(loadedRecords.back().indices_ == records.back().indices_);
+    }
+}
+
+TEST_CASE("Binary archive serialization benchmark", "[.][benchmark][archive]")
+{
+    auto context = MakeShared<Context>();
+    ea::vector<ArchiveTestRecord> records = CreateRecords(10000);
+
+    VectorBuffer buffer;
+    {
+        BinaryOutputArchive archive(context, buffer);
+        SerializeRecords(archive, records);
+    }
+
+    BENCHMARK("Write through Archive interface")
+    {
+        VectorBuffer output;
+        BinaryOutputArchive binaryArchive(context, output);
+        Archive& archive = binaryArchive;
+        return SerializeRecords(archive, records);
+    };
+
+    BENCHMARK("Write through BinaryOutputArchive")
+    {
+        VectorBuffer output;
+        BinaryOutputArchive archive(context, output);
+        return SerializeRecords(archive, records);
+    };
+
+    BENCHMARK("Read through Archive interface")
+    {
+        ea::vector<ArchiveTestRecord> loadedRecords;
+        MemoryBuffer input(buffer.GetBuffer());
+        BinaryInputArchive binaryArchive(context, input);
+        Archive& archive = binaryArchive;
+        return SerializeRecords(archive, loadedRecords);
+    };
+
+    BENCHMARK("Read through BinaryInputArchive")
+    {
+        ea::vector<ArchiveTestRecord> loadedRecords;
+        MemoryBuffer input(buffer.GetBuffer());
+        BinaryInputArchive archive(context, input);
+        return SerializeRecords(archive, loadedRecords);
+    };
+}
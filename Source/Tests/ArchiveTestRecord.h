@@ -0,0 +1,124 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <Urho3D/IO/ArchiveSerialization.h>
+
+#include <EASTL/map.h>
+
+namespace Tests
+{
+
+/// Record with common value types serialized through archives.
+struct ArchiveTestRecord
+{
+    Urho3D::Vector3 position_;
+    Urho3D::Quaternion rotation_;
+    Urho3D::Color color_;
+    ea::string name_;
+    int id_{};
+    float weight_{};
+    bool enabled_{};
+    ea::vector<unsigned> indices_;
+    ea::map<ea::string, int> counters_;
+
+    /// Compare records.
+    bool operator==(const ArchiveTestRecord& rhs) const
+    {
+        return position_ == rhs.position_
+            && rotation_ == rhs.rotation_
+            && color_ == rhs.color_
+            && name_ == rhs.name_
+            && id_ == rhs.id_
+            && weight_ == rhs.weight_
+            && enabled_ == rhs.enabled_
+            && indices_ == rhs.indices_
+            && counters_ == rhs.counters_;
+    }
+};
+
+/// Serialize one record.
+template <class ArchiveT>
+bool SerializeRecord(ArchiveT& archive, ArchiveTestRecord& record)
+{
+    using namespace Urho3D;
+
+    if (ArchiveBlock block = archive.OpenUnorderedBlock("record"))
+    {
+        SerializeValue(archive, "position", record.position_);
+        SerializeValue(archive, "rotation", record.rotation_);
+        SerializeValue(archive, "color", record.color_);
+        SerializeValue(archive, "name", record.name_);
+        SerializeValue(archive, "id", record.id_);
+        SerializeValue(archive, "weight", record.weight_);
+        SerializeValue(archive, "enabled", record.enabled_);
+        SerializeVector(archive, "indices", "index", record.indices_);
+        SerializeStringMap(archive, "counters", "counter", record.counters_);
+        return !archive.HasError();
+    }
+    return false;
+}
+
+/// Serialize array of records.
+template <class ArchiveT>
+bool SerializeRecords(ArchiveT& archive, ea::vector<ArchiveTestRecord>& records)
+{
+    using namespace Urho3D;
+
+    if (ArchiveBlock block = archive.OpenArrayBlock("records", records.size()))
+    {
+        if (archive.IsInput())
+            records.resize(block.GetSizeHint());
+        for (ArchiveTestRecord& record : records)
+        {
+            if (!SerializeRecord(archive, record))
+                return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+/// Create records. All floats are exactly representable in text archives.
+inline ea::vector<ArchiveTestRecord> CreateRecords(unsigned count)
+{
+    using namespace Urho3D;
+
+    ea::vector<ArchiveTestRecord> records(count);
+    for (unsigned i = 0; i < count; ++i)
+    {
+        ArchiveTestRecord& record = records[i];
+        record.position_ = Vector3(i * 1.0f, i * 2.0f, i * 3.0f);
+        record.rotation_ = Quaternion(0.5f, 0.5f, i % 2 ? 0.5f : -0.5f, 0.5f);
+        record.color_ = Color(0.25f, 0.5f, 0.75f, i % 2 ? 1.0f : 0.5f);
+        record.name_ = Format("Record \"{}\" & <more>", i);
+        record.id_ = static_cast<int>(i) - 32;
+        record.weight_ = i * 0.5f;
+        record.enabled_ = i % 3 == 0;
+        record.indices_ = { i, i + 1, i + 2, i + 3 };
+        record.counters_ = { { "first", static_cast<int>(i) }, { "second", static_cast<int>(i * 2) } };
+    }
+    return records;
+}
+
+}
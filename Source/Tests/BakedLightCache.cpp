@@ -0,0 +1,174 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <catch2/catch_amalgamated.hpp>
+#include <Urho3D/Urho3D.h>
+
+#ifdef URHO3D_GLOW
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Glow/BakedLightCache.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/FileSystem.h>
+
+using namespace Urho3D;
+
+namespace
+{
+
+/// Size of test lightmaps.
+const unsigned LightmapSize = 64;
+/// Size of test lightmap in memory.
+const unsigned long long LightmapMemorySize = LightmapSize * LightmapSize * sizeof(Vector3);
+
+/// Create lightmap filled with value derived from index.
+BakedLightmap CreateLightmap(unsigned index)
+{
+    BakedLightmap bakedLightmap(LightmapSize);
+    for (unsigned i = 0; i < bakedLightmap.lightmap_.size(); ++i)
+        bakedLightmap.lightmap_[i] = Vector3(static_cast<float>(index), static_cast<float>(i), 1.0f);
+    return bakedLightmap;
+}
+
+/// Create direct light filled with value derived from index.
+LightmapChartBakedDirect CreateDirectLight(unsigned index)
+{
+    LightmapChartBakedDirect bakedDirect(LightmapSize);
+    for (unsigned i = 0; i < bakedDirect.directLight_.size(); ++i)
+    {
+        bakedDirect.directLight_[i] = Vector3(static_cast<float>(index), static_cast<float>(i), 0.0f);
+        bakedDirect.surfaceLight_[i] = Vector3::ONE * static_cast<float>(index);
+        bakedDirect.albedo_[i] = Vector3::ONE * 0.5f;
+    }
+    return bakedDirect;
+}
+
+/// Create empty cache directory.
+ea::string CreateCacheDirectory(Context* context)
+{
+    auto fileSystem = context->GetSubsystem<FileSystem>();
+    const ea::string cacheDirectory = fileSystem->GetTemporaryDir() + "Urho3DTests/BakedLightCache/";
+    fileSystem->RemoveDir(cacheDirectory, true);
+    return cacheDirectory;
+}
+
+}
+
+TEST_CASE("Disk light cache spills least recently used data", "[glow]")
+{
+    auto context = MakeShared<Context>();
+    context->RegisterSubsystem(new FileSystem(context));
+    const ea::string cacheDirectory = CreateCacheDirectory(context);
+
+    const unsigned numLightmaps = 8;
+    {
+        BakedLightDiskCache cache(context, cacheDirectory, LightmapMemorySize * 4);
+        for (unsigned i = 0; i < numLightmaps; ++i)
+        {
+            cache.SetLightmapInputHash(i, 100 + i);
+            cache.StoreLightmap(i, CreateLightmap(i));
+            cache.StoreDirectLight(i, CreateDirectLight(i));
+        }
+
+        REQUIRE(cache.GetMemoryUse() <= cache.GetMemoryBudget());
+        REQUIRE(cache.GetNumSpilledItems() > 0);
+
+        for (unsigned i = 0; i < numLightmaps; ++i)
+        {
+            const auto bakedLightmap = cache.LoadLightmap(i);
+            REQUIRE(bakedLightmap);
+            REQUIRE(bakedLightmap->lightmap_ == CreateLightmap(i).lightmap_);
+
+            const auto bakedDirect = cache.LoadDirectLight(i);
+            REQUIRE(bakedDirect);
+            REQUIRE(bakedDirect->directLight_ == CreateDirectLight(i).directLight_);
+            REQUIRE(bakedDirect->surfaceLight_ == CreateDirectLight(i).surfaceLight_);
+            const int lastTexel = static_cast<int>(LightmapSize) - 1;
+            REQUIRE(bakedDirect->GetNearestLocation(Vector2::ONE) == IntVector2(lastTexel, lastTexel));
+        }
+
+        REQUIRE(cache.GetMemoryUse() <= cache.GetMemoryBudget());
+        REQUIRE_FALSE(cache.LoadLightmap(numLightmaps));
+    }
+
+    // Data is reused by the next bake if the input is the same
+    {
+        BakedLightDiskCache cache(context, cacheDirectory, LightmapMemorySize * 4);
+        for (unsigned i = 0; i < numLightmaps; ++i)
+            cache.SetLightmapInputHash(i, i == 0 ? 1 : 100 + i);
+
+        const auto bakedLightmap = cache.LoadLightmap(numLightmaps - 1);
+        REQUIRE(bakedLightmap);
+        REQUIRE(bakedLightmap->lightmap_ == CreateLightmap(numLightmaps - 1).lightmap_);
+        REQUIRE(cache.GetNumSpilledItems() == 0);
+
+        REQUIRE_FALSE(cache.LoadLightmap(0));
+        REQUIRE_FALSE(cache.LoadDirectLight(0));
+    }
+
+    // Data of changed input is removed
+    {
+        BakedLightDiskCache cache(context, cacheDirectory, LightmapMemorySize * 4);
+        cache.SetLightmapInputHash(0, 100);
+        REQUIRE_FALSE(cache.LoadLightmap(0));
+        cache.SetLightmapInputHash(1, 101);
+        REQUIRE(cache.LoadLightmap(1));
+    }
+
+    context->GetSubsystem<FileSystem>()->RemoveDir(cacheDirectory, true);
+}
+
+TEST_CASE("Disk light cache keeps data that cannot be written", "[glow]")
+{
+    auto context = MakeShared<Context>();
+    context->RegisterSubsystem(new FileSystem(context));
+    auto fileSystem = context->GetSubsystem<FileSystem>();
+
+    // Cache directory cannot be created because there is a file with the same name
+    const ea::string cacheDirectory = CreateCacheDirectory(context);
+    fileSystem->CreateDirsRecursive(GetParentPath(cacheDirectory));
+    {
+        File file(context, RemoveTrailingSlash(cacheDirectory), FILE_WRITE);
+        file.WriteUInt(0);
+    }
+
+    const unsigned numLightmaps = 8;
+    {
+        BakedLightDiskCache cache(context, cacheDirectory, LightmapMemorySize * 2);
+        for (unsigned i = 0; i < numLightmaps; ++i)
+            cache.StoreLightmap(i, CreateLightmap(i));
+
+        REQUIRE(cache.GetNumSpilledItems() == 0);
+        REQUIRE(cache.GetMemoryUse() == LightmapMemorySize * numLightmaps);
+        for (unsigned i = 0; i < numLightmaps; ++i)
+        {
+            const auto bakedLightmap = cache.LoadLightmap(i);
+            REQUIRE(bakedLightmap);
+            REQUIRE(bakedLightmap->lightmap_ == CreateLightmap(i).lightmap_);
+        }
+    }
+
+    fileSystem->Delete(RemoveTrailingSlash(cacheDirectory));
+}
+
+#endif
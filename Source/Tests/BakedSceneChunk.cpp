@@ -0,0 +1,171 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <catch2/catch_amalgamated.hpp>
+#include <Urho3D/Urho3D.h>
+
+#ifdef URHO3D_GLOW
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Glow/BakedSceneChunk.h>
+#include <Urho3D/Graphics/Graphics.h>
+#include <Urho3D/Graphics/Light.h>
+#include <Urho3D/Graphics/Material.h>
+#include <Urho3D/Graphics/Model.h>
+#include <Urho3D/Graphics/Octree.h>
+#include <Urho3D/Graphics/StaticModel.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include "TestUtils.h"
+
+using namespace Urho3D;
+using namespace Tests;
+
+namespace
+{
+
+/// Calculate hashes of all chunks in the scene. Each chunk owns one lightmap.
+ea::unordered_map<IntVector3, unsigned> CalculateChunkHashes(
+    Scene* scene, const LightBakingSettings& settings, unsigned baseLightmapIndex = 0)
+{
+    DefaultBakedSceneCollector collector;
+    collector.LockScene(scene, settings.incremental_.chunkSize_);
+
+    ResourceContentHashes contentHashes;
+    ea::unordered_map<IntVector3, unsigned> chunkHashes;
+    for (const IntVector3& chunk : collector.GetChunks())
+    {
+        chunkHashes[chunk] = CalculateBakedSceneChunkHash(
+            collector, chunk, baseLightmapIndex++, 1, settings, contentHashes);
+    }
+
+    collector.UnlockScene();
+    return chunkHashes;
+}
+
+}
+
+TEST_CASE("Chunk hash changes only for chunks affected by scene change", "[glow]")
+{
+    auto context = CreateTestContext(TestContextFlag::Resources | TestContextFlag::Graphics);
+
+    LightBakingSettings settings;
+    settings.incremental_.chunkSize_ = Vector3::ONE * 16.0f;
+    settings.incremental_.indirectPadding_ = 4.0f;
+
+    // Two distant groups of quads
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateComponent<Octree>();
+
+    const SharedPtr<Model> model = CreateQuadModel(context);
+    ea::vector<StaticModel*> quads;
+    ea::vector<SharedPtr<Material>> materials;
+    for (float x : { 0.0f, 4.0f, 60.0f, 64.0f })
+    {
+        auto material = MakeShared<Material>(context);
+        material->SetShaderParameter("MatDiffColor", Color::WHITE);
+
+        Node* node = scene->CreateChild();
+        node->SetPosition({ x, 0.0f, 0.0f });
+        node->SetScale(4.0f);
+        auto staticModel = node->CreateComponent<StaticModel>();
+        staticModel->SetModel(model);
+        staticModel->SetMaterial(material);
+        staticModel->SetBakeLightmap(true);
+
+        quads.push_back(staticModel);
+        materials.push_back(material);
+    }
+
+    Node* lightNode = scene->CreateChild();
+    lightNode->SetPosition({ 2.0f, 2.0f, 0.0f });
+    auto light = lightNode->CreateComponent<Light>();
+    light->SetLightType(LIGHT_POINT);
+    light->SetLightMode(LM_BAKED);
+    light->SetRange(4.0f);
+
+    const auto baseHashes = CalculateChunkHashes(scene, settings);
+    REQUIRE(baseHashes.size() > 1);
+
+    const auto getChunkOf = [&](const StaticModel* staticModel)
+    {
+        DefaultBakedSceneCollector collector;
+        collector.LockScene(scene, settings.incremental_.chunkSize_);
+        for (const IntVector3& chunk : collector.GetChunks())
+        {
+            const ea::vector<Component*> geometries = collector.GetUniqueGeometries(chunk);
+            if (ea::find(geometries.begin(), geometries.end(), staticModel) != geometries.end())
+                return chunk;
+        }
+        return IntVector3::ZERO;
+    };
+    const IntVector3 nearChunk = getChunkOf(quads[0]);
+    const IntVector3 farChunk = getChunkOf(quads[3]);
+    REQUIRE(nearChunk != farChunk);
+
+    SECTION("hash is stable")
+    {
+        REQUIRE(CalculateChunkHashes(scene, settings) == baseHashes);
+    }
+
+    SECTION("material change affects only its chunk")
+    {
+        materials[3]->SetShaderParameter("MatDiffColor", Color::RED);
+        const auto hashes = CalculateChunkHashes(scene, settings);
+        REQUIRE(hashes.at(nearChunk) == baseHashes.at(nearChunk));
+        REQUIRE(hashes.at(farChunk) != baseHashes.at(farChunk));
+    }
+
+    SECTION("model data change affects only its chunk")
+    {
+        quads[3]->SetModel(CreateQuadModel(context, 2.0f));
+        const auto hashes = CalculateChunkHashes(scene, settings);
+        REQUIRE(hashes.at(nearChunk) == baseHashes.at(nearChunk));
+        REQUIRE(hashes.at(farChunk) != baseHashes.at(farChunk));
+    }
+
+    SECTION("lightmap index change affects all chunks")
+    {
+        const auto hashes = CalculateChunkHashes(scene, settings, 1);
+        REQUIRE(hashes.at(nearChunk) != baseHashes.at(nearChunk));
+        REQUIRE(hashes.at(farChunk) != baseHashes.at(farChunk));
+    }
+
+    SECTION("light change affects only lit chunks")
+    {
+        light->SetColor(Color::BLUE);
+        const auto hashes = CalculateChunkHashes(scene, settings);
+        REQUIRE(hashes.at(nearChunk) != baseHashes.at(nearChunk));
+        REQUIRE(hashes.at(farChunk) == baseHashes.at(farChunk));
+    }
+
+    SECTION("settings change affects all chunks")
+    {
+        settings.indirectChartTracing_.maxBounces_ += 1;
+        const auto hashes = CalculateChunkHashes(scene, settings);
+        REQUIRE(hashes.at(nearChunk) != baseHashes.at(nearChunk));
+        REQUIRE(hashes.at(farChunk) != baseHashes.at(farChunk));
+    }
+}
+
+#endif
@@ -0,0 +1,251 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <catch2/catch_amalgamated.hpp>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/Math/RandomEngine.h>
+#include <Urho3D/Resource/BlockCompression.h>
+#include <Urho3D/Resource/Decompress.h>
+#include <Urho3D/Resource/Image.h>
+
+using namespace Urho3D;
+
+namespace
+{
+
+/// Create RGBA image with smooth gradients, sharp edges and a bit of noise.
+ea::vector<unsigned char> CreateTestImage(int width, int height, unsigned seed)
+{
+    RandomEngine random(seed);
+    ea::vector<unsigned char> image(width * height * 4);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            unsigned char* pixel = &image[(y * width + x) * 4];
+            const int noise = random.GetInt(-4, 5);
+            pixel[0] = static_cast<unsigned char>(Clamp(x * 255 / width + noise, 0, 255));
+            pixel[1] = static_cast<unsigned char>(Clamp(y * 255 / height + noise, 0, 255));
+            pixel[2] = static_cast<unsigned char>((x / 16 + y / 16) % 2 ? 200 : 40);
+            pixel[3] = static_cast<unsigned char>(x < width / 2 ? 255 : Clamp((x + y) * 255 / (width + height), 0, 255));
+        }
+    }
+    return image;
+}
+
+/// Return PSNR of RGBA images.
+double CalculatePSNR(const unsigned char* reference, const unsigned char* image, unsigned count)
+{
+    double squaredError = 0.0;
+    for (unsigned i = 0; i < count; ++i)
+        squaredError += (reference[i] - image[i]) * (reference[i] - image[i]);
+    return squaredError == 0.0 ? M_INFINITY : 10.0 * log10(255.0 * 255.0 * count / squaredError);
+}
+
+}
+
+TEST_CASE("Block compression round trip", "[image]")
+{
+    auto context = MakeShared<Context>();
+    auto workQueue = new WorkQueue(context);
+    context->RegisterSubsystem(workQueue);
+    workQueue->CreateThreads(ea::max(GetNumLogicalCPUs(), 2u) - 1);
+
+    const int width = 130;
+    const int height = 66;
+    const unsigned blocksSize = (width + 3) / 4 * ((height + 3) / 4) * BLOCK_COMPRESSION_BLOCK_SIZE;
+    const auto image = CreateTestImage(width, height, 1);
+
+    SECTION("BC7 and ASTC preserve image quality")
+    {
+        const CompressedFormat formats[] = {CF_BC7, CF_ASTC_4x4};
+        const double minPSNR[] = {40.0, 40.0};
+        for (unsigned i = 0; i < 2; ++i)
+        {
+            ea::vector<unsigned char> blocks(blocksSize);
+            ea::vector<unsigned char> decompressed(width * height * 4);
+            REQUIRE(CompressImageBlocks(blocks.data(), image.data(), width, height, formats[i], BlockCompressionQuality::High));
+
+            CompressedLevel level;
+            level.data_ = blocks.data();
+            level.format_ = formats[i];
+            level.width_ = width;
+            level.height_ = height;
+            level.depth_ = 1;
+            level.blockSize_ = BLOCK_COMPRESSION_BLOCK_SIZE;
+            REQUIRE(level.Decompress(decompressed.data()));
+
+            CHECK(CalculatePSNR(image.data(), decompressed.data(), image.size()) > minPSNR[i]);
+        }
+    }
+
+    SECTION("Higher quality doesn't increase error")
+    {
+        double psnr[3];
+        for (unsigned quality = 0; quality < 3; ++quality)
+        {
+            ea::vector<unsigned char> blocks(blocksSize);
+            ea::vector<unsigned char> decompressed(width * height * 4);
+            CompressImageBlocks(blocks.data(), image.data(), width, height, CF_BC7, static_cast<BlockCompressionQuality>(quality));
+            DecompressImageBC7(decompressed.data(), blocks.data(), width, height);
+            psnr[quality] = CalculatePSNR(image.data(), decompressed.data(), image.size());
+        }
+        CHECK(psnr[1] >= psnr[0]);
+        CHECK(psnr[2] >= psnr[1]);
+    }
+
+    SECTION("Solid blocks are encoded exactly")
+    {
+        const unsigned char colors[][4] = {{0, 0, 0, 255}, {255, 255, 255, 255}, {17, 130, 201, 255}, {90, 3, 250, 77}};
+        for (const auto& color : colors)
+        {
+            unsigned char pixels[16 * 4];
+            for (unsigned i = 0; i < 16; ++i)
+                memcpy(pixels + i * 4, color, 4);
+
+            unsigned char block[BLOCK_COMPRESSION_BLOCK_SIZE];
+            unsigned char decompressed[16 * 4];
+            CompressBlockASTC(block, pixels, BlockCompressionQuality::Fast);
+            DecompressBlockASTC(decompressed, block);
+            CHECK(memcmp(pixels, decompressed, sizeof(pixels)) == 0);
+
+            // BC7 mode 6 endpoints share the lowest bit, so solid colors may be off by one
+            CompressBlockBC7(block, pixels, BlockCompressionQuality::High);
+            DecompressBlockBC7(decompressed, block);
+            for (unsigned i = 0; i < 16 * 4; ++i)
+                CHECK(Abs(pixels[i] - decompressed[i]) <= 1);
+        }
+    }
+
+    SECTION("BC6H preserves HDR values")
+    {
+        float pixels[16 * 3];
+        for (unsigned i = 0; i < 16; ++i)
+        {
+            pixels[i * 3] = 1.0f + i * 0.05f;
+            pixels[i * 3 + 1] = 0.1f + i * 0.01f;
+            pixels[i * 3 + 2] = 4.0f - i * 0.1f;
+        }
+
+        unsigned char block[BLOCK_COMPRESSION_BLOCK_SIZE];
+        float decompressed[16 * 3];
+        CompressBlockBC6H(block, pixels, BlockCompressionQuality::High);
+        DecompressBlockBC6H(decompressed, block);
+        for (unsigned i = 0; i < 16 * 3; ++i)
+            CHECK(decompressed[i] == Catch::Approx(pixels[i]).epsilon(0.08));
+    }
+
+    SECTION("BC7 decoder supports modes 4 and 5")
+    {
+        // Mode 5 with red color endpoints and transparent alpha, rotation swaps alpha and red
+        unsigned char block[BLOCK_COMPRESSION_BLOCK_SIZE]{};
+        block[0] = 0x20 | 0x40;
+        block[1] = 0xff;
+        block[2] = 0x3f;
+
+        unsigned char decompressed[16 * 4];
+        DecompressBlockBC7(decompressed, block);
+        for (unsigned i = 0; i < 16; ++i)
+        {
+            CHECK(decompressed[i * 4] == 0);
+            CHECK(decompressed[i * 4 + 1] == 0);
+            CHECK(decompressed[i * 4 + 2] == 0);
+            CHECK(decompressed[i * 4 + 3] == 255);
+        }
+
+        // Mode 4 with 5-bit green endpoints and 6-bit alpha endpoints
+        memset(block, 0, sizeof(block));
+        block[0] = 0x10;
+        // Bits 8..17 are red endpoints, green endpoints are at bits 18..27
+        block[2] = 0xfc;
+        block[3] = 0x0f;
+        // Alpha endpoints are at bits 38..49
+        block[4] = 0xc0;
+        block[5] = 0xff;
+        block[6] = 0x03;
+
+        DecompressBlockBC7(decompressed, block);
+        for (unsigned i = 0; i < 16; ++i)
+        {
+            CHECK(decompressed[i * 4] == 0);
+            CHECK(decompressed[i * 4 + 1] == 255);
+            CHECK(decompressed[i * 4 + 2] == 0);
+            CHECK(decompressed[i * 4 + 3] == 255);
+        }
+    }
+
+    SECTION("Parallel compression matches serial")
+    {
+        const CompressedFormat formats[] = {CF_BC7, CF_ASTC_4x4};
+        for (CompressedFormat format : formats)
+        {
+            ea::vector<unsigned char> serial(blocksSize);
+            ea::vector<unsigned char> parallel(blocksSize);
+            CompressImageBlocks(serial.data(), image.data(), width, height, format, BlockCompressionQuality::Normal);
+            CompressImageBlocks(parallel.data(), image.data(), width, height, format, BlockCompressionQuality::Normal, workQueue);
+            CHECK(serial == parallel);
+        }
+
+        ea::vector<float> imageHDR(width * height * 3);
+        for (unsigned i = 0; i < imageHDR.size(); ++i)
+            imageHDR[i] = image[i / 3 * 4 + i % 3] / 64.0f;
+
+        ea::vector<unsigned char> serial(blocksSize);
+        ea::vector<unsigned char> parallel(blocksSize);
+        CompressImageBC6H(serial.data(), imageHDR.data(), width, height, BlockCompressionQuality::Normal);
+        CompressImageBC6H(parallel.data(), imageHDR.data(), width, height, BlockCompressionQuality::Normal, workQueue);
+        CHECK(serial == parallel);
+    }
+}
+
+TEST_CASE("Block compression benchmark", "[.][benchmark][image]")
+{
+    auto context = MakeShared<Context>();
+    auto workQueue = new WorkQueue(context);
+    context->RegisterSubsystem(workQueue);
+    workQueue->CreateThreads(ea::max(GetNumLogicalCPUs(), 2u) - 1);
+
+    const int size = 1024;
+    const auto image = CreateTestImage(size, size, 0);
+    ea::vector<unsigned char> blocks(size * size);
+
+    WARN("Worker threads: " << workQueue->GetNumThreads());
+
+    BENCHMARK("BC7, single thread")
+    {
+        return CompressImageBlocks(blocks.data(), image.data(), size, size, CF_BC7, BlockCompressionQuality::Normal);
+    };
+
+    BENCHMARK("BC7")
+    {
+        return CompressImageBlocks(blocks.data(), image.data(), size, size, CF_BC7, BlockCompressionQuality::Normal, workQueue);
+    };
+
+    BENCHMARK("ASTC 4x4")
+    {
+        return CompressImageBlocks(blocks.data(), image.data(), size, size, CF_ASTC_4x4, BlockCompressionQuality::Normal, workQueue);
+    };
+}
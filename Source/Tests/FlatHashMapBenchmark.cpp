@@ -0,0 +1,157 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <catch2/catch_amalgamated.hpp>
+#include <Urho3D/Urho3D.h>
+#include <Urho3D/Container/FlatHashMap.h>
+#include <Urho3D/Core/StringUtils.h>
+#include <Urho3D/Math/RandomEngine.h>
+#include <Urho3D/Math/StringHash.h>
+
+#include <EASTL/unordered_map.h>
+
+using namespace Urho3D;
+
+TEST_CASE("FlatHashMap matches unordered_map", "[container]")
+{
+    FlatHashMap<unsigned, unsigned> map;
+    ea::unordered_map<unsigned, unsigned> reference;
+
+    RandomEngine random(0);
+    for (unsigned i = 0; i < 20000; ++i)
+    {
+        const unsigned key = random.GetUInt(0, 1000);
+        switch (random.GetUInt(0, 3))
+        {
+        case 0:
+            REQUIRE(map.erase(key) == reference.erase(key));
+            break;
+        case 1:
+            map[key] = i;
+            reference[key] = i;
+            break;
+        default:
+            REQUIRE(map.try_emplace(key, i).second == reference.emplace(key, i).second);
+            break;
+        }
+    }
+
+    REQUIRE(map.size() == reference.size());
+    for (const auto& [key, value] : reference)
+    {
+        const auto iter = map.find(key);
+        REQUIRE(iter != map.end());
+        REQUIRE(iter->second == value);
+    }
+
+    unsigned count = 0;
+    for (auto iter = map.begin(); iter != map.end();)
+    {
+        REQUIRE(reference.count(iter->first) == 1);
+        ++count;
+        iter = iter->first % 2 ? map.erase(iter) : ++iter;
+    }
+    REQUIRE(count == reference.size());
+    for (const auto& [key, value] : map)
+        REQUIRE(key % 2 == 0);
+
+    const FlatHashMap<unsigned, unsigned> copy = map;
+    REQUIRE(copy.size() == map.size());
+    for (const auto& [key, value] : map)
+        REQUIRE(copy.find(key)->second == value);
+
+    map.clear();
+    REQUIRE(map.empty());
+    REQUIRE(map.begin() == map.end());
+}
+
+TEST_CASE("FlatHashMap supports lookup by string view", "[container]")
+{
+    StringFlatHashMap<int> map;
+    map["first"] = 1;
+    map.try_emplace(ea::string_view{"second"}, 2);
+
+    REQUIRE(map.contains("first"));
+    REQUIRE(map.find(ea::string_view{"second"})->second == 2);
+    REQUIRE(map.find("third") == map.end());
+    REQUIRE(map.erase("first") == 1);
+    REQUIRE(map.size() == 1);
+}
+
+namespace
+{
+
+template <class MapType>
+MapType CreateBenchmarkMap(const ea::vector<StringHash>& keys)
+{
+    MapType map;
+    for (unsigned i = 0; i < keys.size(); ++i)
+        map[keys[i]] = i;
+    return map;
+}
+
+template <class MapType>
+unsigned LookupBenchmarkKeys(const MapType& map, const ea::vector<StringHash>& keys)
+{
+    unsigned sum = 0;
+    for (const StringHash& key : keys)
+    {
+        const auto iter = map.find(key);
+        if (iter != map.end())
+            sum += iter->second;
+    }
+    return sum;
+}
+
+template <class MapType>
+unsigned IterateBenchmarkMap(const MapType& map)
+{
+    unsigned sum = 0;
+    for (const auto& element : map)
+        sum += element.second;
+    return sum;
+}
+
+}
+
+TEST_CASE("FlatHashMap benchmark", "[.][benchmark][container]")
+{
+    ea::vector<StringHash> keys;
+    ea::vector<StringHash> missingKeys;
+    for (unsigned i = 0; i < 1000; ++i)
+    {
+        keys.push_back(StringHash(Format("Attribute{}", i)));
+        missingKeys.push_back(StringHash(Format("Missing{}", i)));
+    }
+
+    const auto unorderedMap = CreateBenchmarkMap<ea::unordered_map<StringHash, unsigned>>(keys);
+    const auto flatMap = CreateBenchmarkMap<FlatHashMap<StringHash, unsigned>>(keys);
+
+    BENCHMARK("Insert into unordered_map") { return CreateBenchmarkMap<ea::unordered_map<StringHash, unsigned>>(keys).size(); };
+    BENCHMARK("Insert into FlatHashMap") { return CreateBenchmarkMap<FlatHashMap<StringHash, unsigned>>(keys).size(); };
+    BENCHMARK("Lookup in unordered_map") { return LookupBenchmarkKeys(unorderedMap, keys); };
+    BENCHMARK("Lookup in FlatHashMap") { return LookupBenchmarkKeys(flatMap, keys); };
+    BENCHMARK("Failed lookup in unordered_map") { return LookupBenchmarkKeys(unorderedMap, missingKeys); };
+    BENCHMARK("Failed lookup in FlatHashMap") { return LookupBenchmarkKeys(flatMap, missingKeys); };
+    BENCHMARK("Iterate unordered_map") { return IterateBenchmarkMap(unorderedMap); };
+    BENCHMARK("Iterate FlatHashMap") { return IterateBenchmarkMap(flatMap); };
+}
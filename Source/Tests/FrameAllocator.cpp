@@ -0,0 +1,179 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <catch2/catch_amalgamated.hpp>
+
+#include <Urho3D/Container/FrameAllocator.h>
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/Graphics/Graphics.h>
+#include <Urho3D/Graphics/Model.h>
+#include <Urho3D/Graphics/Octree.h>
+#include <Urho3D/Graphics/OctreeQuery.h>
+#include <Urho3D/Graphics/StaticModel.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include <future>
+#include <thread>
+
+#include "TestUtils.h"
+
+using namespace Urho3D;
+using namespace Tests;
+
+namespace
+{
+
+/// Return whether the marker points to the beginning of the allocator.
+bool IsAtStart(const LinearAllocator::Marker& marker)
+{
+    return marker.chunk_ == 0 && marker.offset_ == 0;
+}
+
+}
+
+TEST_CASE("Linear allocator rewinds to markers and merges chunks on reset", "[allocator]")
+{
+    LinearAllocator allocator(1024);
+
+    void* first = allocator.Allocate(100);
+    const LinearAllocator::Marker marker = allocator.GetMarker();
+    void* aligned = allocator.Allocate(16, 256);
+    REQUIRE(reinterpret_cast<uintptr_t>(aligned) % 256 == 0);
+
+    // Larger allocation doesn't fit into the first chunk
+    allocator.Allocate(2000);
+    const unsigned long long capacity = allocator.GetCapacity();
+    REQUIRE(capacity > 1024);
+
+    // Memory after the marker is reused
+    allocator.Rewind(marker);
+    REQUIRE(allocator.Allocate(16, 256) == aligned);
+
+    // Chunks are merged into one that fits all of them
+    allocator.Reset();
+    REQUIRE(allocator.GetCapacity() == capacity);
+    REQUIRE(IsAtStart(allocator.GetMarker()));
+    REQUIRE(allocator.Allocate(2000) != first);
+    REQUIRE(allocator.Allocate(100));
+    REQUIRE(allocator.GetCapacity() == capacity);
+    REQUIRE(allocator.GetTotalAllocations() == 6);
+}
+
+TEST_CASE("Frame arena of a thread that doesn't reset it is reset by the outermost scope", "[allocator]")
+{
+    std::promise<void> firstFrameDone;
+    std::promise<void> frameEnded;
+    std::future<void> frameEndedFuture = frameEnded.get_future();
+    unsigned long long firstCapacity = 0;
+    unsigned long long secondCapacity = 0;
+    bool rewound = false;
+
+    std::thread thread([&]()
+    {
+        {
+            FrameArenaScope scope;
+            LinearAllocator& arena = GetFrameArena();
+            arena.Allocate(60000);
+            arena.Allocate(60000);
+            firstCapacity = arena.GetCapacity();
+        }
+        firstFrameDone.set_value();
+        frameEndedFuture.wait();
+
+        // Chunks are merged when the outermost scope ends after the frame end, so the same memory fits into one chunk
+        {
+            FrameArenaScope scope;
+        }
+        {
+            FrameArenaScope scope;
+            LinearAllocator& arena = GetFrameArena();
+            rewound = IsAtStart(arena.GetMarker());
+            arena.Allocate(150000);
+            {
+                FrameArenaScope nestedScope;
+                arena.Allocate(1000);
+            }
+            secondCapacity = arena.GetCapacity();
+        }
+    });
+
+    firstFrameDone.get_future().wait();
+    EndFrameArenas();
+    frameEnded.set_value();
+    thread.join();
+
+    REQUIRE(rewound);
+    REQUIRE(firstCapacity > 0);
+    REQUIRE(secondCapacity == firstCapacity);
+}
+
+TEST_CASE("Octree raycasts keep temporary lists in the frame arena", "[allocator][octree]")
+{
+    auto context = CreateTestContext(TestContextFlag::WorkQueue | TestContextFlag::Graphics);
+
+    auto scene = MakeShared<Scene>(context);
+    auto octree = scene->CreateComponent<Octree>();
+    SharedPtr<Model> model = CreateQuadModel(context);
+    for (unsigned i = 0; i < 8; ++i)
+    {
+        Node* node = scene->CreateChild();
+        node->SetPosition(Vector3(0.0f, static_cast<float>(i), 0.0f));
+        node->SetScale(Vector3(4.0f, 1.0f, 4.0f));
+        node->CreateComponent<StaticModel>()->SetModel(model);
+    }
+    octree->Update(FrameInfo{});
+
+    const Ray ray(Vector3(0.0f, 20.0f, 0.0f), Vector3::DOWN);
+
+    ea::vector<RayQueryResult> results;
+    RayOctreeQuery query(results, ray, RAY_TRIANGLE);
+    octree->Raycast(query);
+    REQUIRE(results.size() == 8);
+    for (unsigned i = 0; i < results.size(); ++i)
+        REQUIRE(results[i].distance_ == Catch::Approx(13.0f + i));
+
+    octree->RaycastSingle(query);
+    REQUIRE(results.size() == 1);
+    REQUIRE(results[0].distance_ == Catch::Approx(13.0f));
+
+    // Raycasts release their candidate lists on return, also in threads that never reset the arena
+    bool rewound = false;
+    ea::vector<RayQueryResult> threadResults;
+    std::thread thread([&]()
+    {
+        RayOctreeQuery threadQuery(threadResults, ray, RAY_TRIANGLE);
+        for (unsigned i = 0; i < 100; ++i)
+        {
+            octree->Raycast(threadQuery);
+            octree->RaycastSingle(threadQuery);
+        }
+
+        FrameArenaScope scope;
+        rewound = IsAtStart(GetFrameArena().GetMarker());
+    });
+    thread.join();
+
+    REQUIRE(rewound);
+    REQUIRE(threadResults.size() == 1);
+    REQUIRE(threadResults[0].distance_ == Catch::Approx(13.0f));
+}
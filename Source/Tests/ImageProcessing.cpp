@@ -0,0 +1,321 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <catch2/catch_amalgamated.hpp>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/Math/RandomEngine.h>
+#include <Urho3D/Resource/Decompress.h>
+#include <Urho3D/Resource/Image.h>
+#include <Urho3D/Resource/ImageProcessing.h>
+
+using namespace Urho3D;
+
+namespace
+{
+
+/// Create image with random pixels.
+SharedPtr<Image> CreateNoiseImage(Context* context, int width, int height, unsigned components, unsigned seed)
+{
+    RandomEngine random(seed);
+    auto image = MakeShared<Image>(context);
+    image->SetSize(width, height, components);
+    unsigned char* data = image->GetData();
+    for (unsigned i = 0; i < width * height * components; ++i)
+        data[i] = static_cast<unsigned char>(random.GetUInt(0, 256));
+    return image;
+}
+
+/// Downsample image with box filter one pixel at a time.
+ea::vector<unsigned char> DownsampleReference(const unsigned char* src, int width, int height, unsigned components)
+{
+    const int destWidth = ea::max(width / 2, 1);
+    const int destHeight = ea::max(height / 2, 1);
+    ea::vector<unsigned char> dest(destWidth * destHeight * components);
+    for (int y = 0; y < destHeight; ++y)
+    {
+        for (int x = 0; x < destWidth; ++x)
+        {
+            const int x0 = ea::min(x * 2, width - 1);
+            const int x1 = ea::min(x * 2 + 1, width - 1);
+            const int y0 = ea::min(y * 2, height - 1);
+            const int y1 = ea::min(y * 2 + 1, height - 1);
+            for (unsigned c = 0; c < components; ++c)
+            {
+                const unsigned sum = src[(y0 * width + x0) * components + c] + src[(y0 * width + x1) * components + c]
+                    + src[(y1 * width + x0) * components + c] + src[(y1 * width + x1) * components + c];
+                dest[(y * destWidth + x) * components + c] = static_cast<unsigned char>(sum >> 2);
+            }
+        }
+    }
+    return dest;
+}
+
+/// Create DXT1 blocks with random colors and indices.
+ea::vector<unsigned char> CreateDXT1Blocks(int width, int height, unsigned seed)
+{
+    RandomEngine random(seed);
+    ea::vector<unsigned char> blocks((width + 3) / 4 * ((height + 3) / 4) * 8);
+    for (unsigned char& value : blocks)
+        value = static_cast<unsigned char>(random.GetUInt(0, 256));
+    return blocks;
+}
+
+}
+
+TEST_CASE("Image kernels match reference implementation", "[image]")
+{
+    auto context = MakeShared<Context>();
+    auto workQueue = new WorkQueue(context);
+    context->RegisterSubsystem(workQueue);
+    workQueue->CreateThreads(ea::max(GetNumLogicalCPUs(), 2u) - 1);
+    Image::RegisterObject(context);
+
+    SECTION("Box filter matches per-pixel average")
+    {
+        const IntVector2 sizes[] = {{1, 1}, {1, 7}, {9, 1}, {37, 29}, {256, 130}, {301, 257}};
+        for (unsigned components = 1; components <= 4; ++components)
+        {
+            for (const IntVector2& size : sizes)
+            {
+                const auto image = CreateNoiseImage(context, size.x_, size.y_, components, components);
+                const auto expected = DownsampleReference(image->GetData(), size.x_, size.y_, components);
+
+                const auto nextLevel = image->GetNextLevel();
+                REQUIRE(nextLevel->GetWidth() == ea::max(size.x_ / 2, 1));
+                REQUIRE(nextLevel->GetHeight() == ea::max(size.y_ / 2, 1));
+                REQUIRE(memcmp(nextLevel->GetData(), expected.data(), expected.size()) == 0);
+            }
+        }
+    }
+
+    SECTION("Filters preserve solid color")
+    {
+        for (unsigned components = 1; components <= 4; ++components)
+        {
+            auto image = MakeShared<Image>(context);
+            image->SetSize(67, 45, components);
+            image->Clear(Color(0.2f, 0.5f, 0.9f, 0.4f));
+
+            for (ImageMipFilter filter : {ImageMipFilter::Box, ImageMipFilter::Kaiser})
+            {
+                for (bool sRGB : {false, true})
+                {
+                    const auto nextLevel = image->GetNextLevel(filter, sRGB);
+                    REQUIRE(nextLevel->GetWidth() == 33);
+                    REQUIRE(nextLevel->GetHeight() == 22);
+                    for (int y = 0; y < nextLevel->GetHeight(); ++y)
+                    {
+                        for (int x = 0; x < nextLevel->GetWidth(); ++x)
+                            REQUIRE(nextLevel->GetPixelInt(x, y) == image->GetPixelInt(x, y));
+                    }
+                }
+            }
+        }
+    }
+
+    SECTION("sRGB box filter averages in linear space")
+    {
+        auto image = MakeShared<Image>(context);
+        image->SetSize(2, 2, 4);
+        image->SetPixelInt(0, 0, 0x00000000);
+        image->SetPixelInt(1, 0, 0x00ffffff);
+        image->SetPixelInt(0, 1, 0xff000000);
+        image->SetPixelInt(1, 1, 0xffffffff);
+
+        const auto linearLevel = image->GetNextLevel(ImageMipFilter::Box, false);
+        const auto srgbLevel = image->GetNextLevel(ImageMipFilter::Box, true);
+        CHECK(linearLevel->GetPixelInt(0, 0) == 0x7f7f7f7f);
+        CHECK(srgbLevel->GetPixelInt(0, 0) == 0x7fbcbcbc);
+    }
+
+    SECTION("Precalculated levels use requested filter")
+    {
+        const auto image = CreateNoiseImage(context, 64, 32, 4, 1);
+        image->PrecalculateLevels(ImageMipFilter::Kaiser, true);
+
+        SharedPtr<Image> level = image->GetNextLevel();
+        SharedPtr<Image> expected = image->GetNextLevel(ImageMipFilter::Kaiser, true);
+        while (true)
+        {
+            REQUIRE(level->GetWidth() == expected->GetWidth());
+            REQUIRE(level->GetHeight() == expected->GetHeight());
+            REQUIRE(memcmp(level->GetData(), expected->GetData(), level->GetWidth() * level->GetHeight() * 4) == 0);
+            if (level->GetWidth() == 1 && level->GetHeight() == 1)
+                break;
+            expected = expected->GetNextLevel(ImageMipFilter::Kaiser, true);
+            level = level->GetNextLevel();
+        }
+    }
+
+    SECTION("Flip and resize")
+    {
+        for (unsigned components = 1; components <= 4; ++components)
+        {
+            const auto image = CreateNoiseImage(context, 131, 67, components, 2);
+            const auto original = image->GetSubimage(IntRect(0, 0, 131, 67));
+
+            REQUIRE(image->FlipHorizontal());
+            REQUIRE(image->GetPixelInt(0, 5) == original->GetPixelInt(130, 5));
+            REQUIRE(image->GetPixelInt(77, 66) == original->GetPixelInt(53, 66));
+            REQUIRE(image->FlipVertical());
+            REQUIRE(image->GetPixelInt(0, 0) == original->GetPixelInt(130, 66));
+            REQUIRE(image->FlipHorizontal());
+            REQUIRE(image->FlipVertical());
+            REQUIRE(memcmp(image->GetData(), original->GetData(), 131 * 67 * components) == 0);
+
+            // Same size is copy, corners are preserved
+            REQUIRE(image->Resize(131, 67));
+            REQUIRE(memcmp(image->GetData(), original->GetData(), 131 * 67 * components) == 0);
+            REQUIRE(image->Resize(300, 200));
+            CHECK(image->GetPixelInt(0, 0) == original->GetPixelInt(0, 0));
+            CHECK(image->GetPixelInt(299, 199) == original->GetPixelInt(130, 66));
+            REQUIRE(image->Resize(20, 10));
+            CHECK(image->GetWidth() == 20);
+            CHECK(image->GetHeight() == 10);
+        }
+    }
+
+    SECTION("Parallel DXT decompression matches serial")
+    {
+        const int width = 250;
+        const int height = 198;
+        auto blocks = CreateDXT1Blocks(width, height, 3);
+
+        // Red block with blue second row
+        blocks[0] = 0x00;
+        blocks[1] = 0xf8;
+        blocks[2] = 0x1f;
+        blocks[3] = 0x00;
+        blocks[4] = 0x00;
+        blocks[5] = 0x55;
+        blocks[6] = 0x00;
+        blocks[7] = 0x00;
+
+        CompressedLevel level;
+        level.data_ = blocks.data();
+        level.format_ = CF_DXT1;
+        level.width_ = width;
+        level.height_ = height;
+        level.depth_ = 1;
+        level.blockSize_ = 8;
+
+        ea::vector<unsigned char> serial(width * height * 4);
+        ea::vector<unsigned char> parallel(width * height * 4);
+        REQUIRE(level.Decompress(serial.data()));
+        REQUIRE(level.Decompress(parallel.data(), workQueue));
+        REQUIRE(serial == parallel);
+
+        const unsigned char red[] = {255, 0, 0, 255};
+        const unsigned char blue[] = {0, 0, 255, 255};
+        CHECK(memcmp(&serial[0], red, 4) == 0);
+        CHECK(memcmp(&serial[width * 4 + 12], blue, 4) == 0);
+    }
+}
+
+TEST_CASE("Image processing benchmark", "[.][benchmark][image]")
+{
+    auto context = MakeShared<Context>();
+    auto workQueue = new WorkQueue(context);
+    context->RegisterSubsystem(workQueue);
+    workQueue->CreateThreads(ea::max(GetNumLogicalCPUs(), 2u) - 1);
+    Image::RegisterObject(context);
+
+    const int size = 4096;
+    const auto image = CreateNoiseImage(context, size, size, 4, 0);
+    const auto blocks = CreateDXT1Blocks(size, size, 0);
+    ea::vector<unsigned char> buffer(size * size * 4);
+
+    WARN("Worker threads: " << workQueue->GetNumThreads());
+
+    BENCHMARK("Box mip level, per-pixel reference")
+    {
+        return DownsampleReference(image->GetData(), size, size, 4).size();
+    };
+
+    BENCHMARK("Box mip level, single thread")
+    {
+        DownsampleImage(buffer.data(), image->GetData(), size, size, 4, ImageMipFilter::Box, false);
+        return buffer[0];
+    };
+
+    BENCHMARK("Box mip level")
+    {
+        return image->GetNextLevel(ImageMipFilter::Box, false)->GetWidth();
+    };
+
+    BENCHMARK("sRGB box mip level")
+    {
+        return image->GetNextLevel(ImageMipFilter::Box, true)->GetWidth();
+    };
+
+    BENCHMARK("sRGB Kaiser mip level")
+    {
+        return image->GetNextLevel(ImageMipFilter::Kaiser, true)->GetWidth();
+    };
+
+    BENCHMARK("Precalculate box mip chain")
+    {
+        image->PrecalculateLevels();
+        image->CleanupLevels();
+    };
+
+    BENCHMARK("Resize to 3000x3000")
+    {
+        ResampleImage(buffer.data(), 3000, 3000, image->GetData(), size, size, 4, workQueue);
+        return buffer[0];
+    };
+
+    BENCHMARK("Flip horizontally")
+    {
+        FlipImageHorizontal(buffer.data(), image->GetData(), size, size, 4, workQueue);
+        return buffer[0];
+    };
+
+    BENCHMARK("Flip vertically")
+    {
+        FlipImageVertical(buffer.data(), image->GetData(), size, size, 4, workQueue);
+        return buffer[0];
+    };
+
+    BENCHMARK("DXT1 decompression, single thread")
+    {
+        DecompressImageDXT(buffer.data(), blocks.data(), size, size, 1, CF_DXT1);
+        return buffer[0];
+    };
+
+    BENCHMARK("DXT1 decompression")
+    {
+        CompressedLevel level;
+        level.data_ = const_cast<unsigned char*>(blocks.data());
+        level.format_ = CF_DXT1;
+        level.width_ = size;
+        level.height_ = size;
+        level.depth_ = 1;
+        level.blockSize_ = 8;
+        level.Decompress(buffer.data(), workQueue);
+        return buffer[0];
+    };
+}
@@ -0,0 +1,273 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <catch2/catch_amalgamated.hpp>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/IO/ArchiveSerialization.h>
+#include <Urho3D/Resource/JSONArchive.h>
+#include <Urho3D/Resource/JSONFile.h>
+
+#include <rapidjson/document.h>
+
+#include "ArchiveTestRecord.h"
+
+using namespace Urho3D;
+using namespace Tests;
+
+namespace
+{
+
+/// Convert rapidjson DOM value to JSON value, the way JSONFile used to load documents.
+void ToJSONValueReference(JSONValue& jsonValue, const rapidjson::Value& value)
+{
+    switch (value.GetType())
+    {
+    case rapidjson::kNullType:
+        jsonValue.SetType(JSON_NULL);
+        break;
+
+    case rapidjson::kFalseType:
+    case rapidjson::kTrueType:
+        jsonValue = value.GetBool();
+        break;
+
+    case rapidjson::kNumberType:
+        if (value.IsInt())
+            jsonValue = value.GetInt();
+        else if (value.IsUint())
+            jsonValue = value.GetUint();
+        else
+            jsonValue = value.GetDouble();
+        break;
+
+    case rapidjson::kStringType:
+        jsonValue = value.GetString();
+        break;
+
+    case rapidjson::kArrayType:
+        jsonValue.Resize(value.Size());
+        for (unsigned i = 0; i < value.Size(); ++i)
+            ToJSONValueReference(jsonValue[i], value[i]);
+        break;
+
+    case rapidjson::kObjectType:
+        jsonValue.SetType(JSON_OBJECT);
+        for (auto i = value.MemberBegin(); i != value.MemberEnd(); ++i)
+            ToJSONValueReference(jsonValue[ea::string(i->name.GetString())], i->value);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/// Parse JSON through rapidjson DOM.
+JSONValue ParseReference(const ea::string& source)
+{
+    rapidjson::Document document;
+    document.Parse<rapidjson::kParseCommentsFlag | rapidjson::kParseTrailingCommasFlag>(source.c_str());
+    JSONValue result;
+    ToJSONValueReference(result, document);
+    return result;
+}
+
+/// Create JSON shaped like serialized scene.
+JSONValue CreateSceneLikeJSON(unsigned numNodes)
+{
+    JSONValue root;
+    root["type"] = "Scene";
+    root["id"] = 1;
+    JSONValue& nodes = root["children"];
+    nodes.SetType(JSON_ARRAY);
+    for (unsigned i = 0; i < numNodes; ++i)
+    {
+        JSONValue node;
+        node["id"] = static_cast<int>(i + 2);
+
+        JSONValue attributes;
+        const auto addAttribute = [&](const char* name, JSONValue value)
+        {
+            JSONValue attribute;
+            attribute["name"] = name;
+            attribute["value"] = ea::move(value);
+            attributes.Push(ea::move(attribute));
+        };
+        addAttribute("Is Enabled", i % 5 != 0);
+        addAttribute("Name", Format("Node \"{}\"\n", i));
+        addAttribute("Position", Format("{} {} {}", i * 0.5f, i * 0.25f, -1.0f * i));
+        addAttribute("Scale", i * 0.125);
+        addAttribute("Tags", i % 7 == 0 ? JSONValue{} : JSONValue(JSON_ARRAY));
+        addAttribute("Seed", 3000000000u + i);
+        addAttribute("Offset", -static_cast<int>(i));
+        node["attributes"] = ea::move(attributes);
+
+        JSONValue component;
+        component["type"] = "StaticModel";
+        component["id"] = static_cast<int>(16777216 + i);
+        component["attributes"].SetType(JSON_OBJECT);
+        node["components"].Push(ea::move(component));
+
+        nodes.Push(ea::move(node));
+    }
+    return root;
+}
+
+}
+
+TEST_CASE("JSON file is parsed into values", "[json]")
+{
+    auto context = MakeShared<Context>();
+    auto file = MakeShared<JSONFile>(context);
+
+    const ea::string source = R"({
+        // Comments and trailing commas are allowed in files
+        "null": null,
+        "true": true,
+        "false": false,
+        "int": -42,
+        "uint": 4000000000,
+        "smallUint": 7,
+        "int64": 12345678901234,
+        "double": 0.5,
+        "string": "a\"b\\c\né",
+        "empty": "",
+        "array": [1, [2, [3]], {}, [], ],
+        "object": { "nested": { "key": "value" }, },
+        "duplicate": 1,
+        "duplicate": 2,
+    })";
+    REQUIRE(file->FromString(source));
+
+    const JSONValue& root = file->GetRoot();
+    REQUIRE(root.IsObject());
+    REQUIRE(root.Size() == 13);
+    REQUIRE(root["null"].IsNull());
+    REQUIRE(root["true"].GetBool() == true);
+    REQUIRE(root["false"].GetBool() == false);
+    REQUIRE(root["int"].GetNumberType() == JSONNT_INT);
+    REQUIRE(root["int"].GetInt() == -42);
+    REQUIRE(root["uint"].GetNumberType() == JSONNT_UINT);
+    REQUIRE(root["uint"].GetUInt() == 4000000000u);
+    REQUIRE(root["smallUint"].GetNumberType() == JSONNT_INT);
+    REQUIRE(root["int64"].GetNumberType() == JSONNT_FLOAT_DOUBLE);
+    REQUIRE(root["int64"].GetDouble() == 12345678901234.0);
+    REQUIRE(root["double"].GetDouble() == 0.5);
+    REQUIRE(root["string"].GetString() == "a\"b\\c\n\xc3\xa9");
+    REQUIRE(root["empty"].IsString());
+    REQUIRE(root["array"].Size() == 4);
+    REQUIRE(root["array"][1][1][0].GetInt() == 3);
+    REQUIRE(root["array"][2].IsObject());
+    REQUIRE(root["array"][3].IsArray());
+    REQUIRE(root["object"]["nested"]["key"].GetString() == "value");
+    REQUIRE(root["duplicate"].GetInt() == 2);
+    REQUIRE(root == ParseReference(source));
+
+    // Failed parse keeps previous contents
+    REQUIRE_FALSE(file->FromString("{ \"key\": [1, 2 }"));
+    REQUIRE(file->GetRoot() == ParseReference(source));
+
+    JSONValue value;
+    REQUIRE(JSONFile::ParseJSON("[1, \"two\", { \"three\": 3.5 }]", value));
+    REQUIRE(value.Size() == 3);
+    REQUIRE(value[2]["three"].GetDouble() == 3.5);
+    REQUIRE_FALSE(JSONFile::ParseJSON("[1, // comment\n2]", value, false));
+    REQUIRE(value.Size() == 3);
+}
+
+TEST_CASE("JSON file matches rapidjson DOM conversion", "[json]")
+{
+    auto context = MakeShared<Context>();
+    const JSONValue scene = CreateSceneLikeJSON(200);
+
+    auto sourceFile = MakeShared<JSONFile>(context);
+    sourceFile->GetRoot() = scene;
+    const ea::string source = sourceFile->ToString();
+
+    auto file = MakeShared<JSONFile>(context);
+    REQUIRE(file->FromString(source));
+    REQUIRE(file->GetRoot() == ParseReference(source));
+    REQUIRE(file->GetRoot() == scene);
+    REQUIRE(file->ToString() == source);
+}
+
+TEST_CASE("JSON archive roundtrip", "[json][archive]")
+{
+    auto context = MakeShared<Context>();
+    ea::vector<ArchiveTestRecord> records = CreateRecords(64);
+
+    ea::string source;
+    {
+        auto file = MakeShared<JSONFile>(context);
+        JSONOutputArchive archive(file);
+        REQUIRE(SerializeRecords(archive, records));
+        source = file->ToString();
+    }
+
+    auto file = MakeShared<JSONFile>(context);
+    REQUIRE(file->FromString(source));
+
+    ea::vector<ArchiveTestRecord> loadedRecords;
+    JSONInputArchive archive(file);
+    REQUIRE(SerializeRecords(archive, loadedRecords));
+    REQUIRE(loadedRecords.size() == records.size());
+    for (unsigned i = 0; i < records.size(); ++i)
+        REQUIRE(loadedRecords[i] == records[i]);
+}
+
+TEST_CASE("JSON parsing benchmark", "[.][benchmark][json]")
+{
+    auto context = MakeShared<Context>();
+
+    auto sourceFile = MakeShared<JSONFile>(context);
+    sourceFile->GetRoot() = CreateSceneLikeJSON(5000);
+    const ea::string scene = sourceFile->ToString();
+
+    {
+        JSONOutputArchive archive(sourceFile);
+        ea::vector<ArchiveTestRecord> records = CreateRecords(10000);
+        SerializeRecords(archive, records);
+    }
+    const ea::string archiveSource = sourceFile->ToString();
+
+    BENCHMARK("Parse scene through rapidjson DOM")
+    {
+        return ParseReference(scene).Size();
+    };
+
+    BENCHMARK("Parse scene through JSONFile")
+    {
+        auto file = MakeShared<JSONFile>(context);
+        file->FromString(scene);
+        return file->GetRoot().Size();
+    };
+
+    BENCHMARK("Read archive from JSON")
+    {
+        auto file = MakeShared<JSONFile>(context);
+        file->FromString(archiveSource);
+        ea::vector<ArchiveTestRecord> loadedRecords;
+        JSONInputArchive archive(file);
+        SerializeRecords(archive, loadedRecords);
+        return loadedRecords.size();
+    };
+}
@@ -0,0 +1,53 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <catch2/catch_amalgamated.hpp>
+
+#include <Urho3D/Resource/JSONValue.h>
+
+using namespace Urho3D;
+
+TEST_CASE("JSON values compare by content", "[json]")
+{
+    REQUIRE(JSONValue{} == JSONValue{});
+    REQUIRE(JSONValue{} != JSONValue(false));
+    REQUIRE(JSONValue(false) != JSONValue{});
+    REQUIRE(JSONValue(1) == JSONValue(1u));
+    REQUIRE(JSONValue(1) != JSONValue(2));
+    REQUIRE(JSONValue("a") != JSONValue("b"));
+
+    JSONValue array;
+    array.Push(JSONValue{});
+    array.Push(1);
+    JSONValue sameArray = array;
+    REQUIRE(array == sameArray);
+    sameArray[0] = 0;
+    REQUIRE(array != sameArray);
+
+    JSONValue object;
+    object["null"] = JSONValue{};
+    object["nested"] = array;
+    JSONValue sameObject = object;
+    REQUIRE(object == sameObject);
+    sameObject["null"] = "";
+    REQUIRE(object != sameObject);
+}
@@ -0,0 +1,252 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <catch2/catch_amalgamated.hpp>
+#include <Urho3D/Urho3D.h>
+
+#ifdef URHO3D_GLOW
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Glow/BakedLight.h>
+#include <Urho3D/Glow/LightmapGeometryBuffer.h>
+#include <Urho3D/Glow/LightTracer.h>
+#include <Urho3D/Glow/RaytracerScene.h>
+#include <Urho3D/Graphics/Material.h>
+#include <Urho3D/Graphics/Model.h>
+#include <Urho3D/Graphics/ModelView.h>
+#include <Urho3D/Graphics/StaticModel.h>
+#include <Urho3D/Math/TetrahedralMesh.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include "TestUtils.h"
+
+using namespace Urho3D;
+using namespace Tests;
+
+namespace
+{
+
+/// Size of reference scene ground.
+const float GroundSize = 64.0f;
+/// Size of lightmap chart that covers the ground.
+const unsigned LightmapSize = 128;
+
+/// Add quad with given center, normal and half-size. Lightmap UV projects everything onto the ground.
+void AddQuad(GeometryLODView& geometry, const Vector3& center, const Vector3& normal, float halfWidth, float halfHeight)
+{
+    const Vector3 side = Abs(normal.y_) > 0.5f ? Vector3::RIGHT : Vector3::UP;
+    const Vector3 u = normal.CrossProduct(side).Normalized() * halfWidth;
+    const Vector3 v = normal.CrossProduct(u).Normalized() * halfHeight;
+
+    const unsigned base = geometry.vertices_.size();
+    for (const Vector3& position : { center - u - v, center + u - v, center + u + v, center - u + v })
+    {
+        ModelVertex vertex;
+        vertex.SetPosition(position);
+        vertex.normal_ = Vector4(normal, 0.0f);
+        vertex.uv_[1] = Vector4(position.x_ / GroundSize + 0.5f, position.z_ / GroundSize + 0.5f, 0.0f, 0.0f);
+        geometry.vertices_.push_back(vertex);
+    }
+    geometry.indices_.insert(geometry.indices_.end(), { base, base + 1, base + 2, base, base + 2, base + 3 });
+}
+
+/// Create model from single geometry.
+SharedPtr<Model> CreateModel(Context* context, const GeometryLODView& geometry)
+{
+    ModelVertexFormat vertexFormat;
+    vertexFormat.position_ = TYPE_VECTOR3;
+    vertexFormat.normal_ = TYPE_VECTOR3;
+    vertexFormat.uv_[0] = TYPE_VECTOR2;
+    vertexFormat.uv_[1] = TYPE_VECTOR2;
+
+    GeometryView geometryView;
+    geometryView.lods_.push_back(geometry);
+
+    auto modelView = MakeShared<ModelView>(context);
+    modelView->SetVertexFormat(vertexFormat);
+    modelView->SetGeometries({ geometryView });
+    return modelView->ExportModel();
+}
+
+/// Create reference scene: ground with grid of boxes.
+SharedPtr<RaytracerScene> CreateReferenceScene(Context* context)
+{
+    auto scene = MakeShared<Scene>(context);
+    auto material = MakeShared<Material>(context);
+    ea::vector<Component*> geometries;
+
+    const auto addModel = [&](const GeometryLODView& geometry)
+    {
+        auto staticModel = scene->CreateChild()->CreateComponent<StaticModel>();
+        staticModel->SetModel(CreateModel(context, geometry));
+        staticModel->SetMaterial(material);
+        staticModel->SetBakeLightmap(true);
+        staticModel->SetLightmapIndex(0);
+        staticModel->SetLightmapScaleOffset({ 1.0f, 1.0f, 0.0f, 0.0f });
+        geometries.push_back(staticModel);
+    };
+
+    GeometryLODView ground;
+    AddQuad(ground, Vector3::ZERO, Vector3::UP, GroundSize * 0.5f, GroundSize * 0.5f);
+    addModel(ground);
+
+    const unsigned numBoxes = 8;
+    const Vector3 boxHalfSize{ 1.5f, 3.0f, 1.5f };
+    for (unsigned x = 0; x < numBoxes; ++x)
+    {
+        for (unsigned z = 0; z < numBoxes; ++z)
+        {
+            const Vector3 center{ (x + 0.5f) * GroundSize / numBoxes - GroundSize * 0.5f, boxHalfSize.y_,
+                (z + 0.5f) * GroundSize / numBoxes - GroundSize * 0.5f };
+
+            GeometryLODView box;
+            for (const Vector3& normal : { Vector3::LEFT, Vector3::RIGHT, Vector3::FORWARD, Vector3::BACK, Vector3::UP })
+            {
+                const Vector3 halfSize = boxHalfSize * VectorAbs(Vector3::ONE - VectorAbs(normal));
+                const float halfHeight = Abs(normal.y_) > 0.5f ? halfSize.x_ : halfSize.y_;
+                const float halfWidth = Abs(normal.y_) > 0.5f ? halfSize.z_ : ea::max(halfSize.x_, halfSize.z_);
+                AddQuad(box, center + normal * boxHalfSize, normal, halfWidth, halfHeight);
+            }
+            addModel(box);
+        }
+    }
+
+    BakedSceneBackground background;
+    background.intensity_ = 1.0f;
+    background.color_ = Color(0.5f, 0.6f, 0.8f);
+    auto backgrounds = ea::make_shared<ea::vector<BakedSceneBackground>>(1, background);
+
+    return CreateRaytracingScene(context, geometries, 1, backgrounds);
+}
+
+/// Create geometry buffer for the ground.
+LightmapChartGeometryBuffer CreateGroundGeometryBuffer()
+{
+    LightmapChartGeometryBuffer geometryBuffer{ 0, LightmapSize };
+    const float texelSize = GroundSize / LightmapSize;
+    for (unsigned y = 0; y < LightmapSize; ++y)
+    {
+        for (unsigned x = 0; x < LightmapSize; ++x)
+        {
+            const unsigned index = geometryBuffer.LocationToIndex({ static_cast<int>(x), static_cast<int>(y) });
+            geometryBuffer.positions_[index] = Vector3((x + 0.5f) * texelSize, 0.01f, (y + 0.5f) * texelSize)
+                - Vector3(GroundSize, 0.0f, GroundSize) * 0.5f;
+            geometryBuffer.smoothNormals_[index] = Vector3::UP;
+            geometryBuffer.faceNormals_[index] = Vector3::UP;
+            geometryBuffer.geometryIds_[index] = 1;
+            geometryBuffer.lightMasks_[index] = M_MAX_UNSIGNED;
+            geometryBuffer.texelRadiuses_[index] = texelSize * 0.5f;
+            geometryBuffer.albedo_[index] = Vector3::ONE * 0.5f;
+        }
+    }
+    return geometryBuffer;
+}
+
+/// Create directional light.
+BakedLight CreateDirectionalLight(float angle)
+{
+    BakedLight light;
+    light.lightType_ = LIGHT_DIRECTIONAL;
+    light.lightMode_ = LM_BAKED;
+    light.lightMask_ = M_MAX_UNSIGNED;
+    light.color_ = Color::WHITE;
+    light.indirectBrightness_ = 1.0f;
+    light.angle_ = angle;
+    light.halfAngleTan_ = Tan(angle / 2.0f);
+    light.direction_ = Vector3(1.0f, -2.0f, 0.5f).Normalized();
+    light.rotation_ = Quaternion(Vector3::FORWARD, light.direction_);
+    return light;
+}
+
+}
+
+TEST_CASE("Packet tracing matches single ray tracing", "[glow]")
+{
+    auto context = CreateTestContext(TestContextFlag::Resources | TestContextFlag::Graphics);
+    const SharedPtr<RaytracerScene> scene = CreateReferenceScene(context);
+    const LightmapChartGeometryBuffer geometryBuffer = CreateGroundGeometryBuffer();
+    const ea::vector<unsigned> geometryBufferToRaytracer{ 0, 0 };
+    const BakedLight light = CreateDirectionalLight(0.0f);
+
+    DirectLightTracingSettings singleRaySettings;
+    singleRaySettings.usePacketTracing_ = false;
+    LightmapChartBakedDirect singleRayDirect{ LightmapSize };
+    BakeDirectLightForCharts(singleRayDirect, geometryBuffer, *scene, geometryBufferToRaytracer, light, singleRaySettings);
+
+    DirectLightTracingSettings packetSettings;
+    packetSettings.usePacketTracing_ = true;
+    LightmapChartBakedDirect packetDirect{ LightmapSize };
+    BakeDirectLightForCharts(packetDirect, geometryBuffer, *scene, geometryBufferToRaytracer, light, packetSettings);
+
+    // Hard light is deterministic, so results should be exactly the same
+    unsigned numShadowed = 0;
+    for (unsigned i = 0; i < LightmapSize * LightmapSize; ++i)
+    {
+        REQUIRE(singleRayDirect.directLight_[i] == packetDirect.directLight_[i]);
+        if (packetDirect.directLight_[i] == Vector3::ZERO)
+            ++numShadowed;
+    }
+    CHECK(numShadowed > 0);
+    CHECK(numShadowed < LightmapSize * LightmapSize);
+}
+
+TEST_CASE("Light baking benchmark", "[.][benchmark][glow]")
+{
+    auto context = CreateTestContext(TestContextFlag::Resources | TestContextFlag::Graphics);
+    const SharedPtr<RaytracerScene> scene = CreateReferenceScene(context);
+    const LightmapChartGeometryBuffer geometryBuffer = CreateGroundGeometryBuffer();
+    const ea::vector<unsigned> geometryBufferToRaytracer{ 0, 0 };
+    const BakedLight light = CreateDirectionalLight(5.0f * M_DEGTORAD);
+
+    const TetrahedralMesh lightProbesMesh;
+    const LightProbeCollectionBakedData lightProbesData;
+    const unsigned numElements = LightmapSize * LightmapSize;
+
+    for (bool usePacketTracing : { false, true })
+    {
+        DirectLightTracingSettings directSettings{ 32 };
+        directSettings.usePacketTracing_ = usePacketTracing;
+        IndirectLightTracingSettings indirectSettings{ 32, 2 };
+        indirectSettings.usePacketTracing_ = usePacketTracing;
+
+        LightmapChartBakedDirect bakedDirect{ LightmapSize };
+        LightmapChartBakedIndirect bakedIndirect{ LightmapSize };
+
+        HiresTimer timer;
+        BakeDirectLightForCharts(bakedDirect, geometryBuffer, *scene, geometryBufferToRaytracer, light, directSettings);
+        const long long directTime = timer.GetUSec(true);
+        BakeIndirectLightForCharts(bakedIndirect, { &bakedDirect }, geometryBuffer,
+            lightProbesMesh, lightProbesData, *scene, geometryBufferToRaytracer, indirectSettings);
+        const long long indirectTime = timer.GetUSec(false);
+
+        const double numDirectRays = static_cast<double>(numElements) * directSettings.maxSamples_;
+        const double numIndirectSamples = static_cast<double>(numElements) * indirectSettings.maxSamples_;
+        WARN((usePacketTracing ? "Packet tracing" : "Single ray tracing")
+            << ": direct " << numDirectRays / directTime << " Mrays/s, indirect "
+            << numIndirectSamples / indirectTime << " Msamples/s, total bake time "
+            << (directTime + indirectTime) / 1000 << " ms");
+    }
+}
+
+#endif
@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <catch2/catch_amalgamated.hpp>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/IO/IOEvents.h>
+#include <Urho3D/IO/Log.h>
+
+#include <cstring>
+#include <thread>
+
+using namespace Urho3D;
+
+TEST_CASE("Deferred log messages own their format strings", "[log]")
+{
+    auto context = MakeShared<Context>();
+    auto log = MakeShared<Log>(context);
+    context->RegisterSubsystem(log);
+    log->SetQuiet(true);
+    log->SetAsync(true);
+
+    ea::vector<ea::string> messages;
+    log->SubscribeToEvent(E_LOGMESSAGE, [&](StringHash, VariantMap& eventData)
+    {
+        messages.push_back(eventData[LogMessage::P_MESSAGE].GetString());
+    });
+
+    const Logger logger = Log::GetLogger("test");
+    const unsigned numThreads = 4;
+    const unsigned numMessages = 16;
+    ea::vector<std::thread> threads;
+    for (unsigned threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+    {
+        threads.emplace_back([&logger, threadIndex]()
+        {
+            // Format string is overwritten right after the message is queued
+            char format[32];
+            for (unsigned i = 0; i < numMessages; ++i)
+            {
+                strcpy(format, "Thread {} message {}");
+                logger.Info(format, threadIndex, i);
+                strcpy(format, "Garbage {} {}");
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    // Queues of exited threads are drained and released
+    log->Flush();
+    log->SendEvent(E_ENDFRAME);
+
+    REQUIRE(messages.size() == numThreads * numMessages);
+    for (const ea::string& message : messages)
+        REQUIRE(message.starts_with("Thread "));
+
+    log->SetAsync(false);
+}
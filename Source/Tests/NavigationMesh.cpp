@@ -0,0 +1,272 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <catch2/catch_amalgamated.hpp>
+#include <Urho3D/Urho3D.h>
+
+#ifdef URHO3D_NAVIGATION
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/Graphics/Model.h>
+#include <Urho3D/Graphics/Octree.h>
+#include <Urho3D/Graphics/StaticModel.h>
+#include <Urho3D/Navigation/CrowdAgent.h>
+#include <Urho3D/Navigation/CrowdManager.h>
+#include <Urho3D/Navigation/Navigable.h>
+#include <Urho3D/Navigation/NavigationEvents.h>
+#include <Urho3D/Navigation/NavigationMesh.h>
+#include <Urho3D/Navigation/NavigationPathService.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include "TestUtils.h"
+
+#include <mutex>
+#include <thread>
+
+using namespace Urho3D;
+using namespace Tests;
+
+namespace
+{
+
+/// Subsystems and libraries needed for navigation.
+const TestContextFlags NavigationContextFlags = TestContextFlag::Resources | TestContextFlag::WorkQueue
+    | TestContextFlag::Graphics | TestContextFlag::Navigation;
+
+/// Crowd agent that records threads of velocity updates.
+class ThreadRecordingCrowdAgent : public CrowdAgent
+{
+    URHO3D_OBJECT(ThreadRecordingCrowdAgent, CrowdAgent);
+
+public:
+    using CrowdAgent::CrowdAgent;
+
+    /// Threads of velocity updates.
+    static ea::vector<std::thread::id> threads_;
+    /// Mutex for threads.
+    static std::mutex mutex_;
+
+protected:
+    /// Record thread and update velocity.
+    void OnCrowdVelocityUpdate(dtCrowdAgent* ag, float* pos, float dt) override
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            threads_.push_back(std::this_thread::get_id());
+        }
+        CrowdAgent::OnCrowdVelocityUpdate(ag, pos, dt);
+    }
+};
+
+ea::vector<std::thread::id> ThreadRecordingCrowdAgent::threads_;
+std::mutex ThreadRecordingCrowdAgent::mutex_;
+
+/// Create scene with 64x64 floor and navigation mesh built over it.
+SharedPtr<Scene> CreateNavigationScene(Context* context)
+{
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateComponent<Octree>();
+    scene->CreateComponent<Navigable>();
+
+    Node* floorNode = scene->CreateChild("Floor");
+    floorNode->SetScale(Vector3(64.0f, 1.0f, 64.0f));
+    auto floor = floorNode->CreateComponent<StaticModel>();
+    floor->SetModel(CreateQuadModel(context));
+
+    auto navMesh = scene->CreateComponent<NavigationMesh>();
+    navMesh->SetTileSize(16);
+    navMesh->SetCellSize(0.5f);
+    navMesh->SetAgentRadius(0.5f);
+    navMesh->Build();
+    return scene;
+}
+
+}
+
+TEST_CASE("Navigation mesh is rebuilt asynchronously with current parameters", "[navigation]")
+{
+    auto context = CreateTestContext(NavigationContextFlags);
+    auto scene = CreateNavigationScene(context);
+    auto navMesh = scene->GetComponent<NavigationMesh>();
+    Node* floorNode = scene->GetChild("Floor");
+
+    const Vector3 probe{ 40.0f, 0.0f, 0.0f };
+    const Vector3 extents{ 20.0f, 2.0f, 2.0f };
+    REQUIRE(navMesh->FindNearestPoint(probe, extents).x_ == Catch::Approx(31.5f).margin(0.5f));
+
+    // Shrink the floor and queue rebuild of the whole navigation mesh
+    floorNode->SetScale(Vector3(48.0f, 1.0f, 48.0f));
+    navMesh->BuildAsync(BoundingBox(-100.0f * Vector3::ONE, 100.0f * Vector3::ONE));
+    const unsigned numTiles = navMesh->GetNumPendingTiles();
+    REQUIRE(numTiles > 0);
+
+    // Rebuild is started at frame start. Change of parameters cancels it and queues the tiles again
+    scene->SendEvent(E_BEGINFRAME);
+    navMesh->SetAgentRadius(2.0f);
+    REQUIRE(navMesh->GetNumPendingTiles() == numTiles);
+
+    navMesh->CompleteAsyncBuild();
+    REQUIRE(navMesh->GetNumPendingTiles() == 0);
+    const Vector3 asyncPoint = navMesh->FindNearestPoint(probe, extents);
+    REQUIRE(asyncPoint.x_ == Catch::Approx(22.0f).margin(0.5f));
+
+    // Synchronous rebuild gives the same result
+    REQUIRE(navMesh->Build());
+    REQUIRE(navMesh->FindNearestPoint(probe, extents).Equals(asyncPoint));
+
+    // Synchronous partial rebuild replaces pending asynchronous rebuild of the same tiles
+    const BoundingBox allTiles{ -100.0f * Vector3::ONE, 100.0f * Vector3::ONE };
+    floorNode->SetScale(Vector3(32.0f, 1.0f, 32.0f));
+    navMesh->BuildAsync(allTiles);
+    scene->SendEvent(E_BEGINFRAME);
+    REQUIRE(navMesh->GetNumPendingTiles() > 0);
+
+    floorNode->SetScale(Vector3(46.0f, 1.0f, 46.0f));
+    REQUIRE(navMesh->Build(allTiles));
+    REQUIRE(navMesh->GetNumPendingTiles() == 0);
+
+    navMesh->CompleteAsyncBuild();
+    scene->SendEvent(E_BEGINFRAME);
+    REQUIRE(navMesh->FindNearestPoint(probe, extents).x_ == Catch::Approx(21.0f).margin(0.5f));
+}
+
+TEST_CASE("Crowd may be recreated by agent event handlers", "[navigation]")
+{
+    auto context = CreateTestContext(NavigationContextFlags);
+    auto scene = CreateNavigationScene(context);
+
+    auto crowdManager = scene->CreateComponent<CrowdManager>();
+    crowdManager->SetNavigationMesh(scene->GetComponent<NavigationMesh>());
+    crowdManager->SetRegionSize(16.0f);
+
+    ea::vector<CrowdAgent*> agents;
+    for (float x : { -24.0f, -8.0f, 8.0f, 24.0f })
+    {
+        for (float z : { -24.0f, -8.0f, 8.0f, 24.0f })
+        {
+            Node* node = scene->CreateChild();
+            node->SetPosition({ x, 0.0f, z });
+            auto agent = node->CreateComponent<CrowdAgent>();
+            agent->SetMaxSpeed(3.0f);
+            agent->SetMaxAccel(5.0f);
+            agent->SetTargetPosition({ -x, 0.0f, -z });
+            agents.push_back(agent);
+        }
+    }
+
+    // Recreating the crowd with single region shrinks agent states while they are being synchronized
+    unsigned numRepositions = 0;
+    crowdManager->SubscribeToEvent(crowdManager, E_CROWD_AGENT_REPOSITION, [&](StringHash, VariantMap&)
+    {
+        if (numRepositions++ == 0)
+            crowdManager->SetRegionSize(0.0f);
+    });
+
+    for (unsigned i = 0; i < 10; ++i)
+        scene->Update(0.1f);
+
+    REQUIRE(numRepositions > 0);
+    for (CrowdAgent* agent : agents)
+        REQUIRE(agent->IsInCrowd());
+}
+
+TEST_CASE("Crowd agents are updated in main thread if threaded update is disabled", "[navigation]")
+{
+    auto context = CreateTestContext(NavigationContextFlags);
+    context->RegisterFactory<ThreadRecordingCrowdAgent>();
+    auto scene = CreateNavigationScene(context);
+
+    auto crowdManager = scene->CreateComponent<CrowdManager>();
+    crowdManager->SetNavigationMesh(scene->GetComponent<NavigationMesh>());
+    crowdManager->SetRegionSize(16.0f);
+    crowdManager->SetThreadedUpdate(false);
+
+    for (float x : { -24.0f, -8.0f, 8.0f, 24.0f })
+    {
+        for (float z : { -24.0f, -8.0f, 8.0f, 24.0f })
+        {
+            Node* node = scene->CreateChild();
+            node->SetPosition({ x, 0.0f, z });
+            auto agent = node->CreateComponent<ThreadRecordingCrowdAgent>();
+            agent->SetTargetPosition({ -x, 0.0f, -z });
+        }
+    }
+
+    ThreadRecordingCrowdAgent::threads_.clear();
+    for (unsigned i = 0; i < 10; ++i)
+        scene->Update(0.1f);
+    REQUIRE(crowdManager->GetNumRegions() > 1);
+
+    REQUIRE_FALSE(ThreadRecordingCrowdAgent::threads_.empty());
+    for (const std::thread::id& thread : ThreadRecordingCrowdAgent::threads_)
+        REQUIRE(thread == std::this_thread::get_id());
+}
+
+TEST_CASE("Path service evicts least recently used paths", "[navigation]")
+{
+    auto context = CreateTestContext(NavigationContextFlags);
+    auto scene = CreateNavigationScene(context);
+
+    auto pathService = scene->CreateComponent<NavigationPathService>();
+    pathService->SetNavigationMesh(scene->GetComponent<NavigationMesh>());
+    pathService->SetMaxCachedPaths(2);
+
+    const auto isPathCached = [&](const Vector3& end)
+    {
+        bool success = false;
+        bool cached = false;
+        pathService->RequestPath(Vector3(-24.0f, 0.0f, -24.0f), end, [&](const NavigationPathResult& result)
+        {
+            success = result.success_;
+            cached = result.cached_;
+        });
+        pathService->Update();
+        REQUIRE(success);
+        return cached;
+    };
+
+    const Vector3 endA{ 24.0f, 0.0f, -24.0f };
+    const Vector3 endB{ 24.0f, 0.0f, 24.0f };
+    const Vector3 endC{ -24.0f, 0.0f, 24.0f };
+    REQUIRE_FALSE(isPathCached(endA));
+    REQUIRE_FALSE(isPathCached(endB));
+    REQUIRE(isPathCached(endA));
+
+    // Path to B is least recently used and is evicted
+    REQUIRE_FALSE(isPathCached(endC));
+    REQUIRE(isPathCached(endA));
+    REQUIRE(isPathCached(endC));
+    REQUIRE_FALSE(isPathCached(endB));
+
+    // Requests served from the cache still consume iterations
+    pathService->SetMaxIterations(1);
+    const unsigned numSlots = context->GetSubsystem<WorkQueue>()->GetNumThreads() + 1;
+    const unsigned numRequests = numSlots * 3;
+    for (unsigned i = 0; i < numRequests; ++i)
+        pathService->RequestPath(Vector3(-24.0f, 0.0f, -24.0f), endB, nullptr);
+    pathService->Update();
+    REQUIRE(pathService->GetNumPendingRequests() >= numRequests - numSlots);
+}
+
+#endif
@@ -0,0 +1,197 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <catch2/catch_amalgamated.hpp>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/StringUtils.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/IO/PackageBuilder.h>
+#include <Urho3D/IO/PackageFile.h>
+#include <Urho3D/Math/RandomEngine.h>
+
+using namespace Urho3D;
+
+namespace
+{
+
+/// Create compressible binary data.
+ea::vector<unsigned char> CreateTestData(RandomEngine& random, unsigned size)
+{
+    ea::vector<unsigned char> data(size);
+    for (unsigned i = 0; i < size; ++i)
+        data[i] = static_cast<unsigned char>(random.GetUInt(0, 16) * 3 + i % 7);
+    return data;
+}
+
+/// Create small JSON file.
+ea::vector<unsigned char> CreateTestJson(RandomEngine& random)
+{
+    ea::string text = "{\n    \"components\": [\n";
+    const unsigned numComponents = random.GetUInt(4, 16);
+    for (unsigned i = 0; i < numComponents; ++i)
+    {
+        text += Format("        {{ \"type\": \"StaticModel\", \"id\": {}, \"enabled\": true, \"position\": [{}, {}, {}] }},\n",
+            random.GetUInt(), random.GetFloat(0.0f, 1.0f), random.GetFloat(0.0f, 1.0f), random.GetFloat(0.0f, 1.0f));
+    }
+    text += "    ]\n}\n";
+    return ea::vector<unsigned char>(text.begin(), text.end());
+}
+
+}
+
+TEST_CASE("Package files are read from any offset", "[io]")
+{
+    auto context = MakeShared<Context>();
+    auto fileSystem = MakeShared<FileSystem>(context);
+    auto workQueue = new WorkQueue(context);
+    context->RegisterSubsystem(fileSystem);
+    context->RegisterSubsystem(workQueue);
+    workQueue->CreateThreads(ea::max(GetNumLogicalCPUs(), 2u) - 1);
+
+    const ea::string tempDir = fileSystem->GetTemporaryDir() + "PackageFileTest/";
+    fileSystem->RemoveDir(tempDir, true);
+    REQUIRE(fileSystem->CreateDirsRecursive(tempDir + "Data"));
+
+    RandomEngine random(0);
+    ea::unordered_map<ea::string, ea::vector<unsigned char>> files;
+    files["Large.bin"] = CreateTestData(random, 3 * PACKAGE_BLOCK_SIZE + 1000);
+    files["Block.bin"] = CreateTestData(random, PACKAGE_BLOCK_SIZE);
+    files["Empty.bin"] = {};
+    for (unsigned i = 0; i < 32; ++i)
+        files[Format("Scene{}.json", i)] = CreateTestJson(random);
+
+    for (const auto& [name, data] : files)
+    {
+        File file(context, tempDir + "Data/" + name, FILE_WRITE);
+        file.Write(data.data(), data.size());
+    }
+
+    for (bool compress : {false, true})
+    {
+        const ea::string packageName = tempDir + (compress ? "Compressed.pak" : "Uncompressed.pak");
+        {
+            PackageBuilder builder(context);
+            REQUIRE(builder.Create(packageName, compress));
+            builder.SetDictionaryEnabled(true);
+            for (const auto& [name, data] : files)
+                builder.AddFile(name, tempDir + "Data/" + name);
+            REQUIRE(builder.Finish());
+            REQUIRE(builder.GetEntries().size() == files.size());
+            REQUIRE((builder.GetDictionarySize() > 0) == compress);
+        }
+
+        auto package = MakeShared<PackageFile>(context, packageName);
+        REQUIRE(package->GetNumFiles() == files.size());
+        REQUIRE(package->IsCompressed() == compress);
+        REQUIRE(package->HasBlockIndex() == compress);
+        if (compress)
+            REQUIRE(package->GetEntry("Scene0.json")->useDictionary_);
+
+        for (const auto& [name, data] : files)
+        {
+            File file(context, package, name);
+            REQUIRE(file.IsOpen());
+            REQUIRE(file.GetSize() == data.size());
+            REQUIRE(file.ReadBinary() == data);
+
+            if (data.empty())
+                continue;
+
+            // Random seeks both forward and backward
+            for (unsigned i = 0; i < 64; ++i)
+            {
+                const unsigned offset = random.GetUInt(0, data.size());
+                const unsigned size = ea::min(random.GetUInt(1, 2 * PACKAGE_BLOCK_SIZE), data.size() - offset);
+                ea::vector<unsigned char> buffer(size);
+                REQUIRE(file.Seek(offset) == offset);
+                REQUIRE(file.Read(buffer.data(), size) == size);
+                REQUIRE(ea::equal(buffer.begin(), buffer.end(), data.begin() + offset));
+                REQUIRE(file.Tell() == offset + size);
+            }
+
+            REQUIRE(file.Seek(data.size()) == data.size());
+            REQUIRE(file.IsEof());
+        }
+    }
+
+    fileSystem->RemoveDir(tempDir, true);
+}
+
+TEST_CASE("Corrupted package blocks are not decompressed", "[io]")
+{
+    auto context = MakeShared<Context>();
+    auto fileSystem = MakeShared<FileSystem>(context);
+    context->RegisterSubsystem(fileSystem);
+
+    const ea::string tempDir = fileSystem->GetTemporaryDir() + "PackageFileCorruptionTest/";
+    fileSystem->RemoveDir(tempDir, true);
+    REQUIRE(fileSystem->CreateDirsRecursive(tempDir));
+
+    RandomEngine random(0);
+    const ea::vector<unsigned char> data = CreateTestData(random, 2 * PACKAGE_BLOCK_SIZE);
+    {
+        File file(context, tempDir + "Data.bin", FILE_WRITE);
+        file.Write(data.data(), data.size());
+    }
+
+    const ea::string packageName = tempDir + "Compressed.pak";
+    {
+        PackageBuilder builder(context);
+        REQUIRE(builder.Create(packageName, true));
+        builder.AddFile("Data.bin", tempDir + "Data.bin");
+        REQUIRE(builder.Finish());
+    }
+
+    const unsigned offset = MakeShared<PackageFile>(context, packageName)->GetEntry("Data.bin")->offset_;
+    const auto corruptPackage = [&](unsigned position, const ea::vector<unsigned char>& bytes)
+    {
+        File file(context, packageName, FILE_READWRITE);
+        REQUIRE(file.Seek(offset + position) == offset + position);
+        REQUIRE(file.Write(bytes.data(), bytes.size()) == bytes.size());
+    };
+
+    SECTION("unpacked size is larger than block")
+    {
+        corruptPackage(0, { 0xff, 0xff });
+    }
+
+    SECTION("packed data is invalid")
+    {
+        corruptPackage(4, ea::vector<unsigned char>(64, 0xff));
+    }
+
+    auto package = MakeShared<PackageFile>(context, packageName);
+    File file(context, package, "Data.bin");
+    REQUIRE(file.IsOpen());
+
+    ea::vector<unsigned char> buffer(data.size());
+    REQUIRE(file.Read(buffer.data(), buffer.size()) < buffer.size());
+
+    file.Close();
+    package = nullptr;
+    fileSystem->RemoveDir(tempDir, true);
+}
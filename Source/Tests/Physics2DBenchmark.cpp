@@ -0,0 +1,223 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <catch2/catch_amalgamated.hpp>
+#include <Urho3D/Urho3D.h>
+
+#ifdef URHO3D_URHO2D
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Scene/Scene.h>
+#include <Urho3D/Urho2D/CollisionBox2D.h>
+#include <Urho3D/Urho2D/CollisionCircle2D.h>
+#include <Urho3D/Urho2D/PhysicsEvents2D.h>
+#include <Urho3D/Urho2D/PhysicsUtils2D.h>
+#include <Urho3D/Urho2D/PhysicsWorld2D.h>
+#include <Urho3D/Urho2D/RigidBody2D.h>
+
+#include <Box2D/Box2D.h>
+
+#include "TestUtils.h"
+
+using namespace Urho3D;
+using namespace Tests;
+
+namespace
+{
+
+/// Create scene with static ground and a pile of falling boxes and balls.
+SharedPtr<Scene> CreatePhysicsScene(Context* context, unsigned numBodies)
+{
+    auto scene = MakeShared<Scene>(context);
+    scene->CreateComponent<PhysicsWorld2D>();
+
+    Node* groundNode = scene->CreateChild("Ground");
+    groundNode->SetPosition(Vector3(0.0f, -3.0f, 0.0f));
+    groundNode->SetScale(Vector3(200.0f, 1.0f, 0.0f));
+    groundNode->CreateComponent<RigidBody2D>();
+    auto groundShape = groundNode->CreateComponent<CollisionBox2D>();
+    groundShape->SetSize(Vector2(1.0f, 1.0f));
+    groundShape->SetFriction(0.5f);
+
+    static const unsigned bodiesPerRow = 50;
+    for (unsigned i = 0; i < numBodies; ++i)
+    {
+        const float x = (static_cast<float>(i % bodiesPerRow) - bodiesPerRow * 0.5f) * 0.4f + (i / bodiesPerRow % 2) * 0.1f;
+        const float y = 0.5f * (i / bodiesPerRow);
+
+        Node* node = scene->CreateChild("Body");
+        node->SetPosition(Vector3(x, y, 0.0f));
+        auto body = node->CreateComponent<RigidBody2D>();
+        body->SetBodyType(BT_DYNAMIC);
+
+        CollisionShape2D* shape = nullptr;
+        if (i % 2 == 0)
+        {
+            auto box = node->CreateComponent<CollisionBox2D>();
+            box->SetSize(Vector2(0.3f, 0.3f));
+            shape = box;
+        }
+        else
+        {
+            auto circle = node->CreateComponent<CollisionCircle2D>();
+            circle->SetRadius(0.15f);
+            shape = circle;
+        }
+        shape->SetDensity(1.0f);
+        shape->SetFriction(0.5f);
+        shape->SetRestitution(0.1f);
+    }
+
+    return scene;
+}
+
+/// Collects contacts delivered by physics world.
+struct ContactCounter : public Object
+{
+    URHO3D_OBJECT(ContactCounter, Object);
+
+    explicit ContactCounter(Context* context)
+        : Object(context)
+    {
+        SubscribeToEvent(E_PHYSICSCONTACTS2D, [this](StringHash, VariantMap& eventData)
+        {
+            auto world = static_cast<PhysicsWorld2D*>(eventData[PhysicsContacts2D::P_WORLD].GetPtr());
+            numBeginContacts_ += world->GetBeginContacts().size();
+            numEndContacts_ += world->GetEndContacts().size();
+            for (const PhysicsContact2D& contact : world->GetBeginContacts())
+            {
+                if (!contact.nodeA_ || !contact.nodeB_ || !contact.bodyA_ || !contact.bodyB_)
+                    ++numInvalidContacts_;
+            }
+        });
+        SubscribeToEvent(E_PHYSICSBEGINCONTACT2D, [this](StringHash, VariantMap&) { ++numBeginContactEvents_; });
+        SubscribeToEvent(E_PHYSICSENDCONTACT2D, [this](StringHash, VariantMap&) { ++numEndContactEvents_; });
+    }
+
+    unsigned numBeginContacts_{};
+    unsigned numEndContacts_{};
+    unsigned numInvalidContacts_{};
+    unsigned numBeginContactEvents_{};
+    unsigned numEndContactEvents_{};
+};
+
+/// Return max distance between node and Box2D body positions.
+float GetMaxPositionError(Scene* scene)
+{
+    float maxError = 0.0f;
+    ea::vector<RigidBody2D*> bodies;
+    scene->GetComponents<RigidBody2D>(bodies, true);
+    for (RigidBody2D* body : bodies)
+    {
+        const Vector2 bodyPosition = ToVector2(body->GetBody()->GetPosition());
+        const float error = (body->GetNode()->GetWorldPosition2D() - bodyPosition).Length();
+        maxError = Max(maxError, error);
+    }
+    return maxError;
+}
+
+}
+
+TEST_CASE("2D physics applies transforms and delivers contacts", "[urho2d]")
+{
+    auto context = CreateTestContext(TestContextFlag::Urho2D);
+    auto scene = CreatePhysicsScene(context, 200);
+    auto physicsWorld = scene->GetComponent<PhysicsWorld2D>();
+
+    // Body parented to moved and rotated node
+    Node* parentNode = scene->CreateChild("Parent");
+    parentNode->SetPosition(Vector3(3.0f, 4.0f, 0.0f));
+    parentNode->SetRotation(Quaternion(30.0f));
+    Node* childNode = parentNode->CreateChild("Child");
+    childNode->SetPosition(Vector3(1.0f, 0.0f, 0.0f));
+    auto childBody = childNode->CreateComponent<RigidBody2D>();
+    childBody->SetBodyType(BT_DYNAMIC);
+    childNode->CreateComponent<CollisionCircle2D>()->SetRadius(0.2f);
+
+    auto counter = MakeShared<ContactCounter>(context);
+    for (unsigned i = 0; i < 120; ++i)
+        physicsWorld->Update(1.0f / 60.0f);
+
+    REQUIRE(GetMaxPositionError(scene) < 0.001f);
+    REQUIRE(childNode->GetWorldPosition2D().y_ < 4.0f);
+    const float childAngle = childBody->GetBody()->GetAngle();
+    const Vector3 childDirection = childNode->GetWorldRotation() * Vector3::RIGHT;
+    REQUIRE(childDirection.Equals(Vector3(Cos(ToDegrees(childAngle)), Sin(ToDegrees(childAngle)), 0.0f), 0.001f));
+
+    REQUIRE(counter->numBeginContacts_ > 0);
+    REQUIRE(counter->numInvalidContacts_ == 0);
+    REQUIRE(counter->numBeginContacts_ == counter->numBeginContactEvents_);
+    REQUIRE(counter->numEndContacts_ == counter->numEndContactEvents_);
+
+    // Contact records are delivered even when per-contact events are disabled
+    physicsWorld->SetContactEventsEnabled(false);
+    const unsigned numBeginContactEvents = counter->numBeginContactEvents_;
+    const unsigned numBeginContacts = counter->numBeginContacts_;
+    childBody->SetLinearVelocity(Vector2(0.0f, -20.0f));
+    for (unsigned i = 0; i < 120; ++i)
+        physicsWorld->Update(1.0f / 60.0f);
+
+    REQUIRE(counter->numBeginContactEvents_ == numBeginContactEvents);
+    REQUIRE(counter->numBeginContacts_ > numBeginContacts);
+    REQUIRE(GetMaxPositionError(scene) < 0.001f);
+}
+
+TEST_CASE("2D physics stepping benchmark", "[.][benchmark][urho2d]")
+{
+    static const unsigned numBodies = 2000;
+    static const unsigned numWarmupSteps = 60;
+
+    auto context = CreateTestContext(TestContextFlag::Urho2D);
+    auto counter = MakeShared<ContactCounter>(context);
+
+    auto sceneWithEvents = CreatePhysicsScene(context, numBodies);
+    auto sceneWithoutEvents = CreatePhysicsScene(context, numBodies);
+    auto worldWithEvents = sceneWithEvents->GetComponent<PhysicsWorld2D>();
+    auto worldWithoutEvents = sceneWithoutEvents->GetComponent<PhysicsWorld2D>();
+    worldWithoutEvents->SetContactEventsEnabled(false);
+    worldWithoutEvents->SetUpdateContactEventsEnabled(false);
+
+    // Let the pile settle so that the benchmark includes both moving and sleeping bodies
+    for (unsigned i = 0; i < numWarmupSteps; ++i)
+    {
+        worldWithEvents->Update(1.0f / 60.0f);
+        worldWithoutEvents->Update(1.0f / 60.0f);
+    }
+
+    BENCHMARK("Step with contact events")
+    {
+        worldWithEvents->Update(1.0f / 60.0f);
+        return counter->numBeginContactEvents_;
+    };
+
+    BENCHMARK("Step with contact records only")
+    {
+        worldWithoutEvents->Update(1.0f / 60.0f);
+        return counter->numBeginContacts_;
+    };
+
+    WARN("Bodies " << numBodies << ", contacts began " << counter->numBeginContacts_
+        << ", contact events sent " << counter->numBeginContactEvents_);
+}
+
+#endif
@@ -0,0 +1,162 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <catch2/catch_amalgamated.hpp>
+#include <Urho3D/Urho3D.h>
+
+#ifdef URHO3D_URHO2D
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/Math/RandomEngine.h>
+#include <Urho3D/Urho2D/Drawable2D.h>
+
+using namespace Urho3D;
+
+namespace
+{
+
+/// Sprite parameters.
+struct TestSprite
+{
+    Matrix3x4 worldTransform_;
+    Rect drawRect_;
+    Rect textureRect_;
+    unsigned color_{};
+};
+
+/// Create random sprites.
+ea::vector<TestSprite> CreateTestSprites(unsigned count)
+{
+    RandomEngine random(0);
+    ea::vector<TestSprite> sprites(count);
+    for (TestSprite& sprite : sprites)
+    {
+        const Vector3 position{ random.GetFloat(-100.0f, 100.0f), random.GetFloat(-100.0f, 100.0f), random.GetFloat(0.0f, 10.0f) };
+        const Quaternion rotation{ random.GetFloat(0.0f, 360.0f) };
+        const Vector3 scale{ random.GetFloat(0.5f, 2.0f), random.GetFloat(0.5f, 2.0f), 1.0f };
+        sprite.worldTransform_ = Matrix3x4(position, rotation, scale);
+
+        const Vector2 halfSize{ random.GetFloat(0.1f, 1.0f), random.GetFloat(0.1f, 1.0f) };
+        sprite.drawRect_ = Rect(-halfSize, halfSize);
+        sprite.textureRect_ = Rect(random.GetFloat(0.0f, 0.5f), random.GetFloat(0.0f, 0.5f),
+            random.GetFloat(0.5f, 1.0f), random.GetFloat(0.5f, 1.0f));
+        sprite.color_ = random.GetUInt();
+    }
+    return sprites;
+}
+
+/// Generate sprite quad by transforming each corner with the matrix.
+void GenerateSpriteQuadReference(Vertex2D* vertices, const TestSprite& sprite)
+{
+    const Rect& drawRect = sprite.drawRect_;
+    vertices[0].position_ = sprite.worldTransform_ * Vector3(drawRect.min_.x_, drawRect.min_.y_, 0.0f);
+    vertices[1].position_ = sprite.worldTransform_ * Vector3(drawRect.min_.x_, drawRect.max_.y_, 0.0f);
+    vertices[2].position_ = sprite.worldTransform_ * Vector3(drawRect.max_.x_, drawRect.max_.y_, 0.0f);
+    vertices[3].position_ = sprite.worldTransform_ * Vector3(drawRect.max_.x_, drawRect.min_.y_, 0.0f);
+
+    const Rect& textureRect = sprite.textureRect_;
+    vertices[0].uv_ = textureRect.min_;
+    vertices[1].uv_ = Vector2(textureRect.min_.x_, textureRect.max_.y_);
+    vertices[2].uv_ = textureRect.max_;
+    vertices[3].uv_ = Vector2(textureRect.max_.x_, textureRect.min_.y_);
+
+    vertices[0].color_ = vertices[1].color_ = vertices[2].color_ = vertices[3].color_ = sprite.color_;
+}
+
+/// Generate quads for all sprites.
+void GenerateSpriteQuads(Vertex2D* vertices, const ea::vector<TestSprite>& sprites, unsigned beginIndex, unsigned endIndex)
+{
+    for (unsigned i = beginIndex; i < endIndex; ++i)
+    {
+        const TestSprite& sprite = sprites[i];
+        GenerateSpriteQuad(&vertices[i * 4], sprite.worldTransform_, sprite.drawRect_, sprite.textureRect_, false, sprite.color_);
+    }
+}
+
+}
+
+TEST_CASE("Sprite quad matches transformed corners", "[urho2d]")
+{
+    ea::vector<TestSprite> sprites = CreateTestSprites(1000);
+
+    // Colors that are NaN, denormal or negative zero if treated as floats
+    sprites[0].color_ = 0xffffffff;
+    sprites[1].color_ = 0xff800001;
+    sprites[2].color_ = 0x00000001;
+    sprites[3].color_ = 0x80000000;
+
+    for (const TestSprite& sprite : sprites)
+    {
+        Vertex2D expected[4];
+        GenerateSpriteQuadReference(expected, sprite);
+
+        Vertex2D actual[4];
+        GenerateSpriteQuad(actual, sprite.worldTransform_, sprite.drawRect_, sprite.textureRect_, false, sprite.color_);
+
+        for (unsigned i = 0; i < 4; ++i)
+        {
+            REQUIRE(actual[i].position_.Equals(expected[i].position_, 1e-4f));
+            REQUIRE(actual[i].uv_ == expected[i].uv_);
+            REQUIRE(actual[i].color_ == expected[i].color_);
+        }
+    }
+}
+
+TEST_CASE("Sprite quad generation benchmark", "[.][benchmark][urho2d]")
+{
+    static const unsigned numSprites = 200000;
+    static const unsigned spritesPerWorkItem = 1024;
+
+    auto context = MakeShared<Context>();
+    auto workQueue = new WorkQueue(context);
+    context->RegisterSubsystem(workQueue);
+    workQueue->CreateThreads(ea::max(GetNumLogicalCPUs(), 2u) - 1);
+
+    const ea::vector<TestSprite> sprites = CreateTestSprites(numSprites);
+    ea::vector<Vertex2D> vertices(numSprites * 4);
+
+    BENCHMARK("Transform each corner")
+    {
+        for (unsigned i = 0; i < numSprites; ++i)
+            GenerateSpriteQuadReference(&vertices[i * 4], sprites[i]);
+        return vertices.back().position_.x_;
+    };
+
+    BENCHMARK("GenerateSpriteQuad")
+    {
+        GenerateSpriteQuads(vertices.data(), sprites, 0, numSprites);
+        return vertices.back().position_.x_;
+    };
+
+    BENCHMARK("GenerateSpriteQuad in WorkQueue threads")
+    {
+        ForEachParallel(workQueue, spritesPerWorkItem, numSprites, [&](unsigned beginIndex, unsigned endIndex)
+        {
+            GenerateSpriteQuads(vertices.data(), sprites, beginIndex, endIndex);
+        });
+        return vertices.back().position_.x_;
+    };
+}
+
+#endif
@@ -0,0 +1,127 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <Urho3D/Urho3D.h>
+#include <Urho3D/Container/FlagSet.h>
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/Graphics/Graphics.h>
+#include <Urho3D/Graphics/Model.h>
+#include <Urho3D/Graphics/ModelView.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Scene/Scene.h>
+#ifdef URHO3D_NAVIGATION
+#include <Urho3D/Navigation/NavigationMesh.h>
+#endif
+#ifdef URHO3D_URHO2D
+#include <Urho3D/Urho2D/Urho2D.h>
+#endif
+
+namespace Tests
+{
+
+/// Optional subsystems and libraries of the test context. Scene library is always registered.
+enum class TestContextFlag
+{
+    None = 0,
+    /// FileSystem and ResourceCache subsystems.
+    Resources = 1 << 0,
+    /// WorkQueue subsystem with worker threads.
+    WorkQueue = 1 << 1,
+    /// Graphics library.
+    Graphics = 1 << 2,
+    /// Navigation library.
+    Navigation = 1 << 3,
+    /// Urho2D library.
+    Urho2D = 1 << 4,
+};
+URHO3D_FLAGSET(TestContextFlag, TestContextFlags);
+
+/// Create context with given subsystems and libraries.
+inline Urho3D::SharedPtr<Urho3D::Context> CreateTestContext(TestContextFlags flags)
+{
+    using namespace Urho3D;
+
+    auto context = MakeShared<Context>();
+    if (flags.Test(TestContextFlag::Resources))
+    {
+        context->RegisterSubsystem(new FileSystem(context));
+        context->RegisterSubsystem(new ResourceCache(context));
+    }
+    if (flags.Test(TestContextFlag::WorkQueue))
+    {
+        auto workQueue = new WorkQueue(context);
+        context->RegisterSubsystem(workQueue);
+        workQueue->CreateThreads(ea::max(GetNumLogicalCPUs(), 2u) - 1);
+    }
+
+    RegisterSceneLibrary(context);
+    if (flags.Test(TestContextFlag::Graphics))
+        RegisterGraphicsLibrary(context);
+#ifdef URHO3D_NAVIGATION
+    if (flags.Test(TestContextFlag::Navigation))
+        RegisterNavigationLibrary(context);
+#endif
+#ifdef URHO3D_URHO2D
+    if (flags.Test(TestContextFlag::Urho2D))
+        RegisterUrho2DLibrary(context);
+#endif
+    return context;
+}
+
+/// Create unit quad model in XZ plane facing up. Both UV channels cover the quad uvScale times.
+inline Urho3D::SharedPtr<Urho3D::Model> CreateQuadModel(Urho3D::Context* context, float uvScale = 1.0f)
+{
+    using namespace Urho3D;
+
+    GeometryLODView geometry;
+    for (const Vector2& corner : { Vector2(0.0f, 0.0f), Vector2(1.0f, 0.0f), Vector2(1.0f, 1.0f), Vector2(0.0f, 1.0f) })
+    {
+        ModelVertex vertex;
+        vertex.SetPosition(Vector3(corner.x_ - 0.5f, 0.0f, corner.y_ - 0.5f));
+        vertex.normal_ = Vector4(Vector3::UP, 0.0f);
+        vertex.uv_[0] = Vector4(corner.x_ * uvScale, corner.y_ * uvScale, 0.0f, 0.0f);
+        vertex.uv_[1] = vertex.uv_[0];
+        geometry.vertices_.push_back(vertex);
+    }
+    geometry.indices_ = { 0, 2, 1, 0, 3, 2 };
+
+    ModelVertexFormat vertexFormat;
+    vertexFormat.position_ = TYPE_VECTOR3;
+    vertexFormat.normal_ = TYPE_VECTOR3;
+    vertexFormat.uv_[0] = TYPE_VECTOR2;
+    vertexFormat.uv_[1] = TYPE_VECTOR2;
+
+    GeometryView geometryView;
+    geometryView.lods_.push_back(geometry);
+
+    auto modelView = MakeShared<ModelView>(context);
+    modelView->SetVertexFormat(vertexFormat);
+    modelView->SetGeometries({ geometryView });
+    return modelView->ExportModel();
+}
+
+}
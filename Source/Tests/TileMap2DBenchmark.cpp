@@ -0,0 +1,317 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <catch2/catch_amalgamated.hpp>
+#include <Urho3D/Urho3D.h>
+
+#ifdef URHO3D_URHO2D
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/StringUtils.h>
+#include <Urho3D/Graphics/Texture2D.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Scene/Scene.h>
+#include <Urho3D/Urho2D/StaticSprite2D.h>
+#include <Urho3D/Urho2D/TileMap2D.h>
+#include <Urho3D/Urho2D/TileMapChunk2D.h>
+#include <Urho3D/Urho2D/TileMapLayer2D.h>
+#include <Urho3D/Urho2D/TmxFile2D.h>
+
+#include <EASTL/sort.h>
+#include <EASTL/unordered_set.h>
+
+#include "TestUtils.h"
+
+using namespace Urho3D;
+using namespace Tests;
+
+namespace
+{
+
+/// Create context for tile maps with manual tile set textures.
+SharedPtr<Context> CreateTileMapContext()
+{
+    auto context = CreateTestContext(TestContextFlag::Resources | TestContextFlag::Graphics | TestContextFlag::Urho2D);
+
+    // Tile set textures, 8 tiles 16x16 and 8 tiles 16x32
+    for (const char* name : { "Tiles.png", "TallTiles.png" })
+    {
+        auto texture = MakeShared<Texture2D>(context);
+        texture->SetName(name);
+        context->GetSubsystem<ResourceCache>()->AddManualResource(texture);
+    }
+    return context;
+}
+
+/// Create orthogonal CSV tile map with some empty and flipped tiles.
+/// Optionally some tiles are taken from the second tile set with tiles taller than the grid.
+SharedPtr<TmxFile2D> CreateTmxFile(Context* context, int width, int height, bool tallTiles = false)
+{
+    ea::string csv;
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            const unsigned index = y * width + x;
+            unsigned gid = index % 11 == 0 ? 0 : 1 + (x * 7 + y * 3) % 8;
+            if (gid && tallTiles && (x + y) % 3 == 0)
+                gid += 8;
+            if (gid && index % 5 == 0)
+                gid |= FLIP_HORIZONTAL;
+            if (gid && index % 7 == 0)
+                gid |= FLIP_DIAGONAL;
+
+            csv += ea::to_string(gid);
+            if (index + 1 < width * height)
+                csv += x + 1 < width ? "," : ",\n";
+        }
+    }
+
+    const char* tallTileset = "<tileset firstgid=\"9\" name=\"TallTiles\" tilewidth=\"16\" tileheight=\"32\">\n"
+        "<image source=\"TallTiles.png\" width=\"64\" height=\"64\"/>\n"
+        "</tileset>\n";
+
+    const ea::string tmx = Format("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<map version=\"1.0\" orientation=\"orthogonal\" width=\"{}\" height=\"{}\" tilewidth=\"16\" tileheight=\"16\">\n"
+        "<tileset firstgid=\"1\" name=\"Tiles\" tilewidth=\"16\" tileheight=\"16\">\n"
+        "<image source=\"Tiles.png\" width=\"64\" height=\"32\"/>\n"
+        "</tileset>\n"
+        "{}"
+        "<layer name=\"Ground\" width=\"{}\" height=\"{}\">\n"
+        "<data encoding=\"csv\">\n{}\n</data>\n"
+        "</layer>\n"
+        "</map>\n", width, height, tallTiles ? tallTileset : "", width, height, csv);
+
+    auto tmxFile = MakeShared<TmxFile2D>(context);
+    tmxFile->SetName("Map.tmx");
+    MemoryBuffer buffer(tmx.c_str(), tmx.length());
+    if (!tmxFile->Load(buffer))
+        return nullptr;
+    return tmxFile;
+}
+
+/// Create tile map in the scene.
+TileMap2D* CreateTileMap(Scene* scene, TmxFile2D* tmxFile, int chunkSize)
+{
+    auto tileMap = scene->CreateChild("TileMap")->CreateComponent<TileMap2D>();
+    tileMap->SetChunkSize(chunkSize);
+    tileMap->SetTmxFile(tmxFile);
+    return tileMap;
+}
+
+/// Return vertices of source batches in draw order.
+ea::vector<Vertex2D> GetVerticesInDrawOrder(ea::vector<const SourceBatch2D*> sourceBatches)
+{
+    ea::stable_sort(sourceBatches.begin(), sourceBatches.end(),
+        [](const SourceBatch2D* lhs, const SourceBatch2D* rhs) { return lhs->drawOrder_ < rhs->drawOrder_; });
+
+    ea::vector<Vertex2D> vertices;
+    for (const SourceBatch2D* sourceBatch : sourceBatches)
+        vertices.insert(vertices.end(), sourceBatch->vertices_.begin(), sourceBatch->vertices_.end());
+    return vertices;
+}
+
+/// Check that chunks draw the same quads in the same order as sprites of individual tiles.
+void CheckChunksMatchSprites(TileMapLayer2D* spriteLayer, TileMapLayer2D* chunkLayer, int width, int height)
+{
+    ea::vector<const SourceBatch2D*> spriteBatches;
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            REQUIRE(chunkLayer->GetTile(x, y) == spriteLayer->GetTile(x, y));
+            if (Node* tileNode = spriteLayer->GetTileNode(x, y))
+            {
+                const ea::vector<SourceBatch2D>& sourceBatches = tileNode->GetComponent<StaticSprite2D>()->GetSourceBatches();
+                REQUIRE(sourceBatches.size() == 1);
+                REQUIRE(sourceBatches[0].vertices_.size() == 4);
+                spriteBatches.push_back(&sourceBatches[0]);
+            }
+        }
+    }
+
+    // Renderer breaks ties by material, so every batch needs its own draw order
+    ea::vector<const SourceBatch2D*> chunkBatches;
+    ea::unordered_set<int> drawOrders;
+    for (unsigned i = 0; i < chunkLayer->GetNumChunks(); ++i)
+    {
+        for (const SourceBatch2D& sourceBatch : chunkLayer->GetChunk(i)->GetSourceBatches())
+        {
+            REQUIRE(drawOrders.insert(sourceBatch.drawOrder_).second);
+            chunkBatches.push_back(&sourceBatch);
+        }
+    }
+
+    const ea::vector<Vertex2D> expectedVertices = GetVerticesInDrawOrder(spriteBatches);
+    const ea::vector<Vertex2D> vertices = GetVerticesInDrawOrder(chunkBatches);
+    REQUIRE(vertices.size() == expectedVertices.size());
+    for (unsigned i = 0; i < vertices.size(); ++i)
+    {
+        const Vertex2D& expected = expectedVertices[i];
+        const Vertex2D& actual = vertices[i];
+        REQUIRE(actual.position_.Equals(expected.position_, 1e-4f));
+        REQUIRE(memcmp(&actual.uv_, &expected.uv_, sizeof(Vector2)) == 0);
+        REQUIRE(actual.color_ == expected.color_);
+    }
+}
+
+}
+
+TEST_CASE("Tile map chunks match sprite per tile", "[urho2d]")
+{
+    static const int width = 40;
+    static const int height = 30;
+    static const int chunkSize = 16;
+
+    auto context = CreateTileMapContext();
+    auto tmxFile = CreateTmxFile(context, width, height);
+    REQUIRE(tmxFile);
+
+    auto scene = MakeShared<Scene>(context);
+    TileMapLayer2D* spriteLayer = CreateTileMap(scene, tmxFile, 0)->GetLayer(0);
+    TileMapLayer2D* chunkLayer = CreateTileMap(scene, tmxFile, chunkSize)->GetLayer(0);
+    REQUIRE(spriteLayer);
+    REQUIRE(chunkLayer);
+
+    // Equal tiles are shared
+    const auto tileLayer = static_cast<const TmxTileLayer2D*>(tmxFile->GetLayer(0));
+    REQUIRE(tileLayer->GetNumUniqueTiles() <= 1 + 8 * 4);
+
+    REQUIRE(spriteLayer->GetNumChunks() == 0);
+    REQUIRE(chunkLayer->GetNumChunks() == 6);
+    REQUIRE(chunkLayer->GetTileNode(1, 0) == nullptr);
+    REQUIRE(chunkLayer->GetNumLoadedChunks() == 0);
+
+    // Chunks contain the same quads in the same order as sprites of individual tiles
+    CheckChunksMatchSprites(spriteLayer, chunkLayer, width, height);
+
+    unsigned numTiles = 0;
+    for (unsigned i = 0; i < chunkLayer->GetNumChunks(); ++i)
+    {
+        TileMapChunk2D* chunk = chunkLayer->GetChunk(i);
+        unsigned numVertices = 0;
+        for (const SourceBatch2D& sourceBatch : chunk->GetSourceBatches())
+            numVertices += sourceBatch.vertices_.size();
+        REQUIRE(numVertices == chunk->GetNumTiles() * 4);
+        numTiles += chunk->GetNumTiles();
+    }
+    REQUIRE(numTiles == width * height - (width * height + 10) / 11);
+
+    // Geometry of chunks that are not in view is released
+    REQUIRE(chunkLayer->GetNumLoadedChunks() == 6);
+    const unsigned loadedMemoryUse = chunkLayer->GetChunk(0)->GetMemoryUse();
+    chunkLayer->ReleaseHiddenChunks(1);
+    REQUIRE(chunkLayer->GetNumLoadedChunks() == 0);
+    REQUIRE(chunkLayer->GetChunk(0)->GetMemoryUse() < loadedMemoryUse);
+
+    chunkLayer->GetChunk(0)->GetSourceBatches();
+    REQUIRE(chunkLayer->GetNumLoadedChunks() == 1);
+}
+
+TEST_CASE("Tile map chunks keep the order of tiles from different tile sets", "[urho2d]")
+{
+    static const int width = 10;
+    static const int height = 6;
+    static const int chunkSize = 4;
+
+    // Tall tiles overlap the row above, also across chunk boundaries
+    auto context = CreateTileMapContext();
+    auto tmxFile = CreateTmxFile(context, width, height, true);
+    REQUIRE(tmxFile);
+
+    auto scene = MakeShared<Scene>(context);
+    TileMapLayer2D* spriteLayer = CreateTileMap(scene, tmxFile, 0)->GetLayer(0);
+    TileMapLayer2D* chunkLayer = CreateTileMap(scene, tmxFile, chunkSize)->GetLayer(0);
+    REQUIRE(spriteLayer);
+    REQUIRE(chunkLayer);
+    REQUIRE(chunkLayer->GetNumChunks() == 6);
+
+    CheckChunksMatchSprites(spriteLayer, chunkLayer, width, height);
+}
+
+TEST_CASE("Large tile map loading benchmark", "[.][benchmark][urho2d]")
+{
+    static const int width = 256;
+    static const int height = 256;
+    static const int chunkSize = 32;
+
+    auto context = CreateTileMapContext();
+    auto scene = MakeShared<Scene>(context);
+    auto tmxFile = CreateTmxFile(context, width, height);
+    REQUIRE(tmxFile);
+
+    BENCHMARK("Load tmx file")
+    {
+        return CreateTmxFile(context, width, height);
+    };
+
+    BENCHMARK("Create node per tile")
+    {
+        TileMap2D* tileMap = CreateTileMap(scene, tmxFile, 0);
+        tileMap->GetNode()->Remove();
+    };
+
+    BENCHMARK("Create chunks")
+    {
+        TileMap2D* tileMap = CreateTileMap(scene, tmxFile, chunkSize);
+        tileMap->GetNode()->Remove();
+    };
+
+    BENCHMARK("Create chunks and generate geometry")
+    {
+        TileMap2D* tileMap = CreateTileMap(scene, tmxFile, chunkSize);
+        TileMapLayer2D* layer = tileMap->GetLayer(0);
+        for (unsigned i = 0; i < layer->GetNumChunks(); ++i)
+            layer->GetChunk(i)->GetSourceBatches();
+        tileMap->GetNode()->Remove();
+    };
+
+    // Compare memory of tile nodes with memory of chunks
+    TileMap2D* spriteMap = CreateTileMap(scene, tmxFile, 0);
+    TileMap2D* chunkMap = CreateTileMap(scene, tmxFile, chunkSize);
+    TileMapLayer2D* chunkLayer = chunkMap->GetLayer(0);
+
+    unsigned numTileNodes = 0;
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            if (spriteMap->GetLayer(0)->GetTileNode(x, y))
+                ++numTileNodes;
+        }
+    }
+
+    unsigned chunkMemoryUse = 0;
+    for (unsigned i = 0; i < chunkLayer->GetNumChunks(); ++i)
+    {
+        TileMapChunk2D* chunk = chunkLayer->GetChunk(i);
+        chunk->GetSourceBatches();
+        chunkMemoryUse += sizeof(Node) + sizeof(TileMapChunk2D) + chunk->GetMemoryUse();
+    }
+
+    const unsigned spriteMemoryUse = numTileNodes * (sizeof(Node) + sizeof(StaticSprite2D) + 4 * sizeof(Vertex2D));
+    WARN("Nodes: node per tile " << numTileNodes << ", chunks " << chunkLayer->GetNumChunks()
+        << "; approximate memory, KB: node per tile " << spriteMemoryUse / 1024 << ", chunks " << chunkMemoryUse / 1024);
+}
+
+#endif
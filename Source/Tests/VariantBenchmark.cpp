@@ -0,0 +1,379 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <catch2/catch_amalgamated.hpp>
+#include <Urho3D/Urho3D.h>
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/Core/Object.h>
+#include <Urho3D/Core/Variant.h>
+#include <Urho3D/Math/RandomEngine.h>
+
+#include <EASTL/unordered_map.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+
+/// Number of global allocations since the start of the test run.
+std::atomic<unsigned> numAllocations{};
+
+}
+
+void* operator new(size_t size)
+{
+    numAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return ::operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+using namespace Urho3D;
+
+namespace
+{
+
+/// Object that sends and receives events.
+class EventTestObject : public Object
+{
+    URHO3D_OBJECT(EventTestObject, Object);
+
+public:
+    using Object::Object;
+};
+
+/// Return number of allocations made by the callback.
+template <class T> unsigned CountAllocations(const T& callback)
+{
+    const unsigned numAllocationsBefore = numAllocations.load(std::memory_order_relaxed);
+    callback();
+    return numAllocations.load(std::memory_order_relaxed) - numAllocationsBefore;
+}
+
+/// Fill event data the same way E_UPDATE is sent.
+template <class MapType> void FillUpdateEventData(MapType& eventData, float timeStep)
+{
+    using namespace Update;
+    eventData[P_TIMESTEP] = timeStep;
+}
+
+/// Fill event data the same way E_NODECOLLISION is sent.
+template <class MapType> void FillNodeCollisionEventData(MapType& eventData, RefCounted* body, const ByteVector& contacts)
+{
+    static const StringHash P_BODY("Body");
+    static const StringHash P_OTHERNODE("OtherNode");
+    static const StringHash P_OTHERBODY("OtherBody");
+    static const StringHash P_TRIGGER("Trigger");
+    static const StringHash P_CONTACTS("Contacts");
+
+    eventData[P_BODY] = body;
+    eventData[P_OTHERNODE] = body;
+    eventData[P_OTHERBODY] = body;
+    eventData[P_TRIGGER] = false;
+    eventData[P_CONTACTS] = contacts;
+}
+
+}
+
+TEST_CASE("VariantMap matches unordered_map", "[variant]")
+{
+    VariantMap map;
+    ea::unordered_map<StringHash, Variant> reference;
+
+    // Key range is large enough to switch between linear search and hash index
+    RandomEngine random(0);
+    for (unsigned i = 0; i < 20000; ++i)
+    {
+        const StringHash key{random.GetUInt(0, 40)};
+        switch (random.GetUInt(0, 4))
+        {
+        case 0:
+            REQUIRE(map.erase(key) == reference.erase(key));
+            break;
+        case 1:
+            map[key] = static_cast<int>(i);
+            reference[key] = static_cast<int>(i);
+            break;
+        case 2:
+            map.clear();
+            reference.clear();
+            break;
+        default:
+            REQUIRE(map.try_emplace(key, static_cast<int>(i)).second == reference.emplace(key, static_cast<int>(i)).second);
+            break;
+        }
+
+        REQUIRE(map.size() == reference.size());
+        for (const auto& [referenceKey, referenceValue] : reference)
+        {
+            const auto iter = map.find(referenceKey);
+            REQUIRE(iter != map.end());
+            REQUIRE(iter->second == referenceValue);
+        }
+    }
+
+    for (unsigned i = 0; i < 32; ++i)
+        map[StringHash{i}] = i;
+
+    // Erase while iterating visits every element once
+    unsigned numVisited = 0;
+    for (auto iter = map.begin(); iter != map.end();)
+    {
+        ++numVisited;
+        iter = iter->first.Value() % 2 ? map.erase(iter) : iter + 1;
+    }
+    REQUIRE(numVisited == 32);
+    REQUIRE(map.size() == 16);
+
+    VariantMap reversed;
+    for (unsigned i = 32; i > 0; --i)
+    {
+        if ((i - 1) % 2 == 0)
+            reversed[StringHash{i - 1}] = i - 1;
+    }
+    REQUIRE(map == reversed);
+    REQUIRE(map.ToHash() == reversed.ToHash());
+
+    const VariantMap copy = map;
+    REQUIRE(copy == map);
+    reversed.erase(StringHash{0u});
+    REQUIRE(reversed != map);
+}
+
+TEST_CASE("Variant shares large values between copies", "[variant]")
+{
+    VariantMap map;
+    map[StringHash{1u}] = 1;
+    map[StringHash{2u}] = Matrix4::IDENTITY;
+
+    const Variant original = map;
+    Variant copy = original;
+    REQUIRE(&copy.GetVariantMap() == &original.GetVariantMap());
+
+    copy.GetVariantMapPtr()->erase(StringHash{1u});
+    REQUIRE(&copy.GetVariantMap() != &original.GetVariantMap());
+    REQUIRE(original.GetVariantMap().size() == 2);
+    REQUIRE(copy.GetVariantMap().size() == 1);
+
+    Variant moved = ea::move(copy);
+    REQUIRE(moved.GetVariantMap().size() == 1);
+    REQUIRE(copy.IsEmpty());
+
+    const Variant matrix = Matrix3x4(Vector3::ONE, Quaternion::IDENTITY, 2.0f);
+    Variant matrixCopy = matrix;
+    REQUIRE(matrixCopy == matrix);
+    matrixCopy = Matrix4::IDENTITY;
+    const Variant matrixCopy2 = matrixCopy;
+    REQUIRE(&matrixCopy.GetMatrix4() == &matrixCopy2.GetMatrix4());
+    matrixCopy = Matrix4::ZERO;
+    REQUIRE(matrixCopy2.GetMatrix4() == Matrix4::IDENTITY);
+}
+
+TEST_CASE("VariantMap elements are not moved by insertion", "[variant]")
+{
+    VariantMap map;
+    map[StringHash{0u}] = "Value 0";
+    Variant& firstValue = map[StringHash{0u}];
+
+    // Source element is referenced while the map grows
+    for (unsigned i = 1; i < 64; ++i)
+        map[StringHash{i}] = map[StringHash{i - 1}];
+    REQUIRE(&firstValue == &map[StringHash{0u}]);
+    REQUIRE(map[StringHash{63u}].GetString() == "Value 0");
+
+    // Erasure doesn't move other elements
+    Variant& lastValue = map[StringHash{63u}];
+    map.erase(StringHash{10u});
+    map.erase(StringHash{11u});
+    REQUIRE(&lastValue == &map[StringHash{63u}]);
+    REQUIRE(map.size() == 62);
+
+    map.insert_or_assign(StringHash{100u}, map[StringHash{1u}]);
+    REQUIRE(map[StringHash{100u}].GetString() == "Value 0");
+}
+
+TEST_CASE("Variant is assigned from its own element", "[variant]")
+{
+    // Unique nested map
+    {
+        VariantMap inner;
+        inner[StringHash{1u}] = "Inner";
+        VariantMap outer;
+        outer[StringHash{1u}] = inner;
+        outer[StringHash{2u}] = Matrix4::IDENTITY;
+
+        Variant value = outer;
+        value = value.GetVariantMap().find(StringHash{1u})->second;
+        REQUIRE(value.GetVariantMap().size() == 1);
+        REQUIRE(value.GetVariantMap().find(StringHash{1u})->second.GetString() == "Inner");
+
+        value = outer;
+        value = value.GetVariantMap().find(StringHash{2u})->second;
+        REQUIRE(value.GetMatrix4() == Matrix4::IDENTITY);
+
+        value = outer;
+        value = value.GetVariantMap().find(StringHash{1u})->second.GetVariantMap();
+        REQUIRE(value.GetVariantMap().find(StringHash{1u})->second.GetString() == "Inner");
+    }
+
+    // Element of uniquely owned map and vector
+    {
+        Variant value = VariantMap{};
+        value.GetVariantMapPtr()->populate(StringHash{1u}, "Element", StringHash{2u}, 2);
+        value = value.GetVariantMap().find(StringHash{1u})->second;
+        REQUIRE(value.GetString() == "Element");
+
+        value = VariantVector{Variant{"First"}, Variant{VariantVector{Variant{3}}}};
+        value = value.GetVariantVector()[1];
+        REQUIRE(value.GetVariantVector().size() == 1);
+        value = value.GetVariantVector()[0];
+        REQUIRE(value.GetInt() == 3);
+
+        value = VariantVector{Variant{"First"}, Variant{"Second"}};
+        value = ea::move((*value.GetVariantVectorPtr())[1]);
+        REQUIRE(value.GetString() == "Second");
+    }
+
+    // Modification through pointer doesn't affect copies
+    {
+        Variant value = VariantMap{};
+        value.GetVariantMapPtr()->populate(StringHash{1u}, 1);
+        const Variant copy = value;
+        (*value.GetVariantMapPtr())[StringHash{1u}] = 2;
+        REQUIRE(copy.GetVariantMap().find(StringHash{1u})->second.GetInt() == 1);
+        REQUIRE(value.GetVariantMap().find(StringHash{1u})->second.GetInt() == 2);
+    }
+}
+
+TEST_CASE("Reused event data doesn't allocate", "[variant]")
+{
+    VariantMap eventData;
+    ByteVector contacts(64);
+
+    FillNodeCollisionEventData(eventData, nullptr, contacts);
+    eventData.clear();
+
+    const unsigned numAllocations = CountAllocations([&]
+    {
+        for (unsigned i = 0; i < 100; ++i)
+        {
+            eventData.clear();
+            FillUpdateEventData(eventData, 0.01f);
+            eventData.clear();
+            FillNodeCollisionEventData(eventData, nullptr, {});
+        }
+    });
+    REQUIRE(numAllocations == 0);
+}
+
+TEST_CASE("Event data allocation benchmark", "[.][benchmark][variant]")
+{
+    auto context = MakeShared<Context>();
+    auto sender = MakeShared<EventTestObject>(context);
+    auto receiver = MakeShared<EventTestObject>(context);
+    unsigned numEvents = 0;
+    receiver->SubscribeToEvent(E_UPDATE, [&](StringHash, VariantMap&) { ++numEvents; });
+
+    ByteVector contacts(64);
+    ea::unordered_map<StringHash, Variant> hashMap;
+    VariantMap variantMap;
+
+    const unsigned numIterations = 1000;
+    const unsigned hashMapAllocations = CountAllocations([&]
+    {
+        for (unsigned i = 0; i < numIterations; ++i)
+        {
+            hashMap.clear();
+            FillNodeCollisionEventData(hashMap, sender, contacts);
+        }
+    });
+    const unsigned variantMapAllocations = CountAllocations([&]
+    {
+        for (unsigned i = 0; i < numIterations; ++i)
+        {
+            variantMap.clear();
+            FillNodeCollisionEventData(variantMap, sender, contacts);
+        }
+    });
+    const unsigned sendAllocations = CountAllocations([&]
+    {
+        for (unsigned i = 0; i < numIterations; ++i)
+        {
+            VariantMap& eventData = sender->GetEventDataMap();
+            FillUpdateEventData(eventData, 0.01f);
+            sender->SendEvent(E_UPDATE, eventData);
+        }
+    });
+
+    WARN("E_NODECOLLISION data, allocations per event: unordered_map "
+        << static_cast<float>(hashMapAllocations) / numIterations << ", VariantMap "
+        << static_cast<float>(variantMapAllocations) / numIterations);
+    WARN("E_UPDATE send, allocations per event: " << static_cast<float>(sendAllocations) / numIterations);
+
+    BENCHMARK("Fill E_NODECOLLISION data in unordered_map")
+    {
+        hashMap.clear();
+        FillNodeCollisionEventData(hashMap, sender, contacts);
+        return hashMap.size();
+    };
+    BENCHMARK("Fill E_NODECOLLISION data in VariantMap")
+    {
+        variantMap.clear();
+        FillNodeCollisionEventData(variantMap, sender, contacts);
+        return variantMap.size();
+    };
+    BENCHMARK("Send E_UPDATE")
+    {
+        VariantMap& eventData = sender->GetEventDataMap();
+        FillUpdateEventData(eventData, 0.01f);
+        sender->SendEvent(E_UPDATE, eventData);
+        return numEvents;
+    };
+}
@@ -0,0 +1,206 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <catch2/catch_amalgamated.hpp>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/IO/ArchiveSerialization.h>
+#include <Urho3D/Resource/XMLArchive.h>
+#include <Urho3D/Resource/XMLFile.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include "ArchiveTestRecord.h"
+
+using namespace Urho3D;
+using namespace Tests;
+
+namespace
+{
+
+/// Create scene with named nodes, transforms and variables.
+SharedPtr<Scene> CreateTestScene(Context* context, unsigned numNodes)
+{
+    auto scene = MakeShared<Scene>(context);
+    for (unsigned i = 0; i < numNodes; ++i)
+    {
+        Node* parent = i % 4 == 0 ? scene.Get() : scene->GetChildren().back().Get();
+        Node* node = parent->CreateChild(Format("Node \"{}\" & <{}>", i, i % 3));
+        node->SetPosition(Vector3(i * 0.5f, i * 0.25f, -1.0f * i));
+        node->SetRotation(Quaternion(i * 5.0f, Vector3::UP));
+        node->SetScale(1.0f + i * 0.125f);
+        node->SetVar("Index", static_cast<int>(i));
+        node->SetVar("Label", Format("Label {}", i));
+        if (i % 5 == 0)
+            node->AddTag("Marked");
+    }
+    return scene;
+}
+
+/// Save scene to XML string.
+ea::string SaveSceneXML(Scene* scene)
+{
+    auto file = MakeShared<XMLFile>(scene->GetContext());
+    XMLElement root = file->CreateRoot("scene");
+    scene->SaveXML(root);
+    return file->ToString();
+}
+
+}
+
+TEST_CASE("XML file is parsed in place", "[xml]")
+{
+    auto context = MakeShared<Context>();
+    auto file = MakeShared<XMLFile>(context);
+
+    const ea::string source =
+        "<?xml version=\"1.0\"?>\n"
+        "<root name=\"a &amp; &quot;b&quot;\" int=\"-42\" uint=\"4000000000\" float=\"0.5\" bool=\"true\">\n"
+        "    <!-- comment -->\n"
+        "    <vector value=\"1 2 3\" quaternion=\"0 90 0\" color=\"0.1 0.2 0.3 1\" />\n"
+        "    <variant type=\"Vector3\" value=\"4 5 6\" />\n"
+        "    <text>inner &lt;value&gt;</text>\n"
+        "</root>\n";
+    REQUIRE(file->FromString(source));
+
+    XMLElement root = file->GetRoot("root");
+    REQUIRE(root);
+    REQUIRE(root.GetAttribute("name") == "a & \"b\"");
+    REQUIRE(root.GetInt("int") == -42);
+    REQUIRE(root.GetUInt("uint") == 4000000000u);
+    REQUIRE(root.GetFloat("float") == 0.5f);
+    REQUIRE(root.GetBool("bool"));
+    REQUIRE(root.GetInt("missing") == 0);
+    REQUIRE_FALSE(root.HasAttribute("missing"));
+
+    XMLElement vector = root.GetChild("vector");
+    REQUIRE(vector.GetVector3("value") == Vector3(1.0f, 2.0f, 3.0f));
+    REQUIRE(vector.GetQuaternion("quaternion").Equals(Quaternion(0.0f, 90.0f, 0.0f)));
+    REQUIRE(vector.GetColor("color") == Color(0.1f, 0.2f, 0.3f, 1.0f));
+    REQUIRE(vector.GetVector2("missing") == Vector2::ZERO);
+    REQUIRE(root.GetChild("variant").GetVariant() == Variant(Vector3(4.0f, 5.0f, 6.0f)));
+    REQUIRE(root.GetChild("text").GetValue() == "inner <value>");
+
+    // Document should stay valid after saving and reloading from its own output
+    const ea::string saved = file->ToString();
+    auto reloadedFile = MakeShared<XMLFile>(context);
+    REQUIRE(reloadedFile->FromString(saved));
+    REQUIRE(reloadedFile->ToString() == saved);
+
+    REQUIRE_FALSE(file->FromString("<root><unclosed></root>"));
+}
+
+TEST_CASE("XML scene roundtrip", "[xml]")
+{
+    auto context = MakeShared<Context>();
+    RegisterSceneLibrary(context);
+
+    auto scene = CreateTestScene(context, 64);
+    const ea::string source = SaveSceneXML(scene);
+
+    auto file = MakeShared<XMLFile>(context);
+    REQUIRE(file->FromString(source));
+    auto loadedScene = MakeShared<Scene>(context);
+    REQUIRE(loadedScene->LoadXML(file->GetRoot()));
+
+    ea::vector<Node*> nodes;
+    ea::vector<Node*> loadedNodes;
+    scene->GetChildren(nodes, true);
+    loadedScene->GetChildren(loadedNodes, true);
+    REQUIRE(loadedNodes.size() == nodes.size());
+    for (unsigned i = 0; i < nodes.size(); ++i)
+    {
+        REQUIRE(loadedNodes[i]->GetName() == nodes[i]->GetName());
+        REQUIRE(loadedNodes[i]->GetPosition() == nodes[i]->GetPosition());
+        REQUIRE(loadedNodes[i]->GetRotation().Equals(nodes[i]->GetRotation()));
+        REQUIRE(loadedNodes[i]->GetScale() == nodes[i]->GetScale());
+        REQUIRE(loadedNodes[i]->GetVars() == nodes[i]->GetVars());
+        REQUIRE(loadedNodes[i]->GetTags() == nodes[i]->GetTags());
+    }
+    REQUIRE(SaveSceneXML(loadedScene) == source);
+}
+
+TEST_CASE("XML archive roundtrip", "[xml][archive]")
+{
+    auto context = MakeShared<Context>();
+    ea::vector<ArchiveTestRecord> records = CreateRecords(64);
+
+    ea::string source;
+    {
+        auto file = MakeShared<XMLFile>(context);
+        XMLOutputArchive archive(file);
+        REQUIRE(SerializeRecords(archive, records));
+        source = file->ToString();
+    }
+
+    auto file = MakeShared<XMLFile>(context);
+    REQUIRE(file->FromString(source));
+
+    ea::vector<ArchiveTestRecord> loadedRecords;
+    XMLInputArchive archive(file);
+    REQUIRE(SerializeRecords(archive, loadedRecords));
+    REQUIRE(loadedRecords.size() == records.size());
+    for (unsigned i = 0; i < records.size(); ++i)
+        REQUIRE(loadedRecords[i] == records[i]);
+}
+
+TEST_CASE("XML loading benchmark", "[.][benchmark][xml]")
+{
+    auto context = MakeShared<Context>();
+    RegisterSceneLibrary(context);
+
+    const ea::string sceneSource = SaveSceneXML(CreateTestScene(context, 5000));
+
+    ea::string archiveSource;
+    {
+        auto file = MakeShared<XMLFile>(context);
+        XMLOutputArchive archive(file);
+        ea::vector<ArchiveTestRecord> records = CreateRecords(10000);
+        SerializeRecords(archive, records);
+        archiveSource = file->ToString();
+    }
+
+    BENCHMARK("Parse scene XML")
+    {
+        auto file = MakeShared<XMLFile>(context);
+        file->FromString(sceneSource);
+        return file->GetRoot().GetNumAttributes();
+    };
+
+    BENCHMARK("Load scene from XML")
+    {
+        auto file = MakeShared<XMLFile>(context);
+        file->FromString(sceneSource);
+        auto scene = MakeShared<Scene>(context);
+        scene->LoadXML(file->GetRoot());
+        return scene->GetNumChildren();
+    };
+
+    BENCHMARK("Read archive from XML")
+    {
+        auto file = MakeShared<XMLFile>(context);
+        file->FromString(archiveSource);
+        ea::vector<ArchiveTestRecord> loadedRecords;
+        XMLInputArchive archive(file);
+        SerializeRecords(archive, loadedRecords);
+        return loadedRecords.size();
+    };
+}
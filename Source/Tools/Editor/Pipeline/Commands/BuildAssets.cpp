@@ -21,6 +21,7 @@
 //
 
 #include <Urho3D/Engine/EngineDefs.h>
+#include <Urho3D/IO/FileSystem.h>
 #include "Project.h"
 #include "Editor.h"
 #include "Pipeline/Commands/BuildAssets.h"
@@ -46,6 +47,8 @@ void BuildAssets::RegisterCommandLine(CLI::App& cli)
     });
     cli.add_flag("--full", full_, "Disable out-of-date checks and rebuild cache completely.");
     cli.add_option("flavor", flavor_, "Flavor to build.");
+    cli.add_option("--import-cache", importCachePath_, "Directory of content-addressed import cache. Defaults to ImportCache in project directory.");
+    cli.add_flag("--no-import-cache", noImportCache_, "Do not reuse or store byproducts in import cache.");
 }
 
 void BuildAssets::Execute()
@@ -62,8 +65,14 @@ void BuildAssets::Execute()
         flags |= PipelineBuildFlag::SKIP_UP_TO_DATE;
 
     auto* pipeline = GetSubsystem<Pipeline>();
-    pipeline->BuildCache(pipeline->GetFlavor(flavor_), flags);
-    pipeline->WaitForCompletion();
+    if (noImportCache_)
+        pipeline->SetImportCachePath(EMPTY_STRING);
+    else if (!importCachePath_.empty())
+        pipeline->SetImportCachePath(GetAbsolutePath(importCachePath_));
+
+    pipeline->ResetImportStats();
+    pipeline->BuildCacheAndWait(pipeline->GetFlavor(flavor_), flags);
+    pipeline->LogImportStats();
 }
 
 }
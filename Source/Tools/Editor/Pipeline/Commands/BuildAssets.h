@@ -47,6 +47,10 @@ protected:
     int full_ = 0;
     ///
     ea::string flavor_{Flavor::DEFAULT};
+    /// Directory of content-addressed import cache.
+    ea::string importCachePath_{};
+    /// Disables content-addressed import cache.
+    int noImportCache_ = 0;
 };
 
 }
@@ -0,0 +1,139 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/IO/Log.h>
+
+#include "Pipeline/ImportCache.h"
+
+namespace Urho3D
+{
+
+static const char* IMPORT_CACHE_LIST_FILE = "byproducts.txt";
+static const char* IMPORT_CACHE_DATA_DIR = "data/";
+
+ImportCache::ImportCache(Context* context)
+    : Object(context)
+{
+}
+
+void ImportCache::SetStorePath(const ea::string& path)
+{
+    storePath_ = path.empty() ? EMPTY_STRING : AddTrailingSlash(path);
+}
+
+ea::string ImportCache::GetEntryPath(const ea::string& contentHash) const
+{
+    return Format("{}{}/{}/", storePath_, contentHash.substr(0, 2), contentHash);
+}
+
+bool ImportCache::Contains(const ea::string& contentHash) const
+{
+    if (storePath_.empty() || contentHash.empty())
+        return false;
+
+    auto* fs = context_->GetSubsystem<FileSystem>();
+    return fs->FileExists(GetEntryPath(contentHash) + IMPORT_CACHE_LIST_FILE);
+}
+
+bool ImportCache::Restore(const ea::string& contentHash, const ea::string& outputPath, StringVector& byproducts) const
+{
+    byproducts.clear();
+    if (!Contains(contentHash))
+        return false;
+
+    auto* fs = context_->GetSubsystem<FileSystem>();
+    const ea::string entryPath = GetEntryPath(contentHash);
+
+    File listFile(context_);
+    if (!listFile.Open(entryPath + IMPORT_CACHE_LIST_FILE, FILE_READ))
+        return false;
+
+    while (!listFile.IsEof())
+    {
+        const ea::string byproduct = listFile.ReadLine();
+        if (!byproduct.empty())
+            byproducts.push_back(byproduct);
+    }
+
+    for (const ea::string& byproduct : byproducts)
+    {
+        const ea::string destination = outputPath + byproduct;
+        fs->CreateDirsRecursive(GetPath(destination));
+        if (!fs->Copy(entryPath + IMPORT_CACHE_DATA_DIR + byproduct, destination))
+        {
+            URHO3D_LOGWARNING("Import cache entry '{}' is damaged, byproduct '{}' could not be restored.", contentHash, byproduct);
+            byproducts.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ImportCache::Store(const ea::string& contentHash, const ea::string& outputPath, const StringVector& byproducts) const
+{
+    if (storePath_.empty() || contentHash.empty() || byproducts.empty())
+        return false;
+
+    if (Contains(contentHash))
+        return true;
+
+    auto* fs = context_->GetSubsystem<FileSystem>();
+    const ea::string entryPath = RemoveTrailingSlash(GetEntryPath(contentHash));
+    const ea::string tempPath = Format("{}.{}.tmp/", entryPath, GenerateUUID());
+
+    bool success = fs->CreateDirsRecursive(tempPath + IMPORT_CACHE_DATA_DIR);
+    for (const ea::string& byproduct : byproducts)
+    {
+        if (!success)
+            break;
+
+        const ea::string destination = tempPath + IMPORT_CACHE_DATA_DIR + byproduct;
+        success = fs->CreateDirsRecursive(GetPath(destination)) && fs->Copy(outputPath + byproduct, destination);
+    }
+
+    // List is written last, entry without the list is never considered valid
+    if (success)
+    {
+        File listFile(context_);
+        success = listFile.Open(tempPath + IMPORT_CACHE_LIST_FILE, FILE_WRITE);
+        for (const ea::string& byproduct : byproducts)
+            success = success && listFile.WriteLine(byproduct);
+    }
+
+    // Another thread or process may have stored the same entry in the meantime, it is identical to this one
+    if (success && !fs->Rename(RemoveTrailingSlash(tempPath), entryPath))
+        success = Contains(contentHash);
+
+    if (fs->DirExists(tempPath))
+        fs->RemoveDir(tempPath, true);
+
+    if (!success)
+        URHO3D_LOGWARNING("Failed to store byproducts of '{}' in import cache.", contentHash);
+    return success;
+}
+
+}
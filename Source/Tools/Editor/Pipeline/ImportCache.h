@@ -0,0 +1,63 @@
+//
+// Copyright (c) 2017-2020 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <Urho3D/Core/Object.h>
+
+namespace Urho3D
+{
+
+/// Content-addressed store of import byproducts. Byproducts are stored under the content hash of importer input, therefore
+/// they survive cache directory wipes and branch switches, and may be shared by multiple checkouts of the project.
+///
+/// Store layout: `{storePath}/{first two hash characters}/{hash}/` directory contains `byproducts.txt` with a list of
+/// byproduct resource names and `data/` subdirectory with byproduct files. Entries are written to temporary directory
+/// first and renamed into place, so concurrent writers never produce partial entries.
+class ImportCache : public Object
+{
+    URHO3D_OBJECT(ImportCache, Object);
+public:
+    /// Construct.
+    explicit ImportCache(Context* context);
+    /// Set absolute path to the store directory.
+    void SetStorePath(const ea::string& path);
+    /// Returns absolute path to the store directory.
+    const ea::string& GetStorePath() const { return storePath_; }
+    /// Returns true if store contains byproducts for specified content hash. May be called from non-main thread.
+    bool Contains(const ea::string& contentHash) const;
+    /// Copy byproducts stored for specified content hash to output directory. Returns a list of restored byproducts in
+    /// `byproducts` vector and `true` on success. May be called from non-main thread.
+    bool Restore(const ea::string& contentHash, const ea::string& outputPath, StringVector& byproducts) const;
+    /// Copy byproducts from output directory to the store under specified content hash. Does nothing if store already
+    /// contains this hash. May be called from non-main thread.
+    bool Store(const ea::string& contentHash, const ea::string& outputPath, const StringVector& byproducts) const;
+
+protected:
+    /// Returns absolute path to the store entry of specified content hash.
+    ea::string GetEntryPath(const ea::string& contentHash) const;
+
+    /// Absolute path to the store directory.
+    ea::string storePath_;
+};
+
+}
@@ -21,6 +21,7 @@
 //
 
 #include <Urho3D/IO/ArchiveSerialization.h>
+#include <Urho3D/IO/File.h>
 #include <Urho3D/IO/FileSystem.h>
 
 #include "EditorEvents.h"
@@ -82,6 +83,12 @@ bool AssetImporter::Serialize(Archive& archive, ArchiveBlock& block)
     if (!SerializeVector(archive, "byproducts", "resourceName", byproducts_))
         return false;
 
+    // Optional, missing in assets that were never imported or were imported before content hashing was introduced
+    if (archive.IsInput() || !lastContentHash_.empty())
+        SerializeValue(archive, "contentHash", lastContentHash_);
+    if (archive.IsInput() || lastCheckedSourceTime_ != 0)
+        SerializeValue(archive, "checkedSourceTime", lastCheckedSourceTime_);
+
     lastAttributeHash_ = HashEffectiveAttributeValues();
     return true;
 }
@@ -111,6 +118,7 @@ bool AssetImporter::IsOutOfDate() const
     auto* project = GetSubsystem<Project>();
 
     unsigned mtime = fs->GetLastModifiedTime(asset_->GetResourcePath());
+    bool sourceIsNewer = false;
     for (const ea::string& byproduct : byproducts_)
     {
         ea::string byproductPath = project->GetCachePath() + byproduct;
@@ -118,12 +126,61 @@ bool AssetImporter::IsOutOfDate() const
             return true;
 
         if (fs->GetLastModifiedTime(byproductPath) < mtime)
+            sourceIsNewer = true;
+    }
+
+    // Source file may be touched without changing its contents, for example by switching branches.
+    // Contents are hashed once per modification time of the source.
+    if (sourceIsNewer && mtime != lastCheckedSourceTime_)
+    {
+        if (lastContentHash_.empty() || lastContentHash_ != CalculateContentHash())
             return true;
+        lastCheckedSourceTime_ = mtime;
     }
 
     return false;
 }
 
+ea::string AssetImporter::CalculateContentHash() const
+{
+    // 64-bit FNV-1a, 32-bit hashes are too collision-prone for a store shared by thousands of assets
+    static const unsigned long long FNV_OFFSET_BASIS = 14695981039346656037ull;
+    static const unsigned long long FNV_PRIME = 1099511628211ull;
+    static const unsigned BUFFER_SIZE = 64 * 1024;
+
+    unsigned long long hash = FNV_OFFSET_BASIS;
+    const auto hashBytes = [&hash](const void* data, unsigned size)
+    {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (unsigned i = 0; i < size; ++i)
+            hash = (hash ^ bytes[i]) * FNV_PRIME;
+    };
+
+    File file(context_);
+    if (!file.Open(asset_->GetResourcePath(), FILE_READ))
+        return EMPTY_STRING;
+
+    ea::vector<unsigned char> buffer(BUFFER_SIZE);
+    while (!file.IsEof())
+    {
+        const unsigned size = file.Read(buffer.data(), BUFFER_SIZE);
+        if (size == 0)
+            return EMPTY_STRING;
+        hashBytes(buffer.data(), size);
+    }
+
+    const ea::string& typeName = GetTypeName();
+    const ea::string& flavorName = flavor_->GetName();
+    const unsigned version = GetVersion();
+    const unsigned attributeHash = HashEffectiveAttributeValues();
+    hashBytes(typeName.c_str(), typeName.length() + 1);
+    hashBytes(flavorName.c_str(), flavorName.length() + 1);
+    hashBytes(&version, sizeof(version));
+    hashBytes(&attributeHash, sizeof(attributeHash));
+
+    return Format("{:016x}", hash);
+}
+
 void AssetImporter::OnGetAttribute(const AttributeInfo& attr, Variant& dest) const
 {
     auto it = isAttributeSet_.find(attr.name_);
@@ -190,6 +247,14 @@ void AssetImporter::RemoveByproduct(const ea::string& byproduct)
     }
 }
 
+void AssetImporter::SetRestoredByproducts(const ea::string& contentHash, const StringVector& byproducts)
+{
+    lastAttributeHash_ = HashEffectiveAttributeValues();
+    lastContentHash_ = contentHash;
+    lastCheckedSourceTime_ = 0;
+    byproducts_ = byproducts;
+}
+
 bool AssetImporter::SaveDefaultAttributes(const AttributeInfo& attr) const
 {
     auto it = isAttributeSet_.find(attr.name_);
@@ -63,6 +63,14 @@ public:
     bool IsModified() const;
     /// Source asset file change, importer settings modification or lack of artifacts are some of conditions that prompt return of true value.
     bool IsOutOfDate() const;
+    /// Returns version of importer output. Increment it when importer produces different byproducts for the same input, so
+    /// that byproducts of older versions are not reused from the import cache.
+    virtual unsigned GetVersion() const { return 1; }
+    /// Returns a hash of everything that affects import results: source file contents, importer type and version, flavor
+    /// and effective attribute values. Returns empty string if source file can not be read. May be called from non-main thread.
+    ea::string CalculateContentHash() const;
+    /// Returns content hash as seen during last import.
+    const ea::string& GetLastContentHash() const { return lastContentHash_; }
     ///
     void OnGetAttribute(const AttributeInfo& attr, Variant& dest) const override;
     ///
@@ -83,6 +91,8 @@ protected:
     void AddByproduct(const ea::string& byproduct);
     /// Unregister a byproduct. Should be called from AssetImporter::Execute().
     void RemoveByproduct(const ea::string& byproduct);
+    /// Replace byproducts with ones restored from the import cache instead of executing the importer.
+    void SetRestoredByproducts(const ea::string& contentHash, const StringVector& byproducts);
     /// Returns true if user has modified the attribute even if attribute value is equal to default value.
     bool SaveDefaultAttributes(const AttributeInfo& attr) const override;
     /// Returns a hash of all attribute values that are in effect (including unset/default/inherited values). Used for detecting a change in settings.
@@ -107,8 +117,13 @@ protected:
     ea::unordered_map<StringHash, bool> isAttributeSet_{};
     /// A hash of all attribute values as seen during last execution of AssetImporter::Execute().
     unsigned lastAttributeHash_ = 0;
+    /// A hash of importer input as seen during last import.
+    ea::string lastContentHash_{};
+    /// Modification time of the source that was found to match the last content hash.
+    mutable unsigned lastCheckedSourceTime_ = 0;
 
     friend class Asset;
+    friend class Pipeline;
 };
 
 }
@@ -141,7 +141,8 @@ bool ModelImporter::Execute(Urho3D::Asset* input, const ea::string& outputPath)
         fs->CreateDirsRecursive(GetPath(moveTo));
         fs->Rename(byproductPath, moveTo);
         fs->SetLastModifiedTime(moveTo, mtime);
-        AddByproduct(byproduct);
+        // Full path, so that byproducts of non-default flavors are relative to cache directory like in other importers
+        AddByproduct(moveTo);
     }
 
     fs->RemoveDir(tempPath, true);
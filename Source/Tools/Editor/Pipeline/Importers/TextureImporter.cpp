@@ -20,14 +20,279 @@
 // THE SOFTWARE.
 //
 
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/Thread.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/IO/File.h>
 #include <Urho3D/IO/FileSystem.h>
 #include <Urho3D/IO/Log.h>
+#include <Urho3D/Resource/BlockCompression.h>
+#include <Urho3D/Resource/Decompress.h>
+#include <Urho3D/Resource/Image.h>
 #include "Pipeline/Asset.h"
 #include "Pipeline/Importers/TextureImporter.h"
 
+#include <STB/stb_image.h>
+
+#include <atomic>
+
 namespace Urho3D
 {
 
+namespace
+{
+
+/// Max number of helper threads accepted by crunch.
+const unsigned MAX_CRUNCH_HELPER_THREADS = 16;
+/// Number of block rows encoded at once by built-in encoders.
+const unsigned TILE_BLOCK_ROWS = 4;
+/// DXGI format of BC6H textures.
+const unsigned DXGI_FORMAT_BC6H = 95;
+/// DXGI format of BC7 textures.
+const unsigned DXGI_FORMAT_BC7 = 98;
+/// OpenGL internal format of ASTC 4x4 textures.
+const unsigned KTX_INTERNAL_FORMAT_ASTC_4x4 = 0x93b0;
+/// OpenGL base internal format of RGBA textures.
+const unsigned KTX_BASE_INTERNAL_FORMAT_RGBA = 0x1908;
+
+/// Range of block rows of a mip level.
+struct EncodeTile
+{
+    /// Mip level.
+    unsigned level_{};
+    /// First block row.
+    unsigned beginRow_{};
+    /// Block row after the last one.
+    unsigned endRow_{};
+};
+
+/// Number of threads not used by any import. Each import takes one thread for itself while it runs on a WorkQueue
+/// thread and its helpers take what is left, so imports and their helpers together don't exceed the number of CPUs.
+std::atomic<unsigned> numFreeEncoderThreads{GetNumLogicalCPUs()};
+
+/// Encoder threads reserved for one import.
+class EncoderThreadReservation
+{
+public:
+    /// Reserve as many free threads as possible, up to given number.
+    explicit EncoderThreadReservation(unsigned maxCount)
+    {
+        unsigned numFree = numFreeEncoderThreads.load();
+        do
+            count_ = Min(numFree, maxCount);
+        while (!numFreeEncoderThreads.compare_exchange_weak(numFree, numFree - count_));
+    }
+    /// Return reserved threads.
+    ~EncoderThreadReservation() { numFreeEncoderThreads += count_; }
+
+    /// Prevent copy.
+    EncoderThreadReservation(const EncoderThreadReservation&) = delete;
+    EncoderThreadReservation& operator=(const EncoderThreadReservation&) = delete;
+
+    /// Return number of reserved threads.
+    unsigned GetCount() const { return count_; }
+
+private:
+    /// Number of reserved threads.
+    unsigned count_{};
+};
+
+/// Thread helping the importing thread to encode tiles.
+class TileEncoderThread : public Thread
+{
+public:
+    /// Construct.
+    explicit TileEncoderThread(const ea::function<void()>& work)
+        : Thread("TextureImporter")
+        , work_(work)
+    {
+    }
+
+    /// Encode tiles until none are left.
+    void ThreadFunction() override { work_(); }
+
+private:
+    /// Work function.
+    ea::function<void()> work_;
+};
+
+/// Encode tiles on the calling thread and helper threads. Importers are executed by WorkQueue threads
+/// and can't wait for other work items, so the tiles are shared with dedicated threads instead.
+template <class T>
+void EncodeTilesParallel(const ea::vector<EncodeTile>& tiles, unsigned numHelperThreads, const T& encodeTile)
+{
+    std::atomic<unsigned> nextTile{};
+    const auto work = [&]()
+    {
+        for (unsigned index = nextTile++; index < tiles.size(); index = nextTile++)
+            encodeTile(tiles[index]);
+    };
+
+    ea::vector<ea::unique_ptr<TileEncoderThread>> threads;
+    numHelperThreads = Min(numHelperThreads, tiles.size() > 0 ? tiles.size() - 1 : 0u);
+    for (unsigned i = 0; i < numHelperThreads; ++i)
+    {
+        auto thread = ea::make_unique<TileEncoderThread>(work);
+        if (thread->Run())
+            threads.push_back(ea::move(thread));
+    }
+
+    work();
+
+    for (auto& thread : threads)
+        thread->Stop();
+}
+
+/// Map crunch DXT quality to quality of built-in encoders.
+BlockCompressionQuality GetBlockCompressionQuality(TextureImporter::DxtQuality quality)
+{
+    switch (quality)
+    {
+    case TextureImporter::DxtQuality::Superfast:
+    case TextureImporter::DxtQuality::Fast:
+        return BlockCompressionQuality::Fast;
+    case TextureImporter::DxtQuality::Normal:
+        return BlockCompressionQuality::Normal;
+    default:
+        return BlockCompressionQuality::High;
+    }
+}
+
+/// Flip image rows in place.
+void FlipRowsVertical(void* data, int width, int height, unsigned pixelSize)
+{
+    auto* bytes = static_cast<unsigned char*>(data);
+    const unsigned rowSize = width * pixelSize;
+    ea::vector<unsigned char> row(rowSize);
+    for (int y = 0; y < height / 2; ++y)
+    {
+        unsigned char* top = bytes + y * rowSize;
+        unsigned char* bottom = bytes + (height - y - 1) * rowSize;
+        memcpy(row.data(), top, rowSize);
+        memcpy(top, bottom, rowSize);
+        memcpy(bottom, row.data(), rowSize);
+    }
+}
+
+/// Return next mip level of RGB float image using 2x2 box filter.
+ea::vector<float> DownsampleFloatRGB(const ea::vector<float>& src, int width, int height)
+{
+    const int destWidth = Max(width / 2, 1);
+    const int destHeight = Max(height / 2, 1);
+    ea::vector<float> dest(destWidth * destHeight * 3);
+    for (int y = 0; y < destHeight; ++y)
+    {
+        const int y0 = Min(y * 2, height - 1);
+        const int y1 = Min(y * 2 + 1, height - 1);
+        for (int x = 0; x < destWidth; ++x)
+        {
+            const int x0 = Min(x * 2, width - 1);
+            const int x1 = Min(x * 2 + 1, width - 1);
+            for (unsigned c = 0; c < 3; ++c)
+            {
+                const float sum = src[(y0 * width + x0) * 3 + c] + src[(y0 * width + x1) * 3 + c]
+                    + src[(y1 * width + x0) * 3 + c] + src[(y1 * width + x1) * 3 + c];
+                dest[(y * destWidth + x) * 3 + c] = sum * 0.25f;
+            }
+        }
+    }
+    return dest;
+}
+
+/// Return PSNR of RGB channels of two RGBA images.
+float CalculatePSNR(const unsigned char* reference, const unsigned char* image, int width, int height)
+{
+    double squaredError = 0.0;
+    for (int i = 0; i < width * height; ++i)
+    {
+        for (unsigned c = 0; c < 3; ++c)
+        {
+            const int delta = reference[i * 4 + c] - image[i * 4 + c];
+            squaredError += delta * delta;
+        }
+    }
+
+    if (squaredError == 0.0)
+        return M_INFINITY;
+
+    const double meanSquaredError = squaredError / (width * height * 3);
+    return static_cast<float>(10.0 * log10(255.0 * 255.0 / meanSquaredError));
+}
+
+/// Write compressed mip levels to DDS file with DX10 header.
+void WriteDDS(Serializer& dest, const ea::vector<IntVector2>& levelSizes, const ea::vector<unsigned char>& data, unsigned dxgiFormat)
+{
+    const unsigned numLevels = levelSizes.size();
+    const unsigned linearSize = (levelSizes[0].x_ + 3) / 4 * ((levelSizes[0].y_ + 3) / 4) * BLOCK_COMPRESSION_BLOCK_SIZE;
+
+    dest.WriteFileID("DDS ");
+    dest.WriteUInt(124);
+    dest.WriteUInt(0x00000001 /*DDSD_CAPS*/ | 0x00000002 /*DDSD_HEIGHT*/ | 0x00000004 /*DDSD_WIDTH*/
+        | 0x00001000 /*DDSD_PIXELFORMAT*/ | 0x00020000 /*DDSD_MIPMAPCOUNT*/ | 0x00080000 /*DDSD_LINEARSIZE*/);
+    dest.WriteUInt(levelSizes[0].y_);
+    dest.WriteUInt(levelSizes[0].x_);
+    dest.WriteUInt(linearSize);
+    dest.WriteUInt(0);
+    dest.WriteUInt(numLevels);
+    for (unsigned i = 0; i < 11; ++i)
+        dest.WriteUInt(0);
+
+    // Pixel format
+    dest.WriteUInt(32);
+    dest.WriteUInt(0x00000004 /*DDPF_FOURCC*/);
+    dest.WriteFileID("DX10");
+    for (unsigned i = 0; i < 5; ++i)
+        dest.WriteUInt(0);
+
+    // Caps
+    dest.WriteUInt(0x00001000 /*DDSCAPS_TEXTURE*/ | (numLevels > 1 ? 0x00400008 /*DDSCAPS_MIPMAP | DDSCAPS_COMPLEX*/ : 0));
+    for (unsigned i = 0; i < 4; ++i)
+        dest.WriteUInt(0);
+
+    // DX10 header
+    dest.WriteUInt(dxgiFormat);
+    dest.WriteUInt(3 /*D3D10_RESOURCE_DIMENSION_TEXTURE2D*/);
+    dest.WriteUInt(0);
+    dest.WriteUInt(1);
+    dest.WriteUInt(0);
+
+    dest.Write(data.data(), data.size());
+}
+
+/// Write compressed mip levels to KTX file.
+void WriteKTX(Serializer& dest, const ea::vector<IntVector2>& levelSizes, const ea::vector<unsigned>& levelOffsets,
+    const ea::vector<unsigned char>& data, unsigned internalFormat)
+{
+    static const unsigned char identifier[] = {0xab, 'K', 'T', 'X', ' ', '1', '1', 0xbb, '\r', '\n', 0x1a, '\n'};
+    dest.Write(identifier, sizeof(identifier));
+    dest.WriteUInt(0x04030201);
+    // Type, type size and format of compressed data
+    dest.WriteUInt(0);
+    dest.WriteUInt(1);
+    dest.WriteUInt(0);
+    dest.WriteUInt(internalFormat);
+    dest.WriteUInt(KTX_BASE_INTERNAL_FORMAT_RGBA);
+    dest.WriteUInt(levelSizes[0].x_);
+    dest.WriteUInt(levelSizes[0].y_);
+    // Depth, array elements, faces
+    dest.WriteUInt(0);
+    dest.WriteUInt(0);
+    dest.WriteUInt(1);
+    dest.WriteUInt(levelSizes.size());
+    // Key-value data
+    dest.WriteUInt(0);
+
+    // Block size is a multiple of 4, no padding is needed
+    for (unsigned level = 0; level < levelSizes.size(); ++level)
+    {
+        const unsigned endOffset = level + 1 < levelOffsets.size() ? levelOffsets[level + 1] : data.size();
+        dest.WriteUInt(endOffset - levelOffsets[level]);
+        dest.Write(data.data() + levelOffsets[level], endOffset - levelOffsets[level]);
+    }
+}
+
+}
+
 const char* TextureImporter::mipModeNames[] = {
     "None",
     "Generate",
@@ -85,6 +350,9 @@ const char* TextureImporter::pixelFormatNames[] = {
     "A8",
     "A8L8",
     "A8R8G8B8",
+    "BC7",
+    "BC6H",
+    "ASTC4x4",
     nullptr
 };
 
@@ -124,7 +392,7 @@ void TextureImporter::RegisterObject(Context* context)
 
 bool TextureImporter::Accepts(const ea::string& path) const
 {
-    return path.ends_with(".png");
+    return path.ends_with(".png") || path.ends_with(".hdr");
 }
 
 bool TextureImporter::Execute(Urho3D::Asset* input, const ea::string& outputPath)
@@ -133,7 +401,6 @@ bool TextureImporter::Execute(Urho3D::Asset* input, const ea::string& outputPath
         return false;
 
     ea::string outputDirectory = outputPath + GetPath(input->GetName());
-    ea::string outputFile = outputDirectory + GetFileName(input->GetName()) + ".dds";
     int pixelFormatValue = GetAttribute("Pixel Format").GetInt();
 
     if (pixelFormatValue == (int)PixelFormat::None)
@@ -141,6 +408,29 @@ bool TextureImporter::Execute(Urho3D::Asset* input, const ea::string& outputPath
     else
         context_->GetSubsystem<FileSystem>()->CreateDirsRecursive(outputDirectory);
 
+    const auto pixelFormat = static_cast<PixelFormat>(pixelFormatValue);
+    const bool isHDR = input->GetName().ends_with(".hdr");
+    if (isHDR && pixelFormat != PixelFormat::BC6H)
+    {
+        logger_.Error("HDR texture 'res://{}' can only be compressed to BC6H.", input->GetName());
+        return false;
+    }
+
+    // Importing thread is taken from the budget until the import finishes, helpers get the rest
+    const EncoderThreadReservation importThread(1);
+
+    if (pixelFormat == PixelFormat::BC7 || pixelFormat == PixelFormat::BC6H)
+        return ExecuteBlockCompression(input, outputDirectory + GetFileName(input->GetName()) + ".dds", pixelFormat);
+    else if (pixelFormat == PixelFormat::ASTC4x4)
+        return ExecuteBlockCompression(input, outputDirectory + GetFileName(input->GetName()) + ".ktx", pixelFormat);
+    else
+        return ExecuteCrunch(input, outputDirectory + GetFileName(input->GetName()) + ".dds", pixelFormat);
+}
+
+bool TextureImporter::ExecuteCrunch(Asset* input, const ea::string& outputFile, PixelFormat pixelFormat)
+{
+    HiresTimer timer;
+
     ea::string output;
     StringVector arguments{
         "-fileformat", "dds", "-noprogress", "-nostats", "-quality", ea::to_string(GetAttribute("Quality").GetInt()),
@@ -198,8 +488,13 @@ bool TextureImporter::Execute(Urho3D::Asset* input, const ea::string& outputPath
     if (GetAttribute("Use Transparent Indices For Black").GetBool())
         arguments.push_back("-usetransparentindicesforblack");
 
-    ea::string pixelFormat = pixelFormatNames[pixelFormatValue];
-    arguments.push_back(Format("-{}", pixelFormat));
+    // Helpers are reserved until crunch exits
+    const EncoderThreadReservation helperThreads(MAX_CRUNCH_HELPER_THREADS);
+    arguments.push_back("-helperThreads");
+    arguments.push_back(ea::to_string(helperThreads.GetCount()));
+
+    ea::string pixelFormatName = pixelFormatNames[(int)pixelFormat];
+    arguments.push_back(Format("-{}", pixelFormatName));
 
     arguments.push_back("-out");
     arguments.push_back(outputFile);
@@ -209,16 +504,215 @@ bool TextureImporter::Execute(Urho3D::Asset* input, const ea::string& outputPath
     int result = context_->GetSubsystem<FileSystem>()->SystemRun(context_->GetSubsystem<FileSystem>()->GetProgramDir() + "/crunch", arguments, output);
     if (result != 0)
     {
-        logger_.Error("Error {}-compressing 'res://{}' to '{}' failed.", pixelFormat, input->GetName(), outputFile);
+        logger_.Error("Error {}-compressing 'res://{}' to '{}' failed.", pixelFormatName, input->GetName(), outputFile);
         if (!output.empty())
             URHO3D_LOGERROR(output);
         return false;
     }
 
     AddByproduct(outputFile);
+
+    // Compare the first level with the source image, formats unknown to Image are not measured
+    const long long importTime = timer.GetUSec(false);
+    float psnr = -1.0f;
+    auto sourceImage = MakeShared<Image>(context_);
+    auto compressedImage = MakeShared<Image>(context_);
+    if (sourceImage->LoadFile(input->GetResourcePath()) && compressedImage->LoadFile(outputFile) && compressedImage->IsCompressed())
+    {
+        if (GetAttribute("Y-flip").GetBool())
+            sourceImage->FlipVertical();
+        SharedPtr<Image> sourceRGBA = sourceImage->ConvertToRGBA();
+        SharedPtr<Image> decompressedImage = compressedImage->GetDecompressedImage();
+        if (sourceRGBA && decompressedImage && sourceRGBA->GetWidth() == decompressedImage->GetWidth()
+            && sourceRGBA->GetHeight() == decompressedImage->GetHeight())
+        {
+            psnr = CalculatePSNR(sourceRGBA->GetData(), decompressedImage->GetData(), sourceRGBA->GetWidth(),
+                sourceRGBA->GetHeight());
+        }
+    }
+
+    ReportQuality(input, pixelFormat, importTime, psnr);
     return true;
 }
 
+bool TextureImporter::ExecuteBlockCompression(Asset* input, const ea::string& outputFile, PixelFormat pixelFormat)
+{
+    HiresTimer timer;
+
+    const bool isHDR = input->GetName().ends_with(".hdr");
+    const bool yFlip = GetAttribute("Y-flip").GetBool();
+    const auto mipMode = static_cast<MipMode>(GetAttribute("Mip Mode").GetInt());
+    const auto mipFilter = static_cast<MipFilter>(GetAttribute("Mip Filter").GetInt());
+    const bool sRGB = !Equals(GetAttribute("Gamma").GetFloat(), 1.0f);
+    const unsigned maxLevels = mipMode == MipMode::Generate || mipMode == MipMode::UseSourceOrGenerate
+        ? static_cast<unsigned>(GetAttribute("Max Mips").GetInt()) : 1u;
+    const int minMipSize = GetAttribute("Min Mip Size").GetInt();
+    const BlockCompressionQuality quality = GetBlockCompressionQuality(static_cast<DxtQuality>(GetAttribute("DXT Quality").GetInt()));
+
+    // Load the source and generate mip levels, HDR levels are kept in float
+    ea::vector<SharedPtr<Image>> levels;
+    ea::vector<ea::vector<float>> levelsHDR;
+    IntVector2 size;
+    if (isHDR)
+    {
+        File file(context_, input->GetResourcePath());
+        ea::vector<unsigned char> buffer(file.GetSize());
+        if (!file.IsOpen() || file.Read(buffer.data(), buffer.size()) != buffer.size())
+        {
+            logger_.Error("Failed to read 'res://{}'.", input->GetName());
+            return false;
+        }
+
+        int components = 0;
+        float* pixels = stbi_loadf_from_memory(buffer.data(), static_cast<int>(buffer.size()), &size.x_, &size.y_, &components, 3);
+        if (!pixels)
+        {
+            logger_.Error("Failed to decode 'res://{}'.", input->GetName());
+            return false;
+        }
+
+        levelsHDR.emplace_back(pixels, pixels + size.x_ * size.y_ * 3);
+        stbi_image_free(pixels);
+
+        if (yFlip)
+            FlipRowsVertical(levelsHDR[0].data(), size.x_, size.y_, 3 * sizeof(float));
+    }
+    else
+    {
+        auto image = MakeShared<Image>(context_);
+        if (!image->LoadFile(input->GetResourcePath()))
+        {
+            logger_.Error("Failed to load 'res://{}'.", input->GetName());
+            return false;
+        }
+
+        if (yFlip)
+            image->FlipVertical();
+
+        levels.push_back(image->ConvertToRGBA());
+        size = IntVector2(levels[0]->GetWidth(), levels[0]->GetHeight());
+
+        // Unlike other formats BC6H is stored in float
+        if (pixelFormat == PixelFormat::BC6H)
+        {
+            const unsigned char* data = levels[0]->GetData();
+            levelsHDR.emplace_back(size.x_ * size.y_ * 3);
+            for (int i = 0; i < size.x_ * size.y_; ++i)
+            {
+                for (unsigned c = 0; c < 3; ++c)
+                    levelsHDR[0][i * 3 + c] = data[i * 4 + c] / 255.0f;
+            }
+        }
+    }
+
+    ea::vector<IntVector2> levelSizes{size};
+    while (levelSizes.size() < maxLevels)
+    {
+        const IntVector2 lastSize = levelSizes.back();
+        if (lastSize == IntVector2::ONE || Max(lastSize.x_, lastSize.y_) / 2 < minMipSize)
+            break;
+
+        if (!levelsHDR.empty())
+            levelsHDR.push_back(DownsampleFloatRGB(levelsHDR.back(), lastSize.x_, lastSize.y_));
+        else
+            levels.push_back(levels.back()->GetNextLevel(mipFilter == MipFilter::Kaiser ? ImageMipFilter::Kaiser : ImageMipFilter::Box, sRGB));
+
+        levelSizes.emplace_back(Max(lastSize.x_ / 2, 1), Max(lastSize.y_ / 2, 1));
+    }
+
+    // Split levels into tiles of block rows
+    ea::vector<unsigned> levelOffsets;
+    ea::vector<EncodeTile> tiles;
+    unsigned dataSize = 0;
+    for (unsigned level = 0; level < levelSizes.size(); ++level)
+    {
+        const unsigned blocksWide = (levelSizes[level].x_ + 3) / 4;
+        const unsigned blocksHigh = (levelSizes[level].y_ + 3) / 4;
+        levelOffsets.push_back(dataSize);
+        dataSize += blocksWide * blocksHigh * BLOCK_COMPRESSION_BLOCK_SIZE;
+
+        for (unsigned beginRow = 0; beginRow < blocksHigh; beginRow += TILE_BLOCK_ROWS)
+            tiles.push_back(EncodeTile{level, beginRow, Min(beginRow + TILE_BLOCK_ROWS, blocksHigh)});
+    }
+
+    ea::vector<unsigned char> data(dataSize);
+    const auto encodeTile = [&](const EncodeTile& tile)
+    {
+        const IntVector2 levelSize = levelSizes[tile.level_];
+        const unsigned blocksWide = (levelSize.x_ + 3) / 4;
+        const int beginY = tile.beginRow_ * 4;
+        const int height = Min(static_cast<int>(tile.endRow_ * 4), levelSize.y_) - beginY;
+        unsigned char* dest = data.data() + levelOffsets[tile.level_] + tile.beginRow_ * blocksWide * BLOCK_COMPRESSION_BLOCK_SIZE;
+
+        if (pixelFormat == PixelFormat::BC6H)
+            CompressImageBC6H(dest, levelsHDR[tile.level_].data() + beginY * levelSize.x_ * 3, levelSize.x_, height, quality);
+        else
+        {
+            const unsigned char* src = levels[tile.level_]->GetData() + beginY * levelSize.x_ * 4;
+            CompressImageBlocks(dest, src, levelSize.x_, height, pixelFormat == PixelFormat::BC7 ? CF_BC7 : CF_ASTC_4x4, quality);
+        }
+    };
+
+    const EncoderThreadReservation helperThreads(tiles.size() > 0 ? tiles.size() - 1 : 0u);
+    EncodeTilesParallel(tiles, helperThreads.GetCount(), encodeTile);
+
+    File outputImage(context_, outputFile, FILE_WRITE);
+    if (!outputImage.IsOpen())
+    {
+        logger_.Error("Failed to open '{}' for writing.", outputFile);
+        return false;
+    }
+
+    if (pixelFormat == PixelFormat::ASTC4x4)
+        WriteKTX(outputImage, levelSizes, levelOffsets, data, KTX_INTERNAL_FORMAT_ASTC_4x4);
+    else
+        WriteDDS(outputImage, levelSizes, data, pixelFormat == PixelFormat::BC7 ? DXGI_FORMAT_BC7 : DXGI_FORMAT_BC6H);
+    outputImage.Close();
+
+    AddByproduct(outputFile);
+    const long long importTime = timer.GetUSec(false);
+
+    // Compare the first level with the source image, HDR source is compared in [0, 1] range
+    ea::vector<unsigned char> sourceRGBA;
+    const unsigned char* reference = nullptr;
+    if (isHDR)
+    {
+        sourceRGBA.resize(size.x_ * size.y_ * 4);
+        for (int i = 0; i < size.x_ * size.y_; ++i)
+        {
+            for (unsigned c = 0; c < 3; ++c)
+                sourceRGBA[i * 4 + c] = static_cast<unsigned char>(RoundToInt(Clamp(levelsHDR[0][i * 3 + c], 0.0f, 1.0f) * 255.0f));
+            sourceRGBA[i * 4 + 3] = 255;
+        }
+        reference = sourceRGBA.data();
+    }
+    else
+        reference = levels[0]->GetData();
+
+    ea::vector<unsigned char> decompressed(size.x_ * size.y_ * 4);
+    if (pixelFormat == PixelFormat::BC7)
+        DecompressImageBC7(decompressed.data(), data.data(), size.x_, size.y_);
+    else if (pixelFormat == PixelFormat::BC6H)
+        DecompressImageBC6H(decompressed.data(), data.data(), size.x_, size.y_);
+    else
+        DecompressImageASTC(decompressed.data(), data.data(), size.x_, size.y_);
+
+    ReportQuality(input, pixelFormat, importTime, CalculatePSNR(reference, decompressed.data(), size.x_, size.y_));
+    return true;
+}
+
+void TextureImporter::ReportQuality(Asset* input, PixelFormat pixelFormat, long long importTime, float psnr)
+{
+    const float importTimeMs = importTime / 1000.0f;
+    if (psnr < 0.0f)
+        logger_.Info("{}-compressed 'res://{}' in {:.1f} ms.", pixelFormatNames[(int)pixelFormat], input->GetName(), importTimeMs);
+    else
+    {
+        logger_.Info("{}-compressed 'res://{}' in {:.1f} ms, PSNR {:.2f} dB.", pixelFormatNames[(int)pixelFormat],
+            input->GetName(), importTimeMs, psnr);
+    }
+}
+
 void TextureImporter::ApplyBlurLimit()
 {
     if (blur_ < 0.01f)
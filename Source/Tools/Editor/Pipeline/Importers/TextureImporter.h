@@ -94,6 +94,9 @@ public:
         A8,
         A8L8,
         A8R8G8B8,
+        BC7,
+        BC6H,
+        ASTC4x4,
     };
 
     static const char* mipModeNames[];
@@ -111,6 +114,13 @@ public:
     bool Execute(Urho3D::Asset* input, const ea::string& outputPath) override;
 
 protected:
+    /// Compress texture to BC7, BC6H or ASTC by built-in encoders. Mip levels are split into tiles encoded in parallel.
+    bool ExecuteBlockCompression(Asset* input, const ea::string& outputFile, PixelFormat pixelFormat);
+    /// Compress texture by crunch.
+    bool ExecuteCrunch(Asset* input, const ea::string& outputFile, PixelFormat pixelFormat);
+    /// Log import time and PSNR of the first level of compressed texture against source image.
+    void ReportQuality(Asset* input, PixelFormat pixelFormat, long long importTime, float psnr);
+
     ///
     void ApplyBlurLimit();
     ///
@@ -22,12 +22,8 @@
 
 #include <EASTL/sort.h>
 
-#include <Urho3D/Core/WorkQueue.h>
-#include <Urho3D/Core/Thread.h>
 #include <Urho3D/IO/Log.h>
 #include <Urho3D/IO/FileSystem.h>
-#include <LZ4/lz4.h>
-#include <LZ4/lz4hc.h>
 
 #include "Project.h"
 #include "Pipeline/Pipeline.h"
@@ -40,9 +36,7 @@ namespace Urho3D
 
 Packager::Packager(Context* context)
     : Object(context)
-    , output_(context)
 {
-    compressBuffer_.resize(LZ4_compressBound(blockSize_));
 }
 
 Packager::~Packager()
@@ -57,25 +51,33 @@ bool Packager::OpenPackage(const ea::string& path, Flavor* flavor, bool compress
     logger_ = Log::GetLogger(GetFileNameAndExtension(path));
 
     flavor_ = WeakPtr(flavor);
-    compress_ = compress;
 
-    if (output_.Open(path, FILE_WRITE))
+    builder_ = MakeShared<PackageBuilder>(context_);
+    if (builder_->Create(path, compress))
     {
-        WriteHeaders();
+        // Dictionary is used only for files that compress better with it
+        builder_->SetDictionaryEnabled(compress);
         return true;
     }
+    builder_ = nullptr;
     logger_.Error("Opening '{}' failed, package was not created.", GetFileNameAndExtension(path));
     return false;
 }
 
 float Packager::GetProgress() const
 {
-    return (float)(1.0 / filesTotal_ * filesDone_);
+    if (!started_)
+        return 1.0f;
+
+    // Adding files of the assets and writing them take one half each
+    const float addProgress = queuedAssets_.empty() ? 1.0f : static_cast<float>(nextAsset_) / queuedAssets_.size();
+    const float writeProgress = filesAdded_ ? builder_->GetProgress() : 0.0f;
+    return 0.5f * (addProgress + writeProgress);
 }
 
 bool Packager::IsCompleted() const
 {
-    return filesTotal_ == filesDone_;
+    return !started_;
 }
 
 void Packager::AddAsset(Asset* asset)
@@ -87,38 +89,37 @@ void Packager::AddAsset(Asset* asset)
 void Packager::Start()
 {
     assert(IsCompleted());
-    filesTotal_ = queuedAssets_.size() + 2;     // CacheInfo.json + Settings.json
-
-    if (filesTotal_ == 0)
-    {
-        logger_.Warning("Resources directory is empty, package was not created.");
-        output_.Close();
-        context_->GetSubsystem<FileSystem>()->Delete(outputPath_);
+    if (!builder_)
         return;
-    }
-
-    context_->GetSubsystem<WorkQueue>()->AddWorkItem([this](unsigned /*threadIndex*/) { WritePackage(); });
-}
 
-void Packager::WritePackage()
-{
-    assert(!IsCompleted());
     logger_.Info("Packaging started.");
 
     ea::quick_sort(queuedAssets_.begin(), queuedAssets_.end(), [](const SharedPtr<Asset>& a, const SharedPtr<Asset>& b) {
         return a->GetName() < b->GetName();
     });
 
+    nextAsset_ = 0;
+    filesAdded_ = false;
+    numLoggedFiles_ = 0;
+    started_ = true;
+}
+
+void Packager::Update()
+{
+    if (IsCompleted())
+        return;
+
     auto* project = GetSubsystem<Project>();
     const ea::string& resourcePath = project->GetResourcePath();
     ea::string cachePath = flavor_->GetCachePath();
 
-    for (Asset* asset : queuedAssets_)
+    for (; nextAsset_ < queuedAssets_.size(); ++nextAsset_)
     {
         // Asset may be importing at this time. We have to wait. Can not package another asset in this time because we want reproducible
         // packages.
-        while (asset->IsImporting())
-            Time::Sleep(1);
+        Asset* asset = queuedAssets_[nextAsset_];
+        if (asset->IsImporting())
+            return;
 
         bool writtenAny = false;
         for (AssetImporter* importer : asset->GetImporters(flavor_))
@@ -133,131 +134,77 @@ void Packager::WritePackage()
         // Raw assets are only written to default flavor pak
         if (!writtenAny && flavor_->IsDefault())
             AddFile(resourcePath, asset->GetResourcePath());
-
-        filesDone_++;
     }
 
-    // Has to be done here in case any resources were imported during packaging.
-    auto pipeline = GetSubsystem<Pipeline>();
-    pipeline->CookSettings(); // TODO: Thread safety
-    pipeline->CookCacheInfo();// TODO: Thread safety
-    AddFile(cachePath, "CacheInfo.json");   filesDone_++;
-    AddFile(cachePath, "Settings.json");    filesDone_++;
-
-    entriesOffset_ = output_.GetSize();
+    if (!filesAdded_)
+    {
+        // Has to be done here in case any resources were imported during packaging.
+        auto pipeline = GetSubsystem<Pipeline>();
+        pipeline->CookSettings();
+        pipeline->CookCacheInfo();
+        AddFile(cachePath, "CacheInfo.json");
+        AddFile(cachePath, "Settings.json");
+        filesAdded_ = true;
+    }
 
-    for (const FileEntry& entry : entries_)
+    // One batch per frame keeps editor responsive
+    if (builder_->WriteNextBatch())
     {
-        output_.WriteString(entry.name_);
-        output_.WriteUInt(entry.offset_);
-        output_.WriteUInt(entry.size_);
-        output_.WriteUInt(entry.checksum_);
+        LogWrittenFiles();
+        return;
     }
-    // Write package size to the end of file to allow finding it linked to an executable file
-    unsigned currentSize = output_.GetSize();
-    output_.WriteUInt(currentSize + sizeof(unsigned));
 
-    WriteHeaders();
+    if (!builder_->Finish())
+        logger_.Error("Writing '{}' failed.", GetFileNameAndExtension(outputPath_));
 
+    builder_ = nullptr;
+    started_ = false;
     logger_.Info("Packaging completed.");
 }
 
-void Packager::WriteHeaders()
-{
-    output_.Seek(0);
-    output_.WriteFileID(compress_ ? "RLZ4" : "RPAK");
-    output_.WriteUInt(entries_.size());
-    output_.WriteUInt(checksum_);
-    output_.WriteUInt(0);                                   // Version. Reserved for future use.
-    output_.WriteInt64(entriesOffset_);
-}
-
 bool Packager::AddFile(const ea::string& root, const ea::string& path)
 {
     assert(root.ends_with("/"));
 
-    FileEntry entry{};
+    ea::string name;
     ea::string fileFullPath;
 
     if (IsAbsolutePath(path))
     {
-        assert(root.starts_with(root));
+        assert(path.starts_with(root));
         fileFullPath = path;
-        entry.name_ = path.substr(root.length());
+        name = path.substr(root.length());
     }
     else
     {
         fileFullPath = root + path;
-        entry.name_ = path;
+        name = path;
     }
-    entry.checksum_ = 0;
-    entry.offset_ = 0;
-    entry.size_ = File(context_, fileFullPath).GetSize();
-    if (!entry.size_)
-    {
-        logger_.Warning("Skipped empty/missing file '{}'.", fileFullPath);
-        return false;
-    }
-
-    unsigned lastOffset = entry.offset_ = output_.GetSize();
 
-    File srcFile(context_, fileFullPath);
-    if (!srcFile.IsOpen())
+    if (!context_->GetSubsystem<FileSystem>()->FileExists(fileFullPath) || !File(context_, fileFullPath).GetSize())
     {
-        logger_.Error("Could not open file {}. Skipped!", fileFullPath);
-        return false;
-    }
-
-    unsigned dataSize = entry.size_;
-    buffer_.resize(dataSize);
-
-    if (srcFile.Read(&buffer_[0], dataSize) != dataSize)
-    {
-        logger_.Error("Could not read file {}. Skipped!", fileFullPath);
+        logger_.Warning("Skipped empty/missing file '{}'.", fileFullPath);
         return false;
     }
-    srcFile.Close();
 
-    for (unsigned j = 0; j < dataSize; ++j)
-    {
-        checksum_ = SDBMHash(checksum_, buffer_[j]);
-        entry.checksum_ = SDBMHash(entry.checksum_, buffer_[j]);
-    }
+    builder_->AddFile(name, fileFullPath);
+    return true;
+}
 
-    entries_.push_back(entry);
-    if (!compress_)
-    {
-        logger_.Info("Added {} size {}", entry.name_, dataSize);
-        output_.Write(&buffer_[0], entry.size_);
-    }
-    else
+void Packager::LogWrittenFiles()
+{
+    const ea::vector<PackageBuilderEntry>& entries = builder_->GetEntries();
+    for (; numLoggedFiles_ < entries.size(); ++numLoggedFiles_)
     {
-        unsigned pos = 0;
-
-        // TODO: This could be parallelized.
-        while (pos < dataSize)
+        const PackageBuilderEntry& entry = entries[numLoggedFiles_];
+        if (!builder_->IsCompressed())
+            logger_.Info("Added {} size {}", entry.name_, entry.size_);
+        else
         {
-            int unpackedSize = blockSize_;
-            if (pos + unpackedSize > dataSize)
-                unpackedSize = static_cast<int>(dataSize) - pos;
-
-            auto packedSize = (unsigned) LZ4_compress_HC((const char*) &buffer_[pos], (char*) compressBuffer_.data(), unpackedSize,
-                LZ4_compressBound(unpackedSize), 0);
-            if (!packedSize)
-                logger_.Error("LZ4 compression failed for file {} at offset {}.", entry.name_, pos);
-
-            output_.WriteUShort((unsigned short) unpackedSize);
-            output_.WriteUShort((unsigned short) packedSize);
-            output_.Write(compressBuffer_.data(), packedSize);
-
-            pos += unpackedSize;
+            logger_.Info("{} in: {} out: {} ratio: {}", entry.name_, entry.size_, entry.packedSize_,
+                entry.packedSize_ ? 1.f * entry.size_ / entry.packedSize_ : 0.f);
         }
-
-        unsigned totalPackedBytes = output_.GetSize() - lastOffset;
-        logger_.Info("{} in: {} out: {} ratio: {}", entry.name_, dataSize, totalPackedBytes,
-            totalPackedBytes ? 1.f * dataSize / totalPackedBytes : 0.f);
     }
-    return true;
 }
 
 }
@@ -24,30 +24,21 @@
 
 
 #include <Urho3D/Core/Object.h>
-#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/Log.h>
+#include <Urho3D/IO/PackageBuilder.h>
 
 
 namespace Urho3D
 {
 
 class Asset;
-
-struct FileEntry
-{
-    /// This is essentially a resource name.
-    ea::string name_;
-    /// Offset to the file data from the file start.
-    unsigned offset_{};
-    /// Size of file data.
-    unsigned size_{};
-    /// Checksum of file data.
-    unsigned checksum_{};
-};
+class Flavor;
 
 ///
 /// rbfx uses modified Urho3D pak file format. File header is modified and extended. Version field was added to facilitate easy modification
 /// of file structure in the future. Package entry list was moved to the end of the file (much like in a zip file) in order to allow
-/// creation of package files without knowing full list of files before-hand.
+/// creation of package files without knowing full list of files before-hand. Compressed packages of version 1 also store block index
+/// of each file and optional LZ4 dictionary of small JSON and XML files.
 ///
 
 /// %Packager is responsible for creating a package for specified flavor. Package will use new file format and have RPAK/RLZ4 file id.
@@ -67,47 +58,38 @@ public:
     bool IsCompleted() const;
     /// Queues asset for packaging.
     void AddAsset(Asset* asset);
-    /// Begins packaging process and returns immediately. Object must remain alive until IsCompleted() returns true.
+    /// Begins packaging process and returns immediately. Update() must be called until IsCompleted() returns true.
     void Start();
+    /// Writes next batch of files to the package. File data is compressed on WorkQueue threads. Should be called from the main thread
+    /// once per frame.
+    void Update();
     /// Returns flavor packager is packaging.
     Flavor* GetFlavor() const { return flavor_; }
 
 protected:
-    /// Add a file to the package. This is a blocking operation.
+    /// Add a file to the package. File is written by one of the following Update() calls.
     bool AddFile(const ea::string& root, const ea::string& path);
-    /// Writes file headter to the start of the file.
-    void WriteHeaders();
-    /// A worker running in another thread that will handle writing the package.
-    void WritePackage();
+    /// Logs files written since the last call.
+    void LogWrittenFiles();
 
     /// Per-package logger.
     Logger logger_{};
     /// Full path to output package file.
     ea::string outputPath_{};
-    /// Package file.
-    File output_;
-    /// List of files that will be present in the package.
-    ea::vector<FileEntry> entries_{};
+    /// Package writer.
+    SharedPtr<PackageBuilder> builder_;
     /// Flavor that is being compressed.
     WeakPtr<Flavor> flavor_;
     /// A list of assets that are to be written into the package.
     ea::vector<SharedPtr<Asset>> queuedAssets_{};
-    /// Flag indicating whether file content is compressed or not.
-    bool compress_ = false;
-    /// Checksum of all file data (uncompressed).
-    unsigned checksum_ = 0;
-    /// Offset to the list of file entries in this package.
-    int64_t entriesOffset_ = 0;
-    /// LZ4 block size for data compression.
-    const int blockSize_ = 32768;
-    /// Buffer that holds data that was read from file. It will be written to package or used in compression.
-    ea::vector<uint8_t> buffer_{};
-    /// Buffer that holds compressed file data.
-    ea::vector<uint8_t> compressBuffer_{};
-    /// Total number of assets to be processed. This number may be less than files written to the package as each asset may carry multiple byproducts.
-    unsigned filesTotal_ = 0;
-    /// A number of already completed written assets.
-    std::atomic<uint32_t> filesDone_{0};
+    /// Index of the next asset whose files are to be added to the package.
+    unsigned nextAsset_ = 0;
+    /// Flag indicating that all files were added to the package.
+    bool filesAdded_ = false;
+    /// Flag indicating that packaging is in progress.
+    bool started_ = false;
+    /// Number of files already logged.
+    unsigned numLoggedFiles_ = 0;
 };
 
 
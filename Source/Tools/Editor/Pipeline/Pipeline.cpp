@@ -22,6 +22,7 @@
 
 #include <Urho3D/Core/Context.h>
 #include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/Core/Timer.h>
 #include <Urho3D/Core/WorkQueue.h>
 #include <Urho3D/Engine/Engine.h>
 #include <Urho3D/Engine/EngineDefs.h>
@@ -39,6 +40,7 @@
 #include <Toolbox/SystemUI/Widgets.h>
 #include <IconFontCppHeaders/IconsFontAwesome5.h>
 
+#include <EASTL/hash_set.h>
 #include <EASTL/sort.h>
 
 #include "Editor.h"
@@ -56,6 +58,7 @@ namespace Urho3D
 Pipeline::Pipeline(Context* context)
     : Object(context)
     , watcher_(context)
+    , importCache_(MakeShared<ImportCache>(context))
 {
     if (context_->GetSubsystem<Engine>()->IsHeadless())
         return;
@@ -303,6 +306,20 @@ SharedPtr<WorkItem> Pipeline::ScheduleImport(Asset* asset, Flavor* flavor, Pipel
 }
 
 bool Pipeline::ExecuteImport(Asset* asset, Flavor* flavor, PipelineBuildFlags flags)
+{
+    StringVector byproducts;
+    if (!ExecuteImporters(asset, flavor, flags, byproducts))
+        return false;
+
+    for (const ea::string& byproduct : byproducts)
+    {
+        if (Asset* byproductAsset = GetAsset(byproduct))
+            ExecuteImport(byproductAsset, flavor, flags);
+    }
+    return true;
+}
+
+bool Pipeline::ExecuteImporters(Asset* asset, Flavor* flavor, PipelineBuildFlags flags, StringVector& byproducts)
 {
     bool importedAnything = false;
     auto* project = GetSubsystem<Project>();
@@ -320,16 +337,49 @@ bool Pipeline::ExecuteImport(Asset* asset, Flavor* flavor, PipelineBuildFlags fl
         if (!importer->Accepts(asset->GetResourcePath()))
             continue;
 
-        if (importer->Execute(asset, outputPath))
+        HiresTimer timer;
+        const ea::string contentHash = importer->CalculateContentHash();
+
+        // Byproducts of the same input were produced before, possibly on another branch or before cache was wiped
+        bool restored = false;
+        if (importCache_->Contains(contentHash))
         {
-            logger_.Info("{} imported 'res://{}'.", importer->GetTypeName(), asset->GetName());
+            StringVector restoredByproducts;
+            importer->ClearByproducts();
+            restored = importCache_->Restore(contentHash, project->GetCachePath(), restoredByproducts);
+            if (restored)
+                importer->SetRestoredByproducts(contentHash, restoredByproducts);
+        }
+
+        bool succeeded = restored;
+        if (!restored && importer->Execute(asset, outputPath))
+        {
+            succeeded = true;
+            importer->lastContentHash_ = contentHash;
+            importer->lastCheckedSourceTime_ = 0;
+            importCache_->Store(contentHash, project->GetCachePath(), importer->GetByproducts());
+        }
+
+        {
+            MutexLock lock(mutex_);
+            if (!succeeded)
+                ++importStats_.numFailed_;
+            else if (restored)
+                ++importStats_.numCacheHits_;
+            else
+                ++importStats_.numCacheMisses_;
+
+            PipelineImportStats::ImporterTime& importerTime = importStats_.importerTime_[importer->GetTypeName()];
+            ++importerTime.count_;
+            importerTime.time_ += timer.GetUSec(false);
+        }
+
+        if (succeeded)
+        {
+            logger_.Info("{} {} 'res://{}'.", importer->GetTypeName(), restored ? "restored" : "imported", asset->GetName());
 
             importedAnything = true;
-            for (const ea::string& byproduct : importer->GetByproducts())
-            {
-                if (Asset* byproductAsset = GetAsset(byproduct))
-                    ExecuteImport(byproductAsset, flavor, flags);
-            }
+            byproducts.insert(byproducts.end(), importer->GetByproducts().begin(), importer->GetByproducts().end());
         }
     }
 
@@ -357,11 +407,116 @@ void Pipeline::BuildCache(Flavor* flavor, PipelineBuildFlags flags)
     }
 }
 
+void Pipeline::BuildCacheAndWait(Flavor* flavor, PipelineBuildFlags flags)
+{
+    auto* project = GetSubsystem<Project>();
+    auto* fs = context_->GetSubsystem<FileSystem>();
+    auto* workQueue = context_->GetSubsystem<WorkQueue>();
+
+    if (flavor == nullptr)
+        flavor = GetDefaultFlavor();
+
+    StringVector results;
+    fs->ScanDir(results, project->GetResourcePath(), "*.*", SCAN_FILES, true);
+
+    ea::vector<SharedPtr<Asset>> pendingAssets;
+    for (const ea::string& resourceName : results)
+    {
+        if (resourceName.ends_with(".asset"))
+            continue;
+
+        if (Asset* asset = GetAsset(resourceName))
+            pendingAssets.emplace_back(asset);
+    }
+
+    // Import assets in waves: byproducts of one wave are imported in the next one, after importers that produced
+    // them are done. Assets within a wave are independent and are imported in parallel.
+    ea::hash_set<Asset*> visitedAssets;
+    while (!pendingAssets.empty())
+    {
+        ea::vector<StringVector> byproducts(pendingAssets.size());
+        for (unsigned i = 0; i < pendingAssets.size(); ++i)
+        {
+            Asset* asset = pendingAssets[i];
+            if (asset->importing_ || !visitedAssets.insert(asset).second)
+                continue;
+
+            if (flags & PipelineBuildFlag::SKIP_UP_TO_DATE && !asset->IsOutOfDate(flavor))
+            {
+                MutexLock lock(mutex_);
+                ++importStats_.numUpToDate_;
+                continue;
+            }
+
+            asset->importing_ = true;
+            StringVector* assetByproducts = &byproducts[i];
+            workQueue->AddWorkItem([this, asset, flavor, flags, assetByproducts](unsigned /*threadIndex*/)
+            {
+                if (ExecuteImporters(asset, flavor, flags, *assetByproducts))
+                {
+                    MutexLock lock(mutex_);
+                    dirtyAssets_.push_back(SharedPtr(asset));
+                }
+                asset->importing_ = false;
+            }, 0);
+        }
+        WaitForCompletion();
+
+        ea::vector<SharedPtr<Asset>> byproductAssets;
+        for (const StringVector& assetByproducts : byproducts)
+        {
+            for (const ea::string& byproduct : assetByproducts)
+            {
+                if (Asset* byproductAsset = GetAsset(byproduct))
+                    byproductAssets.emplace_back(byproductAsset);
+            }
+        }
+        pendingAssets.swap(byproductAssets);
+
+        // Byproducts were just produced, they are imported unconditionally like ExecuteImport() does
+        flags &= ~PipelineBuildFlags(PipelineBuildFlag::SKIP_UP_TO_DATE);
+    }
+
+    MutexLock lock(mutex_);
+    for (Asset* asset : dirtyAssets_)
+        asset->Save();
+    dirtyAssets_.clear();
+}
+
 void Pipeline::WaitForCompletion() const
 {
     context_->GetSubsystem<WorkQueue>()->Complete(0);
 }
 
+void Pipeline::SetImportCachePath(const ea::string& path)
+{
+    importCache_->SetStorePath(path);
+}
+
+PipelineImportStats Pipeline::GetImportStats() const
+{
+    MutexLock lock(mutex_);
+    return importStats_;
+}
+
+void Pipeline::ResetImportStats()
+{
+    MutexLock lock(mutex_);
+    importStats_ = PipelineImportStats{};
+}
+
+void Pipeline::LogImportStats() const
+{
+    const PipelineImportStats stats = GetImportStats();
+    logger_.Info("Import summary: {} up to date, {} restored from import cache, {} imported, {} failed.",
+        stats.numUpToDate_, stats.numCacheHits_, stats.numCacheMisses_, stats.numFailed_);
+    for (const auto& pair : stats.importerTime_)
+    {
+        logger_.Info("{}: {} runs, {:.3f} s.", pair.first, pair.second.count_,
+            static_cast<double>(pair.second.time_) / 1000000.0);
+    }
+}
+
 void Pipeline::CreatePaksAsync(Flavor* flavor)
 {
     pendingPackageFlavor_.push_back(SharedPtr(flavor));
@@ -393,6 +548,8 @@ void Pipeline::OnUpdate(StringHash, VariantMap&)
 {
     if (packager_.NotNull())
     {
+        packager_->Update();
+
         ui::OpenPopup("Packaging Files");
         if (ui::BeginPopupModal(packagerModalTitle_.c_str(), nullptr,
             ImGuiWindowFlags_NoDocking | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_Popup))
@@ -39,6 +39,7 @@
 #include "Pipeline/Importers/SceneConverter.h"
 #include "Pipeline/Importers/TextureImporter.h"
 #include "Pipeline/Asset.h"
+#include "Pipeline/ImportCache.h"
 #include "Pipeline/Packager.h"
 #include "Pipeline/Flavor.h"
 
@@ -56,6 +57,30 @@ enum class PipelineBuildFlag : unsigned
 };
 URHO3D_FLAGSET(PipelineBuildFlag, PipelineBuildFlags);
 
+/// Statistics of asset importing.
+struct PipelineImportStats
+{
+    /// Time spent by importers of one type.
+    struct ImporterTime
+    {
+        /// Number of executions.
+        unsigned count_{};
+        /// Total execution time in microseconds.
+        long long time_{};
+    };
+
+    /// Number of assets skipped because they were up to date.
+    unsigned numUpToDate_{};
+    /// Number of importer runs satisfied from the import cache.
+    unsigned numCacheHits_{};
+    /// Number of importer runs that had to execute the importer.
+    unsigned numCacheMisses_{};
+    /// Number of importer runs that failed.
+    unsigned numFailed_{};
+    /// Execution time of each importer type, including failed runs.
+    ea::map<ea::string, ImporterTime> importerTime_;
+};
+
 class Pipeline : public Object
 {
     URHO3D_OBJECT(Pipeline, Object);
@@ -84,8 +109,22 @@ public:
     bool ExecuteImport(Asset* asset, Flavor* flavor, PipelineBuildFlags flags);
     /// Mass-schedule assets for importing.
     void BuildCache(Flavor* flavor=nullptr, PipelineBuildFlags flags=PipelineBuildFlag::DEFAULT);
+    /// Import all assets and block until done. Byproducts are imported after assets that produced them, assets that do not
+    /// depend on each other are imported in parallel. Modified assets are saved before returning.
+    void BuildCacheAndWait(Flavor* flavor=nullptr, PipelineBuildFlags flags=PipelineBuildFlag::DEFAULT);
     /// Blocks calling thread until all pipeline tasks complete.
     void WaitForCompletion() const;
+    /// Set directory of content-addressed import cache. Empty path disables import cache. By default "ImportCache"
+    /// directory in the project directory is used.
+    void SetImportCachePath(const ea::string& path);
+    /// Returns directory of content-addressed import cache.
+    const ea::string& GetImportCachePath() const { return importCache_->GetStorePath(); }
+    /// Returns statistics of asset importing since last reset.
+    PipelineImportStats GetImportStats() const;
+    /// Reset statistics of asset importing.
+    void ResetImportStats();
+    /// Print statistics of asset importing to the log.
+    void LogImportStats() const;
     /// Queue packaging of resources for specified flavor. This function returns immediately, however user will be blocked from interacting with editor by modal window until process is done.
     void CreatePaksAsync(Flavor* flavor);
     /// Returns true if resource or any of it's parent directories have non-default flavor settings.
@@ -113,6 +152,9 @@ protected:
     void OnUpdate(StringHash, VariantMap&);
     ///
     void SortFlavors();
+    /// Executes importers of specified asset, or restores their byproducts from import cache. Byproducts are returned in
+    /// `byproducts` vector and are not imported. May be called from non-main thread.
+    bool ExecuteImporters(Asset* asset, Flavor* flavor, PipelineBuildFlags flags, StringVector& byproducts);
     ///
     void OnImporterModified(StringHash, VariantMap& args);
     /// Render a pipeline tab in settings window.
@@ -133,7 +175,7 @@ protected:
     };
 
     ///
-    Mutex mutex_;
+    mutable Mutex mutex_;
     /// A list of assets that were modified in non-main thread and need to be saved on main thread.
     ea::vector<SharedPtr<Asset>> dirtyAssets_;
     /// A list of flavors that are yet to be packaged.
@@ -146,6 +188,10 @@ protected:
     Logger logger_ = Log::GetLogger("pipeline");
     /// Flavor that is to be removed (settings window).
     WeakPtr<Flavor> flavorPendingRemoval_;
+    /// Content-addressed store of import byproducts.
+    SharedPtr<ImportCache> importCache_;
+    /// Statistics of asset importing. Protected by mutex_.
+    PipelineImportStats importStats_;
 
     friend class Project;
     friend class Asset;
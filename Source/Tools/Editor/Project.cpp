@@ -125,6 +125,9 @@ bool Project::LoadProject(const ea::string& projectPath)
     if (!fs->Exists(GetCachePath()))
         fs->CreateDirsRecursive(GetCachePath());
 
+    // Content-addressed import cache survives wiping of cache directory.
+    pipeline_->SetImportCachePath(projectFileDir_ + "ImportCache/");
+
     // Project.json
     ea::string filePath(projectFileDir_ + "Project.json");
     JSONFile file(context_);
@@ -229,7 +232,9 @@ bool Project::LoadProject(const ea::string& projectPath)
 #endif
 #endif
     pipeline_->EnableWatcher();
-    pipeline_->BuildCache(nullptr, PipelineBuildFlag::SKIP_UP_TO_DATE);
+    // Headless subcommands build cache themselves when they need it.
+    if (!context_->GetSubsystem<Engine>()->IsHeadless())
+        pipeline_->BuildCache(nullptr, PipelineBuildFlag::SKIP_UP_TO_DATE);
     return true;
 }
 
@@ -24,41 +24,39 @@
 
 #include <Urho3D/Core/Context.h>
 #include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Core/WorkQueue.h>
 #include <Urho3D/IO/File.h>
 #include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/IO/Log.h>
+#include <Urho3D/IO/PackageBuilder.h>
 #include <Urho3D/IO/PackageFile.h>
 
 #ifdef WIN32
 #include <windows.h>
 #endif
 
-#include <EASTL/unique_ptr.h>
-#include <LZ4/lz4.h>
-#include <LZ4/lz4hc.h>
+#include <random>
 
 #include <Urho3D/DebugNew.h>
 
 
 using namespace Urho3D;
 
-static const unsigned COMPRESSED_BLOCK_SIZE = 32768;
-
-struct FileEntry
-{
-    ea::string name_;
-    unsigned offset_{};
-    unsigned size_{};
-    unsigned checksum_{};
-};
+/// Number of files opened by random access benchmark.
+static const unsigned RANDOM_ACCESS_FILES = 64;
+/// Number of reads per file done by random access benchmark.
+static const unsigned RANDOM_ACCESS_READS = 64;
+/// Size of read done by random access benchmark.
+static const unsigned RANDOM_ACCESS_READ_SIZE = 4096;
 
 Context* context_ = nullptr;
 FileSystem* fileSystem_ = nullptr;
 ea::string basePath_;
-ea::vector<FileEntry> entries_;
-unsigned checksum_ = 0;
+ea::vector<ea::string> entries_;
 bool compress_ = false;
+bool dictionary_ = false;
 bool quiet_ = false;
-unsigned blockSize_ = COMPRESSED_BLOCK_SIZE;
 
 ea::string ignoreExtensions_[] = {
     ".bak",
@@ -69,12 +67,20 @@ int main(int argc, char** argv);
 void Run(const ea::vector<ea::string>& arguments);
 void ProcessFile(const ea::string& fileName, const ea::string& rootDir);
 void WritePackageFile(const ea::string& fileName, const ea::string& rootDir);
-void WriteHeader(File& dest);
+void BenchmarkPackageFile(PackageFile* packageFile);
+void PrintThroughput(const ea::string& name, unsigned long long numBytes, long long usec);
 
 int main(int argc, char** argv)
 {
     SharedPtr<Context> context(new Context());
     SharedPtr<FileSystem> fileSystem(new FileSystem(context));
+    SharedPtr<Log> log(new Log(context));
+    SharedPtr<Time> time(new Time(context));
+    SharedPtr<WorkQueue> workQueue(new WorkQueue(context));
+    context->RegisterSubsystem(log);
+    context->RegisterSubsystem(time);
+    context->RegisterSubsystem(workQueue);
+    workQueue->CreateThreads(GetNumLogicalCPUs() - 1);
     ea::vector<ea::string> arguments;
     context_ = context;
     fileSystem_ = fileSystem;
@@ -97,6 +103,7 @@ void Run(const ea::vector<ea::string>& arguments)
             "\n"
             "Options:\n"
             "-c      Enable package file LZ4 compression\n"
+            "-d      Enable package file LZ4 compression with dictionary for small JSON and XML files\n"
             "-q      Enable quiet mode\n"
             "\n"
             "Basepath is an optional prefix that will be added to the file entries.\n\n"
@@ -105,6 +112,7 @@ void Run(const ea::vector<ea::string>& arguments)
             "-i      Output package file information\n"
             "-l      Output file names (including their paths) contained in the package\n"
             "-L      Similar to -l but also output compression ratio (compressed package file only)\n"
+            "-b      Benchmark sequential and random access read throughput\n"
         );
 
     const ea::string& dirName = arguments[0];
@@ -125,6 +133,10 @@ void Run(const ea::vector<ea::string>& arguments)
                     case 'c':
                         compress_ = true;
                         break;
+                    case 'd':
+                        compress_ = true;
+                        dictionary_ = true;
+                        break;
                     case 'q':
                         quiet_ = true;
                         break;
@@ -206,6 +218,11 @@ void Run(const ea::vector<ea::string>& arguments)
             PrintLine("Package size: " + ea::to_string(packageFile->GetTotalSize()));
             PrintLine("Checksum: " + ea::to_string(packageFile->GetChecksum()));
             PrintLine("Compressed: " + ea::string(packageFile->IsCompressed() ? "yes" : "no"));
+            if (packageFile->IsCompressed())
+            {
+                PrintLine("Block index: " + ea::string(packageFile->HasBlockIndex() ? "yes" : "no"));
+                PrintLine("Dictionary size: " + ea::to_string(packageFile->GetDictionarySize()));
+            }
             break;
         case 'L':
             if (!packageFile->IsCompressed())
@@ -221,9 +238,12 @@ void Run(const ea::vector<ea::string>& arguments)
                     ea::string fileEntry(current->first);
                     if (outputCompressionRatio)
                     {
-                        unsigned compressedSize =
-                            (i == entries.end() ? packageFile->GetTotalSize() - sizeof(unsigned) : i->second.offset_) -
-                            current->second.offset_;
+                        unsigned compressedSize = current->second.packedSize_;
+                        if (!packageFile->HasBlockIndex())
+                        {
+                            compressedSize = (i == entries.end() ? packageFile->GetTotalSize() - sizeof(unsigned) : i->second.offset_) -
+                                current->second.offset_;
+                        }
                         fileEntry.append_sprintf("\tin: %u\tout: %u\tratio: %f", current->second.size_, compressedSize,
                             compressedSize ? 1.f * current->second.size_ / compressedSize : 0.f);
                     }
@@ -231,6 +251,9 @@ void Run(const ea::vector<ea::string>& arguments)
                 }
             }
             break;
+        case 'b':
+            BenchmarkPackageFile(packageFile);
+            break;
         default:
             ErrorExit("Unrecognized output option");
         }
@@ -244,12 +267,7 @@ void ProcessFile(const ea::string& fileName, const ea::string& rootDir)
     if (!file.Open(fullPath))
         ErrorExit("Could not open file " + fileName);
 
-    FileEntry newEntry;
-    newEntry.name_ = fileName;
-    newEntry.offset_ = 0; // Offset not yet known
-    newEntry.size_ = file.GetSize();
-    newEntry.checksum_ = 0; // Will be calculated later
-    entries_.push_back(newEntry);
+    entries_.push_back(fileName);
 }
 
 void WritePackageFile(const ea::string& fileName, const ea::string& rootDir)
@@ -257,121 +275,113 @@ void WritePackageFile(const ea::string& fileName, const ea::string& rootDir)
     if (!quiet_)
         PrintLine("Writing package");
 
-    File dest(context_);
-    if (!dest.Open(fileName, FILE_WRITE))
+    PackageBuilder builder(context_);
+    if (!builder.Create(fileName, compress_))
         ErrorExit("Could not open output file " + fileName);
+    builder.SetDictionaryEnabled(dictionary_);
 
-    // Write ID, number of files & placeholder for checksum
-    WriteHeader(dest);
-
-    for (unsigned i = 0; i < entries_.size(); ++i)
-    {
-        // Write entry (correct offset is still unknown, will be filled in later)
-        dest.WriteString(basePath_ + entries_[i].name_);
-        dest.WriteUInt(entries_[i].offset_);
-        dest.WriteUInt(entries_[i].size_);
-        dest.WriteUInt(entries_[i].checksum_);
-    }
-
-    unsigned totalDataSize = 0;
-    unsigned lastOffset;
+    for (const ea::string& entryName : entries_)
+        builder.AddFile(basePath_ + entryName, rootDir + "/" + entryName);
 
-    // Write file data, calculate checksums & correct offsets
-    for (unsigned i = 0; i < entries_.size(); ++i)
+    HiresTimer timer;
+    unsigned numPrintedEntries = 0;
+    const auto printEntries = [&]()
     {
-        lastOffset = entries_[i].offset_ = dest.GetSize();
-        ea::string fileFullPath = rootDir + "/" + entries_[i].name_;
-
-        File srcFile(context_, fileFullPath);
-        if (!srcFile.IsOpen())
-            ErrorExit("Could not open file " + fileFullPath);
-
-        unsigned dataSize = entries_[i].size_;
-        totalDataSize += dataSize;
-        ea::unique_ptr<unsigned char[]> buffer(new unsigned char[dataSize]);
-
-        if (srcFile.Read(&buffer[0], dataSize) != dataSize)
-            ErrorExit("Could not read file " + fileFullPath);
-        srcFile.Close();
-
-        for (unsigned j = 0; j < dataSize; ++j)
-        {
-            checksum_ = SDBMHash(checksum_, buffer[j]);
-            entries_[i].checksum_ = SDBMHash(entries_[i].checksum_, buffer[j]);
-        }
-
-        if (!compress_)
+        const ea::vector<PackageBuilderEntry>& entries = builder.GetEntries();
+        for (; numPrintedEntries < entries.size(); ++numPrintedEntries)
         {
-            if (!quiet_)
-                PrintLine(entries_[i].name_ + " size " + ea::to_string(dataSize));
-            dest.Write(&buffer[0], entries_[i].size_);
-        }
-        else
-        {
-            ea::unique_ptr<unsigned char[]> compressBuffer(new unsigned char[LZ4_compressBound(blockSize_)]);
-
-            unsigned pos = 0;
-
-            while (pos < dataSize)
-            {
-                unsigned unpackedSize = blockSize_;
-                if (pos + unpackedSize > dataSize)
-                    unpackedSize = dataSize - pos;
-
-                auto packedSize = (unsigned)LZ4_compress_HC((const char*)&buffer[pos], (char*)compressBuffer.get(), unpackedSize, LZ4_compressBound(unpackedSize), 0);
-                if (!packedSize)
-                    ErrorExit("LZ4 compression failed for file " + entries_[i].name_ + " at offset " + ea::to_string(pos));
-
-                dest.WriteUShort((unsigned short)unpackedSize);
-                dest.WriteUShort((unsigned short)packedSize);
-                dest.Write(compressBuffer.get(), packedSize);
-
-                pos += unpackedSize;
-            }
-
-            if (!quiet_)
+            const PackageBuilderEntry& entry = entries[numPrintedEntries];
+            if (!compress_)
+                PrintLine(entry.name_ + " size " + ea::to_string(entry.size_));
+            else
             {
-                unsigned totalPackedBytes = dest.GetSize() - lastOffset;
-                ea::string fileEntry(entries_[i].name_);
-                fileEntry.append_sprintf("\tin: %u\tout: %u\tratio: %f", dataSize, totalPackedBytes,
-                    totalPackedBytes ? 1.f * dataSize / totalPackedBytes : 0.f);
+                ea::string fileEntry(entry.name_);
+                fileEntry.append_sprintf("\tin: %u\tout: %u\tratio: %f", entry.size_, entry.packedSize_,
+                    entry.packedSize_ ? 1.f * entry.size_ / entry.packedSize_ : 0.f);
                 PrintLine(fileEntry);
             }
         }
+    };
+
+    while (builder.WriteNextBatch())
+    {
+        if (!quiet_)
+            printEntries();
     }
+    if (!builder.Finish())
+        ErrorExit("Could not write package file " + fileName);
+    const long long elapsedUSec = timer.GetUSec(false);
+
+    if (builder.GetEntries().size() != entries_.size())
+        ErrorExit("Could not read some of the files");
 
-    // Write package size to the end of file to allow finding it linked to an executable file
-    unsigned currentSize = dest.GetSize();
-    dest.WriteUInt(currentSize + sizeof(unsigned));
+    if (!quiet_)
+    {
+        PrintLine("Number of files: " + ea::to_string(builder.GetEntries().size()));
+        PrintLine("File data size: " + ea::to_string(builder.GetTotalDataSize()));
+        PrintLine("Package size: " + ea::to_string(File(context_, fileName).GetSize()));
+        PrintLine("Checksum: " + ea::to_string(builder.GetChecksum()));
+        PrintLine("Compressed: " + ea::string(compress_ ? "yes" : "no"));
+        if (dictionary_)
+            PrintLine("Dictionary size: " + ea::to_string(builder.GetDictionarySize()));
+        PrintThroughput("Packing", builder.GetTotalDataSize(), elapsedUSec);
+    }
+}
 
-    // Write header again with correct offsets & checksums
-    dest.Seek(0);
-    WriteHeader(dest);
+void BenchmarkPackageFile(PackageFile* packageFile)
+{
+    const ea::unordered_map<ea::string, PackageEntry>& entries = packageFile->GetEntries();
+    ea::vector<ea::string> entryNames = packageFile->GetEntryNames();
+    ea::quick_sort(entryNames.begin(), entryNames.end());
+
+    ea::vector<unsigned char> buffer;
+    HiresTimer timer;
+    unsigned long long numBytes = 0;
+    for (const ea::string& entryName : entryNames)
+    {
+        File file(context_, packageFile, entryName);
+        buffer.resize(file.GetSize());
+        numBytes += file.Read(buffer.data(), buffer.size());
+    }
+    PrintThroughput("Sequential read", numBytes, timer.GetUSec(false));
 
-    for (unsigned i = 0; i < entries_.size(); ++i)
+    if (packageFile->IsCompressed() && !packageFile->HasBlockIndex())
     {
-        dest.WriteString(basePath_ + entries_[i].name_);
-        dest.WriteUInt(entries_[i].offset_);
-        dest.WriteUInt(entries_[i].size_);
-        dest.WriteUInt(entries_[i].checksum_);
+        PrintLine("Random access read: compressed package has no block index");
+        return;
     }
 
-    if (!quiet_)
+    ea::vector<ea::string> nonEmptyEntryNames;
+    for (const ea::string& entryName : entryNames)
     {
-        PrintLine("Number of files: " + ea::to_string(entries_.size()));
-        PrintLine("File data size: " + ea::to_string(totalDataSize));
-        PrintLine("Package size: " + ea::to_string(dest.GetSize()));
-        PrintLine("Checksum: " + ea::to_string(checksum_));
-        PrintLine("Compressed: " + ea::string(compress_ ? "yes" : "no"));
+        if (entries.find(entryName)->second.size_ > 0)
+            nonEmptyEntryNames.push_back(entryName);
+    }
+    if (nonEmptyEntryNames.empty())
+        return;
+
+    // Seed is fixed so that the same package is always read at the same offsets
+    std::mt19937 random(0);
+    buffer.resize(RANDOM_ACCESS_READ_SIZE);
+    timer.Reset();
+    numBytes = 0;
+    for (unsigned i = 0; i < RANDOM_ACCESS_FILES; ++i)
+    {
+        File file(context_, packageFile, nonEmptyEntryNames[random() % nonEmptyEntryNames.size()]);
+        for (unsigned j = 0; j < RANDOM_ACCESS_READS; ++j)
+        {
+            file.Seek(random() % file.GetSize());
+            numBytes += file.Read(buffer.data(), RANDOM_ACCESS_READ_SIZE);
+        }
     }
+    const long long elapsedUSec = timer.GetUSec(false);
+    PrintThroughput("Random access read", numBytes, elapsedUSec);
+    PrintLine(Format("Random access read: {:.2f} us per read", 1.0 * elapsedUSec / (RANDOM_ACCESS_FILES * RANDOM_ACCESS_READS)));
 }
 
-void WriteHeader(File& dest)
+void PrintThroughput(const ea::string& name, unsigned long long numBytes, long long usec)
 {
-    if (!compress_)
-        dest.WriteFileID("UPAK");
-    else
-        dest.WriteFileID("ULZ4");
-    dest.WriteUInt(entries_.size());
-    dest.WriteUInt(checksum_);
+    const double seconds = ea::max(usec, 1ll) / 1000000.0;
+    PrintLine(Format("{}: {} bytes in {:.2f} ms, {:.1f} MB/s", name, numBytes, seconds * 1000.0,
+        numBytes / seconds / (1024.0 * 1024.0)));
 }
@@ -32,8 +32,12 @@
 #include "../Core/Profiler.h"
 #include "../IO/Log.h"
 
+#include <EASTL/sort.h>
+
 #include <SDL/SDL.h>
 
+#include <thread>
+
 #include "../DebugNew.h"
 
 #ifdef _MSC_VER
@@ -60,6 +64,9 @@ Audio::Audio(Context* context) :
     // Set the master to the default value
     masterGain_[SOUND_MASTER_HASH] = 1.0f;
 
+    // Audio thread mixes too, so leave one logical CPU for the main thread
+    numMixingThreads_ = Clamp(GetNumLogicalCPUs(), 1u, 3u) - 1;
+
     // Register Audio library object factories
     RegisterAudioLibrary(context_);
 
@@ -132,7 +139,8 @@ bool Audio::SetMode(int bufferLengthMSec, int mixRate, bool stereo, bool interpo
     fragmentSize_ = Min(NextPowerOfTwo((unsigned)mixRate >> 6u), (unsigned)obtained.samples);
     mixRate_ = obtained.freq;
     interpolation_ = interpolation;
-    clipBuffer_.reset(new int[stereo ? fragmentSize_ << 1u : fragmentSize_]);
+    mixBuffer_.reset(new float[stereo_ ? fragmentSize_ << 1u : fragmentSize_]);
+    mixer_ = ea::make_unique<AudioMixer>(numMixingThreads_, fragmentSize_);
 
     URHO3D_LOGINFO("Set audio mode " + ea::to_string(mixRate_) + " Hz " + (stereo_ ? "stereo" : "mono") + " " + (interpolation_ ? " interpolated" : ""));
 
@@ -182,24 +190,26 @@ void Audio::SetMasterGain(const ea::string& type, float gain)
 
 void Audio::PauseSoundType(const ea::string& type)
 {
-    MutexLock lock(audioMutex_);
-    pausedSoundTypes_.insert(type);
+    const StringHash typeHash(type);
+    pausedSoundTypes_.insert(typeHash);
+    PushCommand({AudioCommandType::PauseSoundType, nullptr, typeHash});
 }
 
 void Audio::ResumeSoundType(const ea::string& type)
 {
-    MutexLock lock(audioMutex_);
-    pausedSoundTypes_.erase(type);
+    const StringHash typeHash(type);
+    pausedSoundTypes_.erase(typeHash);
     // Update sound sources before resuming playback to make sure 3D positions are up to date
-    // Done under mutex to ensure no mixing happens before we are ready
+    // Done before sending the command to ensure no mixing happens before we are ready
     UpdateInternal(0.0f);
+    PushCommand({AudioCommandType::ResumeSoundType, nullptr, typeHash});
 }
 
 void Audio::ResumeAll()
 {
-    MutexLock lock(audioMutex_);
     pausedSoundTypes_.clear();
     UpdateInternal(0.0f);
+    PushCommand({AudioCommandType::ResumeAll});
 }
 
 void Audio::SetListener(SoundListener* listener)
@@ -216,6 +226,54 @@ void Audio::StopSound(Sound* sound)
     }
 }
 
+void Audio::SetVoiceLimit(const ea::string& type, unsigned limit)
+{
+    if (limit)
+        voiceLimits_[type] = limit;
+    else
+        voiceLimits_.erase(type);
+}
+
+void Audio::SetMixingThreads(unsigned numThreads)
+{
+    if (numThreads == numMixingThreads_)
+        return;
+
+    numMixingThreads_ = numThreads;
+
+    if (deviceID_)
+    {
+        SDL_LockAudioDevice(deviceID_);
+        mixer_ = ea::make_unique<AudioMixer>(numMixingThreads_, fragmentSize_);
+        SDL_UnlockAudioDevice(deviceID_);
+    }
+}
+
+void Audio::SetDecodingThreads(unsigned numThreads)
+{
+    numThreads = Max(numThreads, 1u);
+    if (numThreads == numDecodingThreads_)
+        return;
+
+    numDecodingThreads_ = numThreads;
+
+    // Streams decoded ahead keep reading prefetched data, hand them over to the new decoder
+    if (streamDecoder_)
+    {
+        const ea::vector<SoundStream*> streams = streamDecoder_->GetStreams();
+        streamDecoder_ = ea::make_unique<SoundStreamDecoder>(numDecodingThreads_);
+        for (SoundStream* stream : streams)
+            streamDecoder_->AddStream(stream);
+    }
+}
+
+SoundStreamDecoder* Audio::GetStreamDecoder()
+{
+    if (!streamDecoder_)
+        streamDecoder_ = ea::make_unique<SoundStreamDecoder>(numDecodingThreads_);
+    return streamDecoder_.get();
+}
+
 float Audio::GetMasterGain(const ea::string& type) const
 {
     // By definition previously unknown types return full volume
@@ -226,6 +284,12 @@ float Audio::GetMasterGain(const ea::string& type) const
     return findIt->second.GetFloat();
 }
 
+unsigned Audio::GetVoiceLimit(const ea::string& type) const
+{
+    auto findIt = voiceLimits_.find(type);
+    return findIt != voiceLimits_.end() ? findIt->second : 0;
+}
+
 bool Audio::IsSoundTypePaused(const ea::string& type) const
 {
     return pausedSoundTypes_.contains(type);
@@ -238,8 +302,8 @@ SoundListener* Audio::GetListener() const
 
 void Audio::AddSoundSource(SoundSource* soundSource)
 {
-    MutexLock lock(audioMutex_);
     soundSources_.push_back(soundSource);
+    PushCommand({AudioCommandType::AddSoundSource, soundSource});
 }
 
 void Audio::RemoveSoundSource(SoundSource* soundSource)
@@ -247,8 +311,17 @@ void Audio::RemoveSoundSource(SoundSource* soundSource)
     auto i = soundSources_.find(soundSource);
     if (i != soundSources_.end())
     {
-        MutexLock lock(audioMutex_);
         soundSources_.erase(i);
+        PushCommand({AudioCommandType::RemoveSoundSource, soundSource});
+
+        // The audio thread may be mixing the sound source right now. Wait until it's done,
+        // next mix will process the command before touching the sound sources
+        if (deviceID_)
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            while (mixing_.load(std::memory_order_acquire))
+                std::this_thread::yield();
+        }
     }
 }
 
@@ -270,53 +343,56 @@ float Audio::GetSoundSourceMasterGain(StringHash typeHash) const
 void SDLAudioCallback(void* userdata, Uint8* stream, int len)
 {
     auto* audio = static_cast<Audio*>(userdata);
-    {
-        MutexLock Lock(audio->GetMutex());
-        audio->MixOutput(stream, len / audio->GetSampleSize());
-    }
+    audio->MixOutput(stream, len / audio->GetSampleSize());
 }
 
 void Audio::MixOutput(void* dest, unsigned samples)
 {
-    if (!playing_ || !clipBuffer_)
+    // Pairs with the fence in RemoveSoundSource: either the command is seen here, or the remover waits for the mix
+    mixing_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    ProcessCommands();
+
+    if (!playing_ || !mixer_)
     {
         memset(dest, 0, samples * (size_t)sampleSize_);
+        mixing_.store(false, std::memory_order_release);
         return;
     }
 
+    activeMixSources_.clear();
+    virtualMixSources_.clear();
+    for (SoundSource* source : mixSources_)
+    {
+        // Check for pause if necessary
+        if (!mixPausedSoundTypes_.empty() && mixPausedSoundTypes_.contains(source->GetSoundTypeHash()))
+            continue;
+
+        if (source->IsVirtual())
+            virtualMixSources_.push_back(source);
+        else
+            activeMixSources_.push_back(source);
+    }
+
     while (samples)
     {
-        // If sample count exceeds the fragment (clip buffer) size, split the work
+        // If sample count exceeds the fragment (mix buffer) size, split the work
         unsigned workSamples = Min(samples, fragmentSize_);
-        unsigned clipSamples = workSamples;
+        unsigned mixSamples = workSamples;
         if (stereo_)
-            clipSamples <<= 1;
-
-        // Clear clip buffer
-        int* clipPtr = clipBuffer_.get();
-        memset(clipPtr, 0, clipSamples * sizeof(int));
+            mixSamples <<= 1;
 
-        // Mix samples to clip buffer
-        for (auto i = soundSources_.begin(); i != soundSources_.end(); ++i)
-        {
-            SoundSource* source = *i;
-
-            // Check for pause if necessary
-            if (!pausedSoundTypes_.empty())
-            {
-                if (pausedSoundTypes_.contains(source->GetSoundType()))
-                    continue;
-            }
+        mixer_->Mix(mixBuffer_.get(), activeMixSources_, workSamples, mixRate_, stereo_, interpolation_);
+        for (SoundSource* source : virtualMixSources_)
+            source->MixVirtual(workSamples, mixRate_);
+        ConvertFloatToS16(static_cast<short*>(dest), mixBuffer_.get(), mixSamples);
 
-            source->Mix(clipPtr, workSamples, mixRate_, stereo_, interpolation_);
-        }
-        // Copy output from clip buffer to destination
-        auto* destPtr = (short*)dest;
-        while (clipSamples--)
-            *destPtr++ = (short)Clamp(*clipPtr++, -32768, 32767);
         samples -= workSamples;
         ((unsigned char*&)dest) += sampleSize_ * workSamples;
     }
+
+    mixing_.store(false, std::memory_order_release);
 }
 
 void Audio::HandleRenderUpdate(StringHash eventType, VariantMap& eventData)
@@ -334,8 +410,12 @@ void Audio::Release()
     {
         SDL_CloseAudioDevice(deviceID_);
         deviceID_ = 0;
-        clipBuffer_.reset();
+        mixer_.reset();
+        mixBuffer_.reset();
     }
+
+    // Audio thread is not running, keep its state up to date
+    ProcessCommands();
 }
 
 void Audio::UpdateInternal(float timeStep)
@@ -350,12 +430,139 @@ void Audio::UpdateInternal(float timeStep)
         // Check for pause if necessary; do not update paused sound sources
         if (!pausedSoundTypes_.empty())
         {
-            if (pausedSoundTypes_.contains(source->GetSoundType()))
+            if (pausedSoundTypes_.contains(source->GetSoundTypeHash()))
                 continue;
         }
 
         source->Update(timeStep);
     }
+
+    UpdateVoices();
+}
+
+void Audio::UpdateVoices()
+{
+    URHO3D_PROFILE("UpdateVoices");
+
+    voiceStats_ = {};
+    voiceCandidates_.clear();
+
+    for (SoundSource* source : soundSources_)
+    {
+        if (!source->IsPlaying())
+            continue;
+
+        if (!pausedSoundTypes_.empty() && pausedSoundTypes_.contains(source->GetSoundTypeHash()))
+            continue;
+
+        ++voiceStats_.numPlaying_;
+
+        // Inaudible voices don't take voice slots
+        if (source->GetAudibility() < virtualizationGain_ && source->CanBeVirtual())
+        {
+            source->SetVirtual(true);
+            ++voiceStats_.numVirtual_;
+        }
+        else
+            voiceCandidates_.push_back(source);
+    }
+
+    if (voiceLimits_.empty())
+    {
+        for (SoundSource* source : voiceCandidates_)
+            source->SetVirtual(false);
+        voiceStats_.numReal_ = voiceCandidates_.size();
+        return;
+    }
+
+    // Higher priority first, then louder first
+    ea::sort(voiceCandidates_.begin(), voiceCandidates_.end(), [](const SoundSource* lhs, const SoundSource* rhs)
+    {
+        if (lhs->GetPriority() != rhs->GetPriority())
+            return lhs->GetPriority() > rhs->GetPriority();
+        return lhs->GetAudibility() > rhs->GetAudibility();
+    });
+
+    auto masterLimitIt = voiceLimits_.find(SOUND_MASTER_HASH);
+    const unsigned masterLimit = masterLimitIt != voiceLimits_.end() ? masterLimitIt->second : 0;
+
+    numRealVoices_.clear();
+    for (SoundSource* source : voiceCandidates_)
+    {
+        const StringHash typeHash = source->GetSoundTypeHash();
+        auto typeLimitIt = voiceLimits_.find(typeHash);
+        const unsigned typeLimit = typeLimitIt != voiceLimits_.end() ? typeLimitIt->second : 0;
+        unsigned& numTypeVoices = numRealVoices_[typeHash];
+
+        const bool overLimit = (masterLimit && voiceStats_.numReal_ >= masterLimit) || (typeLimit && numTypeVoices >= typeLimit);
+        if (overLimit && source->CanBeVirtual())
+        {
+            source->SetVirtual(true);
+            ++voiceStats_.numVirtual_;
+            ++voiceStats_.numLimited_;
+        }
+        else
+        {
+            source->SetVirtual(false);
+            ++voiceStats_.numReal_;
+            ++numTypeVoices;
+        }
+    }
+}
+
+void Audio::PushCommand(const AudioCommand& command)
+{
+    if (!deviceID_)
+    {
+        ProcessCommand(command);
+        return;
+    }
+
+    // If the queue is full, the audio thread is stalled. Lock it and process the commands here
+    if (!commands_.Push(command))
+    {
+        SDL_LockAudioDevice(deviceID_);
+        ProcessCommands();
+        ProcessCommand(command);
+        SDL_UnlockAudioDevice(deviceID_);
+    }
+}
+
+void Audio::ProcessCommands()
+{
+    AudioCommand command;
+    while (commands_.Pop(command))
+        ProcessCommand(command);
+}
+
+void Audio::ProcessCommand(const AudioCommand& command)
+{
+    switch (command.type_)
+    {
+    case AudioCommandType::AddSoundSource:
+        mixSources_.push_back(command.source_);
+        break;
+
+    case AudioCommandType::RemoveSoundSource:
+    {
+        auto i = mixSources_.find(command.source_);
+        if (i != mixSources_.end())
+            mixSources_.erase(i);
+        break;
+    }
+
+    case AudioCommandType::PauseSoundType:
+        mixPausedSoundTypes_.insert(command.soundType_);
+        break;
+
+    case AudioCommandType::ResumeSoundType:
+        mixPausedSoundTypes_.erase(command.soundType_);
+        break;
+
+    case AudioCommandType::ResumeAll:
+        mixPausedSoundTypes_.clear();
+        break;
+    }
 }
 
 void RegisterAudioLibrary(Context* context)
@@ -26,9 +26,12 @@
 #include <EASTL/hash_set.h>
 
 #include "../Audio/AudioDefs.h"
-#include "../Core/Mutex.h"
+#include "../Audio/AudioMixer.h"
+#include "../Audio/SoundStreamDecoder.h"
 #include "../Core/Object.h"
 
+#include <atomic>
+
 namespace Urho3D
 {
 
@@ -37,6 +40,19 @@ class Sound;
 class SoundListener;
 class SoundSource;
 
+/// Voice statistics, updated every frame.
+struct AudioVoiceStats
+{
+    /// Number of playing sound sources, excluding paused sound types.
+    unsigned numPlaying_{};
+    /// Number of voices that are mixed.
+    unsigned numReal_{};
+    /// Number of voices that advance playback position without mixing.
+    unsigned numVirtual_{};
+    /// Number of audible voices virtualized because of voice limits.
+    unsigned numLimited_{};
+};
+
 /// %Audio subsystem.
 class URHO3D_API Audio : public Object
 {
@@ -70,6 +86,18 @@ public:
     void SetListener(SoundListener* listener);
     /// Stop any sound source playing a certain sound clip.
     void StopSound(Sound* sound);
+    /// Set max number of real voices of specific sound type. Voices over the limit are virtualized in priority and audibility order.
+    /// Limit of the master sound type applies to all voices. Zero means no limit.
+    void SetVoiceLimit(const ea::string& type, unsigned limit);
+    /// Set gain below which voices are virtualized.
+    /// @property
+    void SetVirtualizationGain(float gain) { virtualizationGain_ = Max(gain, 0.0f); }
+    /// Set number of additional threads used for mixing. Takes effect immediately if audio output is initialized.
+    /// @property
+    void SetMixingThreads(unsigned numThreads);
+    /// Set number of background threads decoding compressed sound streams ahead of playback. At least one thread is used.
+    /// @property
+    void SetDecodingThreads(unsigned numThreads);
 
     /// Return byte size of one sample.
     /// @property
@@ -95,10 +123,32 @@ public:
     /// @property
     bool IsInitialized() const { return deviceID_ != 0; }
 
+    /// Return number of additional threads used for mixing.
+    /// @property
+    unsigned GetMixingThreads() const { return numMixingThreads_; }
+
+    /// Return number of background threads decoding compressed sound streams.
+    /// @property
+    unsigned GetDecodingThreads() const { return numDecodingThreads_; }
+
+    /// Return background decoder of sound streams. Created on first use.
+    /// @nobind
+    SoundStreamDecoder* GetStreamDecoder();
+
     /// Return master gain for a specific sound source type. Unknown sound types will return full gain (1).
     /// @property
     float GetMasterGain(const ea::string& type) const;
 
+    /// Return max number of real voices of specific sound type. Zero means no limit.
+    unsigned GetVoiceLimit(const ea::string& type) const;
+
+    /// Return gain below which voices are virtualized.
+    /// @property
+    float GetVirtualizationGain() const { return virtualizationGain_; }
+
+    /// Return voice statistics.
+    const AudioVoiceStats& GetVoiceStats() const { return voiceStats_; }
+
     /// Return whether specific sound type has been paused.
     bool IsSoundTypePaused(const ea::string& type) const;
 
@@ -117,9 +167,6 @@ public:
     /// Remove a sound source. Called by SoundSource.
     void RemoveSoundSource(SoundSource* soundSource);
 
-    /// Return audio thread mutex.
-    Mutex& GetMutex() { return audioMutex_; }
-
     /// Return sound type specific gain multiplied by master gain.
     float GetSoundSourceMasterGain(StringHash typeHash) const;
 
@@ -133,16 +180,42 @@ private:
     void Release();
     /// Actually update sound sources with the specific timestep. Called internally.
     void UpdateInternal(float timeStep);
-
-    /// Clipping buffer for mixing.
-    ea::unique_ptr<int[]> clipBuffer_;
-    /// Audio thread mutex.
-    Mutex audioMutex_;
+    /// Decide which voices are real and which are virtual. Called internally.
+    void UpdateVoices();
+    /// Send command to the audio thread, or execute it immediately if there's no audio thread.
+    void PushCommand(const AudioCommand& command);
+    /// Execute pending commands. Called from the audio thread, or when the audio thread is locked or not running.
+    void ProcessCommands();
+    /// Execute command.
+    void ProcessCommand(const AudioCommand& command);
+
+    /// Sound source mixer.
+    ea::unique_ptr<AudioMixer> mixer_;
+    /// Floating point buffer for mixing.
+    ea::unique_ptr<float[]> mixBuffer_;
+    /// Commands sent to the audio thread.
+    AudioCommandQueue commands_;
+    /// Sound sources known to the audio thread.
+    ea::vector<SoundSource*> mixSources_;
+    /// Real sound sources that are not paused. Rebuilt on every mix.
+    ea::vector<SoundSource*> activeMixSources_;
+    /// Virtual sound sources that are not paused. Rebuilt on every mix.
+    ea::vector<SoundSource*> virtualMixSources_;
+    /// Paused sound types known to the audio thread.
+    ea::hash_set<StringHash> mixPausedSoundTypes_;
+    /// Whether the audio thread is mixing now.
+    std::atomic<bool> mixing_{};
+    /// Number of additional threads used for mixing.
+    unsigned numMixingThreads_{};
+    /// Background decoder of sound streams.
+    ea::unique_ptr<SoundStreamDecoder> streamDecoder_;
+    /// Number of background threads decoding sound streams.
+    unsigned numDecodingThreads_{1};
     /// SDL audio device ID.
     unsigned deviceID_{};
     /// Sample size.
     unsigned sampleSize_{};
-    /// Clip buffer size in samples.
+    /// Mix buffer size in samples.
     unsigned fragmentSize_{};
     /// Mixing rate.
     int mixRate_{};
@@ -160,6 +233,16 @@ private:
     ea::vector<SoundSource*> soundSources_;
     /// Sound listener.
     WeakPtr<SoundListener> listener_;
+    /// Max number of real voices by sound type.
+    ea::unordered_map<StringHash, unsigned> voiceLimits_;
+    /// Gain below which voices are virtualized.
+    float virtualizationGain_{1.0f / 512.0f};
+    /// Audible voices sorted by priority. Rebuilt every frame.
+    ea::vector<SoundSource*> voiceCandidates_;
+    /// Number of real voices by sound type. Rebuilt every frame.
+    ea::unordered_map<StringHash, unsigned> numRealVoices_;
+    /// Voice statistics.
+    AudioVoiceStats voiceStats_;
 };
 
 /// Register Audio library objects.
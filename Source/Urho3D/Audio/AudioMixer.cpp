@@ -0,0 +1,261 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Audio/AudioMixer.h"
+#include "../Audio/SoundSource.h"
+#include "../Math/MathDefs.h"
+
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
+#include <thread>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Sources are mixed on the calling thread only if there are fewer sources than this.
+static const unsigned MIN_SOURCES_FOR_THREADING = 16;
+/// Number of sources taken by the thread at once.
+static const unsigned SOURCES_PER_BATCH = 4;
+
+void MixFloatSamples(float* dest, const float* src, unsigned numFrames, unsigned numChannels,
+    const float gainBegin[], const float gainEnd[])
+{
+    if (!numFrames)
+        return;
+
+    const bool stereo = numChannels == 2;
+    const float invNumFrames = 1.0f / numFrames;
+    const float leftDelta = (gainEnd[0] - gainBegin[0]) * invNumFrames;
+    const float rightDelta = stereo ? (gainEnd[1] - gainBegin[1]) * invNumFrames : leftDelta;
+    const unsigned count = numFrames * numChannels;
+    unsigned i = 0;
+
+#ifdef URHO3D_SSE
+    // Each group of 4 values covers 4 mono frames or 2 stereo frames
+    __m128 gain;
+    __m128 gainStep;
+    if (stereo)
+    {
+        gain = _mm_setr_ps(gainBegin[0], gainBegin[1], gainBegin[0] + leftDelta, gainBegin[1] + rightDelta);
+        gainStep = _mm_setr_ps(2.0f * leftDelta, 2.0f * rightDelta, 2.0f * leftDelta, 2.0f * rightDelta);
+    }
+    else
+    {
+        gain = _mm_setr_ps(gainBegin[0], gainBegin[0] + leftDelta, gainBegin[0] + 2.0f * leftDelta, gainBegin[0] + 3.0f * leftDelta);
+        gainStep = _mm_set1_ps(4.0f * leftDelta);
+    }
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 value = _mm_mul_ps(_mm_loadu_ps(src + i), gain);
+        _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), value));
+        gain = _mm_add_ps(gain, gainStep);
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        const unsigned frame = i / numChannels;
+        const bool right = stereo && (i & 1u);
+        const float gain = right ? gainBegin[1] + rightDelta * frame : gainBegin[0] + leftDelta * frame;
+        dest[i] += src[i] * gain;
+    }
+}
+
+void AccumulateFloatSamples(float* dest, const float* src, unsigned count)
+{
+    unsigned i = 0;
+
+#ifdef URHO3D_SSE
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), _mm_loadu_ps(src + i)));
+#endif
+
+    for (; i < count; ++i)
+        dest[i] += src[i];
+}
+
+void ConvertFloatToS16(short* dest, const float* src, unsigned count)
+{
+    unsigned i = 0;
+
+#ifdef URHO3D_SSE
+    // Clamp before conversion, packing with signed saturation doesn't handle out of range integers
+    const __m128 minValue = _mm_set1_ps(-32768.0f);
+    const __m128 maxValue = _mm_set1_ps(32767.0f);
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128 low = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), minValue), maxValue);
+        const __m128 high = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), minValue), maxValue);
+        const __m128i packed = _mm_packs_epi32(_mm_cvttps_epi32(low), _mm_cvttps_epi32(high));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), packed);
+    }
+#endif
+
+    for (; i < count; ++i)
+        dest[i] = static_cast<short>(Clamp(src[i], -32768.0f, 32767.0f));
+}
+
+/// Mixer thread.
+class AudioMixer::MixerThread : public Thread
+{
+public:
+    /// Construct.
+    MixerThread(AudioMixer* mixer, unsigned index)
+        : Thread("AudioMixer")
+        , mixer_(mixer)
+        , index_(index)
+    {
+    }
+
+    /// Process jobs until shut down.
+    void ThreadFunction() override
+    {
+        unsigned lastJobIndex = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mixer_->mutex_);
+                mixer_->wakeCondition_.wait(lock, [&] { return mixer_->shutdown_ || mixer_->jobIndex_ != lastJobIndex; });
+                if (mixer_->shutdown_)
+                    return;
+                lastJobIndex = mixer_->jobIndex_;
+            }
+
+            mixer_->ProcessJob(index_);
+        }
+    }
+
+private:
+    /// Mixer.
+    AudioMixer* mixer_{};
+    /// Index of the thread, starting from 1.
+    unsigned index_{};
+};
+
+AudioMixer::AudioMixer(unsigned numThreads, unsigned maxSamples)
+    : maxSamples_(maxSamples)
+{
+    // Buffers are allocated for stereo output
+    submixes_.resize(numThreads + 1);
+    for (Submix& submix : submixes_)
+    {
+        submix.buffer_.reset(new float[maxSamples_ * 2]);
+        submix.scratch_.reset(new float[maxSamples_ * 2]);
+    }
+
+    for (unsigned i = 0; i < numThreads; ++i)
+    {
+        auto thread = ea::make_unique<MixerThread>(this, i + 1);
+        if (!thread->Run())
+            break;
+        thread->SetPriority(2);
+        threads_.push_back(ea::move(thread));
+    }
+}
+
+AudioMixer::~AudioMixer()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        shutdown_ = true;
+    }
+    wakeCondition_.notify_all();
+
+    for (auto& thread : threads_)
+        thread->Stop();
+}
+
+void AudioMixer::Mix(float* dest, const ea::vector<SoundSource*>& sources, unsigned samples, int mixRate, bool stereo,
+    bool interpolation)
+{
+    assert(samples <= maxSamples_);
+
+    const unsigned count = stereo ? samples * 2 : samples;
+    memset(dest, 0, count * sizeof(float));
+
+    sources_ = &sources;
+    samples_ = samples;
+    mixRate_ = mixRate;
+    stereo_ = stereo;
+    interpolation_ = interpolation;
+    nextSource_.store(0, std::memory_order_relaxed);
+
+    // Don't wake threads for few sources
+    if (threads_.empty() || sources.size() < MIN_SOURCES_FOR_THREADING)
+    {
+        MixSources(dest, submixes_[0]);
+        return;
+    }
+
+    numPendingThreads_.store(threads_.size(), std::memory_order_relaxed);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ++jobIndex_;
+    }
+    wakeCondition_.notify_all();
+
+    // Calling thread mixes too, straight into the output
+    MixSources(dest, submixes_[0]);
+
+    // Mixing threads finish shortly after the calling thread runs out of sources
+    while (numPendingThreads_.load(std::memory_order_acquire) != 0)
+        std::this_thread::yield();
+
+    for (unsigned i = 1; i < submixes_.size(); ++i)
+        AccumulateFloatSamples(dest, submixes_[i].buffer_.get(), count);
+}
+
+void AudioMixer::MixSources(float* dest, Submix& submix)
+{
+    const ea::vector<SoundSource*>& sources = *sources_;
+    const unsigned numSources = sources.size();
+    while (true)
+    {
+        const unsigned beginIndex = nextSource_.fetch_add(SOURCES_PER_BATCH, std::memory_order_relaxed);
+        if (beginIndex >= numSources)
+            break;
+
+        const unsigned endIndex = Min(beginIndex + SOURCES_PER_BATCH, numSources);
+        for (unsigned i = beginIndex; i < endIndex; ++i)
+            sources[i]->Mix(dest, submix.scratch_.get(), samples_, mixRate_, stereo_, interpolation_);
+    }
+}
+
+void AudioMixer::ProcessJob(unsigned threadIndex)
+{
+    Submix& submix = submixes_[threadIndex];
+    const unsigned count = stereo_ ? samples_ * 2 : samples_;
+    memset(submix.buffer_.get(), 0, count * sizeof(float));
+
+    MixSources(submix.buffer_.get(), submix);
+
+    numPendingThreads_.fetch_sub(1, std::memory_order_release);
+}
+
+}
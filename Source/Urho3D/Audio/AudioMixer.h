@@ -0,0 +1,181 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Core/NonCopyable.h"
+#include "../Core/Thread.h"
+#include "../Math/StringHash.h"
+
+#include <EASTL/unique_ptr.h>
+#include <EASTL/vector.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace Urho3D
+{
+
+class SoundSource;
+
+/// Add floating point samples to the buffer with linear gain ramp from gainBegin to gainEnd.
+/// Samples are interleaved, numChannels is 1 or 2. Gain arrays hold value for each channel.
+URHO3D_API void MixFloatSamples(float* dest, const float* src, unsigned numFrames, unsigned numChannels,
+    const float gainBegin[], const float gainEnd[]);
+/// Add floating point samples to the buffer.
+URHO3D_API void AccumulateFloatSamples(float* dest, const float* src, unsigned count);
+/// Convert floating point samples to 16-bit samples with clamping.
+URHO3D_API void ConvertFloatToS16(short* dest, const float* src, unsigned count);
+
+/// Type of command sent from the main thread to the audio thread.
+enum class AudioCommandType
+{
+    AddSoundSource,
+    RemoveSoundSource,
+    PauseSoundType,
+    ResumeSoundType,
+    ResumeAll
+};
+
+/// Command sent from the main thread to the audio thread.
+/// @nobind
+struct AudioCommand
+{
+    /// Command type.
+    AudioCommandType type_{};
+    /// Sound source for add and remove commands. Used only as identifier by remove command.
+    SoundSource* source_{};
+    /// Sound type for pause and resume commands.
+    StringHash soundType_;
+};
+
+/// Lock-free bounded queue of audio commands. Single producer, single consumer.
+/// @nobind
+class URHO3D_API AudioCommandQueue : private NonCopyable
+{
+public:
+    /// Max number of queued commands.
+    static const unsigned Capacity = 1024;
+
+    /// Push command. Return false if the queue is full. Called by producer.
+    bool Push(const AudioCommand& command)
+    {
+        const unsigned head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= Capacity)
+            return false;
+
+        commands_[head & (Capacity - 1)] = command;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Pop command. Return false if the queue is empty. Called by consumer.
+    bool Pop(AudioCommand& command)
+    {
+        const unsigned tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire))
+            return false;
+
+        command = commands_[tail & (Capacity - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    /// Commands.
+    AudioCommand commands_[Capacity];
+    /// Index of the next pushed command.
+    std::atomic<unsigned> head_{};
+    /// Index of the next popped command.
+    std::atomic<unsigned> tail_{};
+};
+
+/// Mixes sound sources into floating point buffer. Sound sources are split between the calling thread and mixer threads,
+/// each thread mixes into its own submix buffer.
+/// @nobind
+class URHO3D_API AudioMixer : private NonCopyable
+{
+public:
+    /// Construct with the number of additional mixer threads and max number of samples mixed at once.
+    AudioMixer(unsigned numThreads, unsigned maxSamples);
+    /// Destruct. Stop mixer threads.
+    ~AudioMixer();
+
+    /// Mix sound sources into the buffer. Buffer is overwritten.
+    void Mix(float* dest, const ea::vector<SoundSource*>& sources, unsigned samples, int mixRate, bool stereo, bool interpolation);
+
+    /// Return number of additional mixer threads.
+    unsigned GetNumThreads() const { return threads_.size(); }
+
+private:
+    class MixerThread;
+
+    /// Submix buffers of the thread.
+    struct Submix
+    {
+        /// Output buffer.
+        ea::unique_ptr<float[]> buffer_;
+        /// Scratch buffer for resampled source data.
+        ea::unique_ptr<float[]> scratch_;
+    };
+
+    /// Mix sources of current job into the buffer.
+    void MixSources(float* dest, Submix& submix);
+    /// Process current job in mixer thread.
+    void ProcessJob(unsigned threadIndex);
+
+    /// Max number of samples mixed at once.
+    unsigned maxSamples_{};
+    /// Submix buffers. First one is used by the calling thread.
+    ea::vector<Submix> submixes_;
+    /// Mixer threads.
+    ea::vector<ea::unique_ptr<MixerThread>> threads_;
+
+    /// Mutex for waking mixer threads.
+    std::mutex mutex_;
+    /// Condition for waking mixer threads.
+    std::condition_variable wakeCondition_;
+    /// Incremented for each job.
+    unsigned jobIndex_{};
+    /// Whether the mixer threads should exit.
+    bool shutdown_{};
+
+    /// Sources of current job.
+    const ea::vector<SoundSource*>* sources_{};
+    /// Number of samples of current job.
+    unsigned samples_{};
+    /// Mixing rate of current job.
+    int mixRate_{};
+    /// Whether current job is stereo.
+    bool stereo_{};
+    /// Whether current job uses interpolation.
+    bool interpolation_{};
+    /// Index of the next source to mix.
+    std::atomic<unsigned> nextSource_{};
+    /// Number of mixer threads that haven't finished current job yet.
+    std::atomic<unsigned> numPendingThreads_{};
+};
+
+}
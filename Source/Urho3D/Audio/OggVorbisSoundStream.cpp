@@ -24,6 +24,7 @@
 
 #include "../Audio/OggVorbisSoundStream.h"
 #include "../Audio/Sound.h"
+#include "../Math/MathDefs.h"
 
 #include <STB/stb_vorbis.h>
 
@@ -32,6 +33,11 @@
 namespace Urho3D
 {
 
+/// Prefetch buffer length in milliseconds.
+static const unsigned PREFETCH_BUFFER_LENGTH = 500;
+/// Max number of bytes decoded into the prefetch buffer at once.
+static const unsigned PREFETCH_CHUNK_SIZE = 16384;
+
 OggVorbisSoundStream::OggVorbisSoundStream(const Sound* sound)
 {
     assert(sound && sound->IsCompressed());
@@ -64,6 +70,14 @@ bool OggVorbisSoundStream::Seek(unsigned sample_number)
     if (!decoder_)
         return false;
 
+    // Decoder thread owns the decoder when prefetching
+    if (prefetchBuffer_)
+    {
+        seekSample_.store(sample_number, std::memory_order_relaxed);
+        numSeeksRequested_.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+
     auto* vorbis = static_cast<stb_vorbis*>(decoder_);
 
     return stb_vorbis_seek(vorbis, sample_number) == 1;
@@ -74,6 +88,107 @@ unsigned OggVorbisSoundStream::GetData(signed char* dest, unsigned numBytes)
     if (!decoder_)
         return 0;
 
+    if (prefetchBuffer_)
+        return ReadPrefetchedData(dest, numBytes);
+
+    return DecodeData(dest, numBytes);
+}
+
+bool OggVorbisSoundStream::StartPrefetch()
+{
+    if (!decoder_)
+        return false;
+
+    if (!prefetchBuffer_)
+    {
+        const unsigned bufferSize = GetSampleSize() * frequency_ * PREFETCH_BUFFER_LENGTH / 1000;
+        prefetchBufferSize_ = NextPowerOfTwo(bufferSize);
+        prefetchBuffer_.reset(new signed char[prefetchBufferSize_]);
+    }
+
+    return true;
+}
+
+bool OggVorbisSoundStream::Prefetch()
+{
+    if (!decoder_ || !prefetchBuffer_)
+        return false;
+
+    auto* vorbis = static_cast<stb_vorbis*>(decoder_);
+
+    // Perform requested seek. Data decoded so far is discarded by the mixing thread
+    const unsigned numSeeksRequested = numSeeksRequested_.load(std::memory_order_acquire);
+    if (numSeeksRequested != numSeeksDone_.load(std::memory_order_relaxed))
+    {
+        stb_vorbis_seek(vorbis, seekSample_.load(std::memory_order_relaxed));
+        endReached_.store(false, std::memory_order_relaxed);
+        seekWritePosition_.store(writePosition_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        numSeeksDone_.store(numSeeksRequested, std::memory_order_release);
+        return true;
+    }
+
+    if (endReached_.load(std::memory_order_relaxed))
+        return false;
+
+    // Decode into contiguous free space of the ring buffer, whole samples only
+    const unsigned writePosition = writePosition_.load(std::memory_order_relaxed);
+    const unsigned usedSize = writePosition - readPosition_.load(std::memory_order_acquire);
+    const unsigned offset = writePosition & (prefetchBufferSize_ - 1);
+    const unsigned sampleSize = GetSampleSize();
+    unsigned numBytes = Min(Min(prefetchBufferSize_ - usedSize, prefetchBufferSize_ - offset), PREFETCH_CHUNK_SIZE);
+    numBytes -= numBytes % sampleSize;
+    if (!numBytes)
+        return false;
+
+    const unsigned outBytes = DecodeData(prefetchBuffer_.get() + offset, numBytes);
+    writePosition_.store(writePosition + outBytes, std::memory_order_release);
+    if (outBytes < numBytes)
+        endReached_.store(true, std::memory_order_release);
+
+    return outBytes != 0;
+}
+
+unsigned OggVorbisSoundStream::ReadPrefetchedData(signed char* dest, unsigned numBytes)
+{
+    // Produce silence until the decoder thread performs requested seek
+    const unsigned numSeeksDone = numSeeksDone_.load(std::memory_order_acquire);
+    if (numSeeksRequested_.load(std::memory_order_acquire) != numSeeksDone)
+    {
+        memset(dest, 0, numBytes);
+        return numBytes;
+    }
+
+    if (numSeeksObserved_ != numSeeksDone)
+    {
+        readPosition_.store(seekWritePosition_.load(std::memory_order_relaxed), std::memory_order_release);
+        numSeeksObserved_ = numSeeksDone;
+    }
+
+    // Check for end before checking available data, all data is written before the end is flagged
+    const bool endReached = endReached_.load(std::memory_order_acquire);
+    const unsigned readPosition = readPosition_.load(std::memory_order_relaxed);
+    const unsigned availableSize = writePosition_.load(std::memory_order_acquire) - readPosition;
+    const unsigned outBytes = Min(availableSize, numBytes);
+
+    const unsigned offset = readPosition & (prefetchBufferSize_ - 1);
+    const unsigned firstPartSize = Min(outBytes, prefetchBufferSize_ - offset);
+    memcpy(dest, prefetchBuffer_.get() + offset, firstPartSize);
+    memcpy(dest + firstPartSize, prefetchBuffer_.get(), outBytes - firstPartSize);
+    readPosition_.store(readPosition + outBytes, std::memory_order_release);
+
+    if (outBytes < numBytes && !endReached)
+    {
+        // Decoder thread is late. Fill the gap with silence rather than stopping playback
+        numUnderruns_.fetch_add(1, std::memory_order_relaxed);
+        memset(dest + outBytes, 0, numBytes - outBytes);
+        return numBytes;
+    }
+
+    return outBytes;
+}
+
+unsigned OggVorbisSoundStream::DecodeData(signed char* dest, unsigned numBytes)
+{
     auto* vorbis = static_cast<stb_vorbis*>(decoder_);
 
     unsigned channels = stereo_ ? 2 : 1;
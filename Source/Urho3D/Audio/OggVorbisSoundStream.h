@@ -23,9 +23,12 @@
 #pragma once
 
 #include <EASTL/shared_array.h>
+#include <EASTL/unique_ptr.h>
 
 #include "../Audio/SoundStream.h"
 
+#include <atomic>
+
 namespace Urho3D
 {
 
@@ -40,19 +43,56 @@ public:
     /// Destruct.
     ~OggVorbisSoundStream() override;
 
-    /// Seek to sample number. Return true on success.
+    /// Seek to sample number. Return true on success. When prefetching, seek is performed by the decoder thread
+    /// and silence is produced until it's done.
     bool Seek(unsigned sample_number) override;
 
     /// Produce sound data into destination. Return number of bytes produced. Called by SoundSource from the mixing thread.
     unsigned GetData(signed char* dest, unsigned numBytes) override;
 
+    /// Start decoding ahead into a prefetch buffer.
+    bool StartPrefetch() override;
+    /// Decode ahead into the prefetch buffer. Called by SoundStreamDecoder from a decoder thread.
+    bool Prefetch() override;
+
+    /// Return number of times the prefetch buffer ran out of data before the end of the stream.
+    unsigned GetNumUnderruns() const { return numUnderruns_.load(std::memory_order_relaxed); }
+
 protected:
+    /// Decode data, rewinding at end if looped. Return number of bytes produced.
+    unsigned DecodeData(signed char* dest, unsigned numBytes);
+    /// Read data from the prefetch buffer. Return number of bytes produced.
+    unsigned ReadPrefetchedData(signed char* dest, unsigned numBytes);
+
     /// Decoder state.
     void* decoder_;
     /// Compressed sound data.
     ea::shared_array<signed char> data_;
     /// Compressed sound data size in bytes.
     unsigned dataSize_;
+
+    /// Ring buffer of decoded data. Empty if not prefetching.
+    ea::unique_ptr<signed char[]> prefetchBuffer_;
+    /// Prefetch buffer size in bytes. Power of two.
+    unsigned prefetchBufferSize_{};
+    /// Total number of bytes written to the prefetch buffer. Written by the decoder thread.
+    std::atomic<unsigned> writePosition_{};
+    /// Total number of bytes read from the prefetch buffer. Written by the mixing thread.
+    std::atomic<unsigned> readPosition_{};
+    /// Whether the decoder has reached the end of the stream. Written by the decoder thread.
+    std::atomic<bool> endReached_{};
+    /// Sample number of the last requested seek.
+    std::atomic<unsigned> seekSample_{};
+    /// Number of requested seeks.
+    std::atomic<unsigned> numSeeksRequested_{};
+    /// Number of seeks performed by the decoder thread.
+    std::atomic<unsigned> numSeeksDone_{};
+    /// Write position of the prefetch buffer at the last performed seek. Data before it is discarded.
+    std::atomic<unsigned> seekWritePosition_{};
+    /// Number of seeks observed by the mixing thread.
+    unsigned numSeeksObserved_{};
+    /// Number of prefetch buffer underruns.
+    std::atomic<unsigned> numUnderruns_{};
 };
 
 }
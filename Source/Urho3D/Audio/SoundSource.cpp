@@ -24,6 +24,7 @@
 
 #include "../Audio/Audio.h"
 #include "../Audio/AudioEvents.h"
+#include "../Audio/AudioMixer.h"
 #include "../Audio/Sound.h"
 #include "../Audio/SoundSource.h"
 #include "../Audio/SoundStream.h"
@@ -38,62 +39,118 @@
 namespace Urho3D
 {
 
-#define INC_POS_LOOPED() \
-    pos += intAdd; \
-    fractPos += fractAdd; \
-    if (fractPos > 65535) \
-    { \
-        fractPos &= 65535; \
-        ++pos; \
-    } \
-    while (pos >= end) \
-        pos -= (end - repeat); \
-
-#define INC_POS_ONESHOT() \
-    pos += intAdd; \
-    fractPos += fractAdd; \
-    if (fractPos > 65535) \
-    { \
-        fractPos &= 65535; \
-        ++pos; \
-    } \
-    if (pos >= end) \
-    { \
-        pos = 0; \
-        break; \
-    } \
-
-#define INC_POS_STEREO_LOOPED() \
-    pos += ((unsigned)intAdd << 1u); \
-    fractPos += fractAdd; \
-    if (fractPos > 65535) \
-    { \
-        fractPos &= 65535; \
-        pos += 2; \
-    } \
-    while (pos >= end) \
-        pos -= (end - repeat); \
-
-#define INC_POS_STEREO_ONESHOT() \
-    pos += ((unsigned)intAdd << 1u); \
-    fractPos += fractAdd; \
-    if (fractPos > 65535) \
-    { \
-        fractPos &= 65535; \
-        pos += 2; \
-    } \
-    if (pos >= end) \
-    { \
-        pos = 0; \
-        break; \
-    } \
-
-#define GET_IP_SAMPLE() (((((int)pos[1] - (int)pos[0]) * fractPos) / 65536) + (int)pos[0])
-
-#define GET_IP_SAMPLE_LEFT() (((((int)pos[2] - (int)pos[0]) * fractPos) / 65536) + (int)pos[0])
-
-#define GET_IP_SAMPLE_RIGHT() (((((int)pos[3] - (int)pos[1]) * fractPos) / 65536) + (int)pos[1])
+/// Resample sound data into floating point buffer. Sample values are multiplied by scale.
+/// Return new playback position, or null if one-shot sound has ended. Remaining output is zero-filled in that case.
+template <class T, bool SourceStereo, bool OutputStereo, bool Interpolate, bool Looped>
+T* ResampleSound(T* pos, int& fractPos, T* end, T* repeat, int intAdd, int fractAdd, float scale, float dest[], unsigned samples)
+{
+    static constexpr int step = SourceStereo ? 2 : 1;
+    static constexpr float fractScale = 1.0f / 65536.0f;
+
+    while (samples--)
+    {
+        float left;
+        float right;
+        if constexpr (Interpolate)
+        {
+            const float t = static_cast<float>(fractPos) * fractScale;
+            left = static_cast<float>(pos[0]) + static_cast<float>(pos[step] - pos[0]) * t;
+            if constexpr (SourceStereo)
+                right = static_cast<float>(pos[1]) + static_cast<float>(pos[step + 1] - pos[1]) * t;
+            else
+                right = left;
+        }
+        else
+        {
+            left = static_cast<float>(pos[0]);
+            right = SourceStereo ? static_cast<float>(pos[1]) : left;
+        }
+
+        if constexpr (OutputStereo)
+        {
+            *dest++ = left * scale;
+            *dest++ = right * scale;
+        }
+        else
+            *dest++ = (SourceStereo ? (left + right) * 0.5f : left) * scale;
+
+        pos += intAdd * step;
+        fractPos += fractAdd;
+        if (fractPos > 65535)
+        {
+            fractPos &= 65535;
+            pos += step;
+        }
+
+        if (pos >= end)
+        {
+            if constexpr (Looped)
+            {
+                while (pos >= end)
+                    pos -= (end - repeat);
+            }
+            else
+            {
+                memset(dest, 0, samples * (OutputStereo ? 2 : 1) * sizeof(float));
+                return nullptr;
+            }
+        }
+    }
+
+    return pos;
+}
+
+/// Select resampling routine for interpolation and looping.
+template <class T, bool SourceStereo, bool OutputStereo>
+T* ResampleSound(bool interpolate, bool looped, T* pos, int& fractPos, T* end, T* repeat, int intAdd, int fractAdd, float scale,
+    float dest[], unsigned samples)
+{
+    if (interpolate)
+    {
+        if (looped)
+            return ResampleSound<T, SourceStereo, OutputStereo, true, true>(pos, fractPos, end, repeat, intAdd, fractAdd, scale, dest, samples);
+        else
+            return ResampleSound<T, SourceStereo, OutputStereo, true, false>(pos, fractPos, end, repeat, intAdd, fractAdd, scale, dest, samples);
+    }
+    else
+    {
+        if (looped)
+            return ResampleSound<T, SourceStereo, OutputStereo, false, true>(pos, fractPos, end, repeat, intAdd, fractAdd, scale, dest, samples);
+        else
+            return ResampleSound<T, SourceStereo, OutputStereo, false, false>(pos, fractPos, end, repeat, intAdd, fractAdd, scale, dest, samples);
+    }
+}
+
+/// Select resampling routine for sample type and channel layout.
+template <class T>
+signed char* ResampleSound(Sound* sound, signed char* position, int& fractPos, int intAdd, int fractAdd, float scale,
+    float dest[], unsigned samples, bool stereo, bool interpolate)
+{
+    auto* pos = reinterpret_cast<T*>(position);
+    auto* end = reinterpret_cast<T*>(sound->GetEnd());
+    auto* repeat = reinterpret_cast<T*>(sound->GetRepeat());
+    const bool looped = sound->IsLooped();
+
+    T* newPos;
+    if (sound->IsStereo())
+    {
+        if (stereo)
+            newPos = ResampleSound<T, true, true>(interpolate, looped, pos, fractPos, end, repeat, intAdd, fractAdd, scale, dest, samples);
+        else
+            newPos = ResampleSound<T, true, false>(interpolate, looped, pos, fractPos, end, repeat, intAdd, fractAdd, scale, dest, samples);
+    }
+    else
+    {
+        if (stereo)
+            newPos = ResampleSound<T, false, true>(interpolate, looped, pos, fractPos, end, repeat, intAdd, fractAdd, scale, dest, samples);
+        else
+            newPos = ResampleSound<T, false, false>(interpolate, looped, pos, fractPos, end, repeat, intAdd, fractAdd, scale, dest, samples);
+    }
+    return reinterpret_cast<signed char*>(newPos);
+}
 
+/// Sound sources with lower gain are not mixed.
+static const float MIN_AUDIBLE_GAIN = 1.0f / 512.0f;
 static const int STREAM_SAFETY_SAMPLES = 4;
 
 extern const char* AUDIO_CATEGORY;
@@ -103,6 +160,7 @@ extern const char* autoRemoveModeNames[];
 SoundSource::SoundSource(Context* context) :
     Component(context),
     soundType_(SOUND_EFFECT),
+    soundTypeHash_(SOUND_EFFECT),
     frequency_(0.0f),
     gain_(1.0f),
     attenuation_(1.0f),
@@ -126,6 +184,9 @@ SoundSource::~SoundSource()
 {
     if (audio_)
         audio_->RemoveSoundSource(this);
+
+    ReleaseStream();
+    FlushReleasedStreams();
 }
 
 void SoundSource::RegisterObject(Context* context)
@@ -142,6 +203,7 @@ void SoundSource::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Is Playing", IsPlaying, SetPlayingAttr, bool, false, AM_DEFAULT);
     URHO3D_ENUM_ATTRIBUTE("Autoremove Mode", autoRemove_, autoRemoveModeNames, REMOVE_DISABLED, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Play Position", GetPositionAttr, SetPositionAttr, int, 0, AM_FILE);
+    URHO3D_ATTRIBUTE("Priority", int, priority_, 0, AM_DEFAULT);
 }
 
 void SoundSource::Seek(float seekTime)
@@ -177,14 +239,20 @@ void SoundSource::Play(Sound* sound)
     if (frequency_ == 0.0f && sound)
         SetFrequency(sound->GetFrequency());
 
-    // If sound source is currently playing, have to lock the audio mutex
-    if (position_)
+    // Compressed sound is played through a new decoder stream, start decoding it before it becomes visible to mixing
+    SharedPtr<SoundStream> decoderStream;
+    if (sound && sound->IsCompressed())
     {
-        MutexLock lock(audio_->GetMutex());
-        PlayLockless(sound);
+        decoderStream = sound->GetDecoderStream();
+        StartStreamDecoding(decoderStream);
     }
-    else
-        PlayLockless(sound);
+
+    // Sound source may be mixed concurrently, have to lock the mix mutex
+    {
+        MutexLock lock(mixMutex_);
+        PlayLockless(sound, decoderStream);
+    }
+    FlushReleasedStreams();
 
     // Forget the Sound & Is Playing attribute previous values so that they will be sent again, triggering
     // the sound correctly on network clients even after the initial playback
@@ -234,20 +302,16 @@ void SoundSource::Play(SoundStream* stream)
         SetFrequency(stream->GetFrequency());
 
     SharedPtr<SoundStream> streamPtr(stream);
+    StartStreamDecoding(stream);
 
-    // If sound source is currently playing, have to lock the audio mutex. When stream playback is explicitly
+    // Sound source may be mixed concurrently, have to lock the mix mutex. When stream playback is explicitly
     // requested, clear the existing sound if any
-    if (position_)
-    {
-        MutexLock lock(audio_->GetMutex());
-        sound_.Reset();
-        PlayLockless(streamPtr);
-    }
-    else
     {
+        MutexLock lock(mixMutex_);
         sound_.Reset();
         PlayLockless(streamPtr);
     }
+    FlushReleasedStreams();
 
     // Stream playback is not supported for network replication, no need to mark network dirty
 }
@@ -257,14 +321,12 @@ void SoundSource::Stop()
     if (!audio_)
         return;
 
-    // If sound source is currently playing, have to lock the audio mutex
-    if (position_)
+    // Sound source may be mixed concurrently, have to lock the mix mutex
     {
-        MutexLock lock(audio_->GetMutex());
+        MutexLock lock(mixMutex_);
         StopLockless();
     }
-    else
-        StopLockless();
+    FlushReleasedStreams();
 
     MarkNetworkUpdate();
 }
@@ -305,6 +367,12 @@ void SoundSource::SetPanning(float panning)
     MarkNetworkUpdate();
 }
 
+void SoundSource::SetPriority(int priority)
+{
+    priority_ = priority;
+    MarkNetworkUpdate();
+}
+
 void SoundSource::SetAutoRemoveMode(AutoRemoveMode mode)
 {
     autoRemove_ = mode;
@@ -316,13 +384,18 @@ bool SoundSource::IsPlaying() const
     return (sound_ || soundStream_) && position_ != nullptr;
 }
 
+bool SoundSource::CanBeVirtual() const
+{
+    return !soundStream_ || (sound_ && sound_->IsCompressed());
+}
+
 void SoundSource::SetPlayPosition(signed char* pos)
 {
     // Setting play position on a stream is not supported
     if (!audio_ || !sound_ || soundStream_)
         return;
 
-    MutexLock lock(audio_->GetMutex());
+    MutexLock lock(mixMutex_);
     SetPlayPositionLockless(pos);
 }
 
@@ -337,7 +410,13 @@ void SoundSource::Update(float timeStep)
 
     // Free the stream if playback has stopped
     if (soundStream_ && !position_)
-        StopLockless();
+    {
+        {
+            MutexLock lock(mixMutex_);
+            StopLockless();
+        }
+        FlushReleasedStreams();
+    }
 
     bool playing = IsPlaying();
 
@@ -363,13 +442,28 @@ void SoundSource::Update(float timeStep)
     }
 }
 
-void SoundSource::Mix(int dest[], unsigned samples, int mixRate, bool stereo, bool interpolation)
+void SoundSource::Mix(float dest[], float scratch[], unsigned samples, int mixRate, bool stereo, bool interpolation)
 {
+    MutexLock lock(mixMutex_);
+
     if (!position_ || (!sound_ && !soundStream_) || (!IsEnabledEffective() && node_ != nullptr))
         return;
 
     int streamFilledSize, outBytes;
 
+    // Continue the stream from where virtual playback has got to
+    if (streamSeekPending_)
+    {
+        streamSeekPending_ = false;
+        if (soundStream_ && sound_)
+        {
+            const float length = sound_->GetLength();
+            const float timePosition = sound_->IsLooped() && length > 0.0f ? fmodf(timePosition_, length) : timePosition_;
+            soundStream_->Seek((unsigned)(timePosition * soundStream_->GetFrequency()));
+            unusedStreamSize_ = 0;
+        }
+    }
+
     if (soundStream_ && streamBuffer_)
     {
         int streamBufferSize = streamBuffer_->GetDataSize();
@@ -401,42 +495,53 @@ void SoundSource::Mix(int dest[], unsigned samples, int mixRate, bool stereo, bo
     if (!sound)
         return;
 
-    // Choose the correct mixing routine
-    if (!sound->IsStereo())
+    // Mono sound is panned when mixed to stereo output
+    const float totalGain = masterGain_ * attenuation_ * gain_;
+    float gain[2];
+    if (stereo && !sound->IsStereo())
     {
-        if (interpolation)
-        {
-            if (stereo)
-                MixMonoToStereoIP(sound, dest, samples, mixRate);
-            else
-                MixMonoToMonoIP(sound, dest, samples, mixRate);
-        }
-        else
-        {
-            if (stereo)
-                MixMonoToStereo(sound, dest, samples, mixRate);
-            else
-                MixMonoToMono(sound, dest, samples, mixRate);
-        }
+        gain[0] = (1.0f - panning_) * totalGain;
+        gain[1] = (1.0f + panning_) * totalGain;
     }
+    else
+        gain[0] = gain[1] = totalGain;
+
+    // Ramp gain over the mixed samples to avoid clicks
+    if (resetGain_)
+    {
+        lastGain_[0] = gain[0];
+        lastGain_[1] = gain[1];
+        resetGain_ = false;
+    }
+
+    if (Max(Max(gain[0], gain[1]), Max(lastGain_[0], lastGain_[1])) < MIN_AUDIBLE_GAIN)
+        MixZeroVolume(sound, samples, mixRate);
     else
     {
-        if (interpolation)
+        const float add = frequency_ / (float)mixRate;
+        const auto intAdd = (int)add;
+        const auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
+        int fractPos = fractPosition_;
+
+        // 8-bit samples are scaled to 16-bit range
+        if (sound->IsSixteenBit())
         {
-            if (stereo)
-                MixStereoToStereoIP(sound, dest, samples, mixRate);
-            else
-                MixStereoToMonoIP(sound, dest, samples, mixRate);
+            position_ = ResampleSound<short>(sound, (signed char*)position_, fractPos, intAdd, fractAdd, 1.0f, scratch,
+                samples, stereo, interpolation);
         }
         else
         {
-            if (stereo)
-                MixStereoToStereo(sound, dest, samples, mixRate);
-            else
-                MixStereoToMono(sound, dest, samples, mixRate);
+            position_ = ResampleSound<signed char>(sound, (signed char*)position_, fractPos, intAdd, fractAdd, 256.0f,
+                scratch, samples, stereo, interpolation);
         }
+        fractPosition_ = fractPos;
+
+        MixFloatSamples(dest, scratch, samples, stereo ? 2 : 1, lastGain_, gain);
     }
 
+    lastGain_[0] = gain[0];
+    lastGain_[1] = gain[1];
+
     // Update the time position. In stream mode, copy unused data back to the beginning of the stream buffer
     if (soundStream_)
     {
@@ -457,6 +562,39 @@ void SoundSource::Mix(int dest[], unsigned samples, int mixRate, bool stereo, bo
         timePosition_ = ((float)(int)(size_t)(position_ - sound_->GetStart())) / (sound_->GetSampleSize() * sound_->GetFrequency());
 }
 
+void SoundSource::MixVirtual(unsigned samples, int mixRate)
+{
+    MutexLock lock(mixMutex_);
+
+    if (!position_ || (!sound_ && !soundStream_) || (!IsEnabledEffective() && node_ != nullptr))
+        return;
+
+    // Fade in when the voice becomes real again
+    lastGain_[0] = lastGain_[1] = 0.0f;
+    resetGain_ = false;
+
+    if (soundStream_)
+    {
+        // Only compressed sound streams can be virtual. Skip decoding, seek on resume
+        if (!sound_)
+            return;
+
+        timePosition_ += ((float)samples / (float)mixRate) * frequency_ / soundStream_->GetFrequency();
+        if (!sound_->IsLooped() && timePosition_ >= sound_->GetLength())
+        {
+            position_ = nullptr;
+            return;
+        }
+        streamSeekPending_ = true;
+    }
+    else
+    {
+        MixZeroVolume(sound_, samples, mixRate);
+        if (position_)
+            timePosition_ = ((float)(int)(size_t)(position_ - sound_->GetStart())) / (sound_->GetSampleSize() * sound_->GetFrequency());
+    }
+}
+
 void SoundSource::UpdateMasterGain()
 {
     if (audio_)
@@ -472,8 +610,11 @@ void SoundSource::SetSoundAttr(const ResourceRef& value)
     else
     {
         // When changing the sound and not playing, free previous sound stream and stream buffer (if any)
-        soundStream_.Reset();
-        streamBuffer_.Reset();
+        {
+            MutexLock lock(mixMutex_);
+            ReleaseStream();
+        }
+        FlushReleasedStreams();
         sound_ = newSound;
     }
 }
@@ -508,7 +649,7 @@ int SoundSource::GetPositionAttr() const
         return 0;
 }
 
-void SoundSource::PlayLockless(Sound* sound)
+void SoundSource::PlayLockless(Sound* sound, const SharedPtr<SoundStream>& decoderStream)
 {
     // Reset the time position in any case
     timePosition_ = 0.0f;
@@ -522,11 +663,11 @@ void SoundSource::PlayLockless(Sound* sound)
             if (start)
             {
                 // Free existing stream & stream buffer if any
-                soundStream_.Reset();
-                streamBuffer_.Reset();
+                ReleaseStream();
                 sound_ = sound;
                 position_ = start;
                 fractPosition_ = 0;
+                resetGain_ = true;
                 sendFinishedEvent_ = true;
                 return;
             }
@@ -534,7 +675,7 @@ void SoundSource::PlayLockless(Sound* sound)
         else
         {
             // Compressed sound start
-            PlayLockless(sound->GetDecoderStream());
+            PlayLockless(decoderStream);
             sound_ = sound;
             return;
         }
@@ -552,6 +693,10 @@ void SoundSource::PlayLockless(const SharedPtr<SoundStream>& stream)
 
     if (stream)
     {
+        // The stream is already registered in the decoder by the caller
+        if (stream != soundStream_)
+            ReleaseStream();
+
         // Setup the stream buffer
         unsigned sampleSize = stream->GetSampleSize();
         unsigned streamBufferSize = sampleSize * stream->GetIntFrequency() * STREAM_BUFFER_LENGTH / 1000;
@@ -563,8 +708,10 @@ void SoundSource::PlayLockless(const SharedPtr<SoundStream>& stream)
 
         soundStream_ = stream;
         unusedStreamSize_ = 0;
+        streamSeekPending_ = false;
         position_ = streamBuffer_->GetStart();
         fractPosition_ = 0;
+        resetGain_ = true;
         sendFinishedEvent_ = true;
         return;
     }
@@ -577,12 +724,40 @@ void SoundSource::StopLockless()
 {
     position_ = nullptr;
     timePosition_ = 0.0f;
+    streamSeekPending_ = false;
+    SetVirtual(false);
 
     // Free the sound stream and decode buffer if a stream was playing
+    ReleaseStream();
+}
+
+void SoundSource::StartStreamDecoding(SoundStream* stream)
+{
+    // Decode ahead on background thread if possible
+    if (stream && audio_)
+        audio_->GetStreamDecoder()->AddStream(stream);
+}
+
+void SoundSource::ReleaseStream()
+{
+    // Decoder threads may still be using the stream, keep it alive until it is removed from the decoder
+    if (soundStream_ && audio_)
+        releasedStreams_.push_back(soundStream_);
+
     soundStream_.Reset();
     streamBuffer_.Reset();
 }
 
+void SoundSource::FlushReleasedStreams()
+{
+    if (audio_)
+    {
+        for (SoundStream* stream : releasedStreams_)
+            audio_->GetStreamDecoder()->RemoveStream(stream);
+    }
+    releasedStreams_.clear();
+}
+
 void SoundSource::SetPlayPositionLockless(signed char* pos)
 {
     // Setting position on a stream is not supported
@@ -602,635 +777,6 @@ void SoundSource::SetPlayPositionLockless(signed char* pos)
     timePosition_ = ((float)(int)(size_t)(pos - sound_->GetStart())) / (sound_->GetSampleSize() * sound_->GetFrequency());
 }
 
-void SoundSource::MixMonoToMono(Sound* sound, int dest[], unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto vol = RoundToInt(256.0f * totalGain);
-    if (!vol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + (*pos * vol) / 256;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + (*pos * vol) / 256;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + *pos * vol;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + *pos * vol;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-    fractPosition_ = fractPos;
-}
-
-void SoundSource::MixMonoToStereo(Sound* sound, int dest[], unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto leftVol = (int)((-panning_ + 1.0f) * (256.0f * totalGain + 0.5f));
-    auto rightVol = (int)((panning_ + 1.0f) * (256.0f * totalGain + 0.5f));
-    if (!leftVol && !rightVol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + (*pos * leftVol) / 256;
-                ++dest;
-                *dest = *dest + (*pos * rightVol) / 256;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + (*pos * leftVol) / 256;
-                ++dest;
-                *dest = *dest + (*pos * rightVol) / 256;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + *pos * leftVol;
-                ++dest;
-                *dest = *dest + *pos * rightVol;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + *pos * leftVol;
-                ++dest;
-                *dest = *dest + *pos * rightVol;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-
-    fractPosition_ = fractPos;
-}
-
-void SoundSource::MixMonoToMonoIP(Sound* sound, int dest[], unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto vol = RoundToInt(256.0f * totalGain);
-    if (!vol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + (GET_IP_SAMPLE() * vol) / 256;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + (GET_IP_SAMPLE() * vol) / 256;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + GET_IP_SAMPLE() * vol;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + GET_IP_SAMPLE() * vol;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-
-    fractPosition_ = fractPos;
-}
-
-void SoundSource::MixMonoToStereoIP(Sound* sound, int dest[], unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto leftVol = (int)((-panning_ + 1.0f) * (256.0f * totalGain + 0.5f));
-    auto rightVol = (int)((panning_ + 1.0f) * (256.0f * totalGain + 0.5f));
-    if (!leftVol && !rightVol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                int s = GET_IP_SAMPLE();
-                *dest = *dest + (s * leftVol) / 256;
-                ++dest;
-                *dest = *dest + (s * rightVol) / 256;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                int s = GET_IP_SAMPLE();
-                *dest = *dest + (s * leftVol) / 256;
-                ++dest;
-                *dest = *dest + (s * rightVol) / 256;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                int s = GET_IP_SAMPLE();
-                *dest = *dest + s * leftVol;
-                ++dest;
-                *dest = *dest + s * rightVol;
-                ++dest;
-                INC_POS_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                int s = GET_IP_SAMPLE();
-                *dest = *dest + s * leftVol;
-                ++dest;
-                *dest = *dest + s * rightVol;
-                ++dest;
-                INC_POS_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-
-    fractPosition_ = fractPos;
-}
-
-void SoundSource::MixStereoToMono(Sound* sound, int dest[], unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto vol = RoundToInt(256.0f * totalGain);
-    if (!vol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                int s = ((int)pos[0] + (int)pos[1]) / 2;
-                *dest = *dest + (s * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                int s = ((int)pos[0] + (int)pos[1]) / 2;
-                *dest = *dest + (s * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                int s = ((int)pos[0] + (int)pos[1]) / 2;
-                *dest = *dest + s * vol;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                int s = ((int)pos[0] + (int)pos[1]) / 2;
-                *dest = *dest + s * vol;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-
-    fractPosition_ = fractPos;
-}
-
-void SoundSource::MixStereoToStereo(Sound* sound, int dest[], unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto vol = RoundToInt(256.0f * totalGain);
-    if (!vol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + (pos[0] * vol) / 256;
-                ++dest;
-                *dest = *dest + (pos[1] * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + (pos[0] * vol) / 256;
-                ++dest;
-                *dest = *dest + (pos[1] * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + pos[0] * vol;
-                ++dest;
-                *dest = *dest + pos[1] * vol;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + pos[0] * vol;
-                ++dest;
-                *dest = *dest + pos[1] * vol;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-
-    fractPosition_ = fractPos;
-}
-
-void SoundSource::MixStereoToMonoIP(Sound* sound, int dest[], unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto vol = RoundToInt(256.0f * totalGain);
-    if (!vol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                int s = (GET_IP_SAMPLE_LEFT() + GET_IP_SAMPLE_RIGHT()) / 2;
-                *dest = *dest + (s * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                int s = (GET_IP_SAMPLE_LEFT() + GET_IP_SAMPLE_RIGHT()) / 2;
-                *dest = *dest + (s * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                int s = (GET_IP_SAMPLE_LEFT() + GET_IP_SAMPLE_RIGHT()) / 2;
-                *dest = *dest + s * vol;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                int s = (GET_IP_SAMPLE_LEFT() + GET_IP_SAMPLE_RIGHT()) / 2;
-                *dest = *dest + s * vol;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-
-    fractPosition_ = fractPos;
-}
-
-void SoundSource::MixStereoToStereoIP(Sound* sound, int dest[], unsigned samples, int mixRate)
-{
-    float totalGain = masterGain_ * attenuation_ * gain_;
-    auto vol = RoundToInt(256.0f * totalGain);
-    if (!vol)
-    {
-        MixZeroVolume(sound, samples, mixRate);
-        return;
-    }
-
-    float add = frequency_ / (float)mixRate;
-    auto intAdd = (int)add;
-    auto fractAdd = (int)((add - floorf(add)) * 65536.0f);
-    int fractPos = fractPosition_;
-
-    if (sound->IsSixteenBit())
-    {
-        auto* pos = (short*)position_;
-        auto* end = (short*)sound->GetEnd();
-        auto* repeat = (short*)sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + (GET_IP_SAMPLE_LEFT() * vol) / 256;
-                ++dest;
-                *dest = *dest + (GET_IP_SAMPLE_RIGHT() * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = (signed char*)pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + (GET_IP_SAMPLE_LEFT() * vol) / 256;
-                ++dest;
-                *dest = *dest + (GET_IP_SAMPLE_RIGHT() * vol) / 256;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = (signed char*)pos;
-        }
-    }
-    else
-    {
-        auto* pos = (signed char*)position_;
-        signed char* end = sound->GetEnd();
-        signed char* repeat = sound->GetRepeat();
-
-        if (sound->IsLooped())
-        {
-            while (samples--)
-            {
-                *dest = *dest + GET_IP_SAMPLE_LEFT() * vol;
-                ++dest;
-                *dest = *dest + GET_IP_SAMPLE_RIGHT() * vol;
-                ++dest;
-                INC_POS_STEREO_LOOPED();
-            }
-            position_ = pos;
-        }
-        else
-        {
-            while (samples--)
-            {
-                *dest = *dest + GET_IP_SAMPLE_LEFT() * vol;
-                ++dest;
-                *dest = *dest + GET_IP_SAMPLE_RIGHT() * vol;
-                ++dest;
-                INC_POS_STEREO_ONESHOT();
-            }
-            position_ = pos;
-        }
-    }
-
-    fractPosition_ = fractPos;
-}
-
 void SoundSource::MixZeroVolume(Sound* sound, unsigned samples, int mixRate)
 {
     float add = frequency_ * (float)samples / (float)mixRate;
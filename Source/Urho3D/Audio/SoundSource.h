@@ -23,8 +23,11 @@
 #pragma once
 
 #include "../Audio/AudioDefs.h"
+#include "../Core/Mutex.h"
 #include "../Scene/Component.h"
 
+#include <atomic>
+
 namespace Urho3D
 {
 
@@ -82,6 +85,9 @@ public:
     void SetAutoRemoveMode(AutoRemoveMode mode);
     /// Set new playback position.
     void SetPlayPosition(signed char* pos);
+    /// Set voice priority. When the voice limit of the sound type is exceeded, voices with lower priority are virtualized first.
+    /// @property
+    void SetPriority(int priority);
 
     /// Return sound.
     /// @property
@@ -94,6 +100,9 @@ public:
     /// @property
     ea::string GetSoundType() const { return soundType_; }
 
+    /// Return sound type hash.
+    StringHash GetSoundTypeHash() const { return soundTypeHash_; }
+
     /// Return playback time position.
     /// @property
     float GetTimePosition() const { return timePosition_; }
@@ -118,16 +127,34 @@ public:
     /// @property
     AutoRemoveMode GetAutoRemoveMode() const { return autoRemove_; }
 
+    /// Return voice priority.
+    /// @property
+    int GetPriority() const { return priority_; }
+
+    /// Return whether the voice is virtual, i.e. playback position advances without mixing.
+    /// @property
+    bool IsVirtual() const { return virtual_.load(std::memory_order_relaxed); }
+
+    /// Return whether the voice can be virtualized. Streams can be virtualized only if they can seek.
+    bool CanBeVirtual() const;
+
+    /// Return effective gain used to decide whether the voice is audible.
+    float GetAudibility() const { return masterGain_ * attenuation_ * gain_; }
+
     /// Return whether is playing.
     /// @property
     bool IsPlaying() const;
 
     /// Update the sound source. Perform subclass specific operations. Called by Audio.
     virtual void Update(float timeStep);
-    /// Mix sound source output to a 32-bit clipping buffer. Called by Audio.
-    void Mix(int dest[], unsigned samples, int mixRate, bool stereo, bool interpolation);
+    /// Mix sound source output to a floating point buffer. Scratch buffer should fit stereo samples. Called by AudioMixer, possibly from several threads for different sound sources.
+    void Mix(float dest[], float scratch[], unsigned samples, int mixRate, bool stereo, bool interpolation);
+    /// Advance playback position without mixing. Called by Audio for virtual voices.
+    void MixVirtual(unsigned samples, int mixRate);
     /// Update the effective master gain. Called internally and by Audio when the master gain changes.
     void UpdateMasterGain();
+    /// Set whether the voice is virtual. Called by Audio.
+    void SetVirtual(bool enable) { virtual_.store(enable, std::memory_order_relaxed); }
 
     /// Set sound attribute.
     void SetSoundAttr(const ResourceRef& value);
@@ -163,30 +190,20 @@ protected:
     AutoRemoveMode autoRemove_;
 
 private:
-    /// Play a sound without locking the audio mutex. Called internally.
-    void PlayLockless(Sound* sound);
-    /// Play a sound stream without locking the audio mutex. Called internally.
+    /// Play a sound without locking the mix mutex. Compressed sounds are played through the decoder stream. Called internally.
+    void PlayLockless(Sound* sound, const SharedPtr<SoundStream>& decoderStream);
+    /// Play a sound stream without locking the mix mutex. Called internally.
     void PlayLockless(const SharedPtr<SoundStream>& stream);
-    /// Stop sound without locking the audio mutex. Called internally.
+    /// Stop sound without locking the mix mutex. Called internally.
     void StopLockless();
-    /// Set new playback position without locking the audio mutex. Called internally.
+    /// Set new playback position without locking the mix mutex. Called internally.
     void SetPlayPositionLockless(signed char* pos);
-    /// Mix mono sample to mono buffer.
-    void MixMonoToMono(Sound* sound, int dest[], unsigned samples, int mixRate);
-    /// Mix mono sample to stereo buffer.
-    void MixMonoToStereo(Sound* sound, int dest[], unsigned samples, int mixRate);
-    /// Mix mono sample to mono buffer interpolated.
-    void MixMonoToMonoIP(Sound* sound, int dest[], unsigned samples, int mixRate);
-    /// Mix mono sample to stereo buffer interpolated.
-    void MixMonoToStereoIP(Sound* sound, int dest[], unsigned samples, int mixRate);
-    /// Mix stereo sample to mono buffer.
-    void MixStereoToMono(Sound* sound, int dest[], unsigned samples, int mixRate);
-    /// Mix stereo sample to stereo buffer.
-    void MixStereoToStereo(Sound* sound, int dest[], unsigned samples, int mixRate);
-    /// Mix stereo sample to mono buffer interpolated.
-    void MixStereoToMonoIP(Sound* sound, int dest[], unsigned samples, int mixRate);
-    /// Mix stereo sample to stereo buffer interpolated.
-    void MixStereoToStereoIP(Sound* sound, int dest[], unsigned samples, int mixRate);
+    /// Start decoding the sound stream ahead. Should be called before the stream is played, without the mix mutex locked.
+    void StartStreamDecoding(SoundStream* stream);
+    /// Detach the sound stream and free the decode buffer. Called with the mix mutex locked.
+    void ReleaseStream();
+    /// Stop decoding detached sound streams ahead. Waits for decoder threads, so must be called without the mix mutex locked.
+    void FlushReleasedStreams();
     /// Advance playback pointer without producing audible output.
     void MixZeroVolume(Sound* sound, unsigned samples, int mixRate);
     /// Advance playback pointer to simulate audio playback in headless mode.
@@ -196,6 +213,8 @@ private:
     SharedPtr<Sound> sound_;
     /// Sound stream that is being played.
     SharedPtr<SoundStream> soundStream_;
+    /// Sound streams detached from playback that are still registered in the stream decoder.
+    ea::vector<SharedPtr<SoundStream>> releasedStreams_;
     /// Playback position.
     volatile signed char* position_;
     /// Playback fractional position.
@@ -206,6 +225,18 @@ private:
     SharedPtr<Sound> streamBuffer_;
     /// Unused stream bytes from previous frame.
     int unusedStreamSize_;
+    /// Gain of each output channel at the end of previous mix.
+    float lastGain_[2]{};
+    /// Whether the gain ramp should be skipped on next mix.
+    bool resetGain_{true};
+    /// Voice priority.
+    int priority_{};
+    /// Whether the voice is virtual.
+    std::atomic<bool> virtual_{};
+    /// Whether the stream should seek to the time position before next mix. Set when virtual stream playback advances.
+    bool streamSeekPending_{};
+    /// Mix mutex. Locked while mixing or changing playback state.
+    SpinLockMutex mixMutex_;
 };
 
 }
@@ -42,6 +42,16 @@ bool SoundStream::Seek(unsigned int sample_number)
     return false;
 }
 
+bool SoundStream::StartPrefetch()
+{
+    return false;
+}
+
+bool SoundStream::Prefetch()
+{
+    return false;
+}
+
 void SoundStream::SetFormat(unsigned frequency, bool sixteenBit, bool stereo)
 {
     frequency_ = frequency;
@@ -42,6 +42,12 @@ public:
     /// Produce sound data into destination. Return number of bytes produced. Called by SoundSource from the mixing thread.
     virtual unsigned GetData(signed char* dest, unsigned numBytes) = 0;
 
+    /// Start decoding ahead into a prefetch buffer. Return true on success. Need not be implemented by all streams.
+    /// After this call, GetData reads prefetched data and Seek may complete asynchronously.
+    virtual bool StartPrefetch();
+    /// Decode ahead into the prefetch buffer. Return true if any work was done. Called by SoundStreamDecoder from a decoder thread.
+    virtual bool Prefetch();
+
     /// Set sound data format.
     void SetFormat(unsigned frequency, bool sixteenBit, bool stereo);
     /// Set whether playback should stop when no more data. Default false.
@@ -0,0 +1,190 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Audio/SoundStream.h"
+#include "../Audio/SoundStreamDecoder.h"
+
+#include <chrono>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Time to sleep when all streams are decoded ahead.
+static const std::chrono::milliseconds IDLE_WAIT_TIME{5};
+
+/// Decoder thread.
+class SoundStreamDecoder::DecoderThread : public Thread
+{
+public:
+    /// Construct.
+    explicit DecoderThread(SoundStreamDecoder* decoder)
+        : Thread("SoundStreamDecoder")
+        , decoder_(decoder)
+    {
+    }
+
+    /// Decode streams until shut down.
+    void ThreadFunction() override { decoder_->ProcessStreams(); }
+
+private:
+    /// Decoder.
+    SoundStreamDecoder* decoder_{};
+};
+
+SoundStreamDecoder::SoundStreamDecoder(unsigned numThreads)
+{
+    for (unsigned i = 0; i < numThreads; ++i)
+    {
+        auto thread = ea::make_unique<DecoderThread>(this);
+        if (!thread->Run())
+            break;
+        threads_.push_back(ea::move(thread));
+    }
+}
+
+SoundStreamDecoder::~SoundStreamDecoder()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        shutdown_ = true;
+    }
+    wakeCondition_.notify_all();
+
+    for (auto& thread : threads_)
+        thread->Stop();
+}
+
+bool SoundStreamDecoder::AddStream(SoundStream* stream)
+{
+    if (!stream || threads_.empty())
+        return false;
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (const StreamEntry& entry : streams_)
+        {
+            if (entry.stream_ == stream)
+                return true;
+        }
+
+        if (!stream->StartPrefetch())
+            return false;
+
+        StreamEntry entry;
+        entry.stream_ = stream;
+        entry.mutex_ = ea::make_unique<std::mutex>();
+        streams_.push_back(ea::move(entry));
+    }
+
+    wakeCondition_.notify_all();
+    return true;
+}
+
+void SoundStreamDecoder::RemoveStream(SoundStream* stream)
+{
+    ea::unique_ptr<std::mutex> streamMutex;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (auto i = streams_.begin(); i != streams_.end(); ++i)
+        {
+            if (i->stream_ == stream)
+            {
+                streamMutex = ea::move(i->mutex_);
+                streams_.erase(i);
+                break;
+            }
+        }
+    }
+
+    // Stream is not visible to decoder threads anymore, wait for the one that may be decoding it
+    if (streamMutex)
+    {
+        streamMutex->lock();
+        streamMutex->unlock();
+    }
+}
+
+ea::vector<SoundStream*> SoundStreamDecoder::GetStreams() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    ea::vector<SoundStream*> streams;
+    for (const StreamEntry& entry : streams_)
+        streams.push_back(entry.stream_);
+    return streams;
+}
+
+void SoundStreamDecoder::ProcessStreams()
+{
+    unsigned numIdleStreams = 0;
+    while (true)
+    {
+        SoundStream* stream = nullptr;
+        std::mutex* streamMutex = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (shutdown_)
+                return;
+
+            // Sleep if nothing was decoded for a whole round
+            if (numIdleStreams >= streams_.size())
+            {
+                wakeCondition_.wait_for(lock, IDLE_WAIT_TIME);
+                numIdleStreams = 0;
+                continue;
+            }
+
+            // Take the next stream not being decoded by other threads
+            const unsigned numStreams = streams_.size();
+            for (unsigned i = 0; i < numStreams; ++i)
+            {
+                const unsigned index = (nextStream_ + i) % numStreams;
+                StreamEntry& entry = streams_[index];
+                if (entry.mutex_->try_lock())
+                {
+                    stream = entry.stream_;
+                    streamMutex = entry.mutex_.get();
+                    nextStream_ = index + 1;
+                    break;
+                }
+            }
+
+            if (!stream)
+            {
+                numIdleStreams = numStreams;
+                continue;
+            }
+        }
+
+        if (stream->Prefetch())
+            numIdleStreams = 0;
+        else
+            ++numIdleStreams;
+
+        streamMutex->unlock();
+    }
+}
+
+}
@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Core/NonCopyable.h"
+#include "../Core/Thread.h"
+
+#include <EASTL/unique_ptr.h>
+#include <EASTL/vector.h>
+
+#include <condition_variable>
+#include <mutex>
+
+namespace Urho3D
+{
+
+class SoundStream;
+
+/// Decodes sound streams ahead of playback on background threads, so that the audio thread only copies decoded data.
+/// @nobind
+class URHO3D_API SoundStreamDecoder : private NonCopyable
+{
+public:
+    /// Construct with the number of decoder threads.
+    explicit SoundStreamDecoder(unsigned numThreads);
+    /// Destruct. Stop decoder threads.
+    ~SoundStreamDecoder();
+
+    /// Start decoding the stream ahead. Return false if the stream doesn't support prefetch.
+    bool AddStream(SoundStream* stream);
+    /// Stop decoding the stream ahead. Wait until decoder threads are done with the stream.
+    void RemoveStream(SoundStream* stream);
+
+    /// Return streams being decoded.
+    ea::vector<SoundStream*> GetStreams() const;
+    /// Return number of decoder threads.
+    unsigned GetNumThreads() const { return threads_.size(); }
+
+private:
+    class DecoderThread;
+
+    /// Stream being decoded.
+    struct StreamEntry
+    {
+        /// Stream.
+        SoundStream* stream_{};
+        /// Locked while the stream is being decoded.
+        ea::unique_ptr<std::mutex> mutex_;
+    };
+
+    /// Decode streams until shut down. Called from decoder threads.
+    void ProcessStreams();
+
+    /// Decoder threads.
+    ea::vector<ea::unique_ptr<DecoderThread>> threads_;
+    /// Streams being decoded.
+    ea::vector<StreamEntry> streams_;
+    /// Index of the stream checked next.
+    unsigned nextStream_{};
+    /// Mutex for streams and waking decoder threads.
+    mutable std::mutex mutex_;
+    /// Condition for waking decoder threads.
+    std::condition_variable wakeCondition_;
+    /// Whether the decoder threads should exit.
+    bool shutdown_{};
+};
+
+}
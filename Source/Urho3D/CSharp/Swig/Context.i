@@ -3,6 +3,7 @@
 %ignore Urho3D::Context::GetEventHandler;
 %ignore Urho3D::Context::GetObjectCategories;
 %ignore Urho3D::Context::GetObjectFactories;
+%ignore Urho3D::Context::GetAllAttributes;
 
 
 // Extend Context with extra code
@@ -117,6 +117,7 @@ using namespace Urho3D;
 #endif
 
 #define URHO3D_TYPE_TRAIT(...)
+#define URHO3D_POOL_ALLOCATION()
 
 %apply void* VOID_INT_PTR {
 	SDL_Cursor*,
@@ -194,6 +195,7 @@ CSHARP_ARRAYS_FIXED(Urho3D::Vector4, global::Urho3DNet.Vector4)
 %include "eastl_map.i"
 %include "eastl_pair.i"
 %include "eastl_unordered_map.i"
+%include "VariantMap.i"
 
 // Declare inheritable classes in this file
 %include "Context.i"
@@ -383,6 +385,7 @@ namespace SDL
 %ignore Urho3D::GetWideNativePath;
 %ignore Urho3D::logLevelNames;
 %ignore Urho3D::LOG_LEVEL_COLORS;
+%ignore Urho3D::DeferredLogMessage;
 
 %extend Urho3D::Log {
 public:
@@ -404,6 +407,7 @@ public:
 %include "Urho3D/IO/File.h"
 %include "Urho3D/IO/Log.h"
 %include "Urho3D/IO/MemoryBuffer.h"
+%ignore Urho3D::PackageFile::GetDictionary;
 %include "Urho3D/IO/PackageFile.h"
 %include "Urho3D/IO/VectorBuffer.h"
 %include "Urho3D/IO/FileSystem.h"
@@ -449,6 +453,8 @@ public:
 %ignore Urho3D::BackgroundLoadItem;
 %ignore Urho3D::BackgroundLoader::ThreadFunction;
 %ignore Urho3D::ImageCube::CalculateSphericalHarmonics;
+%ignore Urho3D::ResourceCache::GetAllResources;
+%ignore Urho3D::ResourceGroup::resources_;
 %rename(GetValueType) Urho3D::PListValue::GetType;
 
 %include "generated/Urho3D/_pre_resource.i"
@@ -517,6 +523,8 @@ public:
 %ignore Urho3D::BufferedSoundStream::AddData(const ea::shared_array<signed char>& data, unsigned numBytes);
 %ignore Urho3D::BufferedSoundStream::AddData(const ea::shared_array<signed short>& data, unsigned numBytes);
 %ignore Urho3D::Sound::GetData;
+%ignore Urho3D::Audio::GetStreamDecoder;
+%ignore Urho3D::SoundSource::Mix;
 
 %include "generated/Urho3D/_pre_audio.i"
 %include "Urho3D/Audio/AudioDefs.h"
@@ -691,8 +699,12 @@ public:
 	rcPolyMeshDetail*
 }
 %ignore Urho3D::CrowdManager::SetVelocityShader;
-%ignore Urho3D::NavBuildData::navAreas_;
+%ignore Urho3D::CrowdManager::GetAgentStates;
+%ignore Urho3D::CrowdAgentStates;
+%ignore Urho3D::CrowdRegion;
+%ignore Urho3D::NavGeometryData::navAreas_;
 %ignore Urho3D::NavigationMesh::FindPath;
+%ignore Urho3D::NavigationPathService::RequestPath;
 %include "generated/Urho3D/_pre_navigation.i"
 %include "Urho3D/Navigation/CrowdAgent.h"
 %include "Urho3D/Navigation/CrowdManager.h"
@@ -703,6 +715,7 @@ public:
 %include "Urho3D/Navigation/Navigable.h"
 %include "Urho3D/Navigation/Obstacle.h"
 %include "Urho3D/Navigation/OffMeshConnection.h"
+%include "Urho3D/Navigation/NavigationPathService.h"
 %template(CrowdAgentArray)       eastl::vector<Urho3D::CrowdAgent*>;
 #endif
 
@@ -845,6 +858,9 @@ using ImGuiConfigFlags = unsigned;
 
 %ignore Urho3D::AnimationSet2D::GetSpriterData;
 %ignore Urho3D::PhysicsWorld2D::DrawTransform;
+%ignore Urho3D::PhysicsContact2D;
+%ignore Urho3D::PhysicsWorld2D::GetBeginContacts;
+%ignore Urho3D::PhysicsWorld2D::GetEndContacts;
 
 // SWIG applies `override new` modifier by mistake.
 %csmethodmodifiers Urho3D::Drawable2D::OnSceneSet "protected override";
@@ -890,6 +906,7 @@ using ImGuiConfigFlags = unsigned;
 %include "Urho3D/Urho2D/Renderer2D.h"
 %include "Urho3D/Urho2D/SpriteSheet2D.h"
 %include "Urho3D/Urho2D/TileMapLayer2D.h"
+%include "Urho3D/Urho2D/TileMapChunk2D.h"
 %include "Urho3D/Urho2D/ParticleEmitter2D.h"
 %include "Urho3D/Urho2D/Sprite2D.h"
 %include "Urho3D/Urho2D/StretchableSprite2D.h"
@@ -923,7 +940,6 @@ using ImGuiConfigFlags = unsigned;
 %template(TileMapObject2DVector) eastl::vector<Urho3D::SharedPtr<Urho3D::TileMapObject2D>>;
 #endif
 
-%template(VariantMap)                   eastl::unordered_map<Urho3D::StringHash, Urho3D::Variant>;
 %template(AttributeMap)                 eastl::unordered_map<Urho3D::StringHash, eastl::vector<Urho3D::AttributeInfo>>;
 %template(PackageMap)                   eastl::unordered_map<eastl::string, Urho3D::PackageEntry>;
 %template(JSONObject)                   eastl::map<eastl::string, Urho3D::JSONValue>;
@@ -0,0 +1,269 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Urho3D::VariantMap is not a standard container, expose it to C# as IDictionary<StringHash, Variant> the same way
+// eastl_unordered_map.i does for hash maps.
+
+%typemap(csinterfaces) Urho3D::VariantMap "global::System.IDisposable \n    , global::System.Collections.Generic.IDictionary<$typemap(cstype, Urho3D::StringHash), $typemap(cstype, Urho3D::Variant)>\n";
+
+%csmethodmodifiers Urho3D::VariantMap::size "private"
+%csmethodmodifiers Urho3D::VariantMap::getitem "private"
+%csmethodmodifiers Urho3D::VariantMap::setitem "private"
+%csmethodmodifiers Urho3D::VariantMap::create_iterator_begin "private"
+%csmethodmodifiers Urho3D::VariantMap::get_next_key "private"
+%csmethodmodifiers Urho3D::VariantMap::destroy_iterator "private"
+
+namespace Urho3D {
+  class VariantMap {
+%proxycode %{
+
+  public $typemap(cstype, Urho3D::Variant) this[$typemap(cstype, Urho3D::StringHash) key] {
+    get {
+      return getitem(key);
+    }
+
+    set {
+      setitem(key, value);
+    }
+  }
+
+  public bool TryGetValue($typemap(cstype, Urho3D::StringHash) key, out $typemap(cstype, Urho3D::Variant) value) {
+    if (this.ContainsKey(key)) {
+      value = this[key];
+      return true;
+    }
+    value = default($typemap(cstype, Urho3D::Variant));
+    return false;
+  }
+
+  public int Count {
+    get {
+      return (int)size();
+    }
+  }
+
+  public bool IsReadOnly {
+    get {
+      return false;
+    }
+  }
+
+  public global::System.Collections.Generic.ICollection<$typemap(cstype, Urho3D::StringHash)> Keys {
+    get {
+      global::System.Collections.Generic.ICollection<$typemap(cstype, Urho3D::StringHash)> keys = new global::System.Collections.Generic.List<$typemap(cstype, Urho3D::StringHash)>();
+      int size = this.Count;
+      if (size > 0) {
+        global::System.IntPtr iter = create_iterator_begin();
+        for (int i = 0; i < size; i++) {
+          keys.Add(get_next_key(iter));
+        }
+        destroy_iterator(iter);
+      }
+      return keys;
+    }
+  }
+
+  public global::System.Collections.Generic.ICollection<$typemap(cstype, Urho3D::Variant)> Values {
+    get {
+      global::System.Collections.Generic.ICollection<$typemap(cstype, Urho3D::Variant)> vals = new global::System.Collections.Generic.List<$typemap(cstype, Urho3D::Variant)>();
+      foreach (global::System.Collections.Generic.KeyValuePair<$typemap(cstype, Urho3D::StringHash), $typemap(cstype, Urho3D::Variant)> pair in this) {
+        vals.Add(pair.Value);
+      }
+      return vals;
+    }
+  }
+
+  public void Add(global::System.Collections.Generic.KeyValuePair<$typemap(cstype, Urho3D::StringHash), $typemap(cstype, Urho3D::Variant)> item) {
+    Add(item.Key, item.Value);
+  }
+
+  public bool Remove(global::System.Collections.Generic.KeyValuePair<$typemap(cstype, Urho3D::StringHash), $typemap(cstype, Urho3D::Variant)> item) {
+    if (Contains(item)) {
+      return Remove(item.Key);
+    } else {
+      return false;
+    }
+  }
+
+  public bool Contains(global::System.Collections.Generic.KeyValuePair<$typemap(cstype, Urho3D::StringHash), $typemap(cstype, Urho3D::Variant)> item) {
+    if (this[item.Key] == item.Value) {
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  public void CopyTo(global::System.Collections.Generic.KeyValuePair<$typemap(cstype, Urho3D::StringHash), $typemap(cstype, Urho3D::Variant)>[] array) {
+    CopyTo(array, 0);
+  }
+
+  public void CopyTo(global::System.Collections.Generic.KeyValuePair<$typemap(cstype, Urho3D::StringHash), $typemap(cstype, Urho3D::Variant)>[] array, int arrayIndex) {
+    if (array == null)
+      throw new global::System.ArgumentNullException("array");
+    if (arrayIndex < 0)
+      throw new global::System.ArgumentOutOfRangeException("arrayIndex", "Value is less than zero");
+    if (array.Rank > 1)
+      throw new global::System.ArgumentException("Multi dimensional array.", "array");
+    if (arrayIndex+this.Count > array.Length)
+      throw new global::System.ArgumentException("Number of elements to copy is too large.");
+
+    global::System.Collections.Generic.IList<$typemap(cstype, Urho3D::StringHash)> keyList = new global::System.Collections.Generic.List<$typemap(cstype, Urho3D::StringHash)>(this.Keys);
+    for (int i = 0; i < keyList.Count; i++) {
+      $typemap(cstype, Urho3D::StringHash) currentKey = keyList[i];
+      array.SetValue(new global::System.Collections.Generic.KeyValuePair<$typemap(cstype, Urho3D::StringHash), $typemap(cstype, Urho3D::Variant)>(currentKey, this[currentKey]), arrayIndex+i);
+    }
+  }
+
+  global::System.Collections.Generic.IEnumerator<global::System.Collections.Generic.KeyValuePair<$typemap(cstype, Urho3D::StringHash), $typemap(cstype, Urho3D::Variant)>> global::System.Collections.Generic.IEnumerable<global::System.Collections.Generic.KeyValuePair<$typemap(cstype, Urho3D::StringHash), $typemap(cstype, Urho3D::Variant)>>.GetEnumerator() {
+    return new $csclassnameEnumerator(this);
+  }
+
+  global::System.Collections.IEnumerator global::System.Collections.IEnumerable.GetEnumerator() {
+    return new $csclassnameEnumerator(this);
+  }
+
+  public $csclassnameEnumerator GetEnumerator() {
+    return new $csclassnameEnumerator(this);
+  }
+
+  // Type-safe enumerator
+  /// Note that the IEnumerator documentation requires an InvalidOperationException to be thrown
+  /// whenever the collection is modified. This has been done for changes in the size of the
+  /// collection but not when one of the elements of the collection is modified as it is a bit
+  /// tricky to detect unmanaged code that modifies the collection under our feet.
+  public sealed class $csclassnameEnumerator : global::System.Collections.IEnumerator,
+      global::System.Collections.Generic.IEnumerator<global::System.Collections.Generic.KeyValuePair<$typemap(cstype, Urho3D::StringHash), $typemap(cstype, Urho3D::Variant)>>
+  {
+    private $csclassname collectionRef;
+    private global::System.Collections.Generic.IList<$typemap(cstype, Urho3D::StringHash)> keyCollection;
+    private int currentIndex;
+    private object currentObject;
+    private int currentSize;
+
+    public $csclassnameEnumerator($csclassname collection) {
+      collectionRef = collection;
+      keyCollection = new global::System.Collections.Generic.List<$typemap(cstype, Urho3D::StringHash)>(collection.Keys);
+      currentIndex = -1;
+      currentObject = null;
+      currentSize = collectionRef.Count;
+    }
+
+    // Type-safe iterator Current
+    public global::System.Collections.Generic.KeyValuePair<$typemap(cstype, Urho3D::StringHash), $typemap(cstype, Urho3D::Variant)> Current {
+      get {
+        if (currentIndex == -1)
+          throw new global::System.InvalidOperationException("Enumeration not started.");
+        if (currentIndex > currentSize - 1)
+          throw new global::System.InvalidOperationException("Enumeration finished.");
+        if (currentObject == null)
+          throw new global::System.InvalidOperationException("Collection modified.");
+        return (global::System.Collections.Generic.KeyValuePair<$typemap(cstype, Urho3D::StringHash), $typemap(cstype, Urho3D::Variant)>)currentObject;
+      }
+    }
+
+    // Type-unsafe IEnumerator.Current
+    object global::System.Collections.IEnumerator.Current {
+      get {
+        return Current;
+      }
+    }
+
+    public bool MoveNext() {
+      int size = collectionRef.Count;
+      bool moveOkay = (currentIndex+1 < size) && (size == currentSize);
+      if (moveOkay) {
+        currentIndex++;
+        $typemap(cstype, Urho3D::StringHash) currentKey = keyCollection[currentIndex];
+        currentObject = new global::System.Collections.Generic.KeyValuePair<$typemap(cstype, Urho3D::StringHash), $typemap(cstype, Urho3D::Variant)>(currentKey, collectionRef[currentKey]);
+      } else {
+        currentObject = null;
+      }
+      return moveOkay;
+    }
+
+    public void Reset() {
+      currentIndex = -1;
+      currentObject = null;
+      if (collectionRef.Count != currentSize) {
+        throw new global::System.InvalidOperationException("Collection modified.");
+      }
+    }
+
+    public void Dispose() {
+      currentIndex = -1;
+      currentObject = null;
+    }
+  }
+
+%}
+
+  public:
+    VariantMap();
+    VariantMap(const VariantMap &other);
+    unsigned size() const;
+    bool empty() const;
+    %rename(Clear) clear;
+    void clear();
+    %extend {
+      const Urho3D::Variant& getitem(const Urho3D::StringHash& key) throw (std::out_of_range) {
+        Urho3D::VariantMap::iterator iter = $self->find(key);
+        if (iter != $self->end())
+          return iter->second;
+        else
+          throw std::out_of_range("key not found");
+      }
+
+      void setitem(const Urho3D::StringHash& key, const Urho3D::Variant& x) {
+        (*$self)[key] = x;
+      }
+
+      bool ContainsKey(const Urho3D::StringHash& key) {
+        return $self->contains(key);
+      }
+
+      void Add(const Urho3D::StringHash& key, const Urho3D::Variant& value) throw (std::out_of_range) {
+        if (!$self->try_emplace(key, value).second)
+          throw std::out_of_range("key already exists");
+      }
+
+      bool Remove(const Urho3D::StringHash& key) {
+        return $self->erase(key) != 0;
+      }
+
+      // create_iterator_begin(), get_next_key() and destroy_iterator work together to provide a collection of keys to C#
+      %apply void *VOID_INT_PTR { unsigned *create_iterator_begin }
+      %apply void *VOID_INT_PTR { unsigned *swigiterator }
+
+      unsigned *create_iterator_begin() {
+        return new unsigned(0);
+      }
+
+      const Urho3D::StringHash& get_next_key(unsigned *swigiterator) {
+        return $self->begin()[(*swigiterator)++].first;
+      }
+
+      void destroy_iterator(unsigned *swigiterator) {
+        delete swigiterator;
+      }
+    }
+  };
+}
@@ -18,7 +18,10 @@
 %csattribute(Urho3D::Audio, %arg(bool), IsInitialized, IsInitialized);
 %csattribute(Urho3D::Audio, %arg(Urho3D::SoundListener *), Listener, GetListener, SetListener);
 %csattribute(Urho3D::Audio, %arg(ea::vector<SoundSource *>), SoundSources, GetSoundSources);
-%csattribute(Urho3D::Audio, %arg(Urho3D::Mutex), Mutex, GetMutex);
+%csattribute(Urho3D::Audio, %arg(unsigned int), MixingThreads, GetMixingThreads, SetMixingThreads);
+%csattribute(Urho3D::Audio, %arg(unsigned int), DecodingThreads, GetDecodingThreads, SetDecodingThreads);
+%csattribute(Urho3D::Audio, %arg(float), VirtualizationGain, GetVirtualizationGain, SetVirtualizationGain);
+%csattribute(Urho3D::Audio, %arg(Urho3D::AudioVoiceStats), VoiceStats, GetVoiceStats);
 %csattribute(Urho3D::SoundStream, %arg(unsigned int), SampleSize, GetSampleSize);
 %csattribute(Urho3D::SoundStream, %arg(float), Frequency, GetFrequency);
 %csattribute(Urho3D::SoundStream, %arg(unsigned int), IntFrequency, GetIntFrequency);
@@ -27,6 +30,7 @@
 %csattribute(Urho3D::SoundStream, %arg(bool), IsStereo, IsStereo);
 %csattribute(Urho3D::BufferedSoundStream, %arg(unsigned int), BufferNumBytes, GetBufferNumBytes);
 %csattribute(Urho3D::BufferedSoundStream, %arg(float), BufferLength, GetBufferLength);
+%csattribute(Urho3D::OggVorbisSoundStream, %arg(unsigned int), NumUnderruns, GetNumUnderruns);
 %csattribute(Urho3D::Sound, %arg(SharedPtr<Urho3D::SoundStream>), DecoderStream, GetDecoderStream);
 %csattribute(Urho3D::Sound, %arg(ea::shared_array<signed char>), Data, GetData);
 %csattribute(Urho3D::Sound, %arg(signed char *), Start, GetStart);
@@ -44,12 +48,16 @@
 %csattribute(Urho3D::SoundSource, %arg(Urho3D::Sound *), Sound, GetSound);
 %csattribute(Urho3D::SoundSource, %arg(volatile signed char *), PlayPosition, GetPlayPosition);
 %csattribute(Urho3D::SoundSource, %arg(ea::string), SoundType, GetSoundType, SetSoundType);
+%csattribute(Urho3D::SoundSource, %arg(Urho3D::StringHash), SoundTypeHash, GetSoundTypeHash);
 %csattribute(Urho3D::SoundSource, %arg(float), TimePosition, GetTimePosition);
 %csattribute(Urho3D::SoundSource, %arg(float), Frequency, GetFrequency, SetFrequency);
 %csattribute(Urho3D::SoundSource, %arg(float), Gain, GetGain, SetGain);
 %csattribute(Urho3D::SoundSource, %arg(float), Attenuation, GetAttenuation, SetAttenuation);
 %csattribute(Urho3D::SoundSource, %arg(float), Panning, GetPanning, SetPanning);
 %csattribute(Urho3D::SoundSource, %arg(Urho3D::AutoRemoveMode), AutoRemoveMode, GetAutoRemoveMode, SetAutoRemoveMode);
+%csattribute(Urho3D::SoundSource, %arg(int), Priority, GetPriority, SetPriority);
+%csattribute(Urho3D::SoundSource, %arg(bool), IsVirtual, IsVirtual);
+%csattribute(Urho3D::SoundSource, %arg(float), Audibility, GetAudibility);
 %csattribute(Urho3D::SoundSource, %arg(bool), IsPlaying, IsPlaying);
 %csattribute(Urho3D::SoundSource, %arg(Urho3D::ResourceRef), SoundAttr, GetSoundAttr, SetSoundAttr);
 %csattribute(Urho3D::SoundSource, %arg(int), PositionAttr, GetPositionAttr, SetPositionAttr);
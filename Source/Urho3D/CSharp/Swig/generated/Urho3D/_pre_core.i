@@ -78,11 +78,8 @@ using AttributeModeFlags = Urho3D::AttributeMode;
 %csattribute(Urho3D::Context, %arg(Urho3D::VariantMap), EventDataMap, GetEventDataMap);
 %csattribute(Urho3D::Context, %arg(Urho3D::VariantMap), GlobalVars, GetGlobalVars);
 %csattribute(Urho3D::Context, %arg(Urho3D::SubsystemCache), Subsystems, GetSubsystems);
-%csattribute(Urho3D::Context, %arg(ea::unordered_map<StringHash, SharedPtr<ObjectFactory>>), ObjectFactories, GetObjectFactories);
-%csattribute(Urho3D::Context, %arg(ea::unordered_map<ea::string, ea::vector<StringHash>>), ObjectCategories, GetObjectCategories);
 %csattribute(Urho3D::Context, %arg(Urho3D::Object *), EventSender, GetEventSender);
 %csattribute(Urho3D::Context, %arg(Urho3D::EventHandler *), EventHandler, GetEventHandler);
-%csattribute(Urho3D::Context, %arg(ea::unordered_map<StringHash, ea::vector<AttributeInfo>>), AllAttributes, GetAllAttributes);
 %csattribute(Urho3D::PluginModule, %arg(Urho3D::ModuleType), ModuleType, GetModuleType);
 %csattribute(Urho3D::PluginModule, %arg(ea::string), Path, GetPath);
 %csattribute(Urho3D::Spline, %arg(Urho3D::InterpolationMode), InterpolationMode, GetInterpolationMode, SetInterpolationMode);
@@ -39,6 +39,10 @@
 %csattribute(Urho3D::FileWatcher, %arg(float), Delay, GetDelay, SetDelay);
 %csattribute(Urho3D::Log, %arg(Urho3D::LogLevel), Level, GetLevel, SetLevel);
 %csattribute(Urho3D::Log, %arg(bool), IsQuiet, IsQuiet, SetQuiet);
+%csattribute(Urho3D::Log, %arg(bool), IsAsync, IsAsync, SetAsync);
+%csattribute(Urho3D::Log, %arg(Urho3D::LogOverflowPolicy), OverflowPolicy, GetOverflowPolicy, SetOverflowPolicy);
+%csattribute(Urho3D::Log, %arg(unsigned int), QueueCapacity, GetQueueCapacity, SetQueueCapacity);
+%csattribute(Urho3D::Log, %arg(unsigned int), NumDroppedMessages, GetNumDroppedMessages);
 %csattribute(Urho3D::MemoryBuffer, %arg(unsigned char *), Data, GetData);
 %csattribute(Urho3D::MemoryBuffer, %arg(bool), IsReadOnly, IsReadOnly);
 %csattribute(Urho3D::MultiFileWatcher, %arg(float), Delay, GetDelay, SetDelay);
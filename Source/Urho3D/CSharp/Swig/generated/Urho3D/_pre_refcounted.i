@@ -202,6 +202,7 @@ URHO3D_REFCOUNTED(Urho3D::Tile2D);
 URHO3D_REFCOUNTED(Urho3D::TileMapObject2D);
 URHO3D_REFCOUNTED(Urho3D::TileMap2D);
 URHO3D_REFCOUNTED(Urho3D::TileMapLayer2D);
+URHO3D_REFCOUNTED(Urho3D::TileMapChunk2D);
 URHO3D_REFCOUNTED(Urho3D::TmxLayer2D);
 URHO3D_REFCOUNTED(Urho3D::TmxTileLayer2D);
 URHO3D_REFCOUNTED(Urho3D::TmxObjectGroup2D);
@@ -85,7 +85,6 @@
 %csattribute(Urho3D::PListValue, %arg(Urho3D::PListValueVector), ValueVector, GetValueVector, SetValueVector);
 %csattribute(Urho3D::PListFile, %arg(Urho3D::PListValueMap), Root, GetRoot);
 %csattribute(Urho3D::ResourceCache, %arg(unsigned int), NumBackgroundLoadResources, GetNumBackgroundLoadResources);
-%csattribute(Urho3D::ResourceCache, %arg(ea::unordered_map<StringHash, ResourceGroup>), AllResources, GetAllResources);
 %csattribute(Urho3D::ResourceCache, %arg(ea::vector<ea::string>), ResourceDirs, GetResourceDirs);
 %csattribute(Urho3D::ResourceCache, %arg(ea::vector<SharedPtr<PackageFile>>), PackageFiles, GetPackageFiles);
 %csattribute(Urho3D::ResourceCache, %arg(unsigned long long), TotalMemoryUse, GetTotalMemoryUse);
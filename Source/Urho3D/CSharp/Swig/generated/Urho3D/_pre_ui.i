@@ -277,6 +277,7 @@ using DragAndDropModeFlags = Urho3D::DragAndDropMode;
 %csattribute(Urho3D::UI, %arg(bool), UseSystemClipboard, GetUseSystemClipboard, SetUseSystemClipboard);
 %csattribute(Urho3D::UI, %arg(bool), UseScreenKeyboard, GetUseScreenKeyboard, SetUseScreenKeyboard);
 %csattribute(Urho3D::UI, %arg(bool), UseMutableGlyphs, GetUseMutableGlyphs, SetUseMutableGlyphs);
+%csattribute(Urho3D::UI, %arg(bool), UseBatchCache, GetUseBatchCache, SetUseBatchCache);
 %csattribute(Urho3D::UI, %arg(bool), ForceAutoHint, GetForceAutoHint, SetForceAutoHint);
 %csattribute(Urho3D::UI, %arg(Urho3D::FontHintLevel), FontHintLevel, GetFontHintLevel, SetFontHintLevel);
 %csattribute(Urho3D::UI, %arg(float), FontSubpixelThreshold, GetFontSubpixelThreshold, SetFontSubpixelThreshold);
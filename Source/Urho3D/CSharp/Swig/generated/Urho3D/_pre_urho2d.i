@@ -183,6 +183,8 @@
 %csattribute(Urho3D::PhysicsWorld2D, %arg(Urho3D::Vector2), Gravity, GetGravity, SetGravity);
 %csattribute(Urho3D::PhysicsWorld2D, %arg(int), VelocityIterations, GetVelocityIterations, SetVelocityIterations);
 %csattribute(Urho3D::PhysicsWorld2D, %arg(int), PositionIterations, GetPositionIterations, SetPositionIterations);
+%csattribute(Urho3D::PhysicsWorld2D, %arg(bool), AreContactEventsEnabled, AreContactEventsEnabled, SetContactEventsEnabled);
+%csattribute(Urho3D::PhysicsWorld2D, %arg(bool), AreUpdateContactEventsEnabled, AreUpdateContactEventsEnabled, SetUpdateContactEventsEnabled);
 %csattribute(Urho3D::PhysicsWorld2D, %arg(b2World *), World, GetWorld);
 %csattribute(Urho3D::PhysicsWorld2D, %arg(bool), IsApplyingTransforms, IsApplyingTransforms, SetApplyingTransforms);
 %csattribute(Urho3D::Renderer2D, %arg(Urho3D::UpdateGeometryType), UpdateGeometryType, GetUpdateGeometryType);
@@ -234,6 +236,7 @@
 %csattribute(Urho3D::TileMapObject2D, %arg(bool), TileSwapXY, GetTileSwapXY);
 %csattribute(Urho3D::TileMapObject2D, %arg(Urho3D::Sprite2D *), TileSprite, GetTileSprite);
 %csattribute(Urho3D::TileMap2D, %arg(Urho3D::TmxFile2D *), TmxFile, GetTmxFile, SetTmxFile);
+%csattribute(Urho3D::TileMap2D, %arg(int), ChunkSize, GetChunkSize, SetChunkSize);
 %csattribute(Urho3D::TileMap2D, %arg(Urho3D::TileMapInfo2D), Info, GetInfo);
 %csattribute(Urho3D::TileMap2D, %arg(unsigned int), NumLayers, GetNumLayers);
 %csattribute(Urho3D::TileMap2D, %arg(Urho3D::ResourceRef), TmxFileAttr, GetTmxFileAttr, SetTmxFileAttr);
@@ -246,6 +249,12 @@
 %csattribute(Urho3D::TileMapLayer2D, %arg(int), Height, GetHeight);
 %csattribute(Urho3D::TileMapLayer2D, %arg(unsigned int), NumObjects, GetNumObjects);
 %csattribute(Urho3D::TileMapLayer2D, %arg(Urho3D::Node *), ImageNode, GetImageNode);
+%csattribute(Urho3D::TileMapLayer2D, %arg(unsigned int), NumChunks, GetNumChunks);
+%csattribute(Urho3D::TileMapLayer2D, %arg(unsigned int), NumLoadedChunks, GetNumLoadedChunks);
+%csattribute(Urho3D::TileMapChunk2D, %arg(Urho3D::IntRect), TileRect, GetTileRect);
+%csattribute(Urho3D::TileMapChunk2D, %arg(unsigned int), NumTiles, GetNumTiles);
+%csattribute(Urho3D::TileMapChunk2D, %arg(bool), IsGeometryLoaded, IsGeometryLoaded);
+%csattribute(Urho3D::TileMapChunk2D, %arg(unsigned int), MemoryUse, GetMemoryUse);
 %csattribute(Urho3D::TmxLayer2D, %arg(Urho3D::TmxFile2D *), TmxFile, GetTmxFile);
 %csattribute(Urho3D::TmxLayer2D, %arg(ea::string), Name, GetName);
 %csattribute(Urho3D::TmxLayer2D, %arg(int), Width, GetWidth);
@@ -261,6 +270,13 @@
 %pragma(csharp) moduleimports=%{
 public static partial class E
 {
+    public class PhysicsContacts2DEvent {
+        private StringHash _event = new StringHash("PhysicsContacts2D");
+        public StringHash World = new StringHash("World");
+        public PhysicsContacts2DEvent() { }
+        public static implicit operator StringHash(PhysicsContacts2DEvent e) { return e._event; }
+    }
+    public static PhysicsContacts2DEvent PhysicsContacts2D = new PhysicsContacts2DEvent();
     public class PhysicsUpdateContact2DEvent {
         private StringHash _event = new StringHash("PhysicsUpdateContact2D");
         public StringHash World = new StringHash("World");
@@ -0,0 +1,506 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Container/Hash.h"
+#include "../Math/MathDefs.h"
+
+#include <EASTL/functional.h>
+#include <EASTL/string.h>
+#include <EASTL/string_view.h>
+#include <EASTL/utility.h>
+#include <EASTL/vector.h>
+
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+
+namespace Urho3D
+{
+
+/// Transparent hash of strings. Enables lookup by string view in maps with string keys.
+struct StringViewHash
+{
+    using is_transparent = void;
+    size_t operator()(ea::string_view value) const { return ea::hash<ea::string_view>{}(value); }
+};
+
+/// Transparent comparison of strings. Enables lookup by string view in maps with string keys.
+struct StringViewEqual
+{
+    using is_transparent = void;
+    bool operator()(ea::string_view lhs, ea::string_view rhs) const { return lhs == rhs; }
+};
+
+/// Hash map with open addressing. Elements are stored in one array and probed linearly.
+/// Each slot has control byte with 7 bits of the hash, so most of mismatched keys are skipped without comparison.
+/// Insertion invalidates iterators and references. Erasure invalidates only iterators to erased element.
+template <class K, class V, class Hash = ea::hash<K>, class KeyEqual = ea::equal_to<K>>
+class FlatHashMap
+{
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = ea::pair<const K, V>;
+    using size_type = unsigned;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+
+    /// Iterator over occupied slots.
+    template <bool IsConst>
+    class IteratorBase
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ea::pair<const K, V>;
+        using difference_type = ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+        using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+        using MapType = std::conditional_t<IsConst, const FlatHashMap, FlatHashMap>;
+
+        /// Construct invalid.
+        IteratorBase() = default;
+        /// Construct const iterator from non-const iterator.
+        template <bool OtherConst, class = std::enable_if_t<IsConst && !OtherConst>>
+        IteratorBase(const IteratorBase<OtherConst>& other) : map_(other.map_), index_(other.index_) {}
+
+        /// Dereference.
+        reference operator*() const { return map_->slots_[index_]; }
+        /// Dereference.
+        pointer operator->() const { return &map_->slots_[index_]; }
+        /// Advance to the next element.
+        IteratorBase& operator++() { index_ = map_->NextOccupiedSlot(index_ + 1); return *this; }
+        /// Advance to the next element.
+        IteratorBase operator++(int) { IteratorBase result = *this; ++*this; return result; }
+
+        /// Compare.
+        template <bool OtherConst>
+        bool operator==(const IteratorBase<OtherConst>& rhs) const { return index_ == rhs.index_; }
+        /// Compare.
+        template <bool OtherConst>
+        bool operator!=(const IteratorBase<OtherConst>& rhs) const { return index_ != rhs.index_; }
+
+    private:
+        friend class FlatHashMap;
+        template <bool> friend class IteratorBase;
+
+        /// Construct.
+        IteratorBase(MapType* map, unsigned index) : map_(map), index_(index) {}
+
+        /// Owner map.
+        MapType* map_{};
+        /// Slot index.
+        unsigned index_{};
+    };
+
+    using iterator = IteratorBase<false>;
+    using const_iterator = IteratorBase<true>;
+
+    /// Construct empty.
+    FlatHashMap() = default;
+    /// Construct from initializer list.
+    FlatHashMap(std::initializer_list<value_type> list)
+    {
+        reserve(list.size());
+        for (const value_type& value : list)
+            insert(value);
+    }
+    /// Copy-construct.
+    FlatHashMap(const FlatHashMap& other)
+        : hash_(other.hash_)
+        , equal_(other.equal_)
+    {
+        if (!other.size_)
+            return;
+
+        Allocate(other.capacity_);
+        for (unsigned i = 0; i < capacity_; ++i)
+        {
+            if (other.controls_[i] & OccupiedBit)
+                new (&slots_[i]) value_type(other.slots_[i]);
+        }
+        memcpy(controls_, other.controls_, capacity_);
+        size_ = other.size_;
+        numErased_ = other.numErased_;
+    }
+    /// Move-construct.
+    FlatHashMap(FlatHashMap&& other) noexcept { swap(other); }
+    /// Destruct.
+    ~FlatHashMap()
+    {
+        DestroyElements();
+        Deallocate();
+    }
+
+    /// Copy-assign.
+    FlatHashMap& operator=(const FlatHashMap& rhs)
+    {
+        if (this != &rhs)
+        {
+            FlatHashMap copy(rhs);
+            swap(copy);
+        }
+        return *this;
+    }
+    /// Move-assign.
+    FlatHashMap& operator=(FlatHashMap&& rhs) noexcept
+    {
+        FlatHashMap temp(ea::move(rhs));
+        swap(temp);
+        return *this;
+    }
+
+    /// Swap with another map.
+    void swap(FlatHashMap& other) noexcept
+    {
+        ea::swap(controls_, other.controls_);
+        ea::swap(slots_, other.slots_);
+        ea::swap(capacity_, other.capacity_);
+        ea::swap(size_, other.size_);
+        ea::swap(numErased_, other.numErased_);
+        ea::swap(hash_, other.hash_);
+        ea::swap(equal_, other.equal_);
+    }
+
+    /// Return iterator to the first element.
+    iterator begin() { return { this, NextOccupiedSlot(0) }; }
+    /// Return iterator to the first element.
+    const_iterator begin() const { return { this, NextOccupiedSlot(0) }; }
+    /// Return iterator to the first element.
+    const_iterator cbegin() const { return begin(); }
+    /// Return iterator past the last element.
+    iterator end() { return { this, capacity_ }; }
+    /// Return iterator past the last element.
+    const_iterator end() const { return { this, capacity_ }; }
+    /// Return iterator past the last element.
+    const_iterator cend() const { return end(); }
+
+    /// Return number of elements.
+    size_type size() const { return size_; }
+    /// Return whether the map is empty.
+    bool empty() const { return size_ == 0; }
+    /// Return number of slots.
+    size_type capacity() const { return capacity_; }
+
+    /// Remove all elements. Memory is not released.
+    void clear()
+    {
+        DestroyElements();
+        if (controls_)
+            memset(controls_, EmptySlot, capacity_);
+        size_ = 0;
+        numErased_ = 0;
+    }
+
+    /// Reserve space for given number of elements.
+    void reserve(size_type count)
+    {
+        const unsigned requiredCapacity = Max(NextPowerOfTwo(count + count / 7 + 1), MinCapacity);
+        if (requiredCapacity > capacity_)
+            Rehash(requiredCapacity);
+    }
+
+    /// Find element by key.
+    iterator find(const K& key) { return { this, FindSlot(key) }; }
+    /// Find element by key.
+    const_iterator find(const K& key) const { return { this, FindSlot(key) }; }
+    /// Find element by key of another type. Hash and comparison functions should be transparent.
+    template <class U, class H = Hash, class E = KeyEqual, class = typename H::is_transparent, class = typename E::is_transparent>
+    iterator find(const U& key) { return { this, FindSlot(key) }; }
+    /// Find element by key of another type. Hash and comparison functions should be transparent.
+    template <class U, class H = Hash, class E = KeyEqual, class = typename H::is_transparent, class = typename E::is_transparent>
+    const_iterator find(const U& key) const { return { this, FindSlot(key) }; }
+
+    /// Return whether the element with given key exists.
+    bool contains(const K& key) const { return FindSlot(key) != capacity_; }
+    /// Return whether the element with given key of another type exists.
+    template <class U, class H = Hash, class E = KeyEqual, class = typename H::is_transparent, class = typename E::is_transparent>
+    bool contains(const U& key) const { return FindSlot(key) != capacity_; }
+    /// Return number of elements with given key.
+    size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+
+    /// Insert element with value constructed from arguments if the key doesn't exist.
+    /// Return iterator to the element and whether the insertion took place.
+    template <class KK, class... Args>
+    ea::pair<iterator, bool> try_emplace(KK&& key, Args&&... args)
+    {
+        const auto [index, inserted] = FindOrPrepareSlot(key);
+        if (inserted)
+            new (&slots_[index]) value_type(K(ea::forward<KK>(key)), V(ea::forward<Args>(args)...));
+        return { iterator{ this, index }, inserted };
+    }
+    /// Insert element if the key doesn't exist.
+    template <class KK, class VV>
+    ea::pair<iterator, bool> emplace(KK&& key, VV&& value) { return try_emplace(ea::forward<KK>(key), ea::forward<VV>(value)); }
+    /// Insert element if the key doesn't exist.
+    ea::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+    /// Insert element if the key doesn't exist.
+    ea::pair<iterator, bool> insert(value_type&& value) { return try_emplace(value.first, ea::move(value.second)); }
+    /// Insert element or assign the value if the key exists.
+    template <class KK, class VV>
+    ea::pair<iterator, bool> insert_or_assign(KK&& key, VV&& value)
+    {
+        auto result = try_emplace(ea::forward<KK>(key), ea::forward<VV>(value));
+        if (!result.second)
+            result.first->second = ea::forward<VV>(value);
+        return result;
+    }
+
+    /// Return value by key, insert default value if not found.
+    V& operator[](const K& key) { return try_emplace(key).first->second; }
+    /// Return value by key, insert default value if not found.
+    V& operator[](K&& key) { return try_emplace(ea::move(key)).first->second; }
+
+    /// Erase element by iterator. Return iterator to the next element.
+    iterator erase(const_iterator position)
+    {
+        EraseSlot(position.index_);
+        return { this, NextOccupiedSlot(position.index_ + 1) };
+    }
+    /// Erase element by key. Return number of erased elements.
+    size_type erase(const K& key)
+    {
+        const unsigned index = FindSlot(key);
+        if (index == capacity_)
+            return 0;
+        EraseSlot(index);
+        return 1;
+    }
+
+    /// Return vector of keys.
+    ea::vector<K> keys() const
+    {
+        ea::vector<K> result;
+        result.reserve(size_);
+        for (const value_type& element : *this)
+            result.push_back(element.first);
+        return result;
+    }
+    /// Return vector of values.
+    ea::vector<V> values() const
+    {
+        ea::vector<V> result;
+        result.reserve(size_);
+        for (const value_type& element : *this)
+            result.push_back(element.second);
+        return result;
+    }
+
+private:
+    /// Control byte of empty slot.
+    static constexpr unsigned char EmptySlot = 0;
+    /// Control byte of slot with erased element.
+    static constexpr unsigned char ErasedSlot = 1;
+    /// Bit set in control bytes of occupied slots.
+    static constexpr unsigned char OccupiedBit = 0x80;
+    /// Min non-zero number of slots.
+    static constexpr unsigned MinCapacity = 8;
+
+    /// Spread hash bits.
+    static unsigned long long MixHash(size_t hash) { return static_cast<unsigned long long>(hash) * 0x9e3779b97f4a7c15ull; }
+    /// Return control byte of occupied slot.
+    static unsigned char GetControlByte(unsigned long long mixedHash) { return OccupiedBit | static_cast<unsigned char>(mixedHash >> 57); }
+    /// Return first slot to probe.
+    unsigned GetFirstSlot(unsigned long long mixedHash) const { return static_cast<unsigned>(mixedHash >> 32) & (capacity_ - 1); }
+    /// Return whether the number of used slots exceeds max load factor of 7/8.
+    bool IsOverloaded(unsigned numUsedSlots) const { return numUsedSlots * 8ull > capacity_ * 7ull; }
+
+    /// Return index of the first occupied slot starting from given one.
+    unsigned NextOccupiedSlot(unsigned index) const
+    {
+        while (index < capacity_ && !(controls_[index] & OccupiedBit))
+            ++index;
+        return index;
+    }
+
+    /// Find slot by key. Return capacity if not found.
+    template <class U>
+    unsigned FindSlot(const U& key) const
+    {
+        if (!size_)
+            return capacity_;
+
+        const unsigned long long mixedHash = MixHash(hash_(key));
+        const unsigned char controlByte = GetControlByte(mixedHash);
+        const unsigned mask = capacity_ - 1;
+        for (unsigned index = GetFirstSlot(mixedHash); ; index = (index + 1) & mask)
+        {
+            const unsigned char control = controls_[index];
+            if (control == EmptySlot)
+                return capacity_;
+            if (control == controlByte && equal_(slots_[index].first, key))
+                return index;
+        }
+    }
+
+    /// Find slot by key or prepare free slot for the key. Return slot index and whether the slot is free.
+    template <class U>
+    ea::pair<unsigned, bool> FindOrPrepareSlot(const U& key)
+    {
+        if (!capacity_)
+            Rehash(MinCapacity);
+
+        const unsigned long long mixedHash = MixHash(hash_(key));
+        const unsigned char controlByte = GetControlByte(mixedHash);
+        const unsigned mask = capacity_ - 1;
+
+        unsigned freeIndex = capacity_;
+        for (unsigned index = GetFirstSlot(mixedHash); ; index = (index + 1) & mask)
+        {
+            const unsigned char control = controls_[index];
+            if (control == EmptySlot)
+            {
+                if (freeIndex == capacity_)
+                    freeIndex = index;
+                break;
+            }
+            if (control == ErasedSlot)
+            {
+                if (freeIndex == capacity_)
+                    freeIndex = index;
+            }
+            else if (control == controlByte && equal_(slots_[index].first, key))
+                return { index, false };
+        }
+
+        // Reusing erased slot doesn't increase load
+        if (controls_[freeIndex] == EmptySlot && IsOverloaded(size_ + numErased_ + 1))
+        {
+            // Double the capacity unless most of the used slots are erased
+            Rehash(IsOverloaded(2 * (size_ + 1)) ? capacity_ * 2 : capacity_);
+            freeIndex = FindFreeSlot(mixedHash);
+        }
+
+        if (controls_[freeIndex] == ErasedSlot)
+            --numErased_;
+        controls_[freeIndex] = controlByte;
+        ++size_;
+        return { freeIndex, true };
+    }
+
+    /// Find free slot for the hash. There should be no erased slots.
+    unsigned FindFreeSlot(unsigned long long mixedHash) const
+    {
+        const unsigned mask = capacity_ - 1;
+        unsigned index = GetFirstSlot(mixedHash);
+        while (controls_[index] != EmptySlot)
+            index = (index + 1) & mask;
+        return index;
+    }
+
+    /// Erase element in occupied slot.
+    void EraseSlot(unsigned index)
+    {
+        slots_[index].~value_type();
+        --size_;
+
+        // Slot may be marked as empty if probing never continues past it
+        if (controls_[(index + 1) & (capacity_ - 1)] == EmptySlot)
+            controls_[index] = EmptySlot;
+        else
+        {
+            controls_[index] = ErasedSlot;
+            ++numErased_;
+        }
+    }
+
+    /// Move elements to new storage.
+    void Rehash(unsigned newCapacity)
+    {
+        unsigned char* oldControls = controls_;
+        value_type* oldSlots = slots_;
+        const unsigned oldCapacity = capacity_;
+
+        Allocate(newCapacity);
+        for (unsigned i = 0; i < oldCapacity; ++i)
+        {
+            if (!(oldControls[i] & OccupiedBit))
+                continue;
+
+            const unsigned long long mixedHash = MixHash(hash_(oldSlots[i].first));
+            const unsigned index = FindFreeSlot(mixedHash);
+            controls_[index] = GetControlByte(mixedHash);
+            new (&slots_[index]) value_type(ea::move(oldSlots[i]));
+            oldSlots[i].~value_type();
+        }
+        numErased_ = 0;
+
+        Deallocate(oldControls, oldSlots);
+    }
+
+    /// Allocate empty storage. Old storage is not released.
+    void Allocate(unsigned capacity)
+    {
+        controls_ = new unsigned char[capacity];
+        memset(controls_, EmptySlot, capacity);
+        slots_ = static_cast<value_type*>(::operator new(sizeof(value_type) * capacity, std::align_val_t{ alignof(value_type) }));
+        capacity_ = capacity;
+    }
+
+    /// Release storage.
+    static void Deallocate(unsigned char* controls, value_type* slots)
+    {
+        delete[] controls;
+        if (slots)
+            ::operator delete(slots, std::align_val_t{ alignof(value_type) });
+    }
+
+    /// Release current storage.
+    void Deallocate() { Deallocate(controls_, slots_); }
+
+    /// Destroy all elements.
+    void DestroyElements()
+    {
+        if (std::is_trivially_destructible<value_type>::value || !size_)
+            return;
+
+        for (unsigned i = 0; i < capacity_; ++i)
+        {
+            if (controls_[i] & OccupiedBit)
+                slots_[i].~value_type();
+        }
+    }
+
+    /// Control bytes.
+    unsigned char* controls_{};
+    /// Slots.
+    value_type* slots_{};
+    /// Number of slots, zero or power of two.
+    unsigned capacity_{};
+    /// Number of elements.
+    unsigned size_{};
+    /// Number of slots with erased elements.
+    unsigned numErased_{};
+    /// Hash function.
+    Hash hash_;
+    /// Key comparison function.
+    KeyEqual equal_;
+};
+
+/// Flat hash map with string keys. Supports lookup by string view without allocation.
+template <class V>
+using StringFlatHashMap = FlatHashMap<ea::string, V, StringViewHash, StringViewEqual>;
+
+}
@@ -0,0 +1,272 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Container/FrameAllocator.h"
+#include "../Core/CoreEvents.h"
+#include "../Core/Mutex.h"
+#include "../Core/Thread.h"
+
+#include <EASTL/algorithm.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Index of the current frame.
+std::atomic<unsigned> frameIndex{};
+
+/// Registry of the thread frame arenas.
+struct FrameArenaRegistry
+{
+    /// Mutex.
+    Mutex mutex_;
+    /// Arenas.
+    ea::vector<LinearAllocator*> arenas_;
+    /// Total number of allocations at the end of the last frame.
+    unsigned long long lastTotalAllocations_{};
+    /// Total number of allocated bytes at the end of the last frame.
+    unsigned long long lastTotalBytes_{};
+    /// Statistics of the last frame.
+    FrameArenaStats stats_;
+};
+
+FrameArenaRegistry& GetRegistry()
+{
+    static FrameArenaRegistry registry;
+    return registry;
+}
+
+/// Frame arena of the thread. Registers itself for statistics.
+struct ThreadFrameArena
+{
+    ThreadFrameArena()
+        : frameIndex_(frameIndex.load(std::memory_order_relaxed))
+    {
+        FrameArenaRegistry& registry = GetRegistry();
+        MutexLock lock(registry.mutex_);
+        registry.arenas_.push_back(&arena_);
+    }
+
+    ~ThreadFrameArena()
+    {
+        FrameArenaRegistry& registry = GetRegistry();
+        MutexLock lock(registry.mutex_);
+        registry.arenas_.erase_first(&arena_);
+        // Keep totals monotonic
+        registry.lastTotalAllocations_ -= ea::min(registry.lastTotalAllocations_, arena_.GetTotalAllocations());
+        registry.lastTotalBytes_ -= ea::min(registry.lastTotalBytes_, arena_.GetTotalBytes());
+    }
+
+    /// Arena.
+    LinearAllocator arena_;
+    /// Index of the frame the arena was last reset in.
+    unsigned frameIndex_{};
+    /// Number of active scopes.
+    unsigned numScopes_{};
+    /// Whether the thread resets the arena between tasks.
+    bool resetByThread_{};
+};
+
+ThreadFrameArena& GetThreadFrameArena()
+{
+    static thread_local ThreadFrameArena threadArena;
+    return threadArena;
+}
+
+/// Reset the arena if the frame has ended since the last reset.
+void ResetThreadFrameArena(ThreadFrameArena& threadArena)
+{
+    const unsigned currentFrameIndex = frameIndex.load(std::memory_order_relaxed);
+    if (threadArena.frameIndex_ != currentFrameIndex)
+    {
+        threadArena.frameIndex_ = currentFrameIndex;
+        threadArena.arena_.Reset();
+    }
+}
+
+}
+
+LinearAllocator::LinearAllocator(unsigned chunkSize)
+    : chunkSize_(chunkSize)
+{
+}
+
+LinearAllocator::~LinearAllocator() = default;
+
+void* LinearAllocator::Allocate(size_t size, size_t alignment)
+{
+    totalAllocations_.store(totalAllocations_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    totalBytes_.store(totalBytes_.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+
+    // Chunks are allocated with max_align_t alignment, larger alignment is handled by padding
+    const size_t padding = alignment > alignof(std::max_align_t) ? alignment : 0;
+    while (true)
+    {
+        if (currentChunk_ == chunks_.size())
+            AddChunk(size + padding);
+
+        Chunk& chunk = chunks_[currentChunk_];
+        const auto base = reinterpret_cast<uintptr_t>(chunk.data_.get());
+        const size_t alignedOffset = ((base + offset_ + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1)) - base;
+        if (alignedOffset + size <= chunk.size_)
+        {
+            offset_ = static_cast<unsigned>(alignedOffset + size);
+            return chunk.data_.get() + alignedOffset;
+        }
+
+        // Try the next chunk, it may remain from before rewind
+        ++currentChunk_;
+        offset_ = 0;
+    }
+}
+
+void LinearAllocator::Reset()
+{
+    if (chunks_.size() > 1)
+    {
+        // Merge chunks so that next frame fits into one chunk
+        size_t totalSize = 0;
+        for (const Chunk& chunk : chunks_)
+            totalSize += chunk.size_;
+        chunks_.clear();
+        capacity_.store(0, std::memory_order_relaxed);
+        AddChunk(totalSize);
+    }
+
+    currentChunk_ = 0;
+    offset_ = 0;
+}
+
+void LinearAllocator::Rewind(const Marker& marker)
+{
+    // Ignore markers taken before reset
+    if (marker.chunk_ >= chunks_.size())
+        return;
+
+    currentChunk_ = marker.chunk_;
+    offset_ = marker.offset_;
+}
+
+void LinearAllocator::AddChunk(size_t minSize)
+{
+    const size_t lastSize = chunks_.empty() ? 0 : chunks_.back().size_;
+    const size_t size = ea::max({ minSize, static_cast<size_t>(chunkSize_), lastSize * 2 });
+
+    Chunk chunk;
+    chunk.data_.reset(new unsigned char[size]);
+    chunk.size_ = static_cast<unsigned>(size);
+    chunks_.push_back(ea::move(chunk));
+    capacity_.store(capacity_.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+}
+
+LinearAllocator& GetFrameArena()
+{
+    ThreadFrameArena& threadArena = GetThreadFrameArena();
+    // Memory allocated without scope is never released in threads that don't reset the arena
+    assert(threadArena.resetByThread_ || threadArena.numScopes_ > 0 || Thread::IsMainThread());
+    return threadArena.arena_;
+}
+
+void ResetFrameArena()
+{
+    ThreadFrameArena& threadArena = GetThreadFrameArena();
+    threadArena.resetByThread_ = true;
+    ResetThreadFrameArena(threadArena);
+}
+
+void EndFrameArenas()
+{
+    FrameArenaRegistry& registry = GetRegistry();
+    {
+        MutexLock lock(registry.mutex_);
+        unsigned long long totalAllocations = 0;
+        unsigned long long totalBytes = 0;
+        unsigned long long capacity = 0;
+        for (LinearAllocator* arena : registry.arenas_)
+        {
+            totalAllocations += arena->GetTotalAllocations();
+            totalBytes += arena->GetTotalBytes();
+            capacity += arena->GetCapacity();
+        }
+
+        registry.stats_.numAllocations_ = totalAllocations - ea::min(totalAllocations, registry.lastTotalAllocations_);
+        registry.stats_.numBytes_ = totalBytes - ea::min(totalBytes, registry.lastTotalBytes_);
+        registry.stats_.capacity_ = capacity;
+        registry.stats_.numArenas_ = registry.arenas_.size();
+        registry.lastTotalAllocations_ = totalAllocations;
+        registry.lastTotalBytes_ = totalBytes;
+    }
+
+    frameIndex.fetch_add(1, std::memory_order_relaxed);
+    ResetFrameArena();
+}
+
+FrameArenaStats GetFrameArenaStats()
+{
+    FrameArenaRegistry& registry = GetRegistry();
+    MutexLock lock(registry.mutex_);
+    return registry.stats_;
+}
+
+FrameArenaScope::FrameArenaScope()
+    : arena_(GetThreadFrameArena().arena_)
+    , marker_(arena_.GetMarker())
+{
+    ++GetThreadFrameArena().numScopes_;
+}
+
+FrameArenaScope::~FrameArenaScope()
+{
+    arena_.Rewind(marker_);
+
+    // Nothing is allocated from the arena after the outermost scope, it is safe to reset
+    ThreadFrameArena& threadArena = GetThreadFrameArena();
+    --threadArena.numScopes_;
+    if (!threadArena.numScopes_ && !marker_.chunk_ && !marker_.offset_)
+        ResetThreadFrameArena(threadArena);
+}
+
+FrameArenaManager::FrameArenaManager(Context* context)
+    : Object(context)
+{
+    SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(FrameArenaManager, HandleEndFrame));
+}
+
+void FrameArenaManager::HandleEndFrame(StringHash eventType, VariantMap& eventData)
+{
+    EndFrameArenas();
+
+    const FrameArenaStats frameStats = GetFrameArenaStats();
+    const PoolAllocatorStats poolStats = GetPoolAllocatorStats();
+    URHO3D_PROFILE_VALUE("Frame Arena Allocations", static_cast<int64_t>(frameStats.numAllocations_));
+    URHO3D_PROFILE_VALUE("Frame Arena Bytes", static_cast<int64_t>(frameStats.numBytes_));
+    URHO3D_PROFILE_VALUE("Pool Allocations", static_cast<int64_t>(poolStats.numAllocations_));
+    URHO3D_PROFILE_VALUE("Pool Live Allocations", static_cast<int64_t>(poolStats.numAllocations_ - poolStats.numFrees_));
+}
+
+}
@@ -0,0 +1,196 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Core/NonCopyable.h"
+#include "../Core/Object.h"
+
+#include <Urho3D/Urho3D.h>
+
+#include <EASTL/unique_ptr.h>
+#include <EASTL/vector.h>
+
+#include <atomic>
+#include <cstddef>
+
+namespace Urho3D
+{
+
+/// Linear (bump) allocator. Memory is allocated sequentially from chunks and is released all at once on reset.
+/// Destructors of the allocated objects are not called. Not thread-safe.
+class URHO3D_API LinearAllocator : private NonCopyable
+{
+public:
+    /// Position in the allocator that can be rewound to.
+    struct Marker
+    {
+        /// Chunk index.
+        unsigned chunk_{};
+        /// Offset in the chunk.
+        unsigned offset_{};
+    };
+
+    /// Construct with the size of the first chunk.
+    explicit LinearAllocator(unsigned chunkSize = 64 * 1024);
+    /// Destruct.
+    ~LinearAllocator();
+
+    /// Allocate memory. Alignment should be power of two.
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    /// Release all allocated memory. If more than one chunk was used, chunks are merged into one large enough chunk.
+    void Reset();
+    /// Return current position.
+    Marker GetMarker() const { return { currentChunk_, offset_ }; }
+    /// Release memory allocated after the marker was taken.
+    void Rewind(const Marker& marker);
+
+    /// Return number of allocations since construction.
+    unsigned long long GetTotalAllocations() const { return totalAllocations_.load(std::memory_order_relaxed); }
+    /// Return number of allocated bytes since construction.
+    unsigned long long GetTotalBytes() const { return totalBytes_.load(std::memory_order_relaxed); }
+    /// Return number of reserved bytes.
+    unsigned long long GetCapacity() const { return capacity_.load(std::memory_order_relaxed); }
+
+private:
+    /// Memory chunk.
+    struct Chunk
+    {
+        /// Data.
+        ea::unique_ptr<unsigned char[]> data_;
+        /// Size.
+        unsigned size_{};
+    };
+
+    /// Add chunk that can hold at least given size.
+    void AddChunk(size_t minSize);
+
+    /// Memory chunks.
+    ea::vector<Chunk> chunks_;
+    /// Current chunk index.
+    unsigned currentChunk_{};
+    /// Offset in the current chunk.
+    unsigned offset_{};
+    /// Size of the first chunk.
+    unsigned chunkSize_{};
+    /// Total number of allocations. Modified only by the owner thread, may be read from other threads.
+    std::atomic<unsigned long long> totalAllocations_{};
+    /// Total number of allocated bytes. Modified only by the owner thread, may be read from other threads.
+    std::atomic<unsigned long long> totalBytes_{};
+    /// Number of reserved bytes. Modified only by the owner thread, may be read from other threads.
+    std::atomic<unsigned long long> capacity_{};
+};
+
+/// Frame arena statistics.
+struct FrameArenaStats
+{
+    /// Number of allocations during the last frame in all threads.
+    unsigned long long numAllocations_{};
+    /// Number of bytes allocated during the last frame in all threads.
+    unsigned long long numBytes_{};
+    /// Number of bytes reserved by all arenas.
+    unsigned long long capacity_{};
+    /// Number of thread arenas.
+    unsigned numArenas_{};
+};
+
+/// Return the frame arena of the current thread. Memory allocated from the arena is valid until the end of the frame
+/// in the main thread, and until the next safe point after the end of the frame in the other threads.
+/// Threads that don't call ResetFrameArena() may use the arena only within FrameArenaScope.
+URHO3D_API LinearAllocator& GetFrameArena();
+/// Reset the frame arena of the current thread if the frame has ended since the last reset.
+/// Called by the threads between tasks, when no frame memory is in use. Such threads may use the arena without scope.
+URHO3D_API void ResetFrameArena();
+/// End the frame. Reset the frame arena of the calling thread, other threads reset their arenas at the next safe point.
+/// Called from the main thread.
+URHO3D_API void EndFrameArenas();
+/// Return statistics of the frame arenas.
+URHO3D_API FrameArenaStats GetFrameArenaStats();
+
+/// Release the frame arena memory allocated within the scope. Required in threads that don't reset the arena,
+/// the outermost scope resets the arena of such thread once the frame has ended.
+class URHO3D_API FrameArenaScope : private NonCopyable
+{
+public:
+    /// Construct.
+    FrameArenaScope();
+    /// Destruct.
+    ~FrameArenaScope();
+
+private:
+    /// Frame arena.
+    LinearAllocator& arena_;
+    /// Position at construction.
+    LinearAllocator::Marker marker_;
+};
+
+/// EASTL allocator that uses the frame arena of the thread the allocator is created in. Deallocation does nothing.
+class FrameEASTLAllocator
+{
+public:
+    /// Construct.
+    explicit FrameEASTLAllocator(const char* name = nullptr) : arena_(&GetFrameArena()) {}
+    /// Construct copy.
+    FrameEASTLAllocator(const FrameEASTLAllocator& other, const char* name) : arena_(other.arena_) {}
+
+    /// Allocate memory.
+    void* allocate(size_t n, int flags = 0) { return arena_->Allocate(n); }
+    /// Allocate aligned memory.
+    void* allocate(size_t n, size_t alignment, size_t offset, int flags = 0) { return arena_->Allocate(n, alignment); }
+    /// Free memory. Memory is released on arena reset.
+    void deallocate(void* p, size_t n) {}
+
+    /// Return name.
+    const char* get_name() const { return "FrameEASTLAllocator"; }
+    /// Set name. Ignored.
+    void set_name(const char* name) {}
+
+    /// Test for equality.
+    bool operator ==(const FrameEASTLAllocator& rhs) const { return arena_ == rhs.arena_; }
+    /// Test for inequality.
+    bool operator !=(const FrameEASTLAllocator& rhs) const { return arena_ != rhs.arena_; }
+
+private:
+    /// Frame arena.
+    LinearAllocator* arena_{};
+};
+
+/// Vector allocated from the frame arena.
+template <class T> using FrameVector = ea::vector<T, FrameEASTLAllocator>;
+
+/// Frame arena subsystem. Ends the frame of the frame arenas on frame end and reports allocator counters to the profiler.
+class URHO3D_API FrameArenaManager : public Object
+{
+    URHO3D_OBJECT(FrameArenaManager, Object);
+
+public:
+    /// Construct.
+    explicit FrameArenaManager(Context* context);
+
+private:
+    /// Handle frame end event.
+    void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+};
+
+}
@@ -0,0 +1,155 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Container/PoolAllocator.h"
+#include "../Core/Mutex.h"
+
+#include <atomic>
+#include <new>
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Number of size classes.
+static const unsigned NUM_SIZE_CLASSES = POOL_MAX_SIZE / POOL_SIZE_GRANULARITY;
+/// Size of the memory chunk reserved at once for a size class.
+static const unsigned POOL_CHUNK_SIZE = 16 * 1024;
+
+/// Free slot of the size class.
+struct PoolSlot
+{
+    /// Next free slot.
+    PoolSlot* next_;
+};
+
+/// Size class of the pool. Aligned to cache line to avoid false sharing between classes.
+struct alignas(64) PoolSizeClass
+{
+    /// Mutex.
+    SpinLockMutex mutex_;
+    /// First free slot.
+    PoolSlot* free_{};
+    /// Number of allocations. Modified under the lock.
+    std::atomic<unsigned long long> numAllocations_{};
+    /// Number of deallocations. Modified under the lock.
+    std::atomic<unsigned long long> numFrees_{};
+};
+
+/// Pool state. Never destroyed, because objects may be released during static destruction.
+struct PoolState
+{
+    /// Size classes.
+    PoolSizeClass classes_[NUM_SIZE_CLASSES];
+    /// Number of allocations that were too large for the pool.
+    std::atomic<unsigned long long> numHeapAllocations_{};
+    /// Number of bytes reserved by the pool.
+    std::atomic<unsigned long long> reservedBytes_{};
+};
+
+PoolState& GetPoolState()
+{
+    static PoolState* state = new PoolState();
+    return *state;
+}
+
+unsigned GetSizeClassIndex(size_t size)
+{
+    return size ? static_cast<unsigned>((size - 1) / POOL_SIZE_GRANULARITY) : 0u;
+}
+
+}
+
+void* PoolAllocate(size_t size)
+{
+    PoolState& state = GetPoolState();
+    if (size > POOL_MAX_SIZE)
+    {
+        state.numHeapAllocations_.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+
+    const unsigned index = GetSizeClassIndex(size);
+    PoolSizeClass& sizeClass = state.classes_[index];
+
+    MutexLock<SpinLockMutex> lock(sizeClass.mutex_);
+    sizeClass.numAllocations_.store(sizeClass.numAllocations_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (!sizeClass.free_)
+    {
+        // Chunks are never returned to the heap, slots are reused by the same size class
+        const unsigned slotSize = (index + 1) * POOL_SIZE_GRANULARITY;
+        const unsigned numSlots = POOL_CHUNK_SIZE / slotSize;
+        auto* chunk = static_cast<unsigned char*>(::operator new(numSlots * slotSize));
+        for (unsigned i = 0; i < numSlots; ++i)
+        {
+            auto* slot = reinterpret_cast<PoolSlot*>(chunk + i * slotSize);
+            slot->next_ = i + 1 < numSlots ? reinterpret_cast<PoolSlot*>(chunk + (i + 1) * slotSize) : nullptr;
+        }
+        sizeClass.free_ = reinterpret_cast<PoolSlot*>(chunk);
+        state.reservedBytes_.fetch_add(numSlots * slotSize, std::memory_order_relaxed);
+    }
+
+    PoolSlot* slot = sizeClass.free_;
+    sizeClass.free_ = slot->next_;
+    return slot;
+}
+
+void PoolFree(void* ptr, size_t size)
+{
+    if (!ptr)
+        return;
+
+    PoolState& state = GetPoolState();
+    if (size > POOL_MAX_SIZE)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    PoolSizeClass& sizeClass = state.classes_[GetSizeClassIndex(size)];
+    auto* slot = static_cast<PoolSlot*>(ptr);
+
+    MutexLock<SpinLockMutex> lock(sizeClass.mutex_);
+    sizeClass.numFrees_.store(sizeClass.numFrees_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    slot->next_ = sizeClass.free_;
+    sizeClass.free_ = slot;
+}
+
+PoolAllocatorStats GetPoolAllocatorStats()
+{
+    PoolState& state = GetPoolState();
+    PoolAllocatorStats stats;
+    for (const PoolSizeClass& sizeClass : state.classes_)
+    {
+        stats.numAllocations_ += sizeClass.numAllocations_.load(std::memory_order_relaxed);
+        stats.numFrees_ += sizeClass.numFrees_.load(std::memory_order_relaxed);
+    }
+    stats.numHeapAllocations_ = state.numHeapAllocations_.load(std::memory_order_relaxed);
+    stats.reservedBytes_ = state.reservedBytes_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+}
@@ -0,0 +1,103 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include <Urho3D/Urho3D.h>
+
+#include <cstddef>
+
+namespace Urho3D
+{
+
+/// Granularity of the size classes. Also the alignment of the pooled memory.
+static const unsigned POOL_SIZE_GRANULARITY = 16;
+/// Max size of the memory served by the size-class pool. Larger blocks are allocated from the heap.
+static const unsigned POOL_MAX_SIZE = 256;
+
+/// Size-class pool statistics, accumulated since the start of the application.
+struct PoolAllocatorStats
+{
+    /// Number of pooled allocations.
+    unsigned long long numAllocations_{};
+    /// Number of pooled deallocations.
+    unsigned long long numFrees_{};
+    /// Number of allocations that were too large for the pool.
+    unsigned long long numHeapAllocations_{};
+    /// Number of bytes reserved by the pool.
+    unsigned long long reservedBytes_{};
+};
+
+/// Allocate memory from the size-class pool. Thread-safe.
+URHO3D_API void* PoolAllocate(size_t size);
+/// Free memory allocated by PoolAllocate. Size should be the same as passed to PoolAllocate. Thread-safe.
+URHO3D_API void PoolFree(void* ptr, size_t size);
+/// Return size-class pool statistics.
+URHO3D_API PoolAllocatorStats GetPoolAllocatorStats();
+
+/// EASTL allocator that uses the size-class pool. Alignment is limited by POOL_SIZE_GRANULARITY.
+class PoolEASTLAllocator
+{
+public:
+    /// Construct.
+    explicit PoolEASTLAllocator(const char* name = nullptr) {}
+    /// Construct copy.
+    PoolEASTLAllocator(const PoolEASTLAllocator& other, const char* name) {}
+
+    /// Allocate memory.
+    void* allocate(size_t n, int flags = 0) { return PoolAllocate(n); }
+    /// Allocate aligned memory.
+    void* allocate(size_t n, size_t alignment, size_t offset, int flags = 0) { return PoolAllocate(n); }
+    /// Free memory.
+    void deallocate(void* p, size_t n) { PoolFree(p, n); }
+
+    /// Return name.
+    const char* get_name() const { return "PoolEASTLAllocator"; }
+    /// Set name. Ignored.
+    void set_name(const char* name) {}
+
+    /// Test for equality. Pool memory may be freed by any instance.
+    bool operator ==(const PoolEASTLAllocator& rhs) const { return true; }
+    /// Test for inequality.
+    bool operator !=(const PoolEASTLAllocator& rhs) const { return false; }
+};
+
+}
+
+#if defined(_MSC_VER) && defined(_DEBUG)
+#define URHO3D_POOL_ALLOCATION_DEBUG() \
+    static void* operator new(size_t size, int, const char*, int) { return Urho3D::PoolAllocate(size); } \
+    static void operator delete(void* ptr, int, const char*, int) { }
+#else
+#define URHO3D_POOL_ALLOCATION_DEBUG()
+#endif
+
+/// Declare class-specific operators new and delete that use the size-class pool. Derived classes inherit them, the class
+/// should have a virtual destructor if it is deleted through the base class pointer.
+#define URHO3D_POOL_ALLOCATION() \
+    static void* operator new(size_t size) { return Urho3D::PoolAllocate(size); } \
+    static void operator delete(void* ptr, size_t size) { Urho3D::PoolFree(ptr, size); } \
+    static void* operator new(size_t size, void* ptr) { return ptr; } \
+    static void operator delete(void* ptr, void* place) { } \
+    URHO3D_POOL_ALLOCATION_DEBUG()
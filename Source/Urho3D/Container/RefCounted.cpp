@@ -26,6 +26,7 @@
 
 #include <EASTL/internal/thread_support.h>
 
+#include "../Container/PoolAllocator.h"
 #include "../Container/RefCounted.h"
 #include "../Core/Macros.h"
 #if URHO3D_CSHARP
@@ -37,7 +38,7 @@ namespace Urho3D
 
 RefCount* RefCount::Allocate()
 {
-    void* const memory = EASTLAlloc(*ea::get_default_allocator((Allocator*)nullptr), sizeof(RefCount));
+    void* const memory = PoolAllocate(sizeof(RefCount));
     assert(memory != nullptr);
     return ::new(memory) RefCount();
 }
@@ -45,7 +46,7 @@ RefCount* RefCount::Allocate()
 void RefCount::Free(RefCount* instance)
 {
     instance->~RefCount();
-    EASTLFree(*ea::get_default_allocator((Allocator*)nullptr), instance, sizeof(RefCount));
+    PoolFree(instance, sizeof(RefCount));
 }
 
 RefCounted::RefCounted()
@@ -118,7 +118,7 @@ void EventReceiverGroup::Remove(Object* object)
         receivers_.erase_first(object);
 }
 
-void RemoveNamedAttribute(ea::unordered_map<StringHash, ea::vector<AttributeInfo> >& attributes, StringHash objectType, const char* name)
+void RemoveNamedAttribute(FlatHashMap<StringHash, ea::vector<AttributeInfo>>& attributes, StringHash objectType, const char* name)
 {
     auto i = attributes.find(objectType);
     if (i == attributes.end())
@@ -223,7 +223,7 @@ void Context::RegisterFactory(ObjectFactory* factory, const char* category)
 
     RegisterFactory(factory);
     if (CStringLength(category))
-        objectCategories_[category].push_back(factory->GetType());
+        objectCategories_.try_emplace(category).first->second.push_back(factory->GetType());
 }
 
 void Context::RemoveFactory(StringHash type)
@@ -235,7 +235,11 @@ void Context::RemoveFactory(StringHash type, const char* category)
 {
     RemoveFactory(type);
     if (CStringLength(category))
-        objectCategories_[category].erase_first_unsorted(type);
+    {
+        auto iter = objectCategories_.find(category);
+        if (iter != objectCategories_.end())
+            iter->second.erase_first_unsorted(type);
+    }
 }
 
 void Context::RegisterSubsystem(Object* object, StringHash type)
@@ -417,16 +421,17 @@ void Context::CopyBaseAttributes(StringHash baseType, StringHash derivedType)
         return;
     }
 
-    const ea::vector<AttributeInfo>* baseAttributes = GetAttributes(baseType);
-    if (baseAttributes)
+    if (!GetAttributes(baseType))
+        return;
+
+    // Insert derived type first, base attributes may be moved on insertion
+    ea::vector<AttributeInfo>& derivedAttributes = attributes_[derivedType];
+    const ea::vector<AttributeInfo>& baseAttributes = *GetAttributes(baseType);
+    for (const AttributeInfo& attr : baseAttributes)
     {
-        for (unsigned i = 0; i < baseAttributes->size(); ++i)
-        {
-            const AttributeInfo& attr = baseAttributes->at(i);
-            attributes_[derivedType].push_back(attr);
-            if (attr.mode_ & AM_NET)
-                networkAttributes_[derivedType].push_back(attr);
-        }
+        derivedAttributes.push_back(attr);
+        if (attr.mode_ & AM_NET)
+            networkAttributes_[derivedType].push_back(attr);
     }
 }
 
@@ -24,6 +24,7 @@
 
 #include <EASTL/unique_ptr.h>
 
+#include "../Container/FlatHashMap.h"
 #include "../Container/Ptr.h"
 #include "../Core/Attribute.h"
 #include "../Core/Object.h"
@@ -36,6 +37,8 @@ namespace Urho3D
 class URHO3D_API EventReceiverGroup : public RefCounted
 {
 public:
+    URHO3D_POOL_ALLOCATION();
+
     /// Construct.
     EventReceiverGroup() :
         inSend_(0),
@@ -162,10 +165,10 @@ public:
     const SubsystemCache& GetSubsystems() const { return subsystems_; }
 
     /// Return all object factories.
-    const ea::unordered_map<StringHash, SharedPtr<ObjectFactory> >& GetObjectFactories() const { return factories_; }
+    const FlatHashMap<StringHash, SharedPtr<ObjectFactory>>& GetObjectFactories() const { return factories_; }
 
     /// Return all object categories.
-    const ea::unordered_map<ea::string, ea::vector<StringHash> >& GetObjectCategories() const { return objectCategories_; }
+    const StringFlatHashMap<ea::vector<StringHash>>& GetObjectCategories() const { return objectCategories_; }
 
     /// Return active event sender. Null outside event handling.
     Object* GetEventSender() const;
@@ -197,7 +200,7 @@ public:
     }
 
     /// Return all registered attributes.
-    const ea::unordered_map<StringHash, ea::vector<AttributeInfo> >& GetAllAttributes() const { return attributes_; }
+    const FlatHashMap<StringHash, ea::vector<AttributeInfo>>& GetAllAttributes() const { return attributes_; }
 
     /// Return event receivers for a sender and event type, or null if they do not exist.
     EventReceiverGroup* GetEventReceivers(Object* sender, StringHash eventType)
@@ -241,13 +244,13 @@ private:
     void SetEventHandler(EventHandler* handler) { eventHandler_ = handler; }
 
     /// Object factories.
-    ea::unordered_map<StringHash, SharedPtr<ObjectFactory> > factories_;
+    FlatHashMap<StringHash, SharedPtr<ObjectFactory>> factories_;
     /// Subsystems.
     SubsystemCache subsystems_;
     /// Attribute descriptions per object type.
-    ea::unordered_map<StringHash, ea::vector<AttributeInfo> > attributes_;
+    FlatHashMap<StringHash, ea::vector<AttributeInfo>> attributes_;
     /// Network replication attribute descriptions per object type.
-    ea::unordered_map<StringHash, ea::vector<AttributeInfo> > networkAttributes_;
+    FlatHashMap<StringHash, ea::vector<AttributeInfo>> networkAttributes_;
     /// Event receivers for non-specific events.
     ea::unordered_map<StringHash, SharedPtr<EventReceiverGroup> > eventReceivers_;
     /// Event receivers for specific senders' events.
@@ -259,7 +262,7 @@ private:
     /// Active event handler. Not stored in a stack for performance reasons; is needed only in esoteric cases.
     EventHandler* eventHandler_;
     /// Object categories.
-    ea::unordered_map<ea::string, ea::vector<StringHash> > objectCategories_;
+    StringFlatHashMap<ea::vector<StringHash>> objectCategories_;
     /// Variant map for global variables that can persist throughout application execution.
     VariantMap globalVars_;
 };
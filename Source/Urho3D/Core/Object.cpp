@@ -451,7 +451,7 @@ bool Object::HasSubscribedToEvent(Object* sender, StringHash eventType) const
 
 const ea::string& Object::GetCategory() const
 {
-    const ea::unordered_map<ea::string, ea::vector<StringHash> >& objectCategories = context_->GetObjectCategories();
+    const auto& objectCategories = context_->GetObjectCategories();
     for (auto i = objectCategories.begin(); i != objectCategories.end(); ++i)
     {
         if (i->second.contains(GetType()))
@@ -25,6 +25,7 @@
 #include <EASTL/intrusive_list.h>
 
 #include "../Container/Allocator.h"
+#include "../Container/PoolAllocator.h"
 #include "../Core/Mutex.h"
 #include "../Core/Profiler.h"
 #include "../Core/StringHashRegister.h"
@@ -290,6 +291,8 @@ public:
 class URHO3D_API EventHandler : public ea::intrusive_list_node
 {
 public:
+    URHO3D_POOL_ALLOCATION();
+
     /// Construct with specified receiver and userdata.
     explicit EventHandler(Object* receiver, void* userData = nullptr) :
         receiver_(receiver),
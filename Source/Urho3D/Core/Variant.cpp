@@ -75,6 +75,36 @@ static_assert(sizeof(typeNames) / sizeof(const char*) == (size_t)MAX_VAR_TYPES +
 
 Variant& Variant::operator =(const Variant& rhs)
 {
+    if (this == &rhs)
+        return *this;
+
+    // Share heap-allocated values instead of copying.
+    // Source may be nested in the current value, so take the reference before releasing the latter.
+    if (rhs.type_ == VAR_VARIANTMAP || rhs.type_ == VAR_MATRIX4)
+    {
+        if (rhs.type_ == VAR_VARIANTMAP)
+            rhs.value_.variantMap_->refs_.fetch_add(1, std::memory_order_relaxed);
+        else
+            rhs.value_.matrix4_->refs_.fetch_add(1, std::memory_order_relaxed);
+
+        const VariantType type = rhs.type_;
+        VariantValue value;
+        memcpy(&value, &rhs.value_, sizeof(VariantValue));      // NOLINT(bugprone-undefined-memory-manipulation)
+
+        SetType(VAR_NONE);
+        memcpy(&value_, &value, sizeof(VariantValue));          // NOLINT(bugprone-undefined-memory-manipulation)
+        type_ = type;
+        return *this;
+    }
+
+    // Source may be an element of the current map or vector, copy it before the current value is released
+    if (type_ == VAR_VARIANTMAP || type_ == VAR_VARIANTVECTOR)
+    {
+        Variant copy(rhs);
+        SetType(VAR_NONE);
+        return *this = ea::move(copy);
+    }
+
     // Handle custom types separately
     if (rhs.GetType() == VAR_CUSTOM)
     {
@@ -111,28 +141,74 @@ Variant& Variant::operator =(const Variant& rhs)
         value_.stringVector_ = rhs.value_.stringVector_;
         break;
 
-    case VAR_VARIANTMAP:
-        *value_.variantMap_ = *rhs.value_.variantMap_;
-        break;
-
     case VAR_PTR:
         value_.weakPtr_ = rhs.value_.weakPtr_;
         break;
 
-    case VAR_MATRIX3:
-        *value_.matrix3_ = *rhs.value_.matrix3_;
+    default:
+        memcpy(&value_, &rhs.value_, sizeof(VariantValue));     // NOLINT(bugprone-undefined-memory-manipulation)
         break;
+    }
 
-    case VAR_MATRIX3X4:
-        *value_.matrix3x4_ = *rhs.value_.matrix3x4_;
+    return *this;
+}
+
+Variant& Variant::operator =(Variant&& rhs) noexcept
+{
+    if (this == &rhs)
+        return *this;
+
+    // Source may be an element of the current map or vector, take its value before the current value is released
+    if (type_ == VAR_VARIANTMAP || type_ == VAR_VARIANTVECTOR)
+    {
+        Variant temp(ea::move(rhs));
+        SetType(VAR_NONE);
+        return *this = ea::move(temp);
+    }
+
+    switch (rhs.type_)
+    {
+    case VAR_STRING:
+        SetType(VAR_STRING);
+        value_.string_ = ea::move(rhs.value_.string_);
+        break;
+
+    case VAR_BUFFER:
+        SetType(VAR_BUFFER);
+        value_.buffer_ = ea::move(rhs.value_.buffer_);
         break;
 
+    case VAR_RESOURCEREF:
+        SetType(VAR_RESOURCEREF);
+        value_.resourceRef_ = ea::move(rhs.value_.resourceRef_);
+        break;
+
+    case VAR_RESOURCEREFLIST:
+        SetType(VAR_RESOURCEREFLIST);
+        value_.resourceRefList_ = ea::move(rhs.value_.resourceRefList_);
+        break;
+
+    case VAR_VARIANTVECTOR:
+        SetType(VAR_VARIANTVECTOR);
+        value_.variantVector_ = ea::move(rhs.value_.variantVector_);
+        break;
+
+    case VAR_STRINGVECTOR:
+        SetType(VAR_STRINGVECTOR);
+        value_.stringVector_ = ea::move(rhs.value_.stringVector_);
+        break;
+
+    case VAR_VARIANTMAP:
     case VAR_MATRIX4:
-        *value_.matrix4_ = *rhs.value_.matrix4_;
+        // Take over heap-allocated value
+        SetType(VAR_NONE);
+        memcpy(&value_, &rhs.value_, sizeof(VariantValue));     // NOLINT(bugprone-undefined-memory-manipulation)
+        type_ = rhs.type_;
+        rhs.type_ = VAR_NONE;
         break;
 
     default:
-        memcpy(&value_, &rhs.value_, sizeof(VariantValue));     // NOLINT(bugprone-undefined-memory-manipulation)
+        *this = static_cast<const Variant&>(rhs);
         break;
     }
 
@@ -203,7 +279,7 @@ bool Variant::operator ==(const Variant& rhs) const
         return value_.stringVector_ == rhs.value_.stringVector_;
 
     case VAR_VARIANTMAP:
-        return *value_.variantMap_ == *rhs.value_.variantMap_;
+        return value_.variantMap_ == rhs.value_.variantMap_ || value_.variantMap_->value_ == rhs.value_.variantMap_->value_;
 
     case VAR_INTRECT:
         return value_.intRect_ == rhs.value_.intRect_;
@@ -215,13 +291,13 @@ bool Variant::operator ==(const Variant& rhs) const
         return value_.intVector3_ == rhs.value_.intVector3_;
 
     case VAR_MATRIX3:
-        return *value_.matrix3_ == *rhs.value_.matrix3_;
+        return value_.matrix3_ == rhs.value_.matrix3_;
 
     case VAR_MATRIX3X4:
-        return *value_.matrix3x4_ == *rhs.value_.matrix3x4_;
+        return value_.matrix3x4_ == rhs.value_.matrix3x4_;
 
     case VAR_MATRIX4:
-        return *value_.matrix4_ == *rhs.value_.matrix4_;
+        return value_.matrix4_ == rhs.value_.matrix4_ || value_.matrix4_->value_ == rhs.value_.matrix4_->value_;
 
     case VAR_DOUBLE:
         return value_.double_ == rhs.value_.double_;
@@ -587,13 +663,13 @@ ea::string Variant::ToString() const
         return value_.intVector3_.ToString();
 
     case VAR_MATRIX3:
-        return value_.matrix3_->ToString();
+        return value_.matrix3_.ToString();
 
     case VAR_MATRIX3X4:
-        return value_.matrix3x4_->ToString();
+        return value_.matrix3x4_.ToString();
 
     case VAR_MATRIX4:
-        return value_.matrix4_->ToString();
+        return value_.matrix4_->value_.ToString();
 
     case VAR_DOUBLE:
         return ea::to_string(value_.double_);
@@ -674,7 +750,7 @@ bool Variant::IsZero() const
         return value_.stringVector_.empty();
 
     case VAR_VARIANTMAP:
-        return value_.variantMap_->empty();
+        return value_.variantMap_->value_.empty();
 
     case VAR_INTRECT:
         return value_.intRect_ == IntRect::ZERO;
@@ -689,13 +765,13 @@ bool Variant::IsZero() const
         return value_.weakPtr_ == nullptr;
 
     case VAR_MATRIX3:
-        return *value_.matrix3_ == Matrix3::IDENTITY;
+        return value_.matrix3_ == Matrix3::IDENTITY;
 
     case VAR_MATRIX3X4:
-        return *value_.matrix3x4_ == Matrix3x4::IDENTITY;
+        return value_.matrix3x4_ == Matrix3x4::IDENTITY;
 
     case VAR_MATRIX4:
-        return *value_.matrix4_ == Matrix4::IDENTITY;
+        return value_.matrix4_->value_ == Matrix4::IDENTITY;
 
     case VAR_DOUBLE:
         return value_.double_ == 0.0;
@@ -743,23 +819,15 @@ void Variant::SetType(VariantType newType)
         break;
 
     case VAR_VARIANTMAP:
-        delete value_.variantMap_;
+        ReleaseSharedValue(value_.variantMap_);
         break;
 
     case VAR_PTR:
         value_.weakPtr_.~WeakPtr<RefCounted>();
         break;
 
-    case VAR_MATRIX3:
-        delete value_.matrix3_;
-        break;
-
-    case VAR_MATRIX3X4:
-        delete value_.matrix3x4_;
-        break;
-
     case VAR_MATRIX4:
-        delete value_.matrix4_;
+        ReleaseSharedValue(value_.matrix4_);
         break;
 
     case VAR_CUSTOM:
@@ -799,7 +867,7 @@ void Variant::SetType(VariantType newType)
         break;
 
     case VAR_VARIANTMAP:
-        value_.variantMap_ = new VariantMap();
+        value_.variantMap_ = new VariantSharedValue<VariantMap>();
         break;
 
     case VAR_PTR:
@@ -807,15 +875,15 @@ void Variant::SetType(VariantType newType)
         break;
 
     case VAR_MATRIX3:
-        value_.matrix3_ = new Matrix3();
+        new(&value_.matrix3_) Matrix3();
         break;
 
     case VAR_MATRIX3X4:
-        value_.matrix3x4_ = new Matrix3x4();
+        new(&value_.matrix3x4_) Matrix3x4();
         break;
 
     case VAR_MATRIX4:
-        value_.matrix4_ = new Matrix4();
+        value_.matrix4_ = new VariantSharedValue<Matrix4>();
         break;
 
     case VAR_CUSTOM:
@@ -1123,4 +1191,142 @@ unsigned Variant::ToHash() const
     }
 }
 
+VariantMap::~VariantMap()
+{
+    clear();
+    while (blocks_)
+    {
+        void* nextBlock = *static_cast<void**>(blocks_);
+        ::operator delete(blocks_);
+        blocks_ = nextBlock;
+    }
+}
+
+bool VariantMap::operator ==(const VariantMap& rhs) const
+{
+    if (size_ != rhs.size_)
+        return false;
+
+    for (unsigned i = 0; i < size_; ++i)
+    {
+        const unsigned rhsIndex = rhs.FindIndex(keys_[i]);
+        if (rhsIndex == rhs.size_ || rhs.slots_[rhsIndex]->second != slots_[i]->second)
+            return false;
+    }
+    return true;
+}
+
+unsigned VariantMap::ToHash() const
+{
+    unsigned result = 16777619;
+    for (unsigned i = 0; i < size_; ++i)
+        result += keys_[i].ToHash() * 31 + slots_[i]->second.ToHash();
+    return result;
+}
+
+void VariantMap::clear()
+{
+    for (unsigned i = 0; i < size_; ++i)
+        slots_[i]->~value_type();
+    size_ = 0;
+    index_.clear();
+}
+
+void VariantMap::reserve(unsigned count)
+{
+    if (count <= capacity_)
+        return;
+
+    const auto alignUp = [](unsigned offset, unsigned alignment) { return (offset + alignment - 1) / alignment * alignment; };
+    static_assert(alignof(value_type) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "Variant map elements are overaligned");
+
+    // New block contains key and slot arrays for the whole capacity and only the added elements.
+    // Existing elements stay in the old blocks, so references to them are not invalidated.
+    const unsigned newCapacity = Max(NextPowerOfTwo(count), MinCapacity);
+    const unsigned numNewElements = newCapacity - capacity_;
+    const unsigned keysOffset = alignUp(sizeof(void*), alignof(StringHash));
+    const unsigned slotsOffset = alignUp(keysOffset + newCapacity * sizeof(StringHash), alignof(value_type*));
+    const unsigned elementsOffset = alignUp(slotsOffset + newCapacity * sizeof(value_type*), alignof(value_type));
+    auto block = static_cast<unsigned char*>(::operator new(elementsOffset + numNewElements * sizeof(value_type)));
+
+    *reinterpret_cast<void**>(block) = blocks_;
+    auto newKeys = reinterpret_cast<StringHash*>(block + keysOffset);
+    auto newSlots = reinterpret_cast<value_type**>(block + slotsOffset);
+    auto newElements = reinterpret_cast<value_type*>(block + elementsOffset);
+
+    for (unsigned i = 0; i < size_; ++i)
+        new (&newKeys[i]) StringHash(keys_[i]);
+    for (unsigned i = 0; i < capacity_; ++i)
+        newSlots[i] = slots_[i];
+    for (unsigned i = 0; i < numNewElements; ++i)
+        newSlots[capacity_ + i] = &newElements[i];
+
+    blocks_ = block;
+    keys_ = newKeys;
+    slots_ = newSlots;
+    capacity_ = newCapacity;
+}
+
+ea::vector<Variant> VariantMap::values() const
+{
+    ea::vector<Variant> result;
+    result.reserve(size_);
+    for (unsigned i = 0; i < size_; ++i)
+        result.push_back(slots_[i]->second);
+    return result;
+}
+
+void VariantMap::CopyElements(const VariantMap& other)
+{
+    reserve(other.size_);
+    for (unsigned i = 0; i < other.size_; ++i)
+    {
+        new (&keys_[i]) StringHash(other.keys_[i]);
+        new (slots_[i]) value_type(*other.slots_[i]);
+    }
+    size_ = other.size_;
+
+    if (size_ > MaxLinearSearchSize)
+        index_ = other.index_;
+}
+
+void VariantMap::UpdateIndexAfterInsert()
+{
+    if (size_ <= MaxLinearSearchSize)
+        return;
+
+    if (size_ == MaxLinearSearchSize + 1)
+    {
+        index_.reserve(size_);
+        for (unsigned i = 0; i < size_; ++i)
+            index_.emplace(keys_[i], i);
+    }
+    else
+        index_.emplace(keys_[size_ - 1], size_ - 1);
+}
+
+void VariantMap::EraseAt(unsigned index)
+{
+    const bool indexed = size_ > MaxLinearSearchSize;
+    const unsigned lastIndex = size_ - 1;
+    if (indexed)
+        index_.erase(keys_[index]);
+
+    // Last element takes the place of erased one, erased element becomes unused
+    value_type* element = slots_[index];
+    element->~value_type();
+    if (index != lastIndex)
+    {
+        slots_[index] = slots_[lastIndex];
+        slots_[lastIndex] = element;
+        keys_[index] = keys_[lastIndex];
+        if (indexed)
+            index_[keys_[index]] = index;
+    }
+    --size_;
+
+    if (indexed && size_ <= MaxLinearSearchSize)
+        index_.clear();
+}
+
 }
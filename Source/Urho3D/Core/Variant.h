@@ -30,6 +30,7 @@
 
 #include "../Container/Ptr.h"
 #include "../Container/ByteVector.h"
+#include "../Container/FlatHashMap.h"
 #include "../Core/TypeTrait.h"
 #include "../Math/Color.h"
 #include "../Math/Matrix3.h"
@@ -37,6 +38,8 @@
 #include "../Math/Rect.h"
 #include "../Math/StringHash.h"
 
+#include <atomic>
+#include <initializer_list>
 #include <typeinfo>
 
 namespace Urho3D
@@ -80,6 +83,7 @@ enum VariantType : unsigned char
 };
 
 class Variant;
+class VariantMap;
 class VectorBuffer;
 
 /// Vector of variants.
@@ -88,9 +92,6 @@ using VariantVector = ea::vector<Variant>;
 /// Vector of strings.
 using StringVector = ea::vector<ea::string>;
 
-/// Map of variants.
-using VariantMap = ea::unordered_map<StringHash, Variant>;
-
 /// Map from string to Variant.
 using StringVariantMap = ea::unordered_map<ea::string, Variant>;
 
@@ -372,12 +373,26 @@ private:
     T value_;
 };
 
-/// Size of variant value. 16 bytes on 32-bit platform, 32 bytes on 64-bit platform.
-static const unsigned VARIANT_VALUE_SIZE = sizeof(void*) * 4;
+/// Size of variant value. Large enough to store Matrix3x4 without allocation.
+static const unsigned VARIANT_VALUE_SIZE = sizeof(Matrix3x4);
 
 /// Checks whether the custom variant type could be stored on stack.
 template <class T> constexpr bool IsCustomTypeOnStack() { return sizeof(CustomVariantValueImpl<T>) <= VARIANT_VALUE_SIZE; }
 
+/// Heap-allocated variant value. Shared between copies of the variant until modified.
+/// Only Matrix4 and VariantMap are shared this way. Strings, buffers, vectors and resource references are copied
+/// together with the variant.
+template <class T> struct VariantSharedValue
+{
+    /// Construct value.
+    template <class... Args> explicit VariantSharedValue(Args&&... args) : value_(ea::forward<Args>(args)...) {}
+
+    /// Number of variants referencing the value.
+    std::atomic<unsigned> refs_{1};
+    /// Value.
+    T value_;
+};
+
 /// Union for the possible variant values. Objects exceeding the VARIANT_VALUE_SIZE are allocated on the heap.
 union VariantValue
 {
@@ -396,15 +411,15 @@ union VariantValue
     IntVector2 intVector2_;
     IntVector3 intVector3_;
     IntRect intRect_;
-    Matrix3* matrix3_;
-    Matrix3x4* matrix3x4_;
-    Matrix4* matrix4_;
+    Matrix3 matrix3_;
+    Matrix3x4 matrix3x4_;
+    VariantSharedValue<Matrix4>* matrix4_;
     Quaternion quaternion_;
     Color color_;
     ea::string string_;
     StringVector stringVector_;
     VariantVector variantVector_;
-    VariantMap* variantMap_;
+    VariantSharedValue<VariantMap>* variantMap_;
     VariantBuffer buffer_;
     ResourceRef resourceRef_;
     ResourceRefList resourceRefList_;
@@ -422,7 +437,7 @@ union VariantValue
     const CustomVariantValue& AsCustomValue() const { return *reinterpret_cast<const CustomVariantValue*>(&storage_[0]); }
 };
 
-// TODO: static_assert(sizeof(VariantValue) == VARIANT_VALUE_SIZE, "Unexpected size of VariantValue");
+static_assert(sizeof(VariantValue) == VARIANT_VALUE_SIZE, "Unexpected size of VariantValue");
 static_assert(sizeof(CustomVariantValueImpl<SharedPtr<RefCounted>>) <= VARIANT_VALUE_SIZE, "SharedPtr<> does not fit into variant.");
 
 /// Variable that supports a fixed set of types.
@@ -651,6 +666,12 @@ public:
         *this = value;
     }
 
+    /// Move-construct from another variant.
+    Variant(Variant&& value) noexcept
+    {
+        *this = ea::move(value);
+    }
+
     /// Destruct.
     ~Variant()
     {
@@ -666,6 +687,9 @@ public:
     /// Assign from another variant.
     Variant& operator =(const Variant& rhs);
 
+    /// Move-assign from another variant.
+    Variant& operator =(Variant&& rhs) noexcept;
+
     /// Assign from an integer.
     Variant& operator =(int rhs)
     {
@@ -838,12 +862,7 @@ public:
     }
 
     /// Assign from a variant map.
-    Variant& operator =(const VariantMap& rhs)
-    {
-        SetType(VAR_VARIANTMAP);
-        *value_.variantMap_ = rhs;
-        return *this;
-    }
+    Variant& operator =(const VariantMap& rhs);
 
     /// Assign from a rect.
     Variant& operator =(const Rect& rhs)
@@ -889,7 +908,7 @@ public:
     Variant& operator =(const Matrix3& rhs)
     {
         SetType(VAR_MATRIX3);
-        *value_.matrix3_ = rhs;
+        value_.matrix3_ = rhs;
         return *this;
     }
 
@@ -897,7 +916,7 @@ public:
     Variant& operator =(const Matrix3x4& rhs)
     {
         SetType(VAR_MATRIX3X4);
-        *value_.matrix3x4_ = rhs;
+        value_.matrix3x4_ = rhs;
         return *this;
     }
 
@@ -905,7 +924,7 @@ public:
     Variant& operator =(const Matrix4& rhs)
     {
         SetType(VAR_MATRIX4);
-        *value_.matrix4_ = rhs;
+        AssignSharedValue(value_.matrix4_, rhs);
         return *this;
     }
 
@@ -1010,10 +1029,7 @@ public:
     }
 
     /// Test for equality with a variant map. To return true, both the type and value must match.
-    bool operator ==(const VariantMap& rhs) const
-    {
-        return type_ == VAR_VARIANTMAP ? *value_.variantMap_ == rhs : false;
-    }
+    bool operator ==(const VariantMap& rhs) const;
 
     /// Test for equality with a rect. To return true, both the type and value must match.
     bool operator ==(const Rect& rhs) const
@@ -1056,19 +1072,19 @@ public:
     /// Test for equality with a Matrix3. To return true, both the type and value must match.
     bool operator ==(const Matrix3& rhs) const
     {
-        return type_ == VAR_MATRIX3 ? *value_.matrix3_ == rhs : false;
+        return type_ == VAR_MATRIX3 ? value_.matrix3_ == rhs : false;
     }
 
     /// Test for equality with a Matrix3x4. To return true, both the type and value must match.
     bool operator ==(const Matrix3x4& rhs) const
     {
-        return type_ == VAR_MATRIX3X4 ? *value_.matrix3x4_ == rhs : false;
+        return type_ == VAR_MATRIX3X4 ? value_.matrix3x4_ == rhs : false;
     }
 
     /// Test for equality with a Matrix4. To return true, both the type and value must match.
     bool operator ==(const Matrix4& rhs) const
     {
-        return type_ == VAR_MATRIX4 ? *value_.matrix4_ == rhs : false;
+        return type_ == VAR_MATRIX4 ? value_.matrix4_->value_ == rhs : false;
     }
 
     /// Test for inequality with another variant.
@@ -1351,10 +1367,7 @@ public:
     }
 
     /// Return a variant map or empty on type mismatch.
-    const VariantMap& GetVariantMap() const
-    {
-        return type_ == VAR_VARIANTMAP ? *value_.variantMap_ : emptyVariantMap;
-    }
+    const VariantMap& GetVariantMap() const;
 
     /// Return a rect or empty on type mismatch.
     const Rect& GetRect() const { return type_ == VAR_RECT ? value_.rect_ : Rect::ZERO; }
@@ -1383,19 +1396,19 @@ public:
     /// Return a Matrix3 or identity on type mismatch.
     const Matrix3& GetMatrix3() const
     {
-        return type_ == VAR_MATRIX3 ? *value_.matrix3_ : Matrix3::IDENTITY;
+        return type_ == VAR_MATRIX3 ? value_.matrix3_ : Matrix3::IDENTITY;
     }
 
     /// Return a Matrix3x4 or identity on type mismatch.
     const Matrix3x4& GetMatrix3x4() const
     {
-        return type_ == VAR_MATRIX3X4 ? *value_.matrix3x4_ : Matrix3x4::IDENTITY;
+        return type_ == VAR_MATRIX3X4 ? value_.matrix3x4_ : Matrix3x4::IDENTITY;
     }
 
     /// Return a Matrix4 or identity on type mismatch.
     const Matrix4& GetMatrix4() const
     {
-        return type_ == VAR_MATRIX4 ? *value_.matrix4_ : Matrix4::IDENTITY;
+        return type_ == VAR_MATRIX4 ? value_.matrix4_->value_ : Matrix4::IDENTITY;
     }
 
     /// Return pointer to custom variant value.
@@ -1462,8 +1475,8 @@ public:
     /// Return a pointer to a modifiable string vector or null on type mismatch.
     StringVector* GetStringVectorPtr() { return type_ == VAR_STRINGVECTOR ? &value_.stringVector_ : nullptr; }
 
-    /// Return a pointer to a modifiable variant map or null on type mismatch.
-    VariantMap* GetVariantMapPtr() { return type_ == VAR_VARIANTMAP ? value_.variantMap_ : nullptr; }
+    /// Return a pointer to a modifiable variant map or null on type mismatch. Makes a copy of the map if it is shared.
+    VariantMap* GetVariantMapPtr();
 
     /// Return a pointer to a modifiable custom variant value or null on type mismatch.
     template <class T> T* GetCustomPtr() { return const_cast<T*>(const_cast<const Variant*>(this)->GetCustomPtr<T>()); }
@@ -1517,6 +1530,36 @@ private:
     /// Set new type and allocate/deallocate memory as necessary.
     void SetType(VariantType newType);
 
+    /// Release reference to shared value, destroy the value if it was the last one.
+    template <class T> static void ReleaseSharedValue(VariantSharedValue<T>* value)
+    {
+        if (value->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete value;
+    }
+    /// Make sure the shared value is referenced only by this variant and return it for modification.
+    template <class T> static T& MakeSharedValueUnique(VariantSharedValue<T>*& value)
+    {
+        if (value->refs_.load(std::memory_order_acquire) != 1)
+        {
+            auto copy = new VariantSharedValue<T>(value->value_);
+            ReleaseSharedValue(value);
+            value = copy;
+        }
+        return value->value_;
+    }
+    /// Assign shared value. Allocates new value instead of copying if the current one is shared.
+    template <class T> static void AssignSharedValue(VariantSharedValue<T>*& value, const T& rhs)
+    {
+        if (value->refs_.load(std::memory_order_acquire) == 1)
+            value->value_ = rhs;
+        else
+        {
+            auto copy = new VariantSharedValue<T>(rhs);
+            ReleaseSharedValue(value);
+            value = copy;
+        }
+    }
+
     /// Variant type.
     VariantType type_ = VAR_NONE;
     /// Variant value.
@@ -1676,7 +1719,313 @@ template <> URHO3D_API Matrix3x4 Variant::Get<Matrix3x4>() const;
 
 template <> URHO3D_API Matrix4 Variant::Get<Matrix4>() const;
 
+/// Map of variants. Elements are kept in insertion order until an element is erased; erasure moves the last element
+/// into the erased position. Small maps are searched linearly by key, larger maps maintain a hash index.
+/// Elements are allocated in blocks and never move: as with hash map, insertion may invalidate iterators but not
+/// references, and erasure invalidates only references to the erased element.
+/// Cleared map keeps its storage, so reused maps (e.g. event data) don't allocate.
+class URHO3D_API VariantMap
+{
+public:
+    using key_type = StringHash;
+    using mapped_type = Variant;
+    using value_type = ea::pair<const StringHash, Variant>;
+    using size_type = unsigned;
+    using difference_type = ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+
+    /// Iterator over elements.
+    template <bool IsConst> class Iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = VariantMap::value_type;
+        using difference_type = ptrdiff_t;
+        using pointer = ea::conditional_t<IsConst, const value_type*, value_type*>;
+        using reference = ea::conditional_t<IsConst, const value_type&, value_type&>;
+
+        /// Construct null.
+        Iterator() = default;
+        /// Construct from mutable iterator.
+        template <bool OtherIsConst, class = ea::enable_if_t<IsConst && !OtherIsConst>>
+        Iterator(const Iterator<OtherIsConst>& other) : slot_(other.slot_) {}    // NOLINT(google-explicit-constructor)
+
+        reference operator *() const { return **slot_; }
+        pointer operator ->() const { return *slot_; }
+        reference operator [](difference_type offset) const { return *slot_[offset]; }
+
+        Iterator& operator ++() { ++slot_; return *this; }
+        Iterator operator ++(int) { Iterator result = *this; ++slot_; return result; }
+        Iterator& operator --() { --slot_; return *this; }
+        Iterator operator --(int) { Iterator result = *this; --slot_; return result; }
+        Iterator& operator +=(difference_type offset) { slot_ += offset; return *this; }
+        Iterator& operator -=(difference_type offset) { slot_ -= offset; return *this; }
+        Iterator operator +(difference_type offset) const { return Iterator(slot_ + offset); }
+        Iterator operator -(difference_type offset) const { return Iterator(slot_ - offset); }
+
+        template <bool OtherIsConst> difference_type operator -(const Iterator<OtherIsConst>& rhs) const { return slot_ - rhs.slot_; }
+        template <bool OtherIsConst> bool operator ==(const Iterator<OtherIsConst>& rhs) const { return slot_ == rhs.slot_; }
+        template <bool OtherIsConst> bool operator !=(const Iterator<OtherIsConst>& rhs) const { return slot_ != rhs.slot_; }
+        template <bool OtherIsConst> bool operator <(const Iterator<OtherIsConst>& rhs) const { return slot_ < rhs.slot_; }
+
+    private:
+        friend class VariantMap;
+        template <bool> friend class Iterator;
+
+        /// Construct from element slot.
+        explicit Iterator(VariantMap::value_type* const* slot) : slot_(slot) {}
+
+        /// Current element slot.
+        VariantMap::value_type* const* slot_{};
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    /// Max number of elements that are searched linearly. Larger maps are indexed by hash.
+    static const unsigned MaxLinearSearchSize = 16;
+    /// Number of elements allocated by first insertion.
+    static const unsigned MinCapacity = 4;
+
+    /// Construct empty.
+    VariantMap() = default;
+    /// Construct from initializer list.
+    VariantMap(std::initializer_list<value_type> list)
+    {
+        reserve(list.size());
+        for (const value_type& element : list)
+            insert(element);
+    }
+    /// Copy-construct.
+    VariantMap(const VariantMap& other) { CopyElements(other); }
+    /// Move-construct.
+    VariantMap(VariantMap&& other) noexcept { swap(other); }
+    /// Destruct.
+    ~VariantMap();
+
+    /// Copy-assign. Keeps storage if there is enough capacity.
+    VariantMap& operator =(const VariantMap& rhs)
+    {
+        if (this != &rhs)
+        {
+            clear();
+            CopyElements(rhs);
+        }
+        return *this;
+    }
+    /// Move-assign.
+    VariantMap& operator =(VariantMap&& rhs) noexcept
+    {
+        VariantMap temp(ea::move(rhs));
+        swap(temp);
+        return *this;
+    }
+
+    /// Test for equality. Order of elements is ignored.
+    bool operator ==(const VariantMap& rhs) const;
+    /// Test for inequality.
+    bool operator !=(const VariantMap& rhs) const { return !(*this == rhs); }
+    /// Return hash value. Order of elements is ignored.
+    unsigned ToHash() const;
+
+    /// Return iterator to the beginning.
+    iterator begin() { return iterator(slots_); }
+    /// Return iterator to the beginning.
+    const_iterator begin() const { return const_iterator(slots_); }
+    /// Return iterator to the beginning.
+    const_iterator cbegin() const { return const_iterator(slots_); }
+    /// Return iterator to the end.
+    iterator end() { return iterator(slots_ + size_); }
+    /// Return iterator to the end.
+    const_iterator end() const { return const_iterator(slots_ + size_); }
+    /// Return iterator to the end.
+    const_iterator cend() const { return const_iterator(slots_ + size_); }
+
+    /// Return number of elements.
+    unsigned size() const { return size_; }
+    /// Return whether the map is empty.
+    bool empty() const { return size_ == 0; }
+    /// Return number of elements that can be stored without allocation.
+    unsigned capacity() const { return capacity_; }
+
+    /// Find element by key.
+    iterator find(StringHash key) { return iterator(slots_ + FindIndex(key)); }
+    /// Find element by key.
+    const_iterator find(StringHash key) const { return const_iterator(slots_ + FindIndex(key)); }
+    /// Return whether the key is present.
+    bool contains(StringHash key) const { return FindIndex(key) != size_; }
+    /// Return number of elements with the key, zero or one.
+    unsigned count(StringHash key) const { return contains(key) ? 1 : 0; }
+
+    /// Return value by key, inserting empty value if missing.
+    Variant& operator [](StringHash key)
+    {
+        const unsigned index = FindIndex(key);
+        if (index != size_)
+            return slots_[index]->second;
+        return EmplaceNew(key)->second;
+    }
+
+    /// Insert value if the key is not present. Return iterator to the element and whether the insertion took place.
+    template <class... Args> ea::pair<iterator, bool> try_emplace(StringHash key, Args&&... args)
+    {
+        const unsigned index = FindIndex(key);
+        if (index != size_)
+            return {iterator(slots_ + index), false};
+        return {EmplaceNew(key, ea::forward<Args>(args)...), true};
+    }
+    /// Insert value if the key is not present. Return iterator to the element and whether the insertion took place.
+    template <class... Args> ea::pair<iterator, bool> emplace(StringHash key, Args&&... args)
+    {
+        return try_emplace(key, ea::forward<Args>(args)...);
+    }
+    /// Insert key-value pair if the key is not present. Return iterator to the element and whether the insertion took place.
+    ea::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+    /// Insert key-value pair if the key is not present. Return iterator to the element and whether the insertion took place.
+    template <class P> ea::pair<iterator, bool> insert(P&& value) { return try_emplace(value.first, ea::forward<P>(value).second); }
+    /// Insert range of key-value pairs. Existing keys are not overwritten.
+    template <class InputIterator> void insert(InputIterator first, InputIterator last)
+    {
+        for (; first != last; ++first)
+            insert(*first);
+    }
+    /// Insert value or assign existing one. Return iterator to the element and whether the insertion took place.
+    template <class T> ea::pair<iterator, bool> insert_or_assign(StringHash key, T&& value)
+    {
+        const unsigned index = FindIndex(key);
+        if (index != size_)
+        {
+            slots_[index]->second = ea::forward<T>(value);
+            return {iterator(slots_ + index), false};
+        }
+        return {EmplaceNew(key, ea::forward<T>(value)), true};
+    }
+    /// Assign values from the list of key-value arguments.
+    template <class... Args> VariantMap& populate(StringHash key, const Variant& value, const Args&... args)
+    {
+        (*this)[key] = value;
+        if constexpr (sizeof...(args) > 0)
+            populate(args...);
+        return *this;
+    }
+
+    /// Erase element. Return iterator to the element that took the place of erased one.
+    iterator erase(const_iterator position)
+    {
+        const auto index = static_cast<unsigned>(position.slot_ - slots_);
+        EraseAt(index);
+        return iterator(slots_ + index);
+    }
+    /// Erase element by key. Return number of erased elements.
+    unsigned erase(StringHash key)
+    {
+        const unsigned index = FindIndex(key);
+        if (index == size_)
+            return 0;
+        EraseAt(index);
+        return 1;
+    }
+
+    /// Remove all elements. Storage is kept.
+    void clear();
+    /// Reserve storage for the number of elements.
+    void reserve(unsigned count);
+    /// Swap with another map.
+    void swap(VariantMap& other) noexcept
+    {
+        ea::swap(blocks_, other.blocks_);
+        ea::swap(keys_, other.keys_);
+        ea::swap(slots_, other.slots_);
+        ea::swap(size_, other.size_);
+        ea::swap(capacity_, other.capacity_);
+        index_.swap(other.index_);
+    }
+
+    /// Return all keys.
+    ea::vector<StringHash> keys() const { return {keys_, keys_ + size_}; }
+    /// Return all values.
+    ea::vector<Variant> values() const;
+
+private:
+    /// Return index of the element by key or size if not found.
+    unsigned FindIndex(StringHash key) const
+    {
+        if (size_ > MaxLinearSearchSize)
+        {
+            const auto iter = index_.find(key);
+            return iter != index_.end() ? iter->second : size_;
+        }
+
+        for (unsigned i = 0; i < size_; ++i)
+        {
+            if (keys_[i] == key)
+                return i;
+        }
+        return size_;
+    }
+
+    /// Construct new element at the end. The key should not be present.
+    template <class... Args> iterator EmplaceNew(StringHash key, Args&&... args)
+    {
+        // Arguments may reference elements of this map, they stay valid because elements don't move
+        if (size_ == capacity_)
+            reserve(size_ + 1);
+
+        new (slots_[size_]) value_type(key, Variant(ea::forward<Args>(args)...));
+        keys_[size_] = key;
+        ++size_;
+        UpdateIndexAfterInsert();
+        return iterator(slots_ + size_ - 1);
+    }
+
+    /// Copy elements of another map. The map should be empty.
+    void CopyElements(const VariantMap& other);
+    /// Update hash index after insertion of the last element.
+    void UpdateIndexAfterInsert();
+    /// Erase element by index.
+    void EraseAt(unsigned index);
+
+    /// Linked list of allocated blocks. Each block contains next block pointer, key and slot arrays, and elements.
+    void* blocks_{};
+    /// Keys, stored separately from elements for faster linear search.
+    StringHash* keys_{};
+    /// Pointers to elements. Slots past the size point to unused elements.
+    value_type** slots_{};
+    /// Number of elements.
+    unsigned size_{};
+    /// Number of allocated elements.
+    unsigned capacity_{};
+    /// Index of elements by key. Used only if there are more than MaxLinearSearchSize elements.
+    FlatHashMap<StringHash, unsigned> index_;
+};
+
 // Implementations
+inline Variant& Variant::operator =(const VariantMap& rhs)
+{
+    // Map may be nested in the current value, so the latter is released only after copying
+    auto value = new VariantSharedValue<VariantMap>(rhs);
+    SetType(VAR_NONE);
+    value_.variantMap_ = value;
+    type_ = VAR_VARIANTMAP;
+    return *this;
+}
+
+inline bool Variant::operator ==(const VariantMap& rhs) const
+{
+    return type_ == VAR_VARIANTMAP ? value_.variantMap_->value_ == rhs : false;
+}
+
+inline const VariantMap& Variant::GetVariantMap() const
+{
+    return type_ == VAR_VARIANTMAP ? value_.variantMap_->value_ : emptyVariantMap;
+}
+
+inline VariantMap* Variant::GetVariantMapPtr()
+{
+    return type_ == VAR_VARIANTMAP ? &MakeSharedValueUnique(value_.variantMap_) : nullptr;
+}
+
 template <class T> const T* CustomVariantValue::GetValuePtr() const
 {
     if (IsType<T>())
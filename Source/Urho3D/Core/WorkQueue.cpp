@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Container/FrameAllocator.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/ProcessUtils.h"
 #include "../Core/Profiler.h"
@@ -120,8 +121,8 @@ SharedPtr<WorkItem> WorkQueue::GetFreeItem()
 {
     if (!poolItems_.empty())
     {
-        SharedPtr<WorkItem> item = poolItems_.front();
-        poolItems_.pop_front();
+        SharedPtr<WorkItem> item = ea::move(poolItems_.back());
+        poolItems_.pop_back();
         return item;
     }
     else
@@ -358,6 +359,8 @@ void WorkQueue::ProcessItems(unsigned threadIndex)
                 WorkItem* item = queue_.front();
                 queue_.pop_front();
                 queueMutex_.Release();
+                // Frame memory of the previous items is not in use anymore
+                ResetFrameArena();
                 item->workFunction_(item, threadIndex);
                 item->completed_ = true;
             }
@@ -405,7 +408,7 @@ void WorkQueue::PurgePool()
 
     // Difference tolerance, should be fairly significant to reduce the pool size.
     for (unsigned i = 0; !poolItems_.empty() && difference > tolerance_ && i < (unsigned)difference; i++)
-        poolItems_.pop_front();
+        poolItems_.pop_back();
 
     lastSize_ = currentSize;
 }
@@ -25,6 +25,7 @@
 #include "../Core/Mutex.h"
 #include "../Core/Object.h"
 #include "../Container/MultiVector.h"
+#include "../Container/PoolAllocator.h"
 
 #include <EASTL/list.h>
 #include <EASTL/span.h>
@@ -48,6 +49,8 @@ struct WorkItem : public RefCounted
     friend class WorkQueue;
 
 public:
+    URHO3D_POOL_ALLOCATION();
+
     /// Work function. Called with the work item and thread index (0 = main thread) as parameters.
     void (* workFunction_)(const WorkItem*, unsigned){};
     /// Data start pointer.
@@ -143,11 +146,11 @@ private:
     /// Worker threads.
     ea::vector<SharedPtr<WorkerThread> > threads_;
     /// Work item pool for reuse to cut down on allocation. The bool is a flag for item pooling and whether it is available or not.
-    ea::list<SharedPtr<WorkItem> > poolItems_;
+    ea::vector<SharedPtr<WorkItem> > poolItems_;
     /// Work item collection. Accessed only by the main thread.
-    ea::list<SharedPtr<WorkItem> > workItems_;
+    ea::list<SharedPtr<WorkItem>, PoolEASTLAllocator> workItems_;
     /// Work item prioritized queue for worker threads. Pointers are guaranteed to be valid (point to workItems).
-    ea::list<WorkItem*> queue_;
+    ea::list<WorkItem*, PoolEASTLAllocator> queue_;
     /// Worker queue mutex.
     Mutex queueMutex_;
     /// Shutting down flag.
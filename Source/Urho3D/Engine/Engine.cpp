@@ -23,6 +23,7 @@
 #include "../Precompiled.h"
 
 #include "../Audio/Audio.h"
+#include "../Container/FrameAllocator.h"
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
@@ -134,6 +135,7 @@ Engine::Engine(Context* context) :
     // Create subsystems which do not depend on engine initialization or startup parameters
     context_->RegisterSubsystem(new Time(context_));
     context_->RegisterSubsystem(new WorkQueue(context_));
+    context_->RegisterSubsystem(new FrameArenaManager(context_));
     context_->RegisterSubsystem(new FileSystem(context_));
 #ifdef URHO3D_LOGGING
     context_->RegisterSubsystem(new Log(context_));
@@ -666,14 +668,14 @@ void Engine::DumpResources(bool dumpFileName)
         return;
 
     auto* cache = GetSubsystem<ResourceCache>();
-    const ea::unordered_map<StringHash, ResourceGroup>& resourceGroups = cache->GetAllResources();
+    const auto& resourceGroups = cache->GetAllResources();
     if (dumpFileName)
     {
         URHO3D_LOGINFO("Used resources:");
         for (auto i = resourceGroups.begin(); i !=
             resourceGroups.end(); ++i)
         {
-            const ea::unordered_map<StringHash, SharedPtr<Resource> >& resources = i->second.resources_;
+            const auto& resources = i->second.resources_;
             if (dumpFileName)
             {
                 for (auto j = resources.begin(); j !=
@@ -1039,6 +1041,8 @@ void Engine::DoExit()
     if (graphics)
         graphics->Close();
 
+    exiting_ = true;
+
 #if defined(__EMSCRIPTEN__) && defined(URHO3D_TESTING)
     emscripten_force_exit(EXIT_SUCCESS);    // Some how this is required to signal emrun to stop
 #endif
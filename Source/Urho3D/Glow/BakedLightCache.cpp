@@ -24,9 +24,202 @@
 
 #include "../Glow/BakedLightCache.h"
 
+#include "../IO/Compression.h"
+#include "../IO/File.h"
+#include "../IO/FileSystem.h"
+#include "../IO/Log.h"
+#include "../IO/VectorBuffer.h"
+
+#include <EASTL/unordered_set.h>
+
 namespace Urho3D
 {
 
+namespace
+{
+
+/// File ID of disk cache item.
+static const char* DiskCacheFileID = "GLWC";
+/// Version of disk cache item format.
+static const unsigned DiskCacheVersion = 1;
+
+/// Write vector of POD values.
+template <class T>
+void WriteVector(Serializer& dest, const ea::vector<T>& values)
+{
+    dest.WriteVLE(values.size());
+    dest.Write(values.data(), values.size() * sizeof(T));
+}
+
+/// Read vector of POD values.
+template <class T>
+bool ReadVector(Deserializer& source, ea::vector<T>& values)
+{
+    const unsigned size = source.ReadVLE();
+    if (source.GetSize() - source.GetPosition() < size * sizeof(T))
+        return false;
+    values.resize(size);
+    return source.Read(values.data(), size * sizeof(T)) == size * sizeof(T);
+}
+
+/// Return size of vector in memory.
+template <class T>
+unsigned long long GetVectorMemorySize(const ea::vector<T>& values)
+{
+    return values.size() * sizeof(T);
+}
+
+/// Serialize geometry buffers of the chunk.
+void WriteItem(Serializer& dest, const BakedSceneChunk& bakedChunk)
+{
+    dest.WriteVLE(bakedChunk.geometryBuffers_.size());
+    for (const LightmapChartGeometryBuffer& geometryBuffer : bakedChunk.geometryBuffers_)
+    {
+        dest.WriteUInt(geometryBuffer.index_);
+        dest.WriteUInt(geometryBuffer.lightmapSize_);
+        WriteVector(dest, geometryBuffer.positions_);
+        WriteVector(dest, geometryBuffer.smoothPositions_);
+        WriteVector(dest, geometryBuffer.smoothNormals_);
+        WriteVector(dest, geometryBuffer.faceNormals_);
+        WriteVector(dest, geometryBuffer.geometryIds_);
+        WriteVector(dest, geometryBuffer.lightMasks_);
+        WriteVector(dest, geometryBuffer.backgroundIds_);
+        WriteVector(dest, geometryBuffer.texelRadiuses_);
+        WriteVector(dest, geometryBuffer.albedo_);
+        WriteVector(dest, geometryBuffer.emission_);
+        WriteVector(dest, geometryBuffer.seams_);
+    }
+}
+
+/// Deserialize geometry buffers of the chunk.
+bool ReadItem(Deserializer& source, BakedSceneChunk& bakedChunk)
+{
+    bakedChunk.geometryBuffers_.resize(source.ReadVLE());
+    for (LightmapChartGeometryBuffer& geometryBuffer : bakedChunk.geometryBuffers_)
+    {
+        geometryBuffer.index_ = source.ReadUInt();
+        geometryBuffer.lightmapSize_ = source.ReadUInt();
+        if (!ReadVector(source, geometryBuffer.positions_)
+            || !ReadVector(source, geometryBuffer.smoothPositions_)
+            || !ReadVector(source, geometryBuffer.smoothNormals_)
+            || !ReadVector(source, geometryBuffer.faceNormals_)
+            || !ReadVector(source, geometryBuffer.geometryIds_)
+            || !ReadVector(source, geometryBuffer.lightMasks_)
+            || !ReadVector(source, geometryBuffer.backgroundIds_)
+            || !ReadVector(source, geometryBuffer.texelRadiuses_)
+            || !ReadVector(source, geometryBuffer.albedo_)
+            || !ReadVector(source, geometryBuffer.emission_)
+            || !ReadVector(source, geometryBuffer.seams_))
+            return false;
+    }
+    return true;
+}
+
+/// Serialize direct light.
+void WriteItem(Serializer& dest, const LightmapChartBakedDirect& bakedDirect)
+{
+    dest.WriteUInt(bakedDirect.lightmapSize_);
+    WriteVector(dest, bakedDirect.directLight_);
+    WriteVector(dest, bakedDirect.surfaceLight_);
+    WriteVector(dest, bakedDirect.albedo_);
+}
+
+/// Deserialize direct light.
+bool ReadItem(Deserializer& source, LightmapChartBakedDirect& bakedDirect)
+{
+    bakedDirect.lightmapSize_ = source.ReadUInt();
+    bakedDirect.realLightmapSize_ = static_cast<float>(bakedDirect.lightmapSize_);
+    return ReadVector(source, bakedDirect.directLight_)
+        && ReadVector(source, bakedDirect.surfaceLight_)
+        && ReadVector(source, bakedDirect.albedo_);
+}
+
+/// Serialize lightmap.
+void WriteItem(Serializer& dest, const BakedLightmap& bakedLightmap)
+{
+    dest.WriteUInt(bakedLightmap.lightmapSize_);
+    WriteVector(dest, bakedLightmap.lightmap_);
+}
+
+/// Deserialize lightmap.
+bool ReadItem(Deserializer& source, BakedLightmap& bakedLightmap)
+{
+    bakedLightmap.lightmapSize_ = source.ReadUInt();
+    return ReadVector(source, bakedLightmap.lightmap_);
+}
+
+/// Return size of geometry buffers in memory.
+unsigned long long GetMemorySize(const BakedSceneChunk& bakedChunk)
+{
+    unsigned long long size = 0;
+    for (const LightmapChartGeometryBuffer& geometryBuffer : bakedChunk.geometryBuffers_)
+    {
+        size += GetVectorMemorySize(geometryBuffer.positions_);
+        size += GetVectorMemorySize(geometryBuffer.smoothPositions_);
+        size += GetVectorMemorySize(geometryBuffer.smoothNormals_);
+        size += GetVectorMemorySize(geometryBuffer.faceNormals_);
+        size += GetVectorMemorySize(geometryBuffer.geometryIds_);
+        size += GetVectorMemorySize(geometryBuffer.lightMasks_);
+        size += GetVectorMemorySize(geometryBuffer.backgroundIds_);
+        size += GetVectorMemorySize(geometryBuffer.texelRadiuses_);
+        size += GetVectorMemorySize(geometryBuffer.albedo_);
+        size += GetVectorMemorySize(geometryBuffer.emission_);
+        size += GetVectorMemorySize(geometryBuffer.seams_);
+    }
+    return size;
+}
+
+/// Return size of direct light in memory.
+unsigned long long GetMemorySize(const LightmapChartBakedDirect& bakedDirect)
+{
+    return GetVectorMemorySize(bakedDirect.directLight_) + GetVectorMemorySize(bakedDirect.surfaceLight_)
+        + GetVectorMemorySize(bakedDirect.albedo_);
+}
+
+/// Return size of lightmap in memory.
+unsigned long long GetMemorySize(const BakedLightmap& bakedLightmap)
+{
+    return GetVectorMemorySize(bakedLightmap.lightmap_);
+}
+
+/// Save item to compressed file.
+template <class T>
+bool SaveItemToFile(Context* context, const ea::string& fileName, const T& data)
+{
+    VectorBuffer buffer;
+    WriteItem(buffer, data);
+    buffer.Seek(0);
+
+    File file(context, fileName, FILE_WRITE);
+    if (!file.IsOpen())
+        return false;
+
+    file.WriteFileID(DiskCacheFileID);
+    file.WriteUInt(DiskCacheVersion);
+    return CompressStream(file, buffer);
+}
+
+/// Load item from compressed file.
+template <class T>
+bool LoadItemFromFile(Context* context, const ea::string& fileName, T& data)
+{
+    File file(context);
+    if (!file.Open(fileName, FILE_READ))
+        return false;
+
+    if (file.ReadFileID() != DiskCacheFileID || file.ReadUInt() != DiskCacheVersion)
+        return false;
+
+    VectorBuffer buffer;
+    if (!DecompressStream(buffer, file))
+        return false;
+
+    buffer.Seek(0);
+    return ReadItem(buffer, data);
+}
+
+}
+
 BakedLightCache::~BakedLightCache() = default;
 
 void BakedLightMemoryCache::StoreBakedChunk(const IntVector3& chunk, BakedSceneChunk bakedChunk)
@@ -62,4 +255,443 @@ ea::shared_ptr<const BakedLightmap> BakedLightMemoryCache::LoadLightmap(unsigned
     return iter != lightmapCache_.end() ? iter->second : nullptr;
 }
 
+BakedLightDiskCache::BakedLightDiskCache(Context* context, const ea::string& cacheDirectory, unsigned long long memoryBudget)
+    : context_(context)
+    , cacheDirectory_(AddTrailingSlash(cacheDirectory))
+    , memoryBudget_(memoryBudget)
+{
+    auto fileSystem = context_->GetSubsystem<FileSystem>();
+    if (!fileSystem->CreateDirsRecursive(cacheDirectory_))
+        URHO3D_LOGERROR("Cannot create light baking cache directory \"{}\"", cacheDirectory_);
+}
+
+BakedLightDiskCache::~BakedLightDiskCache()
+{
+    Flush();
+}
+
+void BakedLightDiskCache::StoreBakedChunk(const IntVector3& chunk, BakedSceneChunk bakedChunk)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    ChunkItem& item = chunks_[chunk];
+    const ItemKey key{ ItemType::ChunkGeometry, chunk };
+
+    auto residentChunk = ea::make_shared<BakedSceneChunk>();
+    residentChunk->lightmaps_ = bakedChunk.lightmaps_;
+    residentChunk->requiredDirectLightmaps_ = bakedChunk.requiredDirectLightmaps_;
+    residentChunk->raytracerScene_ = bakedChunk.raytracerScene_;
+    residentChunk->geometryBufferToRaytracer_ = bakedChunk.geometryBufferToRaytracer_;
+    residentChunk->bakedLights_ = bakedChunk.bakedLights_;
+    residentChunk->lightProbesCollection_ = bakedChunk.lightProbesCollection_;
+    residentChunk->numUniqueLightProbes_ = bakedChunk.numUniqueLightProbes_;
+    item.residentChunk_ = residentChunk;
+
+    const unsigned long long memorySize = GetMemorySize(bakedChunk);
+    item.data_ = ea::make_shared<BakedSceneChunk>(ea::move(bakedChunk));
+    item.dirty_ = true;
+    AddItem(item, key, memorySize);
+    WritePendingItems(lock);
+}
+
+ea::shared_ptr<const BakedSceneChunk> BakedLightDiskCache::LoadBakedChunk(const IntVector3& chunk)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    auto iter = chunks_.find(chunk);
+    if (iter == chunks_.end())
+        return nullptr;
+
+    ChunkItem& item = iter->second;
+    const ItemKey key{ ItemType::ChunkGeometry, chunk };
+    if (item.data_)
+    {
+        TouchItem(item);
+        return item.data_;
+    }
+
+    ea::shared_ptr<const BakedSceneChunk> bakedChunk = RestorePendingItem(item, key);
+    if (!bakedChunk)
+    {
+        auto loadedChunk = ea::make_shared<BakedSceneChunk>(*item.residentChunk_);
+        if (!LoadItemFromFile(context_, GetFileName(key), *loadedChunk))
+        {
+            URHO3D_LOGERROR("Cannot load geometry buffers of chunk {} from light baking cache", chunk.ToString());
+            return nullptr;
+        }
+
+        const unsigned long long memorySize = GetMemorySize(*loadedChunk);
+        item.data_ = loadedChunk;
+        AddItem(item, key, memorySize);
+        bakedChunk = loadedChunk;
+    }
+
+    WritePendingItems(lock);
+    return bakedChunk;
+}
+
+void BakedLightDiskCache::StoreDirectLight(unsigned lightmapIndex, LightmapChartBakedDirect bakedDirect)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    CachedItem<LightmapChartBakedDirect>& item = directLights_[lightmapIndex];
+    const ItemKey key{ ItemType::DirectLight, IntVector3(lightmapIndex, 0, 0) };
+
+    const unsigned long long memorySize = GetMemorySize(bakedDirect);
+    item.data_ = ea::make_shared<LightmapChartBakedDirect>(ea::move(bakedDirect));
+    item.dirty_ = true;
+    AddItem(item, key, memorySize);
+    WritePendingItems(lock);
+}
+
+ea::shared_ptr<const LightmapChartBakedDirect> BakedLightDiskCache::LoadDirectLight(unsigned lightmapIndex)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    CachedItem<LightmapChartBakedDirect>& item = directLights_[lightmapIndex];
+    const ItemKey key{ ItemType::DirectLight, IntVector3(lightmapIndex, 0, 0) };
+    if (item.data_)
+    {
+        TouchItem(item);
+        return item.data_;
+    }
+
+    ea::shared_ptr<const LightmapChartBakedDirect> bakedDirect = RestorePendingItem(item, key);
+    if (!bakedDirect)
+    {
+        auto loadedDirect = ea::make_shared<LightmapChartBakedDirect>();
+        if (!LoadItemFromFile(context_, GetFileName(key), *loadedDirect))
+        {
+            directLights_.erase(lightmapIndex);
+            return nullptr;
+        }
+
+        const unsigned long long memorySize = GetMemorySize(*loadedDirect);
+        item.data_ = loadedDirect;
+        AddItem(item, key, memorySize);
+        bakedDirect = loadedDirect;
+    }
+
+    WritePendingItems(lock);
+    return bakedDirect;
+}
+
+void BakedLightDiskCache::StoreLightmap(unsigned lightmapIndex, BakedLightmap bakedLightmap)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    CachedItem<BakedLightmap>& item = lightmaps_[lightmapIndex];
+    const ItemKey key{ ItemType::Lightmap, IntVector3(lightmapIndex, 0, 0) };
+
+    const unsigned long long memorySize = GetMemorySize(bakedLightmap);
+    item.data_ = ea::make_shared<BakedLightmap>(ea::move(bakedLightmap));
+    item.dirty_ = true;
+    AddItem(item, key, memorySize);
+    WritePendingItems(lock);
+}
+
+ea::shared_ptr<const BakedLightmap> BakedLightDiskCache::LoadLightmap(unsigned lightmapIndex)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    CachedItem<BakedLightmap>& item = lightmaps_[lightmapIndex];
+    const ItemKey key{ ItemType::Lightmap, IntVector3(lightmapIndex, 0, 0) };
+    if (item.data_)
+    {
+        TouchItem(item);
+        return item.data_;
+    }
+
+    ea::shared_ptr<const BakedLightmap> bakedLightmap = RestorePendingItem(item, key);
+    if (!bakedLightmap)
+    {
+        auto loadedLightmap = ea::make_shared<BakedLightmap>();
+        if (!LoadItemFromFile(context_, GetFileName(key), *loadedLightmap))
+        {
+            lightmaps_.erase(lightmapIndex);
+            return nullptr;
+        }
+
+        const unsigned long long memorySize = GetMemorySize(*loadedLightmap);
+        item.data_ = loadedLightmap;
+        AddItem(item, key, memorySize);
+        bakedLightmap = loadedLightmap;
+    }
+
+    WritePendingItems(lock);
+    return bakedLightmap;
+}
+
+void BakedLightDiskCache::SetLightmapInputHash(unsigned lightmapIndex, unsigned hash)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // Data of another input is not reused
+    const auto iter = lightmapInputHashes_.find(lightmapIndex);
+    if (iter != lightmapInputHashes_.end() && iter->second == hash)
+        return;
+
+    lightmapInputHashes_[lightmapIndex] = hash;
+    RemoveItem(directLights_, lightmapIndex);
+    RemoveItem(lightmaps_, lightmapIndex);
+}
+
+void BakedLightDiskCache::Flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    for (auto& [chunk, item] : chunks_)
+        ScheduleWrite(item, ItemKey{ ItemType::ChunkGeometry, chunk }, item.data_);
+    for (auto& [lightmapIndex, item] : directLights_)
+        ScheduleWrite(item, ItemKey{ ItemType::DirectLight, IntVector3(lightmapIndex, 0, 0) }, item.data_);
+    for (auto& [lightmapIndex, item] : lightmaps_)
+        ScheduleWrite(item, ItemKey{ ItemType::Lightmap, IntVector3(lightmapIndex, 0, 0) }, item.data_);
+
+    WritePendingItems(lock);
+
+    // Remove files of previous bakes that weren't reused
+    const ea::unordered_set<ea::string> currentFiles = GetItemFileNames();
+    lock.unlock();
+
+    auto fileSystem = context_->GetSubsystem<FileSystem>();
+    ea::vector<ea::string> files;
+    fileSystem->ScanDir(files, cacheDirectory_, "*.bin", SCAN_FILES, false);
+    for (const ea::string& file : files)
+    {
+        const ea::string fileName = cacheDirectory_ + file;
+        if (currentFiles.find(fileName) == currentFiles.end())
+            fileSystem->Delete(fileName);
+    }
+}
+
+unsigned long long BakedLightDiskCache::GetMemoryUse() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return memoryUse_;
+}
+
+unsigned BakedLightDiskCache::GetNumSpilledItems() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return numSpilledItems_;
+}
+
+ea::string BakedLightDiskCache::GetFileName(const ItemKey& key) const
+{
+    switch (key.type_)
+    {
+    case ItemType::ChunkGeometry:
+        return Format("{}Chunk-{}-{}-{}.bin", cacheDirectory_, key.index_.x_, key.index_.y_, key.index_.z_);
+    case ItemType::DirectLight:
+    case ItemType::Lightmap:
+    default:
+    {
+        const auto iter = lightmapInputHashes_.find(key.index_.x_);
+        const unsigned hash = iter != lightmapInputHashes_.end() ? iter->second : 0;
+        const char* prefix = key.type_ == ItemType::DirectLight ? "Direct" : "Lightmap";
+        return Format("{}{}-{}-{:08x}.bin", cacheDirectory_, prefix, key.index_.x_, hash);
+    }
+    }
+}
+
+template <class T>
+void BakedLightDiskCache::TouchItem(CachedItem<T>& item)
+{
+    recentItems_.splice(recentItems_.begin(), recentItems_, item.lruIterator_);
+}
+
+template <class T>
+void BakedLightDiskCache::AddItem(CachedItem<T>& item, const ItemKey& key, unsigned long long memorySize)
+{
+    // Item may be overwritten while in memory
+    if (item.resident_)
+    {
+        memoryUse_ -= item.memorySize_;
+        recentItems_.erase(item.lruIterator_);
+    }
+
+    item.resident_ = true;
+    item.memorySize_ = memorySize;
+    item.lruIterator_ = recentItems_.insert(recentItems_.begin(), key);
+    memoryUse_ += memorySize;
+
+    ReleaseItems();
+}
+
+template <class T>
+ea::shared_ptr<const T> BakedLightDiskCache::RestorePendingItem(CachedItem<T>& item, const ItemKey& key)
+{
+    if (!item.pendingData_)
+        return nullptr;
+
+    // Item stays dirty until the scheduled write is completed
+    item.data_ = item.pendingData_;
+    AddItem(item, key, GetMemorySize(*item.data_));
+    return item.pendingData_;
+}
+
+void BakedLightDiskCache::ReleaseItems()
+{
+    while (memoryUse_ > memoryBudget_ && recentItems_.size() > 1)
+    {
+        const ItemKey key = recentItems_.back();
+        switch (key.type_)
+        {
+        case ItemType::ChunkGeometry:
+            ReleaseItem(chunks_[key.index_], key);
+            break;
+        case ItemType::DirectLight:
+            ReleaseItem(directLights_[key.index_.x_], key);
+            break;
+        case ItemType::Lightmap:
+            ReleaseItem(lightmaps_[key.index_.x_], key);
+            break;
+        }
+    }
+}
+
+template <class T>
+void BakedLightDiskCache::RemoveItem(ea::unordered_map<unsigned, CachedItem<T>>& items, unsigned lightmapIndex)
+{
+    const auto iter = items.find(lightmapIndex);
+    if (iter == items.end())
+        return;
+
+    CachedItem<T>& item = iter->second;
+    if (item.resident_)
+    {
+        memoryUse_ -= item.memorySize_;
+        recentItems_.erase(item.lruIterator_);
+    }
+    items.erase(iter);
+}
+
+template <class T>
+void BakedLightDiskCache::ReleaseItem(CachedItem<T>& item, const ItemKey& key)
+{
+    if (item.dirty_)
+    {
+        item.pendingData_ = item.data_;
+        ScheduleWrite(item, key, item.data_);
+    }
+
+    memoryUse_ -= item.memorySize_;
+    recentItems_.erase(item.lruIterator_);
+    item.resident_ = false;
+    item.memorySize_ = 0;
+    item.data_ = nullptr;
+}
+
+template <class T>
+void BakedLightDiskCache::ScheduleWrite(CachedItem<T>& item, const ItemKey& key, const ea::shared_ptr<const T>& data)
+{
+    if (!item.dirty_ || !data)
+        return;
+
+    PendingWrite& pendingWrite = pendingWrites_.push_back();
+    pendingWrite.key_ = key;
+    pendingWrite.fileName_ = GetFileName(key);
+    pendingWrite.data_ = data;
+    pendingWrite.save_ = [context = context_, fileName = pendingWrite.fileName_, data]()
+    {
+        return SaveItemToFile(context, fileName, *data);
+    };
+}
+
+void BakedLightDiskCache::WritePendingItems(std::unique_lock<std::mutex>& lock)
+{
+    if (pendingWrites_.empty())
+        return;
+
+    // Only one thread writes at a time, so the file of each item is written in the order of scheduling
+    lock.unlock();
+    std::unique_lock<std::mutex> writeLock(writeMutex_);
+    lock.lock();
+
+    while (!pendingWrites_.empty())
+    {
+        PendingWrite pendingWrite = ea::move(pendingWrites_.front());
+        pendingWrites_.pop_front();
+
+        lock.unlock();
+        const bool saved = pendingWrite.save_();
+        lock.lock();
+
+        if (!saved)
+            URHO3D_LOGERROR("Cannot save light baking cache item \"{}\"", pendingWrite.fileName_);
+
+        const ItemKey& key = pendingWrite.key_;
+        switch (key.type_)
+        {
+        case ItemType::ChunkGeometry:
+        {
+            const auto iter = chunks_.find(key.index_);
+            if (iter != chunks_.end())
+                CompleteWrite(iter->second, pendingWrite, saved);
+            break;
+        }
+        case ItemType::DirectLight:
+        {
+            const auto iter = directLights_.find(key.index_.x_);
+            if (iter != directLights_.end())
+                CompleteWrite(iter->second, pendingWrite, saved);
+            break;
+        }
+        case ItemType::Lightmap:
+        {
+            const auto iter = lightmaps_.find(key.index_.x_);
+            if (iter != lightmaps_.end())
+                CompleteWrite(iter->second, pendingWrite, saved);
+            break;
+        }
+        }
+    }
+}
+
+template <class T>
+void BakedLightDiskCache::CompleteWrite(CachedItem<T>& item, const PendingWrite& pendingWrite, bool saved)
+{
+    // Item may be overwritten or reset while the file is written
+    if (pendingWrite.fileName_ != GetFileName(pendingWrite.key_))
+        return;
+
+    const auto data = ea::static_pointer_cast<const T>(pendingWrite.data_);
+    if (item.pendingData_ == data)
+        item.pendingData_ = nullptr;
+
+    if (saved)
+    {
+        if (!item.data_ || item.data_ == data)
+            item.dirty_ = false;
+        ++numSpilledItems_;
+    }
+    else if (!item.data_ && !item.pendingData_)
+    {
+        // Don't lose the data, keep it in memory as least recently used item
+        item.data_ = data;
+        item.resident_ = true;
+        item.memorySize_ = GetMemorySize(*data);
+        item.lruIterator_ = recentItems_.insert(recentItems_.end(), pendingWrite.key_);
+        memoryUse_ += item.memorySize_;
+    }
+}
+
+ea::unordered_set<ea::string> BakedLightDiskCache::GetItemFileNames() const
+{
+    ea::unordered_set<ea::string> currentFiles;
+    for (const auto& [chunk, item] : chunks_)
+        currentFiles.insert(GetFileName(ItemKey{ ItemType::ChunkGeometry, chunk }));
+    for (const auto& [lightmapIndex, hash] : lightmapInputHashes_)
+    {
+        currentFiles.insert(GetFileName(ItemKey{ ItemType::DirectLight, IntVector3(lightmapIndex, 0, 0) }));
+        currentFiles.insert(GetFileName(ItemKey{ ItemType::Lightmap, IntVector3(lightmapIndex, 0, 0) }));
+    }
+    for (const auto& [lightmapIndex, item] : directLights_)
+        currentFiles.insert(GetFileName(ItemKey{ ItemType::DirectLight, IntVector3(lightmapIndex, 0, 0) }));
+    for (const auto& [lightmapIndex, item] : lightmaps_)
+        currentFiles.insert(GetFileName(ItemKey{ ItemType::Lightmap, IntVector3(lightmapIndex, 0, 0) }));
+
+    return currentFiles;
+}
+
 }
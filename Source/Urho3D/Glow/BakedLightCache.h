@@ -32,7 +32,12 @@
 #include "../Graphics/LightProbeGroup.h"
 #include "../Math/Vector3.h"
 
+#include <EASTL/functional.h>
+#include <EASTL/list.h>
 #include <EASTL/shared_ptr.h>
+#include <EASTL/unordered_set.h>
+
+#include <mutex>
 
 namespace Urho3D
 {
@@ -75,6 +80,9 @@ public:
     virtual void StoreLightmap(unsigned lightmapIndex, BakedLightmap bakedLightmap) = 0;
     /// Load baked lightmap.
     virtual ea::shared_ptr<const BakedLightmap> LoadLightmap(unsigned lightmapIndex) = 0;
+
+    /// Set hash of the input the lightmap chart is baked from. Data of the chart is reused only if the hash matches.
+    virtual void SetLightmapInputHash(unsigned lightmapIndex, unsigned hash) = 0;
 };
 
 /// Memory lightmap cache.
@@ -96,6 +104,9 @@ public:
     /// Load baked lightmap.
     ea::shared_ptr<const BakedLightmap> LoadLightmap(unsigned lightmapIndex) override;
 
+    /// Memory cache is not reused, input hash is ignored.
+    void SetLightmapInputHash(unsigned lightmapIndex, unsigned hash) override {}
+
 private:
     /// Baking contexts cache.
     ea::unordered_map<IntVector3, ea::shared_ptr<const BakedSceneChunk>> bakedChunkCache_;
@@ -105,4 +116,160 @@ private:
     ea::unordered_map<unsigned, ea::shared_ptr<const BakedLightmap>> lightmapCache_;
 };
 
+/// Disk lightmap cache. Recently used data is kept in memory within the memory budget,
+/// the rest is spilled to compressed files in the cache directory.
+/// Raytracer scenes of baked chunks are always kept in memory, only geometry buffers are spilled.
+/// Direct light and lightmaps stored by previous bakes are loaded from the cache directory on demand,
+/// files are named by lightmap index and input hash so the data of changed charts is never reused.
+/// Files are compressed and written outside of the cache lock. Safe to use from multiple threads.
+class URHO3D_API BakedLightDiskCache : public BakedLightCache
+{
+public:
+    /// Construct with cache directory and memory budget in bytes.
+    BakedLightDiskCache(Context* context, const ea::string& cacheDirectory, unsigned long long memoryBudget);
+    /// Destruct.
+    ~BakedLightDiskCache() override;
+
+    /// Store baked scene chunk in the cache.
+    void StoreBakedChunk(const IntVector3& chunk, BakedSceneChunk bakedChunk) override;
+    /// Load baked scene chunk.
+    ea::shared_ptr<const BakedSceneChunk> LoadBakedChunk(const IntVector3& chunk) override;
+
+    /// Store direct light for the lightmap chart.
+    void StoreDirectLight(unsigned lightmapIndex, LightmapChartBakedDirect bakedDirect) override;
+    /// Load direct light for the lightmap chart.
+    ea::shared_ptr<const LightmapChartBakedDirect> LoadDirectLight(unsigned lightmapIndex) override;
+
+    /// Store baked lightmap.
+    void StoreLightmap(unsigned lightmapIndex, BakedLightmap bakedLightmap) override;
+    /// Load baked lightmap.
+    ea::shared_ptr<const BakedLightmap> LoadLightmap(unsigned lightmapIndex) override;
+
+    /// Set hash of the input the lightmap chart is baked from.
+    void SetLightmapInputHash(unsigned lightmapIndex, unsigned hash) override;
+
+    /// Write all data kept in memory to disk and remove outdated files. Called on destruction.
+    void Flush();
+
+    /// Return cache directory.
+    const ea::string& GetCacheDirectory() const { return cacheDirectory_; }
+    /// Return memory budget in bytes.
+    unsigned long long GetMemoryBudget() const { return memoryBudget_; }
+    /// Return size of data kept in memory, in bytes.
+    unsigned long long GetMemoryUse() const;
+    /// Return number of items written to disk.
+    unsigned GetNumSpilledItems() const;
+
+private:
+    /// Type of cached item.
+    enum class ItemType
+    {
+        ChunkGeometry,
+        DirectLight,
+        Lightmap
+    };
+
+    /// Key of cached item. Lightmap index is stored in x component.
+    struct ItemKey
+    {
+        /// Item type.
+        ItemType type_{};
+        /// Chunk or lightmap index.
+        IntVector3 index_;
+
+        /// Compare.
+        bool operator==(const ItemKey& rhs) const { return type_ == rhs.type_ && index_ == rhs.index_; }
+    };
+
+    /// Cached item.
+    template <class T>
+    struct CachedItem
+    {
+        /// Data. May be null if spilled to disk.
+        ea::shared_ptr<const T> data_;
+        /// Data released from memory and not written to disk yet.
+        ea::shared_ptr<const T> pendingData_;
+        /// Size of data in memory.
+        unsigned long long memorySize_{};
+        /// Whether the data is in memory and in the list of recently used items.
+        bool resident_{};
+        /// Whether the data on disk is outdated.
+        bool dirty_{};
+        /// Position in the list of recently used items.
+        ea::list<ItemKey>::iterator lruIterator_;
+    };
+
+    /// Resident part of the baked chunk and geometry buffers, if in memory.
+    struct ChunkItem : public CachedItem<BakedSceneChunk>
+    {
+        /// Baked chunk without geometry buffers.
+        ea::shared_ptr<const BakedSceneChunk> residentChunk_;
+    };
+
+    /// Item data scheduled to be written to disk.
+    struct PendingWrite
+    {
+        /// Item key.
+        ItemKey key_;
+        /// File name.
+        ea::string fileName_;
+        /// Data.
+        ea::shared_ptr<const void> data_;
+        /// Write data to file.
+        ea::function<bool()> save_;
+    };
+
+    /// Return file name for the item.
+    ea::string GetFileName(const ItemKey& key) const;
+    /// Mark item as recently used.
+    template <class T> void TouchItem(CachedItem<T>& item);
+    /// Add item to memory and release least recently used items if over budget.
+    template <class T> void AddItem(CachedItem<T>& item, const ItemKey& key, unsigned long long memorySize);
+    /// Return data that is released from memory but not written yet, and add it back to memory.
+    template <class T> ea::shared_ptr<const T> RestorePendingItem(CachedItem<T>& item, const ItemKey& key);
+    /// Release items from memory until memory use fits the budget. Most recently used item is kept.
+    void ReleaseItems();
+    /// Schedule item write if dirty and release it from memory.
+    template <class T> void ReleaseItem(CachedItem<T>& item, const ItemKey& key);
+    /// Schedule item write if dirty.
+    template <class T> void ScheduleWrite(CachedItem<T>& item, const ItemKey& key, const ea::shared_ptr<const T>& data);
+    /// Write scheduled items to disk. Cache lock is released while writing.
+    void WritePendingItems(std::unique_lock<std::mutex>& lock);
+    /// Update item after the write. Item is kept in memory if the write failed.
+    template <class T> void CompleteWrite(CachedItem<T>& item, const PendingWrite& pendingWrite, bool saved);
+    /// Remove lightmap item from memory.
+    template <class T> void RemoveItem(ea::unordered_map<unsigned, CachedItem<T>>& items, unsigned lightmapIndex);
+    /// Return names of files that belong to current items.
+    ea::unordered_set<ea::string> GetItemFileNames() const;
+
+    /// Context.
+    Context* context_{};
+    /// Cache directory.
+    ea::string cacheDirectory_;
+    /// Memory budget.
+    unsigned long long memoryBudget_{};
+
+    /// Mutex for cache access.
+    mutable std::mutex mutex_;
+    /// Mutex that serializes file writes, so each file is written in order. Locked before mutex_.
+    std::mutex writeMutex_;
+    /// Items scheduled to be written.
+    ea::list<PendingWrite> pendingWrites_;
+    /// Input hashes of lightmap charts.
+    ea::unordered_map<unsigned, unsigned> lightmapInputHashes_;
+    /// Size of data in memory.
+    unsigned long long memoryUse_{};
+    /// Number of items written to disk.
+    unsigned numSpilledItems_{};
+    /// Keys of items in memory, most recently used first.
+    ea::list<ItemKey> recentItems_;
+
+    /// Baked chunks.
+    ea::unordered_map<IntVector3, ChunkItem> chunks_;
+    /// Direct light.
+    ea::unordered_map<unsigned, CachedItem<LightmapChartBakedDirect>> directLights_;
+    /// Baked lightmaps.
+    ea::unordered_map<unsigned, CachedItem<BakedLightmap>> lightmaps_;
+};
+
 }
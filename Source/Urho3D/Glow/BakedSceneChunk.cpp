@@ -27,11 +27,21 @@
 #include "../Glow/Helpers.h"
 #include "../Glow/LightTracer.h"
 #include "../Graphics/Drawable.h"
+#include "../Graphics/Material.h"
+#include "../Graphics/Model.h"
+#include "../Graphics/StaticModel.h"
+#include "../Graphics/Technique.h"
 #include "../Graphics/Terrain.h"
 #include "../Graphics/TerrainPatch.h"
 #include "../Graphics/Zone.h"
+#include "../Graphics/IndexBuffer.h"
+#include "../Graphics/VertexBuffer.h"
+#include "../IO/File.h"
 #include "../IO/Log.h"
+#include "../Resource/ResourceCache.h"
+#include "../Scene/Node.h"
 
+#include <EASTL/algorithm.h>
 #include <EASTL/sort.h>
 
 namespace Urho3D
@@ -203,6 +213,217 @@ ea::vector<unsigned> CollectLightmapsRequiredForChunk(const ea::vector<Raytracer
     return ea::vector<unsigned>(requiredDirectLightmaps.begin(), requiredDirectLightmaps.end());
 }
 
+/// Calculate hash of attributes saved to file.
+unsigned CalculateAttributesHash(const Serializable* serializable)
+{
+    unsigned hash = serializable->GetType().Value();
+    const ea::vector<AttributeInfo>* attributes = serializable->GetAttributes();
+    if (!attributes)
+        return hash;
+
+    for (unsigned i = 0; i < attributes->size(); ++i)
+    {
+        if (!attributes->at(i).ShouldSave())
+            continue;
+
+        // Pointers and custom values cannot be hashed persistently
+        const Variant value = serializable->GetAttribute(i);
+        const VariantType type = value.GetType();
+        if (type == VAR_PTR || type == VAR_VOIDPTR || type == VAR_CUSTOM)
+            continue;
+
+        CombineHash(hash, value.ToHash());
+    }
+    return hash;
+}
+
+/// Calculate hash of resource file contents. Resources without file, e.g. created in code, are hashed by name.
+unsigned CalculateResourceFileHash(const Resource* resource, ResourceContentHashes& contentHashes)
+{
+    if (!resource)
+        return 0;
+
+    const auto iter = contentHashes.find(resource);
+    if (iter != contentHashes.end())
+        return iter->second;
+
+    auto cache = resource->GetSubsystem<ResourceCache>();
+    const SharedPtr<File> file = cache ? cache->GetFile(resource->GetName(), false) : nullptr;
+    const unsigned hash = file ? file->GetChecksum() : MakeHash(resource->GetName());
+    contentHashes[resource] = hash;
+    return hash;
+}
+
+/// Calculate hash of model vertex and index data.
+unsigned CalculateModelHash(const Model* model, ResourceContentHashes& contentHashes)
+{
+    if (!model)
+        return 0;
+
+    const auto iter = contentHashes.find(model);
+    if (iter != contentHashes.end())
+        return iter->second;
+
+    // Buffers without CPU copy cannot be read back, hash the file instead
+    const auto hasShadowData = [](const auto& buffer) { return buffer && buffer->GetShadowData(); };
+    const auto& vertexBuffers = model->GetVertexBuffers();
+    const auto& indexBuffers = model->GetIndexBuffers();
+    if (!ea::all_of(vertexBuffers.begin(), vertexBuffers.end(), hasShadowData)
+        || !ea::all_of(indexBuffers.begin(), indexBuffers.end(), hasShadowData))
+        return CalculateResourceFileHash(model, contentHashes);
+
+    unsigned hash = 0;
+    for (const VertexBuffer* vertexBuffer : vertexBuffers)
+    {
+        const unsigned dataSize = vertexBuffer->GetVertexCount() * vertexBuffer->GetVertexSize();
+        hash = StringHash::Calculate(vertexBuffer->GetShadowData(), dataSize, hash);
+    }
+    for (const IndexBuffer* indexBuffer : indexBuffers)
+    {
+        const unsigned dataSize = indexBuffer->GetIndexCount() * indexBuffer->GetIndexSize();
+        hash = StringHash::Calculate(indexBuffer->GetShadowData(), dataSize, hash);
+    }
+
+    contentHashes[model] = hash;
+    return hash;
+}
+
+/// Calculate hash of material properties affecting baked light.
+unsigned CalculateMaterialHash(const Material* material, ResourceContentHashes& contentHashes)
+{
+    if (!material)
+        return 0;
+
+    unsigned hash = MakeHash(material->GetName());
+    for (const TechniqueEntry& entry : material->GetTechniques())
+    {
+        if (entry.technique_)
+            CombineHash(hash, MakeHash(entry.technique_->GetName()));
+    }
+
+    // Unordered containers are hashed order-independently
+    unsigned texturesHash = 0;
+    for (const auto& [unit, texture] : material->GetTextures())
+    {
+        const unsigned textureHash = texture
+            ? MakeHash(texture->GetName()) * 31 + CalculateResourceFileHash(texture, contentHashes) : 0;
+        texturesHash += MakeHash(static_cast<unsigned>(unit)) * 31 + textureHash;
+    }
+    CombineHash(hash, texturesHash);
+
+    unsigned parametersHash = 0;
+    for (const auto& [nameHash, parameter] : material->GetShaderParameters())
+        parametersHash += nameHash.Value() * 31 + parameter.value_.ToHash();
+    CombineHash(hash, parametersHash);
+
+    return hash;
+}
+
+/// Calculate hash of component and its placement.
+unsigned CalculateComponentHash(const Component* component, ResourceContentHashes& contentHashes)
+{
+    unsigned hash = CalculateAttributesHash(component);
+    if (Node* node = component->GetNode())
+        CombineHash(hash, MakeHash(node->GetWorldTransform()));
+
+    if (auto staticModel = dynamic_cast<const StaticModel*>(component))
+    {
+        if (Model* model = staticModel->GetModel())
+        {
+            const BoundingBox& boundingBox = model->GetBoundingBox();
+            CombineHash(hash, MakeHash(boundingBox.min_));
+            CombineHash(hash, MakeHash(boundingBox.max_));
+            CombineHash(hash, CalculateModelHash(model, contentHashes));
+        }
+        for (unsigned i = 0; i < staticModel->GetNumGeometries(); ++i)
+            CombineHash(hash, CalculateMaterialHash(staticModel->GetMaterial(i), contentHashes));
+    }
+    else if (auto terrain = dynamic_cast<const Terrain*>(component))
+    {
+        CombineHash(hash, CalculateResourceFileHash(terrain->GetHeightMap(), contentHashes));
+        CombineHash(hash, CalculateMaterialHash(terrain->GetMaterial(), contentHashes));
+    }
+
+    return hash;
+}
+
+/// Calculate order-independent hash of components.
+template <class T>
+unsigned CalculateComponentsHash(const ea::vector<T*>& components, ResourceContentHashes& contentHashes)
+{
+    unsigned hash = components.size();
+    for (const T* component : components)
+        hash += CalculateComponentHash(component, contentHashes);
+    return hash;
+}
+
+/// Calculate hash of scene backgrounds.
+unsigned CalculateBackgroundsHash(const BakedSceneBackgroundArrayPtr& backgrounds, ResourceContentHashes& contentHashes)
+{
+    unsigned hash = 0;
+    if (!backgrounds)
+        return hash;
+
+    for (const BakedSceneBackground& background : *backgrounds)
+    {
+        CombineHash(hash, MakeHash(background.intensity_));
+        CombineHash(hash, MakeHash(background.color_));
+        CombineHash(hash, background.image_ ? MakeHash(background.image_->GetName()) : 0);
+        CombineHash(hash, CalculateResourceFileHash(background.image_, contentHashes));
+    }
+    return hash;
+}
+
+/// Calculate hash of settings affecting baked light.
+unsigned CalculateSettingsHash(const LightBakingSettings& settings)
+{
+    unsigned hash = 0;
+    CombineHash(hash, settings.charting_.lightmapSize_);
+    CombineHash(hash, MakeHash(settings.charting_.texelDensity_));
+    CombineHash(hash, settings.geometryBufferBaking_.uvChannel_);
+    CombineHash(hash, settings.directChartTracing_.maxSamples_);
+    CombineHash(hash, settings.directProbesTracing_.maxSamples_);
+    CombineHash(hash, settings.indirectChartTracing_.maxSamples_);
+    CombineHash(hash, settings.indirectChartTracing_.maxBounces_);
+    CombineHash(hash, settings.indirectProbesTracing_.maxSamples_);
+    CombineHash(hash, settings.indirectProbesTracing_.maxBounces_);
+    CombineHash(hash, settings.directFilter_.kernelRadius_);
+    CombineHash(hash, settings.indirectFilter_.kernelRadius_);
+    CombineHash(hash, settings.stitching_.numIterations_);
+    CombineHash(hash, MakeHash(settings.properties_.emissionBrightness_));
+    CombineHash(hash, MakeHash(settings.incremental_.indirectPadding_));
+    CombineHash(hash, MakeHash(settings.incremental_.directionalLightShadowDistance_));
+    return hash;
+}
+
+}
+
+unsigned CalculateBakedSceneChunkHash(BakedSceneCollector& collector, const IntVector3& chunk,
+    unsigned baseLightmapIndex, unsigned numLightmaps, const LightBakingSettings& settings,
+    ResourceContentHashes& contentHashes)
+{
+    const ea::vector<Component*> uniqueGeometries = collector.GetUniqueGeometries(chunk);
+    const ea::vector<LightProbeGroup*> uniqueLightProbeGroups = collector.GetUniqueLightProbeGroups(chunk);
+
+    const ea::vector<Light*> lightsInChunk = CollectLightsInChunk(collector, chunk);
+    const ea::vector<LightProbeGroup*> lightProbeGroupsInChunk = CollectLightProbeGroupsInChunk(
+        collector, chunk, uniqueLightProbeGroups);
+
+    // Geometries in chunk include shadow casters and neighbors within indirect padding
+    const ea::vector<Component*> geometriesInChunk = CollectGeometriesInChunk(
+        collector, chunk, uniqueGeometries, lightsInChunk,
+        settings.incremental_.directionalLightShadowDistance_, settings.incremental_.indirectPadding_);
+
+    unsigned hash = MakeHash(chunk);
+    CombineHash(hash, baseLightmapIndex);
+    CombineHash(hash, numLightmaps);
+    CombineHash(hash, CalculateSettingsHash(settings));
+    CombineHash(hash, CalculateComponentsHash(uniqueGeometries, contentHashes));
+    CombineHash(hash, CalculateComponentsHash(geometriesInChunk, contentHashes));
+    CombineHash(hash, CalculateComponentsHash(lightsInChunk, contentHashes));
+    CombineHash(hash, CalculateComponentsHash(lightProbeGroupsInChunk, contentHashes));
+    CombineHash(hash, CalculateBackgroundsHash(collector.GetBackgrounds(), contentHashes));
+    return hash;
 }
 
 BakedSceneChunk CreateBakedSceneChunk(Context* context,
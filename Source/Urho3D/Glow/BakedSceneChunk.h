@@ -30,6 +30,8 @@
 #include "../Glow/RaytracerScene.h"
 #include "../Graphics/LightProbeGroup.h"
 
+#include <EASTL/unordered_map.h>
+
 namespace Urho3D
 {
 
@@ -65,6 +67,16 @@ struct BakedSceneChunk
     unsigned numUniqueLightProbes_{};
 };
 
+/// Hashes of resource contents. Shared between chunks so each resource is hashed once per bake.
+using ResourceContentHashes = ea::unordered_map<const Resource*, unsigned>;
+
+/// Calculate hash of everything that affects light baked for given chunk:
+/// geometries, materials, lights, light probes and geometries of neighbors within shadow and indirect distance,
+/// as well as lightmaps owned by the chunk.
+URHO3D_API unsigned CalculateBakedSceneChunkHash(BakedSceneCollector& collector, const IntVector3& chunk,
+    unsigned baseLightmapIndex, unsigned numLightmaps, const LightBakingSettings& settings,
+    ResourceContentHashes& contentHashes);
+
 /// Create baked scene chunk.
 URHO3D_API BakedSceneChunk CreateBakedSceneChunk(Context* context,
     BakedSceneCollector& collector, const IntVector3& chunk, const LightBakingSettings& settings);
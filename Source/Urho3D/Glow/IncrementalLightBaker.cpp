@@ -36,6 +36,7 @@
 #include "../Graphics/Graphics.h"
 #include "../Graphics/LightProbeGroup.h"
 #include "../Graphics/Model.h"
+#include "../IO/File.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
 #include "../Math/TetrahedralMesh.h"
@@ -45,6 +46,7 @@
 #include <EASTL/algorithm.h>
 #include <EASTL/numeric.h>
 #include <EASTL/sort.h>
+#include <EASTL/unordered_set.h>
 
 namespace Urho3D
 {
@@ -52,6 +54,9 @@ namespace Urho3D
 namespace
 {
 
+/// File ID of bake state file.
+static const char* BakeStateFileID = "GBST";
+
 /// Get resource name from file name.
 ea::string GetResourceName(ResourceCache* cache, const ea::string& fileName)
 {
@@ -188,6 +193,7 @@ struct IncrementalLightBaker::Impl
         auto fileSystem = context_->GetSubsystem<FileSystem>();
 
         numLightmapCharts_ = 0;
+        chunkLightmaps_.clear();
 
         for (const IntVector3& chunk : chunks_)
         {
@@ -214,6 +220,11 @@ struct IncrementalLightBaker::Impl
                 group->SetBakedDataFileRef({ BinaryFile::GetTypeStatic(), resourceName });
             }
 
+            // Remember lightmaps of the chunk
+            ea::vector<unsigned>& chunkLightmaps = chunkLightmaps_[chunk];
+            for (unsigned i = 0; i < charts.size(); ++i)
+                chunkLightmaps.push_back(numLightmapCharts_ + i);
+
             // Update base index
             numLightmapCharts_ += charts.size();
         }
@@ -244,20 +255,51 @@ struct IncrementalLightBaker::Impl
         }
     }
 
-    /// Generate baking chunks.
+    /// Generate baking chunks. Unchanged chunks are reused.
     void GenerateBakingChunks()
     {
+        const ea::unordered_map<IntVector3, unsigned> previousChunkHashes = LoadBakeState();
+
+        chunkHashes_.clear();
+        chunksToBake_.clear();
+        reusedChunks_.clear();
+        reusedChunkSet_.clear();
+        ResourceContentHashes contentHashes;
         for (const IntVector3& chunk : chunks_)
         {
+            const ea::vector<unsigned>& chunkLightmaps = chunkLightmaps_[chunk];
+            const unsigned baseLightmapIndex = !chunkLightmaps.empty() ? chunkLightmaps.front() : 0;
+            const unsigned hash = CalculateBakedSceneChunkHash(*collector_, chunk,
+                baseLightmapIndex, chunkLightmaps.size(), settings_, contentHashes);
+            chunkHashes_[chunk] = hash;
+            for (unsigned lightmapIndex : chunkLightmaps)
+                cache_->SetLightmapInputHash(lightmapIndex, hash);
+
+            const auto previousHashIter = previousChunkHashes.find(chunk);
+            const bool isUnchanged = previousHashIter != previousChunkHashes.end() && previousHashIter->second == hash;
+            if (settings_.incremental_.reuseUnchangedChunks_ && isUnchanged && HasBakedOutput(chunk))
+            {
+                reusedChunks_.push_back(chunk);
+                reusedChunkSet_.insert(chunk);
+
+                // Direct light is still needed to bake indirect light for neighbors
+                if (HasCachedDirectLight(chunk))
+                    continue;
+            }
+
             BakedSceneChunk bakedChunk = CreateBakedSceneChunk(context_, *collector_, chunk, settings_);
             cache_->StoreBakedChunk(chunk, ea::move(bakedChunk));
+            chunksToBake_.push_back(chunk);
         }
+
+        if (!reusedChunks_.empty())
+            URHO3D_LOGDEBUG("{} of {} chunks are unchanged since the previous bake", reusedChunks_.size(), chunks_.size());
     }
 
     /// Step direct light for charts.
     bool BakeDirectCharts(StopToken stopToken)
     {
-        for (const IntVector3 chunk : chunks_)
+        for (const IntVector3 chunk : chunksToBake_)
         {
             const ea::shared_ptr<const BakedSceneChunk> bakedChunk = cache_->LoadBakedChunk(chunk);
 
@@ -299,11 +341,14 @@ struct IncrementalLightBaker::Impl
         LightProbeCollectionBakedData lightProbesBakedData;
         LightmapChartBakedIndirect bakedIndirect{ settings_.charting_.lightmapSize_ };
 
-        for (const IntVector3 chunk : chunks_)
+        for (const IntVector3 chunk : chunksToBake_)
         {
             if (stopToken.IsStopped())
                 return false;
 
+            if (IsChunkReused(chunk))
+                continue;
+
             const ea::shared_ptr<const BakedSceneChunk> bakedChunk = cache_->LoadBakedChunk(chunk);
 
             // Collect required direct lightmaps
@@ -395,6 +440,7 @@ struct IncrementalLightBaker::Impl
                 }
             }
         }
+        bakeCompleted_ = true;
         return true;
     }
 
@@ -417,9 +463,12 @@ struct IncrementalLightBaker::Impl
             return;
         }
 
-        // Process all chunks
-        for (const IntVector3 chunk : chunks_)
+        // Process all baked chunks
+        for (const IntVector3 chunk : chunksToBake_)
         {
+            if (IsChunkReused(chunk))
+                continue;
+
             const ea::shared_ptr<const BakedSceneChunk> bakedChunk = cache_->LoadBakedChunk(chunk);
             for (unsigned i = 0; i < bakedChunk->lightmaps_.size(); ++i)
             {
@@ -462,7 +511,104 @@ struct IncrementalLightBaker::Impl
         }
     }
 
+    /// Save hashes of baked chunks if baking is completed.
+    void SaveBakeState()
+    {
+        if (!bakeCompleted_)
+            return;
+
+        const ea::string fileName = GetBakeStateFileName();
+        context_->GetSubsystem<FileSystem>()->CreateDirsRecursive(GetPath(fileName));
+
+        File file(context_, fileName, FILE_WRITE);
+        if (!file.IsOpen())
+        {
+            URHO3D_LOGERROR("Cannot save light baking state to \"{}\"", fileName);
+            return;
+        }
+
+        file.WriteFileID(BakeStateFileID);
+        file.WriteVLE(chunkHashes_.size());
+        for (const auto& [chunk, hash] : chunkHashes_)
+        {
+            file.WriteIntVector3(chunk);
+            file.WriteUInt(hash);
+        }
+    }
+
+    /// Return number of chunks.
+    unsigned GetNumChunks() const { return chunks_.size(); }
+    /// Return reused chunks.
+    const ea::vector<IntVector3>& GetReusedChunks() const { return reusedChunks_; }
+
 private:
+    /// Load hashes of chunks baked previously.
+    ea::unordered_map<IntVector3, unsigned> LoadBakeState()
+    {
+        ea::unordered_map<IntVector3, unsigned> chunkHashes;
+
+        const ea::string fileName = GetBakeStateFileName();
+        if (!context_->GetSubsystem<FileSystem>()->FileExists(fileName))
+            return chunkHashes;
+
+        File file(context_);
+        if (!file.Open(fileName, FILE_READ) || file.ReadFileID() != BakeStateFileID)
+        {
+            URHO3D_LOGWARNING("Cannot load light baking state from \"{}\", all chunks are baked", fileName);
+            return chunkHashes;
+        }
+
+        const unsigned numChunks = file.ReadVLE();
+        for (unsigned i = 0; i < numChunks && !file.IsEof(); ++i)
+        {
+            const IntVector3 chunk = file.ReadIntVector3();
+            chunkHashes[chunk] = file.ReadUInt();
+        }
+        return chunkHashes;
+    }
+
+    /// Return whether the baked lightmaps and light probes of the chunk are present.
+    bool HasBakedOutput(const IntVector3& chunk)
+    {
+        auto fileSystem = context_->GetSubsystem<FileSystem>();
+        for (unsigned lightmapIndex : chunkLightmaps_[chunk])
+        {
+            if (!fileSystem->FileExists(GetLightmapFileName(lightmapIndex)))
+                return false;
+        }
+
+        const unsigned numLightProbeGroups = collector_->GetUniqueLightProbeGroups(chunk).size();
+        for (unsigned i = 0; i < numLightProbeGroups; ++i)
+        {
+            if (!fileSystem->FileExists(GetLightProbeBakedDataFileName(chunk, i)))
+                return false;
+        }
+        return true;
+    }
+
+    /// Return whether the direct light of all lightmaps in chunk is present in cache.
+    bool HasCachedDirectLight(const IntVector3& chunk)
+    {
+        for (unsigned lightmapIndex : chunkLightmaps_[chunk])
+        {
+            if (!cache_->LoadDirectLight(lightmapIndex))
+                return false;
+        }
+        return true;
+    }
+
+    /// Return whether the chunk is reused.
+    bool IsChunkReused(const IntVector3& chunk) const
+    {
+        return reusedChunkSet_.find(chunk) != reusedChunkSet_.end();
+    }
+
+    /// Return bake state file name.
+    ea::string GetBakeStateFileName() const
+    {
+        return settings_.incremental_.outputDirectory_ + settings_.incremental_.bakeStateFileName_;
+    }
+
     /// Return lightmap file name.
     ea::string GetLightmapFileName(unsigned lightmapIndex)
     {
@@ -496,6 +642,18 @@ private:
     ea::vector<IntVector3> chunks_;
     /// Number of lightmap charts.
     unsigned numLightmapCharts_{};
+    /// Lightmaps of each chunk.
+    ea::unordered_map<IntVector3, ea::vector<unsigned>> chunkLightmaps_;
+    /// Input hashes of chunks.
+    ea::unordered_map<IntVector3, unsigned> chunkHashes_;
+    /// Chunks stored in the cache, in baking order.
+    ea::vector<IntVector3> chunksToBake_;
+    /// Chunks unchanged since the previous bake. Only direct light is baked for them, if not cached.
+    ea::vector<IntVector3> reusedChunks_;
+    /// Set of reused chunks for fast lookup.
+    ea::unordered_set<IntVector3> reusedChunkSet_;
+    /// Whether the baking is completed.
+    bool bakeCompleted_{};
 };
 
 IncrementalLightBaker::~IncrementalLightBaker()
@@ -529,6 +687,17 @@ bool IncrementalLightBaker::Bake(StopToken stopToken)
 void IncrementalLightBaker::CommitScene()
 {
     impl_->StitchAndSaveImages();
+    impl_->SaveBakeState();
+}
+
+unsigned IncrementalLightBaker::GetNumChunks() const
+{
+    return impl_->GetNumChunks();
+}
+
+const ea::vector<IntVector3>& IncrementalLightBaker::GetReusedChunks() const
+{
+    return impl_->GetReusedChunks();
 }
 
 }
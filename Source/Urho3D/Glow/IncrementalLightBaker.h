@@ -55,6 +55,11 @@ public:
     /// Commit the rest of changes to scene. Scene collector is used here.
     void CommitScene();
 
+    /// Return number of chunks in the scene.
+    unsigned GetNumChunks() const;
+    /// Return chunks that are unchanged since the previous bake and are not baked again.
+    const ea::vector<IntVector3>& GetReusedChunks() const;
+
 private:
     struct Impl;
 
@@ -177,6 +177,127 @@ bool IsTransparentForIndirect(const RaytracerGeometry& hitGeometry, const RTCHit
     return false;
 }
 
+/// Number of direct light rays gathered before tracing. Rays of neighbor elements are coherent.
+static const unsigned DirectRayBatchSize = 256;
+
+/// How rays are traced.
+enum class RayTracingMode
+{
+    /// Trace rays one by one.
+    Single,
+    /// Trace coherent rays in packets.
+    Packets,
+    /// Trace incoherent rays as stream.
+    Stream
+};
+
+/// Return widest ray packet supported natively by the device.
+unsigned GetNativeRayPacketSize(RTCDevice device)
+{
+    if (rtcGetDeviceProperty(device, RTC_DEVICE_PROPERTY_NATIVE_RAY16_SUPPORTED))
+        return 16;
+    if (rtcGetDeviceProperty(device, RTC_DEVICE_PROPERTY_NATIVE_RAY8_SUPPORTED))
+        return 8;
+    return 4;
+}
+
+/// Initialize ray.
+void InitializeRay(RTCRayHit& rayHit, const Vector3& origin, const Vector3& direction, float maxDistance,
+    unsigned mask, unsigned id)
+{
+    rayHit.ray.org_x = origin.x_;
+    rayHit.ray.org_y = origin.y_;
+    rayHit.ray.org_z = origin.z_;
+    rayHit.ray.tnear = 0.0f;
+    rayHit.ray.dir_x = direction.x_;
+    rayHit.ray.dir_y = direction.y_;
+    rayHit.ray.dir_z = direction.z_;
+    rayHit.ray.time = 0.0f;
+    rayHit.ray.tfar = maxDistance;
+    rayHit.ray.mask = mask;
+    rayHit.ray.id = id;
+    rayHit.ray.flags = 0;
+    rayHit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
+    rayHit.hit.instID[0] = RTC_INVALID_GEOMETRY_ID;
+}
+
+/// Copy ray into ray packet.
+template <int N>
+void CopyRayToPacket(RTCRayHitNt<N>& packet, const RTCRayHit& rayHit, unsigned lane)
+{
+    packet.ray.org_x[lane] = rayHit.ray.org_x;
+    packet.ray.org_y[lane] = rayHit.ray.org_y;
+    packet.ray.org_z[lane] = rayHit.ray.org_z;
+    packet.ray.tnear[lane] = rayHit.ray.tnear;
+    packet.ray.dir_x[lane] = rayHit.ray.dir_x;
+    packet.ray.dir_y[lane] = rayHit.ray.dir_y;
+    packet.ray.dir_z[lane] = rayHit.ray.dir_z;
+    packet.ray.time[lane] = rayHit.ray.time;
+    packet.ray.tfar[lane] = rayHit.ray.tfar;
+    packet.ray.mask[lane] = rayHit.ray.mask;
+    packet.ray.id[lane] = rayHit.ray.id;
+    packet.ray.flags[lane] = rayHit.ray.flags;
+    packet.hit.geomID[lane] = rayHit.hit.geomID;
+    packet.hit.instID[0][lane] = rayHit.hit.instID[0];
+}
+
+/// Intersect rays with the scene in packets of given size.
+template <int N>
+void IntersectRayPackets(RTCScene scene, RTCIntersectContext& rayContext, RTCRayHit* rayHits, unsigned numRays)
+{
+    alignas(64) int valid[N];
+    alignas(64) RTCRayHitNt<N> packet;
+    for (unsigned firstRay = 0; firstRay < numRays; firstRay += N)
+    {
+        const unsigned packetSize = ea::min(static_cast<unsigned>(N), numRays - firstRay);
+        for (unsigned lane = 0; lane < N; ++lane)
+        {
+            valid[lane] = lane < packetSize ? -1 : 0;
+            if (lane < packetSize)
+                CopyRayToPacket(packet, rayHits[firstRay + lane], lane);
+        }
+
+        if constexpr (N == 4)
+            rtcIntersect4(valid, scene, &rayContext, reinterpret_cast<RTCRayHit4*>(&packet));
+        else if constexpr (N == 8)
+            rtcIntersect8(valid, scene, &rayContext, reinterpret_cast<RTCRayHit8*>(&packet));
+        else
+            rtcIntersect16(valid, scene, &rayContext, reinterpret_cast<RTCRayHit16*>(&packet));
+
+        for (unsigned lane = 0; lane < packetSize; ++lane)
+            rayHits[firstRay + lane] = rtcGetRayHitFromRayHitN(reinterpret_cast<RTCRayHitN*>(&packet), N, lane);
+    }
+}
+
+/// Intersect rays with the scene. Ray IDs are preserved, so filter functions may use them to find per-ray data.
+void IntersectRays(RTCScene scene, RTCIntersectContext& rayContext, RTCRayHit* rayHits, unsigned numRays,
+    RayTracingMode mode, unsigned packetSize)
+{
+    switch (mode)
+    {
+    case RayTracingMode::Single:
+        rayContext.flags = RTC_INTERSECT_CONTEXT_FLAG_INCOHERENT;
+        for (unsigned i = 0; i < numRays; ++i)
+            rtcIntersect1(scene, &rayContext, &rayHits[i]);
+        break;
+
+    case RayTracingMode::Packets:
+        rayContext.flags = RTC_INTERSECT_CONTEXT_FLAG_COHERENT;
+        if (packetSize == 16)
+            IntersectRayPackets<16>(scene, rayContext, rayHits, numRays);
+        else if (packetSize == 8)
+            IntersectRayPackets<8>(scene, rayContext, rayHits, numRays);
+        else
+            IntersectRayPackets<4>(scene, rayContext, rayHits, numRays);
+        break;
+
+    case RayTracingMode::Stream:
+        rayContext.flags = RTC_INTERSECT_CONTEXT_FLAG_INCOHERENT;
+        rtcIntersect1M(scene, &rayContext, rayHits, numRays, sizeof(RTCRayHit));
+        break;
+    }
+}
+
 /// Ray tracing context for geometry buffer preprocessing.
 struct GeometryBufferPreprocessContext : public RTCIntersectContext
 {
@@ -206,15 +327,15 @@ void GeometryBufferPreprocessFilter(const RTCFilterFunctionNArguments* args)
 /// Base context for direct light tracing.
 struct DirectTracingContextBase : public RTCIntersectContext
 {
-    /// Incoming light accumulator.
+    /// Incoming light accumulators, indexed by ray ID.
     Vector3* incomingLight_{};
+    /// Geometries that cast the rays, indexed by ray ID. Null if the ray is not cast from geometry.
+    const RaytracerGeometry* const* currentGeometries_{};
 };
 
 /// Ray tracing context for direct light baking for charts.
 struct DirectTracingContextForCharts : public DirectTracingContextBase
 {
-    /// Current geometry.
-    const RaytracerGeometry* currentGeometry_{};
     /// Geometry index.
     const ea::vector<RaytracerGeometry>* geometryIndex_{};
 };
@@ -223,21 +344,25 @@ struct DirectTracingContextForCharts : public DirectTracingContextBase
 void TracingFilterForChartsDirect(const RTCFilterFunctionNArguments* args)
 {
     const auto& ctx = *static_cast<const DirectTracingContextForCharts*>(args->context);
-    auto& hit = *reinterpret_cast<RTCHit*>(args->hit);
-    assert(args->N == 1);
 
-    // Ignore invalid
-    if (args->valid[0] == 0)
-        return;
+    for (unsigned i = 0; i < args->N; ++i)
+    {
+        // Ignore invalid
+        if (args->valid[i] == 0)
+            continue;
 
-    // Ignore if unwanted LOD
-    const RaytracerGeometry& hitGeometry = (*ctx.geometryIndex_)[hit.geomID];
-    if (IsUnwantedLod(*ctx.currentGeometry_, hitGeometry))
-        args->valid[0] = 0;
+        const RTCHit hit = rtcGetHitFromHitN(args->hit, args->N, i);
+        const unsigned rayId = RTCRayN_id(args->ray, args->N, i);
 
-    // Accumulate and ignore if transparent
-    if (IsTransparedForDirect(hitGeometry, hit, *ctx.incomingLight_))
-        args->valid[0] = 0;
+        // Ignore if unwanted LOD
+        const RaytracerGeometry& hitGeometry = (*ctx.geometryIndex_)[hit.geomID];
+        if (IsUnwantedLod(*ctx.currentGeometries_[rayId], hitGeometry))
+            args->valid[i] = 0;
+
+        // Accumulate and ignore if transparent
+        if (IsTransparedForDirect(hitGeometry, hit, ctx.incomingLight_[rayId]))
+            args->valid[i] = 0;
+    }
 }
 
 /// Ray tracing context for direct light baking for light probes.
@@ -251,21 +376,25 @@ struct DirectTracingContextForLightProbes : public DirectTracingContextBase
 void TracingFilterForLightProbesDirect(const RTCFilterFunctionNArguments* args)
 {
     const auto& ctx = *static_cast<const DirectTracingContextForLightProbes*>(args->context);
-    auto& hit = *reinterpret_cast<RTCHit*>(args->hit);
-    assert(args->N == 1);
 
-    // Ignore invalid
-    if (args->valid[0] == 0)
-        return;
+    for (unsigned i = 0; i < args->N; ++i)
+    {
+        // Ignore invalid
+        if (args->valid[i] == 0)
+            continue;
 
-    // Ignore if LOD
-    const RaytracerGeometry& hitGeometry = (*ctx.geometryIndex_)[hit.geomID];
-    if (hitGeometry.lodIndex_ != 0)
-        args->valid[0] = 0;
+        const RTCHit hit = rtcGetHitFromHitN(args->hit, args->N, i);
+        const unsigned rayId = RTCRayN_id(args->ray, args->N, i);
 
-    // Accumulate and ignore if transparent
-    if (IsTransparedForDirect(hitGeometry, hit, *ctx.incomingLight_))
-        args->valid[0] = 0;
+        // Ignore if LOD
+        const RaytracerGeometry& hitGeometry = (*ctx.geometryIndex_)[hit.geomID];
+        if (hitGeometry.lodIndex_ != 0)
+            args->valid[i] = 0;
+
+        // Accumulate and ignore if transparent
+        if (IsTransparedForDirect(hitGeometry, hit, ctx.incomingLight_[rayId]))
+            args->valid[i] = 0;
+    }
 }
 
 /// Ray generator for directional light.
@@ -390,8 +519,6 @@ struct ChartDirectTracingKernel
 
     /// Current smooth interpolated normal.
     Vector3 currentSmoothNormal_;
-    /// Current geometry ID.
-    unsigned currentGeometryId_;
 
     /// Accumulated light.
     Vector3 accumulatedLight_;
@@ -415,34 +542,27 @@ struct ChartDirectTracingKernel
         return rayContext;
     }
 
-    /// Begin tracing element.
-    bool BeginElement(unsigned elementIndex, DirectTracingContextForCharts& rayContext, Vector3& position)
+    /// Return position and geometry of element. Return false if element is not traced.
+    bool GetElementPosition(unsigned elementIndex, Vector3& position, const RaytracerGeometry*& currentGeometry) const
     {
         const unsigned geometryId = geometryBuffer_->geometryIds_[elementIndex];
         const unsigned objectLightMask = geometryBuffer_->lightMasks_[elementIndex];
         if (!geometryId || (objectLightMask & lightMask_) == 0)
             return false;
 
-        // Initialize per-element data in ray context
         const unsigned raytracerGeometryId = (*geometryBufferToRaytracer_)[geometryId];
-        rayContext.currentGeometry_ = &(*raytracerGeometries_)[raytracerGeometryId];
-
-        // Initialize current geometry data
-        const Vector3& faceNormal = geometryBuffer_->faceNormals_[elementIndex];
+        currentGeometry = &(*raytracerGeometries_)[raytracerGeometryId];
         position = geometryBuffer_->positions_[elementIndex];
+        return true;
+    }
 
-        // Initialize per-element state
+    /// Begin tracing element.
+    void BeginElement(unsigned elementIndex)
+    {
         currentSmoothNormal_ = geometryBuffer_->smoothNormals_[elementIndex];
-        currentGeometryId_ = geometryId;
-
         accumulatedLight_ = Vector3::ZERO;
-
-        return true;
     };
 
-    /// Begin sample.
-    void BeginSample(unsigned /*sampleIndex*/) {}
-
     /// End sample.
     void EndSample(const Vector3& light, const Vector3& direction)
     {
@@ -506,24 +626,23 @@ struct LightProbeDirectTracingKernel
         return rayContext;
     }
 
-    /// Begin tracing element.
-    bool BeginElement(unsigned elementIndex, DirectTracingContextForLightProbes& /*rayContext*/, Vector3& position)
+    /// Return position and geometry of element. Return false if element is not traced.
+    bool GetElementPosition(unsigned elementIndex, Vector3& position, const RaytracerGeometry*& currentGeometry) const
     {
         const unsigned probeLightMask = collection_->lightMasks_[elementIndex];
         if ((probeLightMask & lightMask_) == 0)
             return false;
 
         position = collection_->worldPositions_[elementIndex];
-
-        accumulatedLightSH_ = {};
-
+        currentGeometry = nullptr;
         return true;
-    };
+    }
 
-    /// Begin sample. Return position, normal and initial ray direction.
-    void BeginSample(unsigned /*sampleIndex*/)
+    /// Begin tracing element.
+    void BeginElement(unsigned /*elementIndex*/)
     {
-    }
+        accumulatedLightSH_ = {};
+    };
 
     /// End sample.
     void EndSample(const Vector3& light, const Vector3& direction)
@@ -544,13 +663,53 @@ struct LightProbeDirectTracingKernel
     }
 };
 
+/// Direct light rays of consecutive elements. Rays of each element are stored contiguously.
+struct DirectRayBatch
+{
+    /// Rays.
+    ea::vector<RTCRayHit> rayHits_;
+    /// Light intensity of each ray. Attenuated by transparent geometry during tracing.
+    ea::vector<Vector3> lightIntensities_;
+    /// Direction to light of each ray.
+    ea::vector<Vector3> lightDirections_;
+    /// Geometry that casts each ray.
+    ea::vector<const RaytracerGeometry*> currentGeometries_;
+    /// Elements and number of rays for each element.
+    ea::vector<ea::pair<unsigned, unsigned>> elements_;
+
+    /// Return number of rays.
+    unsigned GetNumRays() const { return rayHits_.size(); }
+
+    /// Remove all rays and elements.
+    void Clear()
+    {
+        rayHits_.clear();
+        lightIntensities_.clear();
+        lightDirections_.clear();
+        currentGeometries_.clear();
+        elements_.clear();
+    }
+
+    /// Add ray from origin to origin + offset.
+    void AddRay(const Vector3& origin, const Vector3& offset, unsigned mask,
+        const Vector3& lightIntensity, const Vector3& lightDirection, const RaytracerGeometry* currentGeometry)
+    {
+        RTCRayHit& rayHit = rayHits_.emplace_back();
+        InitializeRay(rayHit, origin, offset, 1.0f, mask, rayHits_.size() - 1);
+        lightIntensities_.push_back(lightIntensity);
+        lightDirections_.push_back(lightDirection);
+        currentGeometries_.push_back(currentGeometry);
+    }
+};
+
 /// Trace direct lighting.
 template <class T, class U>
 void TraceDirectLight(T sharedKernel, U sharedGenerator,
     const RaytracerScene& raytracerScene, const DirectLightTracingSettings& settings)
 {
     RTCScene scene = raytracerScene.GetEmbreeScene();
-    const ea::vector<RaytracerGeometry>& raytracerGeometries = raytracerScene.GetGeometries();
+    const RayTracingMode mode = settings.usePacketTracing_ ? RayTracingMode::Packets : RayTracingMode::Single;
+    const unsigned packetSize = GetNativeRayPacketSize(raytracerScene.GetEmbreeDevice());
 
     ParallelFor(sharedKernel.GetNumElements(), settings.numTasks_,
         [&](unsigned fromIndex, unsigned toIndex)
@@ -559,48 +718,51 @@ void TraceDirectLight(T sharedKernel, U sharedGenerator,
         auto generator = sharedGenerator;
 
         auto rayContext = sharedKernel.GetRayContext();
+        const unsigned mask = sharedKernel.GetGeometryMask();
 
-        Vector3 incomingLightIntensity;
-        rayContext.incomingLight_ = &incomingLightIntensity;
-
-        RTCRayHit rayHit;
-        rayHit.ray.mask = sharedKernel.GetGeometryMask();
-        rayHit.ray.tnear = 0.0f;
-        rayHit.ray.time = 0.0f;
-        rayHit.ray.id = 0;
-        rayHit.ray.flags = 0;
-
-        for (unsigned elementIndex = fromIndex; elementIndex < toIndex; ++elementIndex)
+        DirectRayBatch batch;
+        unsigned elementIndex = fromIndex;
+        while (elementIndex < toIndex)
         {
-            Vector3 position;
-            if (!kernel.BeginElement(elementIndex, rayContext, position))
-                continue;
-
-            for (unsigned sampleIndex = 0; sampleIndex < kernel.GetNumSamples(); ++sampleIndex)
+            // Gather rays of consecutive elements. Such elements are close to each other,
+            // so rays towards the light are coherent.
+            batch.Clear();
+            for (; elementIndex < toIndex && batch.GetNumRays() < DirectRayBatchSize; ++elementIndex)
             {
-                kernel.BeginSample(sampleIndex);
-
-                Vector3 rayOffset;
-                Vector3 incomingLightDirection;
-                if (!generator.Generate(position, rayOffset, incomingLightIntensity, incomingLightDirection))
+                Vector3 position;
+                const RaytracerGeometry* currentGeometry = nullptr;
+                if (!kernel.GetElementPosition(elementIndex, position, currentGeometry))
                     continue;
 
-                // Cast direct ray
-                rayHit.ray.dir_x = rayOffset.x_;
-                rayHit.ray.dir_y = rayOffset.y_;
-                rayHit.ray.dir_z = rayOffset.z_;
-                rayHit.ray.org_x = position.x_ - rayOffset.x_;
-                rayHit.ray.org_y = position.y_ - rayOffset.y_;
-                rayHit.ray.org_z = position.z_ - rayOffset.z_;
-                rayHit.ray.tfar = 1.0f;
-                rayHit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
-                rtcIntersect1(scene, &rayContext, &rayHit);
-
-                if (rayHit.hit.geomID == RTC_INVALID_GEOMETRY_ID)
-                    kernel.EndSample(incomingLightIntensity, incomingLightDirection);
+                const unsigned firstRay = batch.GetNumRays();
+                for (unsigned sampleIndex = 0; sampleIndex < kernel.GetNumSamples(); ++sampleIndex)
+                {
+                    Vector3 rayOffset;
+                    Vector3 lightIntensity;
+                    Vector3 lightDirection;
+                    if (generator.Generate(position, rayOffset, lightIntensity, lightDirection))
+                        batch.AddRay(position - rayOffset, rayOffset, mask, lightIntensity, lightDirection, currentGeometry);
+                }
+                batch.elements_.emplace_back(elementIndex, batch.GetNumRays() - firstRay);
             }
 
-            kernel.EndElement(elementIndex);
+            // Cast direct rays
+            rayContext.incomingLight_ = batch.lightIntensities_.data();
+            rayContext.currentGeometries_ = batch.currentGeometries_.data();
+            IntersectRays(scene, rayContext, batch.rayHits_.data(), batch.GetNumRays(), mode, packetSize);
+
+            // Accumulate light of rays that reached elements
+            unsigned rayIndex = 0;
+            for (const auto& element : batch.elements_)
+            {
+                kernel.BeginElement(element.first);
+                for (unsigned i = 0; i < element.second; ++i, ++rayIndex)
+                {
+                    if (batch.rayHits_[rayIndex].hit.geomID == RTC_INVALID_GEOMETRY_ID)
+                        kernel.EndSample(batch.lightIntensities_[rayIndex], batch.lightDirections_[rayIndex]);
+                }
+                kernel.EndElement(element.first);
+            }
         }
     });
 }
@@ -616,17 +778,19 @@ struct IndirectTracingContext : public RTCIntersectContext
 void TracingFilterIndirect(const RTCFilterFunctionNArguments* args)
 {
     const auto& ctx = *static_cast<const IndirectTracingContext*>(args->context);
-    auto& hit = *reinterpret_cast<RTCHit*>(args->hit);
-    assert(args->N == 1);
 
-    // Ignore invalid
-    if (args->valid[0] == 0)
-        return;
-
-    // Ignore if transparent
-    const RaytracerGeometry& hitGeometry = (*ctx.geometryIndex_)[hit.geomID];
-    if (IsTransparentForIndirect(hitGeometry, hit))
-        args->valid[0] = 0;
+    for (unsigned i = 0; i < args->N; ++i)
+    {
+        // Ignore invalid
+        if (args->valid[i] == 0)
+            continue;
+
+        // Ignore if transparent
+        const RTCHit hit = rtcGetHitFromHitN(args->hit, args->N, i);
+        const RaytracerGeometry& hitGeometry = (*ctx.geometryIndex_)[hit.geomID];
+        if (IsTransparentForIndirect(hitGeometry, hit))
+            args->valid[i] = 0;
+    }
 }
 
 /// Indirect light tracing for charts: tracing kernel.
@@ -658,11 +822,6 @@ struct ChartIndirectTracingKernel
     unsigned lightProbesMeshHint_{};
     /// @}
 
-    /// Static within sample:
-    /// @{
-    Vector3 currentSampleDirection_;
-    /// @}
-
     /// Accumulated indirect light value.
     Vector4 accumulatedIndirectLight_;
 
@@ -713,12 +872,11 @@ struct ChartIndirectTracingKernel
         faceNormal = currentFaceNormal_;
         smoothNormal = currentSmoothNormal_;
         albedo = Vector3::ONE;
-        currentSampleDirection_ = RandomHemisphereDirection(currentFaceNormal_);
-        rayDirection = currentSampleDirection_;
+        rayDirection = RandomHemisphereDirection(currentFaceNormal_);
     }
 
     /// End sample.
-    void EndSample(const Vector3& light)
+    void EndSample(const Vector3& light, const Vector3& /*sampleDirection*/)
     {
         accumulatedIndirectLight_ += Vector4(light, 1.0f);
     }
@@ -744,9 +902,6 @@ struct LightProbeIndirectTracingKernel
     Vector3 currentPosition_;
     unsigned backgroundId_{};
 
-    /// Current sample direction.
-    Vector3 currentSampleDirection_;
-
     /// Accumulated indirect light (SH).
     SphericalHarmonicsColor9 accumulatedLightSH_;
 
@@ -772,19 +927,20 @@ struct LightProbeIndirectTracingKernel
     void BeginSample(unsigned /*sampleIndex*/,
         Vector3& position, Vector3& faceNormal, Vector3& smoothNormal, Vector3& rayDirection, Vector3& albedo)
     {
-        RandomDirection3(currentSampleDirection_);
+        Vector3 sampleDirection;
+        RandomDirection3(sampleDirection);
 
         position = currentPosition_;
-        faceNormal = currentSampleDirection_;
-        smoothNormal = currentSampleDirection_;
-        rayDirection = currentSampleDirection_;
+        faceNormal = sampleDirection;
+        smoothNormal = sampleDirection;
+        rayDirection = sampleDirection;
         albedo = Vector3::ONE;
     }
 
     /// End sample.
-    void EndSample(const Vector3& light)
+    void EndSample(const Vector3& light, const Vector3& sampleDirection)
     {
-        accumulatedLightSH_ += SphericalHarmonicsColor9(currentSampleDirection_, light);
+        accumulatedLightSH_ += SphericalHarmonicsColor9(sampleDirection, light);
     }
 
     /// End tracing element.
@@ -798,6 +954,27 @@ struct LightProbeIndirectTracingKernel
     }
 };
 
+/// Path of indirect light sample.
+struct IndirectLightPath
+{
+    /// Initial direction of the sample.
+    Vector3 sampleDirection_;
+    /// Current position.
+    Vector3 position_;
+    /// Current smooth normal.
+    Vector3 smoothNormal_;
+    /// Current ray direction.
+    Vector3 rayDirection_;
+    /// Number of bounces.
+    unsigned numBounces_{};
+    /// Albedo of receiving surface for each bounce.
+    Vector3 albedo_[IndirectLightTracingSettings::MaxBounces];
+    /// Incoming light for each bounce.
+    Vector3 incomingSamples_[IndirectLightTracingSettings::MaxBounces];
+    /// Incoming light factor for each bounce.
+    float incomingFactors_[IndirectLightTracingSettings::MaxBounces];
+};
+
 /// Trace indirect lighting.
 template <class T>
 void TraceIndirectLight(T sharedKernel, const ea::vector<const LightmapChartBakedDirect*>& bakedDirect,
@@ -805,6 +982,7 @@ void TraceIndirectLight(T sharedKernel, const ea::vector<const LightmapChartBake
 {
     assert(settings.maxBounces_ <= IndirectLightTracingSettings::MaxBounces);
 
+    const unsigned packetSize = GetNativeRayPacketSize(raytracerScene.GetEmbreeDevice());
     ParallelFor(sharedKernel.GetNumElements(), settings.numTasks_,
         [&](unsigned fromIndex, unsigned toIndex)
     {
@@ -815,21 +993,14 @@ void TraceIndirectLight(T sharedKernel, const ea::vector<const LightmapChartBake
         const auto& geometryIndex = raytracerScene.GetGeometries();
         const auto& backgrounds = raytracerScene.GetBackgrounds();
 
-        Vector3 albedo[IndirectLightTracingSettings::MaxBounces];
-        Vector3 incomingSamples[IndirectLightTracingSettings::MaxBounces];
-        float incomingFactors[IndirectLightTracingSettings::MaxBounces];
-
-        RTCRayHit rayHit;
         IndirectTracingContext rayContext;
         rtcInitIntersectContext(&rayContext);
         rayContext.geometryIndex_ = &geometryIndex;
         rayContext.filter = TracingFilterIndirect;
 
-        rayHit.ray.tnear = 0.0f;
-        rayHit.ray.time = 0.0f;
-        rayHit.ray.id = 0;
-        rayHit.ray.mask = RaytracerScene::PrimaryLODGeometry;
-        rayHit.ray.flags = 0;
+        ea::vector<IndirectLightPath> paths;
+        ea::vector<unsigned> activePaths;
+        ea::vector<RTCRayHit> rayHits;
 
         for (unsigned elementIndex = fromIndex; elementIndex < toIndex; ++elementIndex)
         {
@@ -838,43 +1009,61 @@ void TraceIndirectLight(T sharedKernel, const ea::vector<const LightmapChartBake
 
             const BakedSceneBackground& background = (*backgrounds)[kernel.GetElementBackgroundIndex()];
 
-            for (unsigned sampleIndex = 0; sampleIndex < kernel.GetNumSamples(); ++sampleIndex)
+            // Begin all samples of the element
+            const unsigned numSamples = kernel.GetNumSamples();
+            paths.resize(numSamples);
+            activePaths.clear();
+            for (unsigned sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
             {
-                Vector3 currentPosition;
-                Vector3 currentFaceNormal;
-                Vector3 currentSmoothNormal;
-                Vector3 currentRayDirection;
+                IndirectLightPath& path = paths[sampleIndex];
+                Vector3 faceNormal;
                 kernel.BeginSample(sampleIndex,
-                    currentPosition, currentFaceNormal, currentSmoothNormal, currentRayDirection, albedo[0]);
+                    path.position_, faceNormal, path.smoothNormal_, path.rayDirection_, path.albedo_[0]);
+                path.sampleDirection_ = path.rayDirection_;
+                path.numBounces_ = 0;
+                activePaths.push_back(sampleIndex);
+            }
+
+            // Trace all samples bounce by bounce. Rays of the first bounce start at the element and are traced
+            // in packets, rays of next bounces are incoherent and are traced as stream.
+            for (unsigned bounceIndex = 0; bounceIndex < settings.maxBounces_ && !activePaths.empty(); ++bounceIndex)
+            {
+                const unsigned numRays = activePaths.size();
+                rayHits.resize(numRays);
+                for (unsigned i = 0; i < numRays; ++i)
+                {
+                    const IndirectLightPath& path = paths[activePaths[i]];
+                    InitializeRay(rayHits[i], path.position_, path.rayDirection_, maxDistance,
+                        RaytracerScene::PrimaryLODGeometry, i);
+                }
+
+                RayTracingMode mode = RayTracingMode::Single;
+                if (settings.usePacketTracing_)
+                    mode = bounceIndex == 0 ? RayTracingMode::Packets : RayTracingMode::Stream;
+                IntersectRays(scene, rayContext, rayHits.data(), numRays, mode, packetSize);
 
-                int numBounces = 0;
-                for (unsigned bounceIndex = 0; bounceIndex < settings.maxBounces_; ++bounceIndex)
+                unsigned numActivePaths = 0;
+                for (unsigned i = 0; i < numRays; ++i)
                 {
-                    rayHit.ray.org_x = currentPosition.x_;
-                    rayHit.ray.org_y = currentPosition.y_;
-                    rayHit.ray.org_z = currentPosition.z_;
-                    rayHit.ray.dir_x = currentRayDirection.x_;
-                    rayHit.ray.dir_y = currentRayDirection.y_;
-                    rayHit.ray.dir_z = currentRayDirection.z_;
-                    rayHit.ray.tfar = maxDistance;
-                    rayHit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
-                    rtcIntersect1(scene, &rayContext, &rayHit);
+                    const unsigned pathIndex = activePaths[i];
+                    IndirectLightPath& path = paths[pathIndex];
+                    const RTCRayHit& rayHit = rayHits[i];
 
                     // Apply angle between receiving surface and ray, multiply by two to normalize
-                    const float cosTheta = ea::max(0.0f, currentRayDirection.DotProduct(currentSmoothNormal));
-                    incomingFactors[bounceIndex] = cosTheta * 2.0f;
+                    const float cosTheta = ea::max(0.0f, path.rayDirection_.DotProduct(path.smoothNormal_));
+                    path.incomingFactors_[bounceIndex] = cosTheta * 2.0f;
 
-                    // If hit background, pick light and break
+                    // If hit background, pick light and finish path
                     if (rayHit.hit.geomID == RTC_INVALID_GEOMETRY_ID)
                     {
-                        incomingSamples[bounceIndex] = background.SampleLinear(currentRayDirection);
-                        ++numBounces;
-                        break;
+                        path.incomingSamples_[bounceIndex] = background.SampleLinear(path.rayDirection_);
+                        ++path.numBounces_;
+                        continue;
                     }
 
                     // Check normal orientation
-                    if (currentRayDirection.DotProduct({ rayHit.hit.Ng_x, rayHit.hit.Ng_y, rayHit.hit.Ng_z }) > 0.0f)
-                        break;
+                    if (path.rayDirection_.DotProduct({ rayHit.hit.Ng_x, rayHit.hit.Ng_y, rayHit.hit.Ng_z }) > 0.0f)
+                        continue;
 
                     // Sample lightmap UV
                     const RaytracerGeometry& geometry = geometryIndex[rayHit.hit.geomID];
@@ -885,16 +1074,17 @@ void TraceIndirectLight(T sharedKernel, const ea::vector<const LightmapChartBake
                     // Modify incoming flux
                     const unsigned lightmapIndex = geometry.lightmapIndex_;
                     const IntVector2 sampleLocation = bakedDirect[lightmapIndex]->GetNearestLocation(lightmapUV);
-                    incomingSamples[bounceIndex] = bakedDirect[lightmapIndex]->GetSurfaceLight(sampleLocation);
-                    ++numBounces;
+                    path.incomingSamples_[bounceIndex] = bakedDirect[lightmapIndex]->GetSurfaceLight(sampleLocation);
+                    ++path.numBounces_;
 
                     // Go to next hemisphere
-                    if (numBounces < settings.maxBounces_)
+                    if (path.numBounces_ < settings.maxBounces_)
                     {
                         // Update albedo for hit surface
-                        albedo[bounceIndex + 1] = bakedDirect[lightmapIndex]->GetAlbedo(sampleLocation);
+                        path.albedo_[bounceIndex + 1] = bakedDirect[lightmapIndex]->GetAlbedo(sampleLocation);
 
                         // Move to hit position
+                        Vector3& currentPosition = path.position_;
                         currentPosition.x_ = rayHit.ray.org_x + rayHit.ray.dir_x * rayHit.ray.tfar;
                         currentPosition.y_ = rayHit.ray.org_y + rayHit.ray.dir_y * rayHit.ray.tfar;
                         currentPosition.z_ = rayHit.ray.org_z + rayHit.ray.dir_z * rayHit.ray.tfar;
@@ -908,25 +1098,29 @@ void TraceIndirectLight(T sharedKernel, const ea::vector<const LightmapChartBake
 
                         // Update smooth normal
                         rtcInterpolate0(geometry.embreeGeometry_, rayHit.hit.primID, rayHit.hit.u, rayHit.hit.v,
-                            RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, RaytracerScene::NormalAttribute, &currentSmoothNormal.x_, 3);
-                        currentSmoothNormal = currentSmoothNormal.Normalized();
+                            RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, RaytracerScene::NormalAttribute, &path.smoothNormal_.x_, 3);
+                        path.smoothNormal_ = path.smoothNormal_.Normalized();
 
-                        // Update face normal and find new direction to sample
-                        currentFaceNormal = hitNormal;
-                        currentRayDirection = RandomHemisphereDirection(currentFaceNormal);
+                        // Find new direction to sample
+                        path.rayDirection_ = RandomHemisphereDirection(hitNormal);
+                        activePaths[numActivePaths++] = pathIndex;
                     }
                 }
+                activePaths.resize(numActivePaths);
+            }
 
-                // Accumulate samples back-to-front
+            // Accumulate samples back-to-front
+            for (const IndirectLightPath& path : paths)
+            {
                 Vector3 sampleIndirectLight;
-                for (int bounceIndex = numBounces - 1; bounceIndex >= 0; --bounceIndex)
+                for (int bounceIndex = static_cast<int>(path.numBounces_) - 1; bounceIndex >= 0; --bounceIndex)
                 {
-                    sampleIndirectLight += incomingSamples[bounceIndex];
-                    sampleIndirectLight *= incomingFactors[bounceIndex];
-                    sampleIndirectLight *= albedo[bounceIndex];
+                    sampleIndirectLight += path.incomingSamples_[bounceIndex];
+                    sampleIndirectLight *= path.incomingFactors_[bounceIndex];
+                    sampleIndirectLight *= path.albedo_[bounceIndex];
                 }
 
-                kernel.EndSample(sampleIndirectLight);
+                kernel.EndSample(sampleIndirectLight, path.sampleDirection_);
             }
             kernel.EndElement(elementIndex);
         }
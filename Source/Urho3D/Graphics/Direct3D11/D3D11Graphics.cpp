@@ -1564,6 +1564,12 @@ unsigned Graphics::GetFormat(CompressedFormat format) const
     case CF_DXT5:
         return DXGI_FORMAT_BC3_UNORM;
 
+    case CF_BC7:
+        return DXGI_FORMAT_BC7_UNORM;
+
+    case CF_BC6H_UF16:
+        return DXGI_FORMAT_BC6H_UF16;
+
     default:
         return 0;
     }
@@ -2261,6 +2267,7 @@ void Graphics::CheckFeatureSupport()
 {
     anisotropySupport_ = true;
     dxtTextureSupport_ = true;
+    bptcTextureSupport_ = true;
     lightPrepassSupport_ = true;
     deferredSupport_ = true;
     hardwareShadowSupport_ = true;
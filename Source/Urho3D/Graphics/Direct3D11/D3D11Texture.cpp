@@ -79,7 +79,8 @@ bool Texture::GetParametersDirty() const
 
 bool Texture::IsCompressed() const
 {
-    return format_ == DXGI_FORMAT_BC1_UNORM || format_ == DXGI_FORMAT_BC2_UNORM || format_ == DXGI_FORMAT_BC3_UNORM;
+    return format_ == DXGI_FORMAT_BC1_UNORM || format_ == DXGI_FORMAT_BC2_UNORM || format_ == DXGI_FORMAT_BC3_UNORM ||
+           format_ == DXGI_FORMAT_BC6H_UF16 || format_ == DXGI_FORMAT_BC7_UNORM;
 }
 
 unsigned Texture::GetRowDataSize(int width) const
@@ -117,6 +118,8 @@ unsigned Texture::GetRowDataSize(int width) const
 
     case DXGI_FORMAT_BC2_UNORM:
     case DXGI_FORMAT_BC3_UNORM:
+    case DXGI_FORMAT_BC6H_UF16:
+    case DXGI_FORMAT_BC7_UNORM:
         return (unsigned)(((width + 3) >> 2) * 16);
 
     default:
@@ -191,6 +194,8 @@ unsigned Texture::GetSRGBFormat(unsigned format)
         return DXGI_FORMAT_BC2_UNORM_SRGB;
     else if (format == DXGI_FORMAT_BC3_UNORM)
         return DXGI_FORMAT_BC3_UNORM_SRGB;
+    else if (format == DXGI_FORMAT_BC7_UNORM)
+        return DXGI_FORMAT_BC7_UNORM_SRGB;
     else
         return format;
 }
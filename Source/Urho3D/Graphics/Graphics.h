@@ -875,6 +875,10 @@ private:
     bool etc2TextureSupport_{};
     /// PVRTC formats support flag.
     bool pvrtcTextureSupport_{};
+    /// BC6H and BC7 formats support flag.
+    bool bptcTextureSupport_{};
+    /// ASTC LDR formats support flag.
+    bool astcTextureSupport_{};
     /// Hardware shadow map depth compare support flag.
     bool hardwareShadowSupport_{};
     /// Instancing support flag.
@@ -71,8 +71,10 @@ struct LightBaker::TaskData
 #if URHO3D_GLOW
     /// Scene collector.
     DefaultBakedSceneCollector sceneCollector_;
-    /// Memory cache
-    BakedLightMemoryCache cache_;
+    /// Memory cache.
+    BakedLightMemoryCache memoryCache_;
+    /// Disk cache, used if cache directory is specified.
+    ea::unique_ptr<BakedLightDiskCache> diskCache_;
     /// Baker.
     IncrementalLightBaker baker_;
 #endif
@@ -119,6 +121,9 @@ void LightBaker::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE("Chunk Size", Vector3, settings_.incremental_.chunkSize_, defaultSettings.incremental_.chunkSize_, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Chunk Indirect Padding", float, settings_.incremental_.indirectPadding_, defaultSettings.incremental_.indirectPadding_, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Chunk Shadow Distance", float, settings_.incremental_.directionalLightShadowDistance_, defaultSettings.incremental_.directionalLightShadowDistance_, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Reuse Unchanged Chunks", bool, settings_.incremental_.reuseUnchangedChunks_, defaultSettings.incremental_.reuseUnchangedChunks_, AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Cache Directory", ea::string, settings_.incremental_.cacheDirectory_, "", AM_DEFAULT);
+    URHO3D_ATTRIBUTE("Cache Memory Budget (MB)", unsigned, settings_.incremental_.cacheMemoryBudget_, defaultSettings.incremental_.cacheMemoryBudget_, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Stitch Iterations", unsigned, settings_.stitching_.numIterations_, defaultSettings.stitching_.numIterations_, AM_DEFAULT);
 }
 
@@ -207,7 +212,17 @@ void LightBaker::Update()
 
         auto taskData = ea::make_shared<TaskData>();
         taskData->weakSelf_ = this;
-        if (!taskData->baker_.Initialize(settings_, GetScene(), &taskData->sceneCollector_, &taskData->cache_))
+
+        BakedLightCache* cache = &taskData->memoryCache_;
+        if (!settings_.incremental_.cacheDirectory_.empty())
+        {
+            const unsigned long long memoryBudget = settings_.incremental_.cacheMemoryBudget_ * 1024ull * 1024ull;
+            taskData->diskCache_ = ea::make_unique<BakedLightDiskCache>(
+                context_, settings_.incremental_.cacheDirectory_, memoryBudget);
+            cache = taskData->diskCache_.get();
+        }
+
+        if (!taskData->baker_.Initialize(settings_, GetScene(), &taskData->sceneCollector_, cache))
         {
             URHO3D_LOGERROR("Cannot initialize light baking");
             state_ = InternalState::NotStarted;
@@ -266,6 +281,15 @@ void LightBaker::Update()
         auto gi = GetScene()->GetComponent<GlobalIllumination>();
         gi->CompileLightProbes();
 
+#if URHO3D_GLOW
+        const unsigned numReusedChunks = taskData_->baker_.GetReusedChunks().size();
+        if (numReusedChunks > 0)
+        {
+            URHO3D_LOGINFO("{} of {} light baking chunks are unchanged and reused",
+                numReusedChunks, taskData_->baker_.GetNumChunks());
+        }
+#endif
+
         // Log overall time
         const unsigned totalMSec = taskData_->timer_.GetMSec(true);
         URHO3D_LOGINFO("Light baking is finished in {} seconds", totalMSec / 1000);
@@ -97,6 +97,8 @@ struct DirectLightTracingSettings
     unsigned numTasks_{ 1 };
     /// Max number of samples per element.
     unsigned maxSamples_{ 10 };
+    /// Whether to trace rays of neighbor elements together in packets. Rays are traced one by one otherwise.
+    bool usePacketTracing_{ true };
 };
 
 /// Parameters of indirect light tracing.
@@ -120,6 +122,8 @@ struct IndirectLightTracingSettings
     unsigned maxSamples_{ 10 };
     /// Max number of bounces.
     unsigned maxBounces_{ 2 };
+    /// Whether to trace rays in packets and streams. Rays are traced one by one otherwise.
+    bool usePacketTracing_{ true };
     /// Position bias in direction of face normal after hit. Scaled with position.
     float scaledPositionBounceBias_{ 0.00002f };
     /// Constant position bias in direction of face normal after hit.
@@ -183,6 +187,14 @@ struct IncrementalLightBakerSettings
     /// Placeholders 1-3: x, y and z components of chunk index.
     /// Placeholder 4: light probe group index within chunk.
     ea::string lightProbeGroupNameFormat_{ "Binary/LightProbeGroup-{}-{}-{}-{}.bin" };
+    /// Whether to skip chunks whose inputs didn't change since the previous bake.
+    bool reuseUnchangedChunks_{ true };
+    /// File with input hashes of baked chunks, used to find unchanged chunks.
+    ea::string bakeStateFileName_{ "Binary/BakeState.bin" };
+    /// Directory for intermediate baking data. Intermediate data is kept in memory if empty.
+    ea::string cacheDirectory_;
+    /// Max size of intermediate data kept in memory when cache directory is used, in megabytes.
+    unsigned cacheMemoryBudget_{ 1024 };
 };
 
 /// Aggregated light baking settings.
@@ -309,7 +309,7 @@ void Octant::GetDrawablesInternal(RayOctreeQuery& query) const
     }
 }
 
-void Octant::GetDrawablesOnlyInternal(RayOctreeQuery& query, ea::vector<Drawable*>& drawables) const
+void Octant::GetDrawablesOnlyInternal(RayOctreeQuery& query, FrameVector<Drawable*>& drawables) const
 {
     float octantDist = query.ray_.HitDistance(cullingBox_);
     if (octantDist >= query.maxDistance_)
@@ -700,22 +700,24 @@ void Octree::RaycastSingle(RayOctreeQuery& query) const
 {
     URHO3D_PROFILE("Raycast");
 
+    // Temporary list of candidate drawables is allocated from the frame arena and released on return
+    FrameArenaScope frameArenaScope;
+    FrameVector<Drawable*> rayQueryDrawables;
     query.result_.clear();
-    rayQueryDrawables_.clear();
-    rootOctant_.GetDrawablesOnlyInternal(query, rayQueryDrawables_);
+    rootOctant_.GetDrawablesOnlyInternal(query, rayQueryDrawables);
 
     // Sort by increasing hit distance to AABB
-    for (auto i = rayQueryDrawables_.begin(); i != rayQueryDrawables_.end(); ++i)
+    for (auto i = rayQueryDrawables.begin(); i != rayQueryDrawables.end(); ++i)
     {
         Drawable* drawable = *i;
         drawable->SetSortValue(query.ray_.HitDistance(drawable->GetWorldBoundingBox()));
     }
 
-    ea::quick_sort(rayQueryDrawables_.begin(), rayQueryDrawables_.end(), CompareDrawables);
+    ea::quick_sort(rayQueryDrawables.begin(), rayQueryDrawables.end(), CompareDrawables);
 
     // Then do the actual test according to the query, and early-out as possible
     float closestHit = M_INFINITY;
-    for (auto i = rayQueryDrawables_.begin(); i != rayQueryDrawables_.end(); ++i)
+    for (auto i = rayQueryDrawables.begin(); i != rayQueryDrawables.end(); ++i)
     {
         Drawable* drawable = *i;
         if (drawable->GetSortValue() < Min(closestHit, query.maxDistance_))
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "../Container/FrameAllocator.h"
 #include "../Core/Mutex.h"
 #include "../Graphics/Drawable.h"
 #include "../Graphics/OctreeQuery.h"
@@ -110,7 +111,7 @@ public:
     /// Return drawable objects by a ray query, called internally.
     void GetDrawablesInternal(RayOctreeQuery& query) const;
     /// Return drawable objects only for a threaded ray query, called internally.
-    void GetDrawablesOnlyInternal(RayOctreeQuery& query, ea::vector<Drawable*>& drawables) const;
+    void GetDrawablesOnlyInternal(RayOctreeQuery& query, FrameVector<Drawable*>& drawables) const;
 
 protected:
     /// Initialize bounding box.
@@ -290,8 +291,6 @@ private:
     ea::vector<Drawable*> drawables_;
     /// Mutex for octree reinsertions.
     Mutex octreeMutex_;
-    /// Ray query temporary list of drawables.
-    mutable ea::vector<Drawable*> rayQueryDrawables_;
     /// Subdivision level.
     unsigned numLevels_;
     /// World bounding box.
@@ -2120,6 +2120,15 @@ unsigned Graphics::GetFormat(CompressedFormat format) const
         return pvrtcTextureSupport_ ? COMPRESSED_RGBA_PVRTC_4BPPV1_IMG : 0;
 #endif
 
+    case CF_BC7:
+        return bptcTextureSupport_ ? GL_COMPRESSED_RGBA_BPTC_UNORM : 0;
+
+    case CF_BC6H_UF16:
+        return bptcTextureSupport_ ? GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT : 0;
+
+    case CF_ASTC_4x4:
+        return astcTextureSupport_ ? GL_COMPRESSED_RGBA_ASTC_4x4_KHR : 0;
+
     default:
         return 0;
     }
@@ -2846,6 +2855,9 @@ void Graphics::CheckFeatureSupport()
     // Check if can use depth-stencil for textures
     if (gl3Support || (CheckExtension("GL_EXT_packed_depth_stencil") && CheckExtension("GL_ARB_depth_texture")))
         glReadableDepthStencilFormat = GL_DEPTH24_STENCIL8_EXT;
+
+    bptcTextureSupport_ = CheckExtension("GL_ARB_texture_compression_bptc");
+    astcTextureSupport_ = CheckExtension("GL_KHR_texture_compression_astc_ldr");
 #else
     // Check for supported compressed texture formats
 #ifdef __EMSCRIPTEN__
@@ -2853,6 +2865,8 @@ void Graphics::CheckFeatureSupport()
     etcTextureSupport_ = CheckExtension("WEBGL_compressed_texture_etc1"); // https://www.khronos.org/registry/webgl/extensions/WEBGL_compressed_texture_etc1/
     pvrtcTextureSupport_ = CheckExtension("WEBGL_compressed_texture_pvrtc"); // https://www.khronos.org/registry/webgl/extensions/WEBGL_compressed_texture_pvrtc/
     etc2TextureSupport_ = gl3Support || CheckExtension("WEBGL_compressed_texture_etc"); // https://www.khronos.org/registry/webgl/extensions/WEBGL_compressed_texture_etc/
+    bptcTextureSupport_ = CheckExtension("EXT_texture_compression_bptc"); // https://www.khronos.org/registry/webgl/extensions/EXT_texture_compression_bptc/
+    astcTextureSupport_ = CheckExtension("WEBGL_compressed_texture_astc"); // https://www.khronos.org/registry/webgl/extensions/WEBGL_compressed_texture_astc/
     // Instancing is in core in WebGL 2, so the extension may not be present anymore. In WebGL 1, find https://www.khronos.org/registry/webgl/extensions/ANGLE_instanced_arrays/
     // TODO: In the distant future, this may break if WebGL 3 is introduced, so either improve the GL_VERSION parsing here, or keep track of which WebGL version we attempted to initialize.
     instancingSupport_ = (strstr((const char *)glGetString(GL_VERSION), "WebGL 2.") != 0) || CheckExtension("ANGLE_instanced_arrays");
@@ -2861,6 +2875,8 @@ void Graphics::CheckFeatureSupport()
     etcTextureSupport_ = CheckExtension("OES_compressed_ETC1_RGB8_texture");
     etc2TextureSupport_ = gl3Support || CheckExtension("OES_compressed_ETC2_RGBA8_texture");
     pvrtcTextureSupport_ = CheckExtension("IMG_texture_compression_pvrtc");
+    bptcTextureSupport_ = CheckExtension("EXT_texture_compression_bptc");
+    astcTextureSupport_ = CheckExtension("KHR_texture_compression_astc_ldr");
 #endif
 
     // Check for best supported depth renderbuffer format for GLES2
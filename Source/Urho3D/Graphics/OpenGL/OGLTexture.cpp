@@ -184,7 +184,9 @@ bool Texture::IsCompressed() const
            format_ == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT || format_ == GL_ETC1_RGB8_OES ||
            format_ == GL_ETC2_RGB8_OES || format_ == GL_ETC2_RGBA8_OES ||
            format_ == COMPRESSED_RGB_PVRTC_4BPPV1_IMG || format_ == COMPRESSED_RGBA_PVRTC_4BPPV1_IMG ||
-           format_ == COMPRESSED_RGB_PVRTC_2BPPV1_IMG || format_ == COMPRESSED_RGBA_PVRTC_2BPPV1_IMG;
+           format_ == COMPRESSED_RGB_PVRTC_2BPPV1_IMG || format_ == COMPRESSED_RGBA_PVRTC_2BPPV1_IMG ||
+           format_ == GL_COMPRESSED_RGBA_BPTC_UNORM || format_ == GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT ||
+           format_ == GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
 }
 
 unsigned Texture::GetRowDataSize(int width) const
@@ -248,6 +250,11 @@ unsigned Texture::GetRowDataSize(int width) const
     case COMPRESSED_RGBA_PVRTC_2BPPV1_IMG:
         return ((unsigned)(width + 7) >> 3u) * 8;
 
+    case GL_COMPRESSED_RGBA_BPTC_UNORM:
+    case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+    case GL_COMPRESSED_RGBA_ASTC_4x4_KHR:
+        return ((unsigned)(width + 3) >> 2u) * 16;
+
     default:
         return 0;
     }
@@ -329,6 +336,10 @@ unsigned Texture::GetSRGBFormat(unsigned format)
         return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT;
     case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
         return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+    case GL_COMPRESSED_RGBA_BPTC_UNORM:
+        return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+    case GL_COMPRESSED_RGBA_ASTC_4x4_KHR:
+        return GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR;
     default:
         return format;
     }
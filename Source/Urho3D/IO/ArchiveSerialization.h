@@ -95,8 +95,8 @@ inline unsigned UnFormatArray(const ea::string& string, int* values, unsigned ma
 }
 
 /// Serialize array of fixed size.
-template <class T>
-inline bool SerializeArray(Archive& archive, const char* name, T* values, unsigned size)
+template <class ArchiveT, class T>
+inline bool SerializeArray(ArchiveT& archive, const char* name, T* values, unsigned size)
 {
     if (!archive.IsHumanReadable())
         return archive.SerializeBytes(name, values, size * sizeof(T));
@@ -120,8 +120,8 @@ inline bool SerializeArray(Archive& archive, const char* name, T* values, unsign
 }
 
 /// Serialize type as fixed array.
-template <unsigned N, class T>
-inline bool SerializeArrayType(Archive& archive, const char* name, T& value)
+template <unsigned N, class ArchiveT, class T>
+inline bool SerializeArrayType(ArchiveT& archive, const char* name, T& value)
 {
     using ElementType = std::decay_t<decltype(*value.Data())>;
 
@@ -174,109 +174,133 @@ inline ea::string FormatResourceRefList(ea::string_view typeString, const ea::st
 }
 
 /// Serialize bool.
-inline bool SerializeValue(Archive& archive, const char* name, bool& value) { return archive.Serialize(name, value); }
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, bool& value) { return archive.Serialize(name, value); }
 
 /// Serialize signed char.
-inline bool SerializeValue(Archive& archive, const char* name, signed char& value) { return archive.Serialize(name, value); }
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, signed char& value) { return archive.Serialize(name, value); }
 
 /// Serialize unsigned char.
-inline bool SerializeValue(Archive& archive, const char* name, unsigned char& value) { return archive.Serialize(name, value); }
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, unsigned char& value) { return archive.Serialize(name, value); }
 
 /// Serialize signed short.
-inline bool SerializeValue(Archive& archive, const char* name, short& value) { return archive.Serialize(name, value); }
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, short& value) { return archive.Serialize(name, value); }
 
 /// Serialize unsigned short.
-inline bool SerializeValue(Archive& archive, const char* name, unsigned short& value) { return archive.Serialize(name, value); }
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, unsigned short& value) { return archive.Serialize(name, value); }
 
 /// Serialize signed int.
-inline bool SerializeValue(Archive& archive, const char* name, int& value) { return archive.Serialize(name, value); }
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, int& value) { return archive.Serialize(name, value); }
 
 /// Serialize unsigned int.
-inline bool SerializeValue(Archive& archive, const char* name, unsigned int& value) { return archive.Serialize(name, value); }
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, unsigned int& value) { return archive.Serialize(name, value); }
 
 /// Serialize signed long.
-inline bool SerializeValue(Archive& archive, const char* name, long long& value) { return archive.Serialize(name, value); }
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, long long& value) { return archive.Serialize(name, value); }
 
 /// Serialize unsigned long.
-inline bool SerializeValue(Archive& archive, const char* name, unsigned long long& value) { return archive.Serialize(name, value); }
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, unsigned long long& value) { return archive.Serialize(name, value); }
 
 /// Serialize float.
-inline bool SerializeValue(Archive& archive, const char* name, float& value) { return archive.Serialize(name, value); }
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, float& value) { return archive.Serialize(name, value); }
 
 /// Serialize double.
-inline bool SerializeValue(Archive& archive, const char* name, double& value) { return archive.Serialize(name, value); }
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, double& value) { return archive.Serialize(name, value); }
 
 /// Serialize string.
-inline bool SerializeValue(Archive& archive, const char* name, ea::string& value) { return archive.Serialize(name, value); }
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, ea::string& value) { return archive.Serialize(name, value); }
 
 /// Serialize Vector2.
-inline bool SerializeValue(Archive& archive, const char* name, Vector2& value)
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, Vector2& value)
 {
     return Detail::SerializeArrayType<2>(archive, name, value);
 }
 
 /// Serialize Vector3.
-inline bool SerializeValue(Archive& archive, const char* name, Vector3& value)
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, Vector3& value)
 {
     return Detail::SerializeArrayType<3>(archive, name, value);
 }
 
 /// Serialize Vector4.
-inline bool SerializeValue(Archive& archive, const char* name, Vector4& value)
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, Vector4& value)
 {
     return Detail::SerializeArrayType<4>(archive, name, value);
 }
 
 /// Serialize Matrix3.
-inline bool SerializeValue(Archive& archive, const char* name, Matrix3& value)
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, Matrix3& value)
 {
     return Detail::SerializeArrayType<9>(archive, name, value);
 }
 
 /// Serialize Matrix3x4.
-inline bool SerializeValue(Archive& archive, const char* name, Matrix3x4& value)
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, Matrix3x4& value)
 {
     return Detail::SerializeArrayType<12>(archive, name, value);
 }
 
 /// Serialize Matrix4.
-inline bool SerializeValue(Archive& archive, const char* name, Matrix4& value)
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, Matrix4& value)
 {
     return Detail::SerializeArrayType<16>(archive, name, value);
 }
 
 /// Serialize Rect.
-inline bool SerializeValue(Archive& archive, const char* name, Rect& value)
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, Rect& value)
 {
     return Detail::SerializeArrayType<4>(archive, name, value);
 }
 
 /// Serialize Quaternion.
-inline bool SerializeValue(Archive& archive, const char* name, Quaternion& value)
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, Quaternion& value)
 {
     return Detail::SerializeArrayType<4>(archive, name, value);
 }
 
 /// Serialize Color.
-inline bool SerializeValue(Archive& archive, const char* name, Color& value)
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, Color& value)
 {
     return Detail::SerializeArrayType<4>(archive, name, value);
 }
 
 /// Serialize IntVector2.
-inline bool SerializeValue(Archive& archive, const char* name, IntVector2& value)
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, IntVector2& value)
 {
     return Detail::SerializeArrayType<2>(archive, name, value);
 }
 
 /// Serialize IntVector3.
-inline bool SerializeValue(Archive& archive, const char* name, IntVector3& value)
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, IntVector3& value)
 {
     return Detail::SerializeArrayType<3>(archive, name, value);
 }
 
 /// Serialize IntRect.
-inline bool SerializeValue(Archive& archive, const char* name, IntRect& value)
+template <class ArchiveT>
+inline bool SerializeValue(ArchiveT& archive, const char* name, IntRect& value)
 {
     return Detail::SerializeArrayType<4>(archive, name, value);
 }
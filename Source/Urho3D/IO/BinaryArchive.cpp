@@ -79,7 +79,7 @@ bool BinaryOutputArchive::BeginBlock(const char* name, unsigned& sizeHint, bool
     {
         Block block{ name, type, serializer_, safe };
         stack_.push_back(ea::move(block));
-        currentBlockSerializer_ = GetCurrentBlock().GetSerializer();
+        UpdateCurrentBlockSerializer();
     }
     else
     {
@@ -123,11 +123,12 @@ bool BinaryOutputArchive::EndBlock()
 
     stack_.pop_back();
     if (!stack_.empty())
-        currentBlockSerializer_ = GetCurrentBlock().GetSerializer();
+        UpdateCurrentBlockSerializer();
     else
     {
         CloseArchive();
         currentBlockSerializer_ = nullptr;
+        currentBlockBuffer_ = nullptr;
     }
 
     return blockClosed;
@@ -165,68 +166,44 @@ bool BinaryOutputArchive::SerializeVLE(const char* name, unsigned& value)
     return CheckElementWrite(currentBlockSerializer_->WriteVLE(value), name);
 }
 
-bool BinaryOutputArchive::CheckEOF(const char* elementName)
+bool BinaryOutputArchive::ReportEOF(const char* elementName)
 {
     if (HasError())
         return false;
 
-    if (IsEOF())
-    {
-        const ea::string_view blockName = !stack_.empty() ? GetCurrentBlock().GetName() : "";
-        SetErrorFormatted(ArchiveBase::errorEOF_elementName, elementName);
-        return false;
-    }
-
-    return true;
+    SetErrorFormatted(ArchiveBase::errorEOF_elementName, elementName);
+    return false;
 }
 
-bool BinaryOutputArchive::CheckEOFAndRoot(const char* elementName)
+bool BinaryOutputArchive::ReportEOFOrRoot(const char* elementName)
 {
-    if (!CheckEOF(elementName))
-        return false;
+    if (HasError() || IsEOF())
+        return ReportEOF(elementName);
 
-    if (stack_.empty())
-    {
-        SetErrorFormatted(ArchiveBase::fatalRootBlockNotOpened_elementName, elementName);
-        assert(0);
-        return false;
-    }
-
-    return true;
+    SetErrorFormatted(ArchiveBase::fatalRootBlockNotOpened_elementName, elementName);
+    assert(0);
+    return false;
 }
 
-bool BinaryOutputArchive::CheckElementWrite(bool result, const char* elementName)
+bool BinaryOutputArchive::ReportElementError(const char* elementName)
 {
-    if (result)
-        return true;
-
     SetErrorFormatted(ArchiveBase::errorUnspecifiedFailure_elementName, elementName);
     return false;
 }
 
-// Generate serialization implementation (binary output)
-#define URHO3D_BINARY_OUT_IMPL(type, function) \
-    bool BinaryOutputArchive::Serialize(const char* name, type& value) \
-    { \
-        if (!CheckEOFAndRoot(name)) \
-            return false; \
-        return CheckElementWrite(currentBlockSerializer_->function(value), name); \
-    }
+void BinaryOutputArchive::UpdateCurrentBlockSerializer()
+{
+    currentBlockSerializer_ = GetCurrentBlock().GetSerializer();
+    currentBlockBuffer_ = dynamic_cast<VectorBuffer*>(currentBlockSerializer_);
+}
 
-URHO3D_BINARY_OUT_IMPL(bool, WriteBool);
-URHO3D_BINARY_OUT_IMPL(signed char, WriteByte);
-URHO3D_BINARY_OUT_IMPL(unsigned char, WriteUByte);
-URHO3D_BINARY_OUT_IMPL(short, WriteShort);
-URHO3D_BINARY_OUT_IMPL(unsigned short, WriteUShort);
-URHO3D_BINARY_OUT_IMPL(int, WriteInt);
-URHO3D_BINARY_OUT_IMPL(unsigned int, WriteUInt);
-URHO3D_BINARY_OUT_IMPL(long long, WriteInt64);
-URHO3D_BINARY_OUT_IMPL(unsigned long long, WriteUInt64);
-URHO3D_BINARY_OUT_IMPL(float, WriteFloat);
-URHO3D_BINARY_OUT_IMPL(double, WriteDouble);
-URHO3D_BINARY_OUT_IMPL(ea::string, WriteString);
-
-#undef URHO3D_BINARY_OUT_IMPL
+bool BinaryOutputArchive::Serialize(const char* name, ea::string& value)
+{
+    if (!CheckEOFAndRoot(name))
+        return false;
+
+    return CheckElementWrite(currentBlockSerializer_->WriteString(value), name);
+}
 
 BinaryInputArchiveBlock::BinaryInputArchiveBlock(const char* name, ArchiveBlockType type,
     Deserializer* deserializer, bool safe, unsigned nextElementPosition)
@@ -258,6 +235,8 @@ void BinaryInputArchiveBlock::Close(ArchiveBase& archive)
 BinaryInputArchive::BinaryInputArchive(Context* context, Deserializer& deserializer)
     : BinaryArchiveBase<BinaryInputArchiveBlock, true>(context)
     , deserializer_(&deserializer)
+    , memoryBuffer_(dynamic_cast<MemoryBuffer*>(deserializer_))
+    , vectorBuffer_(dynamic_cast<VectorBuffer*>(deserializer_))
 {
 }
 
@@ -352,69 +331,38 @@ bool BinaryInputArchive::SerializeVLE(const char* name, unsigned& value)
     return CheckElementRead(true, name);
 }
 
-bool BinaryInputArchive::CheckEOF(const char* elementName)
+bool BinaryInputArchive::ReportEOF(const char* elementName)
 {
     if (HasError())
         return false;
 
-    if (IsEOF())
-    {
-        const ea::string_view blockName = !stack_.empty() ? GetCurrentBlock().GetName() : "";
-        SetErrorFormatted(ArchiveBase::errorEOF_elementName, elementName);
-        return false;
-    }
-
-    return true;
+    SetErrorFormatted(ArchiveBase::errorEOF_elementName, elementName);
+    return false;
 }
 
-bool BinaryInputArchive::CheckEOFAndRoot(const char* elementName)
+bool BinaryInputArchive::ReportEOFOrRoot(const char* elementName)
 {
-    if (!CheckEOF(elementName))
-        return false;
+    if (HasError() || IsEOF())
+        return ReportEOF(elementName);
 
-    if (stack_.empty())
-    {
-        SetErrorFormatted(ArchiveBase::fatalRootBlockNotOpened_elementName, elementName);
-        assert(0);
-        return false;
-    }
-
-    return true;
+    SetErrorFormatted(ArchiveBase::fatalRootBlockNotOpened_elementName, elementName);
+    assert(0);
+    return false;
 }
 
-bool BinaryInputArchive::CheckElementRead(bool result, const char* elementName)
+bool BinaryInputArchive::ReportElementError(const char* elementName)
 {
-    if (!result || deserializer_->GetPosition() > GetCurrentBlock().GetNextElementPosition())
-    {
-        SetErrorFormatted(ArchiveBase::errorUnspecifiedFailure_elementName, elementName);
-        return false;
-    }
-    return true;
+    SetErrorFormatted(ArchiveBase::errorUnspecifiedFailure_elementName, elementName);
+    return false;
 }
 
-// Generate serialization implementation (binary input)
-#define URHO3D_BINARY_IN_IMPL(type, function) \
-    bool BinaryInputArchive::Serialize(const char* name, type& value) \
-    { \
-        if (!CheckEOFAndRoot(name)) \
-            return false; \
-        value = deserializer_->function(); \
-        return CheckElementRead(true, name); \
-    }
+bool BinaryInputArchive::Serialize(const char* name, ea::string& value)
+{
+    if (!CheckEOFAndRoot(name))
+        return false;
 
-URHO3D_BINARY_IN_IMPL(bool, ReadBool);
-URHO3D_BINARY_IN_IMPL(signed char, ReadByte);
-URHO3D_BINARY_IN_IMPL(unsigned char, ReadUByte);
-URHO3D_BINARY_IN_IMPL(short, ReadShort);
-URHO3D_BINARY_IN_IMPL(unsigned short, ReadUShort);
-URHO3D_BINARY_IN_IMPL(int, ReadInt);
-URHO3D_BINARY_IN_IMPL(unsigned int, ReadUInt);
-URHO3D_BINARY_IN_IMPL(long long, ReadInt64);
-URHO3D_BINARY_IN_IMPL(unsigned long long, ReadUInt64);
-URHO3D_BINARY_IN_IMPL(float, ReadFloat);
-URHO3D_BINARY_IN_IMPL(double, ReadDouble);
-URHO3D_BINARY_IN_IMPL(ea::string, ReadString);
-
-#undef URHO3D_BINARY_IN_IMPL
+    value = deserializer_->ReadString();
+    return CheckElementRead(true, name);
+}
 
 }
@@ -24,9 +24,12 @@
 
 #include "../IO/Archive.h"
 #include "../IO/Deserializer.h"
+#include "../IO/MemoryBuffer.h"
 #include "../IO/Serializer.h"
 #include "../IO/VectorBuffer.h"
 
+#include <type_traits>
+
 namespace Urho3D
 {
 
@@ -149,27 +152,31 @@ public:
     bool SerializeKey(unsigned& key) final;
 
     /// Serialize bool.
-    bool Serialize(const char* name, bool& value) final;
+    bool Serialize(const char* name, bool& value) final
+    {
+        const unsigned char byte = value ? 1 : 0;
+        return SerializePOD(name, byte);
+    }
     /// Serialize signed char.
-    bool Serialize(const char* name, signed char& value) final;
+    bool Serialize(const char* name, signed char& value) final { return SerializePOD(name, value); }
     /// Serialize unsigned char.
-    bool Serialize(const char* name, unsigned char& value) final;
+    bool Serialize(const char* name, unsigned char& value) final { return SerializePOD(name, value); }
     /// Serialize signed short.
-    bool Serialize(const char* name, short& value) final;
+    bool Serialize(const char* name, short& value) final { return SerializePOD(name, value); }
     /// Serialize unsigned short.
-    bool Serialize(const char* name, unsigned short& value) final;
+    bool Serialize(const char* name, unsigned short& value) final { return SerializePOD(name, value); }
     /// Serialize signed int.
-    bool Serialize(const char* name, int& value) final;
+    bool Serialize(const char* name, int& value) final { return SerializePOD(name, value); }
     /// Serialize unsigned int.
-    bool Serialize(const char* name, unsigned int& value) final;
+    bool Serialize(const char* name, unsigned int& value) final { return SerializePOD(name, value); }
     /// Serialize signed long.
-    bool Serialize(const char* name, long long& value) final;
+    bool Serialize(const char* name, long long& value) final { return SerializePOD(name, value); }
     /// Serialize unsigned long.
-    bool Serialize(const char* name, unsigned long long& value) final;
+    bool Serialize(const char* name, unsigned long long& value) final { return SerializePOD(name, value); }
     /// Serialize float.
-    bool Serialize(const char* name, float& value) final;
+    bool Serialize(const char* name, float& value) final { return SerializePOD(name, value); }
     /// Serialize double.
-    bool Serialize(const char* name, double& value) final;
+    bool Serialize(const char* name, double& value) final { return SerializePOD(name, value); }
     /// Serialize string.
     bool Serialize(const char* name, ea::string& value) final;
 
@@ -178,18 +185,59 @@ public:
     /// Serialize Variable Length Encoded unsigned integer, up to 29 significant bits.
     bool SerializeVLE(const char* name, unsigned& value) final;
 
+    /// Serialize trivially copyable value as is. Bypasses virtual Serializer interface when writing to memory.
+    template <class T>
+    bool SerializePOD(const char* name, const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Type should be trivially copyable");
+        if (!CheckEOFAndRoot(name))
+            return false;
+
+        if (currentBlockBuffer_)
+        {
+            currentBlockBuffer_->VectorBuffer::Write(&value, sizeof(T));
+            return true;
+        }
+        return CheckElementWrite(currentBlockSerializer_->Write(&value, sizeof(T)) == sizeof(T), name);
+    }
+
 private:
     /// Check EOF.
-    bool CheckEOF(const char* elementName);
+    bool CheckEOF(const char* elementName)
+    {
+        if (HasError() || IsEOF())
+            return ReportEOF(elementName);
+        return true;
+    }
     /// Check EOF and root block.
-    bool CheckEOFAndRoot(const char* elementName);
+    bool CheckEOFAndRoot(const char* elementName)
+    {
+        if (HasError() || IsEOF() || stack_.empty())
+            return ReportEOFOrRoot(elementName);
+        return true;
+    }
     /// Check result of the action.
-    bool CheckElementWrite(bool result, const char* elementName);
+    bool CheckElementWrite(bool result, const char* elementName)
+    {
+        if (result)
+            return true;
+        return ReportElementError(elementName);
+    }
+    /// Report EOF error. Always returns false.
+    bool ReportEOF(const char* elementName);
+    /// Report EOF or missing root block error. Always returns false.
+    bool ReportEOFOrRoot(const char* elementName);
+    /// Report element write error. Always returns false.
+    bool ReportElementError(const char* elementName);
+    /// Update cached serializer of the current block.
+    void UpdateCurrentBlockSerializer();
 
     /// Serializer.
     Serializer* serializer_{};
     /// Current block serializer.
     Serializer* currentBlockSerializer_{};
+    /// Current block serializer if it's memory buffer.
+    VectorBuffer* currentBlockBuffer_{};
 };
 
 /// XML input archive block. Internal.
@@ -272,27 +320,33 @@ public:
     bool SerializeKey(unsigned& key) final;
 
     /// Serialize bool.
-    bool Serialize(const char* name, bool& value) final;
+    bool Serialize(const char* name, bool& value) final
+    {
+        unsigned char byte{};
+        const bool result = SerializePOD(name, byte);
+        value = byte != 0;
+        return result;
+    }
     /// Serialize signed char.
-    bool Serialize(const char* name, signed char& value) final;
+    bool Serialize(const char* name, signed char& value) final { return SerializePOD(name, value); }
     /// Serialize unsigned char.
-    bool Serialize(const char* name, unsigned char& value) final;
+    bool Serialize(const char* name, unsigned char& value) final { return SerializePOD(name, value); }
     /// Serialize signed short.
-    bool Serialize(const char* name, short& value) final;
+    bool Serialize(const char* name, short& value) final { return SerializePOD(name, value); }
     /// Serialize unsigned short.
-    bool Serialize(const char* name, unsigned short& value) final;
+    bool Serialize(const char* name, unsigned short& value) final { return SerializePOD(name, value); }
     /// Serialize signed int.
-    bool Serialize(const char* name, int& value) final;
+    bool Serialize(const char* name, int& value) final { return SerializePOD(name, value); }
     /// Serialize unsigned int.
-    bool Serialize(const char* name, unsigned int& value) final;
+    bool Serialize(const char* name, unsigned int& value) final { return SerializePOD(name, value); }
     /// Serialize signed long.
-    bool Serialize(const char* name, long long& value) final;
+    bool Serialize(const char* name, long long& value) final { return SerializePOD(name, value); }
     /// Serialize unsigned long.
-    bool Serialize(const char* name, unsigned long long& value) final;
+    bool Serialize(const char* name, unsigned long long& value) final { return SerializePOD(name, value); }
     /// Serialize float.
-    bool Serialize(const char* name, float& value) final;
+    bool Serialize(const char* name, float& value) final { return SerializePOD(name, value); }
     /// Serialize double.
-    bool Serialize(const char* name, double& value) final;
+    bool Serialize(const char* name, double& value) final { return SerializePOD(name, value); }
     /// Serialize string.
     bool Serialize(const char* name, ea::string& value) final;
 
@@ -301,17 +355,58 @@ public:
     /// Serialize Variable Length Encoded unsigned integer, up to 29 significant bits.
     bool SerializeVLE(const char* name, unsigned& value) final;
 
+    /// Serialize trivially copyable value as is. Bypasses virtual Deserializer interface when reading from memory.
+    template <class T>
+    bool SerializePOD(const char* name, T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Type should be trivially copyable");
+        if (!CheckEOFAndRoot(name))
+            return false;
+
+        if (memoryBuffer_)
+            memoryBuffer_->MemoryBuffer::Read(&value, sizeof(T));
+        else if (vectorBuffer_)
+            vectorBuffer_->VectorBuffer::Read(&value, sizeof(T));
+        else
+            deserializer_->Read(&value, sizeof(T));
+        return CheckElementRead(true, name);
+    }
+
 private:
     /// Check EOF.
-    bool CheckEOF(const char* elementName);
+    bool CheckEOF(const char* elementName)
+    {
+        if (HasError() || IsEOF())
+            return ReportEOF(elementName);
+        return true;
+    }
     /// Check EOF and root block.
-    bool CheckEOFAndRoot(const char* elementName);
+    bool CheckEOFAndRoot(const char* elementName)
+    {
+        if (HasError() || IsEOF() || stack_.empty())
+            return ReportEOFOrRoot(elementName);
+        return true;
+    }
     /// Check element read.
-    bool CheckElementRead(bool result, const char* elementName);
+    bool CheckElementRead(bool result, const char* elementName)
+    {
+        if (!result || deserializer_->GetPosition() > GetCurrentBlock().GetNextElementPosition())
+            return ReportElementError(elementName);
+        return true;
+    }
+    /// Report EOF error. Always returns false.
+    bool ReportEOF(const char* elementName);
+    /// Report EOF or missing root block error. Always returns false.
+    bool ReportEOFOrRoot(const char* elementName);
+    /// Report element read error. Always returns false.
+    bool ReportElementError(const char* elementName);
 
     /// Deserializer.
     Deserializer* deserializer_{};
-
+    /// Deserializer if it's memory buffer.
+    MemoryBuffer* memoryBuffer_{};
+    /// Deserializer if it's vector buffer.
+    VectorBuffer* vectorBuffer_{};
 };
 
 }
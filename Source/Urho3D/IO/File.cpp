@@ -76,6 +76,8 @@ File::File(Context* context) :
     offset_(0),
     checksum_(0),
     compressed_(false),
+    blockSize_(0),
+    dictionarySize_(0),
     readSyncNeeded_(false),
     writeSyncNeeded_(false)
 {
@@ -93,6 +95,8 @@ File::File(Context* context, const ea::string& fileName, FileMode mode) :
     offset_(0),
     checksum_(0),
     compressed_(false),
+    blockSize_(0),
+    dictionarySize_(0),
     readSyncNeeded_(false),
     writeSyncNeeded_(false)
 {
@@ -111,6 +115,8 @@ File::File(Context* context, PackageFile* package, const ea::string& fileName) :
     offset_(0),
     checksum_(0),
     compressed_(false),
+    blockSize_(0),
+    dictionarySize_(0),
     readSyncNeeded_(false),
     writeSyncNeeded_(false)
 {
@@ -148,6 +154,21 @@ bool File::Open(PackageFile* package, const ea::string& fileName)
     checksum_ = entry->checksum_;
     size_ = entry->size_;
     compressed_ = package->IsCompressed();
+    blockSize_ = 0;
+    blockOffsets_.clear();
+    dictionary_.reset();
+    dictionarySize_ = 0;
+    if (compressed_ && entry->numBlocks_)
+    {
+        const ea::vector<unsigned>& blockOffsets = package->GetBlockOffsets();
+        blockSize_ = package->GetBlockSize();
+        blockOffsets_.assign(blockOffsets.begin() + entry->firstBlock_, blockOffsets.begin() + entry->firstBlock_ + entry->numBlocks_);
+        if (entry->useDictionary_)
+        {
+            dictionary_ = package->GetDictionary();
+            dictionarySize_ = package->GetDictionarySize();
+        }
+    }
 
     // Seek to beginning of package entry's file data
     SeekInternal(offset_);
@@ -217,25 +238,11 @@ unsigned File::Read(void* dest, unsigned size)
         {
             if (!readBuffer_ || readBufferOffset_ >= readBufferSize_)
             {
-                unsigned char blockHeaderBytes[4];
-                ReadInternal(blockHeaderBytes, sizeof blockHeaderBytes);
-
-                MemoryBuffer blockHeader(&blockHeaderBytes[0], sizeof blockHeaderBytes);
-                unsigned unpackedSize = blockHeader.ReadUShort();
-                unsigned packedSize = blockHeader.ReadUShort();
-
-                if (!readBuffer_)
+                if (!ReadCompressedBlock())
                 {
-                    readBuffer_ = new unsigned char[unpackedSize];
-                    inputBuffer_ = new unsigned char[LZ4_compressBound(unpackedSize)];
+                    URHO3D_LOGERROR("Error while decompressing file " + GetName());
+                    return size - sizeLeft;
                 }
-
-                /// \todo Handle errors
-                ReadInternal(inputBuffer_.get(), packedSize);
-                LZ4_decompress_fast((const char*)inputBuffer_.get(), (char*)readBuffer_.get(), unpackedSize);
-
-                readBufferSize_ = unpackedSize;
-                readBufferOffset_ = 0;
             }
 
             unsigned copySize = Min((readBufferSize_ - readBufferOffset_), sizeLeft);
@@ -283,6 +290,35 @@ unsigned File::Seek(unsigned position)
 
     if (compressed_)
     {
+        // With block index, decompress only the block containing the new position
+        if (!blockOffsets_.empty())
+        {
+            const unsigned bufferStart = position_ - readBufferOffset_;
+            if (position >= bufferStart && position < bufferStart + readBufferSize_)
+                readBufferOffset_ = position - bufferStart;
+            else if (position < size_)
+            {
+                const unsigned blockIndex = position / blockSize_;
+                SeekInternal(offset_ + blockOffsets_[blockIndex]);
+                readBufferOffset_ = 0;
+                readBufferSize_ = 0;
+                if (!ReadCompressedBlock())
+                {
+                    URHO3D_LOGERROR("Error while decompressing file " + GetName());
+                    return position_;
+                }
+                readBufferOffset_ = position - blockIndex * blockSize_;
+            }
+            else
+            {
+                readBufferOffset_ = 0;
+                readBufferSize_ = 0;
+            }
+
+            position_ = position;
+            return position_;
+        }
+
         // Start over from the beginning
         if (position == 0)
         {
@@ -546,6 +582,44 @@ void File::SeekInternal(unsigned newPosition)
         fseek((FILE*)handle_, newPosition, SEEK_SET);
 }
 
+bool File::ReadCompressedBlock()
+{
+    unsigned char blockHeaderBytes[4];
+    if (!ReadInternal(blockHeaderBytes, sizeof blockHeaderBytes))
+        return false;
+
+    MemoryBuffer blockHeader(&blockHeaderBytes[0], sizeof blockHeaderBytes);
+    unsigned unpackedSize = blockHeader.ReadUShort();
+    unsigned packedSize = blockHeader.ReadUShort();
+
+    // Packages without block index limit the block size only by the block header.
+    // Buffers are allocated for the largest block, because reading may start from any block.
+    const unsigned maxBlockSize = blockSize_ ? blockSize_ : 0xffffu;
+    const unsigned maxPackedSize = LZ4_compressBound(maxBlockSize);
+    if (unpackedSize > maxBlockSize || packedSize > maxPackedSize)
+        return false;
+
+    if (!readBuffer_)
+    {
+        readBuffer_ = new unsigned char[maxBlockSize];
+        inputBuffer_ = new unsigned char[maxPackedSize];
+    }
+
+    if (!ReadInternal(inputBuffer_.get(), packedSize))
+        return false;
+
+    const int result = dictionary_
+        ? LZ4_decompress_safe_usingDict((const char*)inputBuffer_.get(), (char*)readBuffer_.get(), packedSize,
+            maxBlockSize, (const char*)dictionary_.get(), dictionarySize_)
+        : LZ4_decompress_safe((const char*)inputBuffer_.get(), (char*)readBuffer_.get(), packedSize, maxBlockSize);
+    if (result != static_cast<int>(unpackedSize))
+        return false;
+
+    readBufferSize_ = unpackedSize;
+    readBufferOffset_ = 0;
+    return true;
+}
+
 void File::ReadBinary(ea::vector<unsigned char>& buffer)
 {
     buffer.clear();
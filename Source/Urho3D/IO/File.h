@@ -135,6 +135,8 @@ private:
     bool ReadInternal(void* dest, unsigned size);
     /// Seek in file internally using either C standard IO functions or SDL RWops for Android asset files.
     void SeekInternal(unsigned newPosition);
+    /// Read and decompress the next block of compressed package file into the read buffer. Return true if successful.
+    bool ReadCompressedBlock();
 
     /// Absolute file name.
     ea::string absoluteFileName_;
@@ -160,6 +162,14 @@ private:
     unsigned checksum_;
     /// Compression flag.
     bool compressed_;
+    /// Uncompressed size of compressed blocks, 0 if the package has no block index.
+    unsigned blockSize_;
+    /// Offsets of compressed blocks relative to the file start. Empty if the package has no block index.
+    ea::vector<unsigned> blockOffsets_;
+    /// LZ4 dictionary of compressed blocks. Null if not used by the file.
+    ea::shared_array<unsigned char> dictionary_;
+    /// Size of the LZ4 dictionary.
+    unsigned dictionarySize_;
     /// Synchronization needed before read -flag.
     bool readSyncNeeded_;
     /// Synchronization needed before write -flag.
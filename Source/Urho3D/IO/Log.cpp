@@ -43,6 +43,7 @@
 
 #include <mutex>
 #include <cstdio>
+#include <thread>
 
 #ifdef __ANDROID__
 #include <android/log.h>
@@ -65,6 +66,91 @@ static Log* GetLog()
     return logInstance;
 }
 
+/// Log in asynchronous mode, if any.
+static std::atomic<Log*> asyncLog{};
+/// Counter used to generate unique log instance identifiers.
+static std::atomic<unsigned> logInstanceCounter{};
+
+/// Lock-free bounded queue of deferred log messages. Single producer, single consumer.
+/// Messages are constructed and consumed in place.
+class DeferredLogQueue : public RefCounted
+{
+public:
+    /// Construct with capacity rounded up to power of two.
+    explicit DeferredLogQueue(unsigned capacity)
+        : capacity_(NextPowerOfTwo(capacity))
+        , messages_(new DeferredLogMessage[capacity_])
+    {
+    }
+
+    /// Return free message slot or null if the queue is full. Called by producer.
+    DeferredLogMessage* BeginPush()
+    {
+        const unsigned head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= capacity_)
+            return nullptr;
+        return &messages_[head & (capacity_ - 1)];
+    }
+
+    /// Publish message slot returned by BeginPush. Called by producer.
+    void EndPush() { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    /// Mark that the producer will never push again. Called by producer.
+    void Abandon() { abandoned_.store(true, std::memory_order_release); }
+
+    /// Return oldest message or null if the queue is empty. Called by consumer.
+    DeferredLogMessage* Peek()
+    {
+        const unsigned tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire))
+            return nullptr;
+        return &messages_[tail & (capacity_ - 1)];
+    }
+
+    /// Release message returned by Peek. Called by consumer.
+    void Pop() { tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    /// Return whether the queue is empty.
+    bool IsEmpty() const { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire); }
+    /// Return whether the queue is abandoned and may be removed once empty.
+    bool IsAbandoned() const { return abandoned_.load(std::memory_order_acquire); }
+
+private:
+    /// Capacity.
+    const unsigned capacity_;
+    /// Messages.
+    ea::unique_ptr<DeferredLogMessage[]> messages_;
+    /// Index of the next pushed message.
+    std::atomic<unsigned> head_{};
+    /// Index of the next popped message.
+    std::atomic<unsigned> tail_{};
+    /// Whether the producer thread has exited.
+    std::atomic<bool> abandoned_{};
+};
+
+namespace
+{
+
+/// Deferred message queue of the thread.
+struct ThreadLogQueue
+{
+    /// Abandon the queue when the thread exits.
+    ~ThreadLogQueue()
+    {
+        if (queue_)
+            queue_->Abandon();
+    }
+
+    /// Identifier of the log instance the queue belongs to.
+    unsigned instanceId_{};
+    /// Queue.
+    SharedPtr<DeferredLogQueue> queue_;
+};
+
+}
+
+static thread_local ThreadLogQueue threadLogQueue;
+
 unsigned FindLastNewlineInRange(const ea::string& str, unsigned position, unsigned count)
 {
     const char symbols[] = { '\n' };
@@ -180,11 +266,69 @@ Logger::Logger(void* logger)
 {
 }
 
-void Logger::Write(LogLevel level, const ea::string& message) const
+bool Logger::IsEnabled(LogLevel level) const
 {
     if (logger_ == nullptr)
+        return false;
+
+    // Unknown levels are reported as warnings
+    auto* logger = reinterpret_cast<spdlog::logger*>(logger_);
+    return logger->should_log(level < LOG_NONE ? ConvertLogLevel(level) : spdlog::level::warn);
+}
+
+bool Logger::BeginDeferredMessage(LogLevel level, DeferredLogMessage*& message) const
+{
+    Log* log = asyncLog.load(std::memory_order_acquire);
+    if (!log)
+        return false;
+
+    DeferredLogQueue* queue = log->GetThreadQueue();
+    message = queue->BeginPush();
+    if (!message && log->GetOverflowPolicy() == LogOverflowPolicy::Block)
+    {
+        // Log thread may already be gone, don't wait forever
+        while (!message && asyncLog.load(std::memory_order_acquire) == log)
+        {
+            std::this_thread::yield();
+            message = queue->BeginPush();
+        }
+    }
+
+    if (!message)
+    {
+        log->numDroppedMessages_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    message->logger_ = logger_;
+    message->level_ = level;
+    message->time_ = std::chrono::system_clock::now();
+    message->formatOffset_ = 0;
+    return true;
+}
+
+void Logger::EndDeferredMessage() const
+{
+    threadLogQueue.queue_->EndPush();
+}
+
+void Logger::Write(LogLevel level, const ea::string& message) const
+{
+    if (!IsEnabled(level))
         return;
 
+    DeferredLogMessage* deferredMessage = nullptr;
+    if (BeginDeferredMessage(level, deferredMessage))
+    {
+        if (deferredMessage)
+        {
+            new (deferredMessage->storage_) ea::string(message);
+            deferredMessage->formatFunction_ = &Detail::FormatStoredLogMessage;
+            EndDeferredMessage();
+        }
+        return;
+    }
+
     auto* logger = reinterpret_cast<spdlog::logger*>(logger_);
 
     switch (level)
@@ -257,10 +401,40 @@ public:
     std::shared_ptr<spdlog::sinks::dist_sink_mt> sinkProxy_;
 };
 
+/// Log thread. Formats and writes deferred messages.
+class Log::AsyncThread : public Thread
+{
+public:
+    /// Construct.
+    explicit AsyncThread(Log* log)
+        : Thread("Log")
+        , log_(log)
+    {
+    }
+
+    /// Process messages until stopped. Remaining messages are processed before exit.
+    void ThreadFunction() override
+    {
+        while (shouldRun_)
+        {
+            if (!log_->ProcessDeferredMessages())
+                Time::Sleep(1);
+        }
+
+        while (log_->ProcessDeferredMessages())
+            ;
+    }
+
+private:
+    /// Log.
+    Log* log_{};
+};
+
 Log::Log(Context* context) :
     Object(context),
     impl_(new LogImpl(context)),
-    formatPattern_("[%H:%M:%S] [%l] [%n] : %v")
+    formatPattern_("[%H:%M:%S] [%l] [%n] : %v"),
+    instanceId_(++logInstanceCounter)
 {
 #if !__EMSCRIPTEN__
     spdlog::flush_every(std::chrono::seconds(5));
@@ -270,6 +444,9 @@ Log::Log(Context* context) :
 
 Log::~Log()
 {
+    SetAsync(false);
+    // Messages queued after the log thread was stopped
+    ProcessDeferredMessages();
     spdlog::shutdown();
 }
 
@@ -313,6 +490,108 @@ void Log::SetLevel(LogLevel level)
     spdlog::set_level(ConvertLogLevel(level));
 }
 
+void Log::SetAsync(bool async)
+{
+    if (async == IsAsync())
+        return;
+
+    if (async)
+    {
+        // Only one log may be asynchronous at a time
+        Log* expected = nullptr;
+        if (!asyncLog.compare_exchange_strong(expected, this))
+            return;
+
+        asyncThread_ = ea::make_unique<AsyncThread>(this);
+        if (!asyncThread_->Run())
+        {
+            asyncThread_ = nullptr;
+            asyncLog.store(nullptr, std::memory_order_release);
+        }
+    }
+    else
+    {
+        asyncLog.store(nullptr, std::memory_order_release);
+        asyncThread_->Stop();
+        asyncThread_ = nullptr;
+    }
+}
+
+void Log::Flush()
+{
+    if (!IsAsync())
+        return;
+
+    // Queues are kept alive by the copy, so it's safe to wait outside of the lock
+    ea::vector<SharedPtr<DeferredLogQueue>> queues;
+    {
+        MutexLock lock(queuesMutex_);
+        queues = queues_;
+    }
+
+    for (DeferredLogQueue* queue : queues)
+    {
+        while (!queue->IsEmpty())
+            std::this_thread::yield();
+    }
+}
+
+DeferredLogQueue* Log::GetThreadQueue()
+{
+    if (threadLogQueue.instanceId_ == instanceId_)
+        return threadLogQueue.queue_;
+
+    // Queue of the previous log instance is not used anymore
+    if (threadLogQueue.queue_)
+        threadLogQueue.queue_->Abandon();
+
+    MutexLock lock(queuesMutex_);
+    queues_.push_back(MakeShared<DeferredLogQueue>(queueCapacity_));
+    threadLogQueue.instanceId_ = instanceId_;
+    threadLogQueue.queue_ = queues_.back();
+    return threadLogQueue.queue_;
+}
+
+bool Log::ProcessDeferredMessages()
+{
+    bool processed = false;
+
+    // Take snapshot of the queues and remove queues of exited threads. Abandoned flag is checked first,
+    // so the queue cannot receive new messages after it's found empty.
+    {
+        MutexLock lock(queuesMutex_);
+        ea::erase_if(queues_, [](const SharedPtr<DeferredLogQueue>& queue) { return queue->IsAbandoned() && queue->IsEmpty(); });
+        processedQueues_ = queues_;
+    }
+
+    // Format messages outside of the lock so new threads are not blocked on registration
+    for (DeferredLogQueue* queue : processedQueues_)
+    {
+        while (DeferredLogMessage* message = queue->Peek())
+        {
+            const char* format = reinterpret_cast<const char*>(message->storage_ + message->formatOffset_);
+            const ea::string text = message->formatFunction_(format, message->storage_);
+            auto* logger = reinterpret_cast<spdlog::logger*>(message->logger_);
+            const spdlog::level::level_enum level = message->level_ < LOG_NONE ? ConvertLogLevel(message->level_) : spdlog::level::warn;
+
+            spdlog::details::log_msg msg(logger->name(), level, spdlog::string_view_t(text.data(), text.size()));
+            msg.time = message->time_;
+            for (const auto& sink : logger->sinks())
+            {
+                if (sink->should_log(level))
+                    sink->log(msg);
+            }
+            if (level >= logger->flush_level() && level != spdlog::level::off)
+                logger->flush();
+
+            queue->Pop();
+            processed = true;
+        }
+    }
+    processedQueues_.clear();
+    return processed;
+}
+
 void Log::SetQuiet(bool quiet)
 {
     quiet_ = quiet;
@@ -426,15 +705,15 @@ void Log::PumpThreadMessages()
         return;
     }
 
-    MutexLock lock(logMutex_);
-
-    // Process messages accumulated from other threads (if any)
-    while (!threadMessages_.empty())
     {
-        const StoredLogMessage& stored = threadMessages_.front();
-        SendMessageEvent(stored.level_, stored.timestamp_, stored.logger_, stored.message_);
-        threadMessages_.pop_front();
+        MutexLock lock(logMutex_);
+        ea::swap(pumpedMessages_, threadMessages_);
     }
+
+    // Send messages accumulated from other threads (if any) in one batch
+    for (const StoredLogMessage& stored : pumpedMessages_)
+        SendMessageEvent(stored.level_, stored.timestamp_, stored.logger_, stored.message_);
+    pumpedMessages_.clear();
 }
 
 }
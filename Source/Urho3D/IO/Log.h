@@ -22,13 +22,19 @@
 
 #pragma once
 
-#include <EASTL/list.h>
+#include <EASTL/unique_ptr.h>
+#include <EASTL/vector.h>
 
 #include "../Core/Macros.h"
 #include "../Core/Mutex.h"
 #include "../Core/Object.h"
 #include "../Core/StringUtils.h"
 
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <tuple>
+
 namespace Urho3D
 {
 
@@ -77,6 +83,8 @@ static const char* logLevelNames[] =
 };
 
 class File;
+struct DeferredLogMessage;
+class DeferredLogQueue;
 
 /// Stored log message from another thread.
 struct StoredLogMessage
@@ -103,6 +111,77 @@ struct StoredLogMessage
     ea::string message_{};
 };
 
+/// Policy applied when asynchronous log queue of the thread is full.
+enum class LogOverflowPolicy
+{
+    /// Drop the message and increment the counter of dropped messages.
+    Drop,
+    /// Wait until the log thread frees space in the queue.
+    Block,
+};
+
+#ifndef SWIG
+/// Log message recorded by the producer thread. Arguments and a copy of the format string are stored in place
+/// and formatted by the log thread.
+/// @nobind
+struct DeferredLogMessage
+{
+    /// Max size of stored arguments and format string. Messages that don't fit are formatted immediately.
+    static const unsigned MaxStorageSize = 256;
+    /// Max alignment of stored arguments.
+    static const unsigned MaxArgumentsAlignment = 16;
+    /// Function that formats stored arguments and destroys them.
+    using FormatFunction = ea::string(*)(const char* format, void* arguments);
+
+    /// Instance of spdlog logger.
+    void* logger_{};
+    /// Message level.
+    LogLevel level_{};
+    /// Time when message was logged.
+    std::chrono::system_clock::time_point time_;
+    /// Offset of the format string in the storage.
+    unsigned formatOffset_{};
+    /// Format function.
+    FormatFunction formatFunction_{};
+    /// Storage of the arguments followed by the format string.
+    alignas(MaxArgumentsAlignment) unsigned char storage_[MaxStorageSize];
+};
+
+namespace Detail
+{
+
+/// Convert log argument to the type stored in deferred message. Strings are copied, everything else is stored as is.
+template <class T> inline const T& StoreLogArgument(const T& value) { return value; }
+inline ea::string StoreLogArgument(const char* value) { return value ? value : ""; }
+inline ea::string StoreLogArgument(char* value) { return value ? value : ""; }
+inline ea::string StoreLogArgument(ea::string_view value) { return ea::string(value); }
+
+/// Tuple of stored log arguments.
+template <class... Args>
+using StoredLogArguments = std::tuple<std::decay_t<decltype(StoreLogArgument(std::declval<const Args&>()))>...>;
+
+/// Format stored log arguments and destroy them.
+template <class Tuple>
+ea::string FormatStoredLogArguments(const char* format, void* arguments)
+{
+    auto& tuple = *reinterpret_cast<Tuple*>(arguments);
+    ea::string result = std::apply([format](const auto&... args) { return Format(format, args...); }, tuple);
+    tuple.~Tuple();
+    return result;
+}
+
+/// Return stored message without arguments and destroy it.
+inline ea::string FormatStoredLogMessage(const char* format, void* arguments)
+{
+    auto& message = *reinterpret_cast<ea::string*>(arguments);
+    ea::string result = ea::move(message);
+    message.~basic_string();
+    return result;
+}
+
+}
+#endif
+
 class LogImpl;
 class Log;
 
@@ -123,7 +202,37 @@ public:
     template<typename... Args> void Info(const char* format, Args... args) const    { Write(LOG_INFO, format, args...); }
     template<typename... Args> void Warning(const char* format, Args... args) const { Write(LOG_WARNING, format, args...); }
     template<typename... Args> void Error(const char* format, Args... args) const   { Write(LOG_ERROR, format, args...); }
-    template<typename... Args> void Write(LogLevel level, const char* format, Args... args) const { Write(level, Format(format, args...)); }
+    template<typename... Args> void Write(LogLevel level, const char* format, Args... args) const
+    {
+        if (!IsEnabled(level))
+            return;
+
+        using Tuple = Detail::StoredLogArguments<Args...>;
+        if constexpr (sizeof...(Args) != 0 && sizeof(Tuple) < DeferredLogMessage::MaxStorageSize
+            && alignof(Tuple) <= DeferredLogMessage::MaxArgumentsAlignment)
+        {
+            // Format string is copied after the arguments, it doesn't have to outlive the call
+            const unsigned formatSize = strlen(format) + 1;
+            if (sizeof(Tuple) + formatSize <= DeferredLogMessage::MaxStorageSize)
+            {
+                DeferredLogMessage* message = nullptr;
+                if (BeginDeferredMessage(level, message))
+                {
+                    if (message)
+                    {
+                        new (message->storage_) Tuple(Detail::StoreLogArgument(args)...);
+                        memcpy(message->storage_ + sizeof(Tuple), format, formatSize);
+                        message->formatOffset_ = sizeof(Tuple);
+                        message->formatFunction_ = &Detail::FormatStoredLogArguments<Tuple>;
+                        EndDeferredMessage();
+                    }
+                    return;
+                }
+            }
+        }
+
+        Write(level, Format(format, args...));
+    }
 
     template<typename... Args> void Trace(const ea::string& message) const   { Write(LOG_TRACE, message.c_str()); }
     template<typename... Args> void Debug(const ea::string& message) const   { Write(LOG_DEBUG, message.c_str()); }
@@ -133,7 +242,16 @@ public:
 
     void Write(LogLevel level, const ea::string& message) const;
 
+    /// Return whether the messages of given level are logged.
+    bool IsEnabled(LogLevel level) const;
+
 protected:
+    /// Begin message in the queue of current thread. Return false if the log is not asynchronous.
+    /// Message is null if it was dropped because the queue is full.
+    bool BeginDeferredMessage(LogLevel level, DeferredLogMessage*& message) const;
+    /// Publish message returned by BeginDeferredMessage.
+    void EndDeferredMessage() const;
+
     /// Instance of spdlog logger.
     void* logger_ = nullptr;
 };
@@ -165,9 +283,33 @@ public:
     /// @property
     void SetQuiet(bool quiet);
 
+    /// Set whether to format and write messages on the log thread. Messages are queued by producer threads without locking.
+    /// @property
+    void SetAsync(bool async);
+    /// Set policy applied when the message queue of the thread is full.
+    /// @property
+    void SetOverflowPolicy(LogOverflowPolicy policy) { overflowPolicy_ = policy; }
+    /// Set capacity of per-thread message queues. Affects only queues created after the call.
+    /// @property
+    void SetQueueCapacity(unsigned capacity) { queueCapacity_ = Max(capacity, 1u); }
+    /// Wait until all queued messages are written. Does nothing if the log is not asynchronous.
+    void Flush();
+
     /// Return logging level.
     /// @property
     LogLevel GetLevel() const { return level_; }
+    /// Return whether messages are formatted and written on the log thread.
+    /// @property
+    bool IsAsync() const { return asyncThread_ != nullptr; }
+    /// Return policy applied when the message queue of the thread is full.
+    /// @property
+    LogOverflowPolicy GetOverflowPolicy() const { return overflowPolicy_; }
+    /// Return capacity of per-thread message queues.
+    /// @property
+    unsigned GetQueueCapacity() const { return queueCapacity_; }
+    /// Return number of messages dropped because of queue overflow.
+    /// @property
+    unsigned GetNumDroppedMessages() const { return numDroppedMessages_.load(std::memory_order_relaxed); }
 
     /// Return whether log is in quiet mode (only errors printed to standard error stream).
     /// @property
@@ -182,8 +324,15 @@ public:
     void PumpThreadMessages();
 
 private:
+    class AsyncThread;
+    friend class Logger;
+
     /// Handle end of frame. Process the threaded log messages.
     void HandleEndFrame(StringHash eventType, VariantMap& eventData) { PumpThreadMessages(); }
+    /// Return deferred message queue of current thread, create if necessary.
+    DeferredLogQueue* GetThreadQueue();
+    /// Format and write queued messages. Called from the log thread. Return whether any message was written.
+    bool ProcessDeferredMessages();
 
     /// Implementation hiding spdlog class types from public headers.
     SharedPtr<LogImpl> impl_;
@@ -192,7 +341,25 @@ private:
     /// Mutex for threaded operation.
     Mutex logMutex_{};
     /// Log messages from other threads.
-    ea::list<StoredLogMessage> threadMessages_{};
+    ea::vector<StoredLogMessage> threadMessages_{};
+    /// Log messages being sent from the main thread.
+    ea::vector<StoredLogMessage> pumpedMessages_{};
+    /// Log thread. Exists only in asynchronous mode.
+    ea::unique_ptr<AsyncThread> asyncThread_;
+    /// Per-thread deferred message queues. Queues of exited threads are removed once empty.
+    ea::vector<SharedPtr<DeferredLogQueue>> queues_;
+    /// Queues being processed by the log thread.
+    ea::vector<SharedPtr<DeferredLogQueue>> processedQueues_;
+    /// Mutex for queue registration.
+    Mutex queuesMutex_;
+    /// Unique identifier of the log instance, used to validate per-thread queue cache.
+    unsigned instanceId_{};
+    /// Policy applied when the message queue of the thread is full.
+    LogOverflowPolicy overflowPolicy_{LogOverflowPolicy::Drop};
+    /// Capacity of per-thread message queues.
+    unsigned queueCapacity_{512};
+    /// Number of dropped messages.
+    std::atomic<unsigned> numDroppedMessages_{};
     /// Logging level.
 #ifdef _DEBUG
     LogLevel level_ = LOG_DEBUG;
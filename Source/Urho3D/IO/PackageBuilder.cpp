@@ -0,0 +1,521 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
+#include "../IO/FileSystem.h"
+#include "../IO/Log.h"
+#include "../IO/PackageBuilder.h"
+#include "../IO/PackageFile.h"
+
+#include <EASTL/sort.h>
+#include <EASTL/unordered_set.h>
+
+#include <LZ4/lz4.h>
+#include <LZ4/lz4hc.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Max size of uncompressed data read at once.
+const unsigned MAX_BATCH_SIZE = 8 * 1024 * 1024;
+/// Max number of files read at once.
+const unsigned MAX_BATCH_FILES = 256;
+/// Max size of the file compressed with the dictionary. Such files always consist of one block.
+const unsigned MAX_DICTIONARY_FILE_SIZE = 16 * 1024;
+/// Max total size of dictionary samples.
+const unsigned MAX_DICTIONARY_SAMPLES_SIZE = 2 * 1024 * 1024;
+/// Min number of samples to train dictionary.
+const unsigned MIN_DICTIONARY_SAMPLES = 8;
+/// Length of sequences whose frequency is counted during dictionary training.
+const unsigned DICTIONARY_DMER_SIZE = 8;
+/// Length of dictionary segments.
+const unsigned DICTIONARY_SEGMENT_SIZE = 64;
+
+static_assert(MAX_DICTIONARY_FILE_SIZE <= PACKAGE_BLOCK_SIZE, "Files compressed with dictionary should fit into one block");
+
+/// Return whether the file is small text file that may benefit from the dictionary.
+bool IsDictionaryCandidate(const ea::string& fileName, unsigned size)
+{
+    if (!size || size > MAX_DICTIONARY_FILE_SIZE)
+        return false;
+    const ea::string extension = GetExtension(fileName);
+    return extension == ".json" || extension == ".xml";
+}
+
+/// Read d-mer at given position.
+unsigned long long ReadDmer(const unsigned char* data)
+{
+    unsigned long long dmer = 0;
+    memcpy(&dmer, data, DICTIONARY_DMER_SIZE);
+    return dmer;
+}
+
+/// Deleter of LZ4 HC stream.
+struct LZ4StreamHCDeleter
+{
+    void operator()(LZ4_streamHC_t* stream) const { LZ4_freeStreamHC(stream); }
+};
+
+}
+
+PackageBuilder::PackageBuilder(Context* context)
+    : Object(context)
+{
+}
+
+PackageBuilder::~PackageBuilder() = default;
+
+bool PackageBuilder::Create(const ea::string& fileName, bool compress)
+{
+    output_ = MakeShared<File>(context_);
+    if (!output_->Open(fileName, FILE_WRITE))
+    {
+        output_ = nullptr;
+        return false;
+    }
+
+    compress_ = compress;
+    dictionaryTrained_ = false;
+    dictionary_.clear();
+    files_.clear();
+    nextFile_ = 0;
+    entries_.clear();
+    totalDataSize_ = 0;
+    checksum_ = 0;
+    entriesOffset_ = 0;
+
+    WriteHeader();
+    return true;
+}
+
+void PackageBuilder::AddFile(const ea::string& entryName, const ea::string& fileName)
+{
+    PackageBuilderEntry& file = files_.emplace_back();
+    file.name_ = entryName;
+    file.fileName_ = fileName;
+}
+
+bool PackageBuilder::WriteNextBatch()
+{
+    if (!output_ || failed_ || nextFile_ >= files_.size())
+        return false;
+
+    URHO3D_PROFILE("WritePackageBatch");
+
+    if (compress_ && dictionaryEnabled_ && !dictionaryTrained_)
+        TrainPackageDictionary();
+
+    struct BatchFile
+    {
+        /// Index in added files.
+        unsigned index_{};
+        /// Uncompressed data.
+        ea::vector<unsigned char> data_;
+        /// First compressed block.
+        unsigned firstBlock_{};
+        /// Number of compressed blocks.
+        unsigned numBlocks_{};
+    };
+
+    struct Block
+    {
+        /// Uncompressed data.
+        const unsigned char* data_{};
+        /// Uncompressed size.
+        unsigned size_{};
+        /// Whether to try compression with the dictionary.
+        bool tryDictionary_{};
+        /// Compressed data.
+        ea::vector<unsigned char> packedData_;
+        /// Whether the compressed data uses the dictionary.
+        bool useDictionary_{};
+    };
+
+    // Read files sequentially
+    ea::vector<BatchFile> batch;
+    unsigned batchSize = 0;
+    while (nextFile_ < files_.size() && batchSize < MAX_BATCH_SIZE && batch.size() < MAX_BATCH_FILES)
+    {
+        const unsigned index = nextFile_++;
+        const ea::string& fileName = files_[index].fileName_;
+        File source(context_, fileName);
+        if (!source.IsOpen())
+        {
+            URHO3D_LOGERROR("Could not open file {}, skipped", fileName);
+            continue;
+        }
+
+        BatchFile& batchFile = batch.emplace_back();
+        batchFile.index_ = index;
+        batchFile.data_.resize(source.GetSize());
+        if (!batchFile.data_.empty() && source.Read(batchFile.data_.data(), batchFile.data_.size()) != batchFile.data_.size())
+        {
+            URHO3D_LOGERROR("Could not read file {}, skipped", fileName);
+            batch.pop_back();
+            continue;
+        }
+        batchSize += batchFile.data_.size();
+    }
+
+    // Compress blocks of all files in parallel
+    ea::vector<Block> blocks;
+    if (compress_)
+    {
+        for (BatchFile& batchFile : batch)
+        {
+            const unsigned size = batchFile.data_.size();
+            const bool tryDictionary = !dictionary_.empty() && IsDictionaryCandidate(files_[batchFile.index_].fileName_, size);
+            batchFile.firstBlock_ = blocks.size();
+            for (unsigned offset = 0; offset < size; offset += PACKAGE_BLOCK_SIZE)
+            {
+                Block& block = blocks.emplace_back();
+                block.data_ = batchFile.data_.data() + offset;
+                block.size_ = Min(size - offset, PACKAGE_BLOCK_SIZE);
+                block.tryDictionary_ = tryDictionary;
+                ++batchFile.numBlocks_;
+            }
+        }
+
+        const auto compressBlocks = [&](unsigned beginIndex, unsigned endIndex)
+        {
+            ea::unique_ptr<LZ4_streamHC_t, LZ4StreamHCDeleter> stream{LZ4_createStreamHC()};
+            ea::vector<unsigned char> dictionaryBuffer;
+            for (unsigned i = beginIndex; i < endIndex; ++i)
+            {
+                Block& block = blocks[i];
+                const int bound = LZ4_compressBound(block.size_);
+                block.packedData_.resize(bound);
+                int packedSize = LZ4_compress_HC_extStateHC(stream.get(), (const char*)block.data_,
+                    (char*)block.packedData_.data(), block.size_, bound, 0);
+
+                // Keep dictionary compression only if it's better
+                if (block.tryDictionary_)
+                {
+                    dictionaryBuffer.resize(bound);
+                    LZ4_resetStreamHC(stream.get(), 0);
+                    LZ4_loadDictHC(stream.get(), (const char*)dictionary_.data(), dictionary_.size());
+                    const int dictionaryPackedSize = LZ4_compress_HC_continue(stream.get(), (const char*)block.data_,
+                        (char*)dictionaryBuffer.data(), block.size_, bound);
+                    if (dictionaryPackedSize > 0 && dictionaryPackedSize < packedSize)
+                    {
+                        block.packedData_.swap(dictionaryBuffer);
+                        block.useDictionary_ = true;
+                        packedSize = dictionaryPackedSize;
+                    }
+                }
+
+                block.packedData_.resize(ea::max(packedSize, 0));
+            }
+        };
+
+        if (auto workQueue = GetSubsystem<WorkQueue>())
+            ForEachParallel(workQueue, 1u, blocks.size(), compressBlocks);
+        else
+            compressBlocks(0, blocks.size());
+
+        // Zero-size block cannot be decompressed, so the package would be broken
+        for (const BatchFile& batchFile : batch)
+        {
+            for (unsigned i = 0; i < batchFile.numBlocks_; ++i)
+            {
+                if (blocks[batchFile.firstBlock_ + i].packedData_.empty())
+                {
+                    URHO3D_LOGERROR("LZ4 compression failed for file {} at offset {}",
+                        files_[batchFile.index_].fileName_, i * PACKAGE_BLOCK_SIZE);
+                    failed_ = true;
+                    return false;
+                }
+            }
+        }
+    }
+
+    // Write files sequentially
+    for (const BatchFile& batchFile : batch)
+    {
+        entries_.push_back(files_[batchFile.index_]);
+        PackageBuilderEntry& entry = entries_.back();
+        const unsigned size = batchFile.data_.size();
+        entry.offset_ = output_->GetPosition();
+        entry.size_ = size;
+        for (unsigned char value : batchFile.data_)
+        {
+            checksum_ = SDBMHash(checksum_, value);
+            entry.checksum_ = SDBMHash(entry.checksum_, value);
+        }
+
+        if (!compress_)
+            output_->Write(batchFile.data_.data(), size);
+        else
+        {
+            for (unsigned i = 0; i < batchFile.numBlocks_; ++i)
+            {
+                const Block& block = blocks[batchFile.firstBlock_ + i];
+                output_->WriteUShort(static_cast<unsigned short>(block.size_));
+                output_->WriteUShort(static_cast<unsigned short>(block.packedData_.size()));
+                output_->Write(block.packedData_.data(), block.packedData_.size());
+                entry.blockSizes_.push_back(static_cast<unsigned short>(block.packedData_.size()));
+                entry.useDictionary_ = block.useDictionary_;
+            }
+        }
+
+        entry.packedSize_ = output_->GetPosition() - entry.offset_;
+        totalDataSize_ += size;
+    }
+
+    return true;
+}
+
+bool PackageBuilder::Finish()
+{
+    if (!output_)
+        return false;
+
+    while (WriteNextBatch())
+    {
+    }
+
+    if (failed_)
+    {
+        output_->Close();
+        output_ = nullptr;
+        return false;
+    }
+
+    entriesOffset_ = output_->GetPosition();
+
+    // Compressed packages of version 1 have block index and optional dictionary
+    if (compress_)
+    {
+        output_->WriteVLE(PACKAGE_BLOCK_SIZE);
+        output_->WriteVLE(dictionary_.size());
+        output_->Write(dictionary_.data(), dictionary_.size());
+    }
+
+    for (const PackageBuilderEntry& entry : entries_)
+    {
+        output_->WriteString(entry.name_);
+        output_->WriteUInt(entry.offset_);
+        output_->WriteUInt(entry.size_);
+        output_->WriteUInt(entry.checksum_);
+        if (compress_)
+        {
+            output_->WriteUByte(entry.useDictionary_ ? PACKAGE_ENTRY_USE_DICTIONARY : 0);
+            output_->WriteVLE(entry.blockSizes_.size());
+            for (unsigned short blockSize : entry.blockSizes_)
+                output_->WriteUShort(blockSize);
+        }
+    }
+
+    // Write package size to the end of file to allow finding it linked to an executable file
+    const unsigned currentSize = output_->GetSize();
+    output_->WriteUInt(currentSize + sizeof(unsigned));
+
+    WriteHeader();
+    output_->Close();
+    output_ = nullptr;
+    return true;
+}
+
+void PackageBuilder::TrainPackageDictionary()
+{
+    URHO3D_PROFILE("TrainPackageDictionary");
+
+    dictionaryTrained_ = true;
+
+    ea::vector<ea::vector<unsigned char>> samples;
+    unsigned samplesSize = 0;
+    for (const PackageBuilderEntry& file : files_)
+    {
+        File source(context_, file.fileName_);
+        const unsigned size = source.GetSize();
+        if (!source.IsOpen() || !IsDictionaryCandidate(file.fileName_, size))
+            continue;
+        if (samplesSize + size > MAX_DICTIONARY_SAMPLES_SIZE)
+            break;
+
+        ea::vector<unsigned char>& sample = samples.emplace_back(size);
+        if (source.Read(sample.data(), size) != size)
+        {
+            samples.pop_back();
+            continue;
+        }
+        samplesSize += size;
+    }
+
+    if (samples.size() >= MIN_DICTIONARY_SAMPLES)
+        dictionary_ = TrainDictionary(samples, maxDictionarySize_);
+}
+
+ea::vector<unsigned char> PackageBuilder::TrainDictionary(const ea::vector<ea::vector<unsigned char>>& samples, unsigned maxSize)
+{
+    ea::vector<unsigned char> dictionary;
+    const unsigned maxSegments = maxSize / DICTIONARY_SEGMENT_SIZE;
+    if (!maxSegments)
+        return dictionary;
+
+    // Small corpus fits into the dictionary as is
+    unsigned totalSize = 0;
+    unsigned long long numPositions = 0;
+    for (const ea::vector<unsigned char>& sample : samples)
+    {
+        totalSize += sample.size();
+        if (sample.size() >= DICTIONARY_SEGMENT_SIZE)
+            numPositions += sample.size() - DICTIONARY_SEGMENT_SIZE + 1;
+    }
+    if (totalSize <= maxSize)
+    {
+        for (const ea::vector<unsigned char>& sample : samples)
+            dictionary.insert(dictionary.end(), sample.begin(), sample.end());
+        return dictionary;
+    }
+
+    // Count number of samples containing each d-mer
+    ea::unordered_map<unsigned long long, unsigned> frequencies;
+    ea::unordered_set<unsigned long long> sampleDmers;
+    for (const ea::vector<unsigned char>& sample : samples)
+    {
+        if (sample.size() < DICTIONARY_SEGMENT_SIZE)
+            continue;
+
+        sampleDmers.clear();
+        for (unsigned i = 0; i + DICTIONARY_DMER_SIZE <= sample.size(); ++i)
+            sampleDmers.insert(ReadDmer(&sample[i]));
+        for (unsigned long long dmer : sampleDmers)
+            ++frequencies[dmer];
+    }
+
+    struct Segment
+    {
+        /// Score of the segment.
+        unsigned long long score_{};
+        /// Index of the sample.
+        unsigned sample_{};
+        /// Offset in the sample.
+        unsigned offset_{};
+    };
+
+    // Corpus is split into epochs and the best segment of each epoch is selected, like in COVER algorithm of zstd.
+    // Segment score is sum of frequencies of distinct d-mers in the segment.
+    // D-mers of selected segments are not counted anymore so other epochs don't select the same content.
+    const unsigned dmersPerSegment = DICTIONARY_SEGMENT_SIZE - DICTIONARY_DMER_SIZE + 1;
+    const unsigned long long epochSize = ea::max(1ull, numPositions / maxSegments);
+    ea::vector<Segment> segments;
+    ea::unordered_map<unsigned long long, unsigned> activeDmers;
+    Segment bestSegment;
+    unsigned long long epochPosition = 0;
+
+    const auto finishEpoch = [&]()
+    {
+        if (bestSegment.score_ > 0)
+        {
+            const unsigned char* data = samples[bestSegment.sample_].data() + bestSegment.offset_;
+            for (unsigned i = 0; i < dmersPerSegment; ++i)
+                frequencies[ReadDmer(data + i)] = 0;
+            segments.push_back(bestSegment);
+        }
+        bestSegment = Segment{};
+        epochPosition = 0;
+    };
+
+    for (unsigned sampleIndex = 0; sampleIndex < samples.size() && segments.size() < maxSegments; ++sampleIndex)
+    {
+        const ea::vector<unsigned char>& sample = samples[sampleIndex];
+        if (sample.size() < DICTIONARY_SEGMENT_SIZE)
+            continue;
+
+        const unsigned lastOffset = sample.size() - DICTIONARY_SEGMENT_SIZE;
+        unsigned long long score = 0;
+        bool windowValid = false;
+        for (unsigned offset = 0; offset <= lastOffset && segments.size() < maxSegments; ++offset)
+        {
+            // Rebuild the window when the epoch starts, frequencies might have changed
+            if (!windowValid)
+            {
+                activeDmers.clear();
+                score = 0;
+                for (unsigned i = 0; i < dmersPerSegment; ++i)
+                {
+                    const unsigned long long dmer = ReadDmer(&sample[offset + i]);
+                    if (activeDmers[dmer]++ == 0)
+                        score += frequencies[dmer];
+                }
+                windowValid = true;
+            }
+            else
+            {
+                const unsigned long long removedDmer = ReadDmer(&sample[offset - 1]);
+                if (--activeDmers[removedDmer] == 0)
+                    score -= frequencies[removedDmer];
+                const unsigned long long addedDmer = ReadDmer(&sample[offset + dmersPerSegment - 1]);
+                if (activeDmers[addedDmer]++ == 0)
+                    score += frequencies[addedDmer];
+            }
+
+            if (score > bestSegment.score_)
+                bestSegment = Segment{score, sampleIndex, offset};
+
+            if (++epochPosition >= epochSize)
+            {
+                finishEpoch();
+                windowValid = false;
+            }
+        }
+    }
+    if (segments.size() < maxSegments)
+        finishEpoch();
+
+    // Most valuable segments go last
+    ea::quick_sort(segments.begin(), segments.end(), [](const Segment& lhs, const Segment& rhs)
+    {
+        if (lhs.score_ != rhs.score_)
+            return lhs.score_ < rhs.score_;
+        return lhs.sample_ != rhs.sample_ ? lhs.sample_ < rhs.sample_ : lhs.offset_ < rhs.offset_;
+    });
+
+    for (const Segment& segment : segments)
+    {
+        const unsigned char* data = samples[segment.sample_].data() + segment.offset_;
+        dictionary.insert(dictionary.end(), data, data + DICTIONARY_SEGMENT_SIZE);
+    }
+    return dictionary;
+}
+
+void PackageBuilder::WriteHeader()
+{
+    output_->Seek(0);
+    output_->WriteFileID(compress_ ? "RLZ4" : "RPAK");
+    output_->WriteUInt(entries_.size());
+    output_->WriteUInt(checksum_);
+    output_->WriteUInt(compress_ ? 1 : 0);                 // Version
+    output_->WriteInt64(entriesOffset_);
+}
+
+}
@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "../Core/Object.h"
+#include "../IO/File.h"
+
+namespace Urho3D
+{
+
+/// Uncompressed size of compressed package blocks.
+static const unsigned PACKAGE_BLOCK_SIZE = 32768;
+/// Default max size of package LZ4 dictionary.
+static const unsigned DEFAULT_PACKAGE_DICTIONARY_SIZE = 32768;
+
+/// Entry of the package being built.
+/// @nobind
+struct PackageBuilderEntry
+{
+    /// Name of the entry in the package.
+    ea::string name_;
+    /// Source file name.
+    ea::string fileName_;
+    /// Offset of the entry data from the package start.
+    unsigned offset_{};
+    /// Uncompressed size.
+    unsigned size_{};
+    /// Size of the entry data in the package.
+    unsigned packedSize_{};
+    /// Checksum of uncompressed data.
+    unsigned checksum_{};
+    /// Packed sizes of compressed blocks.
+    ea::vector<unsigned short> blockSizes_;
+    /// Whether the compressed blocks use the package dictionary.
+    bool useDictionary_{};
+};
+
+/// Writes RPAK/RLZ4 package files. Files are written in batches. Compressed packages consist of independent LZ4 blocks,
+/// which are compressed in parallel on WorkQueue threads, and store block index so files can be read from any offset.
+/// Small JSON and XML files may be compressed with LZ4 dictionary trained from the files of the package.
+/// Should be used from the main thread.
+class URHO3D_API PackageBuilder : public Object
+{
+    URHO3D_OBJECT(PackageBuilder, Object);
+
+public:
+    /// Construct.
+    explicit PackageBuilder(Context* context);
+    /// Destruct.
+    ~PackageBuilder() override;
+
+    /// Create package file. Return true if successful.
+    bool Create(const ea::string& fileName, bool compress);
+    /// Set whether to train dictionary for small JSON and XML files. Has effect only for compressed packages.
+    void SetDictionaryEnabled(bool enable) { dictionaryEnabled_ = enable; }
+    /// Set max size of the dictionary.
+    void SetMaxDictionarySize(unsigned size) { maxDictionarySize_ = size; }
+    /// Add file to the package. File is read when its batch is written.
+    void AddFile(const ea::string& entryName, const ea::string& fileName);
+    /// Write next batch of added files. Return false if there are no files left or if writing has failed.
+    bool WriteNextBatch();
+    /// Write remaining files and file list, then close the package. Return false if any file could not be compressed.
+    bool Finish();
+
+    /// Train LZ4 dictionary from sample data. Segments that occur in many samples are preferred. Most valuable segments
+    /// are placed at the end of the dictionary, which is closest to the compressed data.
+    static ea::vector<unsigned char> TrainDictionary(const ea::vector<ea::vector<unsigned char>>& samples, unsigned maxSize);
+
+    /// Return whether the package is compressed.
+    bool IsCompressed() const { return compress_; }
+    /// Return written entries.
+    const ea::vector<PackageBuilderEntry>& GetEntries() const { return entries_; }
+    /// Return number of added files.
+    unsigned GetNumFiles() const { return files_.size(); }
+    /// Return number of processed files, including the skipped ones.
+    unsigned GetNumProcessedFiles() const { return nextFile_; }
+    /// Return progress between 0 and 1.
+    float GetProgress() const { return files_.empty() ? 1.0f : static_cast<float>(nextFile_) / files_.size(); }
+    /// Return total size of uncompressed file data.
+    unsigned long long GetTotalDataSize() const { return totalDataSize_; }
+    /// Return checksum of all file data.
+    unsigned GetChecksum() const { return checksum_; }
+    /// Return size of the trained dictionary.
+    unsigned GetDictionarySize() const { return dictionary_.size(); }
+
+private:
+    /// Train dictionary from small JSON and XML files of the package.
+    void TrainPackageDictionary();
+    /// Write package header.
+    void WriteHeader();
+
+    /// Package file.
+    SharedPtr<File> output_;
+    /// Whether to compress files.
+    bool compress_{};
+    /// Whether to train dictionary.
+    bool dictionaryEnabled_{};
+    /// Whether the dictionary is already trained.
+    bool dictionaryTrained_{};
+    /// Whether compression has failed. The package is not finished then.
+    bool failed_{};
+    /// Max size of the dictionary.
+    unsigned maxDictionarySize_{DEFAULT_PACKAGE_DICTIONARY_SIZE};
+    /// Dictionary.
+    ea::vector<unsigned char> dictionary_;
+    /// Added files. Only name and file name are filled.
+    ea::vector<PackageBuilderEntry> files_;
+    /// Index of the next file to write.
+    unsigned nextFile_{};
+    /// Written entries.
+    ea::vector<PackageBuilderEntry> entries_;
+    /// Total size of uncompressed file data.
+    unsigned long long totalDataSize_{};
+    /// Checksum of all file data.
+    unsigned checksum_{};
+    /// Offset of the file list.
+    long long entriesOffset_{};
+};
+
+}
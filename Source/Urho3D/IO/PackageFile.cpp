@@ -91,18 +91,43 @@ bool PackageFile::Open(const ea::string& fileName, unsigned startOffset)
     unsigned numFiles = file->ReadUInt();
     checksum_ = file->ReadUInt();
 
+    unsigned version = 0;
     if (id == "RPAK" || id == "RLZ4")
     {
         // New PAK file format includes two extra PAK header fields:
-        // * Version. At this time this field is unused and is always 0. It will be used in the future if PAK format needs to be extended.
+        // * Version. 0 for uncompressed packages. Compressed packages of version 1 have block index and optional dictionary.
         // * File list offset. New format writes file list in the end of the file. This allows PAK creation without knowing entire file list
         //   beforehand.
-        unsigned version = file->ReadUInt();                        // Reserved for future use.
-        assert(version == 0);
+        version = file->ReadUInt();
+        if (version > (compressed_ ? 1u : 0u))
+        {
+            URHO3D_LOGERROR("{} has unsupported package version {}", fileName, version);
+            return false;
+        }
         int64_t fileListOffset = file->ReadInt64();                 // New format has file list at the end of the file.
         file->Seek(fileListOffset);                                 // TODO: Serializer/Deserializer do not support files bigger than 4 GB
     }
 
+    blockSize_ = 0;
+    blockOffsets_.clear();
+    dictionary_.reset();
+    dictionarySize_ = 0;
+    if (version >= 1)
+    {
+        blockSize_ = file->ReadVLE();
+        dictionarySize_ = file->ReadVLE();
+        if (!blockSize_ || dictionarySize_ > totalSize_)
+        {
+            URHO3D_LOGERROR(fileName + " has invalid block index");
+            return false;
+        }
+        if (dictionarySize_)
+        {
+            dictionary_ = new unsigned char[dictionarySize_];
+            file->Read(dictionary_.get(), dictionarySize_);
+        }
+    }
+
     for (unsigned i = 0; i < numFiles; ++i)
     {
         ea::string entryName = file->ReadString();
@@ -110,7 +135,26 @@ bool PackageFile::Open(const ea::string& fileName, unsigned startOffset)
         newEntry.offset_ = file->ReadUInt() + startOffset;
         totalDataSize_ += (newEntry.size_ = file->ReadUInt());
         newEntry.checksum_ = file->ReadUInt();
-        if (!compressed_ && newEntry.offset_ + newEntry.size_ > totalSize_)
+        if (!compressed_)
+            newEntry.packedSize_ = newEntry.size_;
+        if (version >= 1)
+        {
+            // Block index stores packed size of each block. Blocks are prefixed by 4 byte headers
+            newEntry.useDictionary_ = (file->ReadUByte() & PACKAGE_ENTRY_USE_DICTIONARY) != 0;
+            newEntry.firstBlock_ = blockOffsets_.size();
+            newEntry.numBlocks_ = file->ReadVLE();
+            if (newEntry.numBlocks_ != (newEntry.size_ + blockSize_ - 1) / blockSize_ || (newEntry.useDictionary_ && !dictionary_))
+            {
+                URHO3D_LOGERROR("File entry " + entryName + " has invalid block index");
+                return false;
+            }
+            for (unsigned j = 0; j < newEntry.numBlocks_; ++j)
+            {
+                blockOffsets_.push_back(newEntry.packedSize_);
+                newEntry.packedSize_ += 2 * sizeof(unsigned short) + file->ReadUShort();
+            }
+        }
+        if (newEntry.offset_ + newEntry.packedSize_ > totalSize_ || (!compressed_ && newEntry.offset_ + newEntry.size_ > totalSize_))
         {
             URHO3D_LOGERROR("File entry " + entryName + " outside package file");
             return false;
@@ -24,9 +24,14 @@
 
 #include "../Core/Object.h"
 
+#include <EASTL/shared_array.h>
+
 namespace Urho3D
 {
 
+/// Package entry flag: compressed blocks of the entry use the package dictionary.
+static const unsigned char PACKAGE_ENTRY_USE_DICTIONARY = 1;
+
 /// %File entry within the package file.
 struct PackageEntry
 {
@@ -36,6 +41,14 @@ struct PackageEntry
     unsigned size_;
     /// File checksum.
     unsigned checksum_;
+    /// Size of the entry data in the package. Unknown (0) for compressed packages without block index.
+    unsigned packedSize_;
+    /// Index of the first block in the package block index.
+    unsigned firstBlock_;
+    /// Number of compressed blocks. 0 if the package has no block index.
+    unsigned numBlocks_;
+    /// Whether the compressed blocks use the package dictionary.
+    bool useDictionary_;
 };
 
 /// Stores files of a directory tree sequentially for convenient access.
@@ -88,6 +101,21 @@ public:
     /// @property
     bool IsCompressed() const { return compressed_; }
 
+    /// Return whether the compressed files have block index and may be read from any offset.
+    bool HasBlockIndex() const { return blockSize_ != 0; }
+
+    /// Return uncompressed size of compressed blocks. 0 if the package has no block index.
+    unsigned GetBlockSize() const { return blockSize_; }
+
+    /// Return offsets of compressed blocks relative to the beginning of their entries. Indexed by PackageEntry::firstBlock_.
+    const ea::vector<unsigned>& GetBlockOffsets() const { return blockOffsets_; }
+
+    /// Return LZ4 dictionary of the package. Null if the package has no dictionary.
+    const ea::shared_array<unsigned char>& GetDictionary() const { return dictionary_; }
+
+    /// Return size of the LZ4 dictionary.
+    unsigned GetDictionarySize() const { return dictionarySize_; }
+
     /// Return list of file names in the package.
     const ea::vector<ea::string> GetEntryNames() const { return entries_.keys(); }
 
@@ -121,6 +149,14 @@ private:
     unsigned checksum_;
     /// Compressed flag.
     bool compressed_;
+    /// Uncompressed size of compressed blocks, 0 if the package has no block index.
+    unsigned blockSize_{};
+    /// Block offsets of all entries.
+    ea::vector<unsigned> blockOffsets_;
+    /// LZ4 dictionary shared by compressed blocks of small files.
+    ea::shared_array<unsigned char> dictionary_;
+    /// Size of the LZ4 dictionary.
+    unsigned dictionarySize_{};
 };
 
 }
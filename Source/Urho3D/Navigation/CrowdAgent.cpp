@@ -263,7 +263,9 @@ void CrowdAgent::UpdateParameters(unsigned scope)
             params.obstacleAvoidanceType = (unsigned char)obstacleAvoidanceType_;
         }
 
-        crowdManager_->GetCrowd()->updateAgentParameters(agentCrowdId_, &params);
+        int localAgent;
+        if (dtCrowd* crowd = crowdManager_->GetAgentCrowd(agentCrowdId_, localAgent))
+            crowd->updateAgentParameters(localAgent, &params);
     }
 }
 
@@ -337,7 +339,9 @@ void CrowdAgent::SetTargetPosition(const Vector3& position)
         {
             dtPolyRef nearestRef;
             Vector3 nearestPos = crowdManager_->FindNearestPoint(position, queryFilterType_, &nearestRef);
-            crowdManager_->GetCrowd()->requestMoveTarget(agentCrowdId_, nearestRef, nearestPos.Data());
+            int localAgent;
+            if (dtCrowd* crowd = crowdManager_->GetAgentCrowd(agentCrowdId_, localAgent))
+                crowd->requestMoveTarget(localAgent, nearestRef, nearestPos.Data());
         }
     }
 }
@@ -350,8 +354,10 @@ void CrowdAgent::SetTargetVelocity(const Vector3& velocity)
         requestedTargetType_ = CA_REQUESTEDTARGET_VELOCITY;
         MarkNetworkUpdate();
 
-        if (IsInCrowd())
-            crowdManager_->GetCrowd()->requestMoveVelocity(agentCrowdId_, velocity.Data());
+        int localAgent;
+        dtCrowd* crowd = IsInCrowd() ? crowdManager_->GetAgentCrowd(agentCrowdId_, localAgent) : nullptr;
+        if (crowd)
+            crowd->requestMoveVelocity(localAgent, velocity.Data());
     }
 }
 
@@ -362,8 +368,10 @@ void CrowdAgent::ResetTarget()
         requestedTargetType_ = CA_REQUESTEDTARGET_NONE;
         MarkNetworkUpdate();
 
-        if (IsInCrowd())
-            crowdManager_->GetCrowd()->resetMoveTarget(agentCrowdId_);
+        int localAgent;
+        dtCrowd* crowd = IsInCrowd() ? crowdManager_->GetAgentCrowd(agentCrowdId_, localAgent) : nullptr;
+        if (crowd)
+            crowd->resetMoveTarget(localAgent);
     }
 }
 
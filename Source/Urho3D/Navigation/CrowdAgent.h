@@ -212,9 +212,9 @@ public:
     bool IsInCrowd() const;
 
 protected:
-    /// Handle crowd agent pre-update. 
+    /// Handle crowd agent pre-update. Called from worker threads when regions are updated in parallel, so overrides must be thread-safe unless threaded update of CrowdManager is disabled.
     virtual void OnCrowdVelocityUpdate(dtCrowdAgent* ag, float* pos, float dt);
-    /// Handle crowd agent being updated. It is called by CrowdManager::Update() via callback.
+    /// Handle crowd agent being updated. It is called by CrowdManager::Update() after all regions are updated if agent position or state has changed.
     virtual void OnCrowdPositionUpdate(dtCrowdAgent* ag, float* pos, float dt);
     /// Handle node being assigned.
     void OnNodeSet(Node* node) override;
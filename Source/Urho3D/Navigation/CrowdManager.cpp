@@ -24,6 +24,7 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../IO/Log.h"
 #include "../Navigation/CrowdAgent.h"
@@ -34,6 +35,7 @@
 #include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
 
+#include <Detour/DetourCommon.h>
 #include <DetourCrowd/DetourCrowd.h>
 
 #include "../DebugNew.h"
@@ -45,6 +47,7 @@ extern const char* NAVIGATION_CATEGORY;
 
 static const unsigned DEFAULT_MAX_AGENTS = 512;
 static const float DEFAULT_MAX_AGENT_RADIUS = 0.f;
+static const float DEFAULT_REGION_SIZE = 0.f;
 
 static const StringVector filterTypesStructureElementNames =
 {
@@ -71,11 +74,12 @@ static const StringVector obstacleAvoidanceTypesStructureElementNames =
 
 void CrowdAgentUpdateCallback(bool positionUpdate, dtCrowdAgent* ag, float* pos, float dt)
 {
-    auto crowdAgent = static_cast<CrowdAgent*>(ag->params.userData);
+    // Position updates are applied by CrowdManager after all regions are updated
     if (positionUpdate)
-        crowdAgent->OnCrowdPositionUpdate(ag, pos, dt);
-    else
-        crowdAgent->OnCrowdVelocityUpdate(ag, pos, dt);
+        return;
+
+    auto crowdAgent = static_cast<CrowdAgent*>(ag->params.userData);
+    crowdAgent->OnCrowdVelocityUpdate(ag, pos, dt);
 }
 
 CrowdManager::CrowdManager(Context* context) :
@@ -91,8 +95,7 @@ CrowdManager::CrowdManager(Context* context) :
 
 CrowdManager::~CrowdManager()
 {
-    dtFreeCrowd(crowd_);
-    crowd_ = nullptr;
+    ReleaseRegions();
 }
 
 void CrowdManager::RegisterObject(Context* context)
@@ -101,6 +104,7 @@ void CrowdManager::RegisterObject(Context* context)
 
     URHO3D_ATTRIBUTE("Max Agents", unsigned, maxAgents_, DEFAULT_MAX_AGENTS, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Max Agent Radius", float, maxAgentRadius_, DEFAULT_MAX_AGENT_RADIUS, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Region Size", GetRegionSize, SetRegionSize, float, DEFAULT_REGION_SIZE, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Navigation Mesh", unsigned, navigationMeshId_, 0, AM_DEFAULT | AM_COMPONENTID);
     URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Filter Types", GetQueryFilterTypesAttr, SetQueryFilterTypesAttr,
         VariantVector, Variant::emptyVariantVector, AM_DEFAULT)
@@ -137,12 +141,15 @@ void CrowdManager::ApplyAttributes()
 
 void CrowdManager::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
 {
-    if (debug && crowd_)
+    if (!debug)
+        return;
+
+    for (const CrowdRegion& region : regions_)
     {
         // Current position-to-target line
-        for (int i = 0; i < crowd_->getAgentCount(); i++)
+        for (int i = 0; i < region.crowd_->getAgentCount(); i++)
         {
-            const dtCrowdAgent* ag = crowd_->getAgent(i);
+            const dtCrowdAgent* ag = region.crowd_->getAgent(i);
             if (!ag->active)
                 continue;
 
@@ -247,6 +254,17 @@ void CrowdManager::SetMaxAgents(unsigned maxAgents)
     }
 }
 
+void CrowdManager::SetRegionSize(float regionSize)
+{
+    regionSize = Max(0.f, regionSize);
+    if (regionSize != regionSize_)
+    {
+        regionSize_ = regionSize;
+        CreateCrowd();
+        MarkNetworkUpdate();
+    }
+}
+
 void CrowdManager::SetMaxAgentRadius(float maxAgentRadius)
 {
     if (maxAgentRadius != maxAgentRadius_ && maxAgentRadius > 0.f)
@@ -310,6 +328,8 @@ void CrowdManager::SetQueryFilterTypesAttr(const VariantVector& value)
         }
         ++queryFilterType;
     }
+
+    SyncRegionSettings();
 }
 
 void CrowdManager::SetIncludeFlags(unsigned queryFilterType, unsigned short flags)
@@ -320,6 +340,7 @@ void CrowdManager::SetIncludeFlags(unsigned queryFilterType, unsigned short flag
         filter->setIncludeFlags(flags);
         if (numQueryFilterTypes_ < queryFilterType + 1)
             numQueryFilterTypes_ = queryFilterType + 1;
+        SyncRegionSettings();
         MarkNetworkUpdate();
     }
 }
@@ -332,6 +353,7 @@ void CrowdManager::SetExcludeFlags(unsigned queryFilterType, unsigned short flag
         filter->setExcludeFlags(flags);
         if (numQueryFilterTypes_ < queryFilterType + 1)
             numQueryFilterTypes_ = queryFilterType + 1;
+        SyncRegionSettings();
         MarkNetworkUpdate();
     }
 }
@@ -346,6 +368,7 @@ void CrowdManager::SetAreaCost(unsigned queryFilterType, unsigned areaID, float
             numQueryFilterTypes_ = queryFilterType + 1;
         if (numAreas_[queryFilterType] < areaID + 1)
             numAreas_[queryFilterType] = areaID + 1;
+        SyncRegionSettings();
         MarkNetworkUpdate();
     }
 }
@@ -378,6 +401,8 @@ void CrowdManager::SetObstacleAvoidanceTypesAttr(const VariantVector& value)
         }
         ++obstacleAvoidanceType;
     }
+
+    SyncRegionSettings();
 }
 
 void CrowdManager::SetObstacleAvoidanceParams(unsigned obstacleAvoidanceType, const CrowdObstacleAvoidanceParams& params)
@@ -387,6 +412,7 @@ void CrowdManager::SetObstacleAvoidanceParams(unsigned obstacleAvoidanceType, co
         crowd_->setObstacleAvoidanceParams(obstacleAvoidanceType, reinterpret_cast<const dtObstacleAvoidanceParams*>(&params));
         if (numObstacleAvoidanceTypes_ < obstacleAvoidanceType + 1)
             numObstacleAvoidanceTypes_ = obstacleAvoidanceType + 1;
+        SyncRegionSettings();
         MarkNetworkUpdate();
     }
 }
@@ -581,18 +607,14 @@ bool CrowdManager::CreateCrowd()
     {
         queryFilterTypeConfiguration = GetQueryFilterTypesAttr();
         obstacleAvoidanceTypeConfiguration = GetObstacleAvoidanceTypesAttr();
-        dtFreeCrowd(crowd_);
+        ReleaseRegions();
     }
-    crowd_ = dtAllocCrowd();
 
-    // Initialize the crowd
+    // Initialize the primary crowd, other regions are created on demand
     if (maxAgentRadius_ == 0.f)
         maxAgentRadius_ = navigationMesh_->GetAgentRadius();
-    if (!crowd_->init(maxAgents_, maxAgentRadius_, navigationMesh_->navMesh_, CrowdAgentUpdateCallback))
-    {
-        URHO3D_LOGERROR("Could not initialize DetourCrowd");
+    if (GetOrCreateRegion(IntVector2::ZERO) == M_MAX_UNSIGNED)
         return false;
-    }
 
     // Reconfigure the newly initialized crowd
     SetQueryFilterTypesAttr(queryFilterTypeConfiguration);
@@ -617,6 +639,9 @@ int CrowdManager::AddAgent(CrowdAgent* agent, const Vector3& pos)
 {
     if (!crowd_ || !navigationMesh_ || !agent)
         return -1;
+    const unsigned regionIndex = GetOrCreateRegion(GetRegionCell(pos));
+    if (regionIndex == M_MAX_UNSIGNED)
+        return -1;
     dtCrowdAgentParams params{};
     params.userData = agent;
     if (agent->radius_ == 0.f)
@@ -625,17 +650,198 @@ int CrowdManager::AddAgent(CrowdAgent* agent, const Vector3& pos)
         agent->height_ = navigationMesh_->GetAgentHeight();
     // dtCrowd::addAgent() requires the query filter type to find the nearest position on navmesh as the initial agent's position
     params.queryFilterType = (unsigned char)agent->GetQueryFilterType();
-    return crowd_->addAgent(pos.Data(), &params);
+
+    CrowdRegion& region = regions_[regionIndex];
+    const int localAgent = region.crowd_->addAgent(pos.Data(), &params);
+    if (localAgent == -1)
+        return -1;
+    ++region.numAgents_;
+    return static_cast<int>(regionIndex * regionCapacity_) + localAgent;
 }
 
 void CrowdManager::RemoveAgent(CrowdAgent* agent)
 {
     if (!crowd_ || !agent)
         return;
-    dtCrowdAgent* agt = crowd_->getEditableAgent(agent->GetAgentCrowdId());
+    const int agentId = agent->GetAgentCrowdId();
+    int localAgent;
+    dtCrowd* crowd = GetAgentCrowd(agentId, localAgent);
+    if (!crowd)
+        return;
+    dtCrowdAgent* agt = crowd->getEditableAgent(localAgent);
     if (agt)
+    {
+        if (agt->active)
+            --regions_[agentId / regionCapacity_].numAgents_;
         agt->params.userData = nullptr;
-    crowd_->removeAgent(agent->GetAgentCrowdId());
+    }
+    crowd->removeAgent(localAgent);
+
+    agentStates_.agents_[agentId] = nullptr;
+    agentStates_.changed_[agentId] = false;
+    agentStates_.handoff_[agentId] = false;
+}
+
+IntVector2 CrowdManager::GetRegionCell(const Vector3& position) const
+{
+    if (regionSize_ <= 0.f)
+        return IntVector2::ZERO;
+    return { FloorToInt(position.x_ / regionSize_), FloorToInt(position.z_ / regionSize_) };
+}
+
+unsigned CrowdManager::GetOrCreateRegion(const IntVector2& cell)
+{
+    const auto iter = regionIndices_.find(cell);
+    if (iter != regionIndices_.end())
+        return iter->second;
+
+    if (!crowd_)
+        regionCapacity_ = maxAgents_;
+
+    dtCrowd* crowd = dtAllocCrowd();
+    if (!crowd->init(regionCapacity_, maxAgentRadius_, navigationMesh_->navMesh_, CrowdAgentUpdateCallback))
+    {
+        URHO3D_LOGERROR("Could not initialize DetourCrowd");
+        dtFreeCrowd(crowd);
+        return M_MAX_UNSIGNED;
+    }
+
+    const unsigned regionIndex = regions_.size();
+    regions_.push_back(CrowdRegion{ crowd, cell, 0 });
+    regionIndices_[cell] = regionIndex;
+    agentStates_.Resize(regions_.size() * regionCapacity_);
+
+    if (!crowd_)
+        crowd_ = crowd;
+    else
+        SyncRegionSettings();
+    return regionIndex;
+}
+
+void CrowdManager::SyncRegionSettings()
+{
+    for (unsigned i = 1; i < regions_.size(); ++i)
+    {
+        dtCrowd* crowd = regions_[i].crowd_;
+        for (int j = 0; j < DT_CROWD_MAX_QUERY_FILTER_TYPE; ++j)
+            *crowd->getEditableFilter(j) = *crowd_->getFilter(j);
+        for (int j = 0; j < DT_CROWD_MAX_OBSTAVOIDANCE_PARAMS; ++j)
+            crowd->setObstacleAvoidanceParams(j, crowd_->getObstacleAvoidanceParams(j));
+    }
+}
+
+void CrowdManager::ExportAgentStates(unsigned regionIndex)
+{
+    const CrowdRegion& region = regions_[regionIndex];
+    const unsigned offset = regionIndex * regionCapacity_;
+    const int numAgents = region.crowd_->getAgentCount();
+
+    // Agents are handed off only when they are far enough from the region to avoid oscillation
+    const float margin = maxAgentRadius_;
+    const float minX = region.cell_.x_ * regionSize_ - margin;
+    const float maxX = (region.cell_.x_ + 1) * regionSize_ + margin;
+    const float minZ = region.cell_.y_ * regionSize_ - margin;
+    const float maxZ = (region.cell_.y_ + 1) * regionSize_ + margin;
+
+    for (int i = 0; i < numAgents; ++i)
+    {
+        const unsigned index = offset + i;
+        const dtCrowdAgent* ag = region.crowd_->getAgent(i);
+        auto* crowdAgent = ag->active ? static_cast<CrowdAgent*>(ag->params.userData) : nullptr;
+
+        agentStates_.agents_[index] = crowdAgent;
+        agentStates_.changed_[index] = false;
+        agentStates_.handoff_[index] = false;
+        if (!crowdAgent)
+            continue;
+
+        const Vector3 position{ ag->npos };
+        agentStates_.positions_[index] = position;
+        agentStates_.velocities_[index] = Vector3{ ag->vel };
+        agentStates_.agentStates_[index] = ag->state;
+        agentStates_.targetStates_[index] = ag->targetState;
+        agentStates_.changed_[index] = position != crowdAgent->previousPosition_
+            || ag->state != crowdAgent->previousAgentState_ || ag->targetState != crowdAgent->previousTargetState_;
+        agentStates_.handoff_[index] = regionSize_ > 0.f
+            && (position.x_ < minX || position.x_ > maxX || position.z_ < minZ || position.z_ > maxZ);
+    }
+}
+
+void CrowdManager::SyncAgents(float delta)
+{
+    URHO3D_PROFILE("SyncCrowdAgents");
+
+    // Event handlers may recreate the crowd and reset agent states, so the size is checked on every iteration.
+    // Reset states are not marked as changed or handed off, so they are skipped
+    for (unsigned index = 0; index < agentStates_.changed_.size(); ++index)
+    {
+        if (!agentStates_.changed_[index])
+            continue;
+        agentStates_.changed_[index] = false;
+
+        // Event handlers may have removed the agent
+        CrowdAgent* crowdAgent = agentStates_.agents_[index];
+        auto* ag = const_cast<dtCrowdAgent*>(GetDetourCrowdAgent(index));
+        if (ag && ag->active && ag->params.userData == crowdAgent)
+            crowdAgent->OnCrowdPositionUpdate(ag, ag->npos, delta);
+    }
+
+    for (unsigned index = 0; index < agentStates_.handoff_.size(); ++index)
+    {
+        if (!agentStates_.handoff_[index])
+            continue;
+        agentStates_.handoff_[index] = false;
+
+        CrowdAgent* crowdAgent = agentStates_.agents_[index];
+        const dtCrowdAgent* ag = GetDetourCrowdAgent(index);
+        if (ag && ag->active && ag->params.userData == crowdAgent)
+            HandOffAgent(crowdAgent);
+    }
+}
+
+void CrowdManager::HandOffAgent(CrowdAgent* agent)
+{
+    int localAgent;
+    dtCrowd* oldCrowd = GetAgentCrowd(agent->GetAgentCrowdId(), localAgent);
+    const dtCrowdAgent* oldAgent = oldCrowd ? oldCrowd->getAgent(localAgent) : nullptr;
+    if (!oldAgent || !oldAgent->active)
+        return;
+
+    const unsigned regionIndex = GetOrCreateRegion(GetRegionCell(Vector3{ oldAgent->npos }));
+    if (regionIndex == M_MAX_UNSIGNED)
+        return;
+
+    // Keep the agent in the old region if the new one is full
+    CrowdRegion& region = regions_[regionIndex];
+    const int newLocalAgent = region.crowd_->addAgent(oldAgent->npos, &oldAgent->params);
+    if (newLocalAgent == -1)
+        return;
+
+    // Preserve motion state, the path corridor is rebuilt by the new crowd
+    dtCrowdAgent* newAgent = region.crowd_->getEditableAgent(newLocalAgent);
+    dtVcopy(newAgent->vel, oldAgent->vel);
+    dtVcopy(newAgent->dvel, oldAgent->dvel);
+    dtVcopy(newAgent->nvel, oldAgent->nvel);
+    newAgent->desiredSpeed = oldAgent->desiredSpeed;
+    if (oldAgent->targetState == DT_CROWDAGENT_TARGET_VELOCITY)
+        region.crowd_->requestMoveVelocity(newLocalAgent, oldAgent->targetPos);
+    else if (oldAgent->targetState != DT_CROWDAGENT_TARGET_NONE && oldAgent->targetState != DT_CROWDAGENT_TARGET_FAILED)
+        region.crowd_->requestMoveTarget(newLocalAgent, oldAgent->targetRef, oldAgent->targetPos);
+
+    RemoveAgent(agent);
+    ++region.numAgents_;
+    agent->agentCrowdId_ = static_cast<int>(regionIndex * regionCapacity_) + newLocalAgent;
+}
+
+void CrowdManager::ReleaseRegions()
+{
+    for (CrowdRegion& region : regions_)
+        dtFreeCrowd(region.crowd_);
+    regions_.clear();
+    regionIndices_.clear();
+    agentStates_ = CrowdAgentStates{};
+    crowd_ = nullptr;
+    regionCapacity_ = 0;
 }
 
 void CrowdManager::OnSceneSet(Scene* scene)
@@ -680,12 +886,43 @@ void CrowdManager::Update(float delta)
 {
     assert(crowd_ && navigationMesh_);
     URHO3D_PROFILE("UpdateCrowd");
-    crowd_->update(delta, nullptr);
+
+    const auto updateRegion = [&](unsigned regionIndex, CrowdRegion& region)
+    {
+        if (region.numAgents_ == 0)
+            return;
+        region.crowd_->update(delta, nullptr);
+        ExportAgentStates(regionIndex);
+    };
+
+    // Velocity shader is user code and is not guaranteed to be thread-safe
+    if (regions_.size() > 1 && threadedUpdate_ && !velocityShader_)
+        ForEachParallel(GetSubsystem<WorkQueue>(), regions_, updateRegion);
+    else
+    {
+        for (unsigned i = 0; i < regions_.size(); ++i)
+            updateRegion(i, regions_[i]);
+    }
+
+    SyncAgents(delta);
 }
 
 const dtCrowdAgent* CrowdManager::GetDetourCrowdAgent(int agent) const
 {
-    return crowd_ ? crowd_->getAgent(agent) : nullptr;
+    int localAgent;
+    dtCrowd* crowd = GetAgentCrowd(agent, localAgent);
+    return crowd ? crowd->getAgent(localAgent) : nullptr;
+}
+
+dtCrowd* CrowdManager::GetAgentCrowd(int agent, int& localAgent) const
+{
+    if (agent < 0 || regionCapacity_ == 0)
+        return nullptr;
+    const unsigned regionIndex = static_cast<unsigned>(agent) / regionCapacity_;
+    if (regionIndex >= regions_.size())
+        return nullptr;
+    localAgent = static_cast<int>(static_cast<unsigned>(agent) % regionCapacity_);
+    return regions_[regionIndex].crowd_;
 }
 
 const dtQueryFilter* CrowdManager::GetDetourQueryFilter(unsigned queryFilterType) const
@@ -22,8 +22,11 @@
 
 #pragma once
 
+#include "../Math/Vector2.h"
 #include "../Scene/Component.h"
 
+#include <EASTL/hash_map.h>
+
 #ifdef DT_POLYREF64
 using dtPolyRef = uint64_t;
 #else
@@ -56,10 +59,56 @@ struct CrowdObstacleAvoidanceParams
     unsigned char adaptiveDepth;    ///< adaptive
 };
 
+/// Crowd agent state exported after each crowd update, stored as structure of arrays indexed by agent crowd ID.
+struct CrowdAgentStates
+{
+    /// Crowd agents. Null if the agent slot is not used.
+    ea::vector<CrowdAgent*> agents_;
+    /// Agent positions.
+    ea::vector<Vector3> positions_;
+    /// Agent actual velocities.
+    ea::vector<Vector3> velocities_;
+    /// Agent states, see CrowdAgentState.
+    ea::vector<unsigned char> agentStates_;
+    /// Agent target states, see CrowdAgentTargetState.
+    ea::vector<unsigned char> targetStates_;
+    /// Whether the agent position or state changed since the last synchronization.
+    ea::vector<unsigned char> changed_;
+    /// Whether the agent should be handed off to another region.
+    ea::vector<unsigned char> handoff_;
+
+    /// Resize arrays.
+    void Resize(unsigned size)
+    {
+        agents_.resize(size);
+        positions_.resize(size);
+        velocities_.resize(size);
+        agentStates_.resize(size);
+        targetStates_.resize(size);
+        changed_.resize(size);
+        handoff_.resize(size);
+    }
+};
+
+/// Spatial region of the crowd simulated by separate Detour crowd.
+/// @nobind
+struct CrowdRegion
+{
+    /// Detour crowd.
+    dtCrowd* crowd_{};
+    /// Region cell.
+    IntVector2 cell_;
+    /// Number of agents in the region.
+    unsigned numAgents_{};
+};
+
 /// Callback used to adjust crowd agent velocity.
 using CrowdAgentVelocityShader = std::function<void(CrowdAgent* agent, float timeStep, Vector3& desiredVelocity, float& desiredSpeed)>;
 
 /// Crowd manager scene component. Should be added only to the root scene node.
+/// If region size is set, the crowd is partitioned into square regions that are updated in parallel.
+/// Agents are handed off to the neighbour region when they leave their region.
+/// Agents in different regions don't avoid each other.
 class URHO3D_API CrowdManager : public Component
 {
     URHO3D_OBJECT(CrowdManager, Component);
@@ -82,8 +131,11 @@ public:
     /// Add debug geometry to the debug renderer.
     void DrawDebugGeometry(bool depthTest);
 
-    /// Set velocity shader.
+    /// Set velocity shader. Regions are updated sequentially if velocity shader is set.
     void SetVelocityShader(const CrowdAgentVelocityShader& shader) { velocityShader_ = shader; }
+    /// Set whether regions are updated in worker threads. Disable if agents override CrowdAgent::OnCrowdVelocityUpdate with code that is not thread-safe.
+    /// @property
+    void SetThreadedUpdate(bool enable) { threadedUpdate_ = enable; }
     /// Update agent velocity using velocity shader.
     void UpdateAgentVelocity(CrowdAgent* agent, float timeStep, Vector3& desiredVelocity, float& desiredSpeed) const { if (velocityShader_) velocityShader_(agent, timeStep, desiredVelocity, desiredSpeed); }
 
@@ -93,9 +145,12 @@ public:
     void SetCrowdVelocity(const Vector3& velocity, Node* node = nullptr);
     /// Reset any crowd target for all crowd agents found in the specified node. Defaulted to scene node.
     void ResetCrowdTarget(Node* node = nullptr);
-    /// Set the maximum number of agents.
+    /// Set the maximum number of agents in each region.
     /// @property
     void SetMaxAgents(unsigned maxAgents);
+    /// Set the size of crowd region. Zero size disables partitioning.
+    /// @property
+    void SetRegionSize(float regionSize);
     /// Set the maximum radius of any agent.
     /// @property
     void SetMaxAgentRadius(float maxAgentRadius);
@@ -132,10 +187,25 @@ public:
     /// Perform a walkability raycast on the navigation mesh between start and end using the crowd initialized query extent (based on maxAgentRadius) and the specified query filter type. Return the point where a wall was hit, or the end point if no walls.
     Vector3 Raycast(const Vector3& start, const Vector3& end, int queryFilterType, Vector3* hitNormal = nullptr);
 
-    /// Get the maximum number of agents.
+    /// Get the maximum number of agents in each region.
     /// @property
     unsigned GetMaxAgents() const { return maxAgents_; }
 
+    /// Get the size of crowd region.
+    /// @property
+    float GetRegionSize() const { return regionSize_; }
+
+    /// Return whether regions are updated in worker threads.
+    /// @property
+    bool GetThreadedUpdate() const { return threadedUpdate_; }
+
+    /// Get the number of crowd regions.
+    /// @property
+    unsigned GetNumRegions() const { return regions_.size(); }
+
+    /// Get agent states exported after the last update.
+    const CrowdAgentStates& GetAgentStates() const { return agentStates_; }
+
     /// Get the maximum radius of any agent.
     /// @property
     float GetMaxAgentRadius() const { return maxAgentRadius_; }
@@ -176,6 +246,20 @@ protected:
     int AddAgent(CrowdAgent* agent, const Vector3& pos);
     /// Removes the detour crowd agent.
     void RemoveAgent(CrowdAgent* agent);
+    /// Return region cell containing the position.
+    IntVector2 GetRegionCell(const Vector3& position) const;
+    /// Return existing or create new region for the cell. Return region index or M_MAX_UNSIGNED on error.
+    unsigned GetOrCreateRegion(const IntVector2& cell);
+    /// Copy query filters and obstacle avoidance parameters from the primary crowd to other regions.
+    void SyncRegionSettings();
+    /// Export agent states of the region. May be called from worker threads.
+    void ExportAgentStates(unsigned regionIndex);
+    /// Apply exported agent states to the agents and hand off agents to other regions.
+    void SyncAgents(float delta);
+    /// Move agent to the region containing its position.
+    void HandOffAgent(CrowdAgent* agent);
+    /// Release all regions and Detour crowds.
+    void ReleaseRegions();
 
 protected:
     /// Handle scene being assigned.
@@ -184,10 +268,12 @@ protected:
     void Update(float delta);
     /// Get the detour crowd agent.
     const dtCrowdAgent* GetDetourCrowdAgent(int agent) const;
+    /// Get the detour crowd of the region containing agent and local agent index.
+    dtCrowd* GetAgentCrowd(int agent, int& localAgent) const;
     /// Get the detour query filter.
     const dtQueryFilter* GetDetourQueryFilter(unsigned queryFilterType) const;
 
-    /// Get the internal detour crowd component.
+    /// Get the primary internal detour crowd component.
     dtCrowd* GetCrowd() const { return crowd_; }
 
 private:
@@ -198,16 +284,28 @@ private:
     /// Handle component added in the scene to check for late addition of the navmesh.
     void HandleComponentAdded(StringHash eventType, VariantMap& eventData);
 
-    /// Internal Detour crowd object.
+    /// Primary internal Detour crowd object. Owned by the first region.
     dtCrowd* crowd_{};
+    /// Crowd regions.
+    ea::vector<CrowdRegion> regions_;
+    /// Region indices by cell.
+    ea::hash_map<IntVector2, unsigned> regionIndices_;
+    /// Exported agent states.
+    CrowdAgentStates agentStates_;
     /// Velocity shader.
     CrowdAgentVelocityShader velocityShader_;
+    /// Whether regions are updated in worker threads.
+    bool threadedUpdate_{true};
     /// NavigationMesh for which the crowd was created.
     WeakPtr<NavigationMesh> navigationMesh_;
     /// The NavigationMesh component Id for pending crowd creation.
     unsigned navigationMeshId_{};
-    /// The maximum number of agents the crowd can manage.
+    /// The maximum number of agents each region can manage.
     unsigned maxAgents_{};
+    /// The size of crowd region.
+    float regionSize_{};
+    /// The number of agent slots in each region, fixed when the primary crowd is created.
+    unsigned regionCapacity_{};
     /// The maximum radius of any agent that will be added to the crowd.
     float maxAgentRadius_{};
     /// Number of query filter types configured in the crowd. Limit to DT_CROWD_MAX_QUERY_FILTER_TYPE.
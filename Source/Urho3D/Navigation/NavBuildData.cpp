@@ -24,6 +24,8 @@
 
 #include <cassert>
 
+#include "../Graphics/Geometry.h"
+#include "../Graphics/VertexBuffer.h"
 #include "../Navigation/NavBuildData.h"
 
 #include <DetourTileCache/DetourTileCacheBuilder.h>
@@ -32,7 +34,98 @@
 namespace Urho3D
 {
 
+void NavGeometryData::Append(const NavGeometryData& other)
+{
+    const int destVertexStart = static_cast<int>(vertices_.size());
+    vertices_.insert(vertices_.end(), other.vertices_.begin(), other.vertices_.end());
+    for (int index : other.indices_)
+        indices_.push_back(index + destVertexStart);
+
+    offMeshVertices_.insert(offMeshVertices_.end(), other.offMeshVertices_.begin(), other.offMeshVertices_.end());
+    offMeshRadii_.insert(offMeshRadii_.end(), other.offMeshRadii_.begin(), other.offMeshRadii_.end());
+    offMeshFlags_.insert(offMeshFlags_.end(), other.offMeshFlags_.begin(), other.offMeshFlags_.end());
+    offMeshAreas_.insert(offMeshAreas_.end(), other.offMeshAreas_.begin(), other.offMeshAreas_.end());
+    offMeshDir_.insert(offMeshDir_.end(), other.offMeshDir_.begin(), other.offMeshDir_.end());
+    navAreas_.insert(navAreas_.end(), other.navAreas_.begin(), other.navAreas_.end());
+}
+
+bool NavTriMeshData::Define(const Geometry* geometry)
+{
+    if (!geometry)
+        return false;
+
+    const ea::vector<VertexElement>* elements = nullptr;
+    geometry->GetRawDataShared(vertexData_, vertexSize_, indexData_, indexSize_, elements);
+    if (!vertexData_ || !indexData_ || !elements || VertexBuffer::GetElementOffset(*elements, TYPE_VECTOR3, SEM_POSITION) != 0)
+        return false;
+
+    vertexStart_ = geometry->GetVertexStart();
+    vertexCount_ = geometry->GetVertexCount();
+    indexStart_ = geometry->GetIndexStart();
+    indexCount_ = geometry->GetIndexCount();
+    return indexCount_ != 0;
+}
+
+void NavGeometrySource::ExtractTriMeshes()
+{
+    for (const NavTriMeshData& triMesh : triMeshes_)
+    {
+        const unsigned destVertexStart = data_.vertices_.size();
+
+        for (unsigned k = triMesh.vertexStart_; k < triMesh.vertexStart_ + triMesh.vertexCount_; ++k)
+        {
+            const Vector3 vertex = transform_ * *reinterpret_cast<const Vector3*>(&triMesh.vertexData_[k * triMesh.vertexSize_]);
+            data_.vertices_.push_back(vertex);
+        }
+
+        // Copy remapped indices
+        if (triMesh.indexSize_ == sizeof(unsigned short))
+        {
+            const auto* indices = reinterpret_cast<const unsigned short*>(triMesh.indexData_.get()) + triMesh.indexStart_;
+            for (unsigned k = 0; k < triMesh.indexCount_; ++k)
+                data_.indices_.push_back(indices[k] - triMesh.vertexStart_ + destVertexStart);
+        }
+        else
+        {
+            const auto* indices = reinterpret_cast<const unsigned*>(triMesh.indexData_.get()) + triMesh.indexStart_;
+            for (unsigned k = 0; k < triMesh.indexCount_; ++k)
+                data_.indices_.push_back(indices[k] - triMesh.vertexStart_ + destVertexStart);
+        }
+    }
+
+    // Release references to the source data
+    triMeshes_.clear();
+}
+
+void NavGeometryIndex::FinalizeSources()
+{
+    extracted_.reset(new std::once_flag[sources_.size()]);
+}
+
+const NavGeometryData& NavGeometryIndex::GetSourceGeometry(unsigned sourceIndex) const
+{
+    assert(extracted_);
+
+    NavGeometrySource& source = sources_[sourceIndex];
+    std::call_once(extracted_[sourceIndex], [&source] { source.ExtractTriMeshes(); });
+    return source.data_;
+}
+
+void NavGeometryIndex::GetTileGeometry(NavGeometryData& dest, const IntVector2& tile, const BoundingBox& box) const
+{
+    const IntVector2 localTile = tile - beginTile_;
+    if (localTile.x_ < 0 || localTile.y_ < 0 || localTile.x_ >= numTiles_.x_ || localTile.y_ >= numTiles_.y_)
+        return;
+
+    for (unsigned sourceIndex : tileSources_[localTile.y_ * numTiles_.x_ + localTile.x_])
+    {
+        if (box.IsInsideFast(boundingBoxes_[sourceIndex]) != OUTSIDE)
+            dest.Append(GetSourceGeometry(sourceIndex));
+    }
+}
+
 NavBuildData::NavBuildData() :
+    NavGeometryData(),
     ctx_(new rcContext(true)),
     heightField_(nullptr),
     compactHeightField_(nullptr)
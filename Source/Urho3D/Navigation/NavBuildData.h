@@ -22,9 +22,15 @@
 
 #pragma once
 
+#include <EASTL/shared_array.h>
+#include <EASTL/unique_ptr.h>
 #include <EASTL/vector.h>
 
+#include <mutex>
+
 #include "../Math/BoundingBox.h"
+#include "../Math/Matrix3x4.h"
+#include "../Math/Vector2.h"
 #include "../Math/Vector3.h"
 
 class rcContext;
@@ -42,6 +48,8 @@ struct rcPolyMeshDetail;
 namespace Urho3D
 {
 
+class Geometry;
+
 /// Navigation area stub.
 struct URHO3D_API NavAreaStub
 {
@@ -51,16 +59,14 @@ struct URHO3D_API NavAreaStub
     unsigned char areaID_;
 };
 
-/// Navigation build data.
-struct URHO3D_API NavBuildData
+/// Navigation geometry in the navigation mesh space: triangles, off-mesh connections and area volumes.
+struct URHO3D_API NavGeometryData
 {
-    /// Constructor.
-    NavBuildData();
-    /// Destructor.
-    virtual ~NavBuildData();
+    /// Append geometry from another container. Indices are remapped.
+    void Append(const NavGeometryData& other);
+    /// Return whether there is no triangle geometry.
+    bool IsEmpty() const { return vertices_.empty() || indices_.empty(); }
 
-    /// World-space bounding box of the navigation mesh tile.
-    BoundingBox worldBoundingBox_;
     /// Vertices from geometries.
     ea::vector<Vector3> vertices_;
     /// Triangle indices from geometries.
@@ -75,14 +81,123 @@ struct URHO3D_API NavBuildData
     ea::vector<unsigned char> offMeshAreas_;
     /// Offmesh connection direction.
     ea::vector<unsigned char> offMeshDir_;
+    /// Pretransformed navigation areas, no correlation to the geometry above.
+    ea::vector<NavAreaStub> navAreas_;
+};
+
+/// Triangle mesh data referenced in the main thread and transformed into navigation geometry in worker threads.
+/// Holds shared vertex and index arrays, so the data stays valid if the source buffers are resized or released.
+/// @nobind
+struct URHO3D_API NavTriMeshData
+{
+    /// Capture data of the geometry. Return false if the geometry has no CPU-side triangle data.
+    bool Define(const Geometry* geometry);
+
+    /// Vertex data. Position is the first element of the vertex.
+    ea::shared_array<unsigned char> vertexData_;
+    /// Vertex size.
+    unsigned vertexSize_{};
+    /// Index data.
+    ea::shared_array<unsigned char> indexData_;
+    /// Index size.
+    unsigned indexSize_{};
+    /// First vertex.
+    unsigned vertexStart_{};
+    /// Number of vertices.
+    unsigned vertexCount_{};
+    /// First index.
+    unsigned indexStart_{};
+    /// Number of indices.
+    unsigned indexCount_{};
+};
+
+/// Navigation geometry source. Triangle meshes are extracted on first use, possibly in a worker thread.
+/// @nobind
+struct URHO3D_API NavGeometrySource
+{
+    /// Extract triangle meshes into the geometry data.
+    void ExtractTriMeshes();
+
+    /// Geometry data. Small shapes, off-mesh connections and area volumes are extracted in the main thread.
+    NavGeometryData data_;
+    /// Triangle meshes to extract.
+    ea::vector<NavTriMeshData> triMeshes_;
+    /// Transform of triangle meshes to the navigation mesh space.
+    Matrix3x4 transform_;
+};
+
+/// Navigation geometry collected from the scene once per build and bucketed by tiles.
+/// Shared between worker threads while tiles are built.
+/// @nobind
+struct URHO3D_API NavGeometryIndex
+{
+    /// Allocate extraction state of the sources. Should be called after all sources are added.
+    void FinalizeSources();
+    /// Return geometry of the source, extracting it on first call. Thread-safe.
+    const NavGeometryData& GetSourceGeometry(unsigned sourceIndex) const;
+    /// Append geometry of the sources overlapping the box of the tile. Thread-safe.
+    void GetTileGeometry(NavGeometryData& dest, const IntVector2& tile, const BoundingBox& box) const;
+
+    /// Bounding boxes of geometry sources.
+    ea::vector<BoundingBox> boundingBoxes_;
+    /// Geometry sources.
+    mutable ea::vector<NavGeometrySource> sources_;
+    /// Whether the source geometry is extracted.
+    mutable ea::unique_ptr<std::once_flag[]> extracted_;
+    /// First indexed tile.
+    IntVector2 beginTile_;
+    /// Number of indexed tiles.
+    IntVector2 numTiles_;
+    /// Indices of geometry sources which may overlap the tile, including tile border.
+    ea::vector<ea::vector<unsigned>> tileSources_;
+};
+
+/// Data of one navigation mesh tile or tile cache layer allocated by Detour.
+/// @nobind
+struct NavTileData
+{
+    /// Data.
+    unsigned char* data_{};
+    /// Data size.
+    int dataSize_{};
+};
+
+/// Result of navigation mesh tile build in worker thread, committed to the navigation mesh in the main thread.
+/// @nobind
+struct NavTileBuildResult
+{
+    /// Tile index.
+    IntVector2 tile_;
+    /// Whether the tile was successfully built.
+    bool success_{};
+    /// Built tile data, one element per layer. Owned by the result until committed.
+    ea::vector<NavTileData> layers_;
+    /// Time spent gathering tile geometry, microseconds.
+    long long geometryTime_{};
+    /// Time spent rasterizing and filtering the heightfield, microseconds.
+    long long rasterizeTime_{};
+    /// Time spent partitioning the heightfield into regions, microseconds.
+    long long regionsTime_{};
+    /// Time spent building polygon mesh or tile cache layers, microseconds.
+    long long meshTime_{};
+};
+
+/// Navigation build data.
+struct URHO3D_API NavBuildData : public NavGeometryData
+{
+    /// Constructor.
+    NavBuildData();
+    /// Destructor.
+    virtual ~NavBuildData();
+
+    /// World-space bounding box of the navigation mesh tile.
+    BoundingBox worldBoundingBox_;
     /// Recast context.
     rcContext* ctx_;
     /// Recast heightfield.
     rcHeightfield* heightField_;
     /// Recast compact heightfield.
     rcCompactHeightfield* compactHeightField_;
-    /// Pretransformed navigation areas, no correlation to the geometry above.
-    ea::vector<NavAreaStub> navAreas_;
 };
 
 struct URHO3D_API SimpleNavBuildData : public NavBuildData
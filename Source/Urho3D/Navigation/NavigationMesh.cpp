@@ -23,7 +23,10 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
+#include "../Core/Timer.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Drawable.h"
 #include "../Graphics/Geometry.h"
@@ -40,6 +43,7 @@
 #include "../Navigation/Navigable.h"
 #include "../Navigation/NavigationEvents.h"
 #include "../Navigation/NavigationMesh.h"
+#include "../Navigation/NavigationPathService.h"
 #include "../Navigation/Obstacle.h"
 #include "../Navigation/OffMeshConnection.h"
 #ifdef URHO3D_PHYSICS
@@ -84,6 +88,37 @@ static const float DEFAULT_DETAIL_SAMPLE_MAX_ERROR = 1.0f;
 static const int MAX_POLYS = 2048;
 
 
+/// Asynchronous rebuild of navigation mesh tiles. Shared between the main thread and worker threads.
+struct NavAsyncBuildJob
+{
+    /// Build parameters at the moment the rebuild was started.
+    NavBuildConfig config_;
+    /// Geometry captured for the rebuilt tiles.
+    NavGeometryIndex geometryIndex_;
+    /// Tiles being rebuilt.
+    ea::vector<NavTileBuildResult> results_;
+    /// Build function of one tile.
+    std::function<void(const NavBuildConfig& config, const NavGeometryIndex& geometryIndex, NavTileBuildResult& result)> buildTile_;
+    /// Index of the next tile to be taken by any thread.
+    std::atomic<unsigned> nextTile_{};
+    /// Number of taken tiles that are processed.
+    std::atomic<unsigned> numProcessed_{};
+    /// Whether the rebuild is cancelled.
+    std::atomic<bool> cancelled_{};
+};
+
+/// Build tiles of the asynchronous rebuild until none are left. Called from any thread.
+static void ProcessAsyncBuildTiles(NavAsyncBuildJob& job)
+{
+    const unsigned numTiles = job.results_.size();
+    for (unsigned index = job.nextTile_++; index < numTiles; index = job.nextTile_++)
+    {
+        if (!job.cancelled_)
+            job.buildTile_(job.config_, job.geometryIndex_, job.results_[index]);
+        ++job.numProcessed_;
+    }
+}
+
 /// Temporary data for finding a path.
 struct FindPathData
 {
@@ -226,6 +261,8 @@ void NavigationMesh::SetMeshName(const ea::string& newName)
 
 void NavigationMesh::SetTileSize(int size)
 {
+    CancelAsyncBuild(true);
+
     tileSize_ = Max(size, 16);
 
     MarkNetworkUpdate();
@@ -233,6 +270,8 @@ void NavigationMesh::SetTileSize(int size)
 
 void NavigationMesh::SetCellSize(float size)
 {
+    CancelAsyncBuild(true);
+
     cellSize_ = Max(size, M_EPSILON);
 
     MarkNetworkUpdate();
@@ -240,6 +279,8 @@ void NavigationMesh::SetCellSize(float size)
 
 void NavigationMesh::SetCellHeight(float height)
 {
+    CancelAsyncBuild(true);
+
     cellHeight_ = Max(height, M_EPSILON);
 
     MarkNetworkUpdate();
@@ -247,6 +288,8 @@ void NavigationMesh::SetCellHeight(float height)
 
 void NavigationMesh::SetAgentHeight(float height)
 {
+    CancelAsyncBuild(true);
+
     agentHeight_ = Max(height, M_EPSILON);
 
     MarkNetworkUpdate();
@@ -254,6 +297,8 @@ void NavigationMesh::SetAgentHeight(float height)
 
 void NavigationMesh::SetAgentRadius(float radius)
 {
+    CancelAsyncBuild(true);
+
     agentRadius_ = Max(radius, M_EPSILON);
 
     MarkNetworkUpdate();
@@ -261,6 +306,8 @@ void NavigationMesh::SetAgentRadius(float radius)
 
 void NavigationMesh::SetAgentMaxClimb(float maxClimb)
 {
+    CancelAsyncBuild(true);
+
     agentMaxClimb_ = Max(maxClimb, M_EPSILON);
 
     MarkNetworkUpdate();
@@ -268,6 +315,8 @@ void NavigationMesh::SetAgentMaxClimb(float maxClimb)
 
 void NavigationMesh::SetAgentMaxSlope(float maxSlope)
 {
+    CancelAsyncBuild(true);
+
     agentMaxSlope_ = Max(maxSlope, 0.0f);
 
     MarkNetworkUpdate();
@@ -275,6 +324,8 @@ void NavigationMesh::SetAgentMaxSlope(float maxSlope)
 
 void NavigationMesh::SetRegionMinSize(float size)
 {
+    CancelAsyncBuild(true);
+
     regionMinSize_ = Max(size, M_EPSILON);
 
     MarkNetworkUpdate();
@@ -282,6 +333,8 @@ void NavigationMesh::SetRegionMinSize(float size)
 
 void NavigationMesh::SetRegionMergeSize(float size)
 {
+    CancelAsyncBuild(true);
+
     regionMergeSize_ = Max(size, M_EPSILON);
 
     MarkNetworkUpdate();
@@ -289,6 +342,8 @@ void NavigationMesh::SetRegionMergeSize(float size)
 
 void NavigationMesh::SetEdgeMaxLength(float length)
 {
+    CancelAsyncBuild(true);
+
     edgeMaxLength_ = Max(length, M_EPSILON);
 
     MarkNetworkUpdate();
@@ -296,6 +351,8 @@ void NavigationMesh::SetEdgeMaxLength(float length)
 
 void NavigationMesh::SetEdgeMaxError(float error)
 {
+    CancelAsyncBuild(true);
+
     edgeMaxError_ = Max(error, M_EPSILON);
 
     MarkNetworkUpdate();
@@ -303,6 +360,8 @@ void NavigationMesh::SetEdgeMaxError(float error)
 
 void NavigationMesh::SetDetailSampleDistance(float distance)
 {
+    CancelAsyncBuild(true);
+
     detailSampleDistance_ = Max(distance, M_EPSILON);
 
     MarkNetworkUpdate();
@@ -310,6 +369,8 @@ void NavigationMesh::SetDetailSampleDistance(float distance)
 
 void NavigationMesh::SetDetailSampleMaxError(float error)
 {
+    CancelAsyncBuild(true);
+
     detailSampleMaxError_ = Max(error, M_EPSILON);
 
     MarkNetworkUpdate();
@@ -317,6 +378,8 @@ void NavigationMesh::SetDetailSampleMaxError(float error)
 
 void NavigationMesh::SetPadding(const Vector3& padding)
 {
+    CancelAsyncBuild(true);
+
     padding_ = padding;
 
     MarkNetworkUpdate();
@@ -475,22 +538,18 @@ bool NavigationMesh::Build(const BoundingBox& boundingBox)
         return false;
     }
 
+    // Pending asynchronous tiles would overwrite the fresh ones on commit
+    CancelAsyncBuild(true);
+
     if (!node_->GetWorldScale().Equals(Vector3::ONE))
         URHO3D_LOGWARNING("Navigation mesh root node has scaling. Agent parameters may not work as intended");
 
-    BoundingBox localSpaceBox = boundingBox.Transformed(node_->GetWorldTransform().Inverse());
-
-    float tileEdgeLength = (float)tileSize_ * cellSize_;
-
     ea::vector<NavigationGeometryInfo> geometryList;
     CollectGeometries(geometryList);
 
-    int sx = Clamp((int)((localSpaceBox.min_.x_ - boundingBox_.min_.x_) / tileEdgeLength), 0, numTilesX_ - 1);
-    int sz = Clamp((int)((localSpaceBox.min_.z_ - boundingBox_.min_.z_) / tileEdgeLength), 0, numTilesZ_ - 1);
-    int ex = Clamp((int)((localSpaceBox.max_.x_ - boundingBox_.min_.x_) / tileEdgeLength), 0, numTilesX_ - 1);
-    int ez = Clamp((int)((localSpaceBox.max_.z_ - boundingBox_.min_.z_) / tileEdgeLength), 0, numTilesZ_ - 1);
-
-    unsigned numTiles = BuildTiles(geometryList, IntVector2(sx, sz), IntVector2(ex, ez));
+    const auto tileRange = GetTileRange(boundingBox);
+    unsigned numTiles = BuildTiles(geometryList, tileRange.first, tileRange.second);
+    RemoveDirtyTiles(tileRange.first, tileRange.second);
 
     URHO3D_LOGDEBUG("Rebuilt " + ea::to_string(numTiles) + " tiles of the navigation mesh");
     return true;
@@ -509,6 +568,9 @@ bool NavigationMesh::Build(const IntVector2& from, const IntVector2& to)
         return false;
     }
 
+    // Pending asynchronous tiles would overwrite the fresh ones on commit
+    CancelAsyncBuild(true);
+
     if (!node_->GetWorldScale().Equals(Vector3::ONE))
         URHO3D_LOGWARNING("Navigation mesh root node has scaling. Agent parameters may not work as intended");
 
@@ -516,11 +578,80 @@ bool NavigationMesh::Build(const IntVector2& from, const IntVector2& to)
     CollectGeometries(geometryList);
 
     unsigned numTiles = BuildTiles(geometryList, from, to);
+    RemoveDirtyTiles(from, to);
 
     URHO3D_LOGDEBUG("Rebuilt " + ea::to_string(numTiles) + " tiles of the navigation mesh");
     return true;
 }
 
+void NavigationMesh::BuildAsync(const BoundingBox& boundingBox)
+{
+    if (!node_)
+        return;
+
+    if (!navMesh_)
+    {
+        URHO3D_LOGERROR("Navigation mesh must first be built fully before it can be partially rebuilt");
+        return;
+    }
+
+    const auto tileRange = GetTileRange(boundingBox);
+    BuildAsync(tileRange.first, tileRange.second);
+}
+
+void NavigationMesh::BuildAsync(const IntVector2& from, const IntVector2& to)
+{
+    if (!node_)
+        return;
+
+    if (!navMesh_)
+    {
+        URHO3D_LOGERROR("Navigation mesh must first be built fully before it can be partially rebuilt");
+        return;
+    }
+
+    for (int z = from.y_; z <= to.y_; ++z)
+    {
+        for (int x = from.x_; x <= to.x_; ++x)
+            dirtyTiles_.insert(IntVector2(x, z));
+    }
+
+    if (!dirtyTiles_.empty())
+        SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(NavigationMesh, HandleBeginFrame));
+}
+
+void NavigationMesh::CompleteAsyncBuild()
+{
+    URHO3D_PROFILE("CompleteAsyncNavigationBuild");
+
+    while (asyncBuildJob_ || !dirtyTiles_.empty())
+    {
+        if (!asyncBuildJob_)
+            StartAsyncBuild();
+
+        if (asyncBuildJob_)
+        {
+            // Help worker threads with the remaining tiles and wait only for the tiles of this job
+            NavAsyncBuildJob& job = *asyncBuildJob_;
+            ProcessAsyncBuildTiles(job);
+            while (job.numProcessed_ < job.results_.size())
+                Time::Sleep(0);
+
+            CommitAsyncBuild();
+        }
+    }
+
+    UnsubscribeFromEvent(E_BEGINFRAME);
+}
+
+unsigned NavigationMesh::GetNumPendingTiles() const
+{
+    unsigned numTiles = dirtyTiles_.size();
+    if (asyncBuildJob_)
+        numTiles += asyncBuildJob_->results_.size();
+    return numTiles;
+}
+
 ea::vector<unsigned char> NavigationMesh::GetTileData(const IntVector2& tile) const
 {
     VectorBuffer ret;
@@ -541,6 +672,22 @@ bool NavigationMesh::HasTile(const IntVector2& tile) const
     return false;
 }
 
+BoundingBox NavBuildConfig::GetTileBoundingBox(const IntVector2& tile) const
+{
+    const float tileEdgeLength = (float)tileSize_ * cellSize_;
+    return BoundingBox(
+        Vector3(
+            boundingBox_.min_.x_ + tileEdgeLength * (float)tile.x_,
+            boundingBox_.min_.y_,
+            boundingBox_.min_.z_ + tileEdgeLength * (float)tile.y_
+        ),
+        Vector3(
+            boundingBox_.min_.x_ + tileEdgeLength * (float)(tile.x_ + 1),
+            boundingBox_.max_.y_,
+            boundingBox_.min_.z_ + tileEdgeLength * (float)(tile.y_ + 1)
+        ));
+}
+
 BoundingBox NavigationMesh::GetTileBoundingBox(const IntVector2& tile) const
 {
     const float tileEdgeLength = (float)tileSize_ * cellSize_;
@@ -954,6 +1101,8 @@ void NavigationMesh::CollectGeometries(ea::vector<NavigationGeometryInfo>& geome
 {
     URHO3D_PROFILE("CollectNavigationGeometry");
 
+    HiresTimer timer;
+
     // Get Navigable components from child nodes, not from whole scene. This makes it possible to partition
     // the scene into several navigation meshes
     ea::vector<Navigable*> navigables;
@@ -1002,6 +1151,8 @@ void NavigationMesh::CollectGeometries(ea::vector<NavigationGeometryInfo>& geome
             areas_.push_back(WeakPtr<NavArea>(area));
         }
     }
+
+    buildStats_.collectTime_ = timer.GetUSec(false);
 }
 
 void NavigationMesh::CollectGeometries(ea::vector<NavigationGeometryInfo>& geometryList, Node* node, ea::hash_set<Node*>& processedNodes,
@@ -1082,170 +1233,116 @@ void NavigationMesh::CollectGeometries(ea::vector<NavigationGeometryInfo>& geome
     }
 }
 
-void NavigationMesh::GetTileGeometry(NavBuildData* build, ea::vector<NavigationGeometryInfo>& geometryList, BoundingBox& box)
+void NavigationMesh::GetGeometry(NavGeometrySource& source, const NavigationGeometryInfo& info, const Matrix3x4& inverse)
 {
-    Matrix3x4 inverse = node_->GetWorldTransform().Inverse();
+    const Matrix3x4& transform = info.transform_;
+    NavGeometryData* build = &source.data_;
+    source.transform_ = transform;
 
-    for (unsigned i = 0; i < geometryList.size(); ++i)
+    if (info.component_->GetType() == OffMeshConnection::GetTypeStatic())
     {
-        if (box.IsInsideFast(geometryList[i].boundingBox_) != OUTSIDE)
-        {
-            const Matrix3x4& transform = geometryList[i].transform_;
-
-            if (geometryList[i].component_->GetType() == OffMeshConnection::GetTypeStatic())
-            {
-                auto* connection = static_cast<OffMeshConnection*>(geometryList[i].component_);
-                Vector3 start = inverse * connection->GetNode()->GetWorldPosition();
-                Vector3 end = inverse * connection->GetEndPoint()->GetWorldPosition();
-
-                build->offMeshVertices_.push_back(start);
-                build->offMeshVertices_.push_back(end);
-                build->offMeshRadii_.push_back(connection->GetRadius());
-                build->offMeshFlags_.push_back((unsigned short) connection->GetMask());
-                build->offMeshAreas_.push_back((unsigned char) connection->GetAreaID());
-                build->offMeshDir_.push_back((unsigned char) (connection->IsBidirectional() ? DT_OFFMESH_CON_BIDIR : 0));
-                continue;
-            }
-            else if (geometryList[i].component_->GetType() == NavArea::GetTypeStatic())
-            {
-                auto* area = static_cast<NavArea*>(geometryList[i].component_);
-                NavAreaStub stub;
-                stub.areaID_ = (unsigned char)area->GetAreaID();
-                stub.bounds_ = area->GetWorldBoundingBox();
-                build->navAreas_.push_back(stub);
-                continue;
-            }
+        auto* connection = static_cast<OffMeshConnection*>(info.component_);
+        Vector3 start = inverse * connection->GetNode()->GetWorldPosition();
+        Vector3 end = inverse * connection->GetEndPoint()->GetWorldPosition();
+
+        build->offMeshVertices_.push_back(start);
+        build->offMeshVertices_.push_back(end);
+        build->offMeshRadii_.push_back(connection->GetRadius());
+        build->offMeshFlags_.push_back((unsigned short) connection->GetMask());
+        build->offMeshAreas_.push_back((unsigned char) connection->GetAreaID());
+        build->offMeshDir_.push_back((unsigned char) (connection->IsBidirectional() ? DT_OFFMESH_CON_BIDIR : 0));
+        return;
+    }
+    else if (info.component_->GetType() == NavArea::GetTypeStatic())
+    {
+        auto* area = static_cast<NavArea*>(info.component_);
+        NavAreaStub stub;
+        stub.areaID_ = (unsigned char)area->GetAreaID();
+        stub.bounds_ = area->GetWorldBoundingBox();
+        build->navAreas_.push_back(stub);
+        return;
+    }
 
 #ifdef URHO3D_PHYSICS
-            auto* shape = dynamic_cast<CollisionShape*>(geometryList[i].component_);
-            if (shape)
+    auto* shape = dynamic_cast<CollisionShape*>(info.component_);
+    if (shape)
+    {
+        switch (shape->GetShapeType())
+        {
+        case SHAPE_TRIANGLEMESH:
             {
-                switch (shape->GetShapeType())
-                {
-                case SHAPE_TRIANGLEMESH:
-                    {
-                        Model* model = shape->GetModel();
-                        if (!model)
-                            continue;
-
-                        unsigned lodLevel = shape->GetLodLevel();
-                        for (unsigned j = 0; j < model->GetNumGeometries(); ++j)
-                            AddTriMeshGeometry(build, model->GetGeometry(j, lodLevel), transform);
-                    }
-                    break;
-
-                case SHAPE_CONVEXHULL:
-                    {
-                        auto* data = static_cast<ConvexData*>(shape->GetGeometryData());
-                        if (!data)
-                            continue;
-
-                        unsigned numVertices = data->vertexCount_;
-                        unsigned numIndices = data->indexCount_;
-                        unsigned destVertexStart = build->vertices_.size();
-
-                        for (unsigned j = 0; j < numVertices; ++j)
-                            build->vertices_.push_back(transform * data->vertexData_[j]);
-
-                        for (unsigned j = 0; j < numIndices; ++j)
-                            build->indices_.push_back(data->indexData_[j] + destVertexStart);
-                    }
-                    break;
+                Model* model = shape->GetModel();
+                if (!model)
+                    return;
 
-                case SHAPE_BOX:
-                    {
-                        unsigned destVertexStart = build->vertices_.size();
-
-                        build->vertices_.push_back(transform * Vector3(-0.5f, 0.5f, -0.5f));
-                        build->vertices_.push_back(transform * Vector3(0.5f, 0.5f, -0.5f));
-                        build->vertices_.push_back(transform * Vector3(0.5f, -0.5f, -0.5f));
-                        build->vertices_.push_back(transform * Vector3(-0.5f, -0.5f, -0.5f));
-                        build->vertices_.push_back(transform * Vector3(-0.5f, 0.5f, 0.5f));
-                        build->vertices_.push_back(transform * Vector3(0.5f, 0.5f, 0.5f));
-                        build->vertices_.push_back(transform * Vector3(0.5f, -0.5f, 0.5f));
-                        build->vertices_.push_back(transform * Vector3(-0.5f, -0.5f, 0.5f));
-
-                        const unsigned indices[] = {
-                            0, 1, 2, 0, 2, 3, 1, 5, 6, 1, 6, 2, 4, 5, 1, 4, 1, 0, 5, 4, 7, 5, 7, 6,
-                            4, 0, 3, 4, 3, 7, 1, 0, 4, 1, 4, 5
-                        };
-
-                        for (unsigned index : indices)
-                            build->indices_.push_back(index + destVertexStart);
-                    }
-                    break;
-
-                default:
-                    break;
+                unsigned lodLevel = shape->GetLodLevel();
+                for (unsigned j = 0; j < model->GetNumGeometries(); ++j)
+                {
+                    NavTriMeshData triMesh;
+                    if (triMesh.Define(model->GetGeometry(j, lodLevel)))
+                        source.triMeshes_.push_back(ea::move(triMesh));
                 }
-
-                continue;
             }
-#endif
-            auto* drawable = dynamic_cast<Drawable*>(geometryList[i].component_);
-            if (drawable)
+            break;
+
+        case SHAPE_CONVEXHULL:
             {
-                const ea::vector<SourceBatch>& batches = drawable->GetBatches();
+                auto* data = static_cast<ConvexData*>(shape->GetGeometryData());
+                if (!data)
+                    return;
 
-                for (unsigned j = 0; j < batches.size(); ++j)
-                    AddTriMeshGeometry(build, drawable->GetLodGeometry(j, geometryList[i].lodLevel_), transform);
-            }
-        }
-    }
-}
+                unsigned numVertices = data->vertexCount_;
+                unsigned numIndices = data->indexCount_;
+                unsigned destVertexStart = build->vertices_.size();
 
-void NavigationMesh::AddTriMeshGeometry(NavBuildData* build, Geometry* geometry, const Matrix3x4& transform)
-{
-    if (!geometry)
-        return;
+                for (unsigned j = 0; j < numVertices; ++j)
+                    build->vertices_.push_back(transform * data->vertexData_[j]);
 
-    const unsigned char* vertexData;
-    const unsigned char* indexData;
-    unsigned vertexSize;
-    unsigned indexSize;
-    const ea::vector<VertexElement>* elements;
+                for (unsigned j = 0; j < numIndices; ++j)
+                    build->indices_.push_back(data->indexData_[j] + destVertexStart);
+            }
+            break;
 
-    geometry->GetRawData(vertexData, vertexSize, indexData, indexSize, elements);
-    if (!vertexData || !indexData || !elements || VertexBuffer::GetElementOffset(*elements, TYPE_VECTOR3, SEM_POSITION) != 0)
-        return;
+        case SHAPE_BOX:
+            {
+                unsigned destVertexStart = build->vertices_.size();
+
+                build->vertices_.push_back(transform * Vector3(-0.5f, 0.5f, -0.5f));
+                build->vertices_.push_back(transform * Vector3(0.5f, 0.5f, -0.5f));
+                build->vertices_.push_back(transform * Vector3(0.5f, -0.5f, -0.5f));
+                build->vertices_.push_back(transform * Vector3(-0.5f, -0.5f, -0.5f));
+                build->vertices_.push_back(transform * Vector3(-0.5f, 0.5f, 0.5f));
+                build->vertices_.push_back(transform * Vector3(0.5f, 0.5f, 0.5f));
+                build->vertices_.push_back(transform * Vector3(0.5f, -0.5f, 0.5f));
+                build->vertices_.push_back(transform * Vector3(-0.5f, -0.5f, 0.5f));
+
+                const unsigned indices[] = {
+                    0, 1, 2, 0, 2, 3, 1, 5, 6, 1, 6, 2, 4, 5, 1, 4, 1, 0, 5, 4, 7, 5, 7, 6,
+                    4, 0, 3, 4, 3, 7, 1, 0, 4, 1, 4, 5
+                };
+
+                for (unsigned index : indices)
+                    build->indices_.push_back(index + destVertexStart);
+            }
+            break;
 
-    unsigned srcIndexStart = geometry->GetIndexStart();
-    unsigned srcIndexCount = geometry->GetIndexCount();
-    unsigned srcVertexStart = geometry->GetVertexStart();
-    unsigned srcVertexCount = geometry->GetVertexCount();
+        default:
+            break;
+        }
 
-    if (!srcIndexCount)
         return;
-
-    unsigned destVertexStart = build->vertices_.size();
-
-    for (unsigned k = srcVertexStart; k < srcVertexStart + srcVertexCount; ++k)
-    {
-        Vector3 vertex = transform * *((const Vector3*)(&vertexData[k * vertexSize]));
-        build->vertices_.push_back(vertex);
-    }
-
-    // Copy remapped indices
-    if (indexSize == sizeof(unsigned short))
-    {
-        const unsigned short* indices = ((const unsigned short*)indexData) + srcIndexStart;
-        const unsigned short* indicesEnd = indices + srcIndexCount;
-
-        while (indices < indicesEnd)
-        {
-            build->indices_.push_back(*indices - srcVertexStart + destVertexStart);
-            ++indices;
-        }
     }
-    else
+#endif
+    auto* drawable = dynamic_cast<Drawable*>(info.component_);
+    if (drawable)
     {
-        const unsigned* indices = ((const unsigned*)indexData) + srcIndexStart;
-        const unsigned* indicesEnd = indices + srcIndexCount;
+        const ea::vector<SourceBatch>& batches = drawable->GetBatches();
 
-        while (indices < indicesEnd)
+        for (unsigned j = 0; j < batches.size(); ++j)
         {
-            build->indices_.push_back(*indices - srcVertexStart + destVertexStart);
-            ++indices;
+            NavTriMeshData triMesh;
+            if (triMesh.Define(drawable->GetLodGeometry(j, info.lodLevel_)))
+                source.triMeshes_.push_back(ea::move(triMesh));
         }
     }
 }
@@ -1299,36 +1396,36 @@ bool NavigationMesh::ReadTile(Deserializer& source, bool silent)
     return true;
 }
 
-bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList, int x, int z)
+void NavigationMesh::BuildTileData(const NavBuildConfig& config, const NavGeometryIndex& geometryIndex, NavTileBuildResult& result) const
 {
     URHO3D_PROFILE("BuildNavigationMeshTile");
 
-    // Remove previous tile (if any)
-    navMesh_->removeTile(navMesh_->getTileRefAt(x, z, 0), nullptr, nullptr);
-
-    const BoundingBox tileBoundingBox = GetTileBoundingBox(IntVector2(x, z));
+    const int x = result.tile_.x_;
+    const int z = result.tile_.y_;
+    const BoundingBox tileBoundingBox = config.GetTileBoundingBox(result.tile_);
+    HiresTimer timer;
 
     SimpleNavBuildData build;
 
     rcConfig cfg;       // NOLINT(hicpp-member-init)
     memset(&cfg, 0, sizeof cfg);
-    cfg.cs = cellSize_;
-    cfg.ch = cellHeight_;
-    cfg.walkableSlopeAngle = agentMaxSlope_;
-    cfg.walkableHeight = CeilToInt(agentHeight_ / cfg.ch);
-    cfg.walkableClimb = FloorToInt(agentMaxClimb_ / cfg.ch);
-    cfg.walkableRadius = CeilToInt(agentRadius_ / cfg.cs);
-    cfg.maxEdgeLen = (int)(edgeMaxLength_ / cellSize_);
-    cfg.maxSimplificationError = edgeMaxError_;
-    cfg.minRegionArea = (int)sqrtf(regionMinSize_);
-    cfg.mergeRegionArea = (int)sqrtf(regionMergeSize_);
+    cfg.cs = config.cellSize_;
+    cfg.ch = config.cellHeight_;
+    cfg.walkableSlopeAngle = config.agentMaxSlope_;
+    cfg.walkableHeight = CeilToInt(config.agentHeight_ / cfg.ch);
+    cfg.walkableClimb = FloorToInt(config.agentMaxClimb_ / cfg.ch);
+    cfg.walkableRadius = CeilToInt(config.agentRadius_ / cfg.cs);
+    cfg.maxEdgeLen = (int)(config.edgeMaxLength_ / config.cellSize_);
+    cfg.maxSimplificationError = config.edgeMaxError_;
+    cfg.minRegionArea = (int)sqrtf(config.regionMinSize_);
+    cfg.mergeRegionArea = (int)sqrtf(config.regionMergeSize_);
     cfg.maxVertsPerPoly = 6;
-    cfg.tileSize = tileSize_;
+    cfg.tileSize = config.tileSize_;
     cfg.borderSize = cfg.walkableRadius + 3; // Add padding
     cfg.width = cfg.tileSize + cfg.borderSize * 2;
     cfg.height = cfg.tileSize + cfg.borderSize * 2;
-    cfg.detailSampleDist = detailSampleDistance_ < 0.9f ? 0.0f : cellSize_ * detailSampleDistance_;
-    cfg.detailSampleMaxError = cellHeight_ * detailSampleMaxError_;
+    cfg.detailSampleDist = config.detailSampleDistance_ < 0.9f ? 0.0f : config.cellSize_ * config.detailSampleDistance_;
+    cfg.detailSampleMaxError = config.cellHeight_ * config.detailSampleMaxError_;
 
     rcVcopy(cfg.bmin, &tileBoundingBox.min_.x_);
     rcVcopy(cfg.bmax, &tileBoundingBox.max_.x_);
@@ -1338,23 +1435,27 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
     cfg.bmax[2] += cfg.borderSize * cfg.cs;
 
     BoundingBox expandedBox(*reinterpret_cast<Vector3*>(cfg.bmin), *reinterpret_cast<Vector3*>(cfg.bmax));
-    GetTileGeometry(&build, geometryList, expandedBox);
+    geometryIndex.GetTileGeometry(build, result.tile_, expandedBox);
+    result.geometryTime_ = timer.GetUSec(true);
 
-    if (build.vertices_.empty() || build.indices_.empty())
-        return true; // Nothing to do
+    if (build.IsEmpty())
+    {
+        result.success_ = true;
+        return; // Nothing to do
+    }
 
     build.heightField_ = rcAllocHeightfield();
     if (!build.heightField_)
     {
         URHO3D_LOGERROR("Could not allocate heightfield");
-        return false;
+        return;
     }
 
     if (!rcCreateHeightfield(build.ctx_, *build.heightField_, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs,
         cfg.ch))
     {
         URHO3D_LOGERROR("Could not create heightfield");
-        return false;
+        return;
     }
 
     unsigned numTriangles = build.indices_.size() / 3;
@@ -1374,37 +1475,39 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
     if (!build.compactHeightField_)
     {
         URHO3D_LOGERROR("Could not allocate create compact heightfield");
-        return false;
+        return;
     }
     if (!rcBuildCompactHeightfield(build.ctx_, cfg.walkableHeight, cfg.walkableClimb, *build.heightField_,
         *build.compactHeightField_))
     {
         URHO3D_LOGERROR("Could not build compact heightfield");
-        return false;
+        return;
     }
     if (!rcErodeWalkableArea(build.ctx_, cfg.walkableRadius, *build.compactHeightField_))
     {
         URHO3D_LOGERROR("Could not erode compact heightfield");
-        return false;
+        return;
     }
 
+    result.rasterizeTime_ = timer.GetUSec(true);
+
     // Mark area volumes
     for (unsigned i = 0; i < build.navAreas_.size(); ++i)
         rcMarkBoxArea(build.ctx_, &build.navAreas_[i].bounds_.min_.x_, &build.navAreas_[i].bounds_.max_.x_,
             build.navAreas_[i].areaID_, *build.compactHeightField_);
 
-    if (this->partitionType_ == NAVMESH_PARTITION_WATERSHED)
+    if (config.partitionType_ == NAVMESH_PARTITION_WATERSHED)
     {
         if (!rcBuildDistanceField(build.ctx_, *build.compactHeightField_))
         {
             URHO3D_LOGERROR("Could not build distance field");
-            return false;
+            return;
         }
         if (!rcBuildRegions(build.ctx_, *build.compactHeightField_, cfg.borderSize, cfg.minRegionArea,
             cfg.mergeRegionArea))
         {
             URHO3D_LOGERROR("Could not build regions");
-            return false;
+            return;
         }
     }
     else
@@ -1412,46 +1515,48 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
         if (!rcBuildRegionsMonotone(build.ctx_, *build.compactHeightField_, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
         {
             URHO3D_LOGERROR("Could not build monotone regions");
-            return false;
+            return;
         }
     }
 
+    result.regionsTime_ = timer.GetUSec(true);
+
     build.contourSet_ = rcAllocContourSet();
     if (!build.contourSet_)
     {
         URHO3D_LOGERROR("Could not allocate contour set");
-        return false;
+        return;
     }
     if (!rcBuildContours(build.ctx_, *build.compactHeightField_, cfg.maxSimplificationError, cfg.maxEdgeLen,
         *build.contourSet_))
     {
         URHO3D_LOGERROR("Could not create contours");
-        return false;
+        return;
     }
 
     build.polyMesh_ = rcAllocPolyMesh();
     if (!build.polyMesh_)
     {
         URHO3D_LOGERROR("Could not allocate poly mesh");
-        return false;
+        return;
     }
     if (!rcBuildPolyMesh(build.ctx_, *build.contourSet_, cfg.maxVertsPerPoly, *build.polyMesh_))
     {
         URHO3D_LOGERROR("Could not triangulate contours");
-        return false;
+        return;
     }
 
     build.polyMeshDetail_ = rcAllocPolyMeshDetail();
     if (!build.polyMeshDetail_)
     {
         URHO3D_LOGERROR("Could not allocate detail mesh");
-        return false;
+        return;
     }
     if (!rcBuildPolyMeshDetail(build.ctx_, *build.polyMesh_, *build.compactHeightField_, cfg.detailSampleDist,
         cfg.detailSampleMaxError, *build.polyMeshDetail_))
     {
         URHO3D_LOGERROR("Could not build detail mesh");
-        return false;
+        return;
     }
 
     // Set polygon flags
@@ -1479,9 +1584,9 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
     params.detailVertsCount = build.polyMeshDetail_->nverts;
     params.detailTris = build.polyMeshDetail_->tris;
     params.detailTriCount = build.polyMeshDetail_->ntris;
-    params.walkableHeight = agentHeight_;
-    params.walkableRadius = agentRadius_;
-    params.walkableClimb = agentMaxClimb_;
+    params.walkableHeight = config.agentHeight_;
+    params.walkableRadius = config.agentRadius_;
+    params.walkableClimb = config.agentMaxClimb_;
     params.tileX = x;
     params.tileY = z;
     rcVcopy(params.bmin, build.polyMesh_->bmin);
@@ -1504,18 +1609,41 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
     if (!dtCreateNavMeshData(&params, &navData, &navDataSize))
     {
         URHO3D_LOGERROR("Could not build navigation mesh tile data");
-        return false;
+        return;
     }
 
-    if (dtStatusFailed(navMesh_->addTile(navData, navDataSize, DT_TILE_FREE_DATA, 0, nullptr)))
+    result.layers_.push_back(NavTileData{navData, navDataSize});
+    result.meshTime_ = timer.GetUSec(true);
+    result.success_ = true;
+}
+
+unsigned NavigationMesh::CommitTile(NavTileBuildResult& result)
+{
+    const int x = result.tile_.x_;
+    const int z = result.tile_.y_;
+
+    // Remove previous tile (if any)
+    navMesh_->removeTile(navMesh_->getTileRefAt(x, z, 0), nullptr, nullptr);
+
+    if (!result.success_)
+        return 0;
+
+    for (NavTileData& layer : result.layers_)
     {
-        URHO3D_LOGERROR("Failed to add navigation mesh tile");
-        dtFree(navData);
-        return false;
+        const dtStatus status = navMesh_->addTile(layer.data_, layer.dataSize_, DT_TILE_FREE_DATA, 0, nullptr);
+        if (dtStatusFailed(status))
+        {
+            URHO3D_LOGERROR("Failed to add navigation mesh tile");
+            return 0;
+        }
+        layer.data_ = nullptr;
     }
 
     // Send a notification of the rebuild of this tile to anyone interested
+    if (!result.layers_.empty())
     {
+        const BoundingBox tileBoundingBox = GetTileBoundingBox(result.tile_);
+
         using namespace NavigationAreaRebuilt;
         VariantMap& eventData = GetContext()->GetEventDataMap();
         eventData[P_NODE] = GetNode();
@@ -1524,24 +1652,305 @@ bool NavigationMesh::BuildTile(ea::vector<NavigationGeometryInfo>& geometryList,
         eventData[P_BOUNDSMAX] = Variant(tileBoundingBox.max_);
         SendEvent(E_NAVIGATION_AREA_REBUILT, eventData);
     }
-    return true;
+    return 1;
+}
+
+void NavigationMesh::BuildGeometryIndex(NavGeometryIndex& geometryIndex, const ea::vector<NavigationGeometryInfo>& geometryList,
+    const ea::vector<IntVector2>& tiles)
+{
+    URHO3D_PROFILE("BuildNavigationGeometryIndex");
+
+    if (tiles.empty())
+        return;
+
+    const Matrix3x4 inverse = node_->GetWorldTransform().Inverse();
+    const float tileEdgeLength = (float)tileSize_ * cellSize_;
+    const float borderSize = GetTileBorderSize();
+    const Vector3 border(borderSize, 0.0f, borderSize);
+
+    IntVector2 from{M_MAX_INT, M_MAX_INT};
+    IntVector2 to{M_MIN_INT, M_MIN_INT};
+    for (const IntVector2& tile : tiles)
+    {
+        from = VectorMin(from, tile);
+        to = VectorMax(to, tile);
+    }
+
+    geometryIndex.beginTile_ = from;
+    geometryIndex.numTiles_ = to - from + IntVector2::ONE;
+    geometryIndex.tileSources_.resize(geometryIndex.numTiles_.x_ * geometryIndex.numTiles_.y_);
+
+    // Tiles may be sparse, skip geometry that does not contribute to any of them
+    ea::vector<bool> isTileIndexed(geometryIndex.tileSources_.size());
+    for (const IntVector2& tile : tiles)
+        isTileIndexed[(tile.y_ - from.y_) * geometryIndex.numTiles_.x_ + (tile.x_ - from.x_)] = true;
+
+    BoundingBox indexBoundingBox;
+    indexBoundingBox.Merge(GetTileBoundingBox(from));
+    indexBoundingBox.Merge(GetTileBoundingBox(to));
+    indexBoundingBox.min_ -= border;
+    indexBoundingBox.max_ += border;
+
+    for (const NavigationGeometryInfo& info : geometryList)
+    {
+        if (indexBoundingBox.IsInsideFast(info.boundingBox_) == OUTSIDE)
+            continue;
+
+        // Conservatively register the source in all tiles it may contribute to
+        const Vector3 minOffset = (info.boundingBox_.min_ - border - boundingBox_.min_) / tileEdgeLength;
+        const Vector3 maxOffset = (info.boundingBox_.max_ + border - boundingBox_.min_) / tileEdgeLength;
+        const int beginX = Max(FloorToInt(minOffset.x_), from.x_);
+        const int beginZ = Max(FloorToInt(minOffset.z_), from.y_);
+        const int endX = Min(FloorToInt(maxOffset.x_), to.x_);
+        const int endZ = Min(FloorToInt(maxOffset.z_), to.y_);
+
+        const unsigned sourceIndex = geometryIndex.sources_.size();
+        bool isSourceUsed = false;
+        for (int z = beginZ; z <= endZ; ++z)
+        {
+            for (int x = beginX; x <= endX; ++x)
+            {
+                const unsigned tileIndex = (z - from.y_) * geometryIndex.numTiles_.x_ + (x - from.x_);
+                if (isTileIndexed[tileIndex])
+                {
+                    geometryIndex.tileSources_[tileIndex].push_back(sourceIndex);
+                    isSourceUsed = true;
+                }
+            }
+        }
+
+        // Capture geometry only once, no matter how many tiles it overlaps
+        if (isSourceUsed)
+        {
+            geometryIndex.boundingBoxes_.push_back(info.boundingBox_);
+            GetGeometry(geometryIndex.sources_.emplace_back(), info, inverse);
+        }
+    }
+
+    geometryIndex.FinalizeSources();
 }
 
 unsigned NavigationMesh::BuildTiles(ea::vector<NavigationGeometryInfo>& geometryList, const IntVector2& from, const IntVector2& to)
 {
-    unsigned numTiles = 0;
+    URHO3D_PROFILE("BuildNavigationMeshTiles");
 
+    ea::vector<IntVector2> tiles;
     for (int z = from.y_; z <= to.y_; ++z)
     {
         for (int x = from.x_; x <= to.x_; ++x)
-        {
-            if (BuildTile(geometryList, x, z))
-                ++numTiles;
-        }
+            tiles.push_back(IntVector2(x, z));
     }
+
+    HiresTimer timer;
+    const NavBuildConfig config = GetBuildConfig();
+    NavGeometryIndex geometryIndex;
+    BuildGeometryIndex(geometryIndex, geometryList, tiles);
+    buildStats_.geometryTime_ = timer.GetUSec(true);
+    buildStats_.numGeometries_ = geometryIndex.sources_.size();
+
+    ea::vector<NavTileBuildResult> results(tiles.size());
+    for (unsigned i = 0; i < tiles.size(); ++i)
+        results[i].tile_ = tiles[i];
+
+    // Build tiles in worker threads, each tile uses its own build data and Recast context.
+    // Triangle meshes are extracted by the first tile that needs them
+    ForEachParallel(GetSubsystem<WorkQueue>(), results,
+        [&](unsigned /*index*/, NavTileBuildResult& result) { BuildTileData(config, geometryIndex, result); });
+    buildStats_.buildTime_ = timer.GetUSec(true);
+
+    // Commit tiles to the navigation mesh in the main thread
+    unsigned numTiles = 0;
+    buildStats_.tileGeometryTime_ = 0;
+    buildStats_.rasterizeTime_ = 0;
+    buildStats_.regionsTime_ = 0;
+    buildStats_.meshTime_ = 0;
+    for (NavTileBuildResult& result : results)
+    {
+        numTiles += CommitTile(result);
+
+        // Free the data that was not consumed by the navigation mesh
+        for (NavTileData& layer : result.layers_)
+            dtFree(layer.data_);
+
+        buildStats_.tileGeometryTime_ += result.geometryTime_;
+        buildStats_.rasterizeTime_ += result.rasterizeTime_;
+        buildStats_.regionsTime_ += result.regionsTime_;
+        buildStats_.meshTime_ += result.meshTime_;
+    }
+    buildStats_.commitTime_ = timer.GetUSec(false);
+    buildStats_.numTiles_ = results.size();
+
+    URHO3D_LOGDEBUG("Built {} navigation mesh tiles from {} geometries: geometry {} ms, tiles {} ms, commit {} ms",
+        numTiles, buildStats_.numGeometries_, buildStats_.geometryTime_ / 1000, buildStats_.buildTime_ / 1000,
+        buildStats_.commitTime_ / 1000);
     return numTiles;
 }
 
+NavBuildConfig NavigationMesh::GetBuildConfig() const
+{
+    NavBuildConfig config;
+    config.tileSize_ = tileSize_;
+    config.cellSize_ = cellSize_;
+    config.cellHeight_ = cellHeight_;
+    config.agentHeight_ = agentHeight_;
+    config.agentRadius_ = agentRadius_;
+    config.agentMaxClimb_ = agentMaxClimb_;
+    config.agentMaxSlope_ = agentMaxSlope_;
+    config.regionMinSize_ = regionMinSize_;
+    config.regionMergeSize_ = regionMergeSize_;
+    config.edgeMaxLength_ = edgeMaxLength_;
+    config.edgeMaxError_ = edgeMaxError_;
+    config.detailSampleDistance_ = detailSampleDistance_;
+    config.detailSampleMaxError_ = detailSampleMaxError_;
+    config.partitionType_ = partitionType_;
+    config.boundingBox_ = boundingBox_;
+    return config;
+}
+
+float NavigationMesh::GetTileBorderSize() const
+{
+    const int walkableRadius = CeilToInt(agentRadius_ / cellSize_);
+    return (walkableRadius + 3) * cellSize_;
+}
+
+ea::pair<IntVector2, IntVector2> NavigationMesh::GetTileRange(const BoundingBox& boundingBox) const
+{
+    const BoundingBox localSpaceBox = boundingBox.Transformed(node_->GetWorldTransform().Inverse());
+    const float tileEdgeLength = (float)tileSize_ * cellSize_;
+
+    const int sx = Clamp((int)((localSpaceBox.min_.x_ - boundingBox_.min_.x_) / tileEdgeLength), 0, numTilesX_ - 1);
+    const int sz = Clamp((int)((localSpaceBox.min_.z_ - boundingBox_.min_.z_) / tileEdgeLength), 0, numTilesZ_ - 1);
+    const int ex = Clamp((int)((localSpaceBox.max_.x_ - boundingBox_.min_.x_) / tileEdgeLength), 0, numTilesX_ - 1);
+    const int ez = Clamp((int)((localSpaceBox.max_.z_ - boundingBox_.min_.z_) / tileEdgeLength), 0, numTilesZ_ - 1);
+
+    return { IntVector2(sx, sz), IntVector2(ex, ez) };
+}
+
+void NavigationMesh::StartAsyncBuild()
+{
+    URHO3D_PROFILE("StartAsyncNavigationBuild");
+
+    if (!node_ || !navMesh_)
+    {
+        dirtyTiles_.clear();
+        return;
+    }
+
+    // Take tiles in deterministic order, as many as can be committed within the budget
+    ea::vector<IntVector2> tiles(dirtyTiles_.begin(), dirtyTiles_.end());
+    ea::sort(tiles.begin(), tiles.end(), [](const IntVector2& lhs, const IntVector2& rhs)
+    {
+        return ea::tie(lhs.y_, lhs.x_) < ea::tie(rhs.y_, rhs.x_);
+    });
+
+    const unsigned maxTiles = static_cast<unsigned>(Max(1, FloorToInt(asyncCommitBudget_ / asyncTileCommitTime_)));
+    if (tiles.size() > maxTiles)
+        tiles.resize(maxTiles);
+    for (const IntVector2& tile : tiles)
+        dirtyTiles_.erase(tile);
+
+    auto job = ea::make_shared<NavAsyncBuildJob>();
+    job->config_ = GetBuildConfig();
+    job->buildTile_ = [this](const NavBuildConfig& config, const NavGeometryIndex& geometryIndex, NavTileBuildResult& result)
+    {
+        BuildTileData(config, geometryIndex, result);
+    };
+    job->results_.resize(tiles.size());
+    for (unsigned i = 0; i < tiles.size(); ++i)
+        job->results_[i].tile_ = tiles[i];
+
+    // Components are not thread-safe, so the scene is traversed in the main thread.
+    // Only references to vertex and index data are captured here, triangles are extracted in worker threads
+    ea::vector<NavigationGeometryInfo> geometryList;
+    CollectGeometries(geometryList);
+    BuildGeometryIndex(job->geometryIndex_, geometryList, tiles);
+
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    const unsigned numWorkItems = Max(1u, Min(workQueue->GetNumThreads(), static_cast<unsigned>(job->results_.size())));
+    for (unsigned i = 0; i < numWorkItems; ++i)
+        workQueue->AddWorkItem([job](unsigned /*threadIndex*/) { ProcessAsyncBuildTiles(*job); });
+
+    asyncBuildJob_ = job;
+}
+
+bool NavigationMesh::CommitAsyncBuild()
+{
+    NavAsyncBuildJob& job = *asyncBuildJob_;
+    if (job.numProcessed_ < job.results_.size())
+        return false;
+
+    URHO3D_PROFILE("CommitAsyncNavigationBuild");
+
+    // Swap in all tiles at once, so the navigation mesh never contains a partially applied rebuild
+    HiresTimer timer;
+    for (NavTileBuildResult& result : job.results_)
+    {
+        CommitTile(result);
+
+        // Free the data that was not consumed by the navigation mesh
+        for (NavTileData& layer : result.layers_)
+            dtFree(layer.data_);
+        result.layers_.clear();
+    }
+
+    // Adjust size of the next batches to the observed commit time
+    const float tileCommitTime = timer.GetUSec(false) / 1000.0f / job.results_.size();
+    asyncTileCommitTime_ = Max(Lerp(asyncTileCommitTime_, tileCommitTime, 0.5f), M_EPSILON);
+
+    asyncBuildJob_ = nullptr;
+    return true;
+}
+
+void NavigationMesh::CancelAsyncBuild(bool requeueTiles)
+{
+    if (!asyncBuildJob_)
+        return;
+
+    // Take all remaining tiles so work items will not access this object anymore, then wait for tiles in progress
+    NavAsyncBuildJob& job = *asyncBuildJob_;
+    const unsigned numTiles = job.results_.size();
+    job.cancelled_ = true;
+    const unsigned numTaken = Min(job.nextTile_.exchange(numTiles), numTiles);
+    while (job.numProcessed_ < numTaken)
+        Time::Sleep(0);
+
+    for (NavTileBuildResult& result : job.results_)
+    {
+        for (NavTileData& layer : result.layers_)
+            dtFree(layer.data_);
+        result.layers_.clear();
+
+        if (requeueTiles)
+            dirtyTiles_.insert(result.tile_);
+    }
+
+    asyncBuildJob_ = nullptr;
+}
+
+void NavigationMesh::RemoveDirtyTiles(const IntVector2& from, const IntVector2& to)
+{
+    if (dirtyTiles_.empty())
+        return;
+
+    for (int z = from.y_; z <= to.y_; ++z)
+    {
+        for (int x = from.x_; x <= to.x_; ++x)
+            dirtyTiles_.erase(IntVector2(x, z));
+    }
+}
+
+void NavigationMesh::HandleBeginFrame(StringHash /*eventType*/, VariantMap& /*eventData*/)
+{
+    if (asyncBuildJob_)
+        CommitAsyncBuild();
+
+    if (!asyncBuildJob_ && !dirtyTiles_.empty())
+        StartAsyncBuild();
+
+    if (!asyncBuildJob_ && dirtyTiles_.empty())
+        UnsubscribeFromEvent(E_BEGINFRAME);
+}
+
 bool NavigationMesh::InitializeQuery()
 {
     if (!navMesh_ || !node_)
@@ -1568,6 +1977,9 @@ bool NavigationMesh::InitializeQuery()
 
 void NavigationMesh::ReleaseNavigationMesh()
 {
+    CancelAsyncBuild();
+    dirtyTiles_.clear();
+
     dtFreeNavMesh(navMesh_);
     navMesh_ = nullptr;
 
@@ -1581,6 +1993,8 @@ void NavigationMesh::ReleaseNavigationMesh()
 
 void NavigationMesh::SetPartitionType(NavmeshPartitionType partitionType)
 {
+    CancelAsyncBuild(true);
+
     partitionType_ = partitionType;
     MarkNetworkUpdate();
 }
@@ -1595,6 +2009,7 @@ void RegisterNavigationLibrary(Context* context)
     DynamicNavigationMesh::RegisterObject(context);
     Obstacle::RegisterObject(context);
     NavArea::RegisterObject(context);
+    NavigationPathService::RegisterObject(context);
 }
 
 }
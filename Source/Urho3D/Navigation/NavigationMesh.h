@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <EASTL/hash_set.h>
+#include <EASTL/shared_ptr.h>
 #include <EASTL/unique_ptr.h>
 
 #include "../Math/BoundingBox.h"
@@ -53,7 +55,11 @@ class Geometry;
 class NavArea;
 
 struct FindPathData;
-struct NavBuildData;
+struct NavAsyncBuildJob;
+struct NavGeometryData;
+struct NavGeometryIndex;
+struct NavGeometrySource;
+struct NavTileBuildResult;
 
 /// Description of a navigation mesh geometry component, with transform and bounds information.
 struct NavigationGeometryInfo
@@ -69,6 +75,70 @@ struct NavigationGeometryInfo
 
 };
 
+/// Navigation mesh build parameters. Copied for every build, so worker threads never read attributes of the component.
+/// @nobind
+struct NavBuildConfig
+{
+    /// Return bounding box of the tile in the node space.
+    BoundingBox GetTileBoundingBox(const IntVector2& tile) const;
+
+    /// Tile size.
+    int tileSize_{};
+    /// Cell size.
+    float cellSize_{};
+    /// Cell height.
+    float cellHeight_{};
+    /// Navigation agent height.
+    float agentHeight_{};
+    /// Navigation agent radius.
+    float agentRadius_{};
+    /// Navigation agent max vertical climb.
+    float agentMaxClimb_{};
+    /// Navigation agent max slope.
+    float agentMaxSlope_{};
+    /// Region minimum size.
+    float regionMinSize_{};
+    /// Region merge size.
+    float regionMergeSize_{};
+    /// Edge max length.
+    float edgeMaxLength_{};
+    /// Edge max error.
+    float edgeMaxError_{};
+    /// Detail sampling distance.
+    float detailSampleDistance_{};
+    /// Detail sampling maximum error.
+    float detailSampleMaxError_{};
+    /// Type of the heightfield partitioning.
+    NavmeshPartitionType partitionType_{};
+    /// Whole navigation mesh bounding box.
+    BoundingBox boundingBox_;
+};
+
+/// Navigation mesh build statistics of the last build. Times are in microseconds.
+struct NavigationBuildStats
+{
+    /// Time spent collecting geometry components from the scene.
+    long long collectTime_{};
+    /// Time spent capturing geometry of components and indexing it by tiles.
+    long long geometryTime_{};
+    /// Wall time spent building tiles in worker threads.
+    long long buildTime_{};
+    /// Time spent adding built tiles to the navigation mesh in the main thread.
+    long long commitTime_{};
+    /// Time spent extracting and gathering tile geometry, summed over all tiles.
+    long long tileGeometryTime_{};
+    /// Time spent rasterizing and filtering heightfields, summed over all tiles.
+    long long rasterizeTime_{};
+    /// Time spent partitioning heightfields into regions, summed over all tiles.
+    long long regionsTime_{};
+    /// Time spent building polygon meshes or tile cache layers, summed over all tiles.
+    long long meshTime_{};
+    /// Number of processed tiles.
+    unsigned numTiles_{};
+    /// Number of geometry sources.
+    unsigned numGeometries_{};
+};
+
 /// A flag representing the type of path point- none, the start of a path segment, the end of one, or an off-mesh connection.
 enum NavigationPathPointFlag
 {
@@ -94,6 +164,7 @@ class URHO3D_API NavigationMesh : public Component
     URHO3D_OBJECT(NavigationMesh, Component);
 
     friend class CrowdManager;
+    friend class NavigationPathService;
 
 public:
     /// Construct.
@@ -159,6 +230,15 @@ public:
     virtual bool Build(const BoundingBox& boundingBox);
     /// Rebuild part of the navigation mesh in the rectangular area. Return true if successful.
     virtual bool Build(const IntVector2& from, const IntVector2& to);
+    /// Queue asynchronous rebuild of part of the navigation mesh contained by the world-space bounding box.
+    /// Overlapping requests are coalesced. Tiles are rebuilt in worker threads and committed at frame start.
+    void BuildAsync(const BoundingBox& boundingBox);
+    /// Queue asynchronous rebuild of part of the navigation mesh in the rectangular area.
+    void BuildAsync(const IntVector2& from, const IntVector2& to);
+    /// Finish all queued asynchronous rebuilds and commit them immediately.
+    void CompleteAsyncBuild();
+    /// Return number of tiles queued for asynchronous rebuild or waiting to be committed.
+    unsigned GetNumPendingTiles() const;
     /// Return tile data.
     virtual ea::vector<unsigned char> GetTileData(const IntVector2& tile) const;
     /// Add tile to navigation mesh.
@@ -268,6 +348,18 @@ public:
     /// Get the current cost of an area.
     float GetAreaCost(unsigned areaID) const;
 
+    /// Set max time in milliseconds spent per frame committing asynchronously rebuilt tiles.
+    /// Queued tiles are rebuilt in batches sized to fit the budget, at least one tile each. Every batch is committed at once.
+    /// @property
+    void SetAsyncCommitBudget(float budget) { asyncCommitBudget_ = Max(budget, 0.0f); }
+
+    /// Return max time in milliseconds spent per frame committing asynchronously rebuilt tiles.
+    /// @property
+    float GetAsyncCommitBudget() const { return asyncCommitBudget_; }
+
+    /// Return statistics of the last build.
+    const NavigationBuildStats& GetBuildStats() const { return buildStats_; }
+
     /// Return whether has been initialized with valid navigation data.
     /// @property
     bool IsInitialized() const { return navMesh_ != nullptr; }
@@ -324,14 +416,33 @@ protected:
     void CollectGeometries(ea::vector<NavigationGeometryInfo>& geometryList);
     /// Visit nodes and collect navigable geometry.
     void CollectGeometries(ea::vector<NavigationGeometryInfo>& geometryList, Node* node, ea::hash_set<Node*>& processedNodes, bool recursive);
-    /// Get geometry data within a bounding box.
-    void GetTileGeometry(NavBuildData* build, ea::vector<NavigationGeometryInfo>& geometryList, BoundingBox& box);
-    /// Add a triangle mesh to the geometry data.
-    void AddTriMeshGeometry(NavBuildData* build, Geometry* geometry, const Matrix3x4& transform);
-    /// Build one tile of the navigation mesh. Return true if successful.
-    virtual bool BuildTile(ea::vector<NavigationGeometryInfo>& geometryList, int x, int z);
-    /// Build tiles in the rectangular area. Return number of built tiles.
+    /// Capture geometry overlapping the tiles and index it by tiles. Triangle meshes are extracted when tiles are built.
+    void BuildGeometryIndex(NavGeometryIndex& geometryIndex, const ea::vector<NavigationGeometryInfo>& geometryList,
+        const ea::vector<IntVector2>& tiles);
+    /// Capture geometry of the navigation geometry source.
+    void GetGeometry(NavGeometrySource& source, const NavigationGeometryInfo& info, const Matrix3x4& inverse);
+    /// Return current build parameters.
+    NavBuildConfig GetBuildConfig() const;
+    /// Build data of one tile of the navigation mesh. Called from worker threads and must not access the component.
+    virtual void BuildTileData(const NavBuildConfig& config, const NavGeometryIndex& geometryIndex, NavTileBuildResult& result) const;
+    /// Replace the tile of the navigation mesh with built data. Called from the main thread. Return number of added tiles.
+    virtual unsigned CommitTile(NavTileBuildResult& result);
+    /// Build tiles in the rectangular area in parallel. Return number of built tiles.
     unsigned BuildTiles(ea::vector<NavigationGeometryInfo>& geometryList, const IntVector2& from, const IntVector2& to);
+    /// Return size of the border around tile that contributes geometry to the tile.
+    float GetTileBorderSize() const;
+    /// Return range of tiles overlapping the world-space bounding box.
+    ea::pair<IntVector2, IntVector2> GetTileRange(const BoundingBox& boundingBox) const;
+    /// Start asynchronous rebuild of queued tiles. Number of tiles is limited by the commit time budget.
+    void StartAsyncBuild();
+    /// Commit all tiles of the asynchronous rebuild at once. Return false if some tiles are not built yet.
+    bool CommitAsyncBuild();
+    /// Cancel asynchronous rebuild in progress and wait until worker threads release it. Optionally queue its tiles again.
+    void CancelAsyncBuild(bool requeueTiles = false);
+    /// Remove tiles in range from the asynchronous rebuild queue after they were rebuilt synchronously.
+    void RemoveDirtyTiles(const IntVector2& from, const IntVector2& to);
+    /// Handle frame start. Commit asynchronously rebuilt tiles and start rebuild of queued tiles.
+    void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
     /// Ensure that the navigation mesh query is initialized. Return true if successful.
     bool InitializeQuery();
     /// Release the navigation mesh and the query.
@@ -391,6 +502,16 @@ protected:
     bool drawNavAreas_;
     /// NavAreas for this NavMesh.
     ea::vector<WeakPtr<NavArea> > areas_;
+    /// Statistics of the last build.
+    NavigationBuildStats buildStats_;
+    /// Tiles queued for asynchronous rebuild.
+    ea::hash_set<IntVector2> dirtyTiles_;
+    /// Asynchronous rebuild in progress.
+    ea::shared_ptr<NavAsyncBuildJob> asyncBuildJob_;
+    /// Max time in milliseconds spent per frame committing asynchronously rebuilt tiles.
+    float asyncCommitBudget_{2.0f};
+    /// Estimated time in milliseconds of committing one tile.
+    float asyncTileCommitTime_{0.25f};
 };
 
 /// Register Navigation library objects.
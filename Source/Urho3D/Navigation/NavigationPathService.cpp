@@ -0,0 +1,510 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
+#include "../IO/Log.h"
+#include "../Navigation/NavigationEvents.h"
+#include "../Navigation/NavigationMesh.h"
+#include "../Navigation/NavigationPathService.h"
+#include "../Scene/Node.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneEvents.h"
+
+#include <Detour/DetourNavMesh.h>
+#include <Detour/DetourNavMeshQuery.h>
+
+#include <EASTL/sort.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* NAVIGATION_CATEGORY;
+
+static const unsigned DEFAULT_MAX_ITERATIONS = 512;
+static const unsigned DEFAULT_MAX_CACHED_PATHS = 256;
+static const int MAX_POLYS = 2048;
+
+/// Thread slot of path service. Only one thread accesses the slot at a time.
+struct NavigationPathSlot
+{
+    /// Construct.
+    NavigationPathSlot()
+        : query_(dtAllocNavMeshQuery())
+        , polys_(MAX_POLYS)
+        , points_(MAX_POLYS)
+    {
+    }
+
+    /// Destruct.
+    ~NavigationPathSlot()
+    {
+        dtFreeNavMeshQuery(query_);
+    }
+
+    /// Detour query.
+    dtNavMeshQuery* query_{};
+    /// Whether the request is active.
+    bool active_{};
+    /// Active request.
+    NavigationPathService::Request request_;
+    /// Cache key of active request.
+    NavigationPathService::CacheKey key_;
+    /// Start point of active request in navigation mesh space.
+    Vector3 localStart_;
+    /// End point of active request in navigation mesh space.
+    Vector3 localEnd_;
+    /// Polygon buffer.
+    ea::vector<dtPolyRef> polys_;
+    /// Path point buffer.
+    ea::vector<Vector3> points_;
+    /// Completed requests.
+    ea::vector<ea::pair<NavigationPathCallback, NavigationPathResult>> completed_;
+    /// Found path corridors to be added to the cache.
+    ea::vector<ea::pair<NavigationPathService::CacheKey, ea::vector<dtPolyRef>>> newCacheEntries_;
+    /// Keys of path corridors taken from the cache.
+    ea::vector<NavigationPathService::CacheKey> cacheHits_;
+};
+
+NavigationPathService::NavigationPathService(Context* context)
+    : Component(context)
+    , maxIterations_(DEFAULT_MAX_ITERATIONS)
+    , maxCachedPaths_(DEFAULT_MAX_CACHED_PATHS)
+{
+}
+
+NavigationPathService::~NavigationPathService() = default;
+
+void NavigationPathService::RegisterObject(Context* context)
+{
+    context->RegisterFactory<NavigationPathService>(NAVIGATION_CATEGORY);
+
+    URHO3D_ACCESSOR_ATTRIBUTE("Max Iterations", GetMaxIterations, SetMaxIterations, unsigned, DEFAULT_MAX_ITERATIONS, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Max Cached Paths", GetMaxCachedPaths, SetMaxCachedPaths, unsigned, DEFAULT_MAX_CACHED_PATHS, AM_DEFAULT);
+}
+
+void NavigationPathService::SetNavigationMesh(NavigationMesh* navMesh)
+{
+    if (navMesh == navigationMesh_)
+        return;
+
+    if (navigationMesh_)
+    {
+        UnsubscribeFromEvent(navigationMesh_, E_NAVIGATION_MESH_REBUILT);
+        UnsubscribeFromEvent(navigationMesh_, E_NAVIGATION_AREA_REBUILT);
+        UnsubscribeFromEvent(navigationMesh_, E_NAVIGATION_TILE_ADDED);
+        UnsubscribeFromEvent(navigationMesh_, E_NAVIGATION_TILE_REMOVED);
+        UnsubscribeFromEvent(navigationMesh_, E_NAVIGATION_ALL_TILES_REMOVED);
+    }
+
+    navigationMesh_ = navMesh;
+
+    if (navigationMesh_)
+    {
+        // Any change of navigation data invalidates polygon references
+        SubscribeToEvent(navigationMesh_, E_NAVIGATION_MESH_REBUILT, URHO3D_HANDLER(NavigationPathService, HandleNavMeshChanged));
+        SubscribeToEvent(navigationMesh_, E_NAVIGATION_AREA_REBUILT, URHO3D_HANDLER(NavigationPathService, HandleNavMeshChanged));
+        SubscribeToEvent(navigationMesh_, E_NAVIGATION_TILE_ADDED, URHO3D_HANDLER(NavigationPathService, HandleNavMeshChanged));
+        SubscribeToEvent(navigationMesh_, E_NAVIGATION_TILE_REMOVED, URHO3D_HANDLER(NavigationPathService, HandleNavMeshChanged));
+        SubscribeToEvent(navigationMesh_, E_NAVIGATION_ALL_TILES_REMOVED, URHO3D_HANDLER(NavigationPathService, HandleNavMeshChanged));
+    }
+
+    navMeshDirty_ = true;
+}
+
+void NavigationPathService::SetMaxCachedPaths(unsigned maxCachedPaths)
+{
+    maxCachedPaths_ = maxCachedPaths;
+    TrimCache(maxCachedPaths_);
+}
+
+unsigned NavigationPathService::RequestPath(const Vector3& start, const Vector3& end, const NavigationPathCallback& callback,
+    int priority, const Vector3& extents, const dtQueryFilter* filter)
+{
+    Request request;
+    request.id_ = nextRequestId_++;
+    if (!nextRequestId_)
+        nextRequestId_ = 1;
+    request.priority_ = priority;
+    request.start_ = start;
+    request.end_ = end;
+    request.extents_ = extents;
+    request.filter_ = filter;
+    request.callback_ = callback;
+
+    requests_.push_back(ea::move(request));
+    requestsSorted_ = false;
+    return requests_.back().id_;
+}
+
+bool NavigationPathService::CancelRequest(unsigned requestId)
+{
+    // Worker threads are idle outside of Update, so both queue and slots may be modified here
+    const auto iter = ea::find_if(requests_.begin(), requests_.end(),
+        [&](const Request& request) { return request.id_ == requestId; });
+    if (iter != requests_.end())
+    {
+        requests_.erase(iter);
+        return true;
+    }
+
+    for (const auto& slot : slots_)
+    {
+        if (slot->active_ && slot->request_.id_ == requestId)
+        {
+            slot->active_ = false;
+            slot->request_ = Request{};
+            return true;
+        }
+    }
+    return false;
+}
+
+void NavigationPathService::Update()
+{
+    URHO3D_PROFILE("UpdatePathRequests");
+
+    if (navMeshDirty_)
+    {
+        ClearCache();
+        RestartActiveRequests();
+        navMeshDirty_ = false;
+    }
+
+    if (!InitializeSlots())
+        return;
+
+    if (GetNumPendingRequests() == 0)
+        return;
+
+    if (!requestsSorted_)
+    {
+        // Higher priority first, older requests first within the same priority
+        ea::sort(requests_.begin(), requests_.end(), [](const Request& lhs, const Request& rhs)
+        {
+            return lhs.priority_ != rhs.priority_ ? lhs.priority_ > rhs.priority_ : lhs.id_ < rhs.id_;
+        });
+        requestsSorted_ = true;
+    }
+
+    transform_ = navigationMesh_->GetNode()->GetWorldTransform();
+    inverseTransform_ = transform_.Inverse();
+    defaultFilter_ = navigationMesh_->queryFilter_.get();
+    nextRequest_ = 0;
+
+    auto workQueue = GetSubsystem<WorkQueue>();
+    ForEachParallel(workQueue, slots_,
+        [this](unsigned /*index*/, const ea::unique_ptr<NavigationPathSlot>& slot) { ProcessSlot(*slot); });
+
+    const unsigned numTakenRequests = Min(nextRequest_.load(), requests_.size());
+    requests_.erase(requests_.begin(), requests_.begin() + numTakenRequests);
+
+    CommitResults();
+}
+
+void NavigationPathService::ClearCache()
+{
+    cache_.clear();
+    recentPaths_.clear();
+}
+
+unsigned NavigationPathService::GetNumPendingRequests() const
+{
+    unsigned numRequests = requests_.size();
+    for (const auto& slot : slots_)
+    {
+        if (slot->active_)
+            ++numRequests;
+    }
+    return numRequests;
+}
+
+void NavigationPathService::OnSceneSet(Scene* scene)
+{
+    if (scene)
+    {
+        if (scene != node_)
+        {
+            URHO3D_LOGERROR("NavigationPathService is a scene component and should only be attached to the scene node");
+            return;
+        }
+
+        SubscribeToEvent(scene, E_SCENESUBSYSTEMUPDATE, URHO3D_HANDLER(NavigationPathService, HandleSceneSubsystemUpdate));
+
+        if (!navigationMesh_)
+            SetNavigationMesh(scene->GetDerivedComponent<NavigationMesh>(true));
+    }
+    else
+    {
+        UnsubscribeFromEvent(E_SCENESUBSYSTEMUPDATE);
+        SetNavigationMesh(nullptr);
+    }
+}
+
+void NavigationPathService::HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData)
+{
+    if (IsEnabledEffective())
+        Update();
+}
+
+void NavigationPathService::HandleNavMeshChanged(StringHash eventType, VariantMap& eventData)
+{
+    navMeshDirty_ = true;
+}
+
+bool NavigationPathService::InitializeSlots()
+{
+    dtNavMesh* navMesh = navigationMesh_ ? navigationMesh_->navMesh_ : nullptr;
+    if (!navMesh)
+        return false;
+
+    auto workQueue = GetSubsystem<WorkQueue>();
+    const unsigned numSlots = workQueue->GetNumThreads() + 1;
+    if (navMesh == detourNavMesh_ && slots_.size() == numSlots)
+        return true;
+
+    RestartActiveRequests();
+    ClearCache();
+    slots_.clear();
+    detourNavMesh_ = nullptr;
+
+    for (unsigned i = 0; i < numSlots; ++i)
+    {
+        auto slot = ea::make_unique<NavigationPathSlot>();
+        if (!slot->query_ || dtStatusFailed(slot->query_->init(navMesh, MAX_POLYS)))
+        {
+            URHO3D_LOGERROR("Could not init navigation mesh query");
+            slots_.clear();
+            return false;
+        }
+        slots_.push_back(ea::move(slot));
+    }
+
+    detourNavMesh_ = navMesh;
+    return true;
+}
+
+void NavigationPathService::RestartActiveRequests()
+{
+    for (const auto& slot : slots_)
+    {
+        if (slot->active_)
+        {
+            slot->active_ = false;
+            requests_.push_back(ea::move(slot->request_));
+            requestsSorted_ = false;
+            ++stats_.numRestarted_;
+        }
+    }
+}
+
+void NavigationPathService::ProcessSlot(NavigationPathSlot& slot)
+{
+    unsigned iterationsLeft = maxIterations_;
+    while (iterationsLeft > 0)
+    {
+        if (!slot.active_)
+        {
+            const unsigned index = nextRequest_.fetch_add(1, std::memory_order_relaxed);
+            if (index >= requests_.size())
+                break;
+
+            // Each request is taken by exactly one slot.
+            // Starting a request costs one iteration even if it completes without path search
+            slot.request_ = ea::move(requests_[index]);
+            slot.active_ = true;
+            --iterationsLeft;
+            if (!StartRequest(slot))
+                continue;
+        }
+
+        int numIterations = 0;
+        const dtStatus status = slot.query_->updateSlicedFindPath(static_cast<int>(iterationsLeft), &numIterations);
+        iterationsLeft -= Min(iterationsLeft, static_cast<unsigned>(Max(numIterations, 1)));
+
+        if (!dtStatusInProgress(status))
+            FinishRequest(slot, nullptr);
+    }
+}
+
+bool NavigationPathService::StartRequest(NavigationPathSlot& slot)
+{
+    const Request& request = slot.request_;
+    dtNavMeshQuery* query = slot.query_;
+
+    slot.localStart_ = inverseTransform_ * request.start_;
+    slot.localEnd_ = inverseTransform_ * request.end_;
+    slot.key_.filter_ = request.filter_ ? request.filter_ : defaultFilter_;
+    slot.key_.startRef_ = 0;
+    slot.key_.endRef_ = 0;
+
+    query->findNearestPoly(&slot.localStart_.x_, &request.extents_.x_, slot.key_.filter_, &slot.key_.startRef_, nullptr);
+    query->findNearestPoly(&slot.localEnd_.x_, &request.extents_.x_, slot.key_.filter_, &slot.key_.endRef_, nullptr);
+    if (!slot.key_.startRef_ || !slot.key_.endRef_)
+    {
+        FinishRequest(slot, nullptr);
+        return false;
+    }
+
+    // Cache is not modified while worker threads are running
+    const auto iter = cache_.find(slot.key_);
+    if (iter != cache_.end())
+    {
+        slot.cacheHits_.push_back(slot.key_);
+        FinishRequest(slot, &iter->second.polys_);
+        return false;
+    }
+
+    const dtStatus status = query->initSlicedFindPath(slot.key_.startRef_, slot.key_.endRef_,
+        &slot.localStart_.x_, &slot.localEnd_.x_, slot.key_.filter_);
+    if (dtStatusFailed(status))
+    {
+        slot.key_.startRef_ = 0;
+        FinishRequest(slot, nullptr);
+        return false;
+    }
+    return true;
+}
+
+void NavigationPathService::FinishRequest(NavigationPathSlot& slot, const ea::vector<dtPolyRef>* cachedPolys)
+{
+    dtNavMeshQuery* query = slot.query_;
+
+    NavigationPathResult result;
+    result.requestId_ = slot.request_.id_;
+
+    const dtPolyRef* polys = slot.polys_.data();
+    int numPolys = 0;
+    if (cachedPolys)
+    {
+        polys = cachedPolys->data();
+        numPolys = static_cast<int>(cachedPolys->size());
+        result.cached_ = true;
+    }
+    else if (slot.key_.startRef_ && slot.key_.endRef_)
+    {
+        if (dtStatusFailed(query->finalizeSlicedFindPath(slot.polys_.data(), &numPolys, MAX_POLYS)))
+            numPolys = 0;
+        if (numPolys > 0)
+            slot.newCacheEntries_.emplace_back(slot.key_, ea::vector<dtPolyRef>(polys, polys + numPolys));
+    }
+
+    if (numPolys > 0)
+    {
+        // If full path was not found, clamp end point to the end polygon
+        Vector3 actualLocalEnd = slot.localEnd_;
+        if (polys[numPolys - 1] != slot.key_.endRef_)
+        {
+            query->closestPointOnPoly(polys[numPolys - 1], &slot.localEnd_.x_, &actualLocalEnd.x_, nullptr);
+            result.partial_ = true;
+        }
+
+        int numPathPoints = 0;
+        query->findStraightPath(&slot.localStart_.x_, &actualLocalEnd.x_, polys, numPolys,
+            &slot.points_[0].x_, nullptr, nullptr, &numPathPoints, MAX_POLYS);
+
+        result.path_.reserve(numPathPoints);
+        for (int i = 0; i < numPathPoints; ++i)
+            result.path_.push_back(transform_ * slot.points_[i]);
+        result.success_ = numPathPoints > 0;
+    }
+
+    slot.completed_.emplace_back(ea::move(slot.request_.callback_), ea::move(result));
+    slot.request_ = Request{};
+    slot.active_ = false;
+}
+
+void NavigationPathService::CommitResults()
+{
+    ea::vector<ea::pair<NavigationPathCallback, NavigationPathResult>> completed;
+    for (const auto& slot : slots_)
+    {
+        for (const CacheKey& key : slot->cacheHits_)
+            TouchCacheEntry(key);
+        slot->cacheHits_.clear();
+
+        for (auto& entry : slot->newCacheEntries_)
+            AddCacheEntry(entry.first, ea::move(entry.second));
+        slot->newCacheEntries_.clear();
+
+        for (auto& entry : slot->completed_)
+            completed.push_back(ea::move(entry));
+        slot->completed_.clear();
+    }
+
+    // Callbacks may queue or cancel requests, so state should be consistent at this point
+    for (auto& [callback, result] : completed)
+    {
+        ++stats_.numCompleted_;
+        if (!result.success_)
+            ++stats_.numFailed_;
+        if (result.cached_)
+            ++stats_.numCacheHits_;
+
+        if (callback)
+            callback(result);
+    }
+}
+
+void NavigationPathService::AddCacheEntry(const CacheKey& key, ea::vector<dtPolyRef> polys)
+{
+    if (maxCachedPaths_ == 0)
+        return;
+
+    const auto iter = cache_.find(key);
+    if (iter != cache_.end())
+    {
+        iter->second.polys_ = ea::move(polys);
+        recentPaths_.splice(recentPaths_.begin(), recentPaths_, iter->second.lruIterator_);
+        return;
+    }
+
+    TrimCache(maxCachedPaths_ - 1);
+
+    CacheEntry& entry = cache_[key];
+    entry.polys_ = ea::move(polys);
+    entry.lruIterator_ = recentPaths_.insert(recentPaths_.begin(), key);
+}
+
+void NavigationPathService::TouchCacheEntry(const CacheKey& key)
+{
+    // Entry may be evicted by paths committed earlier in the same update
+    const auto iter = cache_.find(key);
+    if (iter != cache_.end())
+        recentPaths_.splice(recentPaths_.begin(), recentPaths_, iter->second.lruIterator_);
+}
+
+void NavigationPathService::TrimCache(unsigned maxSize)
+{
+    while (cache_.size() > maxSize)
+    {
+        cache_.erase(recentPaths_.back());
+        recentPaths_.pop_back();
+    }
+}
+
+}
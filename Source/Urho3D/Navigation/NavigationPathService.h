@@ -0,0 +1,251 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#include "../Math/Matrix3x4.h"
+#include "../Scene/Component.h"
+
+#include <EASTL/hash_map.h>
+#include <EASTL/list.h>
+#include <EASTL/unique_ptr.h>
+
+#include <atomic>
+
+#ifdef DT_POLYREF64
+using dtPolyRef = uint64_t;
+#else
+using dtPolyRef = unsigned int;
+#endif
+
+class dtNavMesh;
+class dtQueryFilter;
+
+namespace Urho3D
+{
+
+class NavigationMesh;
+struct NavigationPathSlot;
+
+/// Result of asynchronous path request.
+struct NavigationPathResult
+{
+    /// Request ID returned by NavigationPathService::RequestPath.
+    unsigned requestId_{};
+    /// Whether the path is found. Path may be partial if the end point is unreachable.
+    bool success_{};
+    /// Whether the path ends at the closest reachable point instead of the end point.
+    bool partial_{};
+    /// Whether the path corridor was taken from the cache.
+    bool cached_{};
+    /// World-space path points.
+    ea::vector<Vector3> path_;
+};
+
+/// Callback invoked in the main thread when path request is completed.
+using NavigationPathCallback = std::function<void(const NavigationPathResult& result)>;
+
+/// Path request statistics, accumulated since the creation of the service.
+struct NavigationPathStats
+{
+    /// Number of completed requests.
+    unsigned numCompleted_{};
+    /// Number of failed requests.
+    unsigned numFailed_{};
+    /// Number of requests served from the path cache.
+    unsigned numCacheHits_{};
+    /// Number of requests that were restarted because the navigation mesh changed.
+    unsigned numRestarted_{};
+};
+
+/// Path request service scene component. Processes path requests in batches on WorkQueue threads.
+/// Each thread slot owns Detour query, and long requests are processed in time slices across several frames.
+/// Should be added only to the root scene node.
+class URHO3D_API NavigationPathService : public Component
+{
+    URHO3D_OBJECT(NavigationPathService, Component);
+
+public:
+    /// Construct.
+    explicit NavigationPathService(Context* context);
+    /// Destruct.
+    ~NavigationPathService() override;
+    /// Register object factory.
+    /// @nobind
+    static void RegisterObject(Context* context);
+
+    /// Assign the navigation mesh.
+    /// @property{set_navMesh}
+    void SetNavigationMesh(NavigationMesh* navMesh);
+    /// Set max number of search iterations per frame for each thread slot.
+    /// @property
+    void SetMaxIterations(unsigned iterations) { maxIterations_ = Max(iterations, 1u); }
+    /// Set max number of cached path corridors.
+    /// @property
+    void SetMaxCachedPaths(unsigned maxCachedPaths);
+
+    /// Queue path request between world space points. Requests with higher priority are processed first.
+    /// Callback is invoked from the main thread when the request is completed. Return request ID.
+    unsigned RequestPath(const Vector3& start, const Vector3& end, const NavigationPathCallback& callback, int priority = 0,
+        const Vector3& extents = Vector3::ONE, const dtQueryFilter* filter = nullptr);
+    /// Cancel path request. Callback will not be invoked. Return true if the request was pending.
+    bool CancelRequest(unsigned requestId);
+    /// Process queued requests in worker threads. Called automatically on scene subsystem update.
+    void Update();
+    /// Clear path cache.
+    void ClearCache();
+
+    /// Return the navigation mesh.
+    /// @property{get_navMesh}
+    NavigationMesh* GetNavigationMesh() const { return navigationMesh_; }
+    /// Return max number of search iterations per frame for each thread slot.
+    /// @property
+    unsigned GetMaxIterations() const { return maxIterations_; }
+    /// Return max number of cached path corridors.
+    /// @property
+    unsigned GetMaxCachedPaths() const { return maxCachedPaths_; }
+    /// Return number of requests not completed yet.
+    unsigned GetNumPendingRequests() const;
+    /// Return statistics.
+    const NavigationPathStats& GetStats() const { return stats_; }
+
+    /// Path request.
+    /// @nobind
+    struct Request
+    {
+        /// Request ID.
+        unsigned id_{};
+        /// Priority.
+        int priority_{};
+        /// Start point in world space.
+        Vector3 start_;
+        /// End point in world space.
+        Vector3 end_;
+        /// Search extents.
+        Vector3 extents_;
+        /// Query filter.
+        const dtQueryFilter* filter_{};
+        /// Callback.
+        NavigationPathCallback callback_;
+    };
+
+    /// Key of the path cache.
+    /// @nobind
+    struct CacheKey
+    {
+        /// Start polygon.
+        dtPolyRef startRef_{};
+        /// End polygon.
+        dtPolyRef endRef_{};
+        /// Query filter.
+        const dtQueryFilter* filter_{};
+
+        /// Compare.
+        bool operator==(const CacheKey& rhs) const
+        {
+            return startRef_ == rhs.startRef_ && endRef_ == rhs.endRef_ && filter_ == rhs.filter_;
+        }
+
+        /// Return hash value.
+        unsigned ToHash() const
+        {
+            unsigned hash = 0;
+            CombineHash(hash, static_cast<unsigned>(startRef_));
+            CombineHash(hash, static_cast<unsigned>(endRef_));
+            CombineHash(hash, MakeHash(filter_));
+            return hash;
+        }
+    };
+
+    /// Cached path corridor.
+    /// @nobind
+    struct CacheEntry
+    {
+        /// Polygons of the corridor.
+        ea::vector<dtPolyRef> polys_;
+        /// Position in the list of recently used paths.
+        ea::list<CacheKey>::iterator lruIterator_;
+    };
+
+private:
+    /// Handle scene being assigned.
+    void OnSceneSet(Scene* scene) override;
+    /// Handle the scene subsystem update event.
+    void HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle navigation mesh change.
+    void HandleNavMeshChanged(StringHash eventType, VariantMap& eventData);
+    /// Ensure that thread slots are initialized for current Detour navigation mesh. Return true if successful.
+    bool InitializeSlots();
+    /// Return active requests of thread slots to the queue.
+    void RestartActiveRequests();
+    /// Process requests in one thread slot. Called from worker threads.
+    void ProcessSlot(NavigationPathSlot& slot);
+    /// Start active request of the thread slot. Return false if the request is already completed.
+    bool StartRequest(NavigationPathSlot& slot);
+    /// Finish active request of the thread slot.
+    void FinishRequest(NavigationPathSlot& slot, const ea::vector<dtPolyRef>* cachedPolys);
+    /// Invoke callbacks and update cache. Called from the main thread.
+    void CommitResults();
+    /// Add or replace cached path corridor. Evict least recently used corridors if the cache is full.
+    void AddCacheEntry(const CacheKey& key, ea::vector<dtPolyRef> polys);
+    /// Mark cached path corridor as most recently used.
+    void TouchCacheEntry(const CacheKey& key);
+    /// Evict least recently used corridors until the cache fits the size.
+    void TrimCache(unsigned maxSize);
+
+    /// Navigation mesh.
+    WeakPtr<NavigationMesh> navigationMesh_;
+    /// Detour navigation mesh the slots are initialized for.
+    dtNavMesh* detourNavMesh_{};
+    /// Thread slots.
+    ea::vector<ea::unique_ptr<NavigationPathSlot>> slots_;
+    /// Pending requests sorted by priority. Read by worker threads during update.
+    ea::vector<Request> requests_;
+    /// Index of the next request taken by worker threads.
+    std::atomic<unsigned> nextRequest_{};
+    /// Cached path corridors. Read-only during update.
+    ea::hash_map<CacheKey, CacheEntry> cache_;
+    /// Keys of cached path corridors from most to least recently used.
+    ea::list<CacheKey> recentPaths_;
+    /// Transform from navigation mesh space to world space for current update.
+    Matrix3x4 transform_;
+    /// Transform from world space to navigation mesh space for current update.
+    Matrix3x4 inverseTransform_;
+    /// Default query filter of the navigation mesh for current update.
+    const dtQueryFilter* defaultFilter_{};
+    /// Next request ID.
+    unsigned nextRequestId_{1};
+    /// Max number of search iterations per frame for each thread slot.
+    unsigned maxIterations_{};
+    /// Max number of cached path corridors.
+    unsigned maxCachedPaths_{};
+    /// Whether the requests are sorted.
+    bool requestsSorted_{true};
+    /// Whether the navigation mesh has changed since last update.
+    bool navMeshDirty_{};
+    /// Statistics.
+    NavigationPathStats stats_;
+};
+
+}
@@ -0,0 +1,923 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Math/MathDefs.h"
+#include "../Resource/BlockCompression.h"
+#include "../Resource/ImageProcessing.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Number of block rows compressed by one task.
+const unsigned BLOCK_ROWS_PER_TASK = 4;
+/// Number of endpoint refinement passes for each quality level.
+const unsigned NUM_REFINEMENT_PASSES[] = {1, 2, 4};
+
+/// Interpolation weights of 2-bit indices. Shared by BPTC formats and ASTC weights.
+const int WEIGHTS_2[4] = {0, 21, 43, 64};
+/// Interpolation weights of 3-bit indices. Shared by BPTC formats and ASTC weights.
+const int WEIGHTS_3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+/// Interpolation weights of 4-bit indices.
+const int WEIGHTS_4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+/// BC7 mode 6 stores 7-bit endpoints with shared p-bit per endpoint.
+const unsigned BC7_MODE_6 = 6;
+/// BC6H mode 11 stores 10-bit endpoints without deltas.
+const unsigned BC6H_MODE_11 = 0x03;
+/// Largest half float value produced by BC6H.
+const unsigned BC6H_MAX_HALF = 0x7bff;
+
+/// ASTC block mode of 4x4 grid of 3-bit weights.
+const unsigned ASTC_BLOCK_MODE_WEIGHTS_3 = 0x53;
+/// ASTC block mode of 4x4 grid of 2-bit weights.
+const unsigned ASTC_BLOCK_MODE_WEIGHTS_2 = 0x42;
+/// ASTC color endpoint mode of LDR RGB direct.
+const unsigned ASTC_CEM_RGB = 8;
+/// ASTC color endpoint mode of LDR RGBA direct.
+const unsigned ASTC_CEM_RGBA = 12;
+/// Lower 9 bits of ASTC void-extent block mode.
+const unsigned ASTC_VOID_EXTENT = 0x1fc;
+
+/// Pixels of block in float.
+using BlockPixels = float[16][4];
+
+/// Writer of 128-bit block, least significant bit first.
+class BlockBitWriter
+{
+public:
+    /// Construct and clear the block.
+    explicit BlockBitWriter(unsigned char* dest)
+        : dest_(dest)
+    {
+        memset(dest_, 0, BLOCK_COMPRESSION_BLOCK_SIZE);
+    }
+
+    /// Write bits from the beginning of the block.
+    void Write(unsigned value, unsigned numBits)
+    {
+        for (unsigned i = 0; i < numBits; ++i)
+            SetBit(position_++, (value >> i) & 1u);
+    }
+
+    /// Write bits from the end of the block in reverse order.
+    void WriteReversed(unsigned value, unsigned numBits)
+    {
+        for (unsigned i = 0; i < numBits; ++i)
+            SetBit(127 - reversePosition_++, (value >> i) & 1u);
+    }
+
+private:
+    void SetBit(unsigned index, unsigned value)
+    {
+        if (value)
+            dest_[index >> 3u] |= 1u << (index & 7u);
+    }
+
+    /// Block data.
+    unsigned char* dest_{};
+    /// Position of the next bit.
+    unsigned position_{};
+    /// Position of the next bit from the end.
+    unsigned reversePosition_{};
+};
+
+/// Reader of 128-bit block, least significant bit first.
+class BlockBitReader
+{
+public:
+    /// Construct.
+    explicit BlockBitReader(const unsigned char* block)
+        : block_(block)
+    {
+    }
+
+    /// Read bits from the beginning of the block.
+    unsigned Read(unsigned numBits)
+    {
+        unsigned value = 0;
+        for (unsigned i = 0; i < numBits; ++i)
+            value |= GetBit(position_++) << i;
+        return value;
+    }
+
+    /// Read bits from the end of the block in reverse order.
+    unsigned ReadReversed(unsigned numBits)
+    {
+        unsigned value = 0;
+        for (unsigned i = 0; i < numBits; ++i)
+            value |= GetBit(127 - reversePosition_++) << i;
+        return value;
+    }
+
+private:
+    unsigned GetBit(unsigned index) const { return (block_[index >> 3u] >> (index & 7u)) & 1u; }
+
+    /// Block data.
+    const unsigned char* block_{};
+    /// Position of the next bit.
+    unsigned position_{};
+    /// Position of the next bit from the end.
+    unsigned reversePosition_{};
+};
+
+/// Interpolate between endpoints with 6-bit weight.
+int Interpolate(int a, int b, int weight)
+{
+    return ((64 - weight) * a + weight * b + 32) >> 6;
+}
+
+/// Fit endpoints to the pixels along principal axis.
+void FitEndpoints(const BlockPixels& pixels, unsigned numChannels, float endpoints[2][4])
+{
+    float mean[4]{};
+    float minValue[4]{M_INFINITY, M_INFINITY, M_INFINITY, M_INFINITY};
+    float maxValue[4]{-M_INFINITY, -M_INFINITY, -M_INFINITY, -M_INFINITY};
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        for (unsigned c = 0; c < numChannels; ++c)
+        {
+            mean[c] += pixels[i][c] / 16.0f;
+            minValue[c] = Min(minValue[c], pixels[i][c]);
+            maxValue[c] = Max(maxValue[c], pixels[i][c]);
+        }
+    }
+
+    float covariance[4][4]{};
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        for (unsigned c = 0; c < numChannels; ++c)
+        {
+            for (unsigned d = 0; d < numChannels; ++d)
+                covariance[c][d] += (pixels[i][c] - mean[c]) * (pixels[i][d] - mean[d]);
+        }
+    }
+
+    // Power iteration starting from the diagonal of the bounding box
+    float axis[4]{};
+    for (unsigned c = 0; c < numChannels; ++c)
+        axis[c] = maxValue[c] - minValue[c];
+
+    for (unsigned iteration = 0; iteration < 8; ++iteration)
+    {
+        float nextAxis[4]{};
+        float length = 0.0f;
+        for (unsigned c = 0; c < numChannels; ++c)
+        {
+            for (unsigned d = 0; d < numChannels; ++d)
+                nextAxis[c] += covariance[c][d] * axis[d];
+            length = Max(length, Abs(nextAxis[c]));
+        }
+
+        if (length < M_EPSILON)
+            break;
+
+        for (unsigned c = 0; c < numChannels; ++c)
+            axis[c] = nextAxis[c] / length;
+    }
+
+    float minProjection = M_INFINITY;
+    float maxProjection = -M_INFINITY;
+    float axisLengthSquared = 0.0f;
+    for (unsigned c = 0; c < numChannels; ++c)
+        axisLengthSquared += axis[c] * axis[c];
+
+    if (axisLengthSquared < M_EPSILON)
+    {
+        for (unsigned c = 0; c < numChannels; ++c)
+            endpoints[0][c] = endpoints[1][c] = mean[c];
+        return;
+    }
+
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        float projection = 0.0f;
+        for (unsigned c = 0; c < numChannels; ++c)
+            projection += (pixels[i][c] - mean[c]) * axis[c];
+        minProjection = Min(minProjection, projection);
+        maxProjection = Max(maxProjection, projection);
+    }
+
+    for (unsigned c = 0; c < numChannels; ++c)
+    {
+        endpoints[0][c] = mean[c] + axis[c] * minProjection / axisLengthSquared;
+        endpoints[1][c] = mean[c] + axis[c] * maxProjection / axisLengthSquared;
+    }
+}
+
+/// Refine endpoints by least squares fit for given weights of the pixels in [0, 1] range. Return false if failed.
+bool RefineEndpoints(const BlockPixels& pixels, const float weights[16], unsigned numChannels, float endpoints[2][4])
+{
+    float a = 0.0f;
+    float b = 0.0f;
+    float c = 0.0f;
+    float x0[4]{};
+    float x1[4]{};
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        const float w = weights[i];
+        a += (1.0f - w) * (1.0f - w);
+        b += (1.0f - w) * w;
+        c += w * w;
+        for (unsigned ch = 0; ch < numChannels; ++ch)
+        {
+            x0[ch] += (1.0f - w) * pixels[i][ch];
+            x1[ch] += w * pixels[i][ch];
+        }
+    }
+
+    const float det = a * c - b * b;
+    if (Abs(det) < M_EPSILON)
+        return false;
+
+    for (unsigned ch = 0; ch < numChannels; ++ch)
+    {
+        endpoints[0][ch] = (c * x0[ch] - b * x1[ch]) / det;
+        endpoints[1][ch] = (a * x1[ch] - b * x0[ch]) / det;
+    }
+    return true;
+}
+
+/// Select the nearest palette entry for each pixel. Return total squared error.
+int SelectIndices(const int pixels[16][4], const int palette[][4], unsigned paletteSize, unsigned numChannels,
+    unsigned char indices[16])
+{
+    int totalError = 0;
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        int bestError = M_MAX_INT;
+        for (unsigned j = 0; j < paletteSize; ++j)
+        {
+            int error = 0;
+            for (unsigned c = 0; c < numChannels; ++c)
+            {
+                const int delta = pixels[i][c] - palette[j][c];
+                error += delta * delta;
+            }
+
+            if (error < bestError)
+            {
+                bestError = error;
+                indices[i] = static_cast<unsigned char>(j);
+            }
+        }
+        totalError += bestError;
+    }
+    return totalError;
+}
+
+/// Return weights of the pixels in [0, 1] range.
+void GetPixelWeights(const unsigned char indices[16], const int* weightTable, float weights[16])
+{
+    for (unsigned i = 0; i < 16; ++i)
+        weights[i] = weightTable[indices[i]] / 64.0f;
+}
+
+/// Encoded BC7 mode 6 block.
+struct BC7Mode6Block
+{
+    /// 7-bit endpoints.
+    int endpoints_[2][4]{};
+    /// P-bits of endpoints.
+    int pBits_[2]{};
+    /// 4-bit indices.
+    unsigned char indices_[16]{};
+    /// Squared error.
+    int error_{M_MAX_INT};
+};
+
+/// Quantize BC7 mode 6 endpoints with given p-bits and select indices.
+void EncodeBC7Mode6(const int pixels[16][4], const float endpoints[2][4], const int pBits[2], BC7Mode6Block& block)
+{
+    int expanded[2][4];
+    for (unsigned e = 0; e < 2; ++e)
+    {
+        block.pBits_[e] = pBits[e];
+        for (unsigned c = 0; c < 4; ++c)
+        {
+            block.endpoints_[e][c] = Clamp(RoundToInt((endpoints[e][c] - pBits[e]) * 0.5f), 0, 127);
+            expanded[e][c] = (block.endpoints_[e][c] << 1) | pBits[e];
+        }
+    }
+
+    int palette[16][4];
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        for (unsigned c = 0; c < 4; ++c)
+            palette[i][c] = Interpolate(expanded[0][c], expanded[1][c], WEIGHTS_4[i]);
+    }
+
+    block.error_ = SelectIndices(pixels, palette, 16, 4, block.indices_);
+}
+
+/// Return best p-bit for the endpoint.
+int SelectPBit(const float endpoint[4])
+{
+    float errors[2]{};
+    for (int p = 0; p < 2; ++p)
+    {
+        for (unsigned c = 0; c < 4; ++c)
+        {
+            const int value = (Clamp(RoundToInt((endpoint[c] - p) * 0.5f), 0, 127) << 1) | p;
+            errors[p] += (value - endpoint[c]) * (value - endpoint[c]);
+        }
+    }
+    return errors[1] < errors[0] ? 1 : 0;
+}
+
+/// Pack BC7 mode 6 block.
+void PackBC7Mode6(unsigned char* dest, BC7Mode6Block block)
+{
+    // Most significant bit of the first index is implicitly zero
+    if (block.indices_[0] & 0x8)
+    {
+        ea::swap(block.endpoints_[0], block.endpoints_[1]);
+        ea::swap(block.pBits_[0], block.pBits_[1]);
+        for (unsigned char& index : block.indices_)
+            index = static_cast<unsigned char>(15 - index);
+    }
+
+    BlockBitWriter writer(dest);
+    writer.Write(1u << BC7_MODE_6, BC7_MODE_6 + 1);
+    for (unsigned c = 0; c < 4; ++c)
+    {
+        writer.Write(block.endpoints_[0][c], 7);
+        writer.Write(block.endpoints_[1][c], 7);
+    }
+    writer.Write(block.pBits_[0], 1);
+    writer.Write(block.pBits_[1], 1);
+    for (unsigned i = 0; i < 16; ++i)
+        writer.Write(block.indices_[i], i == 0 ? 3 : 4);
+}
+
+/// Unquantize 10-bit BC6H endpoint component.
+int UnquantizeBC6H(int value)
+{
+    if (value == 0)
+        return 0;
+    if (value == 1023)
+        return 0xffff;
+    return ((value << 16) + 0x8000) >> 10;
+}
+
+/// Convert interpolated BC6H value to half float bits.
+int FinishUnquantizeBC6H(int value)
+{
+    return (value * 31) >> 6;
+}
+
+/// Encoded BC6H mode 11 block.
+struct BC6HMode11Block
+{
+    /// 10-bit endpoints.
+    int endpoints_[2][3]{};
+    /// 4-bit indices.
+    unsigned char indices_[16]{};
+    /// Squared error in half float bits.
+    int error_{M_MAX_INT};
+};
+
+/// Quantize BC6H mode 11 endpoints and select indices. Pixels are half float bits, endpoints are in unquantized range.
+void EncodeBC6HMode11(const int pixels[16][4], const float endpoints[2][4], BC6HMode11Block& block)
+{
+    int unquantized[2][3];
+    for (unsigned e = 0; e < 2; ++e)
+    {
+        for (unsigned c = 0; c < 3; ++c)
+        {
+            block.endpoints_[e][c] = Clamp(RoundToInt((endpoints[e][c] - 32.0f) / 64.0f), 0, 1023);
+            unquantized[e][c] = UnquantizeBC6H(block.endpoints_[e][c]);
+        }
+    }
+
+    int palette[16][4];
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        for (unsigned c = 0; c < 3; ++c)
+            palette[i][c] = FinishUnquantizeBC6H(Interpolate(unquantized[0][c], unquantized[1][c], WEIGHTS_4[i]));
+    }
+
+    block.error_ = SelectIndices(pixels, palette, 16, 3, block.indices_);
+}
+
+/// Pack BC6H mode 11 block.
+void PackBC6HMode11(unsigned char* dest, BC6HMode11Block block)
+{
+    // Most significant bit of the first index is implicitly zero
+    if (block.indices_[0] & 0x8)
+    {
+        ea::swap(block.endpoints_[0], block.endpoints_[1]);
+        for (unsigned char& index : block.indices_)
+            index = static_cast<unsigned char>(15 - index);
+    }
+
+    BlockBitWriter writer(dest);
+    writer.Write(BC6H_MODE_11, 5);
+    for (unsigned e = 0; e < 2; ++e)
+    {
+        for (unsigned c = 0; c < 3; ++c)
+            writer.Write(block.endpoints_[e][c], 10);
+    }
+    for (unsigned i = 0; i < 16; ++i)
+        writer.Write(block.indices_[i], i == 0 ? 3 : 4);
+}
+
+/// Encoded single partition ASTC block.
+struct ASTCBlock
+{
+    /// 8-bit endpoints.
+    int endpoints_[2][4]{};
+    /// Weight indices.
+    unsigned char indices_[16]{};
+    /// Squared error.
+    int error_{M_MAX_INT};
+};
+
+/// Quantize ASTC endpoints and select weights.
+void EncodeASTC(const int pixels[16][4], const float endpoints[2][4], unsigned numChannels, const int* weights,
+    unsigned numWeights, ASTCBlock& block)
+{
+    for (unsigned e = 0; e < 2; ++e)
+    {
+        for (unsigned c = 0; c < 4; ++c)
+            block.endpoints_[e][c] = c < numChannels ? Clamp(RoundToInt(endpoints[e][c]), 0, 255) : 255;
+    }
+
+    // Decoder swaps endpoints and applies blue contraction if the second endpoint is darker
+    const int sum0 = block.endpoints_[0][0] + block.endpoints_[0][1] + block.endpoints_[0][2];
+    const int sum1 = block.endpoints_[1][0] + block.endpoints_[1][1] + block.endpoints_[1][2];
+    if (sum1 < sum0)
+        ea::swap(block.endpoints_[0], block.endpoints_[1]);
+
+    int palette[8][4];
+    for (unsigned i = 0; i < numWeights; ++i)
+    {
+        for (unsigned c = 0; c < 4; ++c)
+            palette[i][c] = Interpolate(block.endpoints_[0][c] * 257, block.endpoints_[1][c] * 257, weights[i]) >> 8;
+    }
+
+    block.error_ = SelectIndices(pixels, palette, numWeights, 4, block.indices_);
+}
+
+/// Pack single partition ASTC block.
+void PackASTC(unsigned char* dest, const ASTCBlock& block, bool opaque)
+{
+    const unsigned numChannels = opaque ? 3 : 4;
+    const unsigned weightBits = opaque ? 3 : 2;
+
+    BlockBitWriter writer(dest);
+    writer.Write(opaque ? ASTC_BLOCK_MODE_WEIGHTS_3 : ASTC_BLOCK_MODE_WEIGHTS_2, 11);
+    writer.Write(0, 2);
+    writer.Write(opaque ? ASTC_CEM_RGB : ASTC_CEM_RGBA, 4);
+    for (unsigned c = 0; c < numChannels; ++c)
+    {
+        writer.Write(block.endpoints_[0][c], 8);
+        writer.Write(block.endpoints_[1][c], 8);
+    }
+    for (unsigned i = 0; i < 16; ++i)
+        writer.WriteReversed(block.indices_[i], weightBits);
+}
+
+/// Pack ASTC void-extent block of solid color.
+void PackASTCVoidExtent(unsigned char* dest, const unsigned char* color)
+{
+    BlockBitWriter writer(dest);
+    writer.Write(ASTC_VOID_EXTENT, 9);
+    writer.Write(0, 1);
+    writer.Write(0x3, 2);
+    // Extent is not specified
+    for (unsigned i = 0; i < 4; ++i)
+        writer.Write(0x1fff, 13);
+    for (unsigned c = 0; c < 4; ++c)
+        writer.Write(color[c] * 257u, 16);
+}
+
+/// Fill block with magenta color.
+void FillMagenta(unsigned char* rgba)
+{
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        rgba[i * 4] = 255;
+        rgba[i * 4 + 1] = 0;
+        rgba[i * 4 + 2] = 255;
+        rgba[i * 4 + 3] = 255;
+    }
+}
+
+/// Gather 4x4 block of pixels, repeating the edge pixels outside of the image.
+template <class T>
+void GatherBlock(T* dest, const T* src, int width, int height, unsigned components, int blockX, int blockY)
+{
+    for (int y = 0; y < 4; ++y)
+    {
+        const int srcY = Min(blockY * 4 + y, height - 1);
+        for (int x = 0; x < 4; ++x)
+        {
+            const int srcX = Min(blockX * 4 + x, width - 1);
+            memcpy(dest + (y * 4 + x) * components, src + (srcY * width + srcX) * components, components * sizeof(T));
+        }
+    }
+}
+
+}
+
+void CompressBlockBC7(unsigned char* dest, const unsigned char* rgba, BlockCompressionQuality quality)
+{
+    int pixels[16][4];
+    BlockPixels pixelsFloat;
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        for (unsigned c = 0; c < 4; ++c)
+        {
+            pixels[i][c] = rgba[i * 4 + c];
+            pixelsFloat[i][c] = rgba[i * 4 + c];
+        }
+    }
+
+    float endpoints[2][4];
+    FitEndpoints(pixelsFloat, 4, endpoints);
+
+    BC7Mode6Block bestBlock;
+    const unsigned numPasses = NUM_REFINEMENT_PASSES[static_cast<unsigned>(quality)];
+    for (unsigned pass = 0; pass < numPasses; ++pass)
+    {
+        BC7Mode6Block block;
+        if (quality == BlockCompressionQuality::High)
+        {
+            // Try all combinations of p-bits
+            for (int pBitMask = 0; pBitMask < 4; ++pBitMask)
+            {
+                const int pBits[2] = {pBitMask & 1, pBitMask >> 1};
+                BC7Mode6Block candidate;
+                EncodeBC7Mode6(pixels, endpoints, pBits, candidate);
+                if (candidate.error_ < block.error_)
+                    block = candidate;
+            }
+        }
+        else
+        {
+            const int pBits[2] = {SelectPBit(endpoints[0]), SelectPBit(endpoints[1])};
+            EncodeBC7Mode6(pixels, endpoints, pBits, block);
+        }
+
+        if (block.error_ < bestBlock.error_)
+            bestBlock = block;
+        if (bestBlock.error_ == 0)
+            break;
+
+        float weights[16];
+        GetPixelWeights(block.indices_, WEIGHTS_4, weights);
+        if (!RefineEndpoints(pixelsFloat, weights, 4, endpoints))
+            break;
+    }
+
+    PackBC7Mode6(dest, bestBlock);
+}
+
+void CompressBlockBC6H(unsigned char* dest, const float* rgb, BlockCompressionQuality quality)
+{
+    // Endpoints are fitted in the range of unquantized values, error is measured in half float bits
+    int pixels[16][4]{};
+    BlockPixels pixelsFloat{};
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        for (unsigned c = 0; c < 3; ++c)
+        {
+            const float value = rgb[i * 3 + c];
+            const int half = value > 0.0f ? Min<int>(FloatToHalf(value), BC6H_MAX_HALF) : 0;
+            pixels[i][c] = half;
+            pixelsFloat[i][c] = half * 64.0f / 31.0f;
+        }
+    }
+
+    float endpoints[2][4];
+    FitEndpoints(pixelsFloat, 3, endpoints);
+
+    BC6HMode11Block bestBlock;
+    const unsigned numPasses = NUM_REFINEMENT_PASSES[static_cast<unsigned>(quality)];
+    for (unsigned pass = 0; pass < numPasses; ++pass)
+    {
+        BC6HMode11Block block;
+        EncodeBC6HMode11(pixels, endpoints, block);
+        if (block.error_ < bestBlock.error_)
+            bestBlock = block;
+        if (bestBlock.error_ == 0)
+            break;
+
+        float weights[16];
+        GetPixelWeights(block.indices_, WEIGHTS_4, weights);
+        if (!RefineEndpoints(pixelsFloat, weights, 3, endpoints))
+            break;
+    }
+
+    PackBC6HMode11(dest, bestBlock);
+}
+
+void CompressBlockASTC(unsigned char* dest, const unsigned char* rgba, BlockCompressionQuality quality)
+{
+    bool solid = true;
+    bool opaque = true;
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        solid = solid && memcmp(rgba, rgba + i * 4, 4) == 0;
+        opaque = opaque && rgba[i * 4 + 3] == 255;
+    }
+
+    if (solid)
+    {
+        PackASTCVoidExtent(dest, rgba);
+        return;
+    }
+
+    // Opaque blocks spend the bits of alpha endpoints on more precise weights
+    const unsigned numChannels = opaque ? 3 : 4;
+    const int* weights = opaque ? WEIGHTS_3 : WEIGHTS_2;
+    const unsigned numWeights = opaque ? 8 : 4;
+
+    int pixels[16][4];
+    BlockPixels pixelsFloat;
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        for (unsigned c = 0; c < 4; ++c)
+        {
+            pixels[i][c] = rgba[i * 4 + c];
+            pixelsFloat[i][c] = rgba[i * 4 + c];
+        }
+    }
+
+    float endpoints[2][4];
+    FitEndpoints(pixelsFloat, numChannels, endpoints);
+
+    ASTCBlock bestBlock;
+    const unsigned numPasses = NUM_REFINEMENT_PASSES[static_cast<unsigned>(quality)];
+    for (unsigned pass = 0; pass < numPasses; ++pass)
+    {
+        ASTCBlock block;
+        EncodeASTC(pixels, endpoints, numChannels, weights, numWeights, block);
+        if (block.error_ < bestBlock.error_)
+            bestBlock = block;
+        if (bestBlock.error_ == 0)
+            break;
+
+        // Endpoints may be swapped by encoding
+        for (unsigned e = 0; e < 2; ++e)
+        {
+            for (unsigned c = 0; c < 4; ++c)
+                endpoints[e][c] = static_cast<float>(block.endpoints_[e][c]);
+        }
+
+        float pixelWeights[16];
+        GetPixelWeights(block.indices_, weights, pixelWeights);
+        if (!RefineEndpoints(pixelsFloat, pixelWeights, numChannels, endpoints))
+            break;
+    }
+
+    PackASTC(dest, bestBlock, opaque);
+}
+
+void DecompressBlockBC7(unsigned char* rgba, const unsigned char* block)
+{
+    BlockBitReader reader(block);
+    unsigned mode = 0;
+    while (mode < 8 && !reader.Read(1))
+        ++mode;
+
+    if (mode == BC7_MODE_6)
+    {
+        int endpoints[2][4];
+        for (unsigned c = 0; c < 4; ++c)
+        {
+            endpoints[0][c] = reader.Read(7) << 1;
+            endpoints[1][c] = reader.Read(7) << 1;
+        }
+        const unsigned pBits[2] = {reader.Read(1), reader.Read(1)};
+        for (unsigned e = 0; e < 2; ++e)
+        {
+            for (unsigned c = 0; c < 4; ++c)
+                endpoints[e][c] |= pBits[e];
+        }
+
+        for (unsigned i = 0; i < 16; ++i)
+        {
+            const int weight = WEIGHTS_4[reader.Read(i == 0 ? 3 : 4)];
+            for (unsigned c = 0; c < 4; ++c)
+                rgba[i * 4 + c] = static_cast<unsigned char>(Interpolate(endpoints[0][c], endpoints[1][c], weight));
+        }
+    }
+    else if (mode == 4 || mode == 5)
+    {
+        const unsigned rotation = reader.Read(2);
+        const unsigned indexSelection = mode == 4 ? reader.Read(1) : 0;
+        const unsigned colorBits = mode == 4 ? 5 : 7;
+        const unsigned alphaBits = mode == 4 ? 6 : 8;
+
+        int endpoints[2][4];
+        for (unsigned c = 0; c < 4; ++c)
+        {
+            const unsigned bits = c < 3 ? colorBits : alphaBits;
+            for (unsigned e = 0; e < 2; ++e)
+            {
+                const int value = reader.Read(bits) << (8 - bits);
+                endpoints[e][c] = value | (value >> bits);
+            }
+        }
+
+        // First set of indices is 2-bit, second set is 3-bit for mode 4 and 2-bit for mode 5
+        unsigned char indices[2][16];
+        const unsigned indexBits[2] = {2, mode == 4 ? 3u : 2u};
+        for (unsigned set = 0; set < 2; ++set)
+        {
+            for (unsigned i = 0; i < 16; ++i)
+                indices[set][i] = static_cast<unsigned char>(reader.Read(i == 0 ? indexBits[set] - 1 : indexBits[set]));
+        }
+
+        const unsigned colorSet = indexSelection;
+        const unsigned alphaSet = 1 - indexSelection;
+        const int* colorWeights = indexBits[colorSet] == 2 ? WEIGHTS_2 : WEIGHTS_3;
+        const int* alphaWeights = indexBits[alphaSet] == 2 ? WEIGHTS_2 : WEIGHTS_3;
+        for (unsigned i = 0; i < 16; ++i)
+        {
+            unsigned char* pixel = rgba + i * 4;
+            const int colorWeight = colorWeights[indices[colorSet][i]];
+            const int alphaWeight = alphaWeights[indices[alphaSet][i]];
+            for (unsigned c = 0; c < 3; ++c)
+                pixel[c] = static_cast<unsigned char>(Interpolate(endpoints[0][c], endpoints[1][c], colorWeight));
+            pixel[3] = static_cast<unsigned char>(Interpolate(endpoints[0][3], endpoints[1][3], alphaWeight));
+
+            if (rotation != 0)
+                ea::swap(pixel[3], pixel[rotation - 1]);
+        }
+    }
+    else
+        FillMagenta(rgba);
+}
+
+void DecompressBlockBC6H(float* rgb, const unsigned char* block)
+{
+    BlockBitReader reader(block);
+    const unsigned mode = reader.Read(5);
+    if (mode != BC6H_MODE_11)
+    {
+        for (unsigned i = 0; i < 16; ++i)
+        {
+            rgb[i * 3] = 1.0f;
+            rgb[i * 3 + 1] = 0.0f;
+            rgb[i * 3 + 2] = 1.0f;
+        }
+        return;
+    }
+
+    int endpoints[2][3];
+    for (unsigned e = 0; e < 2; ++e)
+    {
+        for (unsigned c = 0; c < 3; ++c)
+            endpoints[e][c] = UnquantizeBC6H(reader.Read(10));
+    }
+
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        const int weight = WEIGHTS_4[reader.Read(i == 0 ? 3 : 4)];
+        for (unsigned c = 0; c < 3; ++c)
+        {
+            const int half = FinishUnquantizeBC6H(Interpolate(endpoints[0][c], endpoints[1][c], weight));
+            rgb[i * 3 + c] = HalfToFloat(static_cast<unsigned short>(half));
+        }
+    }
+}
+
+void DecompressBlockASTC(unsigned char* rgba, const unsigned char* block)
+{
+    BlockBitReader reader(block);
+    const unsigned blockMode = reader.Read(11);
+
+    if ((blockMode & 0x1ff) == ASTC_VOID_EXTENT)
+    {
+        // HDR void-extent blocks are not supported
+        if (blockMode & 0x200)
+        {
+            FillMagenta(rgba);
+            return;
+        }
+
+        reader.Read(1);
+        reader.Read(52);
+        unsigned char color[4];
+        for (unsigned c = 0; c < 4; ++c)
+            color[c] = static_cast<unsigned char>(reader.Read(16) >> 8);
+        for (unsigned i = 0; i < 16; ++i)
+            memcpy(rgba + i * 4, color, 4);
+        return;
+    }
+
+    const unsigned numPartitions = reader.Read(2) + 1;
+    const unsigned endpointMode = reader.Read(4);
+    const bool isRGB = blockMode == ASTC_BLOCK_MODE_WEIGHTS_3 && endpointMode == ASTC_CEM_RGB;
+    const bool isRGBA = blockMode == ASTC_BLOCK_MODE_WEIGHTS_2 && endpointMode == ASTC_CEM_RGBA;
+    if (numPartitions != 1 || (!isRGB && !isRGBA))
+    {
+        FillMagenta(rgba);
+        return;
+    }
+
+    const unsigned numChannels = isRGB ? 3 : 4;
+    int endpoints[2][4] = {{0, 0, 0, 255}, {0, 0, 0, 255}};
+    for (unsigned c = 0; c < numChannels; ++c)
+    {
+        endpoints[0][c] = reader.Read(8);
+        endpoints[1][c] = reader.Read(8);
+    }
+
+    const int sum0 = endpoints[0][0] + endpoints[0][1] + endpoints[0][2];
+    const int sum1 = endpoints[1][0] + endpoints[1][1] + endpoints[1][2];
+    if (sum1 < sum0)
+    {
+        // Blue contraction
+        const int contracted[2][4] = {
+            {(endpoints[1][0] + endpoints[1][2]) >> 1, (endpoints[1][1] + endpoints[1][2]) >> 1, endpoints[1][2], endpoints[1][3]},
+            {(endpoints[0][0] + endpoints[0][2]) >> 1, (endpoints[0][1] + endpoints[0][2]) >> 1, endpoints[0][2], endpoints[0][3]}};
+        memcpy(endpoints, contracted, sizeof(endpoints));
+    }
+
+    const unsigned weightBits = isRGB ? 3 : 2;
+    const int* weights = isRGB ? WEIGHTS_3 : WEIGHTS_2;
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        const int weight = weights[reader.ReadReversed(weightBits)];
+        for (unsigned c = 0; c < 4; ++c)
+            rgba[i * 4 + c] = static_cast<unsigned char>(Interpolate(endpoints[0][c] * 257, endpoints[1][c] * 257, weight) >> 8);
+    }
+}
+
+bool CompressImageBlocks(unsigned char* dest, const unsigned char* rgba, int width, int height, CompressedFormat format,
+    BlockCompressionQuality quality, WorkQueue* workQueue)
+{
+    if (format != CF_BC7 && format != CF_ASTC_4x4)
+        return false;
+
+    const int blocksWide = (width + 3) / 4;
+    const int blocksHigh = (height + 3) / 4;
+    ForEachImageRows(workQueue, BLOCK_ROWS_PER_TASK, blocksHigh, [&](unsigned beginY, unsigned endY)
+    {
+        unsigned char pixels[16 * 4];
+        for (unsigned y = beginY; y < endY; ++y)
+        {
+            for (int x = 0; x < blocksWide; ++x)
+            {
+                unsigned char* block = dest + (y * blocksWide + x) * BLOCK_COMPRESSION_BLOCK_SIZE;
+                GatherBlock(pixels, rgba, width, height, 4, x, y);
+                if (format == CF_BC7)
+                    CompressBlockBC7(block, pixels, quality);
+                else
+                    CompressBlockASTC(block, pixels, quality);
+            }
+        }
+    });
+    return true;
+}
+
+void CompressImageBC6H(unsigned char* dest, const float* rgb, int width, int height, BlockCompressionQuality quality,
+    WorkQueue* workQueue)
+{
+    const int blocksWide = (width + 3) / 4;
+    const int blocksHigh = (height + 3) / 4;
+    ForEachImageRows(workQueue, BLOCK_ROWS_PER_TASK, blocksHigh, [&](unsigned beginY, unsigned endY)
+    {
+        float pixels[16 * 3];
+        for (unsigned y = beginY; y < endY; ++y)
+        {
+            for (int x = 0; x < blocksWide; ++x)
+            {
+                GatherBlock(pixels, rgb, width, height, 3, x, y);
+                CompressBlockBC6H(dest + (y * blocksWide + x) * BLOCK_COMPRESSION_BLOCK_SIZE, pixels, quality);
+            }
+        }
+    });
+}
+
+}
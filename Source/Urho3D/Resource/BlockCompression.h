@@ -0,0 +1,70 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "../Resource/Image.h"
+
+namespace Urho3D
+{
+
+class WorkQueue;
+
+/// Quality of block compression. Higher quality spends more time refining block endpoints.
+enum class BlockCompressionQuality
+{
+    Fast,
+    Normal,
+    High
+};
+
+/// Size of compressed 4x4 block of BC6H, BC7 and ASTC 4x4 formats in bytes.
+static const unsigned BLOCK_COMPRESSION_BLOCK_SIZE = 16;
+
+/// Compress 4x4 block of RGBA pixels to BC7. Single subset mode 6 is used for all blocks.
+URHO3D_API void CompressBlockBC7(unsigned char* dest, const unsigned char* rgba, BlockCompressionQuality quality);
+/// Compress 4x4 block of RGB float pixels to unsigned BC6H. Single region mode 11 is used for all blocks. Negative values are clamped to zero.
+URHO3D_API void CompressBlockBC6H(unsigned char* dest, const float* rgb, BlockCompressionQuality quality);
+/// Compress 4x4 block of RGBA pixels to LDR ASTC 4x4. Solid blocks are stored as void-extent blocks,
+/// other blocks use single partition with direct RGB or RGBA endpoints.
+URHO3D_API void CompressBlockASTC(unsigned char* dest, const unsigned char* rgba, BlockCompressionQuality quality);
+
+/// Decompress BC7 block to RGBA. Single subset modes 4, 5 and 6 are supported, other blocks are decompressed to magenta.
+URHO3D_API void DecompressBlockBC7(unsigned char* rgba, const unsigned char* block);
+/// Decompress unsigned BC6H block to RGB float. Mode 11 is supported, other blocks are decompressed to magenta.
+URHO3D_API void DecompressBlockBC6H(float* rgb, const unsigned char* block);
+/// Decompress LDR ASTC 4x4 block to RGBA. Blocks produced by CompressBlockASTC are supported, other blocks are decompressed to magenta.
+URHO3D_API void DecompressBlockASTC(unsigned char* rgba, const unsigned char* block);
+
+/// Compress RGBA image to BC7 or ASTC 4x4. Edge blocks are padded by repeating edge pixels.
+/// Block rows are compressed by WorkQueue threads if work queue is not null, in this case should be called from the main thread.
+URHO3D_API bool CompressImageBlocks(unsigned char* dest, const unsigned char* rgba, int width, int height, CompressedFormat format,
+    BlockCompressionQuality quality, WorkQueue* workQueue = nullptr);
+/// Compress RGB float image to unsigned BC6H. Edge blocks are padded by repeating edge pixels.
+/// Block rows are compressed by WorkQueue threads if work queue is not null, in this case should be called from the main thread.
+URHO3D_API void CompressImageBC6H(unsigned char* dest, const float* rgb, int width, int height, BlockCompressionQuality quality,
+    WorkQueue* workQueue = nullptr);
+
+}
@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Resource/BlockCompression.h"
 #include "../Resource/Decompress.h"
 
 #include <cstdint>
@@ -118,26 +119,10 @@ static void DecompressColourDXT(unsigned char* rgba, void const* block, bool isD
     codes[8 + 3] = 255;
     codes[12 + 3] = (unsigned char)((isDxt1 && a <= b) ? 0 : 255);
 
-    // unpack the indices
-    unsigned char indices[16];
-    for (int i = 0; i < 4; ++i)
-    {
-        unsigned char* ind = indices + 4 * i;
-        unsigned char packed = bytes[4 + i];
-
-        ind[0] = (unsigned char)(packed & 0x3);
-        ind[1] = (unsigned char)((packed >> 2) & 0x3);
-        ind[2] = (unsigned char)((packed >> 4) & 0x3);
-        ind[3] = (unsigned char)((packed >> 6) & 0x3);
-    }
-
-    // store out the colours
+    // store out the colours, whole texels at once
+    const unsigned packed = bytes[4] | (bytes[5] << 8u) | (bytes[6] << 16u) | ((unsigned)bytes[7] << 24u);
     for (int i = 0; i < 16; ++i)
-    {
-        auto offset = (unsigned char)(4 * indices[i]);
-        for (int j = 0; j < 4; ++j)
-            rgba[4 * i + j] = codes[offset + j];
-    }
+        memcpy(rgba + 4 * i, codes + 4 * ((packed >> (2 * i)) & 0x3), 4);
 }
 
 static void DecompressAlphaDXT3(unsigned char* rgba, void const* block)
@@ -186,31 +171,14 @@ static void DecompressAlphaDXT5(unsigned char* rgba, void const* block)
             codes[1 + i] = (unsigned char)(((7 - i) * alpha0 + i * alpha1) / 7);
     }
 
-    // decode the indices
-    unsigned char indices[16];
-    unsigned char const* src = bytes + 2;
-    unsigned char* dest = indices;
-    for (int i = 0; i < 2; ++i)
-    {
-        // grab 3 bytes
-        int value = 0;
-        for (int j = 0; j < 3; ++j)
-        {
-            int byte = *src++;
-            value |= (byte << 8 * j);
-        }
-
-        // unpack 8 3-bit values from it
-        for (int j = 0; j < 8; ++j)
-        {
-            int index = (value >> 3 * j) & 0x7;
-            *dest++ = (unsigned char)index;
-        }
-    }
+    // grab 48 bits of 3-bit indices
+    unsigned long long indices = 0;
+    for (int i = 0; i < 6; ++i)
+        indices |= (unsigned long long)bytes[2 + i] << (8 * i);
 
     // write out the indexed codebook values
     for (int i = 0; i < 16; ++i)
-        rgba[4 * i + 3] = codes[indices[i]];
+        rgba[4 * i + 3] = codes[(indices >> (3 * i)) & 0x7];
 }
 
 static void DecompressDXT(unsigned char* rgba, const void* block, CompressedFormat format)
@@ -249,30 +217,11 @@ void DecompressImageDXT(unsigned char* rgba, const void* blocks, int width, int
                 unsigned char targetRgba[4 * 16];
                 DecompressDXT(targetRgba, sourceBlock, format);
 
-                // write the decompressed pixels to the correct image locations
-                unsigned char const* sourcePixel = targetRgba;
-                for (int py = 0; py < 4; ++py)
-                {
-                    for (int px = 0; px < 4; ++px)
-                    {
-                        // get the target location
-                        int sx = x + px;
-                        int sy = y + py;
-                        if (sx < width && sy < height)
-                        {
-                            unsigned char* targetPixel = rgba + sz + 4 * (width * sy + sx);
-
-                            // copy the rgba value
-                            for (int i = 0; i < 4; ++i)
-                                *targetPixel++ = *sourcePixel++;
-                        }
-                        else
-                        {
-                            // skip this pixel as its outside the image
-                            sourcePixel += 4;
-                        }
-                    }
-                }
+                // write the decompressed rows to the correct image locations, skipping pixels outside the image
+                const int numRows = Min(height - y, 4);
+                const int rowSize = 4 * Min(width - x, 4);
+                for (int py = 0; py < numRows; ++py)
+                    memcpy(rgba + sz + 4 * (width * (y + py) + x), targetRgba + 16 * py, rowSize);
 
                 // advance
                 sourceBlock += bytesPerBlock;
@@ -943,20 +892,57 @@ void DecompressImageETC(unsigned char* dstImage, const void* blocks, int width,
 
             int wbuf = Min(width - x * 4, 4);
             int hbuf = Min(height - y * 4, 4);
-            for(int dy = 0; dy < hbuf; ++dy)
-            {
-                for (int dx = 0; dx < wbuf; ++dx)
-                {
-                    int idst = ((y * 4 + dy) * width + x * 4 + dx) * 4;
-                    int ibuf = (dy * 4 + dx) * 4;
-                    dstImage[idst] = buffer4x4[ibuf];
-                    dstImage[idst + 1] = buffer4x4[ibuf + 1];
-                    dstImage[idst + 2] = buffer4x4[ibuf + 2];
-                    dstImage[idst + 3] = buffer4x4[ibuf + 3];
-                }
-            }
+            for (int dy = 0; dy < hbuf; ++dy)
+                memcpy(&dstImage[((y * 4 + dy) * width + x * 4) * 4], &buffer4x4[dy * 4 * 4], wbuf * 4);
         }
     }
 }
 
+/// Decompress image of 16-byte blocks, skipping pixels outside the image.
+template <class T>
+static void DecompressImageBlocks(unsigned char* rgba, const void* blocks, int width, int height, const T& decompressBlock)
+{
+    const auto* sourceBlock = reinterpret_cast<const unsigned char*>(blocks);
+    for (int y = 0; y < height; y += 4)
+    {
+        for (int x = 0; x < width; x += 4)
+        {
+            unsigned char targetRgba[4 * 16];
+            decompressBlock(targetRgba, sourceBlock);
+
+            const int numRows = Min(height - y, 4);
+            const int rowSize = 4 * Min(width - x, 4);
+            for (int py = 0; py < numRows; ++py)
+                memcpy(rgba + 4 * (width * (y + py) + x), targetRgba + 16 * py, rowSize);
+
+            sourceBlock += BLOCK_COMPRESSION_BLOCK_SIZE;
+        }
+    }
+}
+
+void DecompressImageBC7(unsigned char* rgba, const void* blocks, int width, int height)
+{
+    DecompressImageBlocks(rgba, blocks, width, height, DecompressBlockBC7);
+}
+
+void DecompressImageBC6H(unsigned char* rgba, const void* blocks, int width, int height)
+{
+    DecompressImageBlocks(rgba, blocks, width, height, [](unsigned char* targetRgba, const unsigned char* block)
+    {
+        float rgb[3 * 16];
+        DecompressBlockBC6H(rgb, block);
+        for (unsigned i = 0; i < 16; ++i)
+        {
+            for (unsigned c = 0; c < 3; ++c)
+                targetRgba[i * 4 + c] = static_cast<unsigned char>(RoundToInt(Clamp(rgb[i * 3 + c], 0.0f, 1.0f) * 255.0f));
+            targetRgba[i * 4 + 3] = 255;
+        }
+    });
+}
+
+void DecompressImageASTC(unsigned char* rgba, const void* blocks, int width, int height)
+{
+    DecompressImageBlocks(rgba, blocks, width, height, DecompressBlockASTC);
+}
+
 }
@@ -34,6 +34,12 @@ URHO3D_API void
 URHO3D_API void DecompressImageETC(unsigned char* dstImage, const void* blocks, int width, int height, bool hasAlpha);
 /// Decompress a PVRTC compressed image to RGBA.
 URHO3D_API void DecompressImagePVRTC(unsigned char* rgba, const void* blocks, int width, int height, CompressedFormat format);
+/// Decompress a BC7 compressed image to RGBA.
+URHO3D_API void DecompressImageBC7(unsigned char* rgba, const void* blocks, int width, int height);
+/// Decompress an unsigned BC6H compressed image to RGBA. Values are clamped to [0, 1] range.
+URHO3D_API void DecompressImageBC6H(unsigned char* rgba, const void* blocks, int width, int height);
+/// Decompress an ASTC 4x4 compressed image to RGBA.
+URHO3D_API void DecompressImageASTC(unsigned char* rgba, const void* blocks, int width, int height);
 /// Flip a compressed block vertically.
 URHO3D_API void FlipBlockVertical(unsigned char* dest, const unsigned char* src, CompressedFormat format);
 /// Flip a compressed block horizontally.
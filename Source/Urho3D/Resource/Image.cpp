@@ -24,10 +24,13 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../Core/WorkQueue.h"
 #include "../IO/File.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
 #include "../Resource/Decompress.h"
+#include "../Resource/ImageProcessing.h"
 
 #include <SDL/SDL_surface.h>
 #include <STB/stb_image.h>
@@ -84,6 +87,9 @@ static const unsigned DDS_DXGI_FORMAT_BC2_UNORM = 74;
 static const unsigned DDS_DXGI_FORMAT_BC2_UNORM_SRGB = 75;
 static const unsigned DDS_DXGI_FORMAT_BC3_UNORM = 77;
 static const unsigned DDS_DXGI_FORMAT_BC3_UNORM_SRGB = 78;
+static const unsigned DDS_DXGI_FORMAT_BC6H_UF16 = 95;
+static const unsigned DDS_DXGI_FORMAT_BC7_UNORM = 98;
+static const unsigned DDS_DXGI_FORMAT_BC7_UNORM_SRGB = 99;
 
 namespace Urho3D
 {
@@ -214,26 +220,78 @@ struct DDSurfaceDesc2
     unsigned dwTextureStage_;
 };
 
+/// Number of block rows decompressed by one task.
+static const unsigned BLOCK_ROWS_PER_TASK = 16;
+
+/// Return work queue for parallel image processing. Images are processed by single thread outside of the main thread.
+static WorkQueue* GetImageWorkQueue(Context* context)
+{
+    return Thread::IsMainThread() ? context->GetSubsystem<WorkQueue>() : nullptr;
+}
+
+/// Return whether the format is PVRTC. PVRTC levels are not laid out in 4x4 blocks.
+static bool IsPVRTCFormat(CompressedFormat format)
+{
+    switch (format)
+    {
+    case CF_PVRTC_RGB_2BPP:
+    case CF_PVRTC_RGBA_2BPP:
+    case CF_PVRTC_RGB_4BPP:
+    case CF_PVRTC_RGBA_4BPP:
+        return true;
+    default:
+        return false;
+    }
+}
+
 bool CompressedLevel::Decompress(unsigned char* dest) const
+{
+    return Decompress(dest, nullptr);
+}
+
+bool CompressedLevel::Decompress(unsigned char* dest, WorkQueue* workQueue) const
 {
     if (!data_)
         return false;
 
+    // Block rows of 2D images are decompressed independently
+    const unsigned numBlockRows = depth_ > 1 ? 1 : (height_ + 3) / 4;
+    const unsigned blockRowSize = (width_ + 3) / 4 * blockSize_;
+    const auto forEachBlockRows = [&](const auto& decompressRows)
+    {
+        if (depth_ > 1)
+        {
+            decompressRows(dest, data_, height_);
+            return;
+        }
+
+        ForEachImageRows(workQueue, BLOCK_ROWS_PER_TASK, numBlockRows, [&](unsigned beginRow, unsigned endRow)
+        {
+            const int beginY = beginRow * 4;
+            const int height = Min(static_cast<int>(endRow * 4), height_) - beginY;
+            decompressRows(dest + beginY * width_ * 4, data_ + beginRow * blockRowSize, height);
+        });
+    };
+
     switch (format_)
     {
     case CF_DXT1:
     case CF_DXT3:
     case CF_DXT5:
-        DecompressImageDXT(dest, data_, width_, height_, depth_, format_);
+        forEachBlockRows([&](unsigned char* rowDest, const unsigned char* blocks, int height)
+        {
+            DecompressImageDXT(rowDest, blocks, width_, height, depth_, format_);
+        });
         return true;
 
     // ETC2 format is compatible with ETC1, so we just use the same function.
     case CF_ETC1:
     case CF_ETC2_RGB:
-        DecompressImageETC(dest, data_, width_, height_, false);
-        return true;
     case CF_ETC2_RGBA:
-        DecompressImageETC(dest, data_, width_, height_, true);
+        forEachBlockRows([&](unsigned char* rowDest, const unsigned char* blocks, int height)
+        {
+            DecompressImageETC(rowDest, blocks, width_, height, format_ == CF_ETC2_RGBA);
+        });
         return true;
 
     case CF_PVRTC_RGB_2BPP:
@@ -243,6 +301,27 @@ bool CompressedLevel::Decompress(unsigned char* dest) const
         DecompressImagePVRTC(dest, data_, width_, height_, format_);
         return true;
 
+    case CF_BC7:
+        forEachBlockRows([&](unsigned char* rowDest, const unsigned char* blocks, int height)
+        {
+            DecompressImageBC7(rowDest, blocks, width_, height);
+        });
+        return true;
+
+    case CF_BC6H_UF16:
+        forEachBlockRows([&](unsigned char* rowDest, const unsigned char* blocks, int height)
+        {
+            DecompressImageBC6H(rowDest, blocks, width_, height);
+        });
+        return true;
+
+    case CF_ASTC_4x4:
+        forEachBlockRows([&](unsigned char* rowDest, const unsigned char* blocks, int height)
+        {
+            DecompressImageASTC(rowDest, blocks, width_, height);
+        });
+        return true;
+
     default:
         // Unknown format
         return false;
@@ -301,6 +380,15 @@ bool Image::BeginLoad(Deserializer& source)
             case DDS_DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
                 fourCC = 0;
                 break;
+            case DDS_DXGI_FORMAT_BC7_UNORM:
+            case DDS_DXGI_FORMAT_BC7_UNORM_SRGB:
+                compressedFormat_ = CF_BC7;
+                components_ = 4;
+                break;
+            case DDS_DXGI_FORMAT_BC6H_UF16:
+                compressedFormat_ = CF_BC6H_UF16;
+                components_ = 3;
+                break;
             default:
                 URHO3D_LOGERROR("Unrecognized DDS DXGI image format");
                 return false;
@@ -310,6 +398,7 @@ bool Image::BeginLoad(Deserializer& source)
             if (dxgiHeader.dxgiFormat == DDS_DXGI_FORMAT_BC1_UNORM_SRGB ||
                 dxgiHeader.dxgiFormat == DDS_DXGI_FORMAT_BC2_UNORM_SRGB ||
                 dxgiHeader.dxgiFormat == DDS_DXGI_FORMAT_BC3_UNORM_SRGB ||
+                dxgiHeader.dxgiFormat == DDS_DXGI_FORMAT_BC7_UNORM_SRGB ||
                 dxgiHeader.dxgiFormat == DDS_DXGI_FORMAT_R8G8B8A8_UNORM_SRGB)
             {
                 sRGB_ = true;
@@ -347,6 +436,10 @@ bool Image::BeginLoad(Deserializer& source)
             components_ = 4;
             break;
 
+        case FOURCC_DX10:
+            // Format without FourCC code is already selected from DXGI header
+            break;
+
         case 0:
             if (ddsd.ddpfPixelFormat_.dwRGBBitCount_ != 32 && ddsd.ddpfPixelFormat_.dwRGBBitCount_ != 24 &&
                 ddsd.ddpfPixelFormat_.dwRGBBitCount_ != 16)
@@ -630,6 +723,25 @@ bool Image::BeginLoad(Deserializer& source)
             components_ = 4;
             break;
 
+        case 0x8e8c:
+        case 0x8e8d:
+            compressedFormat_ = CF_BC7;
+            components_ = 4;
+            sRGB_ = internalFormat == 0x8e8d;
+            break;
+
+        case 0x8e8f:
+            compressedFormat_ = CF_BC6H_UF16;
+            components_ = 3;
+            break;
+
+        case 0x93b0:
+        case 0x93d0:
+            compressedFormat_ = CF_ASTC_4x4;
+            components_ = 4;
+            sRGB_ = internalFormat == 0x93d0;
+            break;
+
         default:
             compressedFormat_ = CF_NONE;
             break;
@@ -1055,17 +1167,7 @@ bool Image::FlipHorizontal()
     if (!IsCompressed())
     {
         ea::shared_array<unsigned char> newData(new unsigned char[width_ * height_ * components_]);
-        unsigned rowSize = width_ * components_;
-
-        for (int y = 0; y < height_; ++y)
-        {
-            for (int x = 0; x < width_; ++x)
-            {
-                for (unsigned c = 0; c < components_; ++c)
-                    newData[y * rowSize + x * components_ + c] = data_[y * rowSize + (width_ - x - 1) * components_ + c];
-            }
-        }
-
+        FlipImageHorizontal(newData.get(), data_.get(), width_, height_, components_, GetImageWorkQueue(context_));
         data_ = newData;
     }
     else
@@ -1122,11 +1224,7 @@ bool Image::FlipVertical()
     if (!IsCompressed())
     {
         ea::shared_array<unsigned char> newData(new unsigned char[width_ * height_ * components_]);
-        unsigned rowSize = width_ * components_;
-
-        for (int y = 0; y < height_; ++y)
-            memcpy(&newData[(height_ - y - 1) * rowSize], &data_[y * rowSize], rowSize);
-
+        FlipImageVertical(newData.get(), data_.get(), width_, height_, components_, GetImageWorkQueue(context_));
         data_ = newData;
     }
     else
@@ -1187,36 +1285,8 @@ bool Image::Resize(int width, int height)
     if (!data_ || width <= 0 || height <= 0)
         return false;
 
-    /// \todo Reducing image size does not sample all needed pixels
     ea::shared_array<unsigned char> newData(new unsigned char[width * height * components_]);
-    for (int y = 0; y < height; ++y)
-    {
-        for (int x = 0; x < width; ++x)
-        {
-            // Calculate float coordinates between 0 - 1 for resampling
-            float xF = (width_ > 1) ? (float)x / (float)(width - 1) : 0.0f;
-            float yF = (height_ > 1) ? (float)y / (float)(height - 1) : 0.0f;
-            unsigned uintColor = GetPixelBilinear(xF, yF).ToUInt();
-            unsigned char* dest = newData.get() + (y * width + x) * components_;
-            auto* src = (unsigned char*)&uintColor;
-
-            switch (components_)
-            {
-            case 4:
-                dest[3] = src[3];
-                // Fall through
-            case 3:
-                dest[2] = src[2];
-                // Fall through
-            case 2:
-                dest[1] = src[1];
-                // Fall through
-            default:
-                dest[0] = src[0];
-                break;
-            }
-        }
-    }
+    ResampleImage(newData.get(), width, height, data_.get(), width_, height_, components_, GetImageWorkQueue(context_));
 
     width_ = width;
     height_ = height;
@@ -1602,6 +1672,19 @@ Color Image::GetPixelTrilinear(float x, float y, float z) const
 }
 
 SharedPtr<Image> Image::GetNextLevel() const
+{
+    if (nextLevel_)
+        return nextLevel_;
+
+    return CalculateNextLevel(ImageMipFilter::Box, false);
+}
+
+SharedPtr<Image> Image::GetNextLevel(ImageMipFilter filter, bool sRGB) const
+{
+    return CalculateNextLevel(filter, sRGB);
+}
+
+SharedPtr<Image> Image::CalculateNextLevel(ImageMipFilter filter, bool sRGB) const
 {
     if (IsCompressed())
     {
@@ -1614,9 +1697,6 @@ SharedPtr<Image> Image::GetNextLevel() const
         return SharedPtr<Image>();
     }
 
-    if (nextLevel_)
-        return nextLevel_;
-
     URHO3D_PROFILE("CalculateImageMipLevel");
 
     int widthOut = width_ / 2;
@@ -1640,134 +1720,9 @@ SharedPtr<Image> Image::GetNextLevel() const
     const unsigned char* pixelDataIn = data_.get();
     unsigned char* pixelDataOut = mipImage->data_.get();
 
-    // 1D case
-    if (depth_ == 1 && (height_ == 1 || width_ == 1))
-    {
-        // Loop using the larger dimension
-        if (widthOut < heightOut)
-            widthOut = heightOut;
-
-        switch (components_)
-        {
-        case 1:
-            for (int x = 0; x < widthOut; ++x)
-                pixelDataOut[x] = (unsigned char)(((unsigned)pixelDataIn[x * 2] + pixelDataIn[x * 2 + 1]) >> 1);
-            break;
-
-        case 2:
-            for (int x = 0; x < widthOut * 2; x += 2)
-            {
-                pixelDataOut[x] = (unsigned char)(((unsigned)pixelDataIn[x * 2] + pixelDataIn[x * 2 + 2]) >> 1);
-                pixelDataOut[x + 1] = (unsigned char)(((unsigned)pixelDataIn[x * 2 + 1] + pixelDataIn[x * 2 + 3]) >> 1);
-            }
-            break;
-
-        case 3:
-            for (int x = 0; x < widthOut * 3; x += 3)
-            {
-                pixelDataOut[x] = (unsigned char)(((unsigned)pixelDataIn[x * 2] + pixelDataIn[x * 2 + 3]) >> 1);
-                pixelDataOut[x + 1] = (unsigned char)(((unsigned)pixelDataIn[x * 2 + 1] + pixelDataIn[x * 2 + 4]) >> 1);
-                pixelDataOut[x + 2] = (unsigned char)(((unsigned)pixelDataIn[x * 2 + 2] + pixelDataIn[x * 2 + 5]) >> 1);
-            }
-            break;
-
-        case 4:
-            for (int x = 0; x < widthOut * 4; x += 4)
-            {
-                pixelDataOut[x] = (unsigned char)(((unsigned)pixelDataIn[x * 2] + pixelDataIn[x * 2 + 4]) >> 1);
-                pixelDataOut[x + 1] = (unsigned char)(((unsigned)pixelDataIn[x * 2 + 1] + pixelDataIn[x * 2 + 5]) >> 1);
-                pixelDataOut[x + 2] = (unsigned char)(((unsigned)pixelDataIn[x * 2 + 2] + pixelDataIn[x * 2 + 6]) >> 1);
-                pixelDataOut[x + 3] = (unsigned char)(((unsigned)pixelDataIn[x * 2 + 3] + pixelDataIn[x * 2 + 7]) >> 1);
-            }
-            break;
-
-        default:
-            assert(false);  // Should never reach here
-            break;
-        }
-    }
-    // 2D case
-    else if (depth_ == 1)
-    {
-        switch (components_)
-        {
-        case 1:
-            for (int y = 0; y < heightOut; ++y)
-            {
-                const unsigned char* inUpper = &pixelDataIn[(y * 2) * width_];
-                const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * width_];
-                unsigned char* out = &pixelDataOut[y * widthOut];
-
-                for (int x = 0; x < widthOut; ++x)
-                {
-                    out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 1] +
-                                              inLower[x * 2] + inLower[x * 2 + 1]) >> 2);
-                }
-            }
-            break;
-
-        case 2:
-            for (int y = 0; y < heightOut; ++y)
-            {
-                const unsigned char* inUpper = &pixelDataIn[(y * 2) * width_ * 2];
-                const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * width_ * 2];
-                unsigned char* out = &pixelDataOut[y * widthOut * 2];
-
-                for (int x = 0; x < widthOut * 2; x += 2)
-                {
-                    out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 2] +
-                                              inLower[x * 2] + inLower[x * 2 + 2]) >> 2);
-                    out[x + 1] = (unsigned char)(((unsigned)inUpper[x * 2 + 1] + inUpper[x * 2 + 3] +
-                                                  inLower[x * 2 + 1] + inLower[x * 2 + 3]) >> 2);
-                }
-            }
-            break;
-
-        case 3:
-            for (int y = 0; y < heightOut; ++y)
-            {
-                const unsigned char* inUpper = &pixelDataIn[(y * 2) * width_ * 3];
-                const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * width_ * 3];
-                unsigned char* out = &pixelDataOut[y * widthOut * 3];
-
-                for (int x = 0; x < widthOut * 3; x += 3)
-                {
-                    out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 3] +
-                                              inLower[x * 2] + inLower[x * 2 + 3]) >> 2);
-                    out[x + 1] = (unsigned char)(((unsigned)inUpper[x * 2 + 1] + inUpper[x * 2 + 4] +
-                                                  inLower[x * 2 + 1] + inLower[x * 2 + 4]) >> 2);
-                    out[x + 2] = (unsigned char)(((unsigned)inUpper[x * 2 + 2] + inUpper[x * 2 + 5] +
-                                                  inLower[x * 2 + 2] + inLower[x * 2 + 5]) >> 2);
-                }
-            }
-            break;
-
-        case 4:
-            for (int y = 0; y < heightOut; ++y)
-            {
-                const unsigned char* inUpper = &pixelDataIn[(y * 2) * width_ * 4];
-                const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * width_ * 4];
-                unsigned char* out = &pixelDataOut[y * widthOut * 4];
-
-                for (int x = 0; x < widthOut * 4; x += 4)
-                {
-                    out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 4] +
-                                              inLower[x * 2] + inLower[x * 2 + 4]) >> 2);
-                    out[x + 1] = (unsigned char)(((unsigned)inUpper[x * 2 + 1] + inUpper[x * 2 + 5] +
-                                                  inLower[x * 2 + 1] + inLower[x * 2 + 5]) >> 2);
-                    out[x + 2] = (unsigned char)(((unsigned)inUpper[x * 2 + 2] + inUpper[x * 2 + 6] +
-                                                  inLower[x * 2 + 2] + inLower[x * 2 + 6]) >> 2);
-                    out[x + 3] = (unsigned char)(((unsigned)inUpper[x * 2 + 3] + inUpper[x * 2 + 7] +
-                                                  inLower[x * 2 + 3] + inLower[x * 2 + 7]) >> 2);
-                }
-            }
-            break;
-
-        default:
-            assert(false);  // Should never reach here
-            break;
-        }
-    }
+    // 1D and 2D case
+    if (depth_ == 1)
+        DownsampleImage(pixelDataOut, pixelDataIn, width_, height_, components_, filter, sRGB, GetImageWorkQueue(context_));
     // 3D case
     else
     {
@@ -2034,7 +1989,7 @@ CompressedLevel Image::GetCompressedLevel(unsigned index) const
             ++i;
         }
     }
-    else if (compressedFormat_ < CF_PVRTC_RGB_2BPP)
+    else if (!IsPVRTCFormat(compressedFormat_))
     {
         level.blockSize_ = (compressedFormat_ == CF_DXT1 || compressedFormat_ == CF_ETC1 || compressedFormat_ == CF_ETC2_RGB) ? 8 : 16;
         unsigned i = 0;
@@ -2126,7 +2081,7 @@ SharedPtr<Image> Image::GetDecompressedImageLevel(unsigned index) const
 
         auto decompressedImage = MakeShared<Image>(context_);
         decompressedImage->SetSize(compressedLevel.width_, compressedLevel.height_, 4);
-        compressedLevel.Decompress(decompressedImage->GetData());
+        compressedLevel.Decompress(decompressedImage->GetData(), GetImageWorkQueue(context_));
 
         return decompressedImage;
     }
@@ -2312,6 +2267,11 @@ SDL_Surface* Image::GetSDLSurface(const IntRect& rect) const
 }
 
 void Image::PrecalculateLevels()
+{
+    PrecalculateLevels(ImageMipFilter::Box, false);
+}
+
+void Image::PrecalculateLevels(ImageMipFilter filter, bool sRGB)
 {
     if (!data_ || IsCompressed())
         return;
@@ -2322,11 +2282,11 @@ void Image::PrecalculateLevels()
 
     if (width_ > 1 || height_ > 1)
     {
-        SharedPtr<Image> current = GetNextLevel();
+        SharedPtr<Image> current = CalculateNextLevel(filter, sRGB);
         nextLevel_ = current;
         while (current && (current->width_ > 1 || current->height_ > 1))
         {
-            current->nextLevel_ = current->GetNextLevel();
+            current->nextLevel_ = current->CalculateNextLevel(filter, sRGB);
             current = current->nextLevel_;
         }
     }
@@ -33,6 +33,8 @@ struct SDL_Surface;
 namespace Urho3D
 {
 
+class WorkQueue;
+
 static const int COLOR_LUT_SIZE = 16;
 
 /// Supported compressed image formats.
@@ -50,6 +52,18 @@ enum CompressedFormat
     CF_PVRTC_RGBA_2BPP,
     CF_PVRTC_RGB_4BPP,
     CF_PVRTC_RGBA_4BPP,
+    CF_BC7,
+    CF_BC6H_UF16,
+    CF_ASTC_4x4,
+};
+
+/// Filter used to generate image mip levels.
+enum class ImageMipFilter
+{
+    /// Average of 2x2 pixels.
+    Box,
+    /// Kaiser-windowed sinc. Sharper than box filter, but slower.
+    Kaiser
 };
 
 /// Compressed image mip level.
@@ -57,6 +71,8 @@ struct URHO3D_API CompressedLevel
 {
     /// Decompress to RGBA. The destination buffer required is width * height * 4 bytes. Return true if successful.
     bool Decompress(unsigned char* dest) const;
+    /// Decompress to RGBA. Block rows of DXT and ETC formats are decompressed by WorkQueue threads if work queue is not null. Return true if successful.
+    bool Decompress(unsigned char* dest, WorkQueue* workQueue) const;
 
     /// Compressed image data.
     unsigned char* data_{};
@@ -193,6 +209,8 @@ public:
 
     /// Return next mip level by bilinear filtering. Note that if the image is already 1x1x1, will keep returning an image of that size.
     SharedPtr<Image> GetNextLevel() const;
+    /// Return next mip level using specified filter. Color channels are filtered in linear space if sRGB is set. Precalculated levels are not used. 3D images always use box filter.
+    SharedPtr<Image> GetNextLevel(ImageMipFilter filter, bool sRGB) const;
     /// Return the next sibling image of an array or cubemap.
     SharedPtr<Image> GetNextSibling() const { return nextSibling_;  }
     /// Return image converted to 4-component (RGBA) to circumvent modern rendering API's not supporting e.g. the luminance-alpha format.
@@ -209,6 +227,8 @@ public:
     SDL_Surface* GetSDLSurface(const IntRect& rect = IntRect::ZERO) const;
     /// Precalculate the mip levels. Used by asynchronous texture loading.
     void PrecalculateLevels();
+    /// Precalculate the mip levels using specified filter. Color channels are filtered in linear space if sRGB is set.
+    void PrecalculateLevels(ImageMipFilter filter, bool sRGB);
     /// Whether this texture has an alpha channel.
     /// @property
     bool HasAlphaChannel() const;
@@ -226,6 +246,8 @@ private:
     static unsigned char* GetImageData(Deserializer& source, int& width, int& height, unsigned& components);
     /// Free an image file's pixel data.
     static void FreeImageData(unsigned char* pixelData);
+    /// Calculate next mip level.
+    SharedPtr<Image> CalculateNextLevel(ImageMipFilter filter, bool sRGB) const;
 
     /// Width.
     int width_{};
@@ -0,0 +1,547 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Math/MathDefs.h"
+#include "../Resource/ImageProcessing.h"
+
+#include <EASTL/unique_ptr.h>
+#include <EASTL/vector.h>
+
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+namespace
+{
+
+/// Number of destination rows processed by one task of box filter, resampling and flipping.
+const unsigned ROWS_PER_TASK = 64;
+/// Number of destination rows processed by one task of Kaiser filter. Each task filters 10 extra source rows horizontally.
+const unsigned KAISER_ROWS_PER_TASK = 32;
+/// Number of taps of Kaiser filter.
+const int KAISER_TAPS = 12;
+/// Offset of the first tap of Kaiser filter relative to the first source pixel.
+const int KAISER_FIRST_TAP = -5;
+/// Width of Kaiser filter in destination pixels.
+const float KAISER_WIDTH = 3.0f;
+/// Alpha of Kaiser window.
+const float KAISER_ALPHA = 4.0f;
+
+/// Lookup tables for sRGB conversion.
+struct SRGBTables
+{
+    SRGBTables()
+    {
+        for (unsigned i = 0; i < 256; ++i)
+        {
+            const float value = i / 255.0f;
+            const float linear = value <= 0.04045f ? value / 12.92f : powf((value + 0.055f) / 1.055f, 2.4f);
+            toLinear_[i] = linear * 255.0f;
+            toLinear16_[i] = static_cast<unsigned short>(RoundToInt(linear * 65535.0f));
+        }
+
+        for (unsigned i = 0; i < 65536; ++i)
+        {
+            const float linear = i / 65535.0f;
+            const float value = linear <= 0.0031308f ? linear * 12.92f : 1.055f * powf(linear, 1.0f / 2.4f) - 0.055f;
+            fromLinear16_[i] = static_cast<unsigned char>(Clamp(RoundToInt(value * 255.0f), 0, 255));
+        }
+    }
+
+    /// sRGB to linear value in [0, 255] range.
+    float toLinear_[256];
+    /// sRGB to 16-bit linear value.
+    unsigned short toLinear16_[256];
+    /// 16-bit linear value to sRGB.
+    unsigned char fromLinear16_[65536];
+};
+
+const SRGBTables& GetSRGBTables()
+{
+    static const SRGBTables tables;
+    return tables;
+}
+
+/// Return whether the channel is stored in sRGB space. Alpha is always linear.
+bool IsSRGBChannel(unsigned channel, unsigned components, bool sRGB)
+{
+    if (!sRGB)
+        return false;
+    if (components == 2)
+        return channel == 0;
+    return channel < 3;
+}
+
+float BesselI0(float x)
+{
+    float sum = 1.0f;
+    float term = 1.0f;
+    const float halfX = x * 0.5f;
+    for (int i = 1; i < 32; ++i)
+    {
+        term *= halfX / i;
+        sum += term * term;
+        if (term * term < sum * 1e-8f)
+            break;
+    }
+    return sum;
+}
+
+float Sinc(float x)
+{
+    if (Abs(x) < M_EPSILON)
+        return 1.0f;
+    const float arg = x * M_PI;
+    return sinf(arg) / arg;
+}
+
+/// Weights of Kaiser-windowed sinc filter for 2x downsampling.
+struct KaiserWeights
+{
+    KaiserWeights()
+    {
+        float sum = 0.0f;
+        for (int i = 0; i < KAISER_TAPS; ++i)
+        {
+            // Distance from the center of the destination pixel in destination pixels
+            const float distance = (i + KAISER_FIRST_TAP - 0.5f) * 0.5f;
+            const float t = distance / KAISER_WIDTH;
+            const float window = t < 1.0f ? BesselI0(KAISER_ALPHA * sqrtf(1.0f - t * t)) / BesselI0(KAISER_ALPHA) : 0.0f;
+            weights_[i] = Sinc(distance) * window;
+            sum += weights_[i];
+        }
+
+        for (float& weight : weights_)
+            weight /= sum;
+    }
+
+    float weights_[KAISER_TAPS];
+};
+
+const float* GetKaiserWeights()
+{
+    static const KaiserWeights weights;
+    return weights.weights_;
+}
+
+/// Box filter two rows of image with arbitrary number of components.
+void BoxFilterRow(unsigned char* dest, const unsigned char* upper, const unsigned char* lower, int width, int destWidth,
+    unsigned components, int beginX)
+{
+    for (int x = beginX; x < destWidth; ++x)
+    {
+        const unsigned left = Min(x * 2, width - 1) * components;
+        const unsigned right = Min(x * 2 + 1, width - 1) * components;
+        for (unsigned c = 0; c < components; ++c)
+        {
+            const unsigned sum = upper[left + c] + upper[right + c] + lower[left + c] + lower[right + c];
+            dest[x * components + c] = static_cast<unsigned char>(sum >> 2);
+        }
+    }
+}
+
+/// Box filter two rows of image. Color channels are averaged in linear space.
+void BoxFilterRowSRGB(unsigned char* dest, const unsigned char* upper, const unsigned char* lower, int width, int destWidth,
+    unsigned components)
+{
+    const SRGBTables& tables = GetSRGBTables();
+    bool isSRGB[4];
+    for (unsigned c = 0; c < components; ++c)
+        isSRGB[c] = IsSRGBChannel(c, components, true);
+
+    for (int x = 0; x < destWidth; ++x)
+    {
+        const unsigned left = Min(x * 2, width - 1) * components;
+        const unsigned right = Min(x * 2 + 1, width - 1) * components;
+        for (unsigned c = 0; c < components; ++c)
+        {
+            const unsigned char a = upper[left + c];
+            const unsigned char b = upper[right + c];
+            const unsigned char d = lower[left + c];
+            const unsigned char e = lower[right + c];
+            if (isSRGB[c])
+            {
+                const unsigned sum = tables.toLinear16_[a] + tables.toLinear16_[b] + tables.toLinear16_[d] + tables.toLinear16_[e];
+                dest[x * components + c] = tables.fromLinear16_[(sum + 2) >> 2];
+            }
+            else
+                dest[x * components + c] = static_cast<unsigned char>((a + b + d + e) >> 2);
+        }
+    }
+}
+
+/// Box filter two rows of image. Linear 1- and 4-component images are vectorized.
+void BoxFilterRowLinear(unsigned char* dest, const unsigned char* upper, const unsigned char* lower, int width, int destWidth,
+    unsigned components)
+{
+    int x = 0;
+
+#ifdef URHO3D_SSE
+    const __m128i zero = _mm_setzero_si128();
+    if (components == 4)
+    {
+        // 8 source pixels into 4 destination pixels
+        for (; (x + 4) * 2 <= width; x += 4)
+        {
+            __m128i result[2];
+            for (int i = 0; i < 2; ++i)
+            {
+                const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(upper + (x * 2 + i * 4) * 4));
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lower + (x * 2 + i * 4) * 4));
+                const __m128i sumLow = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+                const __m128i sumHigh = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+                const __m128i pairLow = _mm_add_epi16(sumLow, _mm_srli_si128(sumLow, 8));
+                const __m128i pairHigh = _mm_add_epi16(sumHigh, _mm_srli_si128(sumHigh, 8));
+                result[i] = _mm_srli_epi16(_mm_unpacklo_epi64(pairLow, pairHigh), 2);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x * 4), _mm_packus_epi16(result[0], result[1]));
+        }
+    }
+    else if (components == 1)
+    {
+        // 16 source pixels into 8 destination pixels
+        const __m128i ones = _mm_set1_epi16(1);
+        for (; (x + 8) * 2 <= width; x += 8)
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(upper + x * 2));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lower + x * 2));
+            const __m128i sumLow = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            const __m128i sumHigh = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+            const __m128i pairs = _mm_packs_epi32(_mm_madd_epi16(sumLow, ones), _mm_madd_epi16(sumHigh, ones));
+            const __m128i result = _mm_packus_epi16(_mm_srli_epi16(pairs, 2), zero);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dest + x), result);
+        }
+    }
+#endif
+
+    BoxFilterRow(dest, upper, lower, width, destWidth, components, x);
+}
+
+/// Convert row of image to floats. sRGB channels are converted to linear space.
+void ConvertRowToFloat(float* dest, const unsigned char* src, int width, unsigned components, const bool isSRGB[])
+{
+    const SRGBTables& tables = GetSRGBTables();
+    for (int x = 0; x < width; ++x)
+    {
+        for (unsigned c = 0; c < components; ++c)
+        {
+            const unsigned char value = src[x * components + c];
+            dest[x * components + c] = isSRGB[c] ? tables.toLinear_[value] : static_cast<float>(value);
+        }
+    }
+}
+
+/// Convert row of floats to image. sRGB channels are converted from linear space.
+void ConvertRowFromFloat(unsigned char* dest, const float* src, int width, unsigned components, const bool isSRGB[])
+{
+    const SRGBTables& tables = GetSRGBTables();
+    for (int x = 0; x < width; ++x)
+    {
+        for (unsigned c = 0; c < components; ++c)
+        {
+            const float value = src[x * components + c];
+            if (isSRGB[c])
+                dest[x * components + c] = tables.fromLinear16_[Clamp(static_cast<int>(value * 257.0f + 0.5f), 0, 65535)];
+            else
+                dest[x * components + c] = static_cast<unsigned char>(Clamp(static_cast<int>(value + 0.5f), 0, 255));
+        }
+    }
+}
+
+/// Apply Kaiser filter to the row of floats horizontally.
+void KaiserFilterRow(float* dest, const float* src, int width, int destWidth, unsigned components)
+{
+    const float* weights = GetKaiserWeights();
+    for (int x = 0; x < destWidth; ++x)
+    {
+        const int first = x * 2 + KAISER_FIRST_TAP;
+        float* destPixel = dest + x * components;
+
+#ifdef URHO3D_SSE
+        if (components == 4 && first >= 0 && first + KAISER_TAPS <= width)
+        {
+            const float* srcPixel = src + first * 4;
+            __m128 sum = _mm_setzero_ps();
+            for (int i = 0; i < KAISER_TAPS; ++i)
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(srcPixel + i * 4), _mm_set1_ps(weights[i])));
+            _mm_storeu_ps(destPixel, sum);
+            continue;
+        }
+#endif
+
+        for (unsigned c = 0; c < components; ++c)
+            destPixel[c] = 0.0f;
+        for (int i = 0; i < KAISER_TAPS; ++i)
+        {
+            const float* srcPixel = src + Clamp(first + i, 0, width - 1) * components;
+            for (unsigned c = 0; c < components; ++c)
+                destPixel[c] += srcPixel[c] * weights[i];
+        }
+    }
+}
+
+/// Downsample image with Kaiser filter. Rows are filtered horizontally into intermediate buffer and then vertically.
+void KaiserDownsample(unsigned char* dest, const unsigned char* src, int width, int height, int destWidth, int destHeight,
+    unsigned components, bool sRGB, WorkQueue* workQueue)
+{
+    bool isSRGB[4];
+    for (unsigned c = 0; c < components; ++c)
+        isSRGB[c] = IsSRGBChannel(c, components, sRGB);
+
+    // Initialize tables before parallel processing
+    GetSRGBTables();
+    const float* weights = GetKaiserWeights();
+
+    const unsigned srcRowSize = width * components;
+    const unsigned destRowSize = destWidth * components;
+    ForEachImageRows(workQueue, KAISER_ROWS_PER_TASK, destHeight, [&](unsigned beginY, unsigned endY)
+    {
+        const int firstRow = Max(static_cast<int>(beginY * 2) + KAISER_FIRST_TAP, 0);
+        const int lastRow = Min(static_cast<int>((endY - 1) * 2) + KAISER_FIRST_TAP + KAISER_TAPS - 1, height - 1);
+
+        // Filter all source rows used by the task horizontally
+        ea::unique_ptr<float[]> srcRow(new float[srcRowSize]);
+        ea::unique_ptr<float[]> rows(new float[(lastRow - firstRow + 1) * destRowSize]);
+        for (int y = firstRow; y <= lastRow; ++y)
+        {
+            ConvertRowToFloat(srcRow.get(), src + y * srcRowSize, width, components, isSRGB);
+            KaiserFilterRow(rows.get() + (y - firstRow) * destRowSize, srcRow.get(), width, destWidth, components);
+        }
+
+        ea::unique_ptr<float[]> destRow(new float[destRowSize]);
+        for (unsigned y = beginY; y < endY; ++y)
+        {
+            const float* taps[KAISER_TAPS];
+            for (int i = 0; i < KAISER_TAPS; ++i)
+            {
+                const int row = Clamp(static_cast<int>(y * 2) + KAISER_FIRST_TAP + i, 0, height - 1);
+                taps[i] = rows.get() + (row - firstRow) * destRowSize;
+            }
+
+            unsigned x = 0;
+#ifdef URHO3D_SSE
+            for (; x + 4 <= destRowSize; x += 4)
+            {
+                __m128 sum = _mm_setzero_ps();
+                for (int i = 0; i < KAISER_TAPS; ++i)
+                    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(taps[i] + x), _mm_set1_ps(weights[i])));
+                _mm_storeu_ps(destRow.get() + x, sum);
+            }
+#endif
+            for (; x < destRowSize; ++x)
+            {
+                float sum = 0.0f;
+                for (int i = 0; i < KAISER_TAPS; ++i)
+                    sum += taps[i][x] * weights[i];
+                destRow[x] = sum;
+            }
+
+            ConvertRowFromFloat(dest + y * destRowSize, destRow.get(), destWidth, components, isSRGB);
+        }
+    });
+}
+
+/// Resample image with bilinear filtering.
+void BilinearResample(unsigned char* dest, int destWidth, int destHeight, const unsigned char* src, int width, int height,
+    unsigned components, WorkQueue* workQueue)
+{
+    // Pixel centers are aligned. Precalculate source offsets and weights of the columns
+    const float scaleX = static_cast<float>(width) / destWidth;
+    const float scaleY = static_cast<float>(height) / destHeight;
+    ea::vector<unsigned> columnOffsets(destWidth * 2);
+    ea::vector<float> columnWeights(destWidth);
+    for (int x = 0; x < destWidth; ++x)
+    {
+        const float srcX = Clamp((x + 0.5f) * scaleX - 0.5f, 0.0f, static_cast<float>(width - 1));
+        const int left = static_cast<int>(srcX);
+        columnOffsets[x * 2] = left * components;
+        columnOffsets[x * 2 + 1] = Min(left + 1, width - 1) * components;
+        columnWeights[x] = srcX - left;
+    }
+
+    const unsigned srcRowSize = width * components;
+    ForEachImageRows(workQueue, ROWS_PER_TASK, destHeight, [&](unsigned beginY, unsigned endY)
+    {
+        for (unsigned y = beginY; y < endY; ++y)
+        {
+            const float srcY = Clamp((y + 0.5f) * scaleY - 0.5f, 0.0f, static_cast<float>(height - 1));
+            const int top = static_cast<int>(srcY);
+            const float weightY = srcY - top;
+            const unsigned char* upper = src + top * srcRowSize;
+            const unsigned char* lower = src + Min(top + 1, height - 1) * srcRowSize;
+            unsigned char* destRow = dest + y * destWidth * components;
+
+            int x = 0;
+#ifdef URHO3D_SSE
+            if (components == 4)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128 half = _mm_set1_ps(0.5f);
+                const __m128 factorY = _mm_set1_ps(weightY);
+                const auto loadPixel = [&](const unsigned char* pixel)
+                {
+                    int value;
+                    memcpy(&value, pixel, sizeof(value));
+                    const __m128i bytes = _mm_cvtsi32_si128(value);
+                    return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero));
+                };
+
+                for (; x < destWidth; ++x)
+                {
+                    const unsigned left = columnOffsets[x * 2];
+                    const unsigned right = columnOffsets[x * 2 + 1];
+                    const __m128 factorX = _mm_set1_ps(columnWeights[x]);
+                    const __m128 upperLeft = loadPixel(upper + left);
+                    const __m128 lowerLeft = loadPixel(lower + left);
+                    const __m128 upperValue = _mm_add_ps(upperLeft, _mm_mul_ps(_mm_sub_ps(loadPixel(upper + right), upperLeft), factorX));
+                    const __m128 lowerValue = _mm_add_ps(lowerLeft, _mm_mul_ps(_mm_sub_ps(loadPixel(lower + right), lowerLeft), factorX));
+                    const __m128 value = _mm_add_ps(upperValue, _mm_mul_ps(_mm_sub_ps(lowerValue, upperValue), factorY));
+                    const __m128i result = _mm_cvttps_epi32(_mm_add_ps(value, half));
+                    const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(result, zero), zero);
+                    const int pixel = _mm_cvtsi128_si32(packed);
+                    memcpy(destRow + x * 4, &pixel, sizeof(pixel));
+                }
+            }
+#endif
+
+            for (; x < destWidth; ++x)
+            {
+                const unsigned left = columnOffsets[x * 2];
+                const unsigned right = columnOffsets[x * 2 + 1];
+                const float weightX = columnWeights[x];
+                for (unsigned c = 0; c < components; ++c)
+                {
+                    const float upperLeft = upper[left + c];
+                    const float lowerLeft = lower[left + c];
+                    const float upperValue = upperLeft + (upper[right + c] - upperLeft) * weightX;
+                    const float lowerValue = lowerLeft + (lower[right + c] - lowerLeft) * weightX;
+                    destRow[x * components + c] = static_cast<unsigned char>(upperValue + (lowerValue - upperValue) * weightY + 0.5f);
+                }
+            }
+        }
+    });
+}
+
+}
+
+void DownsampleImage(unsigned char* dest, const unsigned char* src, int width, int height, unsigned components,
+    ImageMipFilter filter, bool sRGB, WorkQueue* workQueue)
+{
+    const int destWidth = Max(width / 2, 1);
+    const int destHeight = Max(height / 2, 1);
+
+    if (filter == ImageMipFilter::Kaiser)
+    {
+        KaiserDownsample(dest, src, width, height, destWidth, destHeight, components, sRGB, workQueue);
+        return;
+    }
+
+    if (sRGB)
+        GetSRGBTables();
+
+    // Odd last row and column are ignored, single row and column are averaged with themselves
+    const unsigned srcRowSize = width * components;
+    const unsigned destRowSize = destWidth * components;
+    ForEachImageRows(workQueue, ROWS_PER_TASK, destHeight, [&](unsigned beginY, unsigned endY)
+    {
+        for (unsigned y = beginY; y < endY; ++y)
+        {
+            const unsigned char* upper = src + Min(static_cast<int>(y * 2), height - 1) * srcRowSize;
+            const unsigned char* lower = src + Min(static_cast<int>(y * 2 + 1), height - 1) * srcRowSize;
+            if (sRGB)
+                BoxFilterRowSRGB(dest + y * destRowSize, upper, lower, width, destWidth, components);
+            else
+                BoxFilterRowLinear(dest + y * destRowSize, upper, lower, width, destWidth, components);
+        }
+    });
+}
+
+void ResampleImage(unsigned char* dest, int destWidth, int destHeight, const unsigned char* src, int width, int height,
+    unsigned components, WorkQueue* workQueue)
+{
+    // Bilinear filter doesn't sample all pixels when the image is shrunk, box filter it first
+    ea::unique_ptr<unsigned char[]> levels[2];
+    unsigned currentLevel = 0;
+    while (destWidth * 2 <= width && destHeight * 2 <= height)
+    {
+        const int levelWidth = width / 2;
+        const int levelHeight = height / 2;
+        levels[currentLevel].reset(new unsigned char[levelWidth * levelHeight * components]);
+        DownsampleImage(levels[currentLevel].get(), src, width, height, components, ImageMipFilter::Box, false, workQueue);
+
+        src = levels[currentLevel].get();
+        width = levelWidth;
+        height = levelHeight;
+        currentLevel = 1 - currentLevel;
+    }
+
+    BilinearResample(dest, destWidth, destHeight, src, width, height, components, workQueue);
+}
+
+void FlipImageHorizontal(unsigned char* dest, const unsigned char* src, int width, int height, unsigned components,
+    WorkQueue* workQueue)
+{
+    const unsigned rowSize = width * components;
+    ForEachImageRows(workQueue, ROWS_PER_TASK, height, [&](unsigned beginY, unsigned endY)
+    {
+        for (unsigned y = beginY; y < endY; ++y)
+        {
+            const unsigned char* srcRow = src + y * rowSize;
+            unsigned char* destRow = dest + y * rowSize;
+
+            int x = 0;
+#ifdef URHO3D_SSE
+            if (components == 4)
+            {
+                for (; x + 4 <= width; x += 4)
+                {
+                    const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcRow + (width - x - 4) * 4));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(destRow + x * 4), _mm_shuffle_epi32(pixels, _MM_SHUFFLE(0, 1, 2, 3)));
+                }
+            }
+#endif
+            for (; x < width; ++x)
+                memcpy(destRow + x * components, srcRow + (width - x - 1) * components, components);
+        }
+    });
+}
+
+void FlipImageVertical(unsigned char* dest, const unsigned char* src, int width, int height, unsigned components,
+    WorkQueue* workQueue)
+{
+    const unsigned rowSize = width * components;
+    ForEachImageRows(workQueue, ROWS_PER_TASK, height, [&](unsigned beginY, unsigned endY)
+    {
+        for (unsigned y = beginY; y < endY; ++y)
+            memcpy(dest + (height - y - 1) * rowSize, src + y * rowSize, rowSize);
+    });
+}
+
+}
@@ -0,0 +1,60 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "../Core/WorkQueue.h"
+#include "../Resource/Image.h"
+
+namespace Urho3D
+{
+
+/// Call callback for the ranges of rows [0, numRows). Ranges are processed by WorkQueue threads and the calling thread
+/// if work queue is not null, in this case the function should be called from the main thread.
+template <class T> void ForEachImageRows(WorkQueue* workQueue, unsigned rowsPerTask, unsigned numRows, const T& callback)
+{
+    if (workQueue && workQueue->GetNumThreads() > 0)
+        ForEachParallel(workQueue, rowsPerTask, numRows, callback);
+    else if (numRows > 0)
+        callback(0u, numRows);
+}
+
+/// Downsample 2D image to the next mip level of size Max(width / 2, 1) x Max(height / 2, 1).
+/// Color channels of sRGB image are filtered in linear space, alpha channel is filtered as is.
+/// Rows are processed by WorkQueue threads if work queue is not null.
+URHO3D_API void DownsampleImage(unsigned char* dest, const unsigned char* src, int width, int height, unsigned components,
+    ImageMipFilter filter, bool sRGB, WorkQueue* workQueue = nullptr);
+/// Resample 2D image to arbitrary size with bilinear filtering. Image is box filtered first if it's shrunk more than twice.
+/// Rows are processed by WorkQueue threads if work queue is not null.
+URHO3D_API void ResampleImage(unsigned char* dest, int destWidth, int destHeight, const unsigned char* src, int width,
+    int height, unsigned components, WorkQueue* workQueue = nullptr);
+/// Mirror 2D image horizontally. Source and destination should not overlap.
+URHO3D_API void FlipImageHorizontal(unsigned char* dest, const unsigned char* src, int width, int height, unsigned components,
+    WorkQueue* workQueue = nullptr);
+/// Mirror 2D image vertically. Source and destination should not overlap.
+URHO3D_API void FlipImageVertical(unsigned char* dest, const unsigned char* src, int width, int height, unsigned components,
+    WorkQueue* workQueue = nullptr);
+
+}
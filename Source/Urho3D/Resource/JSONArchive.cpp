@@ -351,14 +351,16 @@ const JSONValue* JSONInputArchiveBlock::ReadElement(ArchiveBase& archive, const
                 return nullptr;
             }
 
-            if (!value_->Contains(elementName))
+            // Find element in map without constructing temporary key string
+            const JSONObject& object = value_->GetObject();
+            const auto iter = object.find_as(elementName, ea::less_2<ea::string, const char*>());
+            if (iter == object.end())
             {
                 // Not an error in Unordered block
                 return nullptr;
             }
 
-            // Find element in map
-            elementValue = &value_->Get(elementName);
+            elementValue = &iter->second;
         }
         else if (type_ == ArchiveBlockType::Map)
         {
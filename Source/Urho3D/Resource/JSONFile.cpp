@@ -31,6 +31,8 @@
 #include "../Resource/ResourceCache.h"
 
 #include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+#include <rapidjson/reader.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/prettywriter.h>
 
@@ -53,61 +55,81 @@ void JSONFile::RegisterObject(Context* context)
     context->RegisterFactory<JSONFile>();
 }
 
-// Convert rapidjson value to JSON value.
-static void ToJSONValue(JSONValue& jsonValue, const rapidjson::Value& rapidjsonValue)
+namespace
 {
-    switch (rapidjsonValue.GetType())
-    {
-    case kNullType:
-        // Reset to null type
-        jsonValue.SetType(JSON_NULL);
-        break;
 
-    case kFalseType:
-        jsonValue = false;
-        break;
-
-    case kTrueType:
-        jsonValue = true;
-        break;
-
-    case kNumberType:
-        if (rapidjsonValue.IsInt())
-            jsonValue = rapidjsonValue.GetInt();
-        else if (rapidjsonValue.IsUint())
-            jsonValue = rapidjsonValue.GetUint();
+/// SAX handler that builds JSON value directly from rapidjson events, without intermediate DOM.
+class JSONValueReader : public BaseReaderHandler<UTF8<>, JSONValueReader>
+{
+public:
+    /// Construct.
+    explicit JSONValueReader(JSONValue& root) : root_(root) {}
+
+    bool Null() { NextValue().SetType(JSON_NULL); return true; }
+    bool Bool(bool value) { NextValue() = value; return true; }
+    bool Int(int value) { NextValue() = value; return true; }
+    bool Uint(unsigned value)
+    {
+        // Keep unsigned values that fit into int signed, same as rapidjson DOM reports them
+        if (value <= static_cast<unsigned>(M_MAX_INT))
+            NextValue() = static_cast<int>(value);
         else
-            jsonValue = rapidjsonValue.GetDouble();
-        break;
+            NextValue() = value;
+        return true;
+    }
+    bool Int64(int64_t value) { NextValue() = static_cast<double>(value); return true; }
+    bool Uint64(uint64_t value) { NextValue() = static_cast<double>(value); return true; }
+    bool Double(double value) { NextValue() = value; return true; }
+    bool String(const char* str, SizeType length, bool /*copy*/)
+    {
+        NextValue().SetString(ea::string_view(str, length));
+        return true;
+    }
 
-    case kStringType:
-        jsonValue = rapidjsonValue.GetString();
-        break;
+    bool StartObject() { return StartContainer(JSON_OBJECT); }
+    bool Key(const char* str, SizeType length, bool /*copy*/)
+    {
+        key_.assign(str, length);
+        return true;
+    }
+    bool EndObject(SizeType /*memberCount*/) { stack_.pop_back(); return true; }
 
-    case kArrayType:
-        {
-            jsonValue.Resize(rapidjsonValue.Size());
-            for (unsigned i = 0; i < rapidjsonValue.Size(); ++i)
-            {
-                ToJSONValue(jsonValue[i], rapidjsonValue[i]);
-            }
-        }
-        break;
+    bool StartArray() { return StartContainer(JSON_ARRAY); }
+    bool EndArray(SizeType /*elementCount*/) { stack_.pop_back(); return true; }
+
+private:
+    /// Return value to be filled by the next event.
+    JSONValue& NextValue()
+    {
+        if (stack_.empty())
+            return root_;
 
-    case kObjectType:
+        JSONValue& parent = *stack_.back();
+        if (parent.IsArray())
         {
-            jsonValue.SetType(JSON_OBJECT);
-            for (rapidjson::Value::ConstMemberIterator i = rapidjsonValue.MemberBegin(); i != rapidjsonValue.MemberEnd(); ++i)
-            {
-                JSONValue& value = jsonValue[ea::string(i->name.GetString())];
-                ToJSONValue(value, i->value);
-            }
+            parent.Push(JSONValue{});
+            return parent[parent.Size() - 1];
         }
-        break;
+        return parent[key_];
+    }
 
-    default:
-        break;
+    /// Begin array or object.
+    bool StartContainer(JSONValueType type)
+    {
+        JSONValue& value = NextValue();
+        value.SetType(type);
+        stack_.push_back(&value);
+        return true;
     }
+
+    /// Root value.
+    JSONValue& root_;
+    /// Arrays and objects being filled.
+    ea::vector<JSONValue*> stack_;
+    /// Last parsed object key.
+    ea::string key_;
+};
+
 }
 
 bool JSONFile::BeginLoad(Deserializer& source)
@@ -124,14 +146,20 @@ bool JSONFile::BeginLoad(Deserializer& source)
         return false;
     buffer[dataSize] = '\0';
 
-    rapidjson::Document document;
-    if (document.Parse<kParseCommentsFlag | kParseTrailingCommasFlag>(buffer.get()).HasParseError())
+    // Parse in place: strings are unescaped inside the buffer and copied once into JSON values
+    JSONValue root;
+    JSONValueReader handler(root);
+    InsituStringStream stream(buffer.get());
+    Reader reader;
+    const ParseResult result = reader.Parse<kParseInsituFlag | kParseCommentsFlag | kParseTrailingCommasFlag>(stream, handler);
+    if (result.IsError())
     {
-        URHO3D_LOGERROR("Could not parse JSON data from " + source.GetName());
+        URHO3D_LOGERROR("Could not parse JSON data from {}: {} at offset {}", source.GetName(),
+            GetParseError_En(result.Code()), result.Offset());
         return false;
     }
 
-    ToJSONValue(root_, document);
+    root_ = ea::move(root);
 
     SetMemoryUse(dataSize);
 
@@ -239,15 +267,19 @@ bool JSONFile::FromString(const ea::string & source)
 
 bool JSONFile::ParseJSON(const ea::string& json, JSONValue& value, bool reportError)
 {
-    rapidjson::Document document;
-    if (document.Parse<0>(json.c_str()).HasParseError())
+    JSONValue root;
+    JSONValueReader handler(root);
+    StringStream stream(json.c_str());
+    Reader reader;
+    const ParseResult result = reader.Parse<0>(stream, handler);
+    if (result.IsError())
     {
         if (reportError)
-            URHO3D_LOGERRORF("Could not parse JSON data from string with error: %s", document.GetParseError());
+            URHO3D_LOGERROR("Could not parse JSON data from string with error: {}", GetParseError_En(result.Code()));
 
         return false;
     }
-    ToJSONValue(value, document);
+    value = ea::move(root);
     return true;
 }
 
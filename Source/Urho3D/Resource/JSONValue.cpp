@@ -113,6 +113,12 @@ JSONValue& JSONValue::operator =(const char* rhs)
     return *this;
 }
 
+void JSONValue::SetString(ea::string_view value)
+{
+    SetType(JSON_STRING);
+    stringValue_->assign(value.data(), value.size());
+}
+
 JSONValue& JSONValue::operator =(const JSONArray& rhs)
 {
     SetType(JSON_ARRAY);
@@ -164,13 +170,14 @@ JSONValue& JSONValue::operator =(const JSONValue& rhs)
     return *this;
 }
 
-JSONValue& JSONValue::operator=(JSONValue && rhs)
+JSONValue& JSONValue::operator=(JSONValue && rhs) noexcept
 {
     assert(this != &rhs);
 
-    SetType(rhs.GetValueType(), rhs.GetNumberType());
+    // Release own payload and take over the payload of other value, leaving it null
+    SetType(JSON_NULL);
 
-    switch (GetValueType())
+    switch (rhs.GetValueType())
     {
     case JSON_BOOL:
         boolValue_ = rhs.boolValue_;
@@ -181,20 +188,24 @@ JSONValue& JSONValue::operator=(JSONValue && rhs)
         break;
 
     case JSON_STRING:
-        *stringValue_ = std::move(*rhs.stringValue_);
+        stringValue_ = rhs.stringValue_;
         break;
 
     case JSON_ARRAY:
-        *arrayValue_ = std::move(*rhs.arrayValue_);
+        arrayValue_ = rhs.arrayValue_;
         break;
 
     case JSON_OBJECT:
-        *objectValue_ = std::move(*rhs.objectValue_);
+        objectValue_ = rhs.objectValue_;
+        break;
 
     default:
         break;
     }
 
+    type_ = rhs.type_;
+    rhs.type_ = 0;
+
     return *this;
 }
 
@@ -208,6 +219,9 @@ bool JSONValue::operator ==(const JSONValue& rhs) const
 
     switch (GetValueType())
     {
+    case JSON_NULL:
+        return true;
+
     case JSON_BOOL:
         return boolValue_ == rhs.boolValue_;
 
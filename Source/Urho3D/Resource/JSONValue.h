@@ -142,8 +142,8 @@ public:
     {
         *this = value;
     }
-    /// Move-construct from another JSON value.
-    JSONValue(JSONValue && value) :
+    /// Move-construct from another JSON value. The other value is left null.
+    JSONValue(JSONValue && value) noexcept :
         type_(0)
     {
         *this = std::move(value);
@@ -175,7 +175,7 @@ public:
     /// Assign from another JSON value.
     JSONValue& operator =(const JSONValue& rhs);
     /// Move-assign from another JSON value.
-    JSONValue& operator =(JSONValue && rhs);
+    JSONValue& operator =(JSONValue && rhs) noexcept;
     /// Value equality operator.
     bool operator ==(const JSONValue& rhs) const;
     /// Value inequality operator.
@@ -231,6 +231,8 @@ public:
     const ea::vector<JSONValue>& GetArray() const { return IsArray() ? *arrayValue_ : emptyArray; }
     /// Return JSON object value.
     const ea::map<ea::string, JSONValue>& GetObject() const { return IsObject() ? *objectValue_ : emptyObject; }
+    /// Set string value from string view.
+    void SetString(ea::string_view value);
 
     // JSON array functions
     /// Return JSON value at index.
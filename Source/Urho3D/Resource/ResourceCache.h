@@ -27,6 +27,7 @@
 #include <EASTL/unique_ptr.h>
 #include <EASTL/hash_set.h>
 
+#include "../Container/FlatHashMap.h"
 #include "../Container/Ptr.h"
 #include "../Core/Mutex.h"
 #include "../IO/File.h"
@@ -57,7 +58,7 @@ struct ResourceGroup
     /// Current memory use.
     unsigned long long memoryUse_;
     /// Resources.
-    ea::unordered_map<StringHash, SharedPtr<Resource> > resources_;
+    FlatHashMap<StringHash, SharedPtr<Resource>> resources_;
 };
 
 /// Resource request types.
@@ -165,7 +166,7 @@ public:
     Resource* GetExistingResource(StringHash type, const ea::string& name);
 
     /// Return all loaded resources.
-    const ea::unordered_map<StringHash, ResourceGroup>& GetAllResources() const { return resourceGroups_; }
+    const FlatHashMap<StringHash, ResourceGroup>& GetAllResources() const { return resourceGroups_; }
 
     /// Return added resource load directories.
     /// @property
@@ -273,7 +274,7 @@ private:
     /// Mutex for thread-safe access to the resource directories, resource packages and resource dependencies.
     mutable Mutex resourceMutex_;
     /// Resources by type.
-    ea::unordered_map<StringHash, ResourceGroup> resourceGroups_;
+    FlatHashMap<StringHash, ResourceGroup> resourceGroups_;
     /// Resource load directories.
     ea::vector<ea::string> resourceDirs_;
     /// File watchers for resource directories, if automatic reloading enabled.
@@ -24,12 +24,22 @@
 #include "../IO/ArchiveSerialization.h"
 #include "../Resource/XMLArchive.h"
 
+#include <PugiXml/pugixml.hpp>
+
 namespace Urho3D
 {
 
 /// Name of internal key attribue of Map block.
 static const char* keyAttribute = "key";
 
+/// Return attribute value of the element, or null if missing.
+static const char* FindAttribute(const XMLElement& element, const char* name)
+{
+    const pugi::xml_node node = element.GetXPathNode() ? element.GetXPathNode()->node() : pugi::xml_node(element.GetNode());
+    const pugi::xml_attribute attribute = node.attribute(name);
+    return attribute ? attribute.value() : nullptr;
+}
+
 XMLOutputArchiveBlock::XMLOutputArchiveBlock(const char* name, ArchiveBlockType type, XMLElement blockElement, unsigned sizeHint)
     : name_(name)
     , type_(type)
@@ -355,13 +365,14 @@ bool XMLInputArchiveBlock::ReadCurrentKey(ArchiveBase& archive, ea::string& key)
         return false;
     }
 
-    if (!nextChild_.HasAttribute(keyAttribute))
+    const char* keyValue = FindAttribute(nextChild_, keyAttribute);
+    if (!keyValue)
     {
         archive.SetErrorFormatted(ArchiveBase::errorMissingMapKey);
         return false;
     }
 
-    key = nextChild_.GetAttribute(keyAttribute);
+    key = keyValue;
     keyRead_ = true;
     return true;
 }
@@ -408,7 +419,7 @@ XMLAttributeReference XMLInputArchiveBlock::ReadElementOrAttribute(ArchiveBase&
     if (type_ != ArchiveBlockType::Unordered)
     {
         XMLElement child = ReadElement(archive, elementName);
-        return { child, "value" };
+        return { child, "value", child.GetAttributeCString("value") };
     }
 
     // Special case for Unordered    
@@ -419,10 +430,12 @@ XMLAttributeReference XMLInputArchiveBlock::ReadElementOrAttribute(ArchiveBase&
         return {};
     }
 
-    if (!blockElement_.HasAttribute(elementName))
+    // Look up the attribute once and keep its text, conversion reads it in place
+    const char* value = FindAttribute(blockElement_, elementName);
+    if (!value)
         return {};
-    
-    return { blockElement_, elementName };
+
+    return { blockElement_, elementName, value };
 }
 
 bool XMLInputArchive::BeginBlock(const char* name, unsigned& sizeHint, bool safe, ArchiveBlockType type)
@@ -498,7 +511,7 @@ bool XMLInputArchive::SerializeBytes(const char* name, void* bytes, unsigned siz
 {
     if (XMLAttributeReference ref = ReadElement(name))
     {
-        if (!HexStringToBuffer(tempBuffer_, ref.GetElement().GetAttribute(ref.GetAttributeName())))
+        if (!HexStringToBuffer(tempBuffer_, ref.GetValue()))
             return false;
         if (tempBuffer_.size() != size)
             return false;
@@ -512,7 +525,7 @@ bool XMLInputArchive::SerializeVLE(const char* name, unsigned& value)
 {
     if (XMLAttributeReference ref = ReadElement(name))
     {
-        value = ref.GetElement().GetUInt(ref.GetAttributeName());
+        value = ToUInt(ref.GetValue());
         return true;
     }
     return false;
@@ -567,24 +580,24 @@ XMLAttributeReference XMLInputArchive::ReadElement(const char* name)
     { \
         if (XMLAttributeReference ref = ReadElement(name)) \
         { \
-            value = ref.GetElement().function(ref.GetAttributeName()); \
+            value = function(ref.GetValue()); \
             return true; \
         } \
         return false; \
     }
 
-URHO3D_XML_IN_IMPL(bool, GetBool);
-URHO3D_XML_IN_IMPL(signed char, GetInt);
-URHO3D_XML_IN_IMPL(short, GetInt);
-URHO3D_XML_IN_IMPL(int, GetInt);
-URHO3D_XML_IN_IMPL(long long, GetInt64);
-URHO3D_XML_IN_IMPL(unsigned char, GetUInt);
-URHO3D_XML_IN_IMPL(unsigned short, GetUInt);
-URHO3D_XML_IN_IMPL(unsigned int, GetUInt);
-URHO3D_XML_IN_IMPL(unsigned long long, GetUInt64);
-URHO3D_XML_IN_IMPL(float, GetFloat);
-URHO3D_XML_IN_IMPL(double, GetDouble);
-URHO3D_XML_IN_IMPL(ea::string, GetAttribute);
+URHO3D_XML_IN_IMPL(bool, ToBool);
+URHO3D_XML_IN_IMPL(signed char, ToInt);
+URHO3D_XML_IN_IMPL(short, ToInt);
+URHO3D_XML_IN_IMPL(int, ToInt);
+URHO3D_XML_IN_IMPL(long long, ToInt64);
+URHO3D_XML_IN_IMPL(unsigned char, ToUInt);
+URHO3D_XML_IN_IMPL(unsigned short, ToUInt);
+URHO3D_XML_IN_IMPL(unsigned int, ToUInt);
+URHO3D_XML_IN_IMPL(unsigned long long, ToUInt64);
+URHO3D_XML_IN_IMPL(float, ToFloat);
+URHO3D_XML_IN_IMPL(double, ToDouble);
+URHO3D_XML_IN_IMPL(ea::string, ea::string);
 
 #undef URHO3D_XML_IN_IMPL
 
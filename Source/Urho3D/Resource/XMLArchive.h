@@ -106,11 +106,16 @@ public:
     XMLAttributeReference() = default;
     /// Construct valid.
     XMLAttributeReference(XMLElement element, const char* attribute) : element_(element), attribute_(attribute) {}
+    /// Construct valid with attribute value found during lookup.
+    XMLAttributeReference(XMLElement element, const char* attribute, const char* value)
+        : element_(element), attribute_(attribute), value_(value) {}
 
     /// Return the element.
     XMLElement GetElement() const { return element_; }
     /// Return attribute name.
     const char* GetAttributeName() const { return attribute_; }
+    /// Return attribute value. Available only when reading.
+    const char* GetValue() const { return value_; }
     /// Return whether the element valid.
     explicit operator bool() const { return !!element_; }
 
@@ -119,6 +124,8 @@ private:
     XMLElement element_;
     /// Attribute name.
     const char* attribute_{};
+    /// Attribute value.
+    const char* value_{""};
 };
 
 /// XML output archive block. Internal.
@@ -412,7 +412,8 @@ bool Serializable::LoadXML(const XMLElement& source)
 
     while (attrElem)
     {
-        ea::string name = attrElem.GetAttribute("name");
+        // Compare attribute names against the text in the document, without copying
+        const char* name = attrElem.GetAttributeCString("name");
         unsigned i = startIndex;
         unsigned attempts = attributes->size();
 
@@ -462,7 +463,7 @@ bool Serializable::LoadXML(const XMLElement& source)
         }
 
         if (!attempts)
-            URHO3D_LOGWARNING("Unknown attribute " + name + " in XML data");
+            URHO3D_LOGWARNING("Unknown attribute {} in XML data", name);
 
         attrElem = attrElem.GetNext("attribute");
     }
@@ -75,6 +75,23 @@ void BorderImage::GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& ve
         GetBatches(batches, vertexData, currentScissor, disabledOffset_);
 }
 
+unsigned BorderImage::GetBatchStateHash() const
+{
+    unsigned hash = UIElement::GetBatchStateHash();
+    CombineHash(hash, MakeHash(texture_.Get()));
+    if (texture_)
+        CombineHash(hash, IntVector2(texture_->GetWidth(), texture_->GetHeight()).ToHash());
+    CombineHash(hash, imageRect_.ToHash());
+    CombineHash(hash, border_.ToHash());
+    CombineHash(hash, imageBorder_.ToHash());
+    CombineHash(hash, hoverOffset_.ToHash());
+    CombineHash(hash, disabledOffset_.ToHash());
+    CombineHash(hash, blendMode_);
+    CombineHash(hash, tiled_);
+    CombineHash(hash, MakeHash(material_.Get()));
+    return hash;
+}
+
 void BorderImage::SetTexture(Texture* texture)
 {
     texture_ = texture;
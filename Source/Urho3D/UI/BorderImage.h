@@ -47,6 +47,10 @@ public:
 
     /// Return UI rendering batches.
     void GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, const IntRect& currentScissor) override;
+    /// Return whether the rendering batches can be cached between frames. Subclasses opt in separately.
+    bool CanCacheBatches() const override { return GetType() == GetTypeStatic(); }
+    /// Return hash of the element state that affects the rendering batches.
+    unsigned GetBatchStateHash() const override;
 
     /// Set texture.
     /// @property
@@ -103,6 +103,14 @@ void Button::GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexD
     BorderImage::GetBatches(batches, vertexData, currentScissor, offset);
 }
 
+unsigned Button::GetBatchStateHash() const
+{
+    unsigned hash = BorderImage::GetBatchStateHash();
+    CombineHash(hash, pressedOffset_.ToHash());
+    CombineHash(hash, pressed_);
+    return hash;
+}
+
 void Button::OnClickBegin(const IntVector2& position, const IntVector2& screenPosition, MouseButton button, MouseButtonFlags buttons, QualifierFlags qualifiers,
     Cursor* cursor)
 {
@@ -72,6 +72,14 @@ void CheckBox::GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& verte
     BorderImage::GetBatches(batches, vertexData, currentScissor, offset);
 }
 
+unsigned CheckBox::GetBatchStateHash() const
+{
+    unsigned hash = BorderImage::GetBatchStateHash();
+    CombineHash(hash, checkedOffset_.ToHash());
+    CombineHash(hash, checked_);
+    return hash;
+}
+
 void CheckBox::OnClickBegin(const IntVector2& position, const IntVector2& screenPosition, MouseButton button, MouseButtonFlags buttons, QualifierFlags qualifiers,
     Cursor* cursor)
 {
@@ -43,6 +43,10 @@ public:
 
     /// Return UI rendering batches.
     void GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, const IntRect& currentScissor) override;
+    /// Return whether the rendering batches can be cached between frames. Subclasses opt in separately.
+    bool CanCacheBatches() const override { return GetType() == GetTypeStatic(); }
+    /// Return hash of the element state that affects the rendering batches.
+    unsigned GetBatchStateHash() const override;
     /// React to mouse click begin.
     void OnClickBegin
         (const IntVector2& position, const IntVector2& screenPosition, MouseButton button, MouseButtonFlags buttons, QualifierFlags qualifiers, Cursor* cursor) override;
@@ -127,6 +127,18 @@ void Sprite::GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexD
     hovering_ = false;
 }
 
+unsigned Sprite::GetBatchStateHash() const
+{
+    unsigned hash = UIElement::GetBatchStateHash();
+    CombineHash(hash, GetTransform().ToHash());
+    CombineHash(hash, MakeHash(texture_.Get()));
+    if (texture_)
+        CombineHash(hash, IntVector2(texture_->GetWidth(), texture_->GetHeight()).ToHash());
+    CombineHash(hash, imageRect_.ToHash());
+    CombineHash(hash, blendMode_);
+    return hash;
+}
+
 void Sprite::OnPositionSet(const IntVector2& newPosition)
 {
     // If the integer position was set (layout update?), copy to the float position
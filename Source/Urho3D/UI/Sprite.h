@@ -48,6 +48,10 @@ public:
     const IntVector2& GetScreenPosition() const override;
     /// Return UI rendering batches.
     void GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, const IntRect& currentScissor) override;
+    /// Return whether the rendering batches can be cached between frames. Subclasses opt in separately.
+    bool CanCacheBatches() const override { return GetType() == GetTypeStatic(); }
+    /// Return hash of the element state that affects the rendering batches.
+    unsigned GetBatchStateHash() const override;
     /// React to position change.
     void OnPositionSet(const IntVector2& newPosition) override;
     /// Convert screen coordinates to element coordinates.
@@ -237,6 +237,31 @@ void Text::GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexDat
     }
 }
 
+bool Text::CanCacheBatches() const
+{
+    if (GetType() != GetTypeStatic())
+        return false;
+
+    // Char locations are updated and mutable glyphs are reacquired when generating the batches
+    FontFace* face = font_ ? font_->GetFace(fontSize_) : nullptr;
+    return face && face == fontFace_.Get() && !charLocationsDirty_ && !face->HasMutableGlyphs();
+}
+
+unsigned Text::GetBatchStateHash() const
+{
+    unsigned hash = UISelectable::GetBatchStateHash();
+    CombineHash(hash, selectionStart_);
+    CombineHash(hash, selectionLength_);
+    CombineHash(hash, textEffect_);
+    CombineHash(hash, shadowOffset_.ToHash());
+    CombineHash(hash, strokeThickness_);
+    CombineHash(hash, roundStroke_);
+    CombineHash(hash, effectColor_.ToHash());
+    CombineHash(hash, MakeHash(effectDepthBias_));
+    CombineHash(hash, fontFace_->GetTextures().size());
+    return hash;
+}
+
 void Text::OnResize(const IntVector2& newSize, const IntVector2& delta)
 {
     if (wordWrap_)
@@ -683,6 +708,7 @@ void Text::UpdateCharLocations()
     if (!face)
         return;
     fontFace_ = face;
+    MarkBatchesDirty();
 
     auto rowHeight = RoundToInt(rowSpacing_ * rowHeight_);
 
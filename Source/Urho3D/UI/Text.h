@@ -92,6 +92,10 @@ public:
     void ApplyAttributes() override;
     /// Return UI rendering batches.
     void GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, const IntRect& currentScissor) override;
+    /// Return whether the rendering batches can be cached between frames.
+    bool CanCacheBatches() const override;
+    /// Return hash of the element state that affects the rendering batches.
+    unsigned GetBatchStateHash() const override;
     /// React to resize.
     void OnResize(const IntVector2& newSize, const IntVector2& delta) override;
     /// React to indent change.
@@ -431,6 +431,7 @@ void UI::RenderUpdate()
     // Get rendering batches from the non-modal UI elements
     batches_.clear();
     vertexData_.clear();
+    batchStats_ = {};
     const IntVector2& rootSize = rootElement_->GetSize();
     const IntVector2& rootPos = rootElement_->GetPosition();
     // Note: the scissors operate on unscaled coordinates. Scissor scaling is only performed during render
@@ -448,7 +449,7 @@ void UI::RenderUpdate()
     if (cursor_ && cursor_->IsVisible() && !osCursorVisible)
     {
         currentScissor = IntRect(0, 0, rootSize.x_, rootSize.y_);
-        cursor_->GetBatches(batches_, vertexData_, currentScissor);
+        GetElementBatches(batches_, vertexData_, cursor_, currentScissor);
         GetBatches(batches_, vertexData_, cursor_, currentScissor);
     }
 
@@ -629,6 +630,11 @@ void UI::SetUseMutableGlyphs(bool enable)
     }
 }
 
+void UI::SetUseBatchCache(bool enable)
+{
+    useBatchCache_ = enable;
+}
+
 void UI::SetForceAutoHint(bool enable)
 {
     if (enable != forceAutoHint_)
@@ -1060,7 +1066,7 @@ void UI::GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData,
             while (j != children.end() && (*j)->GetPriority() == currentPriority)
             {
                 if ((*j)->IsWithinScissor(currentScissor) && (*j) != cursor_)
-                    (*j)->GetBatches(batches, vertexData, currentScissor);
+                    GetElementBatches(batches, vertexData, *j, currentScissor);
                 ++j;
             }
             // Now recurse into the children
@@ -1080,7 +1086,7 @@ void UI::GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData,
             if ((*i) != cursor_)
             {
                 if ((*i)->IsWithinScissor(currentScissor))
-                    (*i)->GetBatches(batches, vertexData, currentScissor);
+                    GetElementBatches(batches, vertexData, *i, currentScissor);
                 if ((*i)->IsVisible())
                     GetBatches(batches, vertexData, *i, currentScissor);
             }
@@ -1089,6 +1095,50 @@ void UI::GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData,
     }
 }
 
+void UI::GetElementBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, UIElement* element,
+    const IntRect& currentScissor)
+{
+    ++batchStats_.numElements_;
+
+    if (!useBatchCache_ || !element->CanCacheBatches())
+    {
+        ++batchStats_.numRebatched_;
+        element->GetBatches(batches, vertexData, currentScissor);
+        return;
+    }
+
+    // Hash is taken before generating the batches, because generation resets the hovering flag
+    UIBatchCache& cache = element->GetBatchCache();
+    const unsigned stateHash = element->GetBatchStateHash();
+    if (cache.valid_ && cache.stateHash_ == stateHash && cache.scissor_ == currentScissor)
+    {
+        ++batchStats_.numCached_;
+        element->SetHovering(false);
+    }
+    else
+    {
+        ++batchStats_.numRebatched_;
+        cache.batches_.clear();
+        cache.vertexData_.clear();
+        element->GetBatches(cache.batches_, cache.vertexData_, currentScissor);
+        cache.scissor_ = currentScissor;
+        cache.stateHash_ = stateHash;
+        cache.valid_ = true;
+    }
+
+    // Copy cached vertex data as is and rebase the batches
+    const unsigned vertexOffset = vertexData.size();
+    vertexData.insert(vertexData.end(), cache.vertexData_.begin(), cache.vertexData_.end());
+    for (const UIBatch& cachedBatch : cache.batches_)
+    {
+        UIBatch batch = cachedBatch;
+        batch.vertexData_ = &vertexData;
+        batch.vertexStart_ += vertexOffset;
+        batch.vertexEnd_ += vertexOffset;
+        UIBatch::AddOrMerge(batch, batches);
+    }
+}
+
 void UI::GetElementAt(UIElement*& result, UIElement* current, const IntVector2& position, bool enabledOnly)
 {
     if (!current)
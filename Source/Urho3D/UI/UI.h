@@ -58,6 +58,17 @@ class XMLFile;
 class RenderSurface;
 class UIComponent;
 
+/// %UI batch generation statistics of the last rendered frame.
+struct UIBatchStats
+{
+    /// Number of elements that produced batches.
+    unsigned numElements_{};
+    /// Number of elements that generated their batches anew.
+    unsigned numRebatched_{};
+    /// Number of elements that reused cached batches.
+    unsigned numCached_{};
+};
+
 /// %UI subsystem. Manages the graphical user interface.
 class URHO3D_API UI : public Object
 {
@@ -126,6 +137,9 @@ public:
     /// Set whether to use mutable (eraseable) glyphs to ensure a font face never expands to more than one texture. Default false.
     /// @property
     void SetUseMutableGlyphs(bool enable);
+    /// Set whether to cache element batches between frames and regenerate them only when the element changes. Default true.
+    /// @property
+    void SetUseBatchCache(bool enable);
     /// Set whether to force font autohinting instead of using FreeType's TTF bytecode interpreter.
     /// @property
     void SetForceAutoHint(bool enable);
@@ -240,6 +254,13 @@ public:
     /// @property
     bool GetUseMutableGlyphs() const { return useMutableGlyphs_; }
 
+    /// Return whether element batches are cached between frames.
+    /// @property
+    bool GetUseBatchCache() const { return useBatchCache_; }
+
+    /// Return batch generation statistics of the last rendered frame.
+    const UIBatchStats& GetBatchStats() const { return batchStats_; }
+
     /// Return whether is using forced autohinting.
     /// @property
     bool GetForceAutoHint() const { return forceAutoHint_; }
@@ -306,6 +327,8 @@ private:
     void Render(VertexBuffer* buffer, const ea::vector<UIBatch>& batches, unsigned batchStart, unsigned batchEnd);
     /// Generate batches from an UI element recursively. Skip the cursor element.
     void GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, UIElement* element, IntRect currentScissor);
+    /// Generate batches of single UI element, reuse cached batches if possible.
+    void GetElementBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, UIElement* element, const IntRect& currentScissor);
     /// Return UI element at screen position recursively.
     void GetElementAt(UIElement*& result, UIElement* current, const IntVector2& position, bool enabledOnly);
     /// Return the first element in hierarchy that can alter focus.
@@ -444,6 +467,8 @@ private:
     bool useScreenKeyboard_;
     /// Flag for using mutable (erasable) font glyphs.
     bool useMutableGlyphs_;
+    /// Flag for caching element batches between frames.
+    bool useBatchCache_{true};
     /// Flag for forcing FreeType auto hinting.
     bool forceAutoHint_;
     /// FreeType hinting level (default is FONT_HINT_LEVEL_NORMAL).
@@ -456,6 +481,8 @@ private:
     bool uiRendered_;
     /// Non-modal batch size (used internally for rendering).
     unsigned nonModalBatchSize_;
+    /// Batch generation statistics of the last rendered frame.
+    UIBatchStats batchStats_;
     /// Timer used to trigger double click.
     Timer clickTimer_;
     /// UI element last clicked for tracking double clicks.
@@ -100,4 +100,20 @@ public:
     static Vector3 posAdjust;
 };
 
+/// %UI element batches cached between frames. Reused while the element state hash is unchanged.
+/// @nobind
+struct UIBatchCache
+{
+    /// Cached batches. Vertex ranges refer to the cached vertex data.
+    ea::vector<UIBatch> batches_;
+    /// Cached vertex data.
+    ea::vector<float> vertexData_;
+    /// Scissor rectangle the batches were generated with.
+    IntRect scissor_;
+    /// Hash of the element state the batches were generated with.
+    unsigned stateHash_{};
+    /// Whether the cached batches are valid.
+    bool valid_{};
+};
+
 }
@@ -371,6 +371,20 @@ void UIElement::GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vert
     hovering_ = false;
 }
 
+unsigned UIElement::GetBatchStateHash() const
+{
+    unsigned hash = batchRevision_;
+    CombineHash(hash, GetScreenPosition().ToHash());
+    CombineHash(hash, size_.ToHash());
+    for (const Color& color : colors_)
+        CombineHash(hash, color.ToHash());
+    CombineHash(hash, MakeHash(GetDerivedOpacity()));
+    CombineHash(hash, MakeHash(UIBatch::posAdjust.x_));
+    CombineHash(hash, MakeHash(UIBatch::posAdjust.y_));
+    CombineHash(hash, (enabled_ ? 1u : 0u) | (selected_ ? 2u : 0u) | (hovering_ ? 4u : 0u) | (HasFocus() ? 8u : 0u));
+    return hash;
+}
+
 void UIElement::GetDebugDrawBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, const IntRect& currentScissor)
 {
     UIBatch batch(this, BLEND_ALPHA, currentScissor, nullptr, &vertexData);
@@ -1881,6 +1895,13 @@ void UIElement::GetBatchesWithOffset(IntVector2& offset, ea::vector<UIBatch>& ba
     }
 }
 
+UIBatchCache& UIElement::GetBatchCache()
+{
+    if (!batchCache_)
+        batchCache_ = ea::make_unique<UIBatchCache>();
+    return *batchCache_;
+}
+
 UIElement* UIElement::GetElementEventSender() const
 {
     auto* element = const_cast<UIElement*>(this);
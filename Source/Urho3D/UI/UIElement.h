@@ -30,6 +30,8 @@
 #include "../Scene/Animatable.h"
 #include "../UI/UIBatch.h"
 
+#include <EASTL/unique_ptr.h>
+
 namespace Urho3D
 {
 
@@ -152,6 +154,13 @@ public:
     virtual const IntVector2& GetScreenPosition() const;
     /// Return UI rendering batches.
     virtual void GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, const IntRect& currentScissor);
+    /// Return whether the rendering batches can be cached between frames. Cached batches are reused while
+    /// the hash returned by GetBatchStateHash() is unchanged. Should be true only for the exact class whose batch
+    /// inputs are all covered by the hash. Caching is per element: the hash of every cacheable element is still
+    /// evaluated each frame, and unchanged subtrees are walked element by element rather than copied as a whole.
+    virtual bool CanCacheBatches() const { return false; }
+    /// Return hash of the element state that affects the rendering batches.
+    virtual unsigned GetBatchStateHash() const;
     /// Return UI rendering batches for debug draw.
     virtual void GetDebugDrawBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, const IntRect& currentScissor);
     /// React to mouse hover.
@@ -743,6 +752,11 @@ public:
     void AdjustScissor(IntRect& currentScissor);
     /// Get UI rendering batches with a specified offset. Also recurse to child elements.
     void GetBatchesWithOffset(IntVector2& offset, ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, IntRect currentScissor);
+    /// Invalidate cached rendering batches. Should be called on content change not covered by GetBatchStateHash().
+    void MarkBatchesDirty() { ++batchRevision_; }
+    /// Return cached rendering batches, create if necessary. Used internally by UI.
+    /// @nobind
+    UIBatchCache& GetBatchCache();
 
     /// Return color attribute. Uses just the top-left color.
     const Color& GetColorAttr() const { return colors_[0]; }
@@ -928,6 +942,10 @@ private:
     static XPathQuery styleXPathQuery_;
     /// Tag list.
     StringVector tags_;
+    /// Cached rendering batches. Created on first use.
+    ea::unique_ptr<UIBatchCache> batchCache_;
+    /// Incremented when cached rendering batches are invalidated.
+    unsigned batchRevision_{};
 };
 
 template <class T> T* UIElement::CreateChild(const ea::string& name, unsigned index)
@@ -56,6 +56,14 @@ void UISelectable::GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& v
     hovering_ = false;
 }
 
+unsigned UISelectable::GetBatchStateHash() const
+{
+    unsigned hash = UIElement::GetBatchStateHash();
+    CombineHash(hash, selectionColor_.ToHash());
+    CombineHash(hash, hoverColor_.ToHash());
+    return hash;
+}
+
 void UISelectable::SetSelectionColor(const Color& color)
 {
     selectionColor_ = color;
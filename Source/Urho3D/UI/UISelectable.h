@@ -44,6 +44,8 @@ public:
 
     /// Return UI rendering batches.
     void GetBatches(ea::vector<UIBatch>& batches, ea::vector<float>& vertexData, const IntRect& currentScissor) override;
+    /// Return hash of the element state that affects the rendering batches.
+    unsigned GetBatchStateHash() const override;
 
     /// Set selection background color. Color with 0 alpha (default) disables.
     /// @property
@@ -30,6 +30,10 @@
 #include "../Urho2D/Drawable2D.h"
 #include "../Urho2D/Renderer2D.h"
 
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
 #include "../DebugNew.h"
 
 namespace Urho3D
@@ -37,6 +41,59 @@ namespace Urho3D
 
 const float PIXEL_SIZE = 0.01f;
 
+void GenerateSpriteQuad(Vertex2D* vertices, const Matrix3x4& worldTransform, const Rect& drawRect,
+    const Rect& textureRect, bool swapXY, unsigned color)
+{
+    // Corner is X axis * x + Y axis * y + translation, Z is always zero
+#ifdef URHO3D_SSE
+    __m128 axisX = _mm_loadu_ps(&worldTransform.m00_);
+    __m128 axisY = _mm_loadu_ps(&worldTransform.m10_);
+    __m128 axisZ = _mm_loadu_ps(&worldTransform.m20_);
+    __m128 translation = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(axisX, axisY, axisZ, translation);
+
+    const __m128 minX = _mm_mul_ps(axisX, _mm_set1_ps(drawRect.min_.x_));
+    const __m128 maxX = _mm_mul_ps(axisX, _mm_set1_ps(drawRect.max_.x_));
+    const __m128 minY = _mm_add_ps(_mm_mul_ps(axisY, _mm_set1_ps(drawRect.min_.y_)), translation);
+    const __m128 maxY = _mm_add_ps(_mm_mul_ps(axisY, _mm_set1_ps(drawRect.max_.y_)), translation);
+
+    // Color is stored right after position, so they are written together.
+    // Color bits are merged after arithmetic so they are never touched by float operations.
+    static_assert(offsetof(Vertex2D, color_) == offsetof(Vertex2D, position_) + sizeof(Vector3), "");
+    const __m128 positionMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    const __m128 colorLane = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, static_cast<int>(color)));
+    const auto storePositionAndColor = [&](Vertex2D& vertex, __m128 position)
+    {
+        _mm_storeu_ps(&vertex.position_.x_, _mm_or_ps(_mm_and_ps(position, positionMask), colorLane));
+    };
+
+    storePositionAndColor(vertices[0], _mm_add_ps(minX, minY));
+    storePositionAndColor(vertices[1], _mm_add_ps(minX, maxY));
+    storePositionAndColor(vertices[2], _mm_add_ps(maxX, maxY));
+    storePositionAndColor(vertices[3], _mm_add_ps(maxX, minY));
+#else
+    const Vector3 axisX{ worldTransform.m00_, worldTransform.m10_, worldTransform.m20_ };
+    const Vector3 axisY{ worldTransform.m01_, worldTransform.m11_, worldTransform.m21_ };
+    const Vector3 translation = worldTransform.Translation();
+
+    const Vector3 minX = axisX * drawRect.min_.x_;
+    const Vector3 maxX = axisX * drawRect.max_.x_;
+    const Vector3 minY = axisY * drawRect.min_.y_ + translation;
+    const Vector3 maxY = axisY * drawRect.max_.y_ + translation;
+
+    vertices[0].position_ = minX + minY;
+    vertices[1].position_ = minX + maxY;
+    vertices[2].position_ = maxX + maxY;
+    vertices[3].position_ = maxX + minY;
+    vertices[0].color_ = vertices[1].color_ = vertices[2].color_ = vertices[3].color_ = color;
+#endif
+
+    vertices[0].uv_ = textureRect.min_;
+    (swapXY ? vertices[3].uv_ : vertices[1].uv_) = Vector2(textureRect.min_.x_, textureRect.max_.y_);
+    vertices[2].uv_ = textureRect.max_;
+    (swapXY ? vertices[1].uv_ : vertices[3].uv_) = Vector2(textureRect.max_.x_, textureRect.min_.y_);
+}
+
 SourceBatch2D::SourceBatch2D() :
     distance_(0.0f),
     drawOrder_(0)
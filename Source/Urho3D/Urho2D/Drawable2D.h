@@ -58,6 +58,10 @@ struct Vertex2D
     }
 };
 
+/// Generate world space vertices of sprite quad: V0 at min corner, V1 at min X and max Y, V2 at max corner, V3 at max X and min Y.
+URHO3D_API void GenerateSpriteQuad(Vertex2D* vertices, const Matrix3x4& worldTransform, const Rect& drawRect,
+    const Rect& textureRect, bool swapXY, unsigned color);
+
 /// 2D source batch.
 struct SourceBatch2D
 {
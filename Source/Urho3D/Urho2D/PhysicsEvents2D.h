@@ -31,6 +31,13 @@
 namespace Urho3D
 {
 
+/// Physics contacts of the step. Global event sent by PhysicsWorld2D once per step before per-contact events.
+/// Contacts are available from PhysicsWorld2D::GetBeginContacts and PhysicsWorld2D::GetEndContacts.
+URHO3D_EVENT(E_PHYSICSCONTACTS2D, PhysicsContacts2D)
+{
+    URHO3D_PARAM(P_WORLD, World);                  // PhysicsWorld2D pointer
+}
+
 /// Physics update contact. Global event sent by PhysicsWorld2D.
 URHO3D_EVENT(E_PHYSICSUPDATECONTACT2D, PhysicsUpdateContact2D)
 {
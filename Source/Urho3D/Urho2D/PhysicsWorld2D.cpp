@@ -89,6 +89,9 @@ void PhysicsWorld2D::RegisterObject(Context* context)
         AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Position Iterations", GetPositionIterations, SetPositionIterations, int, DEFAULT_POSITION_ITERATIONS,
         AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Contact Events", AreContactEventsEnabled, SetContactEventsEnabled, bool, true, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Update Contact Events", AreUpdateContactEventsEnabled, SetUpdateContactEventsEnabled, bool, true,
+        AM_DEFAULT);
 }
 
 void PhysicsWorld2D::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
@@ -115,7 +118,7 @@ void PhysicsWorld2D::BeginContact(b2Contact* contact)
     if (!fixtureA || !fixtureB)
         return;
 
-    beginContactInfos_.push_back(ContactInfo(contact));
+    beginContacts_.emplace_back(contact);
 }
 
 void PhysicsWorld2D::EndContact(b2Contact* contact)
@@ -128,17 +131,20 @@ void PhysicsWorld2D::EndContact(b2Contact* contact)
     if (!fixtureA || !fixtureB)
         return;
 
-    endContactInfos_.push_back(ContactInfo(contact));
+    endContacts_.emplace_back(contact);
 }
 
 void PhysicsWorld2D::PreSolve(b2Contact* contact, const b2Manifold* oldManifold)
 {
+    if (!updateContactEventsEnabled_)
+        return;
+
     b2Fixture* fixtureA = contact->GetFixtureA();
     b2Fixture* fixtureB = contact->GetFixtureB();
     if (!fixtureA || !fixtureB)
         return;
 
-    ContactInfo contactInfo(contact);
+    PhysicsContact2D contactInfo(contact);
 
     // Send global event
     VariantMap& eventData = GetEventDataMap();
@@ -291,21 +297,45 @@ void PhysicsWorld2D::Update(float timeStep)
     world_->Step(timeStep, velocityIterations_, positionIterations_);
     physicsStepping_ = false;
 
-    // Apply world transforms. Unparented transforms first
-    for (unsigned i = 0; i < rigidBodies_.size();)
+    ApplyWorldTransforms();
+
+    if (!beginContacts_.empty() || !endContacts_.empty())
     {
-        if (rigidBodies_[i])
-        {
-            rigidBodies_[i]->ApplyWorldTransform();
-            ++i;
-        }
-        else
-        {
-            // Erase possible stale weak pointer
-            rigidBodies_.erase_at(i);
-        }
+        VariantMap& contactsEventData = GetEventDataMap();
+        contactsEventData[PhysicsContacts2D::P_WORLD] = this;
+        SendEvent(E_PHYSICSCONTACTS2D, contactsEventData);
     }
 
+    if (contactEventsEnabled_)
+    {
+        SendBeginContactEvents();
+        SendEndContactEvents();
+    }
+
+    beginContacts_.clear();
+    endContacts_.clear();
+
+    using namespace PhysicsPostStep;
+    SendEvent(E_PHYSICSPOSTSTEP, eventData);
+}
+
+void PhysicsWorld2D::ApplyWorldTransforms()
+{
+    URHO3D_PROFILE("ApplyWorldTransforms2D");
+
+    // Collect bodies in one pass over Box2D bodies, sleeping and static bodies are skipped unless parented
+    movingRigidBodies_.clear();
+    for (b2Body* body = world_->GetBodyList(); body; body = body->GetNext())
+    {
+        auto* rigidBody = static_cast<RigidBody2D*>(body->GetUserData());
+        if (rigidBody && rigidBody->IsTransformUpdateNeeded())
+            movingRigidBodies_.push_back(rigidBody);
+    }
+
+    // Apply world transforms. Unparented transforms first
+    for (RigidBody2D* rigidBody : movingRigidBodies_)
+        rigidBody->ApplyWorldTransform();
+
     // Apply delayed (parented) world transforms now, if any
     while (!delayedWorldTransforms_.empty())
     {
@@ -324,12 +354,6 @@ void PhysicsWorld2D::Update(float timeStep)
                 ++i;
         }
     }
-
-    SendBeginContactEvents();
-    SendEndContactEvents();
-
-    using namespace PhysicsPostStep;
-    SendEvent(E_PHYSICSPOSTSTEP, eventData);
 }
 
 void PhysicsWorld2D::DrawDebugGeometry()
@@ -427,6 +451,16 @@ void PhysicsWorld2D::SetPositionIterations(int positionIterations)
     positionIterations_ = positionIterations;
 }
 
+void PhysicsWorld2D::SetContactEventsEnabled(bool enable)
+{
+    contactEventsEnabled_ = enable;
+}
+
+void PhysicsWorld2D::SetUpdateContactEventsEnabled(bool enable)
+{
+    updateContactEventsEnabled_ = enable;
+}
+
 void PhysicsWorld2D::AddRigidBody(RigidBody2D* rigidBody)
 {
     if (!rigidBody)
@@ -722,7 +756,7 @@ void PhysicsWorld2D::HandleSceneSubsystemUpdate(StringHash eventType, VariantMap
 
 void PhysicsWorld2D::SendBeginContactEvents()
 {
-    if (beginContactInfos_.empty())
+    if (beginContacts_.empty())
         return;
 
     using namespace PhysicsBeginContact2D;
@@ -730,9 +764,8 @@ void PhysicsWorld2D::SendBeginContactEvents()
     VariantMap nodeEventData;
     eventData[P_WORLD] = this;
 
-    for (unsigned i = 0; i < beginContactInfos_.size(); ++i)
+    for (const PhysicsContact2D& contactInfo : beginContacts_)
     {
-        ContactInfo& contactInfo = beginContactInfos_[i];
         eventData[P_BODYA] = contactInfo.bodyA_;
         eventData[P_BODYB] = contactInfo.bodyB_;
         eventData[P_NODEA] = contactInfo.nodeA_;
@@ -767,13 +800,11 @@ void PhysicsWorld2D::SendBeginContactEvents()
             contactInfo.nodeB_->SendEvent(E_NODEBEGINCONTACT2D, nodeEventData);
         }
     }
-
-    beginContactInfos_.clear();
 }
 
 void PhysicsWorld2D::SendEndContactEvents()
 {
-    if (endContactInfos_.empty())
+    if (endContacts_.empty())
         return;
 
     using namespace PhysicsEndContact2D;
@@ -781,9 +812,8 @@ void PhysicsWorld2D::SendEndContactEvents()
     VariantMap nodeEventData;
     eventData[P_WORLD] = this;
 
-    for (unsigned i = 0; i < endContactInfos_.size(); ++i)
+    for (const PhysicsContact2D& contactInfo : endContacts_)
     {
-        ContactInfo& contactInfo = endContactInfos_[i];
         eventData[P_BODYA] = contactInfo.bodyA_;
         eventData[P_BODYB] = contactInfo.bodyB_;
         eventData[P_NODEA] = contactInfo.nodeA_;
@@ -818,13 +848,11 @@ void PhysicsWorld2D::SendEndContactEvents()
             contactInfo.nodeB_->SendEvent(E_NODEENDCONTACT2D, nodeEventData);
         }
     }
-
-    endContactInfos_.clear();
 }
 
-PhysicsWorld2D::ContactInfo::ContactInfo() = default;
+PhysicsContact2D::PhysicsContact2D() = default;
 
-PhysicsWorld2D::ContactInfo::ContactInfo(b2Contact* contact)
+PhysicsContact2D::PhysicsContact2D(b2Contact* contact)
 {
     b2Fixture* fixtureA = contact->GetFixtureA();
     b2Fixture* fixtureB = contact->GetFixtureB();
@@ -846,7 +874,7 @@ PhysicsWorld2D::ContactInfo::ContactInfo(b2Contact* contact)
     }
 }
 
-const ea::vector<unsigned char>& PhysicsWorld2D::ContactInfo::Serialize(VectorBuffer& buffer) const
+const ea::vector<unsigned char>& PhysicsContact2D::Serialize(VectorBuffer& buffer) const
 {
     buffer.Clear();
     for (int i = 0; i < numPoints_; ++i)
@@ -27,6 +27,8 @@
 
 #include <Box2D/Box2D.h>
 
+#include <EASTL/span.h>
+
 namespace Urho3D
 {
 
@@ -66,6 +68,39 @@ struct DelayedWorldTransform2D
     Quaternion worldRotation_;
 };
 
+/// Contact collected during 2D physics step.
+/// @nobind
+struct URHO3D_API PhysicsContact2D
+{
+    /// Construct.
+    PhysicsContact2D();
+    /// Construct from Box2D contact.
+    explicit PhysicsContact2D(b2Contact* contact);
+    /// Write contact points to buffer.
+    const ea::vector<unsigned char>& Serialize(VectorBuffer& buffer) const;
+
+    /// Rigid body A.
+    SharedPtr<RigidBody2D> bodyA_;
+    /// Rigid body B.
+    SharedPtr<RigidBody2D> bodyB_;
+    /// Node A.
+    SharedPtr<Node> nodeA_;
+    /// Node B.
+    SharedPtr<Node> nodeB_;
+    /// Shape A.
+    SharedPtr<CollisionShape2D> shapeA_;
+    /// Shape B.
+    SharedPtr<CollisionShape2D> shapeB_;
+    /// Number of contact points.
+    int numPoints_{};
+    /// Contact normal in world space.
+    Vector2 worldNormal_;
+    /// Contact positions in world space.
+    Vector2 worldPositions_[b2_maxManifoldPoints];
+    /// Contact overlap values.
+    float separations_[b2_maxManifoldPoints]{};
+};
+
 /// 2D physics simulation world component. Should be added only to the root scene node.
 class URHO3D_API PhysicsWorld2D : public Component, public b2ContactListener, public b2Draw
 {
@@ -153,6 +188,13 @@ public:
     /// Set position iterations.
     /// @property
     void SetPositionIterations(int positionIterations);
+    /// Enable or disable begin and end contact events sent for each contact. Contacts of the step are always
+    /// available from GetBeginContacts() and GetEndContacts() when E_PHYSICSCONTACTS2D is sent.
+    /// @property
+    void SetContactEventsEnabled(bool enable);
+    /// Enable or disable update contact events sent for each touching contact during the step.
+    /// @property
+    void SetUpdateContactEventsEnabled(bool enable);
     /// Add rigid body.
     void AddRigidBody(RigidBody2D* rigidBody);
     /// Remove rigid body.
@@ -225,6 +267,20 @@ public:
     /// @property
     int GetPositionIterations() const { return positionIterations_; }
 
+    /// Return whether begin and end contact events are sent for each contact.
+    /// @property
+    bool AreContactEventsEnabled() const { return contactEventsEnabled_; }
+
+    /// Return whether update contact events are sent.
+    /// @property
+    bool AreUpdateContactEventsEnabled() const { return updateContactEventsEnabled_; }
+
+    /// Return contacts that began during the last step. Valid until the end of the step.
+    ea::span<const PhysicsContact2D> GetBeginContacts() const { return beginContacts_; }
+
+    /// Return contacts that ended during the last step. Valid until the end of the step.
+    ea::span<const PhysicsContact2D> GetEndContacts() const { return endContacts_; }
+
     /// Return the Box2D physics world.
     b2World* GetWorld() { return world_.get(); }
 
@@ -240,6 +296,8 @@ protected:
 
     /// Handle the scene subsystem update event, step simulation here.
     void HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData);
+    /// Apply transforms of moving rigid bodies to scene nodes.
+    void ApplyWorldTransforms();
     /// Send begin contact events.
     void SendBeginContactEvents();
     /// Send end contact events.
@@ -272,41 +330,17 @@ protected:
     /// Delayed (parented) world transform assignments.
     ea::unordered_map<RigidBody2D*, DelayedWorldTransform2D> delayedWorldTransforms_;
 
-    /// Contact info.
-    struct ContactInfo
-    {
-        /// Construct.
-        ContactInfo();
-        /// Construct.
-        explicit ContactInfo(b2Contact* contact);
-        /// Write contact info to buffer.
-        const ea::vector<unsigned char>& Serialize(VectorBuffer& buffer) const;
-
-        /// Rigid body A.
-        SharedPtr<RigidBody2D> bodyA_;
-        /// Rigid body B.
-        SharedPtr<RigidBody2D> bodyB_;
-        /// Node A.
-        SharedPtr<Node> nodeA_;
-        /// Node B.
-        SharedPtr<Node> nodeB_;
-        /// Shape A.
-        SharedPtr<CollisionShape2D> shapeA_;
-        /// Shape B.
-        SharedPtr<CollisionShape2D> shapeB_;
-        /// Number of contact points.
-        int numPoints_{};
-        /// Contact normal in world space.
-        Vector2 worldNormal_;
-        /// Contact positions in world space.
-        Vector2 worldPositions_[b2_maxManifoldPoints];
-        /// Contact overlap values.
-        float separations_[b2_maxManifoldPoints]{};
-    };
-    /// Begin contact infos.
-    ea::vector<ContactInfo> beginContactInfos_;
-    /// End contact infos.
-    ea::vector<ContactInfo> endContactInfos_;
+    /// Rigid bodies with transforms to be applied. Used internally.
+    ea::vector<RigidBody2D*> movingRigidBodies_;
+    /// Whether begin and end contact events are sent for each contact.
+    bool contactEventsEnabled_{true};
+    /// Whether update contact events are sent.
+    bool updateContactEventsEnabled_{true};
+
+    /// Contacts that began during the step.
+    ea::vector<PhysicsContact2D> beginContacts_;
+    /// Contacts that ended during the step.
+    ea::vector<PhysicsContact2D> endContacts_;
     /// Temporary buffer with contact data.
     VectorBuffer contacts_;
 };
@@ -50,6 +50,57 @@ namespace Urho3D
 {
 
 static const unsigned MASK_VERTEX2D = MASK_POSITION | MASK_COLOR | MASK_TEXCOORD1;
+/// Number of source batches processed by one thread at once.
+static const unsigned SOURCE_BATCHES_PER_WORK_ITEM = 1024;
+/// Min number of sort keys sorted by one thread.
+static const unsigned MIN_SORT_KEYS_PER_WORK_ITEM = 4096;
+
+/// Sort ranges of values in multiple threads, then merge sorted ranges pairwise.
+template <class T>
+static void SortParallel(WorkQueue* workQueue, ea::vector<T>& values, ea::vector<T>& buffer)
+{
+    const unsigned size = values.size();
+    const unsigned numRanges = Clamp(size / MIN_SORT_KEYS_PER_WORK_ITEM, 1u, workQueue->GetNumThreads() + 1);
+    if (numRanges == 1)
+    {
+        ea::sort(values.begin(), values.end());
+        return;
+    }
+
+    ea::vector<unsigned> bounds(numRanges + 1);
+    for (unsigned i = 0; i <= numRanges; ++i)
+        bounds[i] = static_cast<unsigned>(static_cast<unsigned long long>(size) * i / numRanges);
+
+    ForEachParallel(workQueue, 1, numRanges, [&](unsigned beginRange, unsigned endRange)
+    {
+        for (unsigned i = beginRange; i < endRange; ++i)
+            ea::sort(values.begin() + bounds[i], values.begin() + bounds[i + 1]);
+    });
+
+    buffer.resize(size);
+    while (bounds.size() > 2)
+    {
+        // Range without pair is merged with empty range, i.e. copied
+        const unsigned lastBound = bounds.size() - 1;
+        const unsigned numMerges = (lastBound + 1) / 2;
+        ForEachParallel(workQueue, 1, numMerges, [&](unsigned beginMerge, unsigned endMerge)
+        {
+            for (unsigned i = beginMerge; i < endMerge; ++i)
+            {
+                const unsigned begin = bounds[2 * i];
+                const unsigned middle = bounds[Min(2 * i + 1, lastBound)];
+                const unsigned end = bounds[Min(2 * i + 2, lastBound)];
+                ea::merge(values.begin() + begin, values.begin() + middle,
+                    values.begin() + middle, values.begin() + end, buffer.begin() + begin);
+            }
+        });
+
+        for (unsigned i = 0; i < numMerges; ++i)
+            bounds[i + 1] = bounds[Min(2 * i + 2, lastBound)];
+        bounds.resize(numMerges + 1);
+        values.swap(buffer);
+    }
+}
 
 ViewBatchInfo2D::ViewBatchInfo2D() :
     vertexBufferUpdateFrameNumber_(0),
@@ -202,14 +253,18 @@ void Renderer2D::UpdateGeometry(const FrameInfo& frame)
             auto* dest = reinterpret_cast<Vertex2D*>(vertexBuffer->Lock(0, vertexCount, true));
             if (dest)
             {
+                // Each source batch has its own range in the buffer, so batches are copied in parallel
                 const ea::vector<const SourceBatch2D*>& sourceBatches = viewBatchInfo.sourceBatches_;
-                for (unsigned b = 0; b < sourceBatches.size(); ++b)
+                const ea::vector<unsigned>& vertexOffsets = viewBatchInfo.vertexOffsets_;
+                ForEachParallel(GetSubsystem<WorkQueue>(), SOURCE_BATCHES_PER_WORK_ITEM, sourceBatches.size(),
+                    [&](unsigned beginIndex, unsigned endIndex)
                 {
-                    const ea::vector<Vertex2D>& vertices = sourceBatches[b]->vertices_;
-                    for (unsigned i = 0; i < vertices.size(); ++i)
-                        dest[i] = vertices[i];
-                    dest += vertices.size();
-                }
+                    for (unsigned b = beginIndex; b < endIndex; ++b)
+                    {
+                        const ea::vector<Vertex2D>& vertices = sourceBatches[b]->vertices_;
+                        memcpy(dest + vertexOffsets[b], vertices.data(), vertices.size() * sizeof(Vertex2D));
+                    }
+                });
 
                 vertexBuffer->Unlock();
             }
@@ -317,7 +372,12 @@ void CheckDrawableVisibilityWork(const WorkItem* item, unsigned threadIndex)
     {
         Drawable2D* drawable = *start++;
         if (renderer->CheckVisibility(drawable))
+        {
             drawable->MarkInView(renderer->frame_);
+
+            // Update vertices of visible drawables here to spread the work between threads
+            drawable->GetSourceBatches();
+        }
     }
 }
 
@@ -408,20 +468,6 @@ void Renderer2D::GetDrawables(ea::vector<Drawable2D*>& drawables, Node* node)
         GetDrawables(drawables, i->Get());
 }
 
-static inline bool CompareSourceBatch2Ds(const SourceBatch2D* lhs, const SourceBatch2D* rhs)
-{
-    if (lhs->drawOrder_ != rhs->drawOrder_)
-        return lhs->drawOrder_ < rhs->drawOrder_;
-
-    if (lhs->distance_ != rhs->distance_)
-        return lhs->distance_ > rhs->distance_;
-
-    if (lhs->material_ != rhs->material_)
-        return lhs->material_->GetNameHash() < rhs->material_->GetNameHash();
-
-    return lhs < rhs;
-}
-
 void Renderer2D::UpdateViewBatchInfo(ViewBatchInfo2D& viewBatchInfo, Camera* camera)
 {
     // Already update in same frame
@@ -443,17 +489,37 @@ void Renderer2D::UpdateViewBatchInfo(ViewBatchInfo2D& viewBatchInfo, Camera* cam
         }
     }
 
-    for (unsigned i = 0; i < sourceBatches.size(); ++i)
+    // Make sure the camera view is up to date before accessing it from worker threads
+    camera->GetView();
+
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    const unsigned numSourceBatches = sourceBatches.size();
+    sortKeys_.resize(numSourceBatches);
+    ForEachParallel(workQueue, SOURCE_BATCHES_PER_WORK_ITEM, numSourceBatches,
+        [&](unsigned beginIndex, unsigned endIndex)
     {
-        const SourceBatch2D* sourceBatch = sourceBatches[i];
-        // if (sourceBatch->owner_)
+        for (unsigned i = beginIndex; i < endIndex; ++i)
         {
-            Vector3 worldPos = sourceBatch->owner_->GetNode()->GetWorldPosition();
+            const SourceBatch2D* sourceBatch = sourceBatches[i];
+            const Vector3 worldPos = sourceBatch->owner_->GetNode()->GetWorldPosition();
             sourceBatch->distance_ = camera->GetDistance(worldPos);
+
+            SourceBatch2DSortKey& sortKey = sortKeys_[i];
+            sortKey.drawOrder_ = sourceBatch->drawOrder_;
+            sortKey.distance_ = sourceBatch->distance_;
+            sortKey.materialHash_ = sourceBatch->material_->GetNameHash().Value();
+            sortKey.index_ = i;
         }
-    }
+    });
+
+    SortParallel(workQueue, sortKeys_, sortBuffer_);
+
+    sortedSourceBatches_.resize(numSourceBatches);
+    for (unsigned i = 0; i < numSourceBatches; ++i)
+        sortedSourceBatches_[i] = sourceBatches[sortKeys_[i].index_];
+    sourceBatches.swap(sortedSourceBatches_);
 
-    ea::quick_sort(sourceBatches.begin(), sourceBatches.end(), CompareSourceBatch2Ds);
+    viewBatchInfo.vertexOffsets_.resize(numSourceBatches);
 
     viewBatchInfo.batchCount_ = 0;
     Material* currMaterial = nullptr;
@@ -485,6 +551,7 @@ void Renderer2D::UpdateViewBatchInfo(ViewBatchInfo2D& viewBatchInfo, Camera* cam
             currMaterial = material;
         }
 
+        viewBatchInfo.vertexOffsets_[b] = vStart + vCount;
         iCount += vertices.size() * 6 / 4;
         vCount += vertices.size();
     }
@@ -37,6 +37,32 @@ class VertexBuffer;
 struct FrameInfo;
 struct SourceBatch2D;
 
+/// Sort key of 2D source batch.
+/// @nobind
+struct SourceBatch2DSortKey
+{
+    /// Draw order.
+    int drawOrder_{};
+    /// Distance to camera.
+    float distance_{};
+    /// Material name hash.
+    unsigned materialHash_{};
+    /// Index of source batch. Keeps the order of batches with equal keys stable.
+    unsigned index_{};
+
+    /// Compare keys: by draw order, back to front, by material.
+    bool operator<(const SourceBatch2DSortKey& rhs) const
+    {
+        if (drawOrder_ != rhs.drawOrder_)
+            return drawOrder_ < rhs.drawOrder_;
+        if (distance_ != rhs.distance_)
+            return distance_ > rhs.distance_;
+        if (materialHash_ != rhs.materialHash_)
+            return materialHash_ < rhs.materialHash_;
+        return index_ < rhs.index_;
+    }
+};
+
 /// 2D view batch info.
 /// @nobind
 struct ViewBatchInfo2D
@@ -56,6 +82,8 @@ struct ViewBatchInfo2D
     unsigned batchUpdatedFrameNumber_;
     /// Source batches.
     ea::vector<const SourceBatch2D*> sourceBatches_;
+    /// Offsets of source batch vertices in vertex buffer.
+    ea::vector<unsigned> vertexOffsets_;
     /// Batch count.
     unsigned batchCount_;
     /// Distances.
@@ -134,6 +162,12 @@ private:
     ea::unordered_map<Texture2D*, ea::unordered_map<int, SharedPtr<Material> > > cachedMaterials_;
     /// Cached techniques per blend mode.
     ea::unordered_map<int, SharedPtr<Technique> > cachedTechniques_;
+    /// Sort keys of source batches, reused between views.
+    ea::vector<SourceBatch2DSortKey> sortKeys_;
+    /// Scratch buffer for sorting.
+    ea::vector<SourceBatch2DSortKey> sortBuffer_;
+    /// Scratch buffer for sorted source batches.
+    ea::vector<const SourceBatch2D*> sortedSourceBatches_;
 };
 
 }
@@ -459,12 +459,34 @@ void RigidBody2D::ApplyWorldTransform(const Vector3& newWorldPosition, const Qua
     {
         // Do not feed changed position back to simulation now
         physicsWorld_->SetApplyingTransforms(true);
-        node_->SetWorldPosition(newWorldPosition);
-        node_->SetWorldRotation(newWorldRotation);
+
+        // Set position and rotation at once so the node is dirtied only once
+        Node* parent = node_->GetParent();
+        if (!parent || parent == GetScene())
+            node_->SetTransform(newWorldPosition, newWorldRotation);
+        else
+        {
+            node_->SetTransform(parent->GetWorldTransform().Inverse() * newWorldPosition,
+                parent->GetWorldRotation().Inverse() * newWorldRotation);
+        }
+
         physicsWorld_->SetApplyingTransforms(false);
     }
 }
 
+bool RigidBody2D::IsTransformUpdateNeeded() const
+{
+    if (!body_ || !node_)
+        return false;
+
+    if (body_->IsActive() && body_->GetType() != b2_staticBody && body_->IsAwake())
+        return true;
+
+    // Body may be parented to another rigid body
+    Node* parent = node_->GetParent();
+    return parent && parent != node_->GetScene();
+}
+
 void RigidBody2D::AddCollisionShape2D(CollisionShape2D* collisionShape)
 {
     if (!collisionShape)
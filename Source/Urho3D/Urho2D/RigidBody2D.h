@@ -125,6 +125,8 @@ public:
 
     /// Apply world transform from the Box2D body. Called by PhysicsWorld2D.
     void ApplyWorldTransform();
+    /// Return whether the world transform may need to be applied from the Box2D body. Called by PhysicsWorld2D.
+    bool IsTransformUpdateNeeded() const;
     /// Apply specified world position & rotation. Called by PhysicsWorld2D.
     void ApplyWorldTransform(const Vector3& newWorldPosition, const Quaternion& newWorldRotation);
     /// Add collision shape.
@@ -318,29 +318,8 @@ void StaticSprite2D::UpdateSourceBatches()
     | /         |
     V0---------V3
     */
-    Vertex2D vertex0;
-    Vertex2D vertex1;
-    Vertex2D vertex2;
-    Vertex2D vertex3;
-
-    // Convert to world space
-    const Matrix3x4& worldTransform = node_->GetWorldTransform();
-    vertex0.position_ = worldTransform * Vector3(drawRect_.min_.x_, drawRect_.min_.y_, 0.0f);
-    vertex1.position_ = worldTransform * Vector3(drawRect_.min_.x_, drawRect_.max_.y_, 0.0f);
-    vertex2.position_ = worldTransform * Vector3(drawRect_.max_.x_, drawRect_.max_.y_, 0.0f);
-    vertex3.position_ = worldTransform * Vector3(drawRect_.max_.x_, drawRect_.min_.y_, 0.0f);
-
-    vertex0.uv_ = textureRect_.min_;
-    (swapXY_ ? vertex3.uv_ : vertex1.uv_) = Vector2(textureRect_.min_.x_, textureRect_.max_.y_);
-    vertex2.uv_ = textureRect_.max_;
-    (swapXY_ ? vertex1.uv_ : vertex3.uv_) = Vector2(textureRect_.max_.x_, textureRect_.min_.y_);
-
-    vertex0.color_ = vertex1.color_ = vertex2.color_ = vertex3.color_ = color_.ToUInt();
-
-    vertices.push_back(vertex0);
-    vertices.push_back(vertex1);
-    vertices.push_back(vertex2);
-    vertices.push_back(vertex3);
+    vertices.resize(4);
+    GenerateSpriteQuad(vertices.data(), node_->GetWorldTransform(), drawRect_, textureRect_, swapXY_, color_.ToUInt());
 
     sourceBatchesDirty_ = false;
 }
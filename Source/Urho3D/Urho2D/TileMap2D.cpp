@@ -51,6 +51,7 @@ void TileMap2D::RegisterObject(Context* context)
     context->RegisterFactory<TileMap2D>(URHO2D_CATEGORY);
 
     URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Chunk Size", GetChunkSize, SetChunkSize, int, 0, AM_DEFAULT);
     URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Tmx File", GetTmxFileAttr, SetTmxFileAttr, ResourceRef, ResourceRef(TmxFile2D::GetTypeStatic()),
         AM_DEFAULT);
 }
@@ -118,12 +119,27 @@ void TileMap2D::SetTmxFile(TmxFile2D* tmxFile)
     if (tmxFile == tmxFile_)
         return;
 
+    tmxFile_ = tmxFile;
+    CreateLayers();
+}
+
+void TileMap2D::SetChunkSize(int chunkSize)
+{
+    chunkSize = Max(chunkSize, 0);
+    if (chunkSize == chunkSize_)
+        return;
+
+    chunkSize_ = chunkSize;
+    CreateLayers();
+}
+
+void TileMap2D::CreateLayers()
+{
     if (rootNode_)
         rootNode_->RemoveAllChildren();
 
     layers_.clear();
 
-    tmxFile_ = tmxFile;
     if (!tmxFile_)
         return;
 
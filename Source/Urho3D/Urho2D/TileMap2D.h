@@ -53,11 +53,18 @@ public:
     void SetTmxFile(TmxFile2D* tmxFile);
     /// Add debug geometry to the debug renderer.
     void DrawDebugGeometry();
+    /// Set size of tile layer chunks in tiles. Tile layers are rendered by chunks instead of node per tile if non-zero.
+    /// @property
+    void SetChunkSize(int chunkSize);
 
     /// Return tmx file.
     /// @property
     TmxFile2D* GetTmxFile() const;
 
+    /// Return size of tile layer chunks in tiles.
+    /// @property
+    int GetChunkSize() const { return chunkSize_; }
+
     /// Return information.
     /// @property
     const TileMapInfo2D& GetInfo() const { return info_; }
@@ -80,6 +87,9 @@ public:
     ///
     ea::vector<SharedPtr<TileMapObject2D> > GetTileCollisionShapes(unsigned gid) const;
 private:
+    /// Create layers for tmx file.
+    void CreateLayers();
+
     /// Tmx file.
     SharedPtr<TmxFile2D> tmxFile_;
     /// Tile map information.
@@ -88,6 +98,8 @@ private:
     SharedPtr<Node> rootNode_;
     /// Tile map layers.
     ea::vector<WeakPtr<TileMapLayer2D> > layers_;
+    /// Size of tile layer chunks in tiles.
+    int chunkSize_{};
 };
 
 }
@@ -0,0 +1,221 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Graphics/Material.h"
+#include "../Graphics/Texture2D.h"
+#include "../Scene/Node.h"
+#include "../Urho2D/Renderer2D.h"
+#include "../Urho2D/Sprite2D.h"
+#include "../Urho2D/TileMapChunk2D.h"
+#include "../Urho2D/TmxFile2D.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+TileMapChunk2D::TileMapChunk2D(Context* context) :
+    Drawable2D(context)
+{
+}
+
+TileMapChunk2D::~TileMapChunk2D() = default;
+
+void TileMapChunk2D::RegisterObject(Context* context)
+{
+    context->RegisterFactory<TileMapChunk2D>();
+}
+
+void TileMapChunk2D::Initialize(const TmxTileLayer2D* tileLayer, const TileMapInfo2D& info, const IntRect& tileRect)
+{
+    tileLayer_ = tileLayer;
+    info_ = info;
+    tileRect_ = tileRect;
+
+    // Store tiles and calculate bounding box in layer space
+    tileIndices_.resize(tileRect_.Width() * tileRect_.Height());
+    numTiles_ = 0;
+    boundingBox_.Clear();
+
+    unsigned index = 0;
+    for (int y = tileRect_.top_; y < tileRect_.bottom_; ++y)
+    {
+        for (int x = tileRect_.left_; x < tileRect_.right_; ++x)
+        {
+            const unsigned tileIndex = tileLayer_->GetTileIndex(x, y);
+            tileIndices_[index++] = tileIndex;
+
+            const Tile2D* tile = tileLayer_->GetUniqueTile(tileIndex);
+            Sprite2D* sprite = tile ? tile->GetSprite() : nullptr;
+            if (!sprite)
+                continue;
+
+            // Flipped tiles stay in place, only texture coordinates are flipped
+            Rect drawRect;
+            if (!sprite->GetDrawRectangle(drawRect))
+                continue;
+
+            const Vector2 position = info_.TileIndexToPosition(x, y);
+            boundingBox_.Merge(BoundingBox(Rect(drawRect.min_ + position, drawRect.max_ + position)));
+            ++numTiles_;
+        }
+    }
+
+    UpdateMaterials();
+    ReleaseGeometryIfHidden(M_MAX_UNSIGNED);
+    worldBoundingBoxDirty_ = true;
+}
+
+bool TileMapChunk2D::ReleaseGeometryIfHidden(unsigned lastFrameNumber)
+{
+    if (!geometryLoaded_ || viewFrameNumber_ >= lastFrameNumber)
+        return false;
+
+    for (SourceBatch2D& sourceBatch : sourceBatches_)
+    {
+        sourceBatch.vertices_.clear();
+        sourceBatch.vertices_.shrink_to_fit();
+    }
+
+    sourceBatchesDirty_ = true;
+    geometryLoaded_ = false;
+    return true;
+}
+
+unsigned TileMapChunk2D::GetMemoryUse() const
+{
+    unsigned memoryUse = tileIndices_.capacity() * sizeof(unsigned);
+    for (const SourceBatch2D& sourceBatch : sourceBatches_)
+        memoryUse += sourceBatch.vertices_.capacity() * sizeof(Vertex2D);
+    return memoryUse;
+}
+
+void TileMapChunk2D::OnSceneSet(Scene* scene)
+{
+    Drawable2D::OnSceneSet(scene);
+
+    UpdateMaterials();
+}
+
+void TileMapChunk2D::OnWorldBoundingBoxUpdate()
+{
+    worldBoundingBox_ = boundingBox_.Transformed(node_->GetWorldTransform());
+}
+
+void TileMapChunk2D::OnDrawOrderChanged()
+{
+    for (unsigned i = 0; i < sourceBatches_.size(); ++i)
+        sourceBatches_[i].drawOrder_ = GetDrawOrder() + tileRuns_[i].order_;
+}
+
+void TileMapChunk2D::UpdateSourceBatches()
+{
+    if (!sourceBatchesDirty_)
+        return;
+
+    for (SourceBatch2D& sourceBatch : sourceBatches_)
+        sourceBatch.vertices_.clear();
+
+    if (!tileLayer_)
+        return;
+
+    // Tiles are added in the order of the layer to keep the order of overlapping tiles
+    const Matrix3x4& worldTransform = node_->GetWorldTransform();
+    const unsigned color = Color::WHITE.ToUInt();
+    const int chunkWidth = tileRect_.Width();
+    for (unsigned runIndex = 0; runIndex < tileRuns_.size(); ++runIndex)
+    {
+        const TileRun& run = tileRuns_[runIndex];
+        ea::vector<Vertex2D>& vertices = sourceBatches_[runIndex].vertices_;
+        for (unsigned index = run.beginTile_; index < run.endTile_; ++index)
+        {
+            const Tile2D* tile = tileLayer_->GetUniqueTile(tileIndices_[index]);
+            Sprite2D* sprite = tile ? tile->GetSprite() : nullptr;
+            if (!sprite || sprite->GetTexture() != run.texture_)
+                continue;
+
+            const int x = tileRect_.left_ + static_cast<int>(index) % chunkWidth;
+            const int y = tileRect_.top_ + static_cast<int>(index) / chunkWidth;
+
+            Rect drawRect;
+            Rect textureRect;
+            if (!sprite->GetDrawRectangle(drawRect)
+                || !sprite->GetTextureRectangle(textureRect, tile->GetFlipX(), tile->GetFlipY()))
+                continue;
+
+            const Vector2 position = info_.TileIndexToPosition(x, y);
+            drawRect.min_ += position;
+            drawRect.max_ += position;
+
+            const unsigned startVertex = vertices.size();
+            vertices.resize(startVertex + 4);
+            GenerateSpriteQuad(&vertices[startVertex], worldTransform, drawRect, textureRect, tile->GetSwapXY(), color);
+        }
+    }
+
+    sourceBatchesDirty_ = false;
+    geometryLoaded_ = true;
+}
+
+void TileMapChunk2D::UpdateMaterials()
+{
+    // Tiles of other chunks never come between tiles of one row, so each run is drawn in the order of its first tile,
+    // which is the order of the sprite of individual tile
+    tileRuns_.clear();
+    const int layerWidth = tileLayer_ ? tileLayer_->GetWidth() : 0;
+    unsigned index = 0;
+    for (int y = tileRect_.top_; y < tileRect_.bottom_; ++y)
+    {
+        TileRun* currentRun = nullptr;
+        for (int x = tileRect_.left_; x < tileRect_.right_; ++x, ++index)
+        {
+            const Tile2D* tile = tileLayer_->GetUniqueTile(tileIndices_[index]);
+            Sprite2D* sprite = tile ? tile->GetSprite() : nullptr;
+            Texture2D* texture = sprite ? sprite->GetTexture() : nullptr;
+            if (!texture)
+                continue;
+
+            if (!currentRun || currentRun->texture_ != texture)
+            {
+                tileRuns_.push_back(TileRun{texture, index, index, y * layerWidth + x});
+                currentRun = &tileRuns_.back();
+            }
+            currentRun->endTile_ = index + 1;
+        }
+    }
+
+    sourceBatches_.resize(tileRuns_.size());
+    for (unsigned i = 0; i < tileRuns_.size(); ++i)
+    {
+        SourceBatch2D& sourceBatch = sourceBatches_[i];
+        sourceBatch.owner_ = this;
+        sourceBatch.drawOrder_ = GetDrawOrder() + tileRuns_[i].order_;
+        sourceBatch.material_ = renderer_ ? renderer_->GetMaterial(tileRuns_[i].texture_, BLEND_ALPHA) : nullptr;
+    }
+
+    sourceBatchesDirty_ = true;
+}
+
+}
@@ -0,0 +1,106 @@
+//
+// Copyright (c) 2017-2021 the rbfx project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Urho2D/Drawable2D.h"
+#include "../Urho2D/TileMapDefs2D.h"
+
+namespace Urho3D
+{
+
+class TmxTileLayer2D;
+
+/// Rectangular chunk of tile layer. Each run of tiles with the same texture in one row is rendered as one batch,
+/// ordered like individual tiles of the layer. Vertices are generated when the chunk becomes visible
+/// and may be released when it is out of view.
+class URHO3D_API TileMapChunk2D : public Drawable2D
+{
+    URHO3D_OBJECT(TileMapChunk2D, Drawable2D);
+
+public:
+    /// Construct.
+    explicit TileMapChunk2D(Context* context);
+    /// Destruct.
+    ~TileMapChunk2D() override;
+    /// Register object factory. Drawable2D must be registered first.
+    /// @nobind
+    static void RegisterObject(Context* context);
+
+    /// Initialize with tiles of the layer in the rectangle.
+    void Initialize(const TmxTileLayer2D* tileLayer, const TileMapInfo2D& info, const IntRect& tileRect);
+    /// Release vertices if the chunk wasn't in view since given frame. Return true if released.
+    bool ReleaseGeometryIfHidden(unsigned lastFrameNumber);
+
+    /// Return rectangle of tiles in the layer.
+    const IntRect& GetTileRect() const { return tileRect_; }
+    /// Return number of non-empty tiles.
+    unsigned GetNumTiles() const { return numTiles_; }
+    /// Return whether the vertices are generated.
+    bool IsGeometryLoaded() const { return geometryLoaded_; }
+    /// Return approximate memory used by tiles and vertices in bytes.
+    unsigned GetMemoryUse() const;
+
+protected:
+    /// Handle scene being assigned.
+    void OnSceneSet(Scene* scene) override;
+    /// Recalculate the world-space bounding box.
+    void OnWorldBoundingBoxUpdate() override;
+    /// Handle draw order changed.
+    void OnDrawOrderChanged() override;
+    /// Update source batches.
+    void UpdateSourceBatches() override;
+
+private:
+    /// Tiles of one row that are drawn with the same texture.
+    struct TileRun
+    {
+        /// Texture of the tiles.
+        Texture2D* texture_{};
+        /// Index of the first tile in the chunk.
+        unsigned beginTile_{};
+        /// Index after the last tile in the chunk.
+        unsigned endTile_{};
+        /// Order of the first tile in the layer, added to the draw order of the chunk.
+        int order_{};
+    };
+
+    /// Split tiles into runs and create source batch for each run.
+    void UpdateMaterials();
+
+    /// Tile layer.
+    const TmxTileLayer2D* tileLayer_{};
+    /// Rectangle of tiles in the layer.
+    IntRect tileRect_;
+    /// Tile map information.
+    TileMapInfo2D info_{};
+    /// Unique tile index for each tile of the chunk, row by row.
+    ea::vector<unsigned> tileIndices_;
+    /// Tile run of each source batch.
+    ea::vector<TileRun> tileRuns_;
+    /// Number of non-empty tiles.
+    unsigned numTiles_{};
+    /// Whether the vertices are generated.
+    bool geometryLoaded_{};
+};
+
+}
@@ -23,11 +23,14 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/CoreEvents.h"
+#include "../Core/Timer.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Resource/ResourceCache.h"
 #include "../Scene/Node.h"
 #include "../Urho2D/StaticSprite2D.h"
 #include "../Urho2D/TileMap2D.h"
+#include "../Urho2D/TileMapChunk2D.h"
 #include "../Urho2D/TileMapLayer2D.h"
 #include "../Urho2D/TmxFile2D.h"
 
@@ -36,6 +39,9 @@
 namespace Urho3D
 {
 
+/// Number of frames the chunk may be out of view before its geometry is released.
+static const unsigned CHUNK_RELEASE_DELAY = 60;
+
 TileMapLayer2D::TileMapLayer2D(Context* context) :
     Component(context)
 {
@@ -181,6 +187,8 @@ void TileMapLayer2D::Initialize(TileMap2D* tileMap, const TmxLayer2D* tmxLayer)
         }
 
         nodes_.clear();
+        chunks_.clear();
+        UnsubscribeFromEvent(E_ENDFRAME);
     }
 
     tileLayer_ = nullptr;
@@ -230,6 +238,12 @@ void TileMapLayer2D::SetDrawOrder(int drawOrder)
         if (staticSprite)
             staticSprite->SetLayer(drawOrder_);
     }
+
+    for (TileMapChunk2D* chunk : chunks_)
+    {
+        if (chunk)
+            chunk->SetLayer(drawOrder_);
+    }
 }
 
 void TileMapLayer2D::SetVisible(bool visible)
@@ -291,7 +305,7 @@ Tile2D* TileMapLayer2D::GetTile(int x, int y) const
 
 Node* TileMapLayer2D::GetTileNode(int x, int y) const
 {
-    if (!tileLayer_)
+    if (!tileLayer_ || !chunks_.empty())
         return nullptr;
 
     if (x < 0 || x >= tileLayer_->GetWidth() || y < 0 || y >= tileLayer_->GetHeight())
@@ -300,6 +314,31 @@ Node* TileMapLayer2D::GetTileNode(int x, int y) const
     return nodes_[y * tileLayer_->GetWidth() + x];
 }
 
+TileMapChunk2D* TileMapLayer2D::GetChunk(unsigned index) const
+{
+    return index < chunks_.size() ? chunks_[index] : nullptr;
+}
+
+unsigned TileMapLayer2D::GetNumLoadedChunks() const
+{
+    unsigned numLoadedChunks = 0;
+    for (TileMapChunk2D* chunk : chunks_)
+    {
+        if (chunk && chunk->IsGeometryLoaded())
+            ++numLoadedChunks;
+    }
+    return numLoadedChunks;
+}
+
+void TileMapLayer2D::ReleaseHiddenChunks(unsigned lastFrameNumber)
+{
+    for (TileMapChunk2D* chunk : chunks_)
+    {
+        if (chunk)
+            chunk->ReleaseGeometryIfHidden(lastFrameNumber);
+    }
+}
+
 unsigned TileMapLayer2D::GetNumObjects() const
 {
     if (!objectGroup_)
@@ -335,10 +374,24 @@ Node* TileMapLayer2D::GetImageNode() const
     return nodes_[0];
 }
 
+void TileMapLayer2D::HandleEndFrame(StringHash eventType, VariantMap& eventData)
+{
+    const unsigned frameNumber = GetSubsystem<Time>()->GetFrameNumber();
+    if (frameNumber > CHUNK_RELEASE_DELAY)
+        ReleaseHiddenChunks(frameNumber - CHUNK_RELEASE_DELAY);
+}
+
 void TileMapLayer2D::SetTileLayer(const TmxTileLayer2D* tileLayer)
 {
     tileLayer_ = tileLayer;
 
+    const int chunkSize = tileMap_->GetChunkSize();
+    if (chunkSize > 0)
+    {
+        CreateChunks(chunkSize);
+        return;
+    }
+
     int width = tileLayer->GetWidth();
     int height = tileLayer->GetHeight();
     nodes_.resize((unsigned) (width * height));
@@ -366,6 +419,41 @@ void TileMapLayer2D::SetTileLayer(const TmxTileLayer2D* tileLayer)
     }
 }
 
+void TileMapLayer2D::CreateChunks(int chunkSize)
+{
+    const int width = tileLayer_->GetWidth();
+    const int height = tileLayer_->GetHeight();
+    const int numChunksX = (width + chunkSize - 1) / chunkSize;
+    const int numChunksY = (height + chunkSize - 1) / chunkSize;
+
+    const TileMapInfo2D& info = tileMap_->GetInfo();
+    for (int chunkY = 0; chunkY < numChunksY; ++chunkY)
+    {
+        for (int chunkX = 0; chunkX < numChunksX; ++chunkX)
+        {
+            const IntRect tileRect(chunkX * chunkSize, chunkY * chunkSize,
+                Min((chunkX + 1) * chunkSize, width), Min((chunkY + 1) * chunkSize, height));
+
+            SharedPtr<Node> chunkNode(GetNode()->CreateTemporaryChild("Chunk"));
+            auto* chunk = chunkNode->CreateComponent<TileMapChunk2D>();
+            chunk->Initialize(tileLayer_, info, tileRect);
+            if (!chunk->GetNumTiles())
+            {
+                chunkNode->Remove();
+                continue;
+            }
+
+            // Batches of the chunk add the order of their tiles in the layer
+            chunk->SetLayer(drawOrder_);
+
+            nodes_.push_back(chunkNode);
+            chunks_.push_back(WeakPtr<TileMapChunk2D>(chunk));
+        }
+    }
+
+    SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(TileMapLayer2D, HandleEndFrame));
+}
+
 void TileMapLayer2D::SetObjectGroup(const TmxObjectGroup2D* objectGroup)
 {
     objectGroup_ = objectGroup;
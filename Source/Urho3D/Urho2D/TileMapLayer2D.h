@@ -35,6 +35,7 @@ namespace Urho3D
 class DebugRenderer;
 class Node;
 class TileMap2D;
+class TileMapChunk2D;
 class TmxImageLayer2D;
 class TmxLayer2D;
 class TmxObjectGroup2D;
@@ -94,10 +95,20 @@ public:
     /// Return height (for tile layer only).
     /// @property
     int GetHeight() const;
-    /// Return tile node (for tile layer only).
+    /// Return tile node (for tile layer without chunks only).
     Node* GetTileNode(int x, int y) const;
     /// Return tile (for tile layer only).
     Tile2D* GetTile(int x, int y) const;
+    /// Return number of non-empty chunks (for tile layer with chunks only).
+    /// @property
+    unsigned GetNumChunks() const { return chunks_.size(); }
+    /// Return chunk at index (for tile layer with chunks only).
+    TileMapChunk2D* GetChunk(unsigned index) const;
+    /// Return number of chunks with generated geometry (for tile layer with chunks only).
+    /// @property
+    unsigned GetNumLoadedChunks() const;
+    /// Release geometry of chunks that were not in view since given frame (for tile layer with chunks only).
+    void ReleaseHiddenChunks(unsigned lastFrameNumber);
 
     /// Return number of tile map objects (for object group only).
     /// @property
@@ -112,8 +123,12 @@ public:
     Node* GetImageNode() const;
 
 private:
+    /// Handle end of frame. Release geometry of chunks that are out of view.
+    void HandleEndFrame(StringHash eventType, VariantMap& eventData);
     /// Set tile layer.
     void SetTileLayer(const TmxTileLayer2D* tileLayer);
+    /// Create chunks for tile layer.
+    void CreateChunks(int chunkSize);
     /// Set object group.
     void SetObjectGroup(const TmxObjectGroup2D* objectGroup);
     /// Set image layer.
@@ -135,6 +150,8 @@ private:
     bool visible_{true};
     /// Tile node or image nodes.
     ea::vector<SharedPtr<Node> > nodes_;
+    /// Chunks of tile layer.
+    ea::vector<WeakPtr<TileMapChunk2D> > chunks_;
 };
 
 }
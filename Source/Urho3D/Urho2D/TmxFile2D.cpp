@@ -130,7 +130,12 @@ bool TmxTileLayer2D::Load(const XMLElement& element, const TileMapInfo2D& info)
     else
         encoding = XML;
 
-    tiles_.resize((unsigned) (width_ * height_));
+    tiles_.clear();
+    tiles_.push_back(nullptr);
+    tileIndices_.clear();
+    tileIndices_.resize((unsigned) (width_ * height_));
+    ea::unordered_map<unsigned, unsigned> gidToTileIndex;
+
     if (encoding == XML)
     {
         XMLElement tileElem = dataElem.GetChild("tile");
@@ -143,14 +148,7 @@ bool TmxTileLayer2D::Load(const XMLElement& element, const TileMapInfo2D& info)
                     return false;
 
                 unsigned gid = tileElem.GetUInt("gid");
-                if (gid > 0)
-                {
-                    SharedPtr<Tile2D> tile(new Tile2D());
-                    tile->gid_ = gid;
-                    tile->sprite_ = tmxFile_->GetTileSprite(gid & ~FLIP_ALL);
-                    tile->propertySet_ = tmxFile_->GetTilePropertySet(gid & ~FLIP_ALL);
-                    tiles_[y * width_ + x] = tile;
-                }
+                SetTileGid(y * width_ + x, gid, gidToTileIndex);
 
                 tileElem = tileElem.GetNext("tile");
             }
@@ -158,25 +156,20 @@ bool TmxTileLayer2D::Load(const XMLElement& element, const TileMapInfo2D& info)
     }
     else if (encoding == CSV)
     {
-        ea::string dataValue = dataElem.GetValue();
-        ea::vector<ea::string> gidVector = dataValue.split(',');
-        int currentIndex = 0;
-        for (int y = 0; y < height_; ++y)
+        // Parse in place, splitting large maps into strings is too slow
+        const ea::string dataValue = dataElem.GetValue();
+        const char* ptr = dataValue.c_str();
+        const unsigned numTiles = tileIndices_.size();
+        for (unsigned index = 0; index < numTiles && *ptr; ++index)
         {
-            for (int x = 0; x < width_; ++x)
-            {
-                gidVector[currentIndex].replace("\n", "");
-                unsigned gid = ToUInt(gidVector[currentIndex]);
-                if (gid > 0)
-                {
-                    SharedPtr<Tile2D> tile(new Tile2D());
-                    tile->gid_ = gid;
-                    tile->sprite_ = tmxFile_->GetTileSprite(gid & ~FLIP_ALL);
-                    tile->propertySet_ = tmxFile_->GetTilePropertySet(gid & ~FLIP_ALL);
-                    tiles_[y * width_ + x] = tile;
-                }
-                ++currentIndex;
-            }
+            while (*ptr && !IsDigit(*ptr))
+                ++ptr;
+
+            unsigned gid = 0;
+            while (IsDigit(*ptr))
+                gid = gid * 10 + (*ptr++ - '0');
+
+            SetTileGid(index, gid, gidToTileIndex);
         }
     }
     else if (encoding == Base64)
@@ -197,14 +190,7 @@ bool TmxTileLayer2D::Load(const XMLElement& element, const TileMapInfo2D& info)
                              | ((unsigned)buffer[currentIndex+2] << 16u)
                              | ((unsigned)buffer[currentIndex+1] << 8u)
                              | (unsigned)buffer[currentIndex];
-                if (gid > 0)
-                {
-                    SharedPtr<Tile2D> tile(new Tile2D());
-                    tile->gid_ = gid;
-                    tile->sprite_ = tmxFile_->GetTileSprite(gid & ~FLIP_ALL);
-                    tile->propertySet_ = tmxFile_->GetTilePropertySet(gid & ~FLIP_ALL);
-                    tiles_[y * width_ + x] = tile;
-                }
+                SetTileGid(y * width_ + x, gid, gidToTileIndex);
                 currentIndex += 4;
             }
         }
@@ -218,10 +204,27 @@ bool TmxTileLayer2D::Load(const XMLElement& element, const TileMapInfo2D& info)
 
 Tile2D* TmxTileLayer2D::GetTile(int x, int y) const
 {
-    if (x < 0 || x >= width_ || y < 0 || y >= height_)
-        return nullptr;
+    return tiles_[GetTileIndex(x, y)];
+}
+
+void TmxTileLayer2D::SetTileGid(unsigned index, unsigned gid, ea::unordered_map<unsigned, unsigned>& gidToTileIndex)
+{
+    if (gid == 0)
+        return;
+
+    auto iter = gidToTileIndex.find(gid);
+    if (iter == gidToTileIndex.end())
+    {
+        SharedPtr<Tile2D> tile(new Tile2D());
+        tile->gid_ = gid;
+        tile->sprite_ = tmxFile_->GetTileSprite(gid & ~FLIP_ALL);
+        tile->propertySet_ = tmxFile_->GetTilePropertySet(gid & ~FLIP_ALL);
+
+        iter = gidToTileIndex.emplace(gid, tiles_.size()).first;
+        tiles_.push_back(tile);
+    }
 
-    return tiles_[y * width_ + x];
+    tileIndices_[index] = iter->second;
 }
 
 TmxObjectGroup2D::TmxObjectGroup2D(TmxFile2D* tmxFile) :
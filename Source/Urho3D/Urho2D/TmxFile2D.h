@@ -97,10 +97,26 @@ public:
     bool Load(const XMLElement& element, const TileMapInfo2D& info);
     /// Return tile.
     Tile2D* GetTile(int x, int y) const;
+    /// Return index of unique tile at position, 0 if empty.
+    unsigned GetTileIndex(int x, int y) const
+    {
+        if (x < 0 || x >= width_ || y < 0 || y >= height_)
+            return 0;
+        return tileIndices_[y * width_ + x];
+    }
+    /// Return unique tile by index, null for index 0.
+    Tile2D* GetUniqueTile(unsigned index) const { return tiles_[index]; }
+    /// Return number of unique tiles including empty tile at index 0.
+    unsigned GetNumUniqueTiles() const { return tiles_.size(); }
 
 protected:
-    /// Tiles.
+    /// Set tile gid at position. Tiles with equal gid and flip flags are shared.
+    void SetTileGid(unsigned index, unsigned gid, ea::unordered_map<unsigned, unsigned>& gidToTileIndex);
+
+    /// Unique tiles. First tile is null and stands for empty cells.
     ea::vector<SharedPtr<Tile2D> > tiles_;
+    /// Index of unique tile for each cell.
+    ea::vector<unsigned> tileIndices_;
 };
 
 /// Tmx objects layer.